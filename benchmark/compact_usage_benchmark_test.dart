@@ -0,0 +1,157 @@
+// 全量记录模式的存储增长与查询延迟基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/compact_usage_benchmark_test.dart
+//
+// 合成 200 个应用、3 年的小时级历史，分别写入日表 / 小时表与紧凑整数表，
+// 比较数据库体积，以及按追踪列表过滤后查询一整年日级 / 小时级数据的
+// p50 / p99 延迟。结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:math';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/repositories/compact_usage_repository.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+
+const _appCount = 200;
+const _years = 3;
+const _trackedCount = 12;
+const _queryRounds = 30;
+
+/// 可复现的合成历史：少数应用占大部分时间（近似 Zipf），每天 8~30 个应用。
+Map<DateTime, Map<int, Map<String, Duration>>> _syntheticHistory(
+  DateTime firstDay,
+) {
+  final random = Random(42);
+  final history = <DateTime, Map<int, Map<String, Duration>>>{};
+  for (var offset = 0; offset < 365 * _years; offset++) {
+    final day = DateTime(firstDay.year, firstDay.month, firstDay.day + offset);
+    final perHour = <int, Map<String, Duration>>{};
+    final appsToday = 8 + random.nextInt(23);
+    for (var i = 0; i < appsToday; i++) {
+      final rank = (pow(random.nextDouble(), 2) * _appCount).floor();
+      final appId = 'app_$rank.exe';
+      final hours = 1 + random.nextInt(6);
+      final firstHour = random.nextInt(24 - hours);
+      for (var h = firstHour; h < firstHour + hours; h++) {
+        perHour.putIfAbsent(h, () => {})[appId] = Duration(
+          seconds: 60 + random.nextInt(3540),
+        );
+      }
+    }
+    history[day] = perHour;
+  }
+  return history;
+}
+
+Map<DateTime, Map<String, Duration>> _dailyOf(
+  Map<DateTime, Map<int, Map<String, Duration>>> hourly,
+) {
+  return hourly.map((day, perHour) {
+    final perApp = <String, Duration>{};
+    for (final apps in perHour.values) {
+      apps.forEach((appId, duration) {
+        perApp[appId] = (perApp[appId] ?? Duration.zero) + duration;
+      });
+    }
+    return MapEntry(day, perApp);
+  });
+}
+
+Future<int> _databaseBytes(AppDatabase db) async {
+  final pages = await db.customSelect('PRAGMA page_count').getSingle();
+  final size = await db.customSelect('PRAGMA page_size').getSingle();
+  return pages.read<int>('page_count') * size.read<int>('page_size');
+}
+
+Future<Map<String, double>> _latency(
+  Future<void> Function() query,
+  String name,
+) async {
+  await query(); // 预热
+  final samples = <int>[];
+  for (var i = 0; i < _queryRounds; i++) {
+    final watch = Stopwatch()..start();
+    await query();
+    samples.add(watch.elapsedMicroseconds);
+  }
+  samples.sort();
+  double at(double p) =>
+      samples[min(samples.length - 1, (p * samples.length).floor())] / 1000;
+  return {'${name}_p50_ms': at(0.5), '${name}_p99_ms': at(0.99)};
+}
+
+void main() {
+  test('compact store vs legacy tables: 200 apps, 3 years', () async {
+    final firstDay = DateTime(2022, 1, 1);
+    final history = _syntheticHistory(firstDay);
+    final daily = _dailyOf(history);
+    final tracked = {for (var i = 0; i < _trackedCount; i++) 'app_$i.exe'};
+    bool filter(String appId) => tracked.contains(appId);
+
+    final hourlyRows = history.values.fold<int>(
+      0,
+      (sum, perHour) =>
+          sum + perHour.values.fold(0, (s, apps) => s + apps.length),
+    );
+
+    // 日表 / 小时表：所有应用都写入，追踪过滤在写入前完成的做法。
+    final legacyDb = AppDatabase.forTesting(NativeDatabase.memory());
+    final legacy = SqliteUsageRepository(legacyDb);
+    await legacy.mergeUsage(daily);
+    await legacy.mergeHourlyUsage(history);
+
+    // 紧凑表：只写小时级整数行，日级由查询汇总。
+    final compactDb = AppDatabase.forTesting(NativeDatabase.memory());
+    final compact = CompactUsageRepository(
+      compactDb,
+      trackedFilter: () => filter,
+    );
+    await compact.mergeHourlyUsage(history);
+    // 小时表中的过滤副本不计入紧凑存储体积。
+    await compactDb.customStatement('DELETE FROM hourly_usage');
+    await compactDb.customStatement('VACUUM');
+
+    final year = (
+      start: DateTime(2024, 1, 1),
+      end: DateTime(2024, 12, 31),
+    );
+
+    final report = <String, Object>{
+      'apps': _appCount,
+      'days': history.length,
+      'hourly_rows': hourlyRows,
+      'legacy_bytes': await _databaseBytes(legacyDb),
+      'compact_bytes': await _databaseBytes(compactDb),
+      ...await _latency(() async {
+        final usage = await legacy.loadRange(year.start, year.end);
+        for (final perApp in usage.values) {
+          perApp.removeWhere((appId, _) => !filter(appId));
+        }
+      }, 'legacy_daily_year'),
+      ...await _latency(
+        () => compact.loadRange(year.start, year.end),
+        'compact_daily_year',
+      ),
+      ...await _latency(() async {
+        final usage = await legacy.loadHourlyRange(year.start, year.end);
+        for (final perHour in usage.values) {
+          for (final perApp in perHour.values) {
+            perApp.removeWhere((appId, _) => !filter(appId));
+          }
+        }
+      }, 'legacy_hourly_year'),
+      ...await _latency(
+        () => compact.loadHourlyRange(year.start, year.end),
+        'compact_hourly_year',
+      ),
+    };
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+
+    await legacyDb.close();
+    await compactDb.close();
+  }, timeout: const Timeout(Duration(minutes: 10)));
+}
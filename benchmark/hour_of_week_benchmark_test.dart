@@ -0,0 +1,132 @@
+// 周内小时打卡图基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/hour_of_week_benchmark_test.dart
+//
+// 用 SyntheticUsageGenerator 生成 5 年历史，对比两种得到打卡图的方式：
+// - 现场折叠：loadHourlyRange 读出整段小时明细，再 HourOfWeekUsage.fold；
+// - 聚合表：loadHourOfWeekUsage 只读 weekly_hour_usage 中的格子。
+// 分别测量最近一年与全部 5 年的 p50 / p99，并记录触发器给每 5 秒一次的
+// mergeHourlyUsage 带来的开销（与删除触发器后的同一操作对比）、升级回填
+// 的耗时。
+//
+// 数据规模由 RINGOTRACK_BENCH_YEARS / RINGOTRACK_BENCH_APPS /
+// RINGOTRACK_BENCH_SEED 控制。结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+
+const _rounds = 20;
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+Map<String, double> _percentiles(String name, List<int> micros) {
+  micros.sort();
+  double at(double p) =>
+      micros[min(micros.length - 1, (p * micros.length).floor())] / 1000;
+  return {'${name}_p50_ms': at(0.5), '${name}_p99_ms': at(0.99)};
+}
+
+Future<Map<String, double>> _latency(
+  String name,
+  Future<void> Function(int round) body,
+) async {
+  await body(-1);
+  final samples = <int>[];
+  for (var i = 0; i < _rounds; i++) {
+    final watch = Stopwatch()..start();
+    await body(i);
+    samples.add(watch.elapsedMicroseconds);
+  }
+  return _percentiles(name, samples);
+}
+
+void main() {
+  test('hour-of-week aggregate vs folding hourly rows', () async {
+    final generator = SyntheticUsageGenerator(
+      seed: _envInt('RINGOTRACK_BENCH_SEED', 42),
+      years: _envInt('RINGOTRACK_BENCH_YEARS', 5),
+      appCount: _envInt('RINGOTRACK_BENCH_APPS', 50),
+    );
+    final lastYear = generator.lastDay.year;
+    final firstYear = lastYear - generator.years + 1;
+
+    final db = AppDatabase.forTesting(NativeDatabase.memory());
+    final rows = await db.bulkLoadUsage(generator.days());
+
+    Future<HourOfWeekUsage> fold(int from, int to) async =>
+        HourOfWeekUsage.fold(
+          await db.loadHourlyRange(DateTime(from, 1, 1), DateTime(to, 12, 31)),
+        );
+
+    // 两种方式得到的打卡图一致。
+    expect(
+      (await db.loadHourOfWeekUsage(
+        firstYear,
+        lastYear,
+      )).punchcard(WeekStartMode.monday),
+      (await fold(firstYear, lastYear)).punchcard(WeekStartMode.monday),
+    );
+
+    Map<DateTime, Map<int, Map<String, Duration>>> flushDelta(int round) => {
+      generator.lastDay: {
+        21: {
+          generator.appIds[0]: const Duration(seconds: 4),
+          generator.appIds[(round + 2) % generator.appCount]: const Duration(
+            seconds: 1,
+          ),
+        },
+      },
+    };
+
+    final report = <String, Object>{
+      'seed': generator.seed,
+      'years': generator.years,
+      'apps': generator.appCount,
+      'rows': rows,
+      ...await _latency('fold_year', (_) => fold(lastYear, lastYear)),
+      ...await _latency(
+        'aggregate_year',
+        (_) => db.loadHourOfWeekUsage(lastYear, lastYear),
+      ),
+      ...await _latency('fold_all_years', (_) => fold(firstYear, lastYear)),
+      ...await _latency(
+        'aggregate_all_years',
+        (_) => db.loadHourOfWeekUsage(firstYear, lastYear),
+      ),
+      ...await _latency(
+        'merge_flush_with_trigger',
+        (round) => db.mergeHourlyUsage(flushDelta(round)),
+      ),
+    };
+
+    final rebuildWatch = Stopwatch()..start();
+    await db.rebuildHourOfWeekUsage();
+    report['rebuild_ms'] = rebuildWatch.elapsedMilliseconds;
+    report['aggregate_rows'] = (await db
+        .customSelect('SELECT COUNT(*) AS n FROM weekly_hour_usage')
+        .getSingle()).read<int>('n');
+
+    for (final suffix in ['insert', 'update', 'delete']) {
+      await db.customStatement('DROP TRIGGER hourly_usage_week_$suffix');
+    }
+    report.addAll(
+      await _latency(
+        'merge_flush_without_trigger',
+        (round) => db.mergeHourlyUsage(flushDelta(round)),
+      ),
+    );
+
+    await db.close();
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 20)));
+}
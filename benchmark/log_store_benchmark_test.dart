@@ -0,0 +1,139 @@
+// 分段日志存储的写入与查询延迟基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/log_store_benchmark_test.dart
+//
+// 生成约 100 MB、跨 14 天的日志（多数为高频模块的 INFO，少量 WARN / ERROR
+// 与低频模块），分别测量：无条件首页、ERROR 首页、低频模块（布隆过滤器
+// 跳块）全部结果、一周前一小时的时间范围、只在最早一条出现的关键词全文
+// 搜索（最坏情况，逐页读到底），以及查询期间的峰值 RSS。
+//
+// 可用 RINGOTRACK_BENCH_LOG_MB / RINGOTRACK_BENCH_SEED 调整。结果输出为
+// 一行 JSON。
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+import 'package:ringotrack/feature/logging/models/log_query.dart';
+import 'package:ringotrack/feature/logging/services/log_store.dart';
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+const _frequentTags = [
+  'usage_tick',
+  'foreground_tracker_windows',
+  'stroke_activity',
+  'usage_db',
+];
+
+void main() {
+  test('log store search latency over large histories', () async {
+    final targetBytes = _envInt('RINGOTRACK_BENCH_LOG_MB', 100) << 20;
+    final random = Random(_envInt('RINGOTRACK_BENCH_SEED', 42));
+    final dir = await Directory.systemTemp.createTemp('ringotrack_logs_');
+    final store = LogStore(dir, maxTotalBytes: targetBytes * 2);
+
+    final start = DateTime(2025, 3, 1);
+    const span = Duration(days: 14);
+    // 每条约 110 字节。
+    final entryCount = targetBytes ~/ 110;
+    final stepMicros = span.inMicroseconds ~/ entryCount;
+
+    final writeWatch = Stopwatch()..start();
+    for (var i = 0; i < entryCount; i++) {
+      final roll = random.nextInt(1000);
+      await store.append(
+        AppLogEntry(
+          timestamp: start.add(Duration(microseconds: i * stepMicros)),
+          level: roll == 0
+              ? 'ERROR'
+              : roll < 20
+              ? 'WARN'
+              : 'INFO',
+          tag: roll == 1
+              ? 'usage_sync'
+              : _frequentTags[random.nextInt(_frequentTags.length)],
+          message: i == 0
+              ? 'needle-oldest app=krita.exe delta=1234ms'
+              : 'app=photoshop.exe seconds=${random.nextInt(3600)} '
+                    'pending=${random.nextInt(64)} seq=$i',
+        ),
+      );
+    }
+    await store.close();
+    writeWatch.stop();
+
+    var bytes = 0;
+    for (final file in dir.listSync().whereType<File>()) {
+      bytes += file.lengthSync();
+    }
+
+    var peakRss = ProcessInfo.currentRss;
+    Future<Map<String, Object>> measure(
+      LogQuery query, {
+      bool drain = false,
+    }) async {
+      final watch = Stopwatch()..start();
+      var pages = 0;
+      var results = 0;
+      var scanned = 0;
+      var skipped = 0;
+      int? firstPageMs;
+      LogCursor? cursor;
+      do {
+        final page = await store.query(query, cursor: cursor);
+        pages++;
+        results += page.entries.length;
+        scanned += page.scannedBytes;
+        skipped += page.skippedBlocks;
+        firstPageMs ??= watch.elapsedMilliseconds;
+        cursor = page.next;
+        final rss = ProcessInfo.currentRss;
+        if (rss > peakRss) peakRss = rss;
+        // 不满一页说明受扫描上限截断，与面板一样接着读。
+        if (!drain && page.entries.length >= 200) break;
+      } while (cursor != null);
+      watch.stop();
+      return {
+        'first_page_ms': firstPageMs!,
+        'total_ms': watch.elapsedMilliseconds,
+        'pages': pages,
+        'results': results,
+        'scanned_mb': scanned / (1 << 20),
+        'skipped_blocks': skipped,
+      };
+    }
+
+    final weekAgo = start.add(const Duration(days: 7));
+    final report = <String, Object>{
+      'entries': entryCount,
+      'bytes': bytes,
+      'write_ms': writeWatch.elapsedMilliseconds,
+      'write_entries_per_s':
+          entryCount * 1000000 / writeWatch.elapsedMicroseconds,
+      'latest': await measure(LogQuery.all),
+      'errors': await measure(const LogQuery(minLevel: 'ERROR')),
+      'rare_tag': await measure(
+        const LogQuery(tag: 'usage_sync'),
+        drain: true,
+      ),
+      'time_range': await measure(
+        LogQuery(from: weekAgo, to: weekAgo.add(const Duration(hours: 1))),
+        drain: true,
+      ),
+      'full_text_oldest': await measure(
+        const LogQuery(text: 'needle-oldest'),
+        drain: true,
+      ),
+    };
+    report['query_peak_rss_mb'] = peakRss / (1 << 20);
+
+    expect((report['full_text_oldest'] as Map)['results'], 1);
+    await dir.delete(recursive: true);
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 30)));
+}
@@ -0,0 +1,248 @@
+// SqliteUsageRepository 基准套件（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/repository_benchmark_test.dart
+//
+// 用 SyntheticUsageGenerator 生成可复现的多年历史，经 bulkLoadUsage 写入
+// 临时目录下的 SQLite 文件，然后测量：
+// - loadRange / loadHourlyRange（一个月、一年）；
+// - mergeHourlyUsage（每 5 秒一次的落库增量、一整天的补写）；
+// - deleteByAppId（每轮删除一个长尾应用）；
+// - 仪表盘 provider 从创建到产出当年数据与指标的耗时。
+//
+// 数据规模由环境变量控制：RINGOTRACK_BENCH_YEARS（默认 3）、
+// RINGOTRACK_BENCH_APPS（默认 50）、RINGOTRACK_BENCH_SEED（默认 42）。
+// 结果输出为一行 JSON；设置 RINGOTRACK_BENCH_OUTPUT 时同时写入该文件，
+// 便于 CI 保存后做回归对比。
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:drift/native.dart';
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/dashboard/services/dashboard_snapshot_store.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+import 'package:ringotrack/feature/usage/services/usage_analysis.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/live_status_publisher.dart';
+import 'package:ringotrack/platform/session_state_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+import 'package:ringotrack/providers.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+const _rounds = 20;
+const _providerRounds = 10;
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+class _IdleForegroundTracker implements ForegroundAppTracker {
+  @override
+  Stream<ForegroundAppEvent> get events => const Stream.empty();
+
+  @override
+  void dispose() {}
+}
+
+class _IdleStrokeTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream.empty();
+
+  @override
+  void dispose() {}
+}
+
+class _IdleSessionTracker implements SessionStateTracker {
+  @override
+  Stream<SessionEvent> get events => const Stream.empty();
+
+  @override
+  void poll() {}
+
+  @override
+  void dispose() {}
+}
+
+class _NullLiveStatusPublisher implements LiveStatusPublisher {
+  @override
+  void publish(LiveStatus status) {}
+
+  @override
+  void dispose() {}
+}
+
+Map<String, double> _percentiles(String name, List<int> micros) {
+  micros.sort();
+  double at(double p) =>
+      micros[min(micros.length - 1, (p * micros.length).floor())] / 1000;
+  return {'${name}_p50_ms': at(0.5), '${name}_p99_ms': at(0.99)};
+}
+
+Future<Map<String, double>> _latency(
+  String name,
+  Future<void> Function(int round) body, {
+  int rounds = _rounds,
+  bool warmUp = true,
+}) async {
+  if (warmUp) await body(-1);
+  final samples = <int>[];
+  for (var i = 0; i < rounds; i++) {
+    final watch = Stopwatch()..start();
+    await body(i);
+    samples.add(watch.elapsedMicroseconds);
+  }
+  return _percentiles(name, samples);
+}
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  test('SqliteUsageRepository suite', () async {
+    final generator = SyntheticUsageGenerator(
+      seed: _envInt('RINGOTRACK_BENCH_SEED', 42),
+      years: _envInt('RINGOTRACK_BENCH_YEARS', 3),
+      appCount: _envInt('RINGOTRACK_BENCH_APPS', 50),
+    );
+    final lastYear = generator.lastDay.year;
+    final yearRange = (
+      start: DateTime(lastYear, 1, 1),
+      end: DateTime(lastYear, 12, 31),
+    );
+    final monthRange = (
+      start: DateTime(lastYear, 6, 1),
+      end: DateTime(lastYear, 6, 30),
+    );
+
+    final dir = await Directory.systemTemp.createTemp('ringotrack_bench_');
+    final dbFile = File('${dir.path}${Platform.pathSeparator}bench.sqlite');
+    final db = AppDatabase.forTesting(NativeDatabase(dbFile));
+    final repo = SqliteUsageRepository(db);
+
+    final loadWatch = Stopwatch()..start();
+    final rows = await db.bulkLoadUsage(generator.days());
+    final bulkLoadMs = loadWatch.elapsedMilliseconds;
+
+    final report = <String, Object>{
+      'seed': generator.seed,
+      'years': generator.years,
+      'apps': generator.appCount,
+      'rows': rows,
+      'bulk_load_ms': bulkLoadMs,
+      'file_bytes': await dbFile.length(),
+      ...await _latency(
+        'load_range_year',
+        (_) => repo.loadRange(yearRange.start, yearRange.end),
+      ),
+      ...await _latency(
+        'load_hourly_range_month',
+        (_) => repo.loadHourlyRange(monthRange.start, monthRange.end),
+      ),
+      ...await _latency(
+        'load_hourly_range_year',
+        (_) => repo.loadHourlyRange(yearRange.start, yearRange.end),
+      ),
+      // UsageService 每 5 秒落库一次：当前小时、一两个应用。
+      ...await _latency(
+        'merge_hourly_flush',
+        (round) => repo.mergeHourlyUsage({
+          generator.lastDay: {
+            21: {
+              generator.appIds[0]: const Duration(seconds: 4),
+              generator.appIds[(round + 2) % generator.appCount]:
+                  const Duration(seconds: 1),
+            },
+          },
+        }),
+      ),
+      ...await _latency(
+        'merge_hourly_full_day',
+        (round) => repo.mergeHourlyUsage({
+          DateTime(lastYear, 3, 1 + round + 1): {
+            for (var hour = 0; hour < 24; hour++)
+              hour: {
+                for (final appId in generator.appIds.take(3))
+                  appId: const Duration(minutes: 15),
+              },
+          },
+        }),
+      ),
+      // 每轮删除一个不同的长尾应用，避免重复删除空数据。
+      ...await _latency(
+        'delete_by_app_id',
+        (round) => repo.deleteByAppId(
+          generator.appIds[generator.appCount - 1 - (round + 1)],
+        ),
+        rounds: min(_rounds, max(1, generator.appCount - 2)),
+        warmUp: false,
+      ),
+    };
+
+    // 仪表盘 provider：每轮新建容器，测量从创建到当年数据、热力图数据
+    // 与指标全部就绪的耗时，再加上分析页的汇总。
+    SharedPreferences.setMockInitialValues({});
+    final snapshotStore = DashboardSnapshotStore(
+      File('${dir.path}${Platform.pathSeparator}dashboard.snapshot'),
+    );
+    final providerSamples = <int>[];
+    final analysisSamples = <int>[];
+    for (var round = -1; round < _providerRounds; round++) {
+      final watch = Stopwatch()..start();
+      final container = ProviderContainer(
+        overrides: [
+          appDatabaseProvider.overrideWithValue(db),
+          usageRepositoryProvider.overrideWithValue(repo),
+          foregroundAppTrackerProvider.overrideWithValue(
+            _IdleForegroundTracker(),
+          ),
+          strokeActivityTrackerProvider.overrideWithValue(_IdleStrokeTracker()),
+          sessionStateTrackerProvider.overrideWithValue(_IdleSessionTracker()),
+          liveStatusPublisherProvider.overrideWithValue(
+            _NullLiveStatusPublisher(),
+          ),
+          dashboardSnapshotStoreProvider.overrideWithValue(snapshotStore),
+          // 固定到合成数据的最后一年，结果不随运行日期变化。
+          metricsRangeProvider.overrideWithValue(yearRange),
+          heatmapRangeProvider.overrideWithValue(yearRange),
+        ],
+      );
+      final subscriptions = [
+        container.listen(currentYearUsageByDateProvider, (_, _) {}),
+        container.listen(yearlyUsageByDateProvider, (_, _) {}),
+      ];
+      await container.read(currentYearUsageByDateProvider.future);
+      final usage = await container.read(yearlyUsageByDateProvider.future);
+      expect(container.read(dashboardMetricsProvider).hasValue, isTrue);
+      final providerMicros = watch.elapsedMicroseconds;
+
+      final analysisWatch = Stopwatch()..start();
+      UsageAnalysis(usage).summarize(yearRange.start, yearRange.end);
+      final analysisMicros = analysisWatch.elapsedMicroseconds;
+
+      for (final subscription in subscriptions) {
+        subscription.close();
+      }
+      container.dispose();
+      if (round >= 0) {
+        providerSamples.add(providerMicros);
+        analysisSamples.add(analysisMicros);
+      }
+    }
+    report.addAll(_percentiles('dashboard_providers_year', providerSamples));
+    report.addAll(_percentiles('analysis_summarize_year', analysisSamples));
+
+    final json = jsonEncode(report);
+    // ignore: avoid_print
+    print(json);
+    final output = Platform.environment['RINGOTRACK_BENCH_OUTPUT'];
+    if (output != null && output.isNotEmpty) {
+      await File(output).writeAsString('$json\n');
+    }
+
+    await db.close();
+    await dir.delete(recursive: true);
+  }, timeout: const Timeout(Duration(minutes: 20)));
+}
@@ -0,0 +1,179 @@
+// 节拍唤醒次数基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/tick_scheduler_benchmark_test.dart
+//
+// 在虚拟时钟上回放一段固定种子生成的一天状态序列（统计中应用在前台 /
+// 其它应用在前台 / AFK），对比原先前台、落笔、按键轮询与 UsageService
+// 各自一个 1 秒定时器的做法与共享 TickScheduler 的唤醒次数，并实测
+// 每次共享节拍分发的 CPU 时间（轮询源为空操作，只计调度本身），
+// 结果按状态输出为一行 JSON。
+import 'dart:async';
+import 'dart:convert';
+import 'dart:math';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+
+const _traceHours = 24;
+
+/// 原先的独立 1 秒定时器：前台、落笔、按键轮询与 UsageService 结算。
+const _legacyTimers = 4;
+
+class _Segment {
+  _Segment(this.cadence, this.duration);
+
+  final TickCadence cadence;
+  final Duration duration;
+}
+
+/// 活跃段数分钟到一小时，期间穿插切到其它应用与短暂 AFK。
+List<_Segment> _syntheticTrace() {
+  final random = Random(7);
+  final segments = <_Segment>[];
+  var total = Duration.zero;
+  while (total < const Duration(hours: _traceHours)) {
+    final roll = random.nextDouble();
+    final segment = roll < 0.5
+        ? _Segment(
+            TickCadence.active,
+            Duration(seconds: 120 + random.nextInt(3600)),
+          )
+        : roll < 0.8
+        ? _Segment(
+            TickCadence.background,
+            Duration(seconds: 30 + random.nextInt(900)),
+          )
+        : _Segment(
+            TickCadence.idle,
+            Duration(seconds: 60 + random.nextInt(5400)),
+          );
+    segments.add(segment);
+    total += segment.duration;
+  }
+  return segments;
+}
+
+class _VirtualTimer implements Timer {
+  _VirtualTimer(this.due, this.callback);
+
+  final DateTime due;
+  final void Function() callback;
+  bool _active = true;
+
+  @override
+  bool get isActive => _active;
+
+  @override
+  int get tick => 0;
+
+  @override
+  void cancel() {
+    _active = false;
+  }
+}
+
+class _VirtualClock {
+  _VirtualClock(this.now);
+
+  DateTime now;
+  _VirtualTimer? _pending;
+
+  Timer createTimer(Duration delay, void Function() callback) {
+    final timer = _VirtualTimer(now.add(delay), callback);
+    _pending = timer;
+    return timer;
+  }
+
+  Future<void> advance(Duration by) async {
+    final target = now.add(by);
+    while (true) {
+      final timer = _pending;
+      if (timer == null || !timer.isActive || timer.due.isAfter(target)) {
+        break;
+      }
+      timer._active = false;
+      now = timer.due;
+      timer.callback();
+      await Future<void>.delayed(Duration.zero);
+    }
+    now = target;
+  }
+}
+
+void main() {
+  test('shared tick vs independent 1s timers over a replayed day', () async {
+    final trace = _syntheticTrace();
+    final clock = _VirtualClock(DateTime(2025, 6, 2));
+    final scheduler = TickScheduler(
+      now: () => clock.now,
+      createTimer: clock.createTimer,
+    );
+
+    // 三个轮询源（Windows 前台 / 落笔 / 按键），空操作。
+    var polls = 0;
+    for (var i = 0; i < 3; i++) {
+      scheduler.addPoller(() => polls++);
+    }
+    final dispatch = Stopwatch();
+    scheduler.handler = () async {
+      dispatch.stop();
+    };
+
+    final seconds = <TickCadence, double>{};
+    final wakeups = <TickCadence, int>{};
+    final micros = <TickCadence, int>{};
+    for (final segment in trace) {
+      scheduler.setCadence(segment.cadence);
+      final before = scheduler.wakeups;
+      // 按节拍逐个推进以便计时：每拍从定时器回调到 handler 的耗时。
+      final end = clock.now.add(segment.duration);
+      while (clock.now.isBefore(end)) {
+        final next = scheduler.scheduledAt;
+        final step = next == null || next.isAfter(end)
+            ? end.difference(clock.now)
+            : next.difference(clock.now);
+        final ticked = scheduler.wakeups;
+        dispatch
+          ..reset()
+          ..start();
+        await clock.advance(step);
+        dispatch.stop();
+        if (scheduler.wakeups > ticked) {
+          micros[segment.cadence] =
+              (micros[segment.cadence] ?? 0) + dispatch.elapsedMicroseconds;
+        }
+      }
+      wakeups[segment.cadence] =
+          (wakeups[segment.cadence] ?? 0) + scheduler.wakeups - before;
+      seconds[segment.cadence] =
+          (seconds[segment.cadence] ?? 0) + segment.duration.inSeconds;
+    }
+    scheduler.dispose();
+
+    expect(polls, scheduler.wakeups * 3);
+
+    final report = <String, Object>{
+      'trace_hours': _traceHours,
+      'segments': trace.length,
+    };
+    var totalSeconds = 0.0;
+    var totalWakeups = 0;
+    for (final cadence in TickCadence.values) {
+      final s = seconds[cadence] ?? 0;
+      final w = wakeups[cadence] ?? 0;
+      totalSeconds += s;
+      totalWakeups += w;
+      report['${cadence.name}_seconds'] = s.round();
+      report['${cadence.name}_legacy_wakeups_per_s'] = _legacyTimers;
+      report['${cadence.name}_shared_wakeups_per_s'] = s == 0 ? 0 : w / s;
+      report['${cadence.name}_dispatch_us_per_tick'] = w == 0
+          ? 0
+          : (micros[cadence] ?? 0) / w;
+    }
+    report['legacy_wakeups_total'] = (totalSeconds * _legacyTimers).round();
+    report['shared_wakeups_total'] = totalWakeups;
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 10)));
+}
@@ -0,0 +1,166 @@
+// 分析页聚合基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/usage_analysis_benchmark_test.dart
+//
+// 合成 10 年、40 个应用的日级数据，对比逐日遍历字典的参考实现与列式扫描：
+// 先校验两者输出一致，再测量 10 年范围内四种聚合的 p50 / p99 耗时，
+// 结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:math';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/services/usage_analysis.dart';
+
+const _years = 10;
+const _appCount = 40;
+const _rounds = 20;
+
+Map<DateTime, Map<String, Duration>> _syntheticUsage(DateTime firstDay) {
+  final random = Random(42);
+  final usage = <DateTime, Map<String, Duration>>{};
+  for (var offset = 0; offset < 365 * _years; offset++) {
+    // 约三成的日子没有记录。
+    if (random.nextDouble() < 0.3) continue;
+    final perApp = <String, Duration>{};
+    for (var i = 0; i < 1 + random.nextInt(6); i++) {
+      final app = (pow(random.nextDouble(), 2) * _appCount).floor();
+      perApp['app_$app.exe'] = Duration(seconds: 60 + random.nextInt(14400));
+    }
+    usage[DateTime(firstDay.year, firstDay.month, firstDay.day + offset)] =
+        perApp;
+  }
+  return usage;
+}
+
+DateTime _day(DateTime dt) => DateTime(dt.year, dt.month, dt.day);
+
+/// 原先逐日遍历 DateTime 键的实现，作为对照。
+class _ReferenceAnalysis {
+  _ReferenceAnalysis(this.usage);
+
+  final Map<DateTime, Map<String, Duration>> usage;
+
+  Iterable<DateTime> _days(DateTime start, DateTime end) sync* {
+    final first = _day(start);
+    for (var i = 0; ; i++) {
+      final day = DateTime(first.year, first.month, first.day + i);
+      if (day.isAfter(end)) return;
+      yield day;
+    }
+  }
+
+  List<Duration> daily(DateTime start, DateTime end) => [
+    for (final day in _days(start, end))
+      (usage[day] ?? const {}).values.fold(Duration.zero, (a, b) => a + b),
+  ];
+
+  List<(DateTime, Duration)> weekly(DateTime start, DateTime end) {
+    final buckets = <DateTime, Duration>{};
+    for (final day in _days(start, end)) {
+      final monday = DateTime(day.year, day.month, day.day - day.weekday + 1);
+      final total = (usage[day] ?? const {}).values.fold(
+        Duration.zero,
+        (a, b) => a + b,
+      );
+      buckets[monday] = (buckets[monday] ?? Duration.zero) + total;
+    }
+    final keys = buckets.keys.toList()..sort();
+    return [for (final k in keys) (k, buckets[k]!)];
+  }
+
+  Map<String, Duration> apps(DateTime start, DateTime end) {
+    final totals = <String, Duration>{};
+    for (final day in _days(start, end)) {
+      usage[day]?.forEach((appId, d) {
+        totals[appId] = (totals[appId] ?? Duration.zero) + d;
+      });
+    }
+    return totals;
+  }
+
+  List<Duration> weekdays(DateTime start, DateTime end) {
+    final sums = List.filled(7, Duration.zero);
+    final counts = List.filled(7, 0);
+    for (final day in _days(start, end)) {
+      counts[day.weekday - 1] += 1;
+      sums[day.weekday - 1] += (usage[day] ?? const {}).values.fold(
+        Duration.zero,
+        (a, b) => a + b,
+      );
+    }
+    return [
+      for (var i = 0; i < 7; i++)
+        counts[i] == 0 ? Duration.zero : sums[i] ~/ counts[i],
+    ];
+  }
+}
+
+Map<String, double> _latency(String name, void Function() body) {
+  body(); // 预热
+  final samples = <int>[];
+  for (var i = 0; i < _rounds; i++) {
+    final watch = Stopwatch()..start();
+    body();
+    samples.add(watch.elapsedMicroseconds);
+  }
+  samples.sort();
+  double at(double p) =>
+      samples[min(samples.length - 1, (p * samples.length).floor())] / 1000;
+  return {'${name}_p50_ms': at(0.5), '${name}_p99_ms': at(0.99)};
+}
+
+void main() {
+  test('columnar analysis vs per-day map walk: 10 years', () {
+    final start = DateTime(2015, 1, 1);
+    final end = DateTime(2015 + _years - 1, 12, 31);
+    final usage = _syntheticUsage(start);
+    final reference = _ReferenceAnalysis(usage);
+    final analysis = UsageAnalysis(usage);
+
+    // 输出一致性。
+    final summary = analysis.summarize(start, end);
+    expect(
+      summary.daily.map((d) => d.total).toList(),
+      reference.daily(start, end),
+    );
+    expect(
+      summary.weekly.map((w) => (w.weekStart, w.total)).toList(),
+      reference.weekly(start, end),
+    );
+    expect(
+      {for (final a in summary.appTotals) a.appId: a.total},
+      reference.apps(start, end),
+    );
+    expect(
+      summary.weekdayAverages.map((w) => w.average).toList(),
+      reference.weekdays(start, end),
+    );
+
+    final report = <String, Object>{
+      'days': usage.length,
+      'apps': _appCount,
+      ..._latency('reference_all', () {
+        reference.daily(start, end);
+        reference.weekly(start, end);
+        reference.apps(start, end);
+        reference.weekdays(start, end);
+      }),
+      // 每轮新建快照，包含列构建成本。
+      ..._latency('columnar_build_and_summarize', () {
+        UsageAnalysis(usage).summarize(start, end);
+      }),
+      ..._latency('columnar_summarize', () {
+        analysis.summarize(start, end);
+      }),
+      ..._latency('columnar_separate_calls', () {
+        analysis.dailyTotals(start, end);
+        analysis.weeklyTotals(start, end);
+        analysis.appTotals(start, end);
+        analysis.weekdayAverages(start, end);
+      }),
+    };
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 5)));
+}
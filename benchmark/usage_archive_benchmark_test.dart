@@ -0,0 +1,103 @@
+// 使用历史归档导出 / 导入吞吐基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/usage_archive_benchmark_test.dart
+//
+// 用 SyntheticUsageGenerator 生成多年历史写入 v7 数据库，分别以二进制与
+// CSV 格式流式导出到临时文件，再流式导入到空库（add 模式）和原库
+// （replace 模式），记录文件体积、各阶段耗时与每秒行数 / 字节数，以及
+// 导入期间的峰值 RSS。
+//
+// 默认 10 年、100 个应用，可用 RINGOTRACK_BENCH_YEARS /
+// RINGOTRACK_BENCH_APPS / RINGOTRACK_BENCH_SEED 调整。结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/usage_archive.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+double _perSecond(int count, Stopwatch watch) =>
+    count * 1000000 / watch.elapsedMicroseconds;
+
+void main() {
+  test('streaming archive export / import throughput', () async {
+    final generator = SyntheticUsageGenerator(
+      seed: _envInt('RINGOTRACK_BENCH_SEED', 42),
+      years: _envInt('RINGOTRACK_BENCH_YEARS', 10),
+      appCount: _envInt('RINGOTRACK_BENCH_APPS', 100),
+    );
+
+    final dir = await Directory.systemTemp.createTemp('ringotrack_archive_');
+    String path(String name) => '${dir.path}${Platform.pathSeparator}$name';
+    final sourceDb = AppDatabase.forTesting(
+      NativeDatabase(File(path('source.sqlite'))),
+    );
+    final rows = await sourceDb.bulkLoadUsage(generator.days());
+
+    final report = <String, Object>{
+      'seed': generator.seed,
+      'years': generator.years,
+      'apps': generator.appCount,
+      'rows': rows,
+    };
+
+    for (final format in UsageArchiveFormat.values) {
+      final file = File(path('history.${format.name}'));
+
+      final exportWatch = Stopwatch()..start();
+      await UsageArchive(
+        sourceDb,
+      ).export(format: format).pipe(file.openWrite());
+      exportWatch.stop();
+      final bytes = await file.length();
+
+      final targetDb = AppDatabase.forTesting(
+        NativeDatabase(File(path('target_${format.name}.sqlite'))),
+      );
+      var peakRss = ProcessInfo.currentRss;
+      final importWatch = Stopwatch()..start();
+      final imported = await UsageArchive(targetDb).import(
+        file.openRead(),
+        totalBytes: bytes,
+        onProgress: (_) {
+          final rss = ProcessInfo.currentRss;
+          if (rss > peakRss) peakRss = rss;
+        },
+      );
+      importWatch.stop();
+
+      final replaceWatch = Stopwatch()..start();
+      await UsageArchive(
+        sourceDb,
+      ).import(file.openRead(), mode: UsageImportMode.replace);
+      replaceWatch.stop();
+
+      final prefix = format.name;
+      report.addAll({
+        '${prefix}_bytes': bytes,
+        '${prefix}_export_ms': exportWatch.elapsedMilliseconds,
+        '${prefix}_export_rows_per_s': _perSecond(rows, exportWatch),
+        '${prefix}_export_mb_per_s': _perSecond(bytes, exportWatch) / 1e6,
+        '${prefix}_import_ms': importWatch.elapsedMilliseconds,
+        '${prefix}_import_rows_per_s': _perSecond(imported.rows, importWatch),
+        '${prefix}_import_mb_per_s': _perSecond(bytes, importWatch) / 1e6,
+        '${prefix}_import_peak_rss_mb': peakRss / (1 << 20),
+        '${prefix}_replace_ms': replaceWatch.elapsedMilliseconds,
+      });
+
+      expect(imported.dailyRows + imported.hourlyRows, rows);
+      await targetDb.close();
+    }
+
+    await sourceDb.close();
+    await dir.delete(recursive: true);
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 30)));
+}
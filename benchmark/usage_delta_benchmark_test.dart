@@ -0,0 +1,134 @@
+// 仪表盘增量合并基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/usage_delta_benchmark_test.dart
+//
+// 加载 5 年、30 个应用的日级数据后，按 1 秒节拍合并 UsageService 的增量，
+// 对比原先「合并后深拷贝整段区间」与 UsageTimeline 结构共享两种做法：
+// 统计每个节拍新分配的日级应用表数量（与上一版本逐日比较是否为同一对象）
+// 以及单节拍 p50 / p99 耗时，结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:math';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/models/usage_timeline.dart';
+
+const _years = 5;
+const _appCount = 30;
+const _ticks = 600;
+
+Map<DateTime, Map<String, Duration>> _syntheticUsage(DateTime firstDay) {
+  final random = Random(42);
+  final usage = <DateTime, Map<String, Duration>>{};
+  for (var offset = 0; offset < 365 * _years; offset++) {
+    if (random.nextDouble() < 0.3) continue;
+    final perApp = <String, Duration>{};
+    for (var i = 0; i < 1 + random.nextInt(6); i++) {
+      final app = (pow(random.nextDouble(), 2) * _appCount).floor();
+      perApp['app_$app.exe'] = Duration(seconds: 60 + random.nextInt(14400));
+    }
+    usage[DateTime(firstDay.year, firstDay.month, firstDay.day + offset)] =
+        perApp;
+  }
+  return usage;
+}
+
+/// 每秒一条增量：今天，当前前台应用 1 秒。
+Map<DateTime, Map<String, Duration>> _tickDelta(DateTime today, int tick) {
+  return {
+    today: {'app_${tick ~/ 120 % 3}.exe': const Duration(seconds: 1)},
+  };
+}
+
+/// 原先 provider 的做法：合并进可变状态后深拷贝一份再产出。
+Map<DateTime, Map<String, Duration>> _referenceTick(
+  Map<DateTime, Map<String, Duration>> state,
+  Map<DateTime, Map<String, Duration>> delta,
+) {
+  delta.forEach((day, perApp) {
+    final existing = state.putIfAbsent(day, () => <String, Duration>{});
+    perApp.forEach((appId, duration) {
+      existing[appId] = (existing[appId] ?? Duration.zero) + duration;
+    });
+  });
+  return Map<DateTime, Map<String, Duration>>.fromEntries(
+    state.entries.map(
+      (e) => MapEntry(e.key, Map<String, Duration>.from(e.value)),
+    ),
+  );
+}
+
+int _freshDayMaps(
+  Map<DateTime, Map<String, Duration>> previous,
+  Map<DateTime, Map<String, Duration>> next,
+) {
+  var fresh = 0;
+  next.forEach((day, perApp) {
+    if (!identical(previous[day], perApp)) fresh++;
+  });
+  return fresh;
+}
+
+Map<String, Object> _summarize(String name, List<int> micros, int fresh) {
+  micros.sort();
+  double at(double p) =>
+      micros[min(micros.length - 1, (p * micros.length).floor())] / 1000;
+  return {
+    '${name}_tick_p50_ms': at(0.5),
+    '${name}_tick_p99_ms': at(0.99),
+    '${name}_fresh_day_maps_per_tick': fresh / _ticks,
+  };
+}
+
+void main() {
+  test('structural sharing vs deep copy: 5 years at 1s cadence', () {
+    final start = DateTime(2021, 1, 1);
+    final end = DateTime(2021 + _years - 1, 12, 31);
+    final today = DateTime(2025, 6, 2);
+    final usage = _syntheticUsage(start);
+
+    // 参考实现。
+    final state = usage.map((k, v) => MapEntry(k, Map.of(v)));
+    var previousCopy = _referenceTick(state, const {});
+    final referenceMicros = <int>[];
+    var referenceFresh = 0;
+    for (var tick = 0; tick < _ticks; tick++) {
+      final watch = Stopwatch()..start();
+      final copy = _referenceTick(state, _tickDelta(today, tick));
+      referenceMicros.add(watch.elapsedMicroseconds);
+      referenceFresh += _freshDayMaps(previousCopy, copy);
+      previousCopy = copy;
+    }
+
+    // 结构共享。
+    var timeline = UsageTimeline.from(usage);
+    final timelineMicros = <int>[];
+    var timelineFresh = 0;
+    for (var tick = 0; tick < _ticks; tick++) {
+      final watch = Stopwatch()..start();
+      final next = timeline.withDelta(
+        _tickDelta(today, tick),
+        start: start,
+        end: end,
+      );
+      timelineMicros.add(watch.elapsedMicroseconds);
+      timelineFresh += _freshDayMaps(timeline, next);
+      timeline = next;
+    }
+
+    // 两种做法的最终结果一致。
+    expect(timeline.length, previousCopy.length);
+    previousCopy.forEach((day, perApp) {
+      expect(timeline[day], perApp);
+    });
+
+    final report = <String, Object>{
+      'days': usage.length,
+      'ticks': _ticks,
+      ..._summarize('deep_copy', referenceMicros, referenceFresh),
+      ..._summarize('timeline', timelineMicros, timelineFresh),
+    };
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 5)));
+}
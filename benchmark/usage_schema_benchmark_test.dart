@@ -0,0 +1,267 @@
+// 日表 / 小时表存储格式基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/usage_schema_benchmark_test.dart
+//
+// 用 SyntheticUsageGenerator 生成同一段多年历史，分别写入 v5 的字符串键
+// 旧表（drift DateTime + 完整 app_id）与 v6 的整数键新表（日序号 + 应用
+// 字典 + 打包主键，WITHOUT ROWID），VACUUM 后比较文件体积，并测量：
+// - loadRange（一年）、loadHourlyRange（一个月、一年）；
+// - mergeHourlyUsage（每 5 秒一次的落库增量）；
+// - 旧库经 migrateLegacyUsage 分块迁移的耗时与迁移后的体积。
+// 旧表的读写使用 v5 的 SQL 作为参考实现。
+//
+// 数据规模与 repository_benchmark_test 相同，由 RINGOTRACK_BENCH_YEARS /
+// RINGOTRACK_BENCH_APPS / RINGOTRACK_BENCH_SEED 控制。结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:drift/drift.dart' hide isNull, isNotNull;
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+
+const _rounds = 20;
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+/// v5 旧表的读写（与迁移前 AppDatabase 的 SQL 相同）。
+class _LegacyTables {
+  _LegacyTables(this.db);
+
+  final AppDatabase db;
+
+  Future<void> bulkLoad(
+    Iterable<MapEntry<DateTime, Map<int, Map<String, Duration>>>> days,
+  ) async {
+    final daily = <DailyUsageEntriesCompanion>[];
+    final hourly = <HourlyUsageEntriesCompanion>[];
+    Future<void> flush() async {
+      await db.batch((batch) {
+        batch.insertAll(db.dailyUsageEntries, daily);
+        batch.insertAll(db.hourlyUsageEntries, hourly);
+      });
+      daily.clear();
+      hourly.clear();
+    }
+
+    for (final entry in days) {
+      final totals = <String, int>{};
+      entry.value.forEach((hour, perApp) {
+        perApp.forEach((appId, duration) {
+          totals[appId] = (totals[appId] ?? 0) + duration.inSeconds;
+          hourly.add(
+            HourlyUsageEntriesCompanion.insert(
+              date: entry.key,
+              hourIndex: hour,
+              appId: appId,
+              durationSeconds: duration.inSeconds,
+            ),
+          );
+        });
+      });
+      totals.forEach((appId, seconds) {
+        daily.add(
+          DailyUsageEntriesCompanion.insert(
+            date: entry.key,
+            appId: appId,
+            durationSeconds: seconds,
+          ),
+        );
+      });
+      if (hourly.length > 20000) await flush();
+    }
+    await flush();
+  }
+
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    final rows = await (db.select(
+      db.dailyUsageEntries,
+    )..where((tbl) => tbl.date.isBetweenValues(start, end))).get();
+    final result = <DateTime, Map<String, Duration>>{};
+    for (final row in rows) {
+      final perApp = result.putIfAbsent(row.date, () => {});
+      perApp[row.appId] =
+          (perApp[row.appId] ?? Duration.zero) +
+          Duration(seconds: row.durationSeconds);
+    }
+    return result;
+  }
+
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    final rows = await (db.select(
+      db.hourlyUsageEntries,
+    )..where((tbl) => tbl.date.isBetweenValues(start, end))).get();
+    final result = <DateTime, Map<int, Map<String, Duration>>>{};
+    for (final row in rows) {
+      final perApp = result
+          .putIfAbsent(row.date, () => {})
+          .putIfAbsent(row.hourIndex, () => {});
+      perApp[row.appId] =
+          (perApp[row.appId] ?? Duration.zero) +
+          Duration(seconds: row.durationSeconds);
+    }
+    return result;
+  }
+
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return db.transaction(() async {
+      for (final dayEntry in delta.entries) {
+        for (final hourEntry in dayEntry.value.entries) {
+          for (final appEntry in hourEntry.value.entries) {
+            await db.customInsert(
+              'INSERT INTO hourly_usage_entries '
+              '(date, hour_index, app_id, duration_seconds) '
+              'VALUES (?1, ?2, ?3, ?4) '
+              'ON CONFLICT(date, hour_index, app_id) DO UPDATE SET '
+              'duration_seconds = duration_seconds + excluded.duration_seconds',
+              variables: [
+                Variable<DateTime>(dayEntry.key),
+                Variable<int>(hourEntry.key),
+                Variable<String>(appEntry.key),
+                Variable<int>(appEntry.value.inSeconds),
+              ],
+            );
+          }
+        }
+      }
+    });
+  }
+}
+
+Map<String, double> _percentiles(String name, List<int> micros) {
+  micros.sort();
+  double at(double p) =>
+      micros[min(micros.length - 1, (p * micros.length).floor())] / 1000;
+  return {'${name}_p50_ms': at(0.5), '${name}_p99_ms': at(0.99)};
+}
+
+Future<Map<String, double>> _latency(
+  String name,
+  Future<void> Function(int round) body,
+) async {
+  await body(-1);
+  final samples = <int>[];
+  for (var i = 0; i < _rounds; i++) {
+    final watch = Stopwatch()..start();
+    await body(i);
+    samples.add(watch.elapsedMicroseconds);
+  }
+  return _percentiles(name, samples);
+}
+
+Future<int> _vacuumedBytes(AppDatabase db, File file) async {
+  await db.customStatement('VACUUM');
+  return file.length();
+}
+
+void main() {
+  test('v5 string-keyed vs v6 integer-keyed usage tables', () async {
+    final generator = SyntheticUsageGenerator(
+      seed: _envInt('RINGOTRACK_BENCH_SEED', 42),
+      years: _envInt('RINGOTRACK_BENCH_YEARS', 3),
+      appCount: _envInt('RINGOTRACK_BENCH_APPS', 50),
+    );
+    final lastYear = generator.lastDay.year;
+    final year = (
+      start: DateTime(lastYear, 1, 1),
+      end: DateTime(lastYear, 12, 31),
+    );
+    final month = (
+      start: DateTime(lastYear, 6, 1),
+      end: DateTime(lastYear, 6, 30),
+    );
+
+    final dir = await Directory.systemTemp.createTemp('ringotrack_schema_');
+    final v5File = File('${dir.path}${Platform.pathSeparator}v5.sqlite');
+    final v6File = File('${dir.path}${Platform.pathSeparator}v6.sqlite');
+    final v5Db = AppDatabase.forTesting(NativeDatabase(v5File));
+    final v6Db = AppDatabase.forTesting(NativeDatabase(v6File));
+    final v5 = _LegacyTables(v5Db);
+
+    // 先打开数据库（beforeOpen 的迁移在空库上是空操作），再写入旧表。
+    await v5Db.customSelect('SELECT 1').get();
+    await v5.bulkLoad(generator.days());
+    final rows = await v6Db.bulkLoadUsage(generator.days());
+
+    // 两种格式读出的结果一致。
+    expect(
+      await v6Db.loadHourlyRange(month.start, month.end),
+      await v5.loadHourlyRange(month.start, month.end),
+    );
+
+    Map<DateTime, Map<int, Map<String, Duration>>> flushDelta(int round) => {
+      generator.lastDay: {
+        21: {
+          generator.appIds[0]: const Duration(seconds: 4),
+          generator.appIds[(round + 2) % generator.appCount]: const Duration(
+            seconds: 1,
+          ),
+        },
+      },
+    };
+
+    final report = <String, Object>{
+      'seed': generator.seed,
+      'years': generator.years,
+      'apps': generator.appCount,
+      'rows': rows,
+      'v5_bytes': await _vacuumedBytes(v5Db, v5File),
+      'v6_bytes': await _vacuumedBytes(v6Db, v6File),
+      ...await _latency(
+        'v5_load_range_year',
+        (_) => v5.loadRange(year.start, year.end),
+      ),
+      ...await _latency(
+        'v6_load_range_year',
+        (_) => v6Db.loadRange(year.start, year.end),
+      ),
+      ...await _latency(
+        'v5_load_hourly_range_month',
+        (_) => v5.loadHourlyRange(month.start, month.end),
+      ),
+      ...await _latency(
+        'v6_load_hourly_range_month',
+        (_) => v6Db.loadHourlyRange(month.start, month.end),
+      ),
+      ...await _latency(
+        'v5_load_hourly_range_year',
+        (_) => v5.loadHourlyRange(year.start, year.end),
+      ),
+      ...await _latency(
+        'v6_load_hourly_range_year',
+        (_) => v6Db.loadHourlyRange(year.start, year.end),
+      ),
+      ...await _latency(
+        'v5_merge_hourly_flush',
+        (round) => v5.mergeHourlyUsage(flushDelta(round)),
+      ),
+      ...await _latency(
+        'v6_merge_hourly_flush',
+        (round) => v6Db.mergeHourlyUsage(flushDelta(round)),
+      ),
+    };
+
+    final migrateWatch = Stopwatch()..start();
+    report['migrated_rows'] = await v5Db.migrateLegacyUsage();
+    report['migrate_ms'] = migrateWatch.elapsedMilliseconds;
+    report['migrated_bytes'] = await _vacuumedBytes(v5Db, v5File);
+
+    await v5Db.close();
+    await v6Db.close();
+    await dir.delete(recursive: true);
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 20)));
+}
@@ -0,0 +1,112 @@
+// 多设备同步的增量体积与耗时基准（不在默认 `flutter test` 范围内）。
+//
+//   flutter test benchmark/usage_sync_benchmark_test.dart
+//
+// 设备 A 写入 SyntheticUsageGenerator 生成的多年历史，经共享目录首次
+// 同步到空的设备 B；随后 A 模拟一天的使用（每 5 秒一次落库，共 8 小时），
+// 再同步一次。对比首次 / 增量分段的字节数与 UsageArchive 全量导出的
+// 字节数，并记录发布、拉取的耗时。
+//
+// 数据规模由 RINGOTRACK_BENCH_YEARS / RINGOTRACK_BENCH_APPS /
+// RINGOTRACK_BENCH_SEED 控制。结果输出为一行 JSON。
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/usage_archive.dart';
+import 'package:ringotrack/feature/database/services/usage_sync.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+
+int _envInt(String key, int fallback) =>
+    int.tryParse(Platform.environment[key] ?? '') ?? fallback;
+
+Future<int> _folderBytes(Directory dir) async {
+  var bytes = 0;
+  await for (final entity in dir.list(recursive: true)) {
+    if (entity is File) bytes += await entity.length();
+  }
+  return bytes;
+}
+
+void main() {
+  test('incremental sync delta vs full export', () async {
+    final generator = SyntheticUsageGenerator(
+      seed: _envInt('RINGOTRACK_BENCH_SEED', 42),
+      years: _envInt('RINGOTRACK_BENCH_YEARS', 3),
+      appCount: _envInt('RINGOTRACK_BENCH_APPS', 50),
+    );
+
+    final dir = await Directory.systemTemp.createTemp('ringotrack_sync_');
+    final folder = Directory('${dir.path}${Platform.pathSeparator}shared');
+    final dbA = AppDatabase.forTesting(NativeDatabase.memory());
+    final dbB = AppDatabase.forTesting(NativeDatabase.memory());
+    final syncA = UsageSync(dbA, folder);
+    final syncB = UsageSync(dbB, folder);
+    final rows = await dbA.bulkLoadUsage(generator.days());
+
+    var fullExportBytes = 0;
+    await for (final chunk in UsageArchive(dbA).export()) {
+      fullExportBytes += chunk.length;
+    }
+
+    final initialPublish = Stopwatch()..start();
+    final initialEntries = await syncA.publish();
+    initialPublish.stop();
+    final initialBytes = await _folderBytes(folder);
+    final initialPull = Stopwatch()..start();
+    await syncB.pull();
+    initialPull.stop();
+
+    // 一天 8 小时、每 5 秒一次落库，前台在 3 个应用之间切换。
+    final day = generator.lastDay.add(const Duration(days: 1));
+    for (var tick = 0; tick < 8 * 3600 ~/ 5; tick++) {
+      final hour = 14 + tick * 5 ~/ 3600;
+      final app = generator.appIds[(tick ~/ 120) % 3];
+      await dbA.mergeHourlyUsage({
+        day: {
+          hour: {app: const Duration(seconds: 5)},
+        },
+      });
+    }
+
+    final deltaPublish = Stopwatch()..start();
+    final deltaEntries = await syncA.publish();
+    deltaPublish.stop();
+    final deltaBytes = await _folderBytes(folder) - initialBytes;
+    final deltaPull = Stopwatch()..start();
+    final applied = (await syncB.pull()).applied;
+    deltaPull.stop();
+
+    expect(
+      await dbB.loadHourlyRange(day, day),
+      await dbA.loadHourlyRange(day, day),
+    );
+
+    final report = <String, Object>{
+      'seed': generator.seed,
+      'years': generator.years,
+      'apps': generator.appCount,
+      'rows': rows,
+      'full_export_bytes': fullExportBytes,
+      'initial_entries': initialEntries,
+      'initial_bytes': initialBytes,
+      'initial_publish_ms': initialPublish.elapsedMilliseconds,
+      'initial_pull_ms': initialPull.elapsedMilliseconds,
+      'delta_entries': deltaEntries,
+      'delta_applied': applied,
+      'delta_bytes': deltaBytes,
+      'delta_vs_full_export': deltaBytes / fullExportBytes,
+      'delta_publish_ms': deltaPublish.elapsedMilliseconds,
+      'delta_pull_ms': deltaPull.elapsedMilliseconds,
+    };
+
+    await dbA.close();
+    await dbB.close();
+    await dir.delete(recursive: true);
+
+    // ignore: avoid_print
+    print(jsonEncode(report));
+  }, timeout: const Timeout(Duration(minutes: 20)));
+}
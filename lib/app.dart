@@ -19,6 +19,8 @@ class RingoTrackApp extends ConsumerWidget {
   Widget build(BuildContext context, WidgetRef ref) {
     final themeAsync = ref.watch(appThemeProvider);
     final currentTheme = themeAsync.asData?.value ?? ringoGreenTheme;
+    // 可选的本机查询端点，随应用生命周期启动 / 关闭；不触发重建。
+    ref.listen(usageQueryServerProvider, (previous, next) {});
 
     final router = GoRouter(
       initialLocation: '/',
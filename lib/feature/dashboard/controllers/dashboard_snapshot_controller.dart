@@ -0,0 +1,17 @@
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_snapshot.dart';
+import 'package:ringotrack/feature/dashboard/providers/dashboard_providers.dart';
+
+/// 持有尚未被数据库结果替换的冷启动快照。
+///
+/// 初始值来自 [dashboardSnapshotSeedProvider]（main() 中同步读取后通过
+/// override 注入）。仪表盘 provider 用 `ref.read` 取快照，拿到数据库数据后
+/// 调用 [release]，之后的重建（切换年份、追踪列表变化等）不会再回到快照。
+class DashboardSnapshotController extends Notifier<DashboardSnapshot?> {
+  @override
+  DashboardSnapshot? build() => ref.read(dashboardSnapshotSeedProvider);
+
+  void release() {
+    if (state != null) state = null;
+  }
+}
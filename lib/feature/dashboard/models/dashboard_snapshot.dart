@@ -0,0 +1,240 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/usage/models/day_number.dart';
+
+/// 仪表盘冷启动快照：上次运行时仪表盘已经展示过的聚合数据。
+///
+/// 启动时先用快照绘制热力图、指标与当日小时分布，数据库加载完成后再用
+/// 真实数据替换。指标与应用排行都由日级数据现算，因此快照只保存：
+/// - 一段日期范围内的「日期 -> 应用 -> 时长」；
+/// - 某一天的「小时 -> 应用 -> 时长」。
+///
+/// 二进制布局（小端，v1）：
+/// ```
+/// u32 magic 'RTSN' | u16 version | u16 appCount | i64 writtenAtMs
+/// i32 rangeStartDay | i32 rangeEndDay | i32 hourlyDay
+/// u32 dailyCount | u32 hourlyCount
+/// appCount × (u16 byteLength, utf8 bytes)
+/// dailyCount × (i32 day, u16 app, u32 seconds)
+/// hourlyCount × (u8 hour, u16 app, u32 seconds)
+/// u32 fnv1a(前面所有字节)
+/// ```
+/// 日期均为 [dayNumberOf] 的日序号；时长按整秒保存。
+class DashboardSnapshot {
+  DashboardSnapshot({
+    required this.writtenAt,
+    required this.rangeStart,
+    required this.rangeEnd,
+    required this.daily,
+    this.hourlyDay,
+    this.hourly = const {},
+  });
+
+  static const int magic = 0x4E535452; // 'RTSN'
+  static const int version = 1;
+
+  static const int _headerBytes = 36;
+  static const int _noHourlyDay = -0x80000000;
+
+  final DateTime writtenAt;
+
+  /// [daily] 覆盖的日期范围（含两端），范围内没有记录的日期即为 0。
+  final DateTime rangeStart;
+  final DateTime rangeEnd;
+  final Map<DateTime, Map<String, Duration>> daily;
+
+  /// [hourly] 对应的日期；为空表示快照不含小时数据。
+  final DateTime? hourlyDay;
+  final Map<int, Map<String, Duration>> hourly;
+
+  /// 快照的日级数据是否完整覆盖 [start, end]。
+  bool covers(DateTime start, DateTime end) {
+    return !start.isBefore(rangeStart) && !end.isAfter(rangeEnd);
+  }
+
+  /// [start, end] 内日级数据的深拷贝。
+  Map<DateTime, Map<String, Duration>> dailyIn(DateTime start, DateTime end) {
+    return {
+      for (final entry in daily.entries)
+        if (!entry.key.isBefore(start) && !entry.key.isAfter(end))
+          entry.key: Map<String, Duration>.from(entry.value),
+    };
+  }
+
+  /// [day] 的小时级数据深拷贝；快照不含该日时返回 null。
+  Map<int, Map<String, Duration>>? hourlyFor(DateTime day) {
+    if (hourlyDay != day) return null;
+    return hourly.map(
+      (hour, perApp) => MapEntry(hour, Map<String, Duration>.from(perApp)),
+    );
+  }
+
+  Uint8List encode() {
+    final appIndex = <String, int>{};
+    final appBytes = <Uint8List>[];
+    int indexOf(String appId) {
+      return appIndex.putIfAbsent(appId, () {
+        appBytes.add(utf8.encode(appId));
+        return appBytes.length - 1;
+      });
+    }
+
+    final dailyRows = <(int, int, int)>[];
+    daily.forEach((day, perApp) {
+      final dayNumber = dayNumberOf(day);
+      perApp.forEach((appId, duration) {
+        if (duration.inSeconds <= 0) return;
+        dailyRows.add((dayNumber, indexOf(appId), duration.inSeconds));
+      });
+    });
+    final hourlyRows = <(int, int, int)>[];
+    if (hourlyDay != null) {
+      hourly.forEach((hour, perApp) {
+        perApp.forEach((appId, duration) {
+          if (duration.inSeconds <= 0) return;
+          hourlyRows.add((hour, indexOf(appId), duration.inSeconds));
+        });
+      });
+    }
+
+    final length =
+        _headerBytes +
+        appBytes.fold<int>(0, (sum, bytes) => sum + 2 + bytes.length) +
+        dailyRows.length * 10 +
+        hourlyRows.length * 7 +
+        4;
+    final data = ByteData(length);
+    var offset = 0;
+    void u8(int v) => data.setUint8(offset++, v);
+    void u16(int v) {
+      data.setUint16(offset, v, Endian.little);
+      offset += 2;
+    }
+
+    void u32(int v) {
+      data.setUint32(offset, v, Endian.little);
+      offset += 4;
+    }
+
+    void i32(int v) {
+      data.setInt32(offset, v, Endian.little);
+      offset += 4;
+    }
+
+    u32(magic);
+    u16(version);
+    u16(appBytes.length);
+    data.setInt64(offset, writtenAt.millisecondsSinceEpoch, Endian.little);
+    offset += 8;
+    i32(dayNumberOf(rangeStart));
+    i32(dayNumberOf(rangeEnd));
+    i32(hourlyDay == null ? _noHourlyDay : dayNumberOf(hourlyDay!));
+    u32(dailyRows.length);
+    u32(hourlyRows.length);
+
+    final bytes = data.buffer.asUint8List();
+    for (final app in appBytes) {
+      u16(app.length);
+      bytes.setRange(offset, offset + app.length, app);
+      offset += app.length;
+    }
+    for (final (day, app, seconds) in dailyRows) {
+      i32(day);
+      u16(app);
+      u32(seconds);
+    }
+    for (final (hour, app, seconds) in hourlyRows) {
+      u8(hour);
+      u16(app);
+      u32(seconds);
+    }
+    u32(_fnv1a(bytes, offset));
+    return bytes;
+  }
+
+  /// 解析 [encode] 的输出；魔数、版本、长度或校验和不符时返回 null，
+  /// 调用方直接回退到数据库加载。
+  static DashboardSnapshot? decode(Uint8List bytes) {
+    if (bytes.length < _headerBytes + 4) return null;
+    final data = ByteData.sublistView(bytes);
+    final bodyLength = bytes.length - 4;
+    if (data.getUint32(bodyLength, Endian.little) !=
+        _fnv1a(bytes, bodyLength)) {
+      return null;
+    }
+    if (data.getUint32(0, Endian.little) != magic ||
+        data.getUint16(4, Endian.little) != version) {
+      return null;
+    }
+
+    try {
+      final appCount = data.getUint16(6, Endian.little);
+      final writtenAt = DateTime.fromMillisecondsSinceEpoch(
+        data.getInt64(8, Endian.little),
+      );
+      final rangeStart = data.getInt32(16, Endian.little);
+      final rangeEnd = data.getInt32(20, Endian.little);
+      final hourlyDay = data.getInt32(24, Endian.little);
+      final dailyCount = data.getUint32(28, Endian.little);
+      final hourlyCount = data.getUint32(32, Endian.little);
+
+      var offset = _headerBytes;
+      final apps = <String>[];
+      for (var i = 0; i < appCount; i++) {
+        final length = data.getUint16(offset, Endian.little);
+        offset += 2;
+        if (offset + length > bodyLength) return null;
+        apps.add(
+          utf8.decode(Uint8List.sublistView(bytes, offset, offset + length)),
+        );
+        offset += length;
+      }
+      if (offset + dailyCount * 10 + hourlyCount * 7 != bodyLength) {
+        return null;
+      }
+
+      final daily = <DateTime, Map<String, Duration>>{};
+      for (var i = 0; i < dailyCount; i++) {
+        final day = dateOfDayNumber(data.getInt32(offset, Endian.little));
+        final app = apps[data.getUint16(offset + 4, Endian.little)];
+        final seconds = data.getUint32(offset + 6, Endian.little);
+        offset += 10;
+        daily.putIfAbsent(day, () => {})[app] = Duration(seconds: seconds);
+      }
+      final hourly = <int, Map<String, Duration>>{};
+      for (var i = 0; i < hourlyCount; i++) {
+        final hour = data.getUint8(offset);
+        final app = apps[data.getUint16(offset + 1, Endian.little)];
+        final seconds = data.getUint32(offset + 3, Endian.little);
+        offset += 7;
+        if (hour > 23) return null;
+        hourly.putIfAbsent(hour, () => {})[app] = Duration(seconds: seconds);
+      }
+
+      return DashboardSnapshot(
+        writtenAt: writtenAt,
+        rangeStart: dateOfDayNumber(rangeStart),
+        rangeEnd: dateOfDayNumber(rangeEnd),
+        daily: daily,
+        hourlyDay: hourlyDay == _noHourlyDay
+            ? null
+            : dateOfDayNumber(hourlyDay),
+        hourly: hourly,
+      );
+    } on RangeError {
+      return null;
+    } on FormatException {
+      return null;
+    }
+  }
+
+  static int _fnv1a(Uint8List bytes, int length) {
+    var hash = 0x811C9DC5;
+    for (var i = 0; i < length; i++) {
+      hash ^= bytes[i];
+      hash = (hash * 0x01000193) & 0xFFFFFFFF;
+    }
+    return hash;
+  }
+}
@@ -1,6 +1,13 @@
+import 'dart:async';
+
+import 'package:flutter/services.dart';
+import 'package:flutter/widgets.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_snapshot.dart';
 import 'package:ringotrack/feature/dashboard/controllers/dashboard_preferences_controller.dart';
+import 'package:ringotrack/feature/dashboard/controllers/dashboard_snapshot_controller.dart';
+import 'package:ringotrack/feature/dashboard/services/dashboard_snapshot_store.dart';
 
 final dashboardPreferencesRepositoryProvider =
     Provider<DashboardPreferencesRepository>((ref) {
@@ -21,3 +28,40 @@ final windowsGlassEffectDisplayProvider = FutureProvider<bool>((ref) async {
   final prefs = await repo.load();
   return prefs.enableGlassEffect;
 });
+
+/// main() 中同步读取的冷启动快照，通过 override 注入；未注入时为空。
+final dashboardSnapshotSeedProvider = Provider<DashboardSnapshot?>(
+  (ref) => null,
+);
+
+final dashboardSnapshotProvider =
+    NotifierProvider<DashboardSnapshotController, DashboardSnapshot?>(
+      DashboardSnapshotController.new,
+    );
+
+final dashboardSnapshotStoreProvider = Provider<DashboardSnapshotStore>((ref) {
+  return DashboardSnapshotStore.defaultLocation();
+});
+
+/// 仪表盘数据的快照写入器；退出或窗口隐藏时立即落盘，保证下次冷启动
+/// 拿到的是最新数据。
+final dashboardSnapshotWriterProvider = Provider<DashboardSnapshotWriter>((
+  ref,
+) {
+  final writer = DashboardSnapshotWriter(
+    ref.watch(dashboardSnapshotStoreProvider),
+  );
+  final lifecycle = AppLifecycleListener(
+    onHide: () => unawaited(writer.flush()),
+    onExitRequested: () async {
+      await writer.flush();
+      return AppExitResponse.exit;
+    },
+  );
+  ref.onDispose(() {
+    lifecycle.dispose();
+    unawaited(writer.flush());
+    writer.dispose();
+  });
+  return writer;
+});
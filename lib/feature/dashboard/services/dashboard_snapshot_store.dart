@@ -0,0 +1,155 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_snapshot.dart';
+
+/// 仪表盘快照文件的读写。
+///
+/// 读取是同步的：文件只有几十 KB，在 runApp 之前读完即可让首帧直接带数据，
+/// 不必等待数据库打开。写入先写临时文件再 rename，进程中途退出也不会留下
+/// 半截快照；即便如此，[DashboardSnapshot.decode] 仍会校验后再使用。
+class DashboardSnapshotStore {
+  DashboardSnapshotStore(this.file);
+
+  /// 与日志目录同级：`<应用数据目录>/RingoTrack/cache/dashboard.snapshot`。
+  factory DashboardSnapshotStore.defaultLocation() {
+    final separator = Platform.pathSeparator;
+    return DashboardSnapshotStore(
+      File('${_resolveCacheDirectory().path}${separator}dashboard.snapshot'),
+    );
+  }
+
+  /// 设置该环境变量（任意非空值）时启动不读取快照，用于对比冷启动耗时。
+  static const disableEnvironmentKey = 'RINGOTRACK_DISABLE_SNAPSHOT';
+
+  final File file;
+
+  static bool get disabledByEnvironment =>
+      Platform.environment[disableEnvironmentKey]?.isNotEmpty == true;
+
+  /// 读取并校验快照；文件不存在、损坏或版本不符时返回 null。
+  DashboardSnapshot? loadSync() {
+    try {
+      if (!file.existsSync()) return null;
+      return DashboardSnapshot.decode(file.readAsBytesSync());
+    } on FileSystemException catch (e) {
+      if (kDebugMode) {
+        debugPrint('[DashboardSnapshotStore] load failed: $e');
+      }
+      return null;
+    }
+  }
+
+  Future<void> write(DashboardSnapshot snapshot) async {
+    final temp = File('${file.path}.tmp');
+    await temp.parent.create(recursive: true);
+    await temp.writeAsBytes(snapshot.encode(), flush: true);
+    await temp.rename(file.path);
+  }
+
+  static Directory _resolveCacheDirectory() {
+    final separator = Platform.pathSeparator;
+
+    if (Platform.isWindows) {
+      final appData = Platform.environment['APPDATA'];
+      final base = appData?.isNotEmpty == true
+          ? appData!
+          : Directory.current.path;
+      return Directory('$base${separator}RingoTrack${separator}cache');
+    }
+
+    if (Platform.isMacOS) {
+      final home = Platform.environment['HOME'];
+      final base = home?.isNotEmpty == true ? home! : Directory.current.path;
+      return Directory(
+        '$base${separator}Library${separator}Application Support${separator}RingoTrack${separator}cache',
+      );
+    }
+
+    return Directory('cache');
+  }
+}
+
+/// 收集仪表盘最新展示的数据，节流写入快照。
+///
+/// provider 每次产出新数据时调用 update*，只标记脏并在 [writeInterval]
+/// 后写一次；退出或窗口隐藏时调用 [flush] 立即落盘。写入串行执行。
+class DashboardSnapshotWriter {
+  DashboardSnapshotWriter(
+    this._store, {
+    this.writeInterval = const Duration(seconds: 30),
+    DateTime Function()? clock,
+  }) : _clock = clock ?? DateTime.now;
+
+  final DashboardSnapshotStore _store;
+  final Duration writeInterval;
+  final DateTime Function() _clock;
+
+  ({DateTime start, DateTime end})? _range;
+  Map<DateTime, Map<String, Duration>> _daily = const {};
+  DateTime? _hourlyDay;
+  Map<int, Map<String, Duration>> _hourly = const {};
+
+  bool _dirty = false;
+  Timer? _timer;
+  Future<void> _writing = Future.value();
+
+  /// 记录 [start, end] 的日级数据。[usage] 由调用方保证之后不再修改。
+  void updateDaily(
+    DateTime start,
+    DateTime end,
+    Map<DateTime, Map<String, Duration>> usage,
+  ) {
+    _range = (start: start, end: end);
+    _daily = usage;
+    _markDirty();
+  }
+
+  /// 记录 [day] 的小时级数据。[usage] 由调用方保证之后不再修改。
+  void updateHourly(DateTime day, Map<int, Map<String, Duration>> usage) {
+    _hourlyDay = day;
+    _hourly = usage;
+    _markDirty();
+  }
+
+  /// 有未写入的数据时立即写入，返回本次写入完成的 Future。
+  Future<void> flush() {
+    _timer?.cancel();
+    _timer = null;
+    final range = _range;
+    if (!_dirty || range == null) return _writing;
+    _dirty = false;
+
+    final snapshot = DashboardSnapshot(
+      writtenAt: _clock(),
+      rangeStart: range.start,
+      rangeEnd: range.end,
+      daily: _daily,
+      hourlyDay: _hourlyDay,
+      hourly: _hourly,
+    );
+    return _writing = _writing.then((_) async {
+      try {
+        await _store.write(snapshot);
+      } on FileSystemException catch (e) {
+        if (kDebugMode) {
+          debugPrint('[DashboardSnapshotWriter] write failed: $e');
+        }
+      }
+    });
+  }
+
+  void dispose() {
+    _timer?.cancel();
+    _timer = null;
+  }
+
+  void _markDirty() {
+    _dirty = true;
+    _timer ??= Timer(writeInterval, () {
+      _timer = null;
+      unawaited(flush());
+    });
+  }
+}
@@ -0,0 +1,43 @@
+import 'package:flutter/widgets.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+
+/// 冷启动计时：从 main() 开始，到仪表盘第一次画出带数据的一帧为止。
+///
+/// 结果写入日志（tag `startup`），并注明首帧数据来自快照还是数据库，
+/// 设置环境变量 `RINGOTRACK_DISABLE_SNAPSHOT=1` 启动即可对比两种冷启动。
+class StartupTiming {
+  StartupTiming._();
+
+  static final Stopwatch _sinceLaunch = Stopwatch();
+  static String _dataSource = 'database';
+  static bool _reported = false;
+
+  static void markLaunch() {
+    _sinceLaunch
+      ..reset()
+      ..start();
+  }
+
+  /// 仪表盘数据 provider 产出数据前调用，记录本次数据的来源。
+  static void noteDataSource(String source) {
+    if (!_reported) _dataSource = source;
+  }
+
+  /// 仪表盘拿到数据后调用；只在第一次调用后的那一帧绘制完成时记录一次。
+  static void reportFirstMeaningfulFrame() {
+    if (_reported || !_sinceLaunch.isRunning) return;
+    _reported = true;
+    final source = _dataSource;
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      _sinceLaunch.stop();
+      final elapsed = _sinceLaunch.elapsedMilliseconds;
+      debugPrint(
+        '[StartupTiming] first meaningful frame: ${elapsed}ms ($source)',
+      );
+      AppLogService.instance.logInfo(
+        'startup',
+        'first meaningful frame ${elapsed}ms source=$source',
+      );
+    });
+  }
+}
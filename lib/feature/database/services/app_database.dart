@@ -1,9 +1,17 @@
 import 'package:drift/drift.dart';
 import 'package:drift_flutter/drift_flutter.dart';
+import 'package:ringotrack/feature/database/services/app_dictionary.dart';
+import 'package:ringotrack/feature/database/services/compact_usage_store.dart';
+import 'package:ringotrack/feature/usage/models/day_number.dart';
+import 'package:ringotrack/feature/usage/models/document_usage.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
 import 'package:ringotrack/feature/usage/models/usage_hourly_backfill.dart';
 
 part 'app_database.g.dart';
 
+/// v5 及更早版本的日表：v6 起只作为迁移来源，打开数据库时由
+/// [AppDatabase.migrateLegacyUsage] 搬到整数键的 daily_usage。
 class DailyUsageEntries extends Table {
   /// 归一化到当天 00:00 的本地日期
   DateTimeColumn get date => dateTime()();
@@ -18,6 +26,7 @@ class DailyUsageEntries extends Table {
   Set<Column<Object>> get primaryKey => {date, appId};
 }
 
+/// v5 及更早版本的小时表：v6 起只作为迁移来源（同上，搬到 hourly_usage）。
 class HourlyUsageEntries extends Table {
   /// 归一化到当天 00:00 的本地日期
   DateTimeColumn get date => dateTime()();
@@ -42,22 +51,585 @@ class AppDatabase extends _$AppDatabase {
   AppDatabase.forTesting(super.executor);
 
   @override
-  int get schemaVersion => 2;
+  int get schemaVersion => 11;
 
   @override
   MigrationStrategy get migration {
     return MigrationStrategy(
-      onCreate: (m) => m.createAll(),
+      onCreate: (m) async {
+        await m.createAll();
+        await _createDocumentTables();
+        await CompactUsageStore.createTables(this);
+        await _createSecondaryUsageTable();
+        await _createUsageTables();
+        await _createSessionTable();
+        await _createSyncTables();
+        await _createHourOfWeekTable();
+        await _createBusyUsageTable();
+        await _createSideUsageTables();
+      },
       onUpgrade: (m, from, to) async {
         if (from < 2) {
           // 新版本引入了小时级 usage 表，并基于旧的日级数据进行回填。
           await m.createTable(hourlyUsageEntries);
           await backfillDailyUsageToHourly(now: DateTime.now());
         }
+        if (from < 3) {
+          // 按文档统计：旧数据没有标题信息，无需回填。
+          await _createDocumentTables();
+        }
+        if (from < 4) {
+          // 全量记录模式的紧凑存储；开启该模式时再从小时表导入历史。
+          await CompactUsageStore.createTables(this);
+        }
+        if (from < 5) {
+          // 副屏可见时长：新功能，无历史可回填。
+          await _createSecondaryUsageTable();
+        }
+        if (from < 6) {
+          // 整数键的日表 / 小时表；旧表中的数据在 beforeOpen 中分块搬运。
+          await _createUsageTables();
+        }
+        if (from < 7) {
+          // 绘画会话：无法从小时表还原，只记录升级之后的会话。
+          await _createSessionTable();
+        }
+        if (from < 8) {
+          // 多设备同步：已有的小时数据都算本机的贡献，首次发布时全部带上。
+          await _createSyncTables();
+          await customStatement(
+            'INSERT OR IGNORE INTO usage_change_log (packed_key) '
+            'SELECT packed_key FROM hourly_usage ORDER BY packed_key',
+          );
+        }
+        if (from < 9) {
+          // 周内小时聚合：建表与触发器后从小时表一次性回填。
+          await _createHourOfWeekTable();
+          await rebuildHourOfWeekUsage();
+        }
+        if (from < 10) {
+          // 前台进程忙碌时长：新功能，无历史可回填。
+          await _createBusyUsageTable();
+        }
+        if (from < 11) {
+          // 按文档 / 副屏用量改为打包整数键；旧表的数据在 beforeOpen 中
+          // 与 v6 的日表 / 小时表一样分块搬运。
+          await _createSideUsageTables();
+        }
       },
+      beforeOpen: (details) async {
+        // 每次打开都检查：上次搬运中途退出时从剩余的行继续，旧表为空时
+        // 只有两次空查询。
+        await migrateLegacyUsage();
+      },
+    );
+  }
+
+  /// appId 字典，日表 / 小时表与紧凑存储共用。
+  late final AppDictionary appDictionary = AppDictionary(this);
+
+  /// hourly_usage 的打包主键：`(日序号 * 24 + 小时) << 20 | 应用 id`。
+  ///
+  /// 同一天的 24 个小时、同一小时的所有应用在主键上连续，按日期范围查询
+  /// 是一段连续的主键区间；应用 id 不超过 2^20。
+  static const _appBits = 20;
+  static const _appMask = (1 << _appBits) - 1;
+
+  static int _hourlyKey(int day, int hour, int app) =>
+      ((day * 24 + hour) << _appBits) | app;
+
+  /// 供归档导入导出、多设备同步等直接读写 hourly_usage 的代码使用。
+  static const hourlyAppMask = _appMask;
+
+  static int packHourlyKey(int day, int hour, int app) =>
+      _hourlyKey(day, hour, app);
+
+  /// 1970 年之前的日序号为负：右移是算术移位，日与小时按向下取整拆分
+  /// （`~/` 与 SQL 的 `/` 都向 0 截断，不能直接用）。
+  static ({int day, int hour, int app}) unpackHourlyKey(int key) {
+    final dayHour = key >> _appBits;
+    final hour = dayHour % 24;
+    return (day: (dayHour - hour) ~/ 24, hour: hour, app: key & _appMask);
+  }
+
+  /// SQL 表达式：打包主键 [key]（列名）对应的小时（0-23），负日序号同样
+  /// 适用（SQLite 的 `%` 结果与被除数同号）。
+  static String hourlyHourSql(String key) =>
+      '(((($key >> $_appBits) % 24) + 24) % 24)';
+
+  /// SQL 表达式：打包主键 [key]（列名）对应的日序号，向下取整。
+  static String hourlyDaySql(String key) =>
+      '((($key >> $_appBits) - ${hourlyHourSql(key)}) / 24)';
+
+  /// SQL 表达式：打包主键 [key]（列名）对应的年份、应用与周内小时格子，
+  /// 格子为「周一 0 点 = 0」，见 [HourOfWeekUsage]。日序号 0 是周四。
+  static String _hourOfWeekColumns(String key) {
+    final day = hourlyDaySql(key);
+    return "CAST(strftime('%Y', $day * 86400, 'unixepoch') AS INTEGER), "
+        '$key & $_appMask, '
+        '(((($day + 3) % 7) + 7) % 7) * 24 + ${hourlyHourSql(key)}';
+  }
+
+  /// 以 hourly_usage 打包主键为键的表，按应用 / 日期删除时一起处理。
+  static const _hourlyKeyedTables = [
+    'hourly_usage',
+    'device_usage',
+    'usage_change_log',
+    'busy_usage',
+    'secondary_usage',
+    'document_usage',
+  ];
+
+  static int _firstHourlyKey(DateTime day) =>
+      _hourlyKey(dayNumberOf(day), 0, 0);
+
+  static int _lastHourlyKey(DateTime day) =>
+      _hourlyKey(dayNumberOf(day), 23, _appMask);
+
+  /// 整数键的日表与小时表（v6）：appId 只在 app_dictionary 中存一次，
+  /// 日期为 [dayNumberOf] 日序号，两张表都使用 WITHOUT ROWID。
+  Future<void> _createUsageTables() async {
+    await AppDictionary.createTable(this);
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS daily_usage ('
+      'day INTEGER NOT NULL, '
+      'app INTEGER NOT NULL, '
+      'seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (day, app)) WITHOUT ROWID',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS hourly_usage ('
+      'packed_key INTEGER NOT NULL PRIMARY KEY, '
+      'seconds INTEGER NOT NULL) WITHOUT ROWID',
+    );
+  }
+
+  /// 在事务中执行 [body]；失败回滚后本次新驻留的应用 id 可能已不存在，
+  /// 字典缓存整体作废。
+  Future<T> _dictionaryTransaction<T>(Future<T> Function() body) async {
+    try {
+      return await transaction(body);
+    } catch (_) {
+      appDictionary.reset();
+      rethrow;
+    }
+  }
+
+  Future<void> _addDailySeconds(int day, int app, int seconds) {
+    return customInsert(
+      'INSERT INTO daily_usage (day, app, seconds) VALUES (?1, ?2, ?3) '
+      'ON CONFLICT(day, app) DO UPDATE SET '
+      'seconds = seconds + excluded.seconds',
+      variables: [
+        Variable<int>(day),
+        Variable<int>(app),
+        Variable<int>(seconds),
+      ],
+    );
+  }
+
+  /// 本机写入的小时时长，同时记入变更日志（见 [_createSyncTables]）。
+  Future<void> _addHourlySeconds(int key, int seconds) async {
+    await customInsert(
+      'INSERT INTO hourly_usage (packed_key, seconds) VALUES (?1, ?2) '
+      'ON CONFLICT(packed_key) DO UPDATE SET '
+      'seconds = seconds + excluded.seconds',
+      variables: [Variable<int>(key), Variable<int>(seconds)],
+    );
+    await customInsert(logLocalChangeSql, variables: [Variable<int>(key)]);
+  }
+
+  /// 把一个小时键记为本机最近一次改动（REPLACE 使旧序号的行被删除）。
+  static const logLocalChangeSql =
+      'INSERT OR REPLACE INTO usage_change_log (packed_key) VALUES (?1)';
+
+  /// 「年 + 应用 + 周内小时」聚合（v9）：年度打卡图只需读 168 个格子
+  /// 而不是全年的小时行。
+  ///
+  /// 由 hourly_usage 上的触发器维护，与写入小时表的语句处于同一事务；
+  /// 守护进程、同步、归档导入等直接写小时表的路径也无需额外处理。
+  /// REPLACE 冲突删除旧行时不触发 DELETE 触发器，写小时表需用 upsert。
+  Future<void> _createHourOfWeekTable() async {
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS weekly_hour_usage ('
+      'year INTEGER NOT NULL, '
+      'app INTEGER NOT NULL, '
+      'cell INTEGER NOT NULL, '
+      'seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (year, app, cell)) WITHOUT ROWID',
+    );
+    const upsert =
+        'INSERT INTO weekly_hour_usage (year, app, cell, seconds) VALUES';
+    const accumulate =
+        'ON CONFLICT(year, app, cell) DO UPDATE SET '
+        'seconds = seconds + excluded.seconds;';
+    await customStatement(
+      'CREATE TRIGGER IF NOT EXISTS hourly_usage_week_insert '
+      'AFTER INSERT ON hourly_usage BEGIN '
+      '$upsert (${_hourOfWeekColumns('NEW.packed_key')}, NEW.seconds) '
+      '$accumulate END',
+    );
+    await customStatement(
+      'CREATE TRIGGER IF NOT EXISTS hourly_usage_week_update '
+      'AFTER UPDATE OF seconds ON hourly_usage BEGIN '
+      '$upsert (${_hourOfWeekColumns('NEW.packed_key')}, '
+      'NEW.seconds - OLD.seconds) $accumulate END',
+    );
+    final oldCell =
+        '(year, app, cell) = (${_hourOfWeekColumns('OLD.packed_key')})';
+    await customStatement(
+      'CREATE TRIGGER IF NOT EXISTS hourly_usage_week_delete '
+      'AFTER DELETE ON hourly_usage BEGIN '
+      'UPDATE weekly_hour_usage SET seconds = seconds - OLD.seconds '
+      'WHERE $oldCell; '
+      'DELETE FROM weekly_hour_usage WHERE $oldCell AND seconds <= 0; END',
+    );
+  }
+
+  /// 从 hourly_usage 重建周内小时聚合（升级回填，或怀疑不一致时修复）。
+  Future<void> rebuildHourOfWeekUsage() {
+    return transaction(() async {
+      await customStatement('DELETE FROM weekly_hour_usage');
+      await customStatement(
+        'INSERT INTO weekly_hour_usage (year, app, cell, seconds) '
+        'SELECT ${_hourOfWeekColumns('packed_key')}, SUM(seconds) '
+        'FROM hourly_usage GROUP BY 1, 2, 3',
+      );
+    });
+  }
+
+  /// [firstYear]..[lastYear]（含）内各应用的周内小时分布。
+  Future<HourOfWeekUsage> loadHourOfWeekUsage(
+    int firstYear,
+    int lastYear,
+  ) async {
+    final rows = await customSelect(
+      'SELECT a.app_id, w.cell, SUM(w.seconds) AS seconds '
+      'FROM weekly_hour_usage w JOIN app_dictionary a ON a.id = w.app '
+      'WHERE w.year BETWEEN ?1 AND ?2 GROUP BY w.app, w.cell',
+      variables: [Variable<int>(firstYear), Variable<int>(lastYear)],
+    ).get();
+
+    final secondsByApp = <String, List<int>>{};
+    for (final row in rows) {
+      final cells = secondsByApp.putIfAbsent(
+        row.read<String>('app_id'),
+        () => List.filled(HourOfWeekUsage.cellCount, 0),
+      );
+      cells[row.read<int>('cell')] = row.read<int>('seconds');
+    }
+    return HourOfWeekUsage(secondsByApp);
+  }
+
+  /// 多设备同步（v8），见 `UsageSync`：
+  /// - sync_devices：id 0 为本机，seq 为已发布到的变更序号；其余为远端
+  ///   设备，seq 为已应用到的序号；
+  /// - device_usage：远端设备对各小时键的贡献（G-counter 的分量，只取
+  ///   最大值）。本机分量 = hourly_usage - 远端分量之和，不单独存储；
+  /// - usage_change_log：本机改动过的小时键，每个键只保留最近的序号，
+  ///   AUTOINCREMENT 保证序号不回退。
+  Future<void> _createSyncTables() async {
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS sync_devices ('
+      'id INTEGER PRIMARY KEY, '
+      'device_uuid TEXT NOT NULL UNIQUE, '
+      'seq INTEGER NOT NULL DEFAULT 0)',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS device_usage ('
+      'packed_key INTEGER NOT NULL, '
+      'device INTEGER NOT NULL, '
+      'seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (packed_key, device)) WITHOUT ROWID',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS usage_change_log ('
+      'seq INTEGER PRIMARY KEY AUTOINCREMENT, '
+      'packed_key INTEGER NOT NULL UNIQUE)',
     );
   }
 
+  /// 把 v5 及更早版本的日表 / 小时表、v10 及更早版本的按文档 / 副屏
+  /// 小时表分块搬到整数键的新表，返回搬运的行数。
+  ///
+  /// 每块一个事务：读出最多 [chunkRows] 行 -> 累加写入新表 -> 删除读出的
+  /// 旧行。中途退出时已提交的块不会重复计入，下次从剩余的行继续；内存
+  /// 占用只与块大小有关。
+  Future<int> migrateLegacyUsage({int chunkRows = 5000}) async {
+    final movers = <Future<int> Function()>[
+      () => _moveLegacyChunk(hourly: false, limit: chunkRows),
+      () => _moveLegacyChunk(hourly: true, limit: chunkRows),
+      () => _moveLegacySecondaryChunk(chunkRows),
+      () => _moveLegacyDocumentChunk(chunkRows),
+    ];
+    var moved = 0;
+    for (final move in movers) {
+      while (true) {
+        final count = await move();
+        if (count == 0) break;
+        moved += count;
+      }
+    }
+    return moved;
+  }
+
+  Future<int> _moveLegacyChunk({required bool hourly, required int limit}) {
+    final table = hourly ? 'hourly_usage_entries' : 'daily_usage_entries';
+    return _dictionaryTransaction(() async {
+      final rows = await customSelect(
+        'SELECT rowid AS rid, date, ${hourly ? 'hour_index, ' : ''}'
+        'app_id, duration_seconds FROM $table ORDER BY rowid LIMIT ?1',
+        variables: [Variable<int>(limit)],
+      ).get();
+      if (rows.isEmpty) return 0;
+
+      for (final row in rows) {
+        final day = dayNumberOf(row.read<DateTime>('date'));
+        final app = await appDictionary.intern(row.read<String>('app_id'));
+        final seconds = row.read<int>('duration_seconds');
+        if (hourly) {
+          await _addHourlySeconds(
+            _hourlyKey(day, row.read<int>('hour_index'), app),
+            seconds,
+          );
+        } else {
+          await _addDailySeconds(day, app, seconds);
+        }
+      }
+      await customUpdate(
+        'DELETE FROM $table WHERE rowid <= ?1',
+        variables: [Variable<int>(rows.last.read<int>('rid'))],
+      );
+      return rows.length;
+    });
+  }
+
+  Future<int> _moveLegacySecondaryChunk(int limit) {
+    return _dictionaryTransaction(() async {
+      final rows = await customSelect(
+        'SELECT date, hour_index, app_id, duration_seconds '
+        'FROM hourly_secondary_usage_entries '
+        'ORDER BY date, hour_index, app_id LIMIT ?1',
+        variables: [Variable<int>(limit)],
+      ).get();
+      if (rows.isEmpty) return 0;
+
+      for (final row in rows) {
+        final app = await appDictionary.intern(row.read<String>('app_id'));
+        await _addKeyedSeconds(
+          'secondary_usage',
+          _hourlyKey(
+            dayNumberOf(row.read<DateTime>('date')),
+            row.read<int>('hour_index'),
+            app,
+          ),
+          row.read<int>('duration_seconds'),
+        );
+      }
+      // WITHOUT ROWID：按主键顺序读出，删除到最后一行为止。
+      final last = rows.last;
+      await customUpdate(
+        'DELETE FROM hourly_secondary_usage_entries '
+        'WHERE (date, hour_index, app_id) <= (?1, ?2, ?3)',
+        variables: [
+          Variable<int>(last.read<int>('date')),
+          Variable<int>(last.read<int>('hour_index')),
+          Variable<String>(last.read<String>('app_id')),
+        ],
+      );
+      return rows.length;
+    });
+  }
+
+  Future<int> _moveLegacyDocumentChunk(int limit) async {
+    try {
+      return await _dictionaryTransaction(() async {
+        final rows = await customSelect(
+          'SELECT u.date AS date, u.hour_index AS hour_index, '
+          'u.app_id AS app_id, u.doc_id AS doc_id, d.name AS name, '
+          'u.duration_seconds AS seconds '
+          'FROM hourly_document_usage_entries u '
+          'JOIN documents d ON d.id = u.doc_id '
+          'ORDER BY u.date, u.hour_index, u.app_id, u.doc_id LIMIT ?1',
+          variables: [Variable<int>(limit)],
+        ).get();
+        if (rows.isEmpty) {
+          // 只剩找不到文档名的行（或已搬完），连同旧文档字典一起清掉。
+          await customStatement('DELETE FROM hourly_document_usage_entries');
+          await customStatement('DELETE FROM documents');
+          return 0;
+        }
+
+        for (final row in rows) {
+          final appId = row.read<String>('app_id');
+          final app = await appDictionary.intern(appId);
+          await customInsert(
+            'INSERT INTO document_usage (packed_key, doc, seconds) '
+            'VALUES (?1, ?2, ?3) '
+            'ON CONFLICT(packed_key, doc) DO UPDATE SET '
+            'seconds = seconds + excluded.seconds',
+            variables: [
+              Variable<int>(
+                _hourlyKey(
+                  dayNumberOf(row.read<DateTime>('date')),
+                  row.read<int>('hour_index'),
+                  app,
+                ),
+              ),
+              Variable<int>(
+                await _documentIdFor(appId, row.read<String>('name')),
+              ),
+              Variable<int>(row.read<int>('seconds')),
+            ],
+          );
+        }
+        final last = rows.last;
+        await customUpdate(
+          'DELETE FROM hourly_document_usage_entries '
+          'WHERE (date, hour_index, app_id, doc_id) <= (?1, ?2, ?3, ?4)',
+          variables: [
+            Variable<int>(last.read<int>('date')),
+            Variable<int>(last.read<int>('hour_index')),
+            Variable<String>(last.read<String>('app_id')),
+            Variable<int>(last.read<int>('doc_id')),
+          ],
+        );
+        return rows.length;
+      });
+    } catch (_) {
+      _documentIds.clear();
+      rethrow;
+    }
+  }
+
+  /// 删除不再被任何用量表引用的字典条目，并作废进程内缓存。
+  Future<void> pruneAppDictionary() async {
+    await customUpdate(
+      'DELETE FROM app_dictionary WHERE '
+      'id NOT IN (SELECT app FROM daily_usage) AND '
+      'id NOT IN (SELECT packed_key & $_appMask FROM hourly_usage) AND '
+      'id NOT IN (SELECT app FROM hourly_app_usage) AND '
+      'id NOT IN (SELECT app FROM drawing_sessions) AND '
+      'id NOT IN (SELECT packed_key & $_appMask FROM device_usage) AND '
+      'id NOT IN (SELECT app FROM weekly_hour_usage) AND '
+      'id NOT IN (SELECT packed_key & $_appMask FROM busy_usage) AND '
+      'id NOT IN (SELECT packed_key & $_appMask FROM secondary_usage) AND '
+      'id NOT IN (SELECT app FROM document_dictionary)',
+    );
+    appDictionary.reset();
+  }
+
+  /// v10 及更早版本的文档字典与按文档用量表（TEXT appId + drift 日期）：
+  /// v11 起只作为迁移来源，由 [migrateLegacyUsage] 搬到 document_usage。
+  Future<void> _createDocumentTables() async {
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS documents ('
+      'id INTEGER PRIMARY KEY AUTOINCREMENT, '
+      'app_id TEXT NOT NULL, '
+      'name TEXT NOT NULL, '
+      'UNIQUE (app_id, name))',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS hourly_document_usage_entries ('
+      'date INTEGER NOT NULL, '
+      'hour_index INTEGER NOT NULL, '
+      'app_id TEXT NOT NULL, '
+      'doc_id INTEGER NOT NULL REFERENCES documents (id), '
+      'duration_seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (date, hour_index, app_id, doc_id)) WITHOUT ROWID',
+    );
+  }
+
+  /// v10 及更早版本的副屏可见小时表：v11 起只作为迁移来源（同上，搬到
+  /// secondary_usage）。
+  Future<void> _createSecondaryUsageTable() {
+    return customStatement(
+      'CREATE TABLE IF NOT EXISTS hourly_secondary_usage_entries ('
+      'date INTEGER NOT NULL, '
+      'hour_index INTEGER NOT NULL, '
+      'app_id TEXT NOT NULL, '
+      'duration_seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (date, hour_index, app_id)) WITHOUT ROWID',
+    );
+  }
+
+  /// 前台进程「忙碌」的小时级时长（v10）：Idle 期间前台统计中应用自身
+  /// 仍在占用 CPU（滤镜、导出、渲染）。键与 hourly_usage 相同，但不计入
+  /// 前台合计，也不参与同步与周内聚合。
+  Future<void> _createBusyUsageTable() {
+    return customStatement(
+      'CREATE TABLE IF NOT EXISTS busy_usage ('
+      'packed_key INTEGER NOT NULL PRIMARY KEY, '
+      'seconds INTEGER NOT NULL) WITHOUT ROWID',
+    );
+  }
+
+  /// 按文档与副屏可见的小时级用量（v11），与 busy_usage 一样以
+  /// hourly_usage 的打包主键为键，按应用 / 日期删除与字典清理共用同一套
+  /// 路径：
+  /// - document_dictionary：按 (应用 id, 文档名) 驻留，id 自增且不复用；
+  /// - document_usage：(打包主键, 文档 id) -> 秒；
+  /// - secondary_usage：「可见但不在前台」的时长（例如副屏上的参考图
+  ///   窗口），不计入日表 / 小时表的合计。
+  Future<void> _createSideUsageTables() async {
+    await AppDictionary.createTable(this);
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS document_dictionary ('
+      'id INTEGER PRIMARY KEY AUTOINCREMENT, '
+      'app INTEGER NOT NULL, '
+      'name TEXT NOT NULL, '
+      'UNIQUE (app, name))',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS document_usage ('
+      'packed_key INTEGER NOT NULL, '
+      'doc INTEGER NOT NULL, '
+      'seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (packed_key, doc)) WITHOUT ROWID',
+    );
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS secondary_usage ('
+      'packed_key INTEGER NOT NULL PRIMARY KEY, '
+      'seconds INTEGER NOT NULL) WITHOUT ROWID',
+    );
+  }
+
+  /// 已结束的绘画会话（v7）：主键以开始时刻打头，按时间范围查询是一段
+  /// 连续的主键区间；时刻为 Unix 毫秒，应用经 [appDictionary] 驻留。
+  Future<void> _createSessionTable() async {
+    await AppDictionary.createTable(this);
+    await customStatement(
+      'CREATE TABLE IF NOT EXISTS drawing_sessions ('
+      'start_ms INTEGER NOT NULL, '
+      'app INTEGER NOT NULL, '
+      'end_ms INTEGER NOT NULL, '
+      'active_ms INTEGER NOT NULL, '
+      'PRIMARY KEY (start_ms, app)) WITHOUT ROWID',
+    );
+  }
+
+  /// 「appId + 文档名」-> document_dictionary.id 的进程内缓存。
+  final Map<String, int> _documentIds = {};
+
+  Future<int> _documentIdFor(String appId, String name) async {
+    final key = documentUsageKey(appId, name);
+    final cached = _documentIds[key];
+    if (cached != null) return cached;
+
+    final app = await appDictionary.intern(appId);
+    await customInsert(
+      'INSERT OR IGNORE INTO document_dictionary (app, name) VALUES (?1, ?2)',
+      variables: [Variable<int>(app), Variable<String>(name)],
+    );
+    final row = await customSelect(
+      'SELECT id FROM document_dictionary WHERE app = ?1 AND name = ?2',
+      variables: [Variable<int>(app), Variable<String>(name)],
+    ).getSingle();
+    final id = row.read<int>('id');
+    _documentIds[key] = id;
+    return id;
+  }
+
   DateTime _normalizeDay(DateTime date) {
     return DateTime(date.year, date.month, date.day);
   }
@@ -110,26 +682,14 @@ class AppDatabase extends _$AppDatabase {
   Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {
     if (delta.isEmpty) return;
 
-    await transaction(() async {
+    await _dictionaryTransaction(() async {
       for (final entry in delta.entries) {
-        final day = _normalizeDay(entry.key);
+        final day = dayNumberOf(entry.key);
         for (final appEntry in entry.value.entries) {
-          final appId = appEntry.key;
           final seconds = appEntry.value.inSeconds;
           if (seconds <= 0) continue;
-
-          await customInsert(
-            'INSERT INTO daily_usage_entries (date, app_id, duration_seconds) '
-            'VALUES (?1, ?2, ?3) '
-            'ON CONFLICT(date, app_id) DO UPDATE SET '
-            'duration_seconds = duration_seconds + excluded.duration_seconds',
-            variables: [
-              Variable<DateTime>(day),
-              Variable<String>(appId),
-              Variable<int>(seconds),
-            ],
-            updates: {dailyUsageEntries},
-          );
+          final app = await appDictionary.intern(appEntry.key);
+          await _addDailySeconds(day, app, seconds);
         }
       }
     });
@@ -140,52 +700,119 @@ class AppDatabase extends _$AppDatabase {
     DateTime start,
     DateTime end,
   ) async {
-    final startDay = _normalizeDay(start);
-    final endDay = _normalizeDay(end);
-
-    final rows = await (select(
-      dailyUsageEntries,
-    )..where((tbl) => tbl.date.isBetweenValues(startDay, endDay))).get();
+    final rows = await customSelect(
+      'SELECT day, app, seconds FROM daily_usage '
+      'WHERE day BETWEEN ?1 AND ?2 ORDER BY day',
+      variables: [
+        Variable<int>(dayNumberOf(start)),
+        Variable<int>(dayNumberOf(end)),
+      ],
+    ).get();
+    final dictionary = appDictionary;
+    await dictionary.load();
 
+    // 主键顺序即 (day, app)，同一天的行相邻。
     final result = <DateTime, Map<String, Duration>>{};
+    var currentDay = -1 << 62;
+    var perApp = <String, Duration>{};
     for (final row in rows) {
-      final day = _normalizeDay(row.date);
-      final perApp = result.putIfAbsent(day, () => {});
-      perApp[row.appId] =
-          (perApp[row.appId] ?? Duration.zero) +
-          Duration(seconds: row.durationSeconds);
+      final day = row.read<int>('day');
+      if (day != currentDay) {
+        currentDay = day;
+        perApp = result[dateOfDayNumber(day)] = <String, Duration>{};
+      }
+      perApp[dictionary.nameOf(row.read<int>('app'))!] = Duration(
+        seconds: row.read<int>('seconds'),
+      );
     }
     return result;
   }
 
+  /// 批量写入整段小时级历史，并同时写入汇总后的日表，返回写入的行数。
+  ///
+  /// 用于合成数据与基准测试的快速导入：每 [chunkDays] 天一个 batch，
+  /// 同一条 INSERT 复用预编译语句；已存在的行被覆盖而不是累加。
+  /// 导入期间临时关闭 `synchronous`，结束后恢复原值。
+  Future<int> bulkLoadUsage(
+    Iterable<MapEntry<DateTime, Map<int, Map<String, Duration>>>> days, {
+    int chunkDays = 64,
+  }) async {
+    final previous = await customSelect('PRAGMA synchronous').getSingle();
+    await customStatement('PRAGMA synchronous = OFF');
+    var rows = 0;
+    try {
+      final daily = <List<int>>[];
+      final hourly = <List<int>>[];
+      var pendingDays = 0;
+
+      Future<void> flush() async {
+        if (daily.isEmpty && hourly.isEmpty) return;
+        await batch((batch) {
+          for (final row in daily) {
+            batch.customStatement(
+              'INSERT OR REPLACE INTO daily_usage (day, app, seconds) '
+              'VALUES (?, ?, ?)',
+              row,
+            );
+          }
+          for (final row in hourly) {
+            // upsert 而非 REPLACE：周内小时聚合的触发器需要看到旧值。
+            batch.customStatement(
+              'INSERT INTO hourly_usage (packed_key, seconds) VALUES (?, ?) '
+              'ON CONFLICT(packed_key) DO UPDATE SET '
+              'seconds = excluded.seconds',
+              row,
+            );
+            batch.customStatement(logLocalChangeSql, [row[0]]);
+          }
+        });
+        rows += daily.length + hourly.length;
+        daily.clear();
+        hourly.clear();
+        pendingDays = 0;
+      }
+
+      for (final entry in days) {
+        final day = dayNumberOf(entry.key);
+        final totals = <int, int>{};
+        for (final hourEntry in entry.value.entries) {
+          for (final appEntry in hourEntry.value.entries) {
+            final seconds = appEntry.value.inSeconds;
+            if (seconds <= 0) continue;
+            final app = await appDictionary.intern(appEntry.key);
+            totals[app] = (totals[app] ?? 0) + seconds;
+            hourly.add([_hourlyKey(day, hourEntry.key, app), seconds]);
+          }
+        }
+        totals.forEach((app, seconds) => daily.add([day, app, seconds]));
+        if (++pendingDays >= chunkDays) await flush();
+      }
+      await flush();
+    } finally {
+      await customStatement(
+        'PRAGMA synchronous = ${previous.read<int>('synchronous')}',
+      );
+    }
+    return rows;
+  }
+
   /// 将小时级增量 usage 合并到数据库里（按日 + 小时 + appId 叠加时长）。
   Future<void> mergeHourlyUsage(
     Map<DateTime, Map<int, Map<String, Duration>>> delta,
   ) async {
     if (delta.isEmpty) return;
 
-    await transaction(() async {
+    await _dictionaryTransaction(() async {
       for (final dayEntry in delta.entries) {
-        final day = _normalizeDay(dayEntry.key);
+        final day = dayNumberOf(dayEntry.key);
         for (final hourEntry in dayEntry.value.entries) {
-          final hourIndex = hourEntry.key;
           for (final appEntry in hourEntry.value.entries) {
-            final appId = appEntry.key;
             final seconds = appEntry.value.inSeconds;
             if (seconds <= 0) continue;
-
-            await customInsert(
-              'INSERT INTO hourly_usage_entries (date, hour_index, app_id, duration_seconds) '
-              'VALUES (?1, ?2, ?3, ?4) '
-              'ON CONFLICT(date, hour_index, app_id) DO UPDATE SET '
-              'duration_seconds = duration_seconds + excluded.duration_seconds',
-              variables: [
-                Variable<DateTime>(day),
-                Variable<int>(hourIndex),
-                Variable<String>(appId),
-                Variable<int>(seconds),
-              ],
-              updates: {hourlyUsageEntries},
+            final app = await appDictionary.intern(appEntry.key);
+            await _addHourlySeconds(
+              _hourlyKey(day, hourEntry.key, app),
+              seconds,
             );
           }
         }
@@ -197,43 +824,271 @@ class AppDatabase extends _$AppDatabase {
   Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
     DateTime start,
     DateTime end,
+  ) {
+    return _loadHourlyKeyed('hourly_usage', start, end);
+  }
+
+  /// 合并前台进程忙碌的小时级增量，结构与 [mergeHourlyUsage] 相同。
+  Future<void> mergeHourlyBusyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _mergeHourlyKeyed('busy_usage', delta);
+  }
+
+  /// 按日期范围加载前台进程忙碌的小时级时长。
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyBusyRange(
+    DateTime start,
+    DateTime end,
+  ) {
+    return _loadHourlyKeyed('busy_usage', start, end);
+  }
+
+  /// 把小时级增量累加到以打包主键为键的 [table]（不记入变更日志）。
+  Future<void> _mergeHourlyKeyed(
+    String table,
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
   ) async {
-    final startDay = _normalizeDay(start);
-    final endDay = _normalizeDay(end);
+    if (delta.isEmpty) return;
+
+    await _dictionaryTransaction(() async {
+      for (final dayEntry in delta.entries) {
+        final day = dayNumberOf(dayEntry.key);
+        for (final hourEntry in dayEntry.value.entries) {
+          for (final appEntry in hourEntry.value.entries) {
+            final seconds = appEntry.value.inSeconds;
+            if (seconds <= 0) continue;
+            final app = await appDictionary.intern(appEntry.key);
+            await _addKeyedSeconds(
+              table,
+              _hourlyKey(day, hourEntry.key, app),
+              seconds,
+            );
+          }
+        }
+      }
+    });
+  }
+
+  Future<void> _addKeyedSeconds(String table, int key, int seconds) {
+    return customInsert(
+      'INSERT INTO $table (packed_key, seconds) VALUES (?1, ?2) '
+      'ON CONFLICT(packed_key) DO UPDATE SET '
+      'seconds = seconds + excluded.seconds',
+      variables: [Variable<int>(key), Variable<int>(seconds)],
+    );
+  }
 
-    final rows = await (select(
-      hourlyUsageEntries,
-    )..where((tbl) => tbl.date.isBetweenValues(startDay, endDay))).get();
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> _loadHourlyKeyed(
+    String table,
+    DateTime start,
+    DateTime end,
+  ) async {
+    final rows = await customSelect(
+      'SELECT packed_key, seconds FROM $table '
+      'WHERE packed_key BETWEEN ?1 AND ?2 ORDER BY packed_key',
+      variables: [
+        Variable<int>(_firstHourlyKey(start)),
+        Variable<int>(_lastHourlyKey(end)),
+      ],
+    ).get();
+    final dictionary = appDictionary;
+    await dictionary.load();
 
+    // 主键有序：同一小时的行相邻，只在小时变化时查找外层 Map。
     final result = <DateTime, Map<int, Map<String, Duration>>>{};
+    var currentSlot = -1 << 62;
+    var perApp = <String, Duration>{};
     for (final row in rows) {
-      final day = _normalizeDay(row.date);
-      final perHour = result.putIfAbsent(
-        day,
-        () => <int, Map<String, Duration>>{},
-      );
-      final perApp = perHour.putIfAbsent(
-        row.hourIndex,
-        () => <String, Duration>{},
+      final key = row.read<int>('packed_key');
+      final slot = key >> _appBits;
+      if (slot != currentSlot) {
+        currentSlot = slot;
+        final hour = slot % 24;
+        final perHour = result.putIfAbsent(
+          dateOfDayNumber((slot - hour) ~/ 24),
+          () => <int, Map<String, Duration>>{},
+        );
+        perApp = perHour[hour] = <String, Duration>{};
+      }
+      perApp[dictionary.nameOf(key & _appMask)!] = Duration(
+        seconds: row.read<int>('seconds'),
       );
-      perApp[row.appId] =
-          (perApp[row.appId] ?? Duration.zero) +
-          Duration(seconds: row.durationSeconds);
     }
 
     return result;
   }
 
-  Future<void> deleteByAppId(String appId) {
-    return transaction(() async {
-      await (delete(
-        dailyUsageEntries,
-      )..where((tbl) => tbl.appId.equals(appId))).go();
+  /// 合并按文档的小时级增量；内层 key 为 [documentUsageKey] 组合 key。
+  Future<void> mergeHourlyDocumentUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {
+    if (delta.isEmpty) return;
+
+    try {
+      await _mergeHourlyDocumentUsage(delta);
+    } catch (_) {
+      // 事务回滚后，本次新分配的文档 id 可能已不存在，缓存整体作废。
+      _documentIds.clear();
+      rethrow;
+    }
+  }
+
+  Future<void> _mergeHourlyDocumentUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _dictionaryTransaction(() async {
+      for (final dayEntry in delta.entries) {
+        final day = dayNumberOf(dayEntry.key);
+        for (final hourEntry in dayEntry.value.entries) {
+          for (final docEntry in hourEntry.value.entries) {
+            final seconds = docEntry.value.inSeconds;
+            final document = documentOfUsageKey(docEntry.key);
+            if (seconds <= 0 || document == null) continue;
+            final appId = appIdOfDocumentUsageKey(docEntry.key);
+            final docId = await _documentIdFor(appId, document);
+            final app = await appDictionary.intern(appId);
+
+            await customInsert(
+              'INSERT INTO document_usage (packed_key, doc, seconds) '
+              'VALUES (?1, ?2, ?3) '
+              'ON CONFLICT(packed_key, doc) DO UPDATE SET '
+              'seconds = seconds + excluded.seconds',
+              variables: [
+                Variable<int>(_hourlyKey(day, hourEntry.key, app)),
+                Variable<int>(docId),
+                Variable<int>(seconds),
+              ],
+            );
+          }
+        }
+      }
+    });
+  }
+
+  /// 按日期范围加载按文档的小时级使用时长，内层 key 为 [documentUsageKey]。
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlyDocumentRange(DateTime start, DateTime end) async {
+    final rows = await customSelect(
+      'SELECT u.packed_key AS packed_key, d.name AS name, '
+      'u.seconds AS seconds FROM document_usage u '
+      'JOIN document_dictionary d ON d.id = u.doc '
+      'WHERE u.packed_key BETWEEN ?1 AND ?2',
+      variables: [
+        Variable<int>(_firstHourlyKey(start)),
+        Variable<int>(_lastHourlyKey(end)),
+      ],
+    ).get();
+    final dictionary = appDictionary;
+    await dictionary.load();
+
+    final result = <DateTime, Map<int, Map<String, Duration>>>{};
+    for (final row in rows) {
+      final key = unpackHourlyKey(row.read<int>('packed_key'));
+      final perDoc = result
+          .putIfAbsent(
+            dateOfDayNumber(key.day),
+            () => <int, Map<String, Duration>>{},
+          )
+          .putIfAbsent(key.hour, () => <String, Duration>{});
+      final docKey = documentUsageKey(
+        dictionary.nameOf(key.app)!,
+        row.read<String>('name'),
+      );
+      perDoc[docKey] =
+          (perDoc[docKey] ?? Duration.zero) +
+          Duration(seconds: row.read<int>('seconds'));
+    }
+    return result;
+  }
 
-      await (delete(
-        hourlyUsageEntries,
-      )..where((tbl) => tbl.appId.equals(appId))).go();
+  /// 合并「可见但不在前台」的小时级增量，结构与 [mergeHourlyUsage] 相同。
+  Future<void> mergeHourlySecondaryUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _mergeHourlyKeyed('secondary_usage', delta);
+  }
+
+  /// 按日期范围加载「可见但不在前台」的小时级使用时长。
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlySecondaryRange(DateTime start, DateTime end) {
+    return _loadHourlyKeyed('secondary_usage', start, end);
+  }
+
+  /// 批量写入已结束的会话；同一应用同一开始时刻的会话以后写入的为准。
+  Future<void> insertSessions(List<DrawingSession> sessions) async {
+    if (sessions.isEmpty) return;
+
+    await _dictionaryTransaction(() async {
+      for (final session in sessions) {
+        await customInsert(
+          'INSERT OR REPLACE INTO drawing_sessions '
+          '(start_ms, app, end_ms, active_ms) VALUES (?1, ?2, ?3, ?4)',
+          variables: [
+            Variable<int>(session.start.millisecondsSinceEpoch),
+            Variable<int>(await appDictionary.intern(session.appId)),
+            Variable<int>(session.end.millisecondsSinceEpoch),
+            Variable<int>(session.active.inMilliseconds),
+          ],
+        );
+      }
+    });
+  }
+
+  /// 开始时刻落在 [start, end) 内的会话，按开始时刻升序（主键区间扫描）。
+  Future<List<DrawingSession>> loadSessions(
+    DateTime start,
+    DateTime end,
+  ) async {
+    final rows = await customSelect(
+      'SELECT start_ms, app, end_ms, active_ms FROM drawing_sessions '
+      'WHERE start_ms >= ?1 AND start_ms < ?2 ORDER BY start_ms',
+      variables: [
+        Variable<int>(start.millisecondsSinceEpoch),
+        Variable<int>(end.millisecondsSinceEpoch),
+      ],
+    ).get();
+    final dictionary = appDictionary;
+    await dictionary.load();
+
+    return [
+      for (final row in rows)
+        DrawingSession(
+          appId: dictionary.nameOf(row.read<int>('app'))!,
+          start: DateTime.fromMillisecondsSinceEpoch(
+            row.read<int>('start_ms'),
+          ),
+          end: DateTime.fromMillisecondsSinceEpoch(row.read<int>('end_ms')),
+          active: Duration(milliseconds: row.read<int>('active_ms')),
+        ),
+    ];
+  }
+
+  Future<void> deleteByAppId(String appId) async {
+    final app = await appDictionary.idOf(appId);
+    if (app == null) return;
+    await transaction(() async {
+      await customUpdate(
+        'DELETE FROM daily_usage WHERE app = ?1',
+        variables: [Variable<int>(app)],
+      );
+      // 删除只在本机生效：同步不传播删除，远端之后的新增量仍会合并进来。
+      for (final table in _hourlyKeyedTables) {
+        await customUpdate(
+          'DELETE FROM $table WHERE packed_key & $_appMask = ?1',
+          variables: [Variable<int>(app)],
+        );
+      }
+      await customUpdate(
+        'DELETE FROM document_dictionary WHERE app = ?1',
+        variables: [Variable<int>(app)],
+      );
+      await customUpdate(
+        'DELETE FROM drawing_sessions WHERE app = ?1',
+        variables: [Variable<int>(app)],
+      );
+      _documentIds.clear();
     });
+    await pruneAppDictionary();
   }
 
   Future<void> deleteByDateRange(DateTime start, DateTime end) {
@@ -241,21 +1096,45 @@ class AppDatabase extends _$AppDatabase {
     final endDay = _normalizeDay(end);
 
     return transaction(() async {
-      await (delete(
-        dailyUsageEntries,
-      )..where((tbl) => tbl.date.isBetweenValues(startDay, endDay))).go();
-
-      await (delete(
-        hourlyUsageEntries,
-      )..where((tbl) => tbl.date.isBetweenValues(startDay, endDay))).go();
+      await customUpdate(
+        'DELETE FROM daily_usage WHERE day BETWEEN ?1 AND ?2',
+        variables: [
+          Variable<int>(dayNumberOf(startDay)),
+          Variable<int>(dayNumberOf(endDay)),
+        ],
+      );
+      for (final table in _hourlyKeyedTables) {
+        await customUpdate(
+          'DELETE FROM $table WHERE packed_key BETWEEN ?1 AND ?2',
+          variables: [
+            Variable<int>(_firstHourlyKey(startDay)),
+            Variable<int>(_lastHourlyKey(endDay)),
+          ],
+        );
+      }
+      // 会话按开始时刻所在的日期归属。
+      final afterEnd = DateTime(endDay.year, endDay.month, endDay.day + 1);
+      await customUpdate(
+        'DELETE FROM drawing_sessions WHERE start_ms >= ?1 AND start_ms < ?2',
+        variables: [
+          Variable<int>(startDay.millisecondsSinceEpoch),
+          Variable<int>(afterEnd.millisecondsSinceEpoch),
+        ],
+      );
     });
   }
 
-  Future<void> clearAll() {
-    return transaction(() async {
-      await delete(dailyUsageEntries).go();
-      await delete(hourlyUsageEntries).go();
+  Future<void> clearAll() async {
+    await transaction(() async {
+      await customStatement('DELETE FROM daily_usage');
+      await customStatement('DELETE FROM document_dictionary');
+      await customStatement('DELETE FROM drawing_sessions');
+      for (final table in _hourlyKeyedTables) {
+        await customStatement('DELETE FROM $table');
+      }
+      _documentIds.clear();
     });
+    await pruneAppDictionary();
   }
 }
 
@@ -0,0 +1,88 @@
+import 'package:drift/drift.dart';
+
+/// appId 字符串 <-> 整数 ID 的字典（app_dictionary 表）。
+///
+/// 日表 / 小时表与「全量记录」的紧凑存储共用同一份字典，行内只存整数 ID。
+/// 进程内缓存首次使用时整表加载，之后只在驻留新应用时追加；不再被任何
+/// 用量表引用的条目由 [AppDatabase.pruneAppDictionary] 清理。
+class AppDictionary {
+  AppDictionary(this._db);
+
+  final DatabaseConnectionUser _db;
+
+  Map<String, int>? _ids;
+  final List<String?> _names = [];
+  int _generation = 0;
+
+  /// 缓存每次作废或追加时递增，依赖 ID -> 名称映射的缓存（例如位图）
+  /// 以此判断是否需要重建。
+  int get generation => _generation;
+
+  /// 已加载的最大 ID + 1；需先 [load]。
+  int get length => _names.length;
+
+  static Future<void> createTable(DatabaseConnectionUser db) {
+    return db.customStatement(
+      'CREATE TABLE IF NOT EXISTS app_dictionary ('
+      'id INTEGER PRIMARY KEY, '
+      'app_id TEXT NOT NULL UNIQUE)',
+    );
+  }
+
+  Future<Map<String, int>> load() async {
+    final cached = _ids;
+    if (cached != null) return cached;
+
+    final rows = await _db
+        .customSelect('SELECT id, app_id FROM app_dictionary')
+        .get();
+    final ids = <String, int>{};
+    _names.clear();
+    for (final row in rows) {
+      _put(ids, row.read<String>('app_id'), row.read<int>('id'));
+    }
+    _generation++;
+    return _ids = ids;
+  }
+
+  /// 已加载的 ID 对应的 appId；未知 ID 返回 null。
+  String? nameOf(int id) => id < _names.length ? _names[id] : null;
+
+  Future<int?> idOf(String appId) async => (await load())[appId];
+
+  Future<int> intern(String appId) async {
+    final ids = await load();
+    final cached = ids[appId];
+    if (cached != null) return cached;
+
+    // 并发驻留同一个应用时只有一条插入生效，以查询结果为准。
+    await _db.customInsert(
+      'INSERT INTO app_dictionary (app_id) VALUES (?1) '
+      'ON CONFLICT(app_id) DO NOTHING',
+      variables: [Variable<String>(appId)],
+    );
+    final row = await _db.customSelect(
+      'SELECT id FROM app_dictionary WHERE app_id = ?1',
+      variables: [Variable<String>(appId)],
+    ).getSingle();
+    final id = row.read<int>('id');
+    _put(ids, appId, id);
+    _generation++;
+    return id;
+  }
+
+  /// 事务回滚或条目被删除后调用，下次使用时重新加载。
+  void reset() {
+    _ids = null;
+    _names.clear();
+    _generation++;
+  }
+
+  void _put(Map<String, int> ids, String appId, int id) {
+    ids[appId] = id;
+    if (_names.length <= id) {
+      _names.length = id + 1;
+    }
+    _names[id] = appId;
+  }
+}
@@ -0,0 +1,262 @@
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:drift/drift.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/app_dictionary.dart';
+import 'package:ringotrack/feature/usage/models/day_number.dart';
+
+/// 应用 ID 位图：按 app_dictionary.id 置位，查询时 O(1) 判断是否计入。
+class AppIdBitmap {
+  AppIdBitmap(int maxId) : _words = Uint32List((maxId >> 5) + 1);
+
+  final Uint32List _words;
+
+  void add(int id) {
+    _words[id >> 5] |= 1 << (id & 31);
+  }
+
+  bool contains(int id) {
+    final word = id >> 5;
+    return word < _words.length && (_words[word] & (1 << (id & 31))) != 0;
+  }
+}
+
+/// 「全量记录」模式的存储：所有前台应用都按整数 ID 记录，统计哪些应用
+/// 推迟到查询时用 [AppIdBitmap] 过滤。
+///
+/// - app_dictionary：与日表 / 小时表共用的 [AppDictionary]；
+/// - hourly_app_usage：(日序号, 小时, 应用 id) -> 秒，全部为整数列，
+///   使用 WITHOUT ROWID，主键即按日期范围查询的顺序。
+///
+/// 两张表只通过 SQL 访问，不参与 drift 的代码生成。
+class CompactUsageStore {
+  CompactUsageStore(this._db);
+
+  final AppDatabase _db;
+
+  AppDictionary get _dictionary => _db.appDictionary;
+
+  AppIdBitmap? _bitmap;
+  bool Function(String appId)? _bitmapFilter;
+  int _bitmapGeneration = -1;
+
+  static Future<void> createTables(DatabaseConnectionUser db) async {
+    await AppDictionary.createTable(db);
+    await db.customStatement(
+      'CREATE TABLE IF NOT EXISTS hourly_app_usage ('
+      'day INTEGER NOT NULL, '
+      'hour INTEGER NOT NULL, '
+      'app INTEGER NOT NULL, '
+      'seconds INTEGER NOT NULL, '
+      'PRIMARY KEY (day, hour, app)) WITHOUT ROWID',
+    );
+  }
+
+  /// 按当前过滤器构建位图；过滤器与字典都未变化时复用上一次的结果。
+  Future<AppIdBitmap> bitmapFor(bool Function(String appId) filter) async {
+    final dictionary = _dictionary;
+    await dictionary.load();
+    final cached = _bitmap;
+    if (cached != null &&
+        identical(filter, _bitmapFilter) &&
+        _bitmapGeneration == dictionary.generation) {
+      return cached;
+    }
+
+    final bitmap = AppIdBitmap(dictionary.length);
+    for (var id = 0; id < dictionary.length; id++) {
+      final name = dictionary.nameOf(id);
+      if (name != null && filter(name)) {
+        bitmap.add(id);
+      }
+    }
+    _bitmap = bitmap;
+    _bitmapFilter = filter;
+    _bitmapGeneration = dictionary.generation;
+    return bitmap;
+  }
+
+  /// 合并小时级增量（所有应用，不做过滤）。
+  Future<void> mergeHourly(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {
+    if (delta.isEmpty) return;
+
+    try {
+      await _db.transaction(() async {
+        for (final dayEntry in delta.entries) {
+          final day = dayNumberOf(dayEntry.key);
+          for (final hourEntry in dayEntry.value.entries) {
+            for (final appEntry in hourEntry.value.entries) {
+              final seconds = appEntry.value.inSeconds;
+              if (seconds <= 0) continue;
+              final app = await _dictionary.intern(appEntry.key);
+              await _db.customInsert(
+                'INSERT INTO hourly_app_usage (day, hour, app, seconds) '
+                'VALUES (?1, ?2, ?3, ?4) '
+                'ON CONFLICT(day, hour, app) DO UPDATE SET '
+                'seconds = seconds + excluded.seconds',
+                variables: [
+                  Variable<int>(day),
+                  Variable<int>(hourEntry.key),
+                  Variable<int>(app),
+                  Variable<int>(seconds),
+                ],
+              );
+            }
+          }
+        }
+      });
+    } catch (_) {
+      // 事务回滚后，本次新驻留的应用 id 可能已不存在。
+      _dictionary.reset();
+      rethrow;
+    }
+  }
+
+  /// 按日期范围加载小时级用量，只保留 [bitmap] 中的应用。
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+    AppIdBitmap bitmap,
+  ) async {
+    final rows = await _db
+        .customSelect(
+          'SELECT day, hour, app, seconds FROM hourly_app_usage '
+          'WHERE day BETWEEN ?1 AND ?2',
+          variables: [
+            Variable<int>(dayNumberOf(start)),
+            Variable<int>(dayNumberOf(end)),
+          ],
+        )
+        .get();
+    // 查询期间字典可能被清理后作废，解析名称前确保已加载。
+    final dictionary = _dictionary;
+    await dictionary.load();
+
+    final result = <DateTime, Map<int, Map<String, Duration>>>{};
+    final days = <int, Map<int, Map<String, Duration>>>{};
+    for (final row in rows) {
+      final app = row.read<int>('app');
+      if (!bitmap.contains(app)) continue;
+      final perHour = days.putIfAbsent(row.read<int>('day'), () {
+        final perHour = <int, Map<String, Duration>>{};
+        result[dateOfDayNumber(row.read<int>('day'))] = perHour;
+        return perHour;
+      });
+      final perApp = perHour.putIfAbsent(
+        row.read<int>('hour'),
+        () => <String, Duration>{},
+      );
+      perApp[dictionary.nameOf(app)!] = Duration(
+        seconds: row.read<int>('seconds'),
+      );
+    }
+    return result;
+  }
+
+  /// 按日期范围加载日级用量（由小时表汇总），只保留 [bitmap] 中的应用。
+  Future<Map<DateTime, Map<String, Duration>>> loadDailyRange(
+    DateTime start,
+    DateTime end,
+    AppIdBitmap bitmap,
+  ) async {
+    final rows = await _db
+        .customSelect(
+          'SELECT day, app, SUM(seconds) AS seconds FROM hourly_app_usage '
+          'WHERE day BETWEEN ?1 AND ?2 GROUP BY day, app',
+          variables: [
+            Variable<int>(dayNumberOf(start)),
+            Variable<int>(dayNumberOf(end)),
+          ],
+        )
+        .get();
+    final dictionary = _dictionary;
+    await dictionary.load();
+
+    final result = <DateTime, Map<String, Duration>>{};
+    final days = <int, Map<String, Duration>>{};
+    for (final row in rows) {
+      final app = row.read<int>('app');
+      if (!bitmap.contains(app)) continue;
+      final perApp = days.putIfAbsent(row.read<int>('day'), () {
+        final perApp = <String, Duration>{};
+        result[dateOfDayNumber(row.read<int>('day'))] = perApp;
+        return perApp;
+      });
+      perApp[dictionary.nameOf(app)!] = Duration(
+        seconds: row.read<int>('seconds'),
+      );
+    }
+    return result;
+  }
+
+  /// 把旧版小时表（只含统计中的应用）对齐到本表：每个 (日, 小时, 应用) 取
+  /// 两边的较大值。
+  ///
+  /// 开启全量记录期间统计中的应用两边同时写入，本表不会少于旧表；关闭期间
+  /// 只有旧表增长，差值正是缺失的时长，重新开启后据此补齐。取较大值是幂等
+  /// 的，每次启动执行、中途崩溃后重跑都不会重复计入。按 [chunkDays] 天一段
+  /// 在 SQL 内完成，每段一个事务，不把历史读进内存。
+  Future<void> importLegacyHourly({int chunkDays = 366}) async {
+    final bounds = await _db
+        .customSelect(
+          'SELECT MIN(packed_key) AS lo, MAX(packed_key) AS hi '
+          'FROM hourly_usage',
+        )
+        .getSingle();
+    final lo = bounds.read<int?>('lo');
+    final hi = bounds.read<int?>('hi');
+    if (lo == null || hi == null) return;
+
+    final lastDay = AppDatabase.unpackHourlyKey(hi).day;
+    for (
+      var day = AppDatabase.unpackHourlyKey(lo).day;
+      day <= lastDay;
+      day += chunkDays
+    ) {
+      final endDay = math.min(day + chunkDays - 1, lastDay);
+      await _db.transaction(() async {
+        await _db.customStatement(
+          'INSERT INTO hourly_app_usage (day, hour, app, seconds) '
+          'SELECT ${AppDatabase.hourlyDaySql('packed_key')}, '
+          '${AppDatabase.hourlyHourSql('packed_key')}, '
+          'packed_key & ${AppDatabase.hourlyAppMask}, seconds '
+          'FROM hourly_usage WHERE packed_key BETWEEN ?1 AND ?2 '
+          'ON CONFLICT(day, hour, app) DO UPDATE SET '
+          'seconds = excluded.seconds WHERE excluded.seconds > seconds',
+          [
+            AppDatabase.packHourlyKey(day, 0, 0),
+            AppDatabase.packHourlyKey(endDay, 23, AppDatabase.hourlyAppMask),
+          ],
+        );
+      });
+    }
+  }
+
+  Future<void> deleteByAppId(String appId) async {
+    final id = await _dictionary.idOf(appId);
+    if (id == null) return;
+    await _db.customUpdate(
+      'DELETE FROM hourly_app_usage WHERE app = ?1',
+      variables: [Variable<int>(id)],
+    );
+    await _db.pruneAppDictionary();
+  }
+
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {
+    await _db.customUpdate(
+      'DELETE FROM hourly_app_usage WHERE day BETWEEN ?1 AND ?2',
+      variables: [
+        Variable<int>(dayNumberOf(start)),
+        Variable<int>(dayNumberOf(end)),
+      ],
+    );
+  }
+
+  Future<void> clearAll() async {
+    await _db.customStatement('DELETE FROM hourly_app_usage');
+    await _db.pruneAppDictionary();
+  }
+}
@@ -0,0 +1,692 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:drift/drift.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/day_number.dart';
+
+/// 导出格式。
+enum UsageArchiveFormat {
+  /// 紧凑二进制（`.rtua`），见 [UsageArchive]。
+  binary,
+
+  /// 便于查看与外部处理的 CSV，导入时同样支持。
+  csv,
+}
+
+/// 导入时与已有数据的合并方式。
+enum UsageImportMode {
+  /// 时长叠加到已有的行上（合并多台机器的历史）。
+  add,
+
+  /// 归档中出现的行覆盖已有的值（从备份恢复）；归档中没有的行保持不变。
+  replace,
+}
+
+class UsageArchiveProgress {
+  const UsageArchiveProgress({
+    required this.rows,
+    required this.bytes,
+    this.totalBytes,
+  });
+
+  /// 已写入数据库的行数。
+  final int rows;
+
+  /// 已读取的归档字节数。
+  final int bytes;
+
+  /// 归档总字节数；未知时为 null。
+  final int? totalBytes;
+}
+
+class UsageImportResult {
+  const UsageImportResult({
+    required this.dailyRows,
+    required this.hourlyRows,
+    required this.sessions,
+  });
+
+  final int dailyRows;
+  final int hourlyRows;
+  final int sessions;
+
+  int get rows => dailyRows + hourlyRows + sessions;
+}
+
+/// 完整使用历史（应用字典、日表、小时表、绘画会话）的流式导出 / 导入。
+///
+/// 导出按主键顺序分页读取（keyset 分页，每页 [chunkRows] 行），每页编码
+/// 后立即交给下游，内存只与页大小和应用数有关；导入边读边解析，每累计
+/// [chunkRows] 行在一个 batch 中写入。
+///
+/// 二进制格式：`RTUA` + 版本字节，之后是一串以标签字节开头的记录，整数均为
+/// LEB128 变长编码，带符号的差值先做 zigzag：
+/// - 1 应用：归档内 id、UTF-8 字节数、appId；
+/// - 2 日表：日序号差值、应用 id、秒；
+/// - 3 小时表：打包主键差值（见 [AppDatabase.packHourlyKey]）、秒；
+/// - 4 会话：开始毫秒差值、应用 id、持续毫秒、活跃毫秒；
+/// - 0 结束：前面的记录总数，用于发现截断的文件。
+/// 每类记录按主键升序排列，差值相对于同类的上一条记录。
+class UsageArchive {
+  UsageArchive(this._db, {this.chunkRows = 5000});
+
+  final AppDatabase _db;
+  final int chunkRows;
+
+  static const _magic = [0x52, 0x54, 0x55, 0x41]; // "RTUA"
+  static const _version = 1;
+  static const _csvHeader =
+      'kind,day,hour,app_id,seconds,start_ms,end_ms,active_ms';
+
+  static const _tagEnd = 0;
+  static const _tagApp = 1;
+  static const _tagDaily = 2;
+  static const _tagHourly = 3;
+  static const _tagSession = 4;
+
+  /// 导出为字节流；按订阅方的节奏分页读取（暂停订阅时不再查询）。
+  Stream<List<int>> export({
+    UsageArchiveFormat format = UsageArchiveFormat.binary,
+  }) {
+    return format == UsageArchiveFormat.binary ? _exportBinary() : _exportCsv();
+  }
+
+  Stream<List<int>> _exportBinary() async* {
+    final out = _ArchiveWriter()
+      ..bytes(_magic)
+      ..byte(_version);
+    var records = 0;
+
+    for (final row in await _appRows()) {
+      final name = utf8.encode(row.read<String>('app_id'));
+      out
+        ..byte(_tagApp)
+        ..varint(row.read<int>('id'))
+        ..varint(name.length)
+        ..bytes(name);
+      records++;
+    }
+
+    var previous = 0;
+    await for (final rows in _dailyPages()) {
+      for (final row in rows) {
+        final day = row.read<int>('day');
+        out
+          ..byte(_tagDaily)
+          ..zigzag(day - previous)
+          ..varint(row.read<int>('app'))
+          ..varint(row.read<int>('seconds'));
+        previous = day;
+      }
+      records += rows.length;
+      yield out.take();
+    }
+
+    previous = 0;
+    await for (final rows in _hourlyPages()) {
+      for (final row in rows) {
+        final key = row.read<int>('packed_key');
+        out
+          ..byte(_tagHourly)
+          ..zigzag(key - previous)
+          ..varint(row.read<int>('seconds'));
+        previous = key;
+      }
+      records += rows.length;
+      yield out.take();
+    }
+
+    previous = 0;
+    await for (final rows in _sessionPages()) {
+      for (final row in rows) {
+        final start = row.read<int>('start_ms');
+        out
+          ..byte(_tagSession)
+          ..zigzag(start - previous)
+          ..varint(row.read<int>('app'))
+          ..varint(row.read<int>('end_ms') - start)
+          ..varint(row.read<int>('active_ms'));
+        previous = start;
+      }
+      records += rows.length;
+      yield out.take();
+    }
+
+    out
+      ..byte(_tagEnd)
+      ..varint(records);
+    yield out.take();
+  }
+
+  Stream<List<int>> _exportCsv() async* {
+    final names = {
+      for (final row in await _appRows())
+        row.read<int>('id'): _csvField(row.read<String>('app_id')),
+    };
+    final out = StringBuffer()..writeln(_csvHeader);
+
+    await for (final rows in _dailyPages()) {
+      for (final row in rows) {
+        out.writeln(
+          'daily,${_formatDay(row.read<int>('day'))},,'
+          '${names[row.read<int>('app')]},${row.read<int>('seconds')},,,',
+        );
+      }
+      yield utf8.encode(out.toString());
+      out.clear();
+    }
+
+    await for (final rows in _hourlyPages()) {
+      for (final row in rows) {
+        final key = AppDatabase.unpackHourlyKey(row.read<int>('packed_key'));
+        out.writeln(
+          'hourly,${_formatDay(key.day)},${key.hour},${names[key.app]},'
+          '${row.read<int>('seconds')},,,',
+        );
+      }
+      yield utf8.encode(out.toString());
+      out.clear();
+    }
+
+    await for (final rows in _sessionPages()) {
+      for (final row in rows) {
+        out.writeln(
+          'session,,,${names[row.read<int>('app')]},,'
+          '${row.read<int>('start_ms')},${row.read<int>('end_ms')},'
+          '${row.read<int>('active_ms')}',
+        );
+      }
+      yield utf8.encode(out.toString());
+      out.clear();
+    }
+
+    if (out.isNotEmpty) yield utf8.encode(out.toString());
+  }
+
+  Future<List<QueryRow>> _appRows() {
+    return _db
+        .customSelect('SELECT id, app_id FROM app_dictionary ORDER BY id')
+        .get();
+  }
+
+  Stream<List<QueryRow>> _dailyPages() async* {
+    var day = -1 << 62;
+    var app = 0;
+    while (true) {
+      final rows = await _db.customSelect(
+        'SELECT day, app, seconds FROM daily_usage '
+        'WHERE (day, app) > (?1, ?2) ORDER BY day, app LIMIT ?3',
+        variables: [
+          Variable<int>(day),
+          Variable<int>(app),
+          Variable<int>(chunkRows),
+        ],
+      ).get();
+      if (rows.isEmpty) return;
+      yield rows;
+      day = rows.last.read<int>('day');
+      app = rows.last.read<int>('app');
+    }
+  }
+
+  Stream<List<QueryRow>> _hourlyPages() async* {
+    var key = -1 << 62;
+    while (true) {
+      final rows = await _db.customSelect(
+        'SELECT packed_key, seconds FROM hourly_usage '
+        'WHERE packed_key > ?1 ORDER BY packed_key LIMIT ?2',
+        variables: [Variable<int>(key), Variable<int>(chunkRows)],
+      ).get();
+      if (rows.isEmpty) return;
+      yield rows;
+      key = rows.last.read<int>('packed_key');
+    }
+  }
+
+  Stream<List<QueryRow>> _sessionPages() async* {
+    var start = -1 << 62;
+    var app = 0;
+    while (true) {
+      final rows = await _db.customSelect(
+        'SELECT start_ms, app, end_ms, active_ms FROM drawing_sessions '
+        'WHERE (start_ms, app) > (?1, ?2) ORDER BY start_ms, app LIMIT ?3',
+        variables: [
+          Variable<int>(start),
+          Variable<int>(app),
+          Variable<int>(chunkRows),
+        ],
+      ).get();
+      if (rows.isEmpty) return;
+      yield rows;
+      start = rows.last.read<int>('start_ms');
+      app = rows.last.read<int>('app');
+    }
+  }
+
+  /// 从字节流导入；格式按文件头自动识别（`RTUA` 为二进制，否则按 CSV）。
+  ///
+  /// 每写入一个 batch 调用一次 [onProgress]。格式错误时抛出
+  /// [FormatException]，已写入的 batch 不回滚。
+  Future<UsageImportResult> import(
+    Stream<List<int>> input, {
+    UsageImportMode mode = UsageImportMode.add,
+    int? totalBytes,
+    void Function(UsageArchiveProgress progress)? onProgress,
+  }) async {
+    final sink = _ImportSink(_db, mode);
+    _ArchiveParser? parser;
+    final head = <int>[];
+    var bytes = 0;
+
+    await for (final chunk in input) {
+      bytes += chunk.length;
+      var data = chunk;
+      if (parser == null) {
+        // 凑够文件头再决定格式。
+        head.addAll(chunk);
+        if (head.length < _magic.length) continue;
+        parser = _startsWithMagic(head)
+            ? _BinaryParser(sink)
+            : _CsvParser(sink);
+        data = head;
+      }
+      parser.add(data);
+      if (sink.pending >= chunkRows) {
+        await sink.flush();
+        onProgress?.call(
+          UsageArchiveProgress(
+            rows: sink.written,
+            bytes: bytes,
+            totalBytes: totalBytes,
+          ),
+        );
+      }
+    }
+
+    parser ??= _CsvParser(sink)..add(head);
+    parser.close();
+    await sink.flush();
+    onProgress?.call(
+      UsageArchiveProgress(
+        rows: sink.written,
+        bytes: bytes,
+        totalBytes: totalBytes,
+      ),
+    );
+    return UsageImportResult(
+      dailyRows: sink.dailyRows,
+      hourlyRows: sink.hourlyRows,
+      sessions: sink.sessions,
+    );
+  }
+
+  static bool _startsWithMagic(List<int> head) {
+    for (var i = 0; i < _magic.length; i++) {
+      if (head[i] != _magic[i]) return false;
+    }
+    return true;
+  }
+
+  static String _formatDay(int day) {
+    final date = dateOfDayNumber(day);
+    String two(int v) => v.toString().padLeft(2, '0');
+    return '${date.year.toString().padLeft(4, '0')}-'
+        '${two(date.month)}-${two(date.day)}';
+  }
+
+  static String _csvField(String value) {
+    if (!value.contains(RegExp('[",\r\n]'))) return value;
+    return '"${value.replaceAll('"', '""')}"';
+  }
+}
+
+class _ArchiveWriter {
+  final _out = BytesBuilder(copy: false);
+  final _scratch = Uint8List(10);
+
+  void byte(int value) => _out.addByte(value);
+
+  void bytes(List<int> value) => _out.add(value);
+
+  void varint(int value) {
+    var n = 0;
+    while (value & ~0x7f != 0) {
+      _scratch[n++] = (value & 0x7f) | 0x80;
+      value >>>= 7;
+    }
+    _scratch[n++] = value;
+    _out.add(Uint8List.sublistView(_scratch, 0, n));
+  }
+
+  void zigzag(int value) => varint((value << 1) ^ (value >> 63));
+
+  Uint8List take() => _out.takeBytes();
+}
+
+abstract class _ArchiveParser {
+  void add(List<int> chunk);
+
+  /// 输入结束；内容不完整时抛出 [FormatException]。
+  void close();
+}
+
+class _BinaryParser implements _ArchiveParser {
+  _BinaryParser(this._sink);
+
+  final _ImportSink _sink;
+  Uint8List _buffer = Uint8List(0);
+  int _pos = 0;
+  bool _headerRead = false;
+  bool _ended = false;
+  int _records = 0;
+  final _names = <int, String>{};
+  int _day = 0;
+  int _hourlyKey = 0;
+  int _sessionStart = 0;
+
+  @override
+  void add(List<int> chunk) {
+    final rest = _buffer.length - _pos;
+    _buffer = Uint8List(rest + chunk.length)
+      ..setRange(0, rest, _buffer, _pos)
+      ..setRange(rest, rest + chunk.length, chunk);
+    _pos = 0;
+
+    if (!_headerRead) {
+      if (_buffer.length < UsageArchive._magic.length + 1) return;
+      final version = _buffer[UsageArchive._magic.length];
+      if (version != UsageArchive._version) {
+        throw FormatException('unsupported archive version $version');
+      }
+      _pos = UsageArchive._magic.length + 1;
+      _headerRead = true;
+    }
+    while (!_ended && _pos < _buffer.length) {
+      final start = _pos;
+      if (!_readRecord()) {
+        _pos = start;
+        return;
+      }
+    }
+    if (_ended && _pos < _buffer.length) {
+      throw const FormatException('unexpected data after end of archive');
+    }
+  }
+
+  @override
+  void close() {
+    if (!_ended) throw const FormatException('truncated archive');
+  }
+
+  /// 读取一条完整的记录；数据不够时返回 false（调用方回退位置）。
+  bool _readRecord() {
+    final tag = _buffer[_pos++];
+    switch (tag) {
+      case UsageArchive._tagApp:
+        final id = _varint();
+        final length = _varint();
+        if (id == null || length == null) return false;
+        if (_buffer.length - _pos < length) return false;
+        _names[id] = utf8.decode(
+          Uint8List.sublistView(_buffer, _pos, _pos + length),
+        );
+        _pos += length;
+      case UsageArchive._tagDaily:
+        final delta = _zigzag();
+        final app = _varint();
+        final seconds = _varint();
+        if (delta == null || app == null || seconds == null) return false;
+        _day += delta;
+        _sink.addDaily(_day, _nameOf(app), seconds);
+      case UsageArchive._tagHourly:
+        final delta = _zigzag();
+        final seconds = _varint();
+        if (delta == null || seconds == null) return false;
+        _hourlyKey += delta;
+        final key = AppDatabase.unpackHourlyKey(_hourlyKey);
+        _sink.addHourly(key.day, key.hour, _nameOf(key.app), seconds);
+      case UsageArchive._tagSession:
+        final delta = _zigzag();
+        final app = _varint();
+        final length = _varint();
+        final active = _varint();
+        if (delta == null || app == null || length == null || active == null) {
+          return false;
+        }
+        _sessionStart += delta;
+        _sink.addSession(
+          _nameOf(app),
+          _sessionStart,
+          _sessionStart + length,
+          active,
+        );
+      case UsageArchive._tagEnd:
+        final count = _varint();
+        if (count == null) return false;
+        if (count != _records) {
+          throw FormatException(
+            'archive has $_records records, expected $count',
+          );
+        }
+        _ended = true;
+        return true;
+      default:
+        throw FormatException('unknown record tag $tag');
+    }
+    _records++;
+    return true;
+  }
+
+  String _nameOf(int id) {
+    final name = _names[id];
+    if (name == null) throw FormatException('unknown app id $id');
+    return name;
+  }
+
+  int? _varint() {
+    var result = 0;
+    var shift = 0;
+    var pos = _pos;
+    while (pos < _buffer.length) {
+      final byte = _buffer[pos++];
+      result |= (byte & 0x7f) << shift;
+      if (byte < 0x80) {
+        _pos = pos;
+        return result;
+      }
+      shift += 7;
+    }
+    return null;
+  }
+
+  int? _zigzag() {
+    final value = _varint();
+    return value == null ? null : (value >>> 1) ^ -(value & 1);
+  }
+}
+
+class _CsvParser implements _ArchiveParser {
+  _CsvParser(this._sink) {
+    _decoder = utf8.decoder.startChunkedConversion(
+      const LineSplitter().startChunkedConversion(_LineSink(_onLine)),
+    );
+  }
+
+  final _ImportSink _sink;
+  late final ByteConversionSink _decoder;
+  int _line = 0;
+
+  @override
+  void add(List<int> chunk) => _decoder.add(chunk);
+
+  @override
+  void close() => _decoder.close();
+
+  void _onLine(String line) {
+    _line++;
+    if (_line == 1 || line.isEmpty) return; // 表头
+    final fields = _split(line);
+    if (fields.length != 8) {
+      throw FormatException('line $_line: expected 8 fields');
+    }
+    int number(int index) {
+      final value = int.tryParse(fields[index]);
+      if (value == null) {
+        throw FormatException('line $_line: bad number "${fields[index]}"');
+      }
+      return value;
+    }
+
+    switch (fields[0]) {
+      case 'daily':
+        _sink.addDaily(_parseDay(fields[1]), fields[3], number(4));
+      case 'hourly':
+        _sink.addHourly(_parseDay(fields[1]), number(2), fields[3], number(4));
+      case 'session':
+        _sink.addSession(fields[3], number(5), number(6), number(7));
+      default:
+        throw FormatException('line $_line: unknown kind "${fields[0]}"');
+    }
+  }
+
+  int _parseDay(String text) {
+    final date = DateTime.tryParse(text);
+    if (date == null) throw FormatException('line $_line: bad date "$text"');
+    return dayNumberOf(date);
+  }
+
+  static List<String> _split(String line) {
+    final fields = <String>[];
+    final field = StringBuffer();
+    var quoted = false;
+    for (var i = 0; i < line.length; i++) {
+      final c = line[i];
+      if (quoted) {
+        if (c != '"') {
+          field.write(c);
+        } else if (i + 1 < line.length && line[i + 1] == '"') {
+          field.write('"');
+          i++;
+        } else {
+          quoted = false;
+        }
+      } else if (c == '"') {
+        quoted = true;
+      } else if (c == ',') {
+        fields.add(field.toString());
+        field.clear();
+      } else {
+        field.write(c);
+      }
+    }
+    fields.add(field.toString());
+    return fields;
+  }
+}
+
+class _LineSink implements Sink<String> {
+  _LineSink(this._onLine);
+
+  final void Function(String line) _onLine;
+
+  @override
+  void add(String line) => _onLine(line);
+
+  @override
+  void close() {}
+}
+
+/// 暂存解析出的行，按 batch 驻留应用名并写入。
+class _ImportSink {
+  _ImportSink(this._db, UsageImportMode mode)
+    : _update = mode == UsageImportMode.add
+          ? 'seconds = seconds + excluded.seconds'
+          : 'seconds = excluded.seconds',
+      _sessionConflict = mode == UsageImportMode.add ? 'IGNORE' : 'REPLACE';
+
+  final AppDatabase _db;
+  final String _update;
+  final String _sessionConflict;
+
+  final _daily = <(int, String, int)>[];
+  final _hourly = <(int, int, String, int)>[];
+  final _sessions = <(String, int, int, int)>[];
+  final _ids = <String, int>{};
+
+  int dailyRows = 0;
+  int hourlyRows = 0;
+  int sessions = 0;
+
+  int get pending => _daily.length + _hourly.length + _sessions.length;
+  int get written => dailyRows + hourlyRows + sessions;
+
+  void addDaily(int day, String app, int seconds) =>
+      _daily.add((day, app, seconds));
+
+  void addHourly(int day, int hour, String app, int seconds) {
+    if (hour < 0 || hour > 23) throw FormatException('bad hour $hour');
+    _hourly.add((day, hour, app, seconds));
+  }
+
+  void addSession(String app, int start, int end, int active) =>
+      _sessions.add((app, start, end, active));
+
+  Future<void> flush() async {
+    if (pending == 0) return;
+    for (final app in [
+      for (final row in _daily) row.$2,
+      for (final row in _hourly) row.$3,
+      for (final row in _sessions) row.$1,
+    ]) {
+      if (!_ids.containsKey(app)) {
+        _ids[app] = await _db.appDictionary.intern(app);
+      }
+    }
+
+    await _db.batch((batch) {
+      for (final (day, app, seconds) in _daily) {
+        batch.customStatement(
+          'INSERT INTO daily_usage (day, app, seconds) VALUES (?, ?, ?) '
+          'ON CONFLICT(day, app) DO UPDATE SET $_update',
+          [day, _ids[app]!, seconds],
+        );
+      }
+      for (final (day, hour, app, seconds) in _hourly) {
+        final key = AppDatabase.packHourlyKey(day, hour, _ids[app]!);
+        // 合计不低于多设备同步带来的远端分量之和：replace 模式恢复同步前的
+        // 备份时，本机分量最少为 0，不会发布负数。
+        batch.customStatement(
+          'INSERT INTO hourly_usage (packed_key, seconds) VALUES (?1, ?2) '
+          'ON CONFLICT(packed_key) DO UPDATE SET $_update',
+          [key, seconds],
+        );
+        batch.customStatement(
+          'UPDATE hourly_usage SET seconds = ('
+          'SELECT SUM(seconds) FROM device_usage WHERE packed_key = ?1) '
+          'WHERE packed_key = ?1 AND seconds < ('
+          'SELECT COALESCE(SUM(seconds), 0) FROM device_usage '
+          'WHERE packed_key = ?1)',
+          [key],
+        );
+        // 导入的时长按本机贡献参与多设备同步。
+        batch.customStatement(AppDatabase.logLocalChangeSql, [key]);
+      }
+      for (final (app, start, end, active) in _sessions) {
+        batch.customStatement(
+          'INSERT OR $_sessionConflict INTO drawing_sessions '
+          '(start_ms, app, end_ms, active_ms) VALUES (?, ?, ?, ?)',
+          [start, _ids[app]!, end, active],
+        );
+      }
+    });
+
+    dailyRows += _daily.length;
+    hourlyRows += _hourly.length;
+    sessions += _sessions.length;
+    _daily.clear();
+    _hourly.clear();
+    _sessions.clear();
+  }
+}
@@ -0,0 +1,281 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:drift/drift.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+
+class UsageSyncResult {
+  const UsageSyncResult({
+    required this.published,
+    required this.applied,
+    required this.devices,
+  });
+
+  /// 本次发布的本机条目数。
+  final int published;
+
+  /// 使远端分量增大的条目数（重复收到的条目不计）。
+  final int applied;
+
+  /// 同步目录中看到的远端设备数。
+  final int devices;
+}
+
+/// 通过共享目录在多台机器之间合并小时级使用时长。
+///
+/// 每台设备对每个小时键的贡献是一个只增的计数（G-counter 的分量）：本机
+/// 改动的键记入 `usage_change_log`，发布时按序号把「改动过的键 -> 当前
+/// 本机分量」写成分段文件 `<设备>/<起始序号>-<结束序号>.json`；拉取时
+/// 对每台远端设备只读取水位线之后的分段，分量取最大值，增加的部分同时
+/// 加到 hourly_usage、daily_usage 和全量记录的 hourly_app_usage 上。因此重复同步、分段重叠都不会重复
+/// 计入，已有的查询路径也无需改动。
+///
+/// 删除只在本机生效，不会传播；共享目录只是传输方式的本地替代，换成其它
+/// 传输时只需替换分段文件的读写。
+class UsageSync {
+  UsageSync(this._db, this.folder, {this.segmentEntries = 20000});
+
+  final AppDatabase _db;
+  final Directory folder;
+
+  /// 每个分段文件最多包含的条目数。
+  final int segmentEntries;
+
+  static const _format = 1;
+  static const _localDevice = 0;
+  static final _segmentName = RegExp(r'^(\d+)-(\d+)\.json$');
+
+  /// 先发布本机的新改动，再拉取其它设备的分段。
+  Future<UsageSyncResult> sync() async {
+    final published = await publish();
+    final pulled = await pull();
+    return UsageSyncResult(
+      published: published,
+      applied: pulled.applied,
+      devices: pulled.devices,
+    );
+  }
+
+  /// 本机的设备标识；首次调用时随机生成并保存。
+  Future<String> localDeviceUuid() async {
+    final row = await _db.customSelect(
+      'SELECT device_uuid FROM sync_devices WHERE id = $_localDevice',
+    ).getSingleOrNull();
+    if (row != null) return row.read<String>('device_uuid');
+
+    final random = Random.secure();
+    final uuid = [
+      for (var i = 0; i < 16; i++)
+        random.nextInt(256).toRadixString(16).padLeft(2, '0'),
+    ].join();
+    await _db.customInsert(
+      'INSERT INTO sync_devices (id, device_uuid) VALUES ($_localDevice, ?1)',
+      variables: [Variable<String>(uuid)],
+    );
+    return uuid;
+  }
+
+  /// 把水位线之后的本机改动写成分段文件，返回条目数。
+  Future<int> publish() async {
+    final uuid = await localDeviceUuid();
+    final dir = Directory('${folder.path}${Platform.pathSeparator}$uuid');
+    var published = 0;
+
+    while (true) {
+      final from = await _seqOf(_localDevice);
+      // 本机分量 = 合计 - 远端分量之和；同一条 SELECT 内读到的是一致的快照。
+      // 合计被改小（删除后重写、replace 导入）时截断为 0，G-counter 分量
+      // 只增不减，负数永远不会发布。
+      final rows = await _db.customSelect(
+        'SELECT l.seq, h.packed_key, MAX(h.seconds - COALESCE(('
+        'SELECT SUM(d.seconds) FROM device_usage d '
+        'WHERE d.packed_key = h.packed_key), 0), 0) AS local, a.app_id '
+        'FROM usage_change_log l '
+        'JOIN hourly_usage h ON h.packed_key = l.packed_key '
+        'JOIN app_dictionary a ON a.id = h.packed_key & ?3 '
+        'WHERE l.seq > ?1 ORDER BY l.seq LIMIT ?2',
+        variables: [
+          Variable<int>(from),
+          Variable<int>(segmentEntries),
+          Variable<int>(AppDatabase.hourlyAppMask),
+        ],
+      ).get();
+      if (rows.isEmpty) return published;
+
+      final apps = <String, int>{};
+      final entries = <List<int>>[];
+      for (final row in rows) {
+        final local = row.read<int>('local');
+        if (local <= 0) continue;
+        final key = AppDatabase.unpackHourlyKey(row.read<int>('packed_key'));
+        final app = apps.putIfAbsent(
+          row.read<String>('app_id'),
+          () => apps.length,
+        );
+        entries.add([key.day, key.hour, app, local]);
+      }
+      final to = rows.last.read<int>('seq');
+
+      await dir.create(recursive: true);
+      final name = '${_pad(from + 1)}-${_pad(to)}.json';
+      final temp = File('${dir.path}${Platform.pathSeparator}$name.tmp');
+      await temp.writeAsString(
+        jsonEncode({
+          'format': _format,
+          'device': uuid,
+          'from': from + 1,
+          'to': to,
+          'apps': apps.keys.toList(),
+          'entries': entries,
+        }),
+        flush: true,
+      );
+      // 先落盘再改名：其它设备只会看到完整的分段。
+      await temp.rename('${dir.path}${Platform.pathSeparator}$name');
+      await _setSeq(_localDevice, to);
+      published += entries.length;
+    }
+  }
+
+  /// 应用其它设备水位线之后的分段。
+  Future<({int applied, int devices})> pull() async {
+    final local = await localDeviceUuid();
+    if (!await folder.exists()) return (applied: 0, devices: 0);
+
+    var applied = 0;
+    var devices = 0;
+    await for (final entity in folder.list()) {
+      if (entity is! Directory) continue;
+      final uuid = entity.uri.pathSegments.lastWhere((s) => s.isNotEmpty);
+      if (uuid == local) continue;
+      devices++;
+      applied += await _pullDevice(uuid, entity);
+    }
+    return (applied: applied, devices: devices);
+  }
+
+  Future<int> _pullDevice(String uuid, Directory dir) async {
+    await _db.customInsert(
+      'INSERT OR IGNORE INTO sync_devices (device_uuid) VALUES (?1)',
+      variables: [Variable<String>(uuid)],
+    );
+    final device = (await _db.customSelect(
+      'SELECT id FROM sync_devices WHERE device_uuid = ?1',
+      variables: [Variable<String>(uuid)],
+    ).getSingle()).read<int>('id');
+
+    final segments = <({int from, int to, File file})>[];
+    await for (final entity in dir.list()) {
+      if (entity is! File) continue;
+      final match = _segmentName.firstMatch(entity.uri.pathSegments.last);
+      if (match == null) continue;
+      segments.add((
+        from: int.parse(match[1]!),
+        to: int.parse(match[2]!),
+        file: entity,
+      ));
+    }
+    segments.sort((a, b) => a.from != b.from ? a.from - b.from : a.to - b.to);
+
+    var applied = 0;
+    var seq = await _seqOf(device);
+    for (final segment in segments) {
+      if (segment.to <= seq) continue;
+      // 中间缺了分段（例如同步盘还没传完）：停在这里，下次再继续。
+      if (segment.from > seq + 1) break;
+      applied += await _applySegment(device, segment.file, segment.to);
+      seq = segment.to;
+    }
+    return applied;
+  }
+
+  Future<int> _applySegment(int device, File file, int to) async {
+    final json = jsonDecode(await file.readAsString()) as Map<String, Object?>;
+    if (json['format'] != _format) {
+      throw FormatException('unsupported sync segment ${file.path}');
+    }
+    // 字典驻留在事务外完成，事务失败时已驻留的 id 仍然有效。
+    final ids = [
+      for (final app in json['apps']! as List<Object?>)
+        await _db.appDictionary.intern(app! as String),
+    ];
+
+    return _db.transaction(() async {
+      var applied = 0;
+      for (final entry in json['entries']! as List<Object?>) {
+        final [day, hour, app, seconds] = (entry! as List<Object?>)
+            .cast<int>();
+        final key = AppDatabase.packHourlyKey(day, hour, ids[app]);
+        final previous = await _db.customSelect(
+          'SELECT seconds FROM device_usage '
+          'WHERE packed_key = ?1 AND device = ?2',
+          variables: [Variable<int>(key), Variable<int>(device)],
+        ).getSingleOrNull();
+        final delta = seconds - (previous?.read<int>('seconds') ?? 0);
+        if (delta <= 0) continue;
+
+        await _db.customInsert(
+          'INSERT OR REPLACE INTO device_usage (packed_key, device, seconds) '
+          'VALUES (?1, ?2, ?3)',
+          variables: [
+            Variable<int>(key),
+            Variable<int>(device),
+            Variable<int>(seconds),
+          ],
+        );
+        // 远端的增量不记入本机变更日志。
+        await _db.customInsert(
+          'INSERT INTO hourly_usage (packed_key, seconds) VALUES (?1, ?2) '
+          'ON CONFLICT(packed_key) DO UPDATE SET '
+          'seconds = seconds + excluded.seconds',
+          variables: [Variable<int>(key), Variable<int>(delta)],
+        );
+        await _db.customInsert(
+          'INSERT INTO daily_usage (day, app, seconds) VALUES (?1, ?2, ?3) '
+          'ON CONFLICT(day, app) DO UPDATE SET '
+          'seconds = seconds + excluded.seconds',
+          variables: [
+            Variable<int>(day),
+            Variable<int>(ids[app]),
+            Variable<int>(delta),
+          ],
+        );
+        // 全量记录模式的紧凑存储同样加上增量；未开启时多出的部分在重新
+        // 开启、导入旧小时表时按较大值对齐，不会重复计入。
+        await _db.customInsert(
+          'INSERT INTO hourly_app_usage (day, hour, app, seconds) '
+          'VALUES (?1, ?2, ?3, ?4) '
+          'ON CONFLICT(day, hour, app) DO UPDATE SET '
+          'seconds = seconds + excluded.seconds',
+          variables: [
+            Variable<int>(day),
+            Variable<int>(hour),
+            Variable<int>(ids[app]),
+            Variable<int>(delta),
+          ],
+        );
+        applied++;
+      }
+      await _setSeq(device, to);
+      return applied;
+    });
+  }
+
+  Future<int> _seqOf(int device) async {
+    final row = await _db.customSelect(
+      'SELECT seq FROM sync_devices WHERE id = ?1',
+      variables: [Variable<int>(device)],
+    ).getSingle();
+    return row.read<int>('seq');
+  }
+
+  Future<void> _setSeq(int device, int seq) {
+    return _db.customUpdate(
+      'UPDATE sync_devices SET seq = ?1 WHERE id = ?2',
+      variables: [Variable<int>(seq), Variable<int>(device)],
+    );
+  }
+
+  static String _pad(int seq) => seq.toString().padLeft(12, '0');
+}
@@ -0,0 +1,59 @@
+import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+
+/// 日志级别，按严重程度递增。
+const logLevels = ['DEBUG', 'INFO', 'WARN', 'ERROR'];
+
+/// 日志查询条件，全部满足才返回。
+class LogQuery {
+  const LogQuery({this.minLevel, this.tag, this.text, this.from, this.to});
+
+  static const all = LogQuery();
+
+  /// 最低级别（[logLevels] 之一）；为空时不限。
+  final String? minLevel;
+
+  /// 模块名，精确匹配；为空时不限。
+  final String? tag;
+
+  /// 在整行（时间、级别、模块与消息）中查找的子串，不区分大小写。
+  final String? text;
+
+  /// 时间范围 [from, to)；为空的一端不限。
+  final DateTime? from;
+  final DateTime? to;
+}
+
+/// 翻页位置：某个分段中某个字节偏移之前（更早）的记录。
+class LogCursor {
+  const LogCursor({required this.segment, required this.offset});
+
+  /// 分段 id（分段创建时的毫秒时间戳）。
+  final int segment;
+  final int offset;
+}
+
+class LogPage {
+  const LogPage({
+    required this.entries,
+    required this.next,
+    this.scannedBytes = 0,
+    this.skippedBlocks = 0,
+  });
+
+  static const empty = LogPage(entries: [], next: null);
+
+  /// 按时间从新到旧。
+  final List<AppLogEntry> entries;
+
+  /// 继续向更早翻页的位置；已经读到最早的记录时为 null。
+  ///
+  /// 单次查询有扫描字节上限，条件很少命中时可能不足一页就返回，
+  /// 此时 [next] 不为空，调用方接着查询即可。
+  final LogCursor? next;
+
+  /// 本次读取并解析的字节数。
+  final int scannedBytes;
+
+  /// 按索引直接跳过的块数。
+  final int skippedBlocks;
+}
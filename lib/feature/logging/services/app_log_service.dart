@@ -1,23 +1,24 @@
 import 'dart:async';
 import 'dart:io';
 import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+import 'package:ringotrack/feature/logging/models/log_query.dart';
+import 'package:ringotrack/feature/logging/services/log_store.dart';
 
-/// 简单的文件 + 内存双通道日志服务，用于在 release 下调试采集逻辑。
+/// 文件日志服务，用于在 release 下调试采集逻辑。
+///
+/// 记录写入 [LogStore] 的分段文件（带稀疏索引），日志面板通过 [query]
+/// 分页读取，过滤与搜索在后台 isolate 中进行。
 class AppLogService {
   AppLogService._internal();
 
   static final AppLogService instance = AppLogService._internal();
 
-  static const int _maxInMemoryEntries = 500;
-  static const int _maxFileBytes = 1024 * 1024; // 1MB
-
-  final List<AppLogEntry> _entries = <AppLogEntry>[];
-
-  File? _logFile;
+  LogStore? _store;
   bool _initializing = false;
   final List<Future<void> Function()> _pendingOperations = [];
 
-  List<AppLogEntry> get entries => List.unmodifiable(_entries);
+  /// 日志文件所在目录；指标导出等诊断文件也放在这里。
+  Directory get logDirectory => _resolveLogDirectory();
 
   Future<void> logDebug(String tag, String message) {
     return _log('DEBUG', tag, message);
@@ -44,30 +45,13 @@ class AppLogService {
       message: message,
     );
 
-    _entries.add(entry);
-    if (_entries.length > _maxInMemoryEntries) {
-      _entries.removeRange(0, _entries.length - _maxInMemoryEntries);
-    }
-
-    await _enqueueFileWrite(timestamp, level, tag, message);
+    await _enqueueFileWrite(entry);
   }
 
-  Future<void> _enqueueFileWrite(
-    DateTime timestamp,
-    String level,
-    String tag,
-    String message,
-  ) async {
+  Future<void> _enqueueFileWrite(AppLogEntry entry) async {
     Future<void> operation() async {
       await _ensureInitialized();
-      final file = _logFile;
-      if (file == null) return;
-
-      await _rotateIfNeeded(file);
-
-      final ts = timestamp.toIso8601String();
-      final line = '$ts [$level] [$tag] $message';
-      await file.writeAsString('$line\n', mode: FileMode.append, flush: false);
+      await _store?.append(entry);
     }
 
     if (_initializing) {
@@ -78,8 +62,20 @@ class AppLogService {
     await operation();
   }
 
+  /// 从新到旧分页查询日志，[cursor] 为上一页返回的 [LogPage.next]。
+  Future<LogPage> query(
+    LogQuery query, {
+    LogCursor? cursor,
+    int limit = 200,
+  }) async {
+    await _ensureInitialized();
+    final store = _store;
+    if (store == null) return LogPage.empty;
+    return store.query(query, cursor: cursor, limit: limit);
+  }
+
   Future<void> _ensureInitialized() async {
-    if (_logFile != null) return;
+    if (_store != null) return;
     if (_initializing) return;
 
     _initializing = true;
@@ -88,8 +84,7 @@ class AppLogService {
       if (!await directory.exists()) {
         await directory.create(recursive: true);
       }
-      final file = File(_buildLogFilePath(directory.path));
-      _logFile = file;
+      _store = LogStore(directory);
 
       // 执行初始化期间积压的写操作
       for (final op in _pendingOperations) {
@@ -124,38 +119,8 @@ class AppLogService {
     return Directory('logs');
   }
 
-  String _buildLogFilePath(String dirPath) {
-    final separator = Platform.pathSeparator;
-    return '$dirPath${separator}tracking.log';
-  }
-
-  Future<void> _rotateIfNeeded(File file) async {
-    try {
-      if (!await file.exists()) return;
-      final length = await file.length();
-      if (length <= _maxFileBytes) return;
-
-      final backup = File('${file.path}.1');
-      if (await backup.exists()) {
-        await backup.delete();
-      }
-      await file.rename(backup.path);
-    } catch (_) {
-      // 旋转失败不影响后续写入
-    }
-  }
-
-  /// 清空内存与文件日志，方便在 UI 中一键清理
+  /// 删除全部日志分段，方便在 UI 中一键清理
   Future<void> clear() async {
-    _entries.clear();
-
-    final file = _logFile;
-    if (file != null && await file.exists()) {
-      try {
-        await file.writeAsString('');
-      } catch (_) {
-        // 忽略清空失败
-      }
-    }
+    await _store?.clear();
   }
 }
@@ -0,0 +1,234 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/platform/native_metrics_reader.dart';
+
+/// 对数-线性延迟直方图，桶布局与 native `ringotrack::LatencyHistogram`
+/// 完全一致：小于 8 的值各占一个桶，之后每个 2 的幂区间切成 8 个子桶。
+/// 单位统一为纳秒，便于与 native 侧的数据合并展示。
+class LatencyHistogram {
+  static const subBucketBits = 3;
+  static const subBuckets = 1 << subBucketBits;
+  static const bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+  final _buckets = Uint64List(bucketCount);
+  int _count = 0;
+  int _sum = 0;
+  int _max = 0;
+
+  static int bucketIndex(int value) {
+    if (value < subBuckets) return value < 0 ? 0 : value;
+    final msb = value.bitLength - 1;
+    final sub = (value >> (msb - subBucketBits)) & (subBuckets - 1);
+    return (msb - subBucketBits + 1) * subBuckets + sub;
+  }
+
+  /// 桶覆盖 [bucketLowerBound(i), bucketLowerBound(i + 1))。
+  static int bucketLowerBound(int index) {
+    if (index < subBuckets) return index;
+    final msb = index ~/ subBuckets + subBucketBits - 1;
+    final sub = index % subBuckets;
+    return (1 << msb) | (sub << (msb - subBucketBits));
+  }
+
+  void record(int nanos) {
+    final value = nanos < 0 ? 0 : nanos;
+    _buckets[bucketIndex(value)]++;
+    _count++;
+    _sum += value;
+    if (value > _max) _max = value;
+  }
+
+  void recordDuration(Duration duration) =>
+      record(duration.inMicroseconds * 1000);
+
+  HistogramSnapshot snapshot() => HistogramSnapshot(
+    count: _count,
+    sum: _sum,
+    max: _max,
+    buckets: Uint64List.fromList(_buckets),
+  );
+
+  void reset() {
+    _buckets.fillRange(0, bucketCount, 0);
+    _count = 0;
+    _sum = 0;
+    _max = 0;
+  }
+}
+
+/// 某一时刻的直方图内容（纳秒）。
+class HistogramSnapshot {
+  HistogramSnapshot({
+    required this.count,
+    required this.sum,
+    required this.max,
+    required this.buckets,
+  });
+
+  final int count;
+  final int sum;
+  final int max;
+  final List<int> buckets;
+
+  int get mean => count == 0 ? 0 : sum ~/ count;
+
+  /// 分位数 [q]（0~1）所在桶的上界，不超过 [max]；没有样本时为 0。
+  /// 算法与 native `ValueAtQuantile` 相同。
+  int valueAtQuantile(double q) {
+    final total = buckets.fold<int>(0, (a, b) => a + b);
+    if (total == 0) return 0;
+    final clamped = q.clamp(0.0, 1.0);
+    var rank = (clamped * total).floor();
+    if (rank == 0) rank = 1;
+    var seen = 0;
+    for (var i = 0; i < buckets.length; i++) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        if (i + 1 == buckets.length) return max;
+        final upper = LatencyHistogram.bucketLowerBound(i + 1) - 1;
+        return upper < max ? upper : max;
+      }
+    }
+    return max;
+  }
+
+  Map<String, Object> toJson() => {
+    'count': count,
+    'mean_ns': mean,
+    'p50_ns': valueAtQuantile(0.5),
+    'p90_ns': valueAtQuantile(0.9),
+    'p99_ns': valueAtQuantile(0.99),
+    'max_ns': max,
+    // 只保留非空桶：[下界, 次数]，离线分析时可以还原完整分布。
+    'buckets': [
+      for (var i = 0; i < buckets.length; i++)
+        if (buckets[i] != 0)
+          [LatencyHistogram.bucketLowerBound(i), buckets[i]],
+    ],
+  };
+}
+
+/// 进程内的热路径指标：Dart 侧的 tick / 落库耗时，加上 native 侧
+/// （钩子回调、前台查询、会话事件读取）经 FFI 一次性读取的快照。
+///
+/// 只在 UI isolate 上使用，无需加锁。
+class AppMetrics {
+  AppMetrics._internal();
+
+  static final AppMetrics instance = AppMetrics._internal();
+
+  /// UsageService 一次 tick 的完整耗时（含增量合并）。
+  final tick = LatencyHistogram();
+
+  /// 一次落库（日 / 小时 / 文档三张表）的耗时。
+  final dbFlush = LatencyHistogram();
+
+  /// 落库相对预定间隔的滞后：Timer 抖动与前一次落库阻塞都会体现在这里。
+  final dbFlushLag = LatencyHistogram();
+
+  final Map<String, int> _counters = {};
+
+  NativeMetricsReader? _nativeReader;
+
+  void increment(String name, [int by = 1]) {
+    _counters[name] = (_counters[name] ?? 0) + by;
+  }
+
+  Map<String, int> get counters => Map.unmodifiable(_counters);
+
+  Map<String, LatencyHistogram> get _histograms => {
+    'tick': tick,
+    'db_flush': dbFlush,
+    'db_flush_lag': dbFlushLag,
+  };
+
+  NativeMetricsSnapshot? readNative() {
+    final reader = _nativeReader ??= createNativeMetricsReader();
+    return reader.read();
+  }
+
+  void reset() {
+    for (final histogram in _histograms.values) {
+      histogram.reset();
+    }
+    _counters.clear();
+    (_nativeReader ??= createNativeMetricsReader()).reset();
+  }
+
+  /// 全部指标的 JSON 结构，供导出与离线分析。
+  Map<String, Object?> toJson() {
+    final native = readNative();
+    return {
+      'captured_at': DateTime.now().toIso8601String(),
+      'platform': Platform.operatingSystem,
+      'dart': {
+        'counters': counters,
+        'histograms': {
+          for (final entry in _histograms.entries)
+            entry.key: entry.value.snapshot().toJson(),
+        },
+      },
+      'native': native?.toJson(),
+    };
+  }
+
+  /// 日志面板里展示的文本摘要，每个直方图一行。
+  String formatSummary() {
+    final buffer = StringBuffer();
+    void writeHistogram(String name, HistogramSnapshot s) {
+      buffer.writeln(
+        '${name.padRight(20)} n=${s.count.toString().padRight(8)}'
+        'p50=${_formatNanos(s.valueAtQuantile(0.5)).padRight(10)}'
+        'p99=${_formatNanos(s.valueAtQuantile(0.99)).padRight(10)}'
+        'max=${_formatNanos(s.max)}',
+      );
+    }
+
+    buffer.writeln('[dart]');
+    _histograms.forEach((name, h) => writeHistogram(name, h.snapshot()));
+    _counters.forEach(
+      (name, value) => buffer.writeln('${name.padRight(20)} $value'),
+    );
+
+    final native = readNative();
+    buffer.writeln();
+    if (native == null) {
+      buffer.writeln('[native] 当前平台不可用');
+    } else {
+      buffer.writeln('[native]');
+      native.histograms.forEach(writeHistogram);
+      native.counters.forEach(
+        (name, value) => buffer.writeln('${name.padRight(20)} $value'),
+      );
+    }
+    return buffer.toString();
+  }
+
+  /// 写出 JSON 快照到日志目录下的 `metrics-<时间戳>.json`，返回文件。
+  Future<File> dumpToFile() async {
+    final directory = AppLogService.instance.logDirectory;
+    if (!await directory.exists()) {
+      await directory.create(recursive: true);
+    }
+    final stamp = DateTime.now()
+        .toIso8601String()
+        .replaceAll(':', '')
+        .replaceAll('.', '');
+    final file = File(
+      '${directory.path}${Platform.pathSeparator}metrics-$stamp.json',
+    );
+    await file.writeAsString(
+      const JsonEncoder.withIndent('  ').convert(toJson()),
+    );
+    return file;
+  }
+
+  static String _formatNanos(int nanos) {
+    if (nanos < 1000) return '${nanos}ns';
+    if (nanos < 1000000) return '${(nanos / 1000).toStringAsFixed(1)}us';
+    return '${(nanos / 1000000).toStringAsFixed(2)}ms';
+  }
+}
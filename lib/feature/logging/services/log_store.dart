@@ -0,0 +1,537 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+import 'package:ringotrack/feature/logging/models/log_query.dart';
+
+/// 分段日志存储：按大小滚动的文本分段 + 稀疏块索引。
+///
+/// 每个分段 `log-<id>.log` 一行一条记录（`时间 [级别] [模块] 消息`，与旧的
+/// tracking.log 相同，消息中的换行与反斜杠转义），id 是分段创建时的毫秒
+/// 时间戳。每 [blockEntries] 条或 [blockBytes] 字节为一个块，块写满时向
+/// `log-<id>.idx` 追加一条 40 字节的索引：块的字节偏移与长度、首末时间、
+/// 级别位图与模块名的 64 位布隆过滤器。
+///
+/// 查询在后台 isolate 中从新到旧逐块读取：时间、级别或模块不可能匹配的
+/// 块按索引直接跳过，其余的块（最大 [blockBytes] 左右）读入后逐行过滤，
+/// 内存只与块大小和页大小有关。最后一个块写满前没有索引，读取时当作条件
+/// 未知的块整体扫描；进程崩溃留下的未索引尾部同样如此。
+///
+/// 写入按调用顺序串行执行，失败时丢弃该条，不影响后续写入。
+class LogStore {
+  LogStore(
+    this.directory, {
+    this.maxSegmentBytes = 4 << 20,
+    this.maxTotalBytes = 64 << 20,
+    this.blockEntries = 256,
+    this.blockBytes = 64 << 10,
+  });
+
+  final Directory directory;
+
+  /// 单个分段的大小上限，超过后滚动到新分段。
+  final int maxSegmentBytes;
+
+  /// 所有分段（含索引）的总大小上限，超过时删除最早的分段。
+  final int maxTotalBytes;
+
+  final int blockEntries;
+  final int blockBytes;
+
+  static const _indexRecordBytes = 40;
+
+  RandomAccessFile? _log;
+  RandomAccessFile? _index;
+  int _segment = 0;
+  int _segmentBytes = 0;
+  _BlockStats? _block;
+  Future<void> _tail = Future<void>.value();
+
+  /// 追加一条记录；返回的 Future 在写入（或写入失败被丢弃）后完成。
+  Future<void> append(AppLogEntry entry) => _enqueue(() => _append(entry));
+
+  /// 删除全部分段；之后的写入从新分段开始。
+  Future<void> clear() => _enqueue(() async {
+    await _closeSegment();
+    for (final segment in await _listSegments(directory)) {
+      await _deleteSegment(segment);
+    }
+  });
+
+  Future<void> close() => _enqueue(_closeSegment);
+
+  /// 从新到旧读取一页满足 [query] 的记录，从 [cursor] 处继续；为空时从
+  /// 最新的记录开始。单次最多解析 [maxScanBytes] 字节。
+  Future<LogPage> query(
+    LogQuery query, {
+    LogCursor? cursor,
+    int limit = 200,
+    int maxScanBytes = 16 << 20,
+  }) async {
+    await _tail;
+    return _queryInIsolate(
+      directory.path,
+      query,
+      cursor,
+      limit,
+      maxScanBytes,
+    );
+  }
+
+  // 静态方法：传给 Isolate.run 的闭包不能捕获持有文件句柄的 this。
+  static Future<LogPage> _queryInIsolate(
+    String path,
+    LogQuery query,
+    LogCursor? cursor,
+    int limit,
+    int maxScanBytes,
+  ) {
+    return Isolate.run(
+      () => _LogReader(
+        Directory(path),
+        _LogFilter(query),
+      ).readPage(cursor, limit, maxScanBytes),
+    );
+  }
+
+  Future<void> _enqueue(Future<void> Function() operation) {
+    _tail = _tail.then((_) => operation()).catchError((Object _) {});
+    return _tail;
+  }
+
+  Future<void> _append(AppLogEntry entry) async {
+    final bytes = utf8.encode('${formatLogLine(entry)}\n');
+    if (_log != null &&
+        _segmentBytes > 0 &&
+        _segmentBytes + bytes.length > maxSegmentBytes) {
+      await _closeSegment();
+    }
+    if (_log == null) {
+      await _openSegment(entry.timestamp.millisecondsSinceEpoch);
+    }
+
+    await _log!.writeFrom(bytes);
+    final block = _block ??= _BlockStats(_segmentBytes);
+    block.add(entry, bytes.length);
+    _segmentBytes += bytes.length;
+    if (block.count >= blockEntries || block.length >= blockBytes) {
+      await _closeBlock();
+    }
+  }
+
+  Future<void> _openSegment(int nowMillis) async {
+    if (!await directory.exists()) {
+      await directory.create(recursive: true);
+    }
+    final existing = await _listSegments(directory);
+    // 分段 id 必须递增：时钟回拨或同一毫秒内滚动时顺延。
+    final id = existing.isEmpty
+        ? nowMillis
+        : math.max(nowMillis, existing.last.id + 1);
+    final segment = _Segment(directory, id);
+    _log = await segment.logFile.open(mode: FileMode.append);
+    _index = await segment.indexFile.open(mode: FileMode.append);
+    _segment = id;
+    _segmentBytes = 0;
+    _block = null;
+    await _enforceRetention([...existing, segment]);
+  }
+
+  Future<void> _closeBlock() async {
+    final block = _block;
+    final index = _index;
+    _block = null;
+    if (block == null || index == null) return;
+    final record = ByteData(_indexRecordBytes)
+      ..setInt64(0, block.offset, Endian.little)
+      ..setInt64(8, block.firstMillis, Endian.little)
+      ..setInt64(16, block.lastMillis, Endian.little)
+      ..setInt64(24, block.tagBloom, Endian.little)
+      ..setUint32(32, block.length, Endian.little)
+      ..setUint16(36, block.levelMask, Endian.little)
+      ..setUint16(38, block.count, Endian.little);
+    await index.writeFrom(record.buffer.asUint8List());
+  }
+
+  Future<void> _closeSegment() async {
+    await _closeBlock();
+    final log = _log;
+    final index = _index;
+    _log = null;
+    _index = null;
+    await log?.close();
+    await index?.close();
+  }
+
+  Future<void> _enforceRetention(List<_Segment> segments) async {
+    var total = 0;
+    final sizes = <int>[];
+    for (final segment in segments) {
+      final size = await segment.size();
+      sizes.add(size);
+      total += size;
+    }
+    for (var i = 0; i < segments.length && total > maxTotalBytes; i++) {
+      if (segments[i].id == _segment) break;
+      await _deleteSegment(segments[i]);
+      total -= sizes[i];
+    }
+  }
+
+  static Future<void> _deleteSegment(_Segment segment) async {
+    for (final file in [segment.logFile, segment.indexFile]) {
+      try {
+        if (await file.exists()) await file.delete();
+      } on FileSystemException {
+        // Windows 上正被查询读取的分段删不掉，留到下次滚动。
+      }
+    }
+  }
+
+  static Future<List<_Segment>> _listSegments(Directory directory) async {
+    if (!await directory.exists()) return [];
+    final segments = <_Segment>[];
+    await for (final entity in directory.list()) {
+      final id = _Segment.parseId(entity.path);
+      if (id != null) segments.add(_Segment(directory, id));
+    }
+    segments.sort((a, b) => a.id.compareTo(b.id));
+    return segments;
+  }
+}
+
+/// 一条记录的行格式；消息中的反斜杠与换行转义，保证一条记录恰好一行。
+String formatLogLine(AppLogEntry entry) {
+  final message = entry.message
+      .replaceAll(r'\', r'\\')
+      .replaceAll('\r', r'\r')
+      .replaceAll('\n', r'\n');
+  return '${entry.timestamp.toIso8601String()} '
+      '[${entry.level}] [${entry.tag}] $message';
+}
+
+/// [formatLogLine] 的逆操作；无法解析的行返回 null。
+AppLogEntry? parseLogLine(String line) {
+  final tsEnd = line.indexOf(' [');
+  if (tsEnd <= 0) return null;
+  final levelEnd = line.indexOf('] [', tsEnd + 2);
+  if (levelEnd < 0) return null;
+  final tagEnd = line.indexOf('] ', levelEnd + 3);
+  if (tagEnd < 0) return null;
+  final timestamp = DateTime.tryParse(line.substring(0, tsEnd));
+  if (timestamp == null) return null;
+  return AppLogEntry(
+    timestamp: timestamp,
+    level: line.substring(tsEnd + 2, levelEnd),
+    tag: line.substring(levelEnd + 3, tagEnd),
+    message: _unescape(line.substring(tagEnd + 2)),
+  );
+}
+
+String _unescape(String message) {
+  if (!message.contains(r'\')) return message;
+  final buffer = StringBuffer();
+  for (var i = 0; i < message.length; i++) {
+    final c = message[i];
+    if (c != r'\' || i + 1 == message.length) {
+      buffer.write(c);
+      continue;
+    }
+    final next = message[++i];
+    buffer.write(
+      next == 'n'
+          ? '\n'
+          : next == 'r'
+          ? '\r'
+          : next,
+    );
+  }
+  return buffer.toString();
+}
+
+int _levelBit(String level) {
+  final index = logLevels.indexOf(level);
+  return 1 << (index < 0 ? logLevels.length : index);
+}
+
+// FNV-1a，每个模块名在 64 位中置两位。
+int _tagBits(String tag) {
+  var hash = 0x811c9dc5;
+  for (final unit in tag.codeUnits) {
+    hash = ((hash ^ unit) * 0x01000193) & 0xffffffff;
+  }
+  return (1 << (hash & 63)) | (1 << ((hash >> 6) & 63));
+}
+
+class _Segment {
+  _Segment(Directory directory, this.id)
+    : logFile = File(_path(directory, id, 'log')),
+      indexFile = File(_path(directory, id, 'idx'));
+
+  final int id;
+  final File logFile;
+  final File indexFile;
+
+  static final _namePattern = RegExp(r'log-(\d+)\.log$');
+
+  static String _path(Directory directory, int id, String extension) =>
+      '${directory.path}${Platform.pathSeparator}log-$id.$extension';
+
+  static int? parseId(String path) {
+    final match = _namePattern.firstMatch(path);
+    return match == null ? null : int.tryParse(match.group(1)!);
+  }
+
+  Future<int> size() async {
+    var total = 0;
+    for (final file in [logFile, indexFile]) {
+      if (await file.exists()) total += await file.length();
+    }
+    return total;
+  }
+}
+
+class _BlockStats {
+  _BlockStats(this.offset);
+
+  final int offset;
+  int length = 0;
+  int count = 0;
+  int firstMillis = 0;
+  int lastMillis = 0;
+  int levelMask = 0;
+  int tagBloom = 0;
+
+  void add(AppLogEntry entry, int bytes) {
+    final millis = entry.timestamp.millisecondsSinceEpoch;
+    if (count == 0) firstMillis = millis;
+    lastMillis = math.max(lastMillis, millis);
+    firstMillis = math.min(firstMillis, millis);
+    levelMask |= _levelBit(entry.level);
+    tagBloom |= _tagBits(entry.tag);
+    length += bytes;
+    count++;
+  }
+}
+
+class _IndexedBlock {
+  const _IndexedBlock({
+    required this.offset,
+    required this.length,
+    this.firstMillis,
+    this.lastMillis,
+    this.levelMask,
+    this.tagBloom,
+  });
+
+  final int offset;
+  final int length;
+
+  // 以下为 null 表示未索引的尾部，条件未知。
+  final int? firstMillis;
+  final int? lastMillis;
+  final int? levelMask;
+  final int? tagBloom;
+
+  int get end => offset + length;
+}
+
+class _LogFilter {
+  _LogFilter(LogQuery query)
+    : levelMask = _levelMask(query.minLevel),
+      tag = _nonEmpty(query.tag),
+      text = _nonEmpty(query.text)?.toLowerCase(),
+      fromMillis = query.from?.millisecondsSinceEpoch,
+      toMillis = query.to?.millisecondsSinceEpoch;
+
+  final int levelMask;
+  final String? tag;
+  final String? text;
+  final int? fromMillis;
+  final int? toMillis;
+  late final int tagBits = tag == null ? 0 : _tagBits(tag!);
+
+  static String? _nonEmpty(String? value) =>
+      value == null || value.isEmpty ? null : value;
+
+  static int _levelMask(String? minLevel) {
+    final min = minLevel == null ? -1 : logLevels.indexOf(minLevel);
+    if (min < 0) return -1;
+    var mask = 0;
+    for (var i = min; i < logLevels.length; i++) {
+      mask |= 1 << i;
+    }
+    return mask;
+  }
+
+  /// 该块及更早的块都早于 [fromMillis]。
+  bool isBefore(_IndexedBlock block) {
+    final last = block.lastMillis;
+    return fromMillis != null && last != null && last < fromMillis!;
+  }
+
+  bool mayMatch(_IndexedBlock block) {
+    final mask = block.levelMask;
+    if (mask != null && mask & levelMask == 0) return false;
+    final bloom = block.tagBloom;
+    if (bloom != null && bloom & tagBits != tagBits) return false;
+    final first = block.firstMillis;
+    if (toMillis != null && first != null && first >= toMillis!) return false;
+    return true;
+  }
+
+  bool lineMayMatch(String line) =>
+      text == null || line.toLowerCase().contains(text!);
+
+  bool matches(AppLogEntry entry) {
+    if (_levelBit(entry.level) & levelMask == 0) return false;
+    if (tag != null && entry.tag != tag) return false;
+    final millis = entry.timestamp.millisecondsSinceEpoch;
+    if (fromMillis != null && millis < fromMillis!) return false;
+    if (toMillis != null && millis >= toMillis!) return false;
+    return true;
+  }
+}
+
+/// 在后台 isolate 中运行的同步读取器。
+class _LogReader {
+  _LogReader(this.directory, this.filter);
+
+  final Directory directory;
+  final _LogFilter filter;
+
+  LogPage readPage(LogCursor? cursor, int limit, int maxScanBytes) {
+    final entries = <AppLogEntry>[];
+    var scanned = 0;
+    var skipped = 0;
+
+    LogPage page(LogCursor? next) => LogPage(
+      entries: entries,
+      next: next,
+      scannedBytes: scanned,
+      skippedBlocks: skipped,
+    );
+
+    for (final id in _segmentIdsDescending()) {
+      if (cursor != null && id > cursor.segment) continue;
+      // 分段 id 是创建时刻，分段内的记录都不早于它。
+      final toMillis = filter.toMillis;
+      if (toMillis != null && id >= toMillis) continue;
+
+      final segment = _Segment(directory, id);
+      final RandomAccessFile file;
+      try {
+        file = segment.logFile.openSync();
+      } on FileSystemException {
+        continue; // 读取期间被滚动删除
+      }
+      try {
+        final length = file.lengthSync();
+        var end = cursor != null && id == cursor.segment
+            ? math.min(cursor.offset, length)
+            : length;
+        final blocks = _readIndex(segment, length);
+        for (var b = blocks.length - 1; b >= 0; b--) {
+          final block = blocks[b];
+          if (block.offset >= end) continue;
+          if (filter.isBefore(block)) return page(null);
+          if (!filter.mayMatch(block)) {
+            skipped++;
+            end = block.offset;
+            continue;
+          }
+          if (scanned >= maxScanBytes) {
+            return page(LogCursor(segment: id, offset: end));
+          }
+
+          file.setPositionSync(block.offset);
+          final bytes = file.readSync(math.min(block.end, end) - block.offset);
+          scanned += bytes.length;
+          final stop = _collect(bytes, block.offset, entries, limit);
+          if (stop != null) {
+            return page(LogCursor(segment: id, offset: stop));
+          }
+          end = block.offset;
+        }
+      } finally {
+        file.closeSync();
+      }
+    }
+    return page(null);
+  }
+
+  /// 从块尾向前逐行匹配；页满时返回下一页开始（更早）的字节偏移。
+  int? _collect(
+    Uint8List bytes,
+    int baseOffset,
+    List<AppLogEntry> out,
+    int limit,
+  ) {
+    const newline = 0x0A;
+    // 末尾没有换行的是正在写入的半行，跳过。
+    var lineEnd = bytes.lastIndexOf(newline);
+    while (lineEnd >= 0) {
+      final lineStart = lineEnd == 0
+          ? 0
+          : bytes.lastIndexOf(newline, lineEnd - 1) + 1;
+      final line = utf8.decode(
+        Uint8List.sublistView(bytes, lineStart, lineEnd),
+        allowMalformed: true,
+      );
+      if (filter.lineMayMatch(line)) {
+        final entry = parseLogLine(line);
+        if (entry != null && filter.matches(entry)) {
+          out.add(entry);
+          if (out.length >= limit) return baseOffset + lineStart;
+        }
+      }
+      lineEnd = lineStart - 1;
+    }
+    return null;
+  }
+
+  List<int> _segmentIdsDescending() {
+    if (!directory.existsSync()) return const [];
+    final ids = <int>[
+      for (final entity in directory.listSync())
+        if (_Segment.parseId(entity.path) case final id?) id,
+    ];
+    ids.sort((a, b) => b.compareTo(a));
+    return ids;
+  }
+
+  // 读到第一条不连续或越界的索引为止，之后的部分当作未索引尾部。
+  List<_IndexedBlock> _readIndex(_Segment segment, int logLength) {
+    final blocks = <_IndexedBlock>[];
+    var indexed = 0;
+    try {
+      final data = ByteData.sublistView(segment.indexFile.readAsBytesSync());
+      const size = LogStore._indexRecordBytes;
+      for (var at = 0; at + size <= data.lengthInBytes; at += size) {
+        final offset = data.getInt64(at, Endian.little);
+        final length = data.getUint32(at + 32, Endian.little);
+        if (offset != indexed || offset + length > logLength) break;
+        blocks.add(
+          _IndexedBlock(
+            offset: offset,
+            length: length,
+            firstMillis: data.getInt64(at + 8, Endian.little),
+            lastMillis: data.getInt64(at + 16, Endian.little),
+            tagBloom: data.getInt64(at + 24, Endian.little),
+            levelMask: data.getUint16(at + 36, Endian.little),
+          ),
+        );
+        indexed = offset + length;
+      }
+    } on FileSystemException {
+      // 没有索引：整个分段作为一个未索引块。
+    }
+    if (indexed < logLength) {
+      blocks.add(_IndexedBlock(offset: indexed, length: logLength - indexed));
+    }
+    return blocks;
+  }
+}
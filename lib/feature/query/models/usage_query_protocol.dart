@@ -0,0 +1,496 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/usage/models/live_status.dart';
+
+export 'package:ringotrack/feature/usage/models/day_number.dart';
+
+/// 本地查询端点的二进制协议（纯 Dart，客户端脚本也可以直接引用）。
+///
+/// 一个帧 = `u32 payload 长度` + payload，所有整数小端。
+/// 一个 payload 可以携带一批请求，客户端也可以不等响应连续发送多个帧（pipeline），
+/// 服务端按帧的到达顺序逐帧回复，每个请求的响应都带回它的 requestId。
+///
+/// 请求 payload：`u8 version, u16 count`，之后每条请求：
+/// - `u32 requestId, u8 op`
+/// - rangeTotal / appTotals / hourlyDistribution：`i32 startDay, i32 endDay`
+///   （本地日期的日序号，1970-01-01 为 0，闭区间）
+/// - liveStatus：无参数
+///
+/// 响应 payload：`u8 version, u16 count`，之后每条响应：
+/// - `u32 requestId, u8 op, u8 status`
+/// - status 非 ok：`u16 len, utf8 message`
+/// - rangeTotal：`i64 totalMillis`
+/// - appTotals：`u16 n`，之后 n 个 `u16 len, utf8 appId, i64 millis`（按时长降序）
+/// - hourlyDistribution：24 个 `i64 millis`
+/// - liveStatus：`u8 flags(bit0 idle, bit1 tracking), i64 sessionStartMillis
+///   (0 表示无), i64 todayTotalMillis, u16 len, utf8 appId`
+///
+/// TCP 端点（Windows）连接后的第一帧是认证帧：`u8 version, u16 len,
+/// utf8 token`，token 取自端点文件。服务端不回复认证帧，不匹配时直接断开。
+const usageQueryProtocolVersion = 1;
+
+/// 单帧 payload 上限，防止异常客户端让服务端无限缓冲。
+const usageQueryMaxFrameBytes = 1 << 20;
+
+/// 单帧最多携带的请求数。
+const usageQueryMaxBatch = 4096;
+
+enum UsageQueryOp {
+  rangeTotal(1),
+  appTotals(2),
+  hourlyDistribution(3),
+  liveStatus(4);
+
+  const UsageQueryOp(this.code);
+
+  final int code;
+
+  static UsageQueryOp? fromCode(int code) {
+    for (final op in values) {
+      if (op.code == code) return op;
+    }
+    return null;
+  }
+}
+
+enum UsageQueryStatus {
+  ok(0),
+  badRequest(1),
+  internalError(2);
+
+  const UsageQueryStatus(this.code);
+
+  final int code;
+
+  static UsageQueryStatus fromCode(int code) {
+    for (final status in values) {
+      if (status.code == code) return status;
+    }
+    return internalError;
+  }
+}
+
+class UsageQueryRequest {
+  const UsageQueryRequest._(this.id, this.op, this.startDay, this.endDay);
+
+  const UsageQueryRequest.rangeTotal(int id, int startDay, int endDay)
+    : this._(id, UsageQueryOp.rangeTotal, startDay, endDay);
+
+  const UsageQueryRequest.appTotals(int id, int startDay, int endDay)
+    : this._(id, UsageQueryOp.appTotals, startDay, endDay);
+
+  const UsageQueryRequest.hourlyDistribution(int id, int startDay, int endDay)
+    : this._(id, UsageQueryOp.hourlyDistribution, startDay, endDay);
+
+  const UsageQueryRequest.liveStatus(int id)
+    : this._(id, UsageQueryOp.liveStatus, 0, 0);
+
+  final int id;
+  final UsageQueryOp op;
+  final int startDay;
+  final int endDay;
+}
+
+class UsageQueryResponse {
+  const UsageQueryResponse._({
+    required this.id,
+    required this.op,
+    this.status = UsageQueryStatus.ok,
+    this.error,
+    this.total,
+    this.appTotals,
+    this.hourly,
+    this.liveStatus,
+  });
+
+  const UsageQueryResponse.rangeTotal(int id, Duration total)
+    : this._(id: id, op: UsageQueryOp.rangeTotal, total: total);
+
+  const UsageQueryResponse.appTotals(
+    int id,
+    List<MapEntry<String, Duration>> appTotals,
+  ) : this._(id: id, op: UsageQueryOp.appTotals, appTotals: appTotals);
+
+  const UsageQueryResponse.hourlyDistribution(int id, List<Duration> hourly)
+    : this._(id: id, op: UsageQueryOp.hourlyDistribution, hourly: hourly);
+
+  const UsageQueryResponse.liveStatus(int id, LiveStatus liveStatus)
+    : this._(id: id, op: UsageQueryOp.liveStatus, liveStatus: liveStatus);
+
+  const UsageQueryResponse.error(
+    int id,
+    UsageQueryOp op,
+    UsageQueryStatus status,
+    String error,
+  ) : this._(id: id, op: op, status: status, error: error);
+
+  final int id;
+  final UsageQueryOp op;
+  final UsageQueryStatus status;
+  final String? error;
+
+  final Duration? total;
+  final List<MapEntry<String, Duration>>? appTotals;
+
+  /// 长度固定为 24，下标即小时。
+  final List<Duration>? hourly;
+  final LiveStatus? liveStatus;
+
+  bool get isOk => status == UsageQueryStatus.ok;
+}
+
+// ============================================================================
+// 编码
+// ============================================================================
+
+Uint8List encodeUsageQueryRequests(List<UsageQueryRequest> requests) {
+  _checkBatchSize(requests.length);
+  final writer = _FrameWriter(8 + requests.length * 13);
+  writer.u8(usageQueryProtocolVersion);
+  writer.u16(requests.length);
+  for (final request in requests) {
+    writer.u32(request.id);
+    writer.u8(request.op.code);
+    if (request.op != UsageQueryOp.liveStatus) {
+      writer.i32(request.startDay);
+      writer.i32(request.endDay);
+    }
+  }
+  return writer.takeFrame();
+}
+
+Uint8List encodeUsageQueryResponses(List<UsageQueryResponse> responses) {
+  _checkBatchSize(responses.length);
+  final writer = _FrameWriter(8 + responses.length * 16);
+  writer.u8(usageQueryProtocolVersion);
+  writer.u16(responses.length);
+  for (final response in responses) {
+    writer.u32(response.id);
+    writer.u8(response.op.code);
+    writer.u8(response.status.code);
+    if (!response.isOk) {
+      writer.string(response.error ?? '');
+      continue;
+    }
+    switch (response.op) {
+      case UsageQueryOp.rangeTotal:
+        writer.i64(response.total!.inMilliseconds);
+      case UsageQueryOp.appTotals:
+        final totals = response.appTotals!;
+        writer.u16(totals.length);
+        for (final entry in totals) {
+          writer.string(entry.key);
+          writer.i64(entry.value.inMilliseconds);
+        }
+      case UsageQueryOp.hourlyDistribution:
+        final hourly = response.hourly!;
+        for (var hour = 0; hour < 24; hour++) {
+          writer.i64(hourly[hour].inMilliseconds);
+        }
+      case UsageQueryOp.liveStatus:
+        final status = response.liveStatus!;
+        writer.u8((status.isIdle ? 1 : 0) | (status.isTracking ? 2 : 0));
+        writer.i64(status.sessionStart?.millisecondsSinceEpoch ?? 0);
+        writer.i64(status.todayTotal.inMilliseconds);
+        writer.string(status.appId ?? '');
+    }
+  }
+  return writer.takeFrame();
+}
+
+Uint8List encodeUsageQueryAuth(String token) {
+  final writer = _FrameWriter(8 + token.length);
+  writer.u8(usageQueryProtocolVersion);
+  writer.string(token);
+  return writer.takeFrame();
+}
+
+void _checkBatchSize(int count) {
+  if (count > usageQueryMaxBatch) {
+    throw ArgumentError.value(count, 'count', 'batch too large');
+  }
+}
+
+// ============================================================================
+// 解码
+// ============================================================================
+
+/// 解析请求 payload；格式错误时抛出 [FormatException]。
+List<UsageQueryRequest> decodeUsageQueryRequests(Uint8List payload) {
+  final reader = _PayloadReader(payload);
+  final count = reader.header();
+  final requests = <UsageQueryRequest>[];
+  for (var i = 0; i < count; i++) {
+    final id = reader.u32();
+    final code = reader.u8();
+    final op = UsageQueryOp.fromCode(code);
+    if (op == null) {
+      throw FormatException('unknown op $code');
+    }
+    if (op == UsageQueryOp.liveStatus) {
+      requests.add(UsageQueryRequest.liveStatus(id));
+    } else {
+      requests.add(UsageQueryRequest._(id, op, reader.i32(), reader.i32()));
+    }
+  }
+  reader.expectEnd();
+  return requests;
+}
+
+/// 解析认证帧 payload，返回其中的 token；格式错误时抛出 [FormatException]。
+String decodeUsageQueryAuth(Uint8List payload) {
+  final reader = _PayloadReader(payload);
+  final version = reader.u8();
+  if (version != usageQueryProtocolVersion) {
+    throw FormatException('unsupported protocol version $version');
+  }
+  final token = reader.string();
+  reader.expectEnd();
+  return token;
+}
+
+/// 解析响应 payload；格式错误时抛出 [FormatException]。
+List<UsageQueryResponse> decodeUsageQueryResponses(Uint8List payload) {
+  final reader = _PayloadReader(payload);
+  final count = reader.header();
+  final responses = <UsageQueryResponse>[];
+  for (var i = 0; i < count; i++) {
+    final id = reader.u32();
+    final code = reader.u8();
+    final op = UsageQueryOp.fromCode(code);
+    if (op == null) {
+      throw FormatException('unknown op $code');
+    }
+    final status = UsageQueryStatus.fromCode(reader.u8());
+    if (status != UsageQueryStatus.ok) {
+      responses.add(UsageQueryResponse.error(id, op, status, reader.string()));
+      continue;
+    }
+    switch (op) {
+      case UsageQueryOp.rangeTotal:
+        responses.add(
+          UsageQueryResponse.rangeTotal(id, Duration(milliseconds: reader.i64())),
+        );
+      case UsageQueryOp.appTotals:
+        final n = reader.u16();
+        final totals = <MapEntry<String, Duration>>[];
+        for (var j = 0; j < n; j++) {
+          final appId = reader.string();
+          totals.add(MapEntry(appId, Duration(milliseconds: reader.i64())));
+        }
+        responses.add(UsageQueryResponse.appTotals(id, totals));
+      case UsageQueryOp.hourlyDistribution:
+        final hourly = List<Duration>.generate(
+          24,
+          (_) => Duration(milliseconds: reader.i64()),
+        );
+        responses.add(UsageQueryResponse.hourlyDistribution(id, hourly));
+      case UsageQueryOp.liveStatus:
+        final flags = reader.u8();
+        final sessionStartMillis = reader.i64();
+        final todayTotalMillis = reader.i64();
+        final appId = reader.string();
+        responses.add(
+          UsageQueryResponse.liveStatus(
+            id,
+            LiveStatus(
+              appId: appId.isEmpty ? null : appId,
+              sessionStart: sessionStartMillis == 0
+                  ? null
+                  : DateTime.fromMillisecondsSinceEpoch(sessionStartMillis),
+              todayTotal: Duration(milliseconds: todayTotalMillis),
+              isIdle: (flags & 1) != 0,
+              isTracking: (flags & 2) != 0,
+            ),
+          ),
+        );
+    }
+  }
+  reader.expectEnd();
+  return responses;
+}
+
+/// 把 socket 上任意切分的字节流还原成一个个完整的 payload。
+class UsageQueryFrameDecoder {
+  final _buffer = BytesBuilder(copy: false);
+  Uint8List _pending = Uint8List(0);
+
+  /// 追加一段数据，返回其中已经完整到达的 payload（可能为空）。
+  /// 帧长度超过 [usageQueryMaxFrameBytes] 时抛出 [FormatException]。
+  List<Uint8List> add(List<int> chunk) {
+    if (_pending.isNotEmpty) {
+      _buffer.add(_pending);
+    }
+    _buffer.add(chunk);
+    final data = _buffer.takeBytes();
+
+    final frames = <Uint8List>[];
+    var offset = 0;
+    while (data.length - offset >= 4) {
+      final length = ByteData.sublistView(
+        data,
+        offset,
+        offset + 4,
+      ).getUint32(0, Endian.little);
+      if (length > usageQueryMaxFrameBytes) {
+        throw FormatException('frame too large: $length bytes');
+      }
+      if (data.length - offset - 4 < length) break;
+      frames.add(Uint8List.sublistView(data, offset + 4, offset + 4 + length));
+      offset += 4 + length;
+    }
+    _pending = offset == data.length
+        ? Uint8List(0)
+        : Uint8List.fromList(Uint8List.sublistView(data, offset));
+    return frames;
+  }
+}
+
+class _FrameWriter {
+  _FrameWriter(int initialCapacity)
+    : _bytes = Uint8List(initialCapacity < 16 ? 16 : initialCapacity) {
+    _data = ByteData.sublistView(_bytes);
+    _length = 4; // 预留帧长度
+  }
+
+  Uint8List _bytes;
+  late ByteData _data;
+  late int _length;
+
+  void _reserve(int extra) {
+    if (_length + extra <= _bytes.length) return;
+    var capacity = _bytes.length * 2;
+    while (capacity < _length + extra) {
+      capacity *= 2;
+    }
+    final grown = Uint8List(capacity)..setRange(0, _length, _bytes);
+    _bytes = grown;
+    _data = ByteData.sublistView(_bytes);
+  }
+
+  void u8(int value) {
+    _reserve(1);
+    _data.setUint8(_length, value);
+    _length += 1;
+  }
+
+  void u16(int value) {
+    _reserve(2);
+    _data.setUint16(_length, value, Endian.little);
+    _length += 2;
+  }
+
+  void u32(int value) {
+    _reserve(4);
+    _data.setUint32(_length, value, Endian.little);
+    _length += 4;
+  }
+
+  void i32(int value) {
+    _reserve(4);
+    _data.setInt32(_length, value, Endian.little);
+    _length += 4;
+  }
+
+  void i64(int value) {
+    _reserve(8);
+    _data.setInt64(_length, value, Endian.little);
+    _length += 8;
+  }
+
+  void string(String value) {
+    var bytes = utf8.encode(value);
+    if (bytes.length > 0xFFFF) {
+      bytes = bytes.sublist(0, 0xFFFF);
+    }
+    u16(bytes.length);
+    _reserve(bytes.length);
+    _bytes.setRange(_length, _length + bytes.length, bytes);
+    _length += bytes.length;
+  }
+
+  Uint8List takeFrame() {
+    final payloadLength = _length - 4;
+    if (payloadLength > usageQueryMaxFrameBytes) {
+      throw StateError('frame too large: $payloadLength bytes');
+    }
+    _data.setUint32(0, payloadLength, Endian.little);
+    return Uint8List.sublistView(_bytes, 0, _length);
+  }
+}
+
+class _PayloadReader {
+  _PayloadReader(this._bytes) : _data = ByteData.sublistView(_bytes);
+
+  final Uint8List _bytes;
+  final ByteData _data;
+  int _offset = 0;
+
+  void _need(int size) {
+    if (_offset + size > _bytes.length) {
+      throw const FormatException('truncated payload');
+    }
+  }
+
+  int header() {
+    final version = u8();
+    if (version != usageQueryProtocolVersion) {
+      throw FormatException('unsupported protocol version $version');
+    }
+    final count = u16();
+    if (count > usageQueryMaxBatch) {
+      throw FormatException('batch too large: $count');
+    }
+    return count;
+  }
+
+  int u8() {
+    _need(1);
+    return _data.getUint8(_offset++);
+  }
+
+  int u16() {
+    _need(2);
+    final value = _data.getUint16(_offset, Endian.little);
+    _offset += 2;
+    return value;
+  }
+
+  int u32() {
+    _need(4);
+    final value = _data.getUint32(_offset, Endian.little);
+    _offset += 4;
+    return value;
+  }
+
+  int i32() {
+    _need(4);
+    final value = _data.getInt32(_offset, Endian.little);
+    _offset += 4;
+    return value;
+  }
+
+  int i64() {
+    _need(8);
+    final value = _data.getInt64(_offset, Endian.little);
+    _offset += 8;
+    return value;
+  }
+
+  String string() {
+    final length = u16();
+    _need(length);
+    final value = utf8.decode(
+      Uint8List.sublistView(_bytes, _offset, _offset + length),
+    );
+    _offset += length;
+    return value;
+  }
+
+  void expectEnd() {
+    if (_offset != _bytes.length) {
+      throw const FormatException('trailing bytes in payload');
+    }
+  }
+}
@@ -0,0 +1,238 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/query/models/usage_query_protocol.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+
+/// 查询端点使用的内存聚合。
+///
+/// 按自然年懒加载：某一年第一次被查询时从仓库读一次，之后完全在内存里回答，
+/// 并通过 UsageService 的增量流保持最新，热查询不会再碰 SQLite。
+/// 与仪表盘的 Provider 一样，年份加载期间到达的增量会被忽略。
+class UsageQueryCache {
+  UsageQueryCache({
+    required UsageRepository repository,
+    Stream<Map<DateTime, Map<String, Duration>>>? deltaStream,
+    Stream<Map<DateTime, Map<int, Map<String, Duration>>>>? hourlyDeltaStream,
+  }) : _repository = repository {
+    _deltaSubscription = deltaStream?.listen(_applyDelta);
+    _hourlyDeltaSubscription = hourlyDeltaStream?.listen(_applyHourlyDelta);
+  }
+
+  /// 单次查询允许的最大跨度（天）。
+  static const maxRangeDays = 366 * 50;
+
+  /// 支持的日序号范围：0001-01-01 至 9999-12-31。超出时换算日期会抛出
+  /// ArgumentError，必须在换算前拒绝。
+  static const minDay = -719162;
+  static const maxDay = 2932896;
+
+  final UsageRepository _repository;
+  StreamSubscription<Map<DateTime, Map<String, Duration>>>? _deltaSubscription;
+  StreamSubscription<Map<DateTime, Map<int, Map<String, Duration>>>>?
+  _hourlyDeltaSubscription;
+
+  // 年份 -> 加载任务；任务完成后对应年份进入 *Loaded 集合。
+  final Map<int, Future<void>> _dailyLoads = {};
+  final Set<int> _dailyLoaded = {};
+  final Map<int, Future<void>> _hourlyLoads = {};
+  final Set<int> _hourlyLoaded = {};
+
+  // 日序号 -> AppId -> 毫秒
+  final Map<int, Map<String, int>> _daily = {};
+  // 日序号 -> 当日合计毫秒
+  final Map<int, int> _dailyTotals = {};
+  // 日序号 -> 24 个小时桶（所有应用合计的毫秒）
+  final Map<int, Int64List> _hourly = {};
+
+  // 每次 invalidate 递增，用于丢弃失效前发起的加载结果。
+  int _generation = 0;
+
+  /// 丢弃所有缓存；删除 / 清空数据后调用。
+  void invalidate() {
+    _generation++;
+    _dailyLoads.clear();
+    _dailyLoaded.clear();
+    _hourlyLoads.clear();
+    _hourlyLoaded.clear();
+    _daily.clear();
+    _dailyTotals.clear();
+    _hourly.clear();
+  }
+
+  /// 保证 [request] 需要的数据都已在内存中。
+  /// 已就绪时返回 null，调用方可以同步调用 [answer]。
+  Future<void>? prepare(UsageQueryRequest request) {
+    if (request.op == UsageQueryOp.liveStatus || !_isValidRange(request)) {
+      return null;
+    }
+    final hourly = request.op == UsageQueryOp.hourlyDistribution;
+    final loaded = hourly ? _hourlyLoaded : _dailyLoaded;
+    final startYear = _yearOf(request.startDay);
+    final endYear = _yearOf(request.endDay);
+
+    List<Future<void>>? pending;
+    for (var year = startYear; year <= endYear; year++) {
+      if (loaded.contains(year)) continue;
+      (pending ??= []).add(hourly ? _loadHourlyYear(year) : _loadDailyYear(year));
+    }
+    return pending == null ? null : Future.wait(pending);
+  }
+
+  /// 回答一条区间类请求；调用前必须先完成 [prepare]。
+  UsageQueryResponse answer(UsageQueryRequest request) {
+    if (!_isValidRange(request)) {
+      return UsageQueryResponse.error(
+        request.id,
+        request.op,
+        UsageQueryStatus.badRequest,
+        'invalid day range ${request.startDay}..${request.endDay}',
+      );
+    }
+
+    switch (request.op) {
+      case UsageQueryOp.rangeTotal:
+        var total = 0;
+        for (var day = request.startDay; day <= request.endDay; day++) {
+          total += _dailyTotals[day] ?? 0;
+        }
+        return UsageQueryResponse.rangeTotal(
+          request.id,
+          Duration(milliseconds: total),
+        );
+      case UsageQueryOp.appTotals:
+        final totals = <String, int>{};
+        for (var day = request.startDay; day <= request.endDay; day++) {
+          _daily[day]?.forEach((appId, millis) {
+            totals[appId] = (totals[appId] ?? 0) + millis;
+          });
+        }
+        final entries =
+            totals.entries
+                .where((e) => e.value > 0)
+                .map((e) => MapEntry(e.key, Duration(milliseconds: e.value)))
+                .toList()
+              ..sort((a, b) => b.value.compareTo(a.value));
+        return UsageQueryResponse.appTotals(request.id, entries);
+      case UsageQueryOp.hourlyDistribution:
+        final buckets = Int64List(24);
+        for (var day = request.startDay; day <= request.endDay; day++) {
+          final perHour = _hourly[day];
+          if (perHour == null) continue;
+          for (var hour = 0; hour < 24; hour++) {
+            buckets[hour] += perHour[hour];
+          }
+        }
+        return UsageQueryResponse.hourlyDistribution(
+          request.id,
+          List<Duration>.generate(
+            24,
+            (hour) => Duration(milliseconds: buckets[hour]),
+          ),
+        );
+      case UsageQueryOp.liveStatus:
+        throw ArgumentError('live status is not served by the cache');
+    }
+  }
+
+  Future<void> close() async {
+    await _deltaSubscription?.cancel();
+    await _hourlyDeltaSubscription?.cancel();
+  }
+
+  bool _isValidRange(UsageQueryRequest request) {
+    return request.startDay >= minDay &&
+        request.endDay <= maxDay &&
+        request.endDay >= request.startDay &&
+        request.endDay - request.startDay < maxRangeDays;
+  }
+
+  Future<void> _loadDailyYear(int year) {
+    return _dailyLoads.putIfAbsent(year, () async {
+      final generation = _generation;
+      final Map<DateTime, Map<String, Duration>> data;
+      try {
+        data = await _repository.loadRange(
+          DateTime(year, 1, 1),
+          DateTime(year, 12, 31),
+        );
+      } catch (_) {
+        // 允许下次查询重试。
+        if (generation == _generation) _dailyLoads.remove(year);
+        rethrow;
+      }
+      if (generation != _generation) return;
+
+      data.forEach((date, perApp) {
+        final day = dayNumberOf(date);
+        final target = _daily.putIfAbsent(day, () => <String, int>{});
+        perApp.forEach((appId, duration) {
+          target[appId] = (target[appId] ?? 0) + duration.inMilliseconds;
+          _dailyTotals[day] = (_dailyTotals[day] ?? 0) + duration.inMilliseconds;
+        });
+      });
+      _dailyLoaded.add(year);
+    });
+  }
+
+  Future<void> _loadHourlyYear(int year) {
+    return _hourlyLoads.putIfAbsent(year, () async {
+      final generation = _generation;
+      final Map<DateTime, Map<int, Map<String, Duration>>> data;
+      try {
+        data = await _repository.loadHourlyRange(
+          DateTime(year, 1, 1),
+          DateTime(year, 12, 31),
+        );
+      } catch (_) {
+        // 允许下次查询重试。
+        if (generation == _generation) _hourlyLoads.remove(year);
+        rethrow;
+      }
+      if (generation != _generation) return;
+
+      data.forEach((date, perHour) {
+        final buckets = _hourly.putIfAbsent(dayNumberOf(date), _newBuckets);
+        perHour.forEach((hour, perApp) {
+          for (final duration in perApp.values) {
+            buckets[hour] += duration.inMilliseconds;
+          }
+        });
+      });
+      _hourlyLoaded.add(year);
+    });
+  }
+
+  void _applyDelta(Map<DateTime, Map<String, Duration>> delta) {
+    delta.forEach((date, perApp) {
+      if (!_dailyLoaded.contains(date.year)) return;
+      final day = dayNumberOf(date);
+      final target = _daily.putIfAbsent(day, () => <String, int>{});
+      perApp.forEach((appId, duration) {
+        target[appId] = (target[appId] ?? 0) + duration.inMilliseconds;
+        _dailyTotals[day] = (_dailyTotals[day] ?? 0) + duration.inMilliseconds;
+      });
+    });
+  }
+
+  void _applyHourlyDelta(Map<DateTime, Map<int, Map<String, Duration>>> delta) {
+    delta.forEach((date, perHour) {
+      if (!_hourlyLoaded.contains(date.year)) return;
+      final buckets = _hourly.putIfAbsent(dayNumberOf(date), _newBuckets);
+      perHour.forEach((hour, perApp) {
+        for (final duration in perApp.values) {
+          buckets[hour] += duration.inMilliseconds;
+        }
+      });
+    });
+  }
+}
+
+Int64List _newBuckets() => Int64List(24);
+
+int _yearOf(int dayNumber) {
+  return DateTime.fromMillisecondsSinceEpoch(
+    dayNumber * Duration.millisecondsPerDay,
+    isUtc: true,
+  ).year;
+}
@@ -0,0 +1,103 @@
+import 'dart:async';
+import 'dart:collection';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/query/models/usage_query_protocol.dart';
+
+/// 默认端点路径：优先 `$XDG_RUNTIME_DIR`，否则系统临时目录。
+///
+/// Windows 下端点文件里有认证 token，放在只有当前用户可读的
+/// `%LOCALAPPDATA%` 中。
+String defaultUsageQueryEndpointPath() {
+  final env = Platform.environment;
+  if (Platform.isWindows) {
+    final localAppData = env['LOCALAPPDATA'];
+    if (localAppData != null && localAppData.isNotEmpty) {
+      return '$localAppData\\ringotrack.query.endpoint';
+    }
+  }
+  final runtimeDir = env['XDG_RUNTIME_DIR'];
+  final dir = (runtimeDir != null && runtimeDir.isNotEmpty)
+      ? runtimeDir
+      : Directory.systemTemp.path;
+  return '$dir${Platform.pathSeparator}ringotrack.query.sock';
+}
+
+/// 查询端点的客户端（只依赖 dart:io，可在独立脚本中使用）。
+///
+/// [send] 可以不等上一批返回就连续调用：请求直接写入 socket，
+/// 服务端按顺序回复，这里按 FIFO 把响应交还给对应的调用方。
+class UsageQueryClient {
+  UsageQueryClient._(this._socket) {
+    _subscription = _socket.listen(
+      _onData,
+      onError: _failAll,
+      onDone: () => _failAll(const SocketException('connection closed')),
+      cancelOnError: true,
+    );
+  }
+
+  final Socket _socket;
+  late final StreamSubscription<Uint8List> _subscription;
+  final _decoder = UsageQueryFrameDecoder();
+  final _inFlight = Queue<Completer<List<UsageQueryResponse>>>();
+
+  /// 连接 [endpointPath]：Unix domain socket，或 Windows 下服务端写出的
+  /// `tcp:<host>:<port>:<token>` 端点文件（连接后先发送认证帧）。
+  static Future<UsageQueryClient> connect(String endpointPath) async {
+    final type = FileSystemEntity.typeSync(endpointPath, followLinks: false);
+    final Socket socket;
+    if (type == FileSystemEntityType.file) {
+      final endpoint = (await File(endpointPath).readAsString()).trim();
+      final parts = endpoint.split(':');
+      if (parts.length != 4 || parts[0] != 'tcp') {
+        throw const FormatException('bad endpoint file');
+      }
+      socket = await Socket.connect(parts[1], int.parse(parts[2]));
+      socket.setOption(SocketOption.tcpNoDelay, true);
+      socket.add(encodeUsageQueryAuth(parts[3]));
+    } else {
+      socket = await Socket.connect(
+        InternetAddress(endpointPath, type: InternetAddressType.unix),
+        0,
+      );
+    }
+    return UsageQueryClient._(socket);
+  }
+
+  /// 发送一批请求；返回的响应与 [requests] 一一对应、顺序一致。
+  Future<List<UsageQueryResponse>> send(List<UsageQueryRequest> requests) {
+    final completer = Completer<List<UsageQueryResponse>>();
+    _inFlight.add(completer);
+    _socket.add(encodeUsageQueryRequests(requests));
+    return completer.future;
+  }
+
+  Future<void> close() async {
+    await _socket.close();
+    await _subscription.cancel();
+    _failAll(const SocketException('client closed'));
+  }
+
+  void _onData(Uint8List chunk) {
+    try {
+      for (final payload in _decoder.add(chunk)) {
+        final responses = decodeUsageQueryResponses(payload);
+        if (_inFlight.isEmpty) {
+          throw const FormatException('unexpected response frame');
+        }
+        _inFlight.removeFirst().complete(responses);
+      }
+    } on FormatException catch (e) {
+      _failAll(e);
+      _socket.destroy();
+    }
+  }
+
+  void _failAll(Object error) {
+    while (_inFlight.isNotEmpty) {
+      _inFlight.removeFirst().completeError(error);
+    }
+  }
+}
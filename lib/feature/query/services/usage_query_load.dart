@@ -0,0 +1,137 @@
+import 'dart:async';
+import 'dart:convert';
+
+import 'package:ringotrack/feature/query/models/usage_query_protocol.dart';
+import 'package:ringotrack/feature/query/services/usage_query_client.dart';
+
+/// 一次压测的结果；延迟按「批」统计（从写出请求帧到收到完整响应帧）。
+class UsageQueryLoadReport {
+  const UsageQueryLoadReport({
+    required this.connections,
+    required this.batches,
+    required this.requests,
+    required this.errors,
+    required this.elapsed,
+    required this.p50,
+    required this.p99,
+    required this.max,
+  });
+
+  final int connections;
+  final int batches;
+  final int requests;
+
+  /// 状态非 ok 的响应条数。
+  final int errors;
+  final Duration elapsed;
+  final Duration p50;
+  final Duration p99;
+  final Duration max;
+
+  double get requestsPerSecond =>
+      elapsed.inMicroseconds == 0 ? 0 : requests * 1e6 / elapsed.inMicroseconds;
+
+  Map<String, Object> toJson() => {
+    'connections': connections,
+    'batches': batches,
+    'requests': requests,
+    'errors': errors,
+    'elapsed_ms': elapsed.inMicroseconds / 1000,
+    'requests_per_second': requestsPerSecond.round(),
+    'p50_us': p50.inMicroseconds,
+    'p99_us': p99.inMicroseconds,
+    'max_us': max.inMicroseconds,
+  };
+
+  @override
+  String toString() => jsonEncode(toJson());
+}
+
+/// 对 [endpointPath] 发起压测：[connections] 条连接并发，每条连接发送
+/// [batchesPerConnection] 批、每批 [batchSize] 条混合请求，最多
+/// [pipelineDepth] 批同时在途。
+Future<UsageQueryLoadReport> runUsageQueryLoad({
+  required String endpointPath,
+  int connections = 4,
+  int batchesPerConnection = 1000,
+  int batchSize = 8,
+  int pipelineDepth = 16,
+  DateTime? today,
+}) async {
+  final batch = _mixedBatch(dayNumberOf(today ?? DateTime.now()), batchSize);
+  final clients = <UsageQueryClient>[];
+  for (var i = 0; i < connections; i++) {
+    clients.add(await UsageQueryClient.connect(endpointPath));
+  }
+
+  final latencies = <int>[];
+  var errors = 0;
+  final stopwatch = Stopwatch()..start();
+
+  Future<void> drive(UsageQueryClient client) async {
+    var sent = 0;
+    final inFlight = <Future<void>>{};
+    while (sent < batchesPerConnection) {
+      while (inFlight.length < pipelineDepth && sent < batchesPerConnection) {
+        final startedAt = stopwatch.elapsedMicroseconds;
+        late final Future<void> future;
+        future = client.send(batch).then((responses) {
+          latencies.add(stopwatch.elapsedMicroseconds - startedAt);
+          errors += responses.where((r) => !r.isOk).length;
+          inFlight.remove(future);
+        });
+        inFlight.add(future);
+        sent++;
+      }
+      await Future.any(inFlight);
+    }
+    await Future.wait(inFlight);
+  }
+
+  try {
+    await Future.wait(clients.map(drive));
+  } finally {
+    for (final client in clients) {
+      await client.close();
+    }
+  }
+  stopwatch.stop();
+
+  latencies.sort();
+  Duration percentile(double p) {
+    if (latencies.isEmpty) return Duration.zero;
+    final rank = (p * latencies.length).ceil().clamp(1, latencies.length);
+    return Duration(microseconds: latencies[rank - 1]);
+  }
+
+  return UsageQueryLoadReport(
+    connections: connections,
+    batches: latencies.length,
+    requests: latencies.length * batch.length,
+    errors: errors,
+    elapsed: stopwatch.elapsed,
+    p50: percentile(0.50),
+    p99: percentile(0.99),
+    max: percentile(1.0),
+  );
+}
+
+/// 模拟仪表盘式的混合查询：近 7 天合计、本月应用排行、近 30 天小时分布、实时状态。
+List<UsageQueryRequest> _mixedBatch(int today, int size) {
+  final requests = <UsageQueryRequest>[];
+  for (var i = 0; i < size; i++) {
+    switch (i % 4) {
+      case 0:
+        requests.add(UsageQueryRequest.rangeTotal(i, today - 6, today));
+      case 1:
+        requests.add(UsageQueryRequest.appTotals(i, today - 29, today));
+      case 2:
+        requests.add(
+          UsageQueryRequest.hourlyDistribution(i, today - 29, today),
+        );
+      default:
+        requests.add(UsageQueryRequest.liveStatus(i));
+    }
+  }
+  return requests;
+}
@@ -0,0 +1,301 @@
+import 'dart:async';
+import 'dart:collection';
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/query/models/usage_query_protocol.dart';
+import 'package:ringotrack/feature/query/services/usage_query_cache.dart';
+import 'package:ringotrack/feature/query/services/usage_query_client.dart';
+import 'package:ringotrack/feature/usage/models/live_status.dart';
+
+/// 本机查询端点：让脚本 / 其它工具读取使用数据，而不必直接打开 SQLite。
+///
+/// - Linux / macOS：监听 [endpointPath] 上的 Unix domain socket；
+/// - Windows：Dart 尚不支持命名管道与 AF_UNIX，改为监听 127.0.0.1 的随机端口，
+///   并把 `tcp:127.0.0.1:<port>:<token>` 写入 [endpointPath]，客户端读取后连接。
+///   本机任何进程都能连上回环端口，因此第一帧必须带上这个随机 token；
+///   端点文件默认位于只有当前用户可读的 `%LOCALAPPDATA%`。
+///
+/// 协议见 usage_query_protocol.dart。同一连接上的帧严格按到达顺序回复；
+/// 命中内存的批次同步应答，冷数据才会等待仓库加载。
+class UsageQueryServer {
+  UsageQueryServer._(
+    this._serverSocket,
+    this.endpointPath,
+    this.cache,
+    this._liveStatus,
+    this._token,
+  ) {
+    _serverSocket.listen(
+      _onConnection,
+      onError: (Object e, StackTrace st) {
+        AppLogService.instance.logError(_logTag, 'accept failed: $e\n$st');
+      },
+    );
+  }
+
+  static const _logTag = 'usage_query_server';
+
+  /// 环境变量：设置后启用查询端点。值为 `1` 时使用 [defaultUsageQueryEndpointPath]，
+  /// 否则视为端点文件路径。
+  static const enableEnvironmentKey = 'RINGOTRACK_QUERY_SERVER';
+
+  final ServerSocket _serverSocket;
+  final String endpointPath;
+  final UsageQueryCache cache;
+  final LiveStatus Function() _liveStatus;
+  final Set<_UsageQueryConnection> _connections = {};
+
+  /// TCP 端点的认证 token；Unix domain socket 为 null（由文件权限保护）。
+  final List<int>? _token;
+
+  /// 根据环境变量解析端点路径；未启用时返回 null。
+  static String? endpointPathFromEnvironment() {
+    final value = Platform.environment[enableEnvironmentKey];
+    if (value == null || value.isEmpty || value == '0') return null;
+    return value == '1' ? defaultUsageQueryEndpointPath() : value;
+  }
+
+  /// [loopbackTcp] 默认只在 Windows 上开启，测试可以在其它平台上强制
+  /// 使用 TCP 端点。
+  static Future<UsageQueryServer> bind({
+    required String endpointPath,
+    required UsageQueryCache cache,
+    required LiveStatus Function() liveStatus,
+    bool? loopbackTcp,
+  }) async {
+    final ServerSocket serverSocket;
+    String? token;
+    if (loopbackTcp ?? Platform.isWindows) {
+      final random = Random.secure();
+      token = [
+        for (var i = 0; i < 32; i++)
+          random.nextInt(256).toRadixString(16).padLeft(2, '0'),
+      ].join();
+      serverSocket = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+      await File(endpointPath).writeAsString(
+        'tcp:127.0.0.1:${serverSocket.port}:$token',
+        flush: true,
+      );
+    } else {
+      // 上次异常退出可能残留 socket 文件，bind 前清掉。
+      final stale = FileSystemEntity.typeSync(endpointPath, followLinks: false);
+      if (stale == FileSystemEntityType.unixDomainSock) {
+        File(endpointPath).deleteSync();
+      }
+      serverSocket = await ServerSocket.bind(
+        InternetAddress(endpointPath, type: InternetAddressType.unix),
+        0,
+      );
+    }
+
+    AppLogService.instance.logInfo(_logTag, 'listening on $endpointPath');
+    return UsageQueryServer._(
+      serverSocket,
+      endpointPath,
+      cache,
+      liveStatus,
+      token == null ? null : utf8.encode(token),
+    );
+  }
+
+  Future<void> close() async {
+    // 先同步删除端点文件：Provider 重建时新实例可能紧接着 bind 同一路径。
+    try {
+      final type = FileSystemEntity.typeSync(endpointPath, followLinks: false);
+      if (type != FileSystemEntityType.notFound) {
+        File(endpointPath).deleteSync();
+      }
+    } on FileSystemException catch (_) {
+      // 文件已被外部删除，忽略。
+    }
+    for (final connection in _connections.toList()) {
+      connection.destroy();
+    }
+    _connections.clear();
+    await _serverSocket.close();
+    await cache.close();
+  }
+
+  void _onConnection(Socket socket) {
+    if (socket.address.type != InternetAddressType.unix) {
+      socket.setOption(SocketOption.tcpNoDelay, true);
+    }
+    final connection = _UsageQueryConnection(this, socket);
+    _connections.add(connection);
+  }
+
+  /// 认证帧中的 token 是否与端点文件一致（逐字节比较全部内容，耗时与
+  /// 第一个不同的位置无关）。
+  bool _accepts(Uint8List payload) {
+    final expected = _token!;
+    final actual = utf8.encode(decodeUsageQueryAuth(payload));
+    var diff = actual.length ^ expected.length;
+    for (var i = 0; i < expected.length; i++) {
+      diff |= expected[i] ^ (i < actual.length ? actual[i] : 0);
+    }
+    return diff == 0;
+  }
+
+  /// 为一批请求准备缓存；全部命中时返回 null。
+  Future<void>? _prepare(List<UsageQueryRequest> requests) {
+    List<Future<void>>? pending;
+    for (final request in requests) {
+      final future = cache.prepare(request);
+      if (future != null) (pending ??= []).add(future);
+    }
+    return pending == null ? null : Future.wait(pending);
+  }
+
+  /// 应答一批请求。回复超过帧长度上限时改为逐条回复 internalError，
+  /// 不让客户端一直等待。
+  Uint8List _answer(List<UsageQueryRequest> requests, Object? loadError) {
+    LiveStatus? liveStatus;
+    final responses = <UsageQueryResponse>[];
+    for (final request in requests) {
+      if (request.op == UsageQueryOp.liveStatus) {
+        liveStatus ??= _liveStatus();
+        responses.add(UsageQueryResponse.liveStatus(request.id, liveStatus));
+      } else if (loadError != null) {
+        responses.add(
+          UsageQueryResponse.error(
+            request.id,
+            request.op,
+            UsageQueryStatus.internalError,
+            '$loadError',
+          ),
+        );
+      } else {
+        responses.add(cache.answer(request));
+      }
+    }
+    try {
+      return encodeUsageQueryResponses(responses);
+    } on StateError catch (e) {
+      AppLogService.instance.logWarn(_logTag, 'response too large: $e');
+      return encodeUsageQueryResponses([
+        for (final request in requests)
+          UsageQueryResponse.error(
+            request.id,
+            request.op,
+            UsageQueryStatus.internalError,
+            'response too large',
+          ),
+      ]);
+    }
+  }
+}
+
+class _UsageQueryConnection {
+  _UsageQueryConnection(this._server, this._socket) {
+    _subscription = _socket.listen(
+      _onData,
+      onError: (Object e) => destroy(),
+      onDone: () {
+        // 客户端半关闭：回复完已排队的批次再断开。
+        _inputDone = true;
+        _pump();
+      },
+      cancelOnError: true,
+    );
+  }
+
+  final UsageQueryServer _server;
+  final Socket _socket;
+  late final StreamSubscription<Uint8List> _subscription;
+  final _decoder = UsageQueryFrameDecoder();
+  final _queue = Queue<List<UsageQueryRequest>>();
+  late bool _authenticated = _server._token == null;
+  bool _waiting = false;
+  bool _inputDone = false;
+  bool _closed = false;
+
+  void _onData(Uint8List chunk) {
+    try {
+      for (final payload in _decoder.add(chunk)) {
+        if (!_authenticated) {
+          if (!_server._accepts(payload)) {
+            throw const FormatException('bad token');
+          }
+          _authenticated = true;
+          continue;
+        }
+        _queue.add(decodeUsageQueryRequests(payload));
+      }
+    } on FormatException catch (e) {
+      AppLogService.instance.logWarn(
+        UsageQueryServer._logTag,
+        'malformed request, closing connection: ${e.message}',
+      );
+      destroy();
+      return;
+    }
+    _pump();
+  }
+
+  /// 按顺序处理排队的批次；遇到冷数据时暂停，加载完再继续。
+  ///
+  /// 在 socket 回调与加载完成回调中运行，异常不能逃出：记录后断开连接，
+  /// 否则该批次一直留在队列里，客户端永远等不到回复。
+  void _pump({Object? loadError}) {
+    try {
+      _pumpQueue(loadError);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        UsageQueryServer._logTag,
+        'answer failed, closing connection: $e\n$st',
+      );
+      destroy();
+    }
+  }
+
+  void _pumpQueue(Object? loadError) {
+    if (loadError != null) {
+      // 加载失败的批次逐条回复错误。
+      _socket.add(_server._answer(_queue.removeFirst(), loadError));
+    }
+    while (!_waiting && !_closed && _queue.isNotEmpty) {
+      final requests = _queue.first;
+      final pending = _server._prepare(requests);
+      if (pending != null) {
+        _waiting = true;
+        pending.then(
+          (_) => _resume(null),
+          onError: (Object e, StackTrace st) {
+            AppLogService.instance.logError(
+              UsageQueryServer._logTag,
+              'load failed: $e\n$st',
+            );
+            _resume(e);
+          },
+        );
+        return;
+      }
+      _queue.removeFirst();
+      _socket.add(_server._answer(requests, null));
+    }
+    if (_inputDone && !_waiting && !_closed && _queue.isEmpty) {
+      _closed = true;
+      _server._connections.remove(this);
+      unawaited(_socket.close());
+    }
+  }
+
+  void _resume(Object? loadError) {
+    _waiting = false;
+    if (_closed) return;
+    _pump(loadError: loadError);
+  }
+
+  void destroy() {
+    if (_closed) return;
+    _closed = true;
+    _queue.clear();
+    unawaited(_subscription.cancel());
+    _socket.destroy();
+    _server._connections.remove(this);
+  }
+}
@@ -0,0 +1,27 @@
+import 'dart:async';
+
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+/// 是否把按键活动计入 AFK 判定（只记录按键发生的时间，不记录内容）。
+class KeyboardActivityController extends AsyncNotifier<bool> {
+  static const _key = 'ringotrack.keyboardActivity';
+
+  @override
+  Future<bool> build() async {
+    final prefs = await SharedPreferences.getInstance();
+    return prefs.getBool(_key) ?? false;
+  }
+
+  Future<void> setEnabled(bool enabled) async {
+    if (state.value == enabled) return;
+    state = AsyncData(enabled);
+    final prefs = await SharedPreferences.getInstance();
+    await prefs.setBool(_key, enabled);
+  }
+}
+
+final keyboardActivityControllerProvider =
+    AsyncNotifierProvider<KeyboardActivityController, bool>(
+      KeyboardActivityController.new,
+    );
@@ -0,0 +1,27 @@
+import 'dart:async';
+
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+/// 是否在没有键鼠输入时采样前台软件的 CPU 占用，记录其「忙碌」时长。
+class ProcessActivityController extends AsyncNotifier<bool> {
+  static const _key = 'ringotrack.processActivity';
+
+  @override
+  Future<bool> build() async {
+    final prefs = await SharedPreferences.getInstance();
+    return prefs.getBool(_key) ?? false;
+  }
+
+  Future<void> setEnabled(bool enabled) async {
+    if (state.value == enabled) return;
+    state = AsyncData(enabled);
+    final prefs = await SharedPreferences.getInstance();
+    await prefs.setBool(_key, enabled);
+  }
+}
+
+final processActivityControllerProvider =
+    AsyncNotifierProvider<ProcessActivityController, bool>(
+      ProcessActivityController.new,
+    );
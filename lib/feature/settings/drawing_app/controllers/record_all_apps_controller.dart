@@ -0,0 +1,27 @@
+import 'dart:async';
+
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+/// 是否启用「全量记录」：记录所有前台应用，统计列表只在查询时生效。
+class RecordAllAppsController extends AsyncNotifier<bool> {
+  static const _key = 'ringotrack.recordAllApps';
+
+  @override
+  Future<bool> build() async {
+    final prefs = await SharedPreferences.getInstance();
+    return prefs.getBool(_key) ?? false;
+  }
+
+  Future<void> setEnabled(bool enabled) async {
+    if (state.value == enabled) return;
+    state = AsyncData(enabled);
+    final prefs = await SharedPreferences.getInstance();
+    await prefs.setBool(_key, enabled);
+  }
+}
+
+final recordAllAppsControllerProvider =
+    AsyncNotifierProvider<RecordAllAppsController, bool>(
+      RecordAllAppsController.new,
+    );
@@ -0,0 +1,27 @@
+import 'dart:async';
+
+import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:shared_preferences/shared_preferences.dart';
+
+/// 是否记录「可见但不在前台」的时长（例如副屏上的参考图窗口）。
+class SecondaryVisibleController extends AsyncNotifier<bool> {
+  static const _key = 'ringotrack.secondaryVisible';
+
+  @override
+  Future<bool> build() async {
+    final prefs = await SharedPreferences.getInstance();
+    return prefs.getBool(_key) ?? false;
+  }
+
+  Future<void> setEnabled(bool enabled) async {
+    if (state.value == enabled) return;
+    state = AsyncData(enabled);
+    final prefs = await SharedPreferences.getInstance();
+    await prefs.setBool(_key, enabled);
+  }
+}
+
+final secondaryVisibleControllerProvider =
+    AsyncNotifierProvider<SecondaryVisibleController, bool>(
+      SecondaryVisibleController.new,
+    );
@@ -236,14 +236,69 @@ class SharedPrefsDrawingAppPreferencesRepository
   }
 }
 
-/// 构造用于 UsageAggregator 的过滤闭包。
-bool Function(String appId) buildAppFilter(DrawingAppPreferences prefs) {
-  final trackedIds = <String>{};
-  for (final app in prefs.trackedApps) {
-    for (final id in app.ids) {
-      trackedIds.add(id.value.toLowerCase());
+/// 编译后的应用过滤器，构造后不可变；可直接当作 `bool Function(String)` 使用。
+///
+/// - 精确表：原样的 id，命中时无需任何字符串处理；
+/// - 折叠表：小写后的 id，用于大小写不同的 exe 名；
+/// - 通配表：含 `*` / `?` 的 id，预先编译为忽略大小写的正则。
+class AppMatcher {
+  AppMatcher._(this._exact, this._folded, this._globs);
+
+  factory AppMatcher.fromIds(Iterable<String> ids) {
+    final exact = <String>{};
+    final folded = <String>{};
+    final globs = <RegExp>[];
+    for (final id in ids) {
+      if (id.isEmpty) continue;
+      if (id.contains('*') || id.contains('?')) {
+        globs.add(_compileGlob(id));
+        continue;
+      }
+      exact.add(id);
+      folded.add(id.toLowerCase());
     }
+    return AppMatcher._(exact, folded, List.unmodifiable(globs));
   }
 
-  return (appId) => trackedIds.contains(appId.toLowerCase());
+  final Set<String> _exact;
+  final Set<String> _folded;
+  final List<RegExp> _globs;
+
+  /// 不含通配符的 id（小写），供 native 侧建立位图。
+  Iterable<String> get foldedIds => _folded;
+
+  /// 是否含通配符规则；此时无法展开为 id 列表。
+  bool get hasPatterns => _globs.isNotEmpty;
+
+  bool call(String appId) {
+    if (_exact.contains(appId)) return true;
+    if (_folded.contains(appId.toLowerCase())) return true;
+    for (final glob in _globs) {
+      if (glob.hasMatch(appId)) return true;
+    }
+    return false;
+  }
+
+  static RegExp _compileGlob(String pattern) {
+    final buffer = StringBuffer('^');
+    for (final char in pattern.split('')) {
+      switch (char) {
+        case '*':
+          buffer.write('.*');
+        case '?':
+          buffer.write('.');
+        default:
+          buffer.write(RegExp.escape(char));
+      }
+    }
+    buffer.write(r'$');
+    return RegExp(buffer.toString(), caseSensitive: false);
+  }
+}
+
+/// 构造用于 UsageAggregator 的过滤器；在偏好变化时调用一次，结果可长期复用。
+AppMatcher buildAppFilter(DrawingAppPreferences prefs) {
+  return AppMatcher.fromIds(
+    prefs.trackedApps.expand((app) => app.ids).map((id) => id.value),
+  );
 }
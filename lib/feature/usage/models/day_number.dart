@@ -0,0 +1,16 @@
+/// 本地日期 -> 日序号（1970-01-01 为 0）。
+///
+/// 日表 / 小时表的整数键、查询协议与仪表盘快照共用这一编号。
+int dayNumberOf(DateTime date) {
+  return DateTime.utc(date.year, date.month, date.day).millisecondsSinceEpoch ~/
+      Duration.millisecondsPerDay;
+}
+
+/// 日序号 -> 本地日期（已归一化到 00:00）。
+DateTime dateOfDayNumber(int dayNumber) {
+  final utc = DateTime.fromMillisecondsSinceEpoch(
+    dayNumber * Duration.millisecondsPerDay,
+    isUtc: true,
+  );
+  return DateTime(utc.year, utc.month, utc.day);
+}
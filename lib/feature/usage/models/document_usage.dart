@@ -0,0 +1,19 @@
+/// 按文档统计时使用的组合 key：`appId` + 分隔符 + 文档名。
+///
+/// 文档名来自窗口标题，不会包含控制字符 U+001F，拆分时取第一个分隔符即可。
+const documentUsageKeySeparator = '\u001f';
+
+String documentUsageKey(String appId, String document) =>
+    '$appId$documentUsageKeySeparator$document';
+
+/// 组合 key 中的 appId；不是组合 key（例如 Idle 占位）时返回原值。
+String appIdOfDocumentUsageKey(String key) {
+  final index = key.indexOf(documentUsageKeySeparator);
+  return index < 0 ? key : key.substring(0, index);
+}
+
+/// 组合 key 中的文档名；不是组合 key 时返回 null。
+String? documentOfUsageKey(String key) {
+  final index = key.indexOf(documentUsageKeySeparator);
+  return index < 0 ? null : key.substring(index + 1);
+}
@@ -0,0 +1,137 @@
+/// 一段绘画会话：同一应用的计时区间，间隔不超过合并阈值的视为同一段。
+class DrawingSession {
+  const DrawingSession({
+    required this.appId,
+    required this.start,
+    required this.end,
+    required this.active,
+  });
+
+  final String appId;
+  final DateTime start;
+  final DateTime end;
+
+  /// 实际计时的时长，不含被合并的间隔（Idle、切到其它应用等）。
+  final Duration active;
+
+  @override
+  bool operator ==(Object other) =>
+      other is DrawingSession &&
+      other.appId == appId &&
+      other.start == start &&
+      other.end == end &&
+      other.active == active;
+
+  @override
+  int get hashCode => Object.hash(appId, start, end, active);
+
+  @override
+  String toString() =>
+      'DrawingSession($appId, $start - $end, active=${active.inSeconds}s)';
+}
+
+/// 在线会话切分器：native `SessionSegmenter` 的 Dart 版本。
+///
+/// 输入聚合器结算出的计时区间，按应用维护进行中的会话；同一应用两个区间
+/// 之间的空档不超过 [mergeGap] 时合并，否则结束旧会话。每个区间 O(1)。
+class DrawingSessionSegmenter {
+  DrawingSessionSegmenter({required this.mergeGap});
+
+  final Duration mergeGap;
+
+  final Map<String, _OpenSession> _open = {};
+  final List<DrawingSession> _finished = [];
+
+  int get openSessions => _open.length;
+
+  /// 区间按结束时刻非递减的顺序到达；同一应用的区间不重叠。
+  void onInterval(String appId, DateTime start, DateTime end) {
+    if (!start.isBefore(end)) return;
+
+    final open = _open[appId];
+    if (open == null) {
+      _open[appId] = _OpenSession(start, end, end.difference(start));
+      return;
+    }
+    if (start.difference(open.end) <= mergeGap) {
+      if (end.isAfter(open.end)) open.end = end;
+      open.active += end.difference(start);
+      return;
+    }
+    _finished.add(open.toSession(appId));
+    _open[appId] = _OpenSession(start, end, end.difference(start));
+  }
+
+  /// 结束最后一个区间早于 `now - mergeGap` 的会话。
+  void expireBefore(DateTime now) {
+    _open.removeWhere((appId, open) {
+      if (now.difference(open.end) <= mergeGap) return false;
+      _finished.add(open.toSession(appId));
+      return true;
+    });
+  }
+
+  /// 结束所有进行中的会话（例如退出时）。
+  void closeAll() {
+    _open.forEach((appId, open) => _finished.add(open.toSession(appId)));
+    _open.clear();
+  }
+
+  /// 取出已结束的会话并清空。
+  List<DrawingSession> drain() {
+    final sessions = List.of(_finished);
+    _finished.clear();
+    return sessions;
+  }
+}
+
+class _OpenSession {
+  _OpenSession(this.start, this.end, this.active);
+
+  final DateTime start;
+  DateTime end;
+  Duration active;
+
+  DrawingSession toSession(String appId) =>
+      DrawingSession(appId: appId, start: start, end: end, active: active);
+}
+
+/// 某一天的会话统计。
+class DailySessionStats {
+  const DailySessionStats({
+    required this.count,
+    required this.total,
+    required this.longest,
+  });
+
+  final int count;
+
+  /// 各会话活跃时长之和。
+  final Duration total;
+  final Duration longest;
+
+  Duration get average => count == 0 ? Duration.zero : total ~/ count;
+}
+
+/// 按会话开始时刻所在的本地日期汇总次数与时长。
+Map<DateTime, DailySessionStats> summarizeSessionsByDay(
+  Iterable<DrawingSession> sessions,
+) {
+  final result = <DateTime, DailySessionStats>{};
+  for (final session in sessions) {
+    final day = DateTime(
+      session.start.year,
+      session.start.month,
+      session.start.day,
+    );
+    final previous = result[day];
+    result[day] = DailySessionStats(
+      count: (previous?.count ?? 0) + 1,
+      total: (previous?.total ?? Duration.zero) + session.active,
+      longest: previous != null && previous.longest >= session.active
+          ? previous.longest
+          : session.active,
+    );
+  }
+  return result;
+}
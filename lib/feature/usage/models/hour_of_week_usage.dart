@@ -0,0 +1,83 @@
+import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+
+/// 一周 168 个小时格子（7 天 × 24 小时）上的累计时长，按应用分组。
+///
+/// 格子固定以「周一 0 点」为 0（与数据库中的 weekly_hour_usage 相同），
+/// 周起始日只在 [punchcard] 中按 [WeekStartMode] 旋转。
+class HourOfWeekUsage {
+  const HourOfWeekUsage(this.secondsByApp);
+
+  static const cellCount = 7 * 24;
+
+  /// appId -> 长度为 [cellCount] 的秒数列表。
+  final Map<String, List<int>> secondsByApp;
+
+  /// 周一=0 … 周日=6。
+  static int cellOf(int mondayBasedWeekday, int hour) =>
+      mondayBasedWeekday * 24 + hour;
+
+  /// 逐行折叠小时级明细得到的结果，作为参考实现与兜底。
+  factory HourOfWeekUsage.fold(
+    Map<DateTime, Map<int, Map<String, Duration>>> usageByDateHour,
+  ) {
+    final secondsByApp = <String, List<int>>{};
+    usageByDateHour.forEach((day, perHour) {
+      final weekday = day.weekday - 1;
+      perHour.forEach((hour, perApp) {
+        perApp.forEach((appId, duration) {
+          final cells = secondsByApp.putIfAbsent(
+            appId,
+            () => List.filled(cellCount, 0),
+          );
+          cells[cellOf(weekday, hour)] += duration.inSeconds;
+        });
+      });
+    });
+    return HourOfWeekUsage(secondsByApp);
+  }
+
+  /// 7 × 24 打卡图，第一行是 [weekStart] 对应的那一天；[include] 为空时
+  /// 统计所有应用。
+  List<List<Duration>> punchcard(
+    WeekStartMode weekStart, {
+    bool Function(String appId)? include,
+  }) {
+    final totals = List.filled(cellCount, 0);
+    secondsByApp.forEach((appId, cells) {
+      if (include != null && !include(appId)) return;
+      for (var i = 0; i < cellCount; i++) {
+        totals[i] += cells[i];
+      }
+    });
+    final firstWeekday = weekStart == WeekStartMode.monday ? 0 : 6;
+    return List.generate(7, (row) {
+      final weekday = (firstWeekday + row) % 7;
+      return List.generate(
+        24,
+        (hour) => Duration(seconds: totals[cellOf(weekday, hour)]),
+        growable: false,
+      );
+    }, growable: false);
+  }
+
+  /// [appId] 在一天 24 个小时上的分布（一周七天合并）。
+  List<Duration> hourOfDay(String appId) {
+    final cells = secondsByApp[appId];
+    return List.generate(24, (hour) {
+      if (cells == null) return Duration.zero;
+      var seconds = 0;
+      for (var weekday = 0; weekday < 7; weekday++) {
+        seconds += cells[cellOf(weekday, hour)];
+      }
+      return Duration(seconds: seconds);
+    }, growable: false);
+  }
+
+  /// 只保留 [include] 接受的应用。
+  HourOfWeekUsage where(bool Function(String appId) include) {
+    return HourOfWeekUsage({
+      for (final entry in secondsByApp.entries)
+        if (include(entry.key)) entry.key: entry.value,
+    });
+  }
+}
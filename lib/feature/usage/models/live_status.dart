@@ -0,0 +1,37 @@
+/// 「当前在画什么、今天画了多久」的实时状态。
+class LiveStatus {
+  const LiveStatus({
+    required this.appId,
+    required this.sessionStart,
+    required this.todayTotal,
+    required this.isIdle,
+    required this.isTracking,
+  });
+
+  /// 当前前台应用；未知时为 null。
+  final String? appId;
+
+  /// 当前连续使用区间的开始时间；前台不是绘画软件或处于 AFK 时为 null。
+  final DateTime? sessionStart;
+
+  /// 今日累计使用时长（已量化到整秒）。
+  final Duration todayTotal;
+
+  final bool isIdle;
+
+  /// 当前前台应用是否在统计列表里。
+  final bool isTracking;
+
+  @override
+  bool operator ==(Object other) =>
+      other is LiveStatus &&
+      other.appId == appId &&
+      other.sessionStart == sessionStart &&
+      other.todayTotal == todayTotal &&
+      other.isIdle == isIdle &&
+      other.isTracking == isTracking;
+
+  @override
+  int get hashCode =>
+      Object.hash(appId, sessionStart, todayTotal, isIdle, isTracking);
+}
@@ -17,10 +17,17 @@ class DailyUsage {
 }
 
 class ForegroundAppEvent {
-  ForegroundAppEvent({required this.appId, required this.timestamp});
+  ForegroundAppEvent({
+    required this.appId,
+    required this.timestamp,
+    this.document,
+  });
 
   final String appId;
   final DateTime timestamp;
+
+  /// 从窗口标题中提取出的文档 / 工程名；平台不支持或没有匹配规则时为 null。
+  final String? document;
 }
 
 class UsageAggregator {
@@ -91,10 +98,13 @@ class UsageAggregator {
 
 /// 小时级聚合器：将前台应用区间拆分为「日 + 小时 + App」的用时。
 class HourlyUsageAggregator {
-  HourlyUsageAggregator({required this.isDrawingApp});
+  HourlyUsageAggregator({required this.isDrawingApp, this.onInterval});
 
   final bool Function(String appId) isDrawingApp;
 
+  /// 可选：通过过滤的每个区间（切分到小时之前）的回调，供会话切分使用。
+  final void Function(String appId, DateTime start, DateTime end)? onInterval;
+
   final Map<DateTime, Map<int, Map<String, Duration>>> _usage = {};
 
   String? _currentAppId;
@@ -141,31 +151,42 @@ class HourlyUsageAggregator {
     if (!start.isBefore(end)) {
       return;
     }
+    onInterval?.call(appId, start, end);
+    addIntervalByHour(_usage, appId, start, end);
+  }
+}
 
-    var cursor = start;
-    while (cursor.isBefore(end)) {
-      final nextHourStart = DateTime(
-        cursor.year,
-        cursor.month,
-        cursor.day,
-        cursor.hour,
-      ).add(const Duration(hours: 1));
-
-      final segmentEnd = end.isBefore(nextHourStart) ? end : nextHourStart;
-      final segmentDuration = segmentEnd.difference(cursor);
-
-      final dayKey = DateTime(cursor.year, cursor.month, cursor.day);
-      final hourIndex = cursor.hour;
-
-      final perHour = _usage.putIfAbsent(
-        dayKey,
-        () => <int, Map<String, Duration>>{},
-      );
-      final perApp = perHour.putIfAbsent(hourIndex, () => <String, Duration>{});
-
-      perApp[appId] = (perApp[appId] ?? Duration.zero) + segmentDuration;
-
-      cursor = segmentEnd;
-    }
+/// 把 [appId] 在 `[start, end)` 内的时长按本地小时切分，累加到 [usage]
+/// （日期 -> 小时 -> App）；跨小时、跨午夜的区间分别计入各自的桶。
+void addIntervalByHour(
+  Map<DateTime, Map<int, Map<String, Duration>>> usage,
+  String appId,
+  DateTime start,
+  DateTime end,
+) {
+  var cursor = start;
+  while (cursor.isBefore(end)) {
+    final nextHourStart = DateTime(
+      cursor.year,
+      cursor.month,
+      cursor.day,
+      cursor.hour,
+    ).add(const Duration(hours: 1));
+
+    final segmentEnd = end.isBefore(nextHourStart) ? end : nextHourStart;
+    final segmentDuration = segmentEnd.difference(cursor);
+
+    final dayKey = DateTime(cursor.year, cursor.month, cursor.day);
+    final hourIndex = cursor.hour;
+
+    final perHour = usage.putIfAbsent(
+      dayKey,
+      () => <int, Map<String, Duration>>{},
+    );
+    final perApp = perHour.putIfAbsent(hourIndex, () => <String, Duration>{});
+
+    perApp[appId] = (perApp[appId] ?? Duration.zero) + segmentDuration;
+
+    cursor = segmentEnd;
   }
 }
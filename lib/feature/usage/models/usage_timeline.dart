@@ -0,0 +1,144 @@
+import 'dart:collection';
+
+/// 日级用时的不可变版本：「日期 -> AppId -> 时长」，按 年 -> 月 -> 日 分三层存放。
+///
+/// [withDelta] 合并一次增量时只复制受影响的路径（年索引、该年的 12 个月槽、
+/// 该月的 31 个日槽，以及被修改的那几天的应用表），其余节点与旧版本共享。
+/// 因此 UI 侧每秒合并增量后可以直接产出新版本，不必深拷贝整段区间。
+///
+/// 对外表现为只读的 `Map<DateTime, Map<String, Duration>>`，key 为本地
+/// 00:00 的日期；返回的每日应用表同样不可修改。
+class UsageTimeline
+    extends UnmodifiableMapBase<DateTime, Map<String, Duration>> {
+  UsageTimeline._(this._years, this.length, this.version);
+
+  UsageTimeline.empty() : this._(const {}, 0, 0);
+
+  /// 以 [usage] 构建初始版本；会复制每天的应用表，之后修改 [usage] 不影响本对象。
+  factory UsageTimeline.from(Map<DateTime, Map<String, Duration>> usage) {
+    if (usage is UsageTimeline) return usage;
+    return UsageTimeline.empty().withDelta(usage);
+  }
+
+  static const _monthsPerYear = 12;
+  static const _daysPerMonth = 31;
+
+  /// 年 -> 12 个月槽 -> 31 个日槽；空槽为 null。发布后不再修改。
+  final Map<int, List<List<Map<String, Duration>?>?>> _years;
+
+  @override
+  final int length;
+
+  /// 版本号，每次产生变化的 [withDelta] 加一。
+  final int version;
+
+  @override
+  bool get isEmpty => length == 0;
+
+  @override
+  bool get isNotEmpty => length != 0;
+
+  @override
+  Map<String, Duration>? operator [](Object? key) {
+    if (key is! DateTime || !_isNormalized(key)) return null;
+    return _years[key.year]?[key.month - 1]?[key.day - 1];
+  }
+
+  @override
+  bool containsKey(Object? key) => this[key] != null;
+
+  @override
+  Iterable<DateTime> get keys sync* {
+    final years = _years.keys.toList()..sort();
+    for (final year in years) {
+      final months = _years[year]!;
+      for (var m = 0; m < _monthsPerYear; m++) {
+        final days = months[m];
+        if (days == null) continue;
+        for (var d = 0; d < _daysPerMonth; d++) {
+          if (days[d] != null) yield DateTime(year, m + 1, d + 1);
+        }
+      }
+    }
+  }
+
+  /// 把 [delta] 累加到当前版本上，返回新版本；只处理 [start, end] 内
+  /// （含两端，未指定则不限）的日期。没有任何变化时返回自身。
+  UsageTimeline withDelta(
+    Map<DateTime, Map<String, Duration>> delta, {
+    DateTime? start,
+    DateTime? end,
+  }) {
+    final copiedYears = <int, List<List<Map<String, Duration>?>?>>{};
+    final copiedMonths = <int, List<Map<String, Duration>?>>{};
+    var added = 0;
+
+    delta.forEach((date, perApp) {
+      if (perApp.isEmpty) return;
+      final day = DateTime(date.year, date.month, date.day);
+      if (start != null && day.isBefore(start)) return;
+      if (end != null && day.isAfter(end)) return;
+
+      final months = copiedYears.putIfAbsent(day.year, () {
+        final existing = _years[day.year];
+        return existing == null
+            ? List<List<Map<String, Duration>?>?>.filled(_monthsPerYear, null)
+            : List.of(existing, growable: false);
+      });
+      final monthKey = day.year * _monthsPerYear + day.month - 1;
+      final days = copiedMonths.putIfAbsent(monthKey, () {
+        final existing = months[day.month - 1];
+        final copy = existing == null
+            ? List<Map<String, Duration>?>.filled(_daysPerMonth, null)
+            : List.of(existing, growable: false);
+        months[day.month - 1] = copy;
+        return copy;
+      });
+
+      final previous = days[day.day - 1];
+      final merged = <String, Duration>{...?previous};
+      perApp.forEach((appId, duration) {
+        merged[appId] = (merged[appId] ?? Duration.zero) + duration;
+      });
+      if (previous == null) added++;
+      days[day.day - 1] = UnmodifiableMapView(merged);
+    });
+
+    if (copiedYears.isEmpty) return this;
+    return UsageTimeline._(
+      {..._years, ...copiedYears},
+      length + added,
+      version + 1,
+    );
+  }
+
+  static bool _isNormalized(DateTime date) {
+    return !date.isUtc &&
+        date.hour == 0 &&
+        date.minute == 0 &&
+        date.second == 0 &&
+        date.millisecond == 0 &&
+        date.microsecond == 0;
+  }
+}
+
+/// 单日「小时 -> AppId -> 时长」的不可变合并：返回新的只读映射，
+/// 未被 [delta] 触及的小时与 [base] 共享同一张应用表。
+///
+/// 以空表为 [base] 调用即可把一份可变数据转换为只读的初始版本。
+Map<int, Map<String, Duration>> mergeHourlyDelta(
+  Map<int, Map<String, Duration>> base,
+  Map<int, Map<String, Duration>> delta,
+) {
+  if (delta.isEmpty) return base;
+  final next = Map.of(base);
+  delta.forEach((hour, perApp) {
+    if (perApp.isEmpty) return;
+    final merged = <String, Duration>{...?base[hour]};
+    perApp.forEach((appId, duration) {
+      merged[appId] = (merged[appId] ?? Duration.zero) + duration;
+    });
+    next[hour] = UnmodifiableMapView(merged);
+  });
+  return UnmodifiableMapView(next);
+}
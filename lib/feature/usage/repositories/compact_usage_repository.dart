@@ -0,0 +1,166 @@
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/compact_usage_store.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+
+/// 「全量记录」模式的仓库：写入时记录所有前台应用，读取时才按
+/// [trackedFilter] 过滤，因此之后新加入统计的应用也能看到历史时长。
+///
+/// 统计中的应用仍会同时写入旧版日表 / 小时表（按写入时的过滤器），
+/// 关闭该模式后可以无缝回到 [SqliteUsageRepository]。
+class CompactUsageRepository
+    implements
+        UsageRepository,
+        DocumentUsageRepository,
+        SecondaryUsageRepository,
+        BusyUsageRepository,
+        SessionUsageRepository,
+        HourOfWeekUsageRepository {
+  CompactUsageRepository(this._db, {required this.trackedFilter})
+    : _store = CompactUsageStore(_db);
+
+  final AppDatabase _db;
+  final CompactUsageStore _store;
+
+  /// 返回当前生效的统计应用过滤器；每次查询时读取，过滤器变化无需重建仓库。
+  final bool Function(String appId) Function() trackedFilter;
+
+  // 首次使用前把旧版小时表中的历史导入紧凑存储。
+  late final Future<void> _ready = _store.importLegacyHourly();
+
+  @override
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    await _ready;
+    final bitmap = await _store.bitmapFor(trackedFilter());
+    return _store.loadDailyRange(start, end, bitmap);
+  }
+
+  @override
+  Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {
+    // 日级增量由服务按过滤器生成，只用于保持旧版日表完整；
+    // 紧凑存储的日级数据由小时表汇总得到。
+    await _ready;
+    await _db.mergeUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    await _ready;
+    final bitmap = await _store.bitmapFor(trackedFilter());
+    return _store.loadHourlyRange(start, end, bitmap);
+  }
+
+  @override
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {
+    await _ready;
+    await _store.mergeHourly(delta);
+
+    final filter = trackedFilter();
+    final tracked = <DateTime, Map<int, Map<String, Duration>>>{};
+    delta.forEach((day, perHour) {
+      perHour.forEach((hour, perApp) {
+        final kept = {
+          for (final entry in perApp.entries)
+            if (filter(entry.key)) entry.key: entry.value,
+        };
+        if (kept.isNotEmpty) {
+          tracked.putIfAbsent(day, () => {})[hour] = kept;
+        }
+      });
+    });
+    await _db.mergeHourlyUsage(tracked);
+  }
+
+  @override
+  Future<void> mergeHourlyDocumentUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlyDocumentUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlyDocumentRange(DateTime start, DateTime end) {
+    return _db.loadHourlyDocumentRange(start, end);
+  }
+
+  @override
+  Future<void> mergeHourlySecondaryUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlySecondaryUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlySecondaryRange(DateTime start, DateTime end) {
+    return _db.loadHourlySecondaryRange(start, end);
+  }
+
+  @override
+  Future<void> mergeHourlyBusyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlyBusyUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyBusyRange(
+    DateTime start,
+    DateTime end,
+  ) {
+    return _db.loadHourlyBusyRange(start, end);
+  }
+
+  @override
+  Future<void> insertSessions(List<DrawingSession> sessions) {
+    return _db.insertSessions(sessions);
+  }
+
+  @override
+  Future<List<DrawingSession>> loadSessions(DateTime start, DateTime end) {
+    return _db.loadSessions(start, end);
+  }
+
+  /// 聚合来自小时表，只含写入时在追踪列表中的应用；这里再按当前过滤器
+  /// 过滤，与其它查询保持一致。
+  @override
+  Future<HourOfWeekUsage> loadHourOfWeekUsage(
+    int firstYear,
+    int lastYear,
+  ) async {
+    await _ready;
+    final usage = await _db.loadHourOfWeekUsage(firstYear, lastYear);
+    return usage.where(trackedFilter());
+  }
+
+  @override
+  Future<void> deleteByAppId(String appId) async {
+    await _ready;
+    await _db.deleteByAppId(appId);
+    await _store.deleteByAppId(appId);
+  }
+
+  @override
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {
+    await _ready;
+    await _db.deleteByDateRange(start, end);
+    await _store.deleteByDateRange(start, end);
+  }
+
+  @override
+  Future<void> clearAll() async {
+    await _ready;
+    await _db.clearAll();
+    await _store.clearAll();
+  }
+}
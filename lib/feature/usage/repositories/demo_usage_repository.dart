@@ -4,8 +4,10 @@ import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
 
 /// 用于调试截图的内存示例数据仓库。
 class DemoUsageRepository implements UsageRepository {
-  DemoUsageRepository({DateTime? now})
-    : _referenceDate = _normalizeDay(now ?? DateTime.now()) {
+  /// [seed] 固定时生成的示例数据可复现；默认按当前时间取随机种子。
+  DemoUsageRepository({DateTime? now, int? seed})
+    : _referenceDate = _normalizeDay(now ?? DateTime.now()),
+      _random = Random(seed ?? DateTime.now().millisecondsSinceEpoch) {
     _generateDemoData();
   }
 
@@ -20,7 +22,7 @@ class DemoUsageRepository implements UsageRepository {
 
   static const int _historyDays = 365;
   final DateTime _referenceDate;
-  final Random _random = Random(DateTime.now().millisecondsSinceEpoch);
+  final Random _random;
   final Map<DateTime, Map<String, Duration>> _dailyUsage = {};
   final Map<DateTime, Map<int, Map<String, Duration>>> _hourlyUsage = {};
   final Map<DateTime, Map<int, int>> _hourlyOccupancy = {};
@@ -1,4 +1,6 @@
 import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
 
 /// UsageRepository 抽象，后续如果需要可以有内存版 / SQLite 版等多种实现。
 abstract class UsageRepository {
@@ -31,7 +33,65 @@ abstract class UsageRepository {
   Future<void> clearAll();
 }
 
-class SqliteUsageRepository implements UsageRepository {
+/// 按文档（画布 / 工程）统计的小时级用量。
+///
+/// 与 [UsageRepository] 分开：只有能从窗口标题提取文档名的平台才会写入，
+/// 内层 key 为 `documentUsageKey(appId, document)` 组合 key。
+abstract class DocumentUsageRepository {
+  Future<void> mergeHourlyDocumentUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  );
+
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlyDocumentRange(DateTime start, DateTime end);
+}
+
+/// 「可见但不在前台」的小时级用量，例如前台在主屏作画时副屏上开着的
+/// 参考图窗口。单独存放，不计入 [UsageRepository] 的前台合计。
+abstract class SecondaryUsageRepository {
+  Future<void> mergeHourlySecondaryUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  );
+
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlySecondaryRange(DateTime start, DateTime end);
+}
+
+/// Idle 期间前台统计中应用仍在占用 CPU（滤镜、导出、渲染）的小时级时长。
+/// 与 [SecondaryUsageRepository] 一样单独存放，不计入前台合计。
+abstract class BusyUsageRepository {
+  Future<void> mergeHourlyBusyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  );
+
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyBusyRange(
+    DateTime start,
+    DateTime end,
+  );
+}
+
+/// 已结束的绘画会话，见 [DrawingSessionSegmenter]。
+abstract class SessionUsageRepository {
+  Future<void> insertSessions(List<DrawingSession> sessions);
+
+  /// 开始时刻落在 [start, end) 内的会话，按开始时刻升序。
+  Future<List<DrawingSession>> loadSessions(DateTime start, DateTime end);
+}
+
+/// 「年 + 应用 + 周内小时」聚合，见 [HourOfWeekUsage]。
+abstract class HourOfWeekUsageRepository {
+  /// [firstYear]..[lastYear]（含）内各应用的周内小时分布。
+  Future<HourOfWeekUsage> loadHourOfWeekUsage(int firstYear, int lastYear);
+}
+
+class SqliteUsageRepository
+    implements
+        UsageRepository,
+        DocumentUsageRepository,
+        SecondaryUsageRepository,
+        BusyUsageRepository,
+        SessionUsageRepository,
+        HourOfWeekUsageRepository {
   SqliteUsageRepository(this._db);
 
   final AppDatabase _db;
@@ -64,6 +124,62 @@ class SqliteUsageRepository implements UsageRepository {
     return _db.mergeHourlyUsage(delta);
   }
 
+  @override
+  Future<void> mergeHourlyDocumentUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlyDocumentUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlyDocumentRange(DateTime start, DateTime end) {
+    return _db.loadHourlyDocumentRange(start, end);
+  }
+
+  @override
+  Future<void> mergeHourlySecondaryUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlySecondaryUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>>
+  loadHourlySecondaryRange(DateTime start, DateTime end) {
+    return _db.loadHourlySecondaryRange(start, end);
+  }
+
+  @override
+  Future<void> mergeHourlyBusyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    return _db.mergeHourlyBusyUsage(delta);
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyBusyRange(
+    DateTime start,
+    DateTime end,
+  ) {
+    return _db.loadHourlyBusyRange(start, end);
+  }
+
+  @override
+  Future<void> insertSessions(List<DrawingSession> sessions) {
+    return _db.insertSessions(sessions);
+  }
+
+  @override
+  Future<List<DrawingSession>> loadSessions(DateTime start, DateTime end) {
+    return _db.loadSessions(start, end);
+  }
+
+  @override
+  Future<HourOfWeekUsage> loadHourOfWeekUsage(int firstYear, int lastYear) {
+    return _db.loadHourOfWeekUsage(firstYear, lastYear);
+  }
+
   @override
   Future<void> deleteByAppId(String appId) {
     return _db.deleteByAppId(appId);
@@ -0,0 +1,203 @@
+import 'dart:math';
+
+/// 可复现的大规模合成使用数据，用于基准测试与压力测试。
+///
+/// 同一组参数（[seed]、[years]、[appCount]、[lastDay]）总是生成完全相同的
+/// 数据。模式尽量贴近真实记录：
+/// - 应用热度近似 Zipf 分布，少数应用占据大部分时间；
+/// - 工作日集中在晚间，周末从午后开始、总时长更长；
+/// - 每年有两段假期，另有零星休息日；
+/// - 单个小时桶不超过 3600 秒。
+///
+/// 按天逐条生成，不在内存中保留整段历史，可直接交给
+/// `AppDatabase.bulkLoadUsage` 批量写入。
+class SyntheticUsageGenerator {
+  SyntheticUsageGenerator({
+    this.seed = 42,
+    this.years = 3,
+    this.appCount = 50,
+    DateTime? lastDay,
+  }) : assert(years > 0 && appCount > 0),
+       // 默认终点固定，保证不同日期运行的基准使用同一份数据。
+       lastDay = _normalizeDay(lastDay ?? DateTime(2025, 12, 31));
+
+  final int seed;
+  final int years;
+  final int appCount;
+  final DateTime lastDay;
+
+  /// 头部使用真实的绘画软件 AppId，其余为编号应用。
+  static const _knownAppIds = [
+    'photoshop.exe',
+    'clip_studio_paint.exe',
+    'sai2.exe',
+    'krita.exe',
+    'blender.exe',
+    'illustrator.exe',
+  ];
+
+  /// 各小时的相对活跃度（0 点 ~ 23 点）。
+  static const _weekdayProfile = [
+    0.5, 0.3, 0.1, 0.0, 0.0, 0.0, 0.0, 0.0, 0.05, 0.1, 0.1, 0.1, // 0~11
+    0.3, 0.2, 0.1, 0.1, 0.1, 0.2, 0.3, 0.7, 1.0, 1.0, 0.9, 0.7,
+  ];
+  static const _weekendProfile = [
+    0.6, 0.4, 0.2, 0.05, 0.0, 0.0, 0.0, 0.0, 0.0, 0.1, 0.4, 0.5, // 0~11
+    0.4, 0.7, 0.9, 1.0, 0.9, 0.7, 0.5, 0.7, 0.9, 1.0, 0.8, 0.7,
+  ];
+
+  DateTime get firstDay =>
+      DateTime(lastDay.year - years, lastDay.month, lastDay.day + 1);
+
+  /// 按热度从高到低排列的全部 AppId。
+  List<String> get appIds => [
+    for (var i = 0; i < appCount; i++)
+      i < _knownAppIds.length ? _knownAppIds[i] : 'synthetic_app_$i.exe',
+  ];
+
+  /// 从 [firstDay] 到 [lastDay] 逐日生成「小时 -> AppId -> 时长」；
+  /// 没有记录的日子不产出。
+  Iterable<MapEntry<DateTime, Map<int, Map<String, Duration>>>> days() sync* {
+    final random = Random(seed);
+    final apps = appIds;
+    final cumulative = _zipfCumulative(apps.length);
+    final vacations = <DateTime>{};
+    final first = firstDay;
+
+    for (var offset = 0; ; offset++) {
+      final day = DateTime(first.year, first.month, first.day + offset);
+      if (day.isAfter(lastDay)) return;
+
+      // 每年第一天排好两段 5~14 天的假期。
+      if (offset == 0 || (day.month == 1 && day.day == 1)) {
+        for (var i = 0; i < 2; i++) {
+          final start = random.nextInt(365);
+          final length = 5 + random.nextInt(10);
+          for (var d = 0; d < length; d++) {
+            vacations.add(DateTime(day.year, 1, 1 + start + d));
+          }
+        }
+      }
+      if (vacations.remove(day)) continue;
+
+      final weekend = day.weekday >= DateTime.saturday;
+      if (random.nextDouble() < (weekend ? 0.05 : 0.1)) continue;
+
+      // 对数正态的当日总时长：工作日中位约 2.5 小时，周末约 5 小时。
+      final median = weekend ? 300.0 : 150.0;
+      final minutes = (median * exp(0.5 * _gaussian(random))).clamp(20, 900);
+      final appsToday = (weekend ? 2 : 1) + random.nextInt(3);
+      final hourly = _spreadOverHours(
+        random,
+        (minutes * 60).round(),
+        weekend ? _weekendProfile : _weekdayProfile,
+        _pickApps(random, apps, cumulative, appsToday),
+      );
+      if (hourly.isNotEmpty) yield MapEntry(day, hourly);
+    }
+  }
+
+  /// 把小时级数据汇总为日级。
+  static Map<String, Duration> dailyOf(
+    Map<int, Map<String, Duration>> hourly,
+  ) {
+    final perApp = <String, Duration>{};
+    for (final apps in hourly.values) {
+      apps.forEach((appId, duration) {
+        perApp[appId] = (perApp[appId] ?? Duration.zero) + duration;
+      });
+    }
+    return perApp;
+  }
+
+  Map<int, Map<String, Duration>> _spreadOverHours(
+    Random random,
+    int totalSeconds,
+    List<double> profile,
+    List<String> apps,
+  ) {
+    final weights = [
+      for (final base in profile) base * (0.6 + 0.8 * random.nextDouble()),
+    ];
+    final weightSum = weights.fold<double>(0, (a, b) => a + b);
+    // 当天第一个应用是「主力」，其余应用各自的份额更小。
+    final affinity = [
+      for (var i = 0; i < apps.length; i++)
+        (i == 0 ? 3.0 : 1.0) * (0.5 + random.nextDouble()),
+    ];
+
+    final hourly = <int, Map<String, Duration>>{};
+    for (var hour = 0; hour < 24; hour++) {
+      final seconds = min(
+        3600,
+        (totalSeconds * weights[hour] / weightSum).round(),
+      );
+      if (seconds < 60) continue;
+
+      // 每小时只切换到一两个应用。
+      final inHour = apps.length == 1 || random.nextDouble() < 0.6
+          ? [random.nextInt(apps.length)]
+          : [0, 1 + random.nextInt(apps.length - 1)];
+      final share = inHour.fold<double>(0, (sum, i) => sum + affinity[i]);
+      var remaining = seconds;
+      final perApp = <String, Duration>{};
+      for (var k = 0; k < inHour.length; k++) {
+        final i = inHour[k];
+        final part = k == inHour.length - 1
+            ? remaining
+            : (seconds * affinity[i] / share).round();
+        remaining -= part;
+        if (part > 0) perApp[apps[i]] = Duration(seconds: part);
+      }
+      hourly[hour] = perApp;
+    }
+    return hourly;
+  }
+
+  List<String> _pickApps(
+    Random random,
+    List<String> apps,
+    List<double> cumulative,
+    int count,
+  ) {
+    final picked = <String>[];
+    for (
+      var attempt = 0;
+      picked.length < count && attempt < count * 8;
+      attempt++
+    ) {
+      final target = random.nextDouble() * cumulative.last;
+      var lo = 0;
+      var hi = cumulative.length - 1;
+      while (lo < hi) {
+        final mid = (lo + hi) >> 1;
+        if (cumulative[mid] < target) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      if (!picked.contains(apps[lo])) picked.add(apps[lo]);
+    }
+    return picked;
+  }
+
+  static List<double> _zipfCumulative(int n) {
+    final cumulative = List<double>.filled(n, 0);
+    var sum = 0.0;
+    for (var i = 0; i < n; i++) {
+      sum += 1 / pow(i + 1, 1.1);
+      cumulative[i] = sum;
+    }
+    return cumulative;
+  }
+
+  /// Box-Muller 标准正态。
+  static double _gaussian(Random random) {
+    final u = 1 - random.nextDouble();
+    return sqrt(-2 * log(u)) * cos(2 * pi * random.nextDouble());
+  }
+
+  static DateTime _normalizeDay(DateTime value) =>
+      DateTime(value.year, value.month, value.day);
+}
@@ -1,3 +1,7 @@
+import 'dart:typed_data';
+
+import 'package:ringotrack/feature/usage/models/day_number.dart';
+
 /// 提供给「分析页」用的数据聚合工具。
 ///
 /// 输入是「按天 + app」的时长字典，输出常见的分析维度：
@@ -5,113 +9,273 @@
 /// - 周总时长（周一作为一周起点）
 /// - 按 App 的总时长
 /// - 按星期的平均时长
+///
+/// 首次查询时把字典转换为 [UsageColumns]（每个 app 一列按日序号排列的
+/// 微秒数），之后所有聚合都是对整数列的线性扫描；同一快照上的多次查询
+/// 共用这份列数据。需要多个维度时优先用 [summarize]，只扫描一遍。
 class UsageAnalysis {
   UsageAnalysis(this._usageByDate);
 
   final Map<DateTime, Map<String, Duration>> _usageByDate;
 
+  late final UsageColumns _columns = UsageColumns.fromUsage(_usageByDate);
+
   /// 按日期返回总时长，缺失日期会补零。
   List<DailyTotal> dailyTotals(DateTime start, DateTime end) {
-    final normalizedStart = _normalizeDay(start);
-    final normalizedEnd = _normalizeDay(end);
-    final days = _daysInRange(normalizedStart, normalizedEnd);
-
-    return days
-        .map((day) {
-          final perApp = _usageByDate[_normalizeDay(day)] ?? const {};
-          final total = perApp.values.fold(Duration.zero, (acc, d) => acc + d);
-          return DailyTotal(date: day, total: total, perApp: Map.of(perApp));
-        })
-        .toList(growable: false);
+    return _scan(start, end, null, daily: true).daily;
   }
 
   /// 按周（周一起点）汇总时长。
   List<WeeklyTotal> weeklyTotals(DateTime start, DateTime end) {
-    final normalizedStart = _normalizeDay(start);
-    final normalizedEnd = _normalizeDay(end);
-    final days = _daysInRange(normalizedStart, normalizedEnd);
-
-    final buckets = <DateTime, Map<String, Duration>>{};
-
-    for (final day in days) {
-      final weekStart = _weekStart(day);
-      final perApp = _usageByDate[_normalizeDay(day)];
-      if (perApp == null) {
-        // 没有数据也要确保周 bucket 存在，便于后续填零
-        buckets.putIfAbsent(weekStart, () => {});
-        continue;
-      }
-
-      final bucket = buckets.putIfAbsent(weekStart, () => {});
-      perApp.forEach((appId, duration) {
-        bucket[appId] = (bucket[appId] ?? Duration.zero) + duration;
-      });
-    }
-
-    final sortedWeekStarts = buckets.keys.toList()
-      ..sort((a, b) => a.compareTo(b));
-
-    return sortedWeekStarts
-        .map((weekStart) {
-          final perApp = buckets[weekStart] ?? const {};
-          final total = perApp.values.fold(Duration.zero, (acc, d) => acc + d);
-          return WeeklyTotal(
-            weekStart: weekStart,
-            total: total,
-            perApp: Map.of(perApp),
-          );
-        })
-        .toList(growable: false);
+    return _scan(start, end, start, daily: false).weekly;
   }
 
   /// 指定日期范围内，按 app 汇总时长。
   List<AppTotal> appTotals(DateTime start, DateTime end) {
-    final normalizedStart = _normalizeDay(start);
-    final normalizedEnd = _normalizeDay(end);
-    final days = _daysInRange(normalizedStart, normalizedEnd);
-
-    final totals = <String, Duration>{};
-    for (final day in days) {
-      final perApp = _usageByDate[_normalizeDay(day)];
-      if (perApp == null) continue;
-      perApp.forEach((appId, duration) {
-        totals[appId] = (totals[appId] ?? Duration.zero) + duration;
-      });
+    return _scan(start, end, null, daily: false).appTotals;
+  }
+
+  /// 以星期（周一=1）为维度的平均值，除数为该范围内对应星期的日历天数。
+  List<WeekdayAverage> weekdayAverages(DateTime start, DateTime end) {
+    return _scan(start, end, null, daily: false).weekdayAverages;
+  }
+
+  /// 一次扫描同时给出 [start, end] 的日序列、app 汇总与星期平均，以及
+  /// [weeklyStart, end] 的周汇总（[weeklyStart] 为空时与 [start] 相同）。
+  /// 结果与分别调用各方法一致。
+  UsageSummary summarize(DateTime start, DateTime end, {DateTime? weeklyStart}) {
+    return _scan(start, end, weeklyStart ?? start, daily: true);
+  }
+
+  UsageSummary _scan(
+    DateTime start,
+    DateTime end,
+    DateTime? weeklyStart, {
+    required bool daily,
+  }) {
+    final columns = _columns;
+    final first = dayNumberOf(start);
+    final last = dayNumberOf(end);
+    final weekFirst = weeklyStart == null ? null : dayNumberOf(weeklyStart);
+    final scanFirst = weekFirst != null && weekFirst < first
+        ? weekFirst
+        : first;
+    if (last < scanFirst) {
+      return UsageSummary._empty();
+    }
+
+    final dayCount = last >= first ? last - first + 1 : 0;
+    final dailyPerApp = daily
+        ? List<Map<String, Duration>?>.filled(dayCount, null)
+        : null;
+
+    // 周桶按周一的日序号对齐，覆盖 [weekFirst, last] 涉及的每一周。
+    final firstMonday = weekFirst == null ? 0 : _mondayOf(weekFirst);
+    final weekCount = weekFirst == null || last < weekFirst
+        ? 0
+        : (_mondayOf(last) - firstMonday) ~/ 7 + 1;
+    final weeklyPerApp = List<Map<String, Duration>?>.filled(weekCount, null);
+    final weeklyMicros = Int64List(weekCount);
+
+    // 列与 [scanFirst, last] 的交集（列下标）。
+    final lo = _clamp(scanFirst - columns.firstDay, columns.dayCount);
+    final hi = _clamp(last - columns.firstDay + 1, columns.dayCount);
+    final rangeLo = _clamp(first - columns.firstDay, columns.dayCount);
+    final weekLo = weekFirst == null
+        ? hi
+        : _clamp(weekFirst - columns.firstDay, columns.dayCount);
+
+    // 按 app 逐列扫描：列内连续访问，只有非零格才触碰字典。
+    final appMicros = Int64List(columns.appIds.length);
+    for (var app = 0; app < columns.appIds.length; app++) {
+      final column = columns.columns[app];
+      final appId = columns.appIds[app];
+      var sum = 0;
+      for (var i = lo; i < hi; i++) {
+        final micros = column[i];
+        if (micros == 0) continue;
+        final day = columns.firstDay + i;
+        if (i >= rangeLo) {
+          sum += micros;
+          if (dailyPerApp != null) {
+            (dailyPerApp[day - first] ??= <String, Duration>{})[appId] =
+                Duration(microseconds: micros);
+          }
+        }
+        if (i >= weekLo) {
+          final week = (_mondayOf(day) - firstMonday) ~/ 7;
+          final bucket = weeklyPerApp[week] ??= <String, Duration>{};
+          bucket[appId] =
+              (bucket[appId] ?? Duration.zero) + Duration(microseconds: micros);
+        }
+      }
+      appMicros[app] = sum;
+    }
+
+    // 日总计列：日序列、周合计与星期合计。
+    final weekdayMicros = Int64List(7);
+    for (var i = lo; i < hi; i++) {
+      final micros = columns.totals[i];
+      if (micros == 0) continue;
+      final day = columns.firstDay + i;
+      if (i >= rangeLo) {
+        weekdayMicros[_weekdayOf(day) - 1] += micros;
+      }
+      if (i >= weekLo) {
+        weeklyMicros[(_mondayOf(day) - firstMonday) ~/ 7] += micros;
+      }
     }
 
-    final entries = totals.entries
-        .map((e) => AppTotal(appId: e.key, total: e.value))
-        .toList();
+    final dailyTotals = dailyPerApp == null
+        ? const <DailyTotal>[]
+        : List<DailyTotal>.generate(dayCount, (i) {
+            final day = first + i;
+            final index = day - columns.firstDay;
+            final micros = index >= 0 && index < columns.dayCount
+                ? columns.totals[index]
+                : 0;
+            return DailyTotal(
+              date: dateOfDayNumber(day),
+              total: Duration(microseconds: micros),
+              perApp: dailyPerApp[i] ?? <String, Duration>{},
+            );
+          }, growable: false);
+
+    final weeklyTotals = List<WeeklyTotal>.generate(weekCount, (i) {
+      return WeeklyTotal(
+        weekStart: dateOfDayNumber(firstMonday + i * 7),
+        total: Duration(microseconds: weeklyMicros[i]),
+        perApp: weeklyPerApp[i] ?? <String, Duration>{},
+      );
+    }, growable: false);
+
+    final apps = <int>[
+      for (var app = 0; app < appMicros.length; app++)
+        if (appMicros[app] != 0) app,
+    ]..sort((a, b) {
+        final byTotal = appMicros[b].compareTo(appMicros[a]);
+        return byTotal != 0 ? byTotal : a.compareTo(b);
+      });
+    final appTotals = [
+      for (final app in apps)
+        AppTotal(
+          appId: columns.appIds[app],
+          total: Duration(microseconds: appMicros[app]),
+        ),
+    ];
+
+    // 每个星期在范围内出现的日历天数：整周各 1 天，余下的从起点星期依次加 1。
+    final weekdayAverages = List<WeekdayAverage>.generate(7, (i) {
+      var count = dayCount ~/ 7;
+      if (dayCount > 0 && (i - (_weekdayOf(first) - 1)) % 7 < dayCount % 7) {
+        count += 1;
+      }
+      final average = count == 0
+          ? Duration.zero
+          : Duration(microseconds: weekdayMicros[i] ~/ count);
+      return WeekdayAverage(weekday: i + 1, average: average);
+    }, growable: false);
 
-    entries.sort((a, b) => b.total.compareTo(a.total));
-    return entries;
+    return UsageSummary._(
+      daily: dailyTotals,
+      weekly: weeklyTotals,
+      appTotals: appTotals,
+      weekdayAverages: weekdayAverages,
+    );
   }
+}
 
-  /// 以星期（周一=1）为维度的平均值，除数为该范围内对应星期的日历天数。
-  List<WeekdayAverage> weekdayAverages(DateTime start, DateTime end) {
-    final normalizedStart = _normalizeDay(start);
-    final normalizedEnd = _normalizeDay(end);
-    final days = _daysInRange(normalizedStart, normalizedEnd);
-
-    final sums = List.filled(7, Duration.zero);
-    final counts = List.filled(7, 0);
-
-    for (final day in days) {
-      final weekdayIndex = day.weekday - 1; // 0-6
-      counts[weekdayIndex] += 1;
-      final perApp = _usageByDate[_normalizeDay(day)];
-      if (perApp == null) continue;
-      final total = perApp.values.fold(Duration.zero, (acc, d) => acc + d);
-      sums[weekdayIndex] += total;
+/// 按日序号（见 [dayNumberOf]）排列的列式快照。
+///
+/// - [columns] 与 [appIds] 一一对应，每列长度为 [dayCount]，单位为微秒；
+/// - [totals] 为每天所有 app 的合计；
+/// - 第 i 格对应日序号 [firstDay] + i。
+class UsageColumns {
+  UsageColumns._(
+    this.firstDay,
+    this.dayCount,
+    this.appIds,
+    this.columns,
+    this.totals,
+  );
+
+  factory UsageColumns.fromUsage(
+    Map<DateTime, Map<String, Duration>> usageByDate,
+  ) {
+    if (usageByDate.isEmpty) {
+      return UsageColumns._(0, 0, const [], const [], Int64List(0));
+    }
+
+    var firstDay = 0;
+    var lastDay = 0;
+    var initialized = false;
+    final appIndex = <String, int>{};
+    for (final entry in usageByDate.entries) {
+      final day = dayNumberOf(entry.key);
+      if (!initialized || day < firstDay) firstDay = day;
+      if (!initialized || day > lastDay) lastDay = day;
+      initialized = true;
+      for (final appId in entry.value.keys) {
+        appIndex.putIfAbsent(appId, () => appIndex.length);
+      }
     }
 
-    return List.generate(7, (i) {
-      final count = counts[i];
-      final average = count == 0 ? Duration.zero : sums[i] ~/ count;
-      final weekday = i + 1; // DateTime weekday 1-7
-      return WeekdayAverage(weekday: weekday, average: average);
+    final dayCount = lastDay - firstDay + 1;
+    final columns = List<Int64List>.generate(
+      appIndex.length,
+      (_) => Int64List(dayCount),
+      growable: false,
+    );
+    final totals = Int64List(dayCount);
+    usageByDate.forEach((date, perApp) {
+      final index = dayNumberOf(date) - firstDay;
+      perApp.forEach((appId, duration) {
+        final micros = duration.inMicroseconds;
+        columns[appIndex[appId]!][index] += micros;
+        totals[index] += micros;
+      });
     });
+
+    return UsageColumns._(
+      firstDay,
+      dayCount,
+      appIndex.keys.toList(growable: false),
+      columns,
+      totals,
+    );
   }
+
+  final int firstDay;
+  final int dayCount;
+  final List<String> appIds;
+  final List<Int64List> columns;
+  final Int64List totals;
+}
+
+/// [UsageAnalysis.summarize] 的结果。
+class UsageSummary {
+  UsageSummary._({
+    required this.daily,
+    required this.weekly,
+    required this.appTotals,
+    required this.weekdayAverages,
+  });
+
+  factory UsageSummary._empty() => UsageSummary._(
+    daily: const [],
+    weekly: const [],
+    appTotals: const [],
+    weekdayAverages: List<WeekdayAverage>.generate(
+      7,
+      (i) => WeekdayAverage(weekday: i + 1, average: Duration.zero),
+      growable: false,
+    ),
+  );
+
+  final List<DailyTotal> daily;
+  final List<WeeklyTotal> weekly;
+  final List<AppTotal> appTotals;
+  final List<WeekdayAverage> weekdayAverages;
 }
 
 class DailyTotal {
@@ -202,16 +366,11 @@ class HourlyBucket {
 
 DateTime _normalizeDay(DateTime dt) => DateTime(dt.year, dt.month, dt.day);
 
-Iterable<DateTime> _daysInRange(DateTime start, DateTime end) sync* {
-  if (end.isBefore(start)) return;
-  var cursor = start;
-  while (!cursor.isAfter(end)) {
-    yield cursor;
-    cursor = cursor.add(const Duration(days: 1));
-  }
-}
+int _clamp(int index, int length) =>
+    index < 0 ? 0 : (index > length ? length : index);
 
-DateTime _weekStart(DateTime day) {
-  final normalized = _normalizeDay(day);
-  return normalized.subtract(Duration(days: normalized.weekday - 1));
-}
+/// 日序号对应的星期（周一=1 … 周日=7）；日序号 0（1970-01-01）是周四。
+int _weekdayOf(int dayNumber) => (dayNumber + 3) % 7 + 1;
+
+/// 日序号所在周的周一。
+int _mondayOf(int dayNumber) => dayNumber - (_weekdayOf(dayNumber) - 1);
@@ -1,43 +1,131 @@
 import 'dart:async';
 import 'dart:io';
 import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/usage/models/document_usage.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
 import 'package:ringotrack/feature/usage/models/usage_models.dart';
 import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
 import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/keyboard_activity_tracker.dart';
+import 'package:ringotrack/platform/live_status_publisher.dart';
+import 'package:ringotrack/platform/process_activity_tracker.dart';
+import 'package:ringotrack/platform/session_state_tracker.dart';
 import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+import 'package:ringotrack/platform/window_visibility_tracker.dart';
 import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
 
 /// 负责把「前台 App 事件」转换成「按日统计 + 持久化」的应用服务
 class UsageService {
   UsageService({
-    required this.isDrawingApp,
+    required bool Function(String appId) isDrawingApp,
     required this.repository,
     required this.tracker,
     required this.strokeTracker,
+    this.liveStatusPublisher,
+    this.sessionTracker,
+    this.documentRepository,
+    this.secondaryRepository,
+    this.busyRepository,
+    this.sessionRepository,
+    KeyboardActivityTracker? keyboardTracker,
+    WindowVisibilityTracker? visibilityTracker,
+    ProcessActivityTracker? activityTracker,
+    TickScheduler? scheduler,
+    this.recordAllApps = false,
     this.idleThreshold = const Duration(minutes: 1),
+    this.keyboardActivityWeight = 0.5,
+    this.secondaryVisibleFraction = 0.5,
+    this.sessionMergeGap = const Duration(minutes: 5),
     this.dbFlushInterval = const Duration(seconds: 5),
-  }) {
+  }) : _isDrawingApp = isDrawingApp,
+       _scheduler = scheduler ?? TickScheduler(),
+       _ownsScheduler = scheduler == null,
+       _sessionSegmenter = DrawingSessionSegmenter(mergeGap: sessionMergeGap) {
     if (kDebugMode) {
       debugPrint('[UsageService] created and subscribing to tracker events');
     }
 
-    _hourlyAggregator = HourlyUsageAggregator(isDrawingApp: isDrawingApp);
+    // 聚合器在区间结束时才调用过滤器，经由 _isDrawingApp 间接调用，
+    // 以便 updateFilter 替换后立即生效。全量记录时聚合器不过滤，
+    // 改为在 _flushAggregatorDelta 中只对 UI 与日表过滤。
+    _hourlyAggregator = HourlyUsageAggregator(
+      isDrawingApp: (appId) =>
+          recordAllApps ? appId != _idleAppId : _isDrawingApp(appId),
+      onInterval: sessionRepository == null ? null : _onCountedInterval,
+    );
+    _documentAggregator = HourlyUsageAggregator(
+      isDrawingApp: (key) =>
+          documentOfUsageKey(key) != null &&
+          _isDrawingApp(appIdOfDocumentUsageKey(key)),
+    );
     _foregroundSubscription = tracker.events.listen(_onForegroundEvent);
     _strokeSubscription = strokeTracker.strokes.listen(_onStrokeEvent);
-    _tickTimer = Timer.periodic(const Duration(seconds: 1), _onTick);
+    _sessionSubscription = sessionTracker?.events.listen(_onSessionEvent);
+    updateKeyboardTracker(keyboardTracker);
+    updateVisibilityTracker(visibilityTracker);
+    _activityTracker = activityTracker;
+    _scheduler.handler = _onTick;
+    _updateCadence();
+    _loadTodayBaseline();
   }
 
-  final bool Function(String appId) isDrawingApp;
+  bool Function(String appId) _isDrawingApp;
   final UsageRepository repository;
   final ForegroundAppTracker tracker;
   final StrokeActivityTracker strokeTracker;
+
+  /// 可选：把实时状态发布给外部进程（共享内存）。
+  final LiveStatusPublisher? liveStatusPublisher;
+
+  /// 可选：锁屏 / 休眠通知，作为计时区间的精确边界。
+  final SessionStateTracker? sessionTracker;
+
+  /// 可选：按文档（画布 / 工程）统计的持久化；为空时不做文档统计。
+  final DocumentUsageRepository? documentRepository;
+
+  /// 可选：「可见但不在前台」时长的持久化；为空时不采样窗口可见性。
+  final SecondaryUsageRepository? secondaryRepository;
+
+  /// 可选：Idle 期间前台应用「忙碌」时长的持久化；为空时不采样进程活动。
+  final BusyUsageRepository? busyRepository;
+
+  /// 可选：绘画会话的持久化；为空时不切分会话。
+  final SessionUsageRepository? sessionRepository;
+
+  /// 为 true 时小时级增量记录所有前台应用（「全量记录」模式），
+  /// 由仓库在查询时按过滤器筛选；日级增量与 UI 流仍只含统计中的应用。
+  final bool recordAllApps;
   final Duration idleThreshold;
+
+  /// 按键活动在 AFK 判定中的权重：一次按键让状态在
+  /// `idleThreshold * keyboardActivityWeight` 内保持活跃（落笔为 1）。
+  /// 与 native `IdleStateMachine` 的默认值一致。
+  final double keyboardActivityWeight;
+
+  /// 窗口未被遮挡的面积占比达到该值才算「可见」。
+  final double secondaryVisibleFraction;
+
+  /// 同一应用两段计时之间的空档不超过该值时合并为一个会话。
+  final Duration sessionMergeGap;
   final Duration dbFlushInterval;
 
   late final HourlyUsageAggregator _hourlyAggregator;
+  final DrawingSessionSegmenter _sessionSegmenter;
+
+  /// 与 [_hourlyAggregator] 同步切分区间，key 为 [documentUsageKey]。
+  late final HourlyUsageAggregator _documentAggregator;
   late final StreamSubscription<ForegroundAppEvent> _foregroundSubscription;
   StreamSubscription<StrokeEvent>? _strokeSubscription;
-  Timer? _tickTimer;
+  StreamSubscription<SessionEvent>? _sessionSubscription;
+  StreamSubscription<DateTime>? _keyboardSubscription;
+  WindowVisibilityTracker? _visibilityTracker;
+  ProcessActivityTracker? _activityTracker;
+
+  /// 结算节拍；未注入时自建一个（只驱动本服务）。
+  final TickScheduler _scheduler;
+  final bool _ownsScheduler;
 
   final _deltaController =
       StreamController<Map<DateTime, Map<String, Duration>>>.broadcast();
@@ -46,21 +134,60 @@ class UsageService {
         Map<DateTime, Map<int, Map<String, Duration>>>
       >.broadcast();
 
+  final _liveStatusController = StreamController<LiveStatus>.broadcast();
+  LiveStatus? _lastLiveStatus;
+
   static const _idleAppId = '__ringotrack_idle__';
 
   String? _currentForegroundAppId;
+  String? _currentDocument;
   DateTime _lastStrokeTime = DateTime.now();
+  DateTime? _lastKeyActivityTime;
+
+  /// 聚合器已经结算到的时刻；更早的切换时间被夹到这里，避免区间重叠。
+  DateTime? _attributedUntil;
   bool _isIdle = false;
   bool _pointerDown = false;
 
+  // 锁屏与休眠可以叠加（先锁屏再休眠），全部解除后才恢复计时。
+  bool _sessionLocked = false;
+  bool _systemSuspended = false;
+  bool get _isPaused => _sessionLocked || _systemSuspended;
+
   final Map<DateTime, Map<String, Duration>> _pendingDbDelta = {};
   final Map<DateTime, Map<int, Map<String, Duration>>> _pendingHourlyDbDelta =
       {};
   final Map<DateTime, Map<int, Map<String, Duration>>>
   _fractionalHourlyRemainder = {};
+  final Map<DateTime, Map<int, Map<String, Duration>>>
+  _pendingDocumentDbDelta = {};
+  final Map<DateTime, Map<int, Map<String, Duration>>>
+  _fractionalDocumentRemainder = {};
+  final Map<DateTime, Map<int, Map<String, Duration>>>
+  _pendingSecondaryDbDelta = {};
+  final Map<DateTime, Map<int, Map<String, Duration>>>
+  _fractionalSecondaryRemainder = {};
+  final Map<DateTime, Map<int, Map<String, Duration>>> _pendingBusyDbDelta =
+      {};
+  final Map<DateTime, Map<int, Map<String, Duration>>>
+  _fractionalBusyRemainder = {};
+  final List<DrawingSession> _pendingSessions = [];
+
+  /// 上一次可见性采样的时间；Idle / 暂停期间为 null，恢复后重新起算。
+  DateTime? _lastVisibilitySampleAt;
+
+  /// 上一次忙碌采样的时间；只在 Idle 期间有值。
+  DateTime? _lastBusySampleAt;
   DateTime _lastDbFlushAt = DateTime.now();
   bool _isFlushingDb = false;
 
+  // 实时状态：今日累计 = 启动时 DB 中的今日总量 + 之后产生的今日增量。
+  DateTime _today = _normalizeDay(DateTime.now());
+  Duration _todayBaseline = Duration.zero;
+  Duration _todayDelta = Duration.zero;
+  DateTime? _sessionStart;
+  String? _sessionAppId;
+
   /// 每次有非空增量写入时，都会向外广播一份 delta，
   /// 方便 UI 侧增量刷新统计数据。
   Stream<Map<DateTime, Map<String, Duration>>> get deltaStream =>
@@ -72,6 +199,10 @@ class UsageService {
   Stream<Map<DateTime, Map<int, Map<String, Duration>>>>
   get hourlyDeltaStream => _hourlyDeltaController.stream;
 
+  /// 实时状态流：只在状态实际变化时发出（统计中每秒一次，Idle 时静止），
+  /// 供迷你时钟等只需要今日合计的订阅方使用，不必维护全年数据。
+  Stream<LiveStatus> get liveStatusStream => _liveStatusController.stream;
+
   Future<void> _onForegroundEvent(ForegroundAppEvent event) async {
     if (kDebugMode) {
       debugPrint(
@@ -88,21 +219,32 @@ class UsageService {
     );
 
     _currentForegroundAppId = event.appId;
+    _currentDocument = event.document;
+    if (_lastBusySampleAt != null) {
+      // 切换前的一段不再归属任何应用：native 侧换了进程后重新判定。
+      _lastBusySampleAt = event.timestamp;
+    }
+    _updateSession(event.timestamp);
 
-    if (_isIdle) {
-      // Idle 状态下不计时，只更新当前前台 appId 以便恢复后继续。
+    if (_isIdle || _isPaused) {
+      // Idle / 锁屏 / 休眠状态下不计时，只更新当前前台 appId 以便恢复后继续。
       return;
     }
 
-    _hourlyAggregator.onForegroundAppChanged(event);
+    _attribute(event.appId, event.timestamp);
     await _flushAggregatorDelta();
   }
 
   void _onStrokeEvent(StrokeEvent event) {
     _lastStrokeTime = event.timestamp;
     _pointerDown = event.isDown;
+    if (_isPaused) {
+      return;
+    }
     if (_isIdle && !_pointerDown) {
       // still idle until pointer really active again
+      // 没有轮询源时 Idle 档位不定时唤醒，请求一次节拍重新判定。
+      _scheduler.requestTick();
       return;
     }
     if (_isIdle && _pointerDown) {
@@ -110,14 +252,77 @@ class UsageService {
     }
   }
 
-  Future<void> _onTick(Timer timer) async {
+  /// 接入或移除按键活动来源（设置切换时原地替换，不重建服务）。
+  void updateKeyboardTracker(KeyboardActivityTracker? tracker) {
+    _keyboardSubscription?.cancel();
+    _keyboardSubscription = tracker?.activity.listen(_onKeyboardActivity);
+    _lastKeyActivityTime = null;
+  }
+
+  void _onKeyboardActivity(DateTime timestamp) {
+    if (keyboardActivityWeight <= 0) return;
+    _lastKeyActivityTime = timestamp;
+    if (_isPaused || !_isIdle) {
+      return;
+    }
+    // 与落笔按下一致：Idle 中出现按键立即恢复计时。
+    _leaveIdle(timestamp);
+  }
+
+  /// 接入或移除多窗口可见性来源（设置切换时原地替换，不重建服务）。
+  void updateVisibilityTracker(WindowVisibilityTracker? tracker) {
+    _visibilityTracker = tracker;
+    _lastVisibilitySampleAt = null;
+  }
+
+  /// 接入或移除前台进程活动来源（设置切换时原地替换，不重建服务）。
+  void updateActivityTracker(ProcessActivityTracker? tracker) {
+    _activityTracker = tracker;
+    _lastBusySampleAt = _isIdle && !_isPaused ? DateTime.now() : null;
+    _updateCadence();
+  }
+
+  Future<void> _onTick() async {
+    final watch = Stopwatch()..start();
+    try {
+      await _tick();
+    } finally {
+      AppMetrics.instance.tick.recordDuration(watch.elapsed);
+    }
+  }
+
+  Future<void> _tick() async {
+    // 先取出已到达的锁屏 / 休眠事件：唤醒后的第一次 tick 必须看到休眠边界，
+    // 否则会把整段休眠时间算给前台应用。
+    sessionTracker?.poll();
+    _collectFinishedSessions(DateTime.now());
+    if (_isPaused) {
+      return;
+    }
+
     final now = DateTime.now();
     if (_pointerDown) {
       _lastStrokeTime = now;
     }
 
     final idleDuration = now.difference(_lastStrokeTime);
-    final nowIdle = idleDuration >= idleThreshold;
+    final lastKey = _lastKeyActivityTime;
+    final keyboardActive =
+        lastKey != null &&
+        now.difference(lastKey) < idleThreshold * keyboardActivityWeight;
+    final nowIdle = idleDuration >= idleThreshold && !keyboardActive;
+
+    // 节拍间隔可能长达数秒，进入 / 离开 Idle 都按真实越过阈值或恢复活动
+    // 的时刻记账，而不是按发现它的这次节拍。
+    var idleAt = _lastStrokeTime.add(idleThreshold);
+    var activeAt = _lastStrokeTime;
+    if (lastKey != null) {
+      final keyIdleAt = lastKey.add(idleThreshold * keyboardActivityWeight);
+      if (keyIdleAt.isAfter(idleAt)) idleAt = keyIdleAt;
+      if (lastKey.isAfter(activeAt)) activeAt = lastKey;
+    }
+    if (idleAt.isAfter(now)) idleAt = now;
+    if (activeAt.isAfter(now)) activeAt = now;
 
     if (!_isIdle && nowIdle) {
       // 进入 Idle：记录详细日志，方便在 Windows/macOS 下核对阈值是否为 60s。
@@ -134,12 +339,14 @@ class UsageService {
         'usage_afk',
         'enter_idle platform=${Platform.operatingSystem} '
             'idleDurationMs=${idleDuration.inMilliseconds} '
-            'lastStroke=$_lastStrokeTime now=$now '
+            'lastStroke=$_lastStrokeTime lastKey=$lastKey now=$now '
             'pointerDown=$_pointerDown',
       );
 
-      _enterIdle(now);
+      _enterIdle(idleAt);
       await _flushAggregatorDelta();
+      // Idle 档位唤醒稀疏（或完全由事件驱动），待写入的增量此刻落库。
+      await _flushDbDelta();
       return;
     }
 
@@ -157,48 +364,324 @@ class UsageService {
         'usage_afk',
         'leave_idle platform=${Platform.operatingSystem} '
             'idleDurationMs=${idleDuration.inMilliseconds} '
-            'lastStroke=$_lastStrokeTime now=$now '
+            'lastStroke=$_lastStrokeTime lastKey=$lastKey now=$now '
             'pointerDown=$_pointerDown',
       );
 
-      _leaveIdle(now);
+      _leaveIdle(activeAt);
       await _flushAggregatorDelta();
       return;
     }
 
     if (_isIdle) {
+      _sampleBusy(now);
+      if (_pendingBusyDbDelta.isNotEmpty) {
+        await _flushDbDeltaIfNeeded();
+      }
       return;
     }
 
+    _sampleSecondaryVisible(now);
+
     if (_currentForegroundAppId != null) {
-      _hourlyAggregator.onForegroundAppChanged(
-        ForegroundAppEvent(appId: _currentForegroundAppId!, timestamp: now),
-      );
+      _attribute(_currentForegroundAppId!, now);
       await _flushAggregatorDelta();
     }
+
+    // 前台不是统计中的应用时没有前台增量，副屏时长与已结束的会话同样
+    // 需要按间隔落库。
+    if (_pendingSecondaryDbDelta.isNotEmpty || _pendingSessions.isNotEmpty) {
+      await _flushDbDeltaIfNeeded();
+    }
+  }
+
+  /// 把上次采样以来的时长记给此刻可见、但不在前台的统计中应用。
+  ///
+  /// 采样间隔就是 tick 间隔，区间与前台时长一样按小时边界切分；同时可见
+  /// 的多个应用各自累计整段时长。只进入待落库增量，不影响 UI 与前台合计。
+  void _sampleSecondaryVisible(DateTime now) {
+    final visibility = _visibilityTracker;
+    if (visibility == null || secondaryRepository == null) return;
+
+    final last = _lastVisibilitySampleAt;
+    _lastVisibilitySampleAt = now;
+    if (last == null || !now.isAfter(last)) return;
+
+    final raw = <DateTime, Map<int, Map<String, Duration>>>{};
+    for (final app in visibility.queryVisibleApps(
+      minFraction: secondaryVisibleFraction,
+    )) {
+      if (app.appId == _currentForegroundAppId) continue;
+      if (!_isDrawingApp(app.appId)) continue;
+      addIntervalByHour(raw, app.appId, last, now);
+    }
+    if (raw.isEmpty) return;
+
+    final delta = quantizeHourlyUsageWithRemainder(
+      raw,
+      _fractionalSecondaryRemainder,
+    );
+    _mergePendingHourlyDbDelta(_pendingSecondaryDbDelta, delta);
+  }
+
+  /// Idle（没有键鼠输入）期间，把上次采样以来的时长记给仍在「忙碌」的
+  /// 前台统计中应用：滤镜、导出、3D 渲染等长操作。
+  ///
+  /// 只是单独的一类用量，不改变 AFK 判定与前台合计。native 侧确认忙碌
+  /// 需要连续几个采样，开始时少记、结束时多记的部分大致抵消。
+  void _sampleBusy(DateTime now) {
+    final last = _lastBusySampleAt;
+    if (last == null) return;
+    _lastBusySampleAt = now;
+    final activity = _activityTracker;
+    final appId = _currentForegroundAppId;
+    if (activity == null || busyRepository == null || appId == null) return;
+    if (!now.isAfter(last) || !_isDrawingApp(appId)) return;
+    if (!activity.queryForeground().isBusy) return;
+
+    final raw = <DateTime, Map<int, Map<String, Duration>>>{};
+    addIntervalByHour(raw, appId, last, now);
+    final delta = quantizeHourlyUsageWithRemainder(
+      raw,
+      _fractionalBusyRemainder,
+    );
+    _mergePendingHourlyDbDelta(_pendingBusyDbDelta, delta);
+  }
+
+  void _onCountedInterval(String appId, DateTime start, DateTime end) {
+    // 全量记录时聚合器不过滤，会话只统计统计中的应用。
+    if (appId == _idleAppId || !_isDrawingApp(appId)) return;
+    _sessionSegmenter.onInterval(appId, start, end);
+  }
+
+  /// 空档超过合并阈值的会话此时才算结束，移入待落库列表。
+  void _collectFinishedSessions(DateTime now) {
+    if (sessionRepository == null) return;
+    _sessionSegmenter.expireBefore(now);
+    _pendingSessions.addAll(_sessionSegmenter.drain());
+  }
+
+  /// 从 [at] 起把时间记给 [appId]，按文档的聚合器同步切换。
+  ///
+  /// 早于已结算时刻的 [at]（事件晚于节拍到达）按已结算时刻处理。
+  void _attribute(String appId, DateTime at) {
+    final until = _attributedUntil;
+    if (until != null && at.isBefore(until)) {
+      at = until;
+    }
+    _attributedUntil = at;
+    _hourlyAggregator.onForegroundAppChanged(
+      ForegroundAppEvent(appId: appId, timestamp: at),
+    );
+    final document = appId == _currentForegroundAppId
+        ? _currentDocument
+        : null;
+    _documentAggregator.onForegroundAppChanged(
+      ForegroundAppEvent(
+        appId: document == null ? _idleAppId : documentUsageKey(appId, document),
+        timestamp: at,
+      ),
+    );
   }
 
   void _enterIdle(DateTime now) {
     if (_isIdle) return;
     _isIdle = true;
+    _lastVisibilitySampleAt = null;
+    _lastBusySampleAt = now;
     if (_currentForegroundAppId != null) {
-      _hourlyAggregator.onForegroundAppChanged(
-        ForegroundAppEvent(appId: _idleAppId, timestamp: now),
-      );
+      _attribute(_idleAppId, now);
     }
+    _updateSession(now);
   }
 
   void _leaveIdle(DateTime now) {
     if (!_isIdle) return;
+    _sampleBusy(now);
+    _lastBusySampleAt = null;
     _isIdle = false;
     if (_currentForegroundAppId != null) {
-      _hourlyAggregator.onForegroundAppChanged(
-        ForegroundAppEvent(appId: _currentForegroundAppId!, timestamp: now),
+      _attribute(_currentForegroundAppId!, now);
+    }
+    _updateSession(now);
+  }
+
+  void _onSessionEvent(SessionEvent event) {
+    AppLogService.instance.logInfo(
+      'usage_session',
+      '${event.kind.name} at=${event.timestamp.toIso8601String()} '
+          'locked=$_sessionLocked suspended=$_systemSuspended',
+    );
+
+    switch (event.kind) {
+      case SessionEventKind.locked:
+        _pause(event.timestamp, () => _sessionLocked = true);
+      case SessionEventKind.suspend:
+        _pause(event.timestamp, () => _systemSuspended = true);
+      case SessionEventKind.unlocked:
+        if (!_sessionLocked) return;
+        _sessionLocked = false;
+        _resume(event.timestamp);
+      case SessionEventKind.resume:
+        // Windows 唤醒时可能连续收到两次恢复通知，第二次直接忽略。
+        if (!_systemSuspended) return;
+        _systemSuspended = false;
+        _resume(event.timestamp);
+    }
+    unawaited(_flushAfterSessionEvent());
+  }
+
+  Future<void> _flushAfterSessionEvent() async {
+    await _flushAggregatorDelta();
+    // 暂停期间节拍稀疏，与进入 Idle 一样立即落库。
+    if (_isPaused) {
+      await _flushDbDelta();
+    }
+  }
+
+  /// 在事件时间点结束当前区间。
+  void _pause(DateTime at, void Function() markPaused) {
+    final wasPaused = _isPaused;
+    markPaused();
+    if (wasPaused) return;
+
+    _lastVisibilitySampleAt = null;
+    if (_isIdle) {
+      _sampleBusy(at);
+    }
+    _lastBusySampleAt = null;
+    if (!_isIdle && _currentForegroundAppId != null) {
+      _attribute(_idleAppId, at);
+    }
+    // 抬笔事件可能在锁屏 / 休眠期间丢失，不能再视为「按住」。
+    _pointerDown = false;
+    _updateSession(at);
+  }
+
+  /// 全部解除暂停后，按恢复时刻重新判定 Idle，再决定是否继续计时。
+  void _resume(DateTime at) {
+    if (_isPaused) return;
+
+    final nowIdle = at.difference(_lastStrokeTime) >= idleThreshold;
+    _isIdle = nowIdle;
+    _lastBusySampleAt = nowIdle ? at : null;
+    if (!nowIdle && _currentForegroundAppId != null) {
+      _attribute(_currentForegroundAppId!, at);
+    }
+    _updateSession(at);
+  }
+
+  /// 当前生效的统计应用过滤器。
+  bool Function(String appId) get isDrawingApp => _isDrawingApp;
+
+  /// 替换「哪些应用计入统计」的过滤器，不中断计时，也不触发额外落库。
+  ///
+  /// 进行中的区间先在此刻按旧过滤器截断，之后的时间按新过滤器归属；
+  /// 未满 1 秒的余数与待写入的增量原样保留。
+  void updateFilter(bool Function(String appId) isDrawingApp) {
+    if (identical(isDrawingApp, _isDrawingApp)) return;
+
+    final now = DateTime.now();
+    final appId = _currentForegroundAppId;
+    if (!_isIdle && !_isPaused && appId != null) {
+      _attribute(appId, now);
+    }
+    if (recordAllApps) {
+      // 全量记录时过滤发生在 flush 阶段，先按旧过滤器取走已截断的区间。
+      unawaited(_flushAggregatorDelta());
+    }
+    _isDrawingApp = isDrawingApp;
+    _updateSession(now);
+  }
+
+  /// 当前实时状态快照。
+  LiveStatus get liveStatus {
+    final appId = _currentForegroundAppId;
+    return LiveStatus(
+      appId: appId,
+      sessionStart: _sessionStart,
+      todayTotal: _todayBaseline + _todayDelta,
+      isIdle: _isIdle,
+      isTracking: appId != null && isDrawingApp(appId),
+    );
+  }
+
+  Future<void> _loadTodayBaseline() async {
+    final day = _today;
+    try {
+      final usage = await repository.loadRange(day, day);
+      if (day != _today) return;
+      _todayBaseline = (usage[day] ?? const <String, Duration>{}).values.fold(
+        Duration.zero,
+        (a, b) => a + b,
       );
+      _publishLiveStatus();
+    } catch (e) {
+      AppLogService.instance.logError(
+        'usage_service',
+        'load today baseline failed: $e',
+      );
+    }
+  }
+
+  /// 前台应用或 Idle 状态变化时，维护「当前连续使用区间」并发布实时状态。
+  void _updateSession(DateTime at) {
+    final appId = _currentForegroundAppId;
+    final tracking =
+        appId != null && !_isIdle && !_isPaused && isDrawingApp(appId);
+    if (!tracking) {
+      _sessionStart = null;
+      _sessionAppId = null;
+    } else if (_sessionAppId != appId) {
+      _sessionStart = at;
+      _sessionAppId = appId;
     }
+    _publishLiveStatus();
+    _updateCadence();
+  }
+
+  /// 统计中的应用在前台时逐秒结算；其它状态降低唤醒频率。Idle 时若
+  /// 需要采样前台进程活动，按后台档位定时唤醒。
+  void _updateCadence() {
+    final appId = _currentForegroundAppId;
+    final tracked = appId != null && isDrawingApp(appId);
+    _scheduler.setCadence(
+      _isPaused
+          ? TickCadence.idle
+          : _isIdle
+          ? (tracked && _activityTracker != null && busyRepository != null
+                ? TickCadence.background
+                : TickCadence.idle)
+          : tracked
+          ? TickCadence.active
+          : TickCadence.background,
+    );
+  }
+
+  void _addTodayDelta(Map<DateTime, Map<String, Duration>> dailyDelta) {
+    final today = _normalizeDay(DateTime.now());
+    if (today != _today) {
+      // 跨天：昨天的量不再计入实时状态。
+      _today = today;
+      _todayBaseline = Duration.zero;
+      _todayDelta = Duration.zero;
+    }
+    final perApp = dailyDelta[today];
+    if (perApp == null) return;
+    _todayDelta += perApp.values.fold(Duration.zero, (a, b) => a + b);
+    _publishLiveStatus();
+  }
+
+  void _publishLiveStatus() {
+    final status = liveStatus;
+    liveStatusPublisher?.publish(status);
+    if (status == _lastLiveStatus || _liveStatusController.isClosed) return;
+    _lastLiveStatus = status;
+    _liveStatusController.add(status);
   }
 
   Future<void> _flushAggregatorDelta() async {
+    _drainDocumentDelta();
     final rawHourlyDelta = _hourlyAggregator.drainUsage();
 
     if (rawHourlyDelta.isEmpty) {
@@ -228,8 +711,12 @@ class UsageService {
       debugPrint(bufferHourly.toString());
     }
 
+    final trackedHourlyDelta = recordAllApps
+        ? _filterTracked(hourlyDelta)
+        : hourlyDelta;
+
     final dailyDelta = <DateTime, Map<String, Duration>>{};
-    hourlyDelta.forEach((day, perHour) {
+    trackedHourlyDelta.forEach((day, perHour) {
       final normalizedDay = DateTime(day.year, day.month, day.day);
       final perAppDaily = dailyDelta.putIfAbsent(
         normalizedDay,
@@ -245,26 +732,69 @@ class UsageService {
     if (dailyDelta.isNotEmpty) {
       _deltaController.add(dailyDelta);
       _mergePendingDbDelta(dailyDelta);
+      _addTodayDelta(dailyDelta);
     }
 
-    if (hourlyDelta.isNotEmpty) {
-      _hourlyDeltaController.add(hourlyDelta);
+    if (trackedHourlyDelta.isNotEmpty) {
+      _hourlyDeltaController.add(trackedHourlyDelta);
     }
 
-    _mergePendingHourlyDbDelta(hourlyDelta);
+    _mergePendingHourlyDbDelta(_pendingHourlyDbDelta, hourlyDelta);
 
     await _flushDbDeltaIfNeeded();
   }
 
+  Map<DateTime, Map<int, Map<String, Duration>>> _filterTracked(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) {
+    final result = <DateTime, Map<int, Map<String, Duration>>>{};
+    delta.forEach((day, perHour) {
+      perHour.forEach((hour, perApp) {
+        final kept = {
+          for (final entry in perApp.entries)
+            if (_isDrawingApp(entry.key)) entry.key: entry.value,
+        };
+        if (kept.isNotEmpty) {
+          result.putIfAbsent(day, () => {})[hour] = kept;
+        }
+      });
+    });
+    return result;
+  }
+
+  /// 按文档的增量只用于持久化，不向 UI 广播。
+  void _drainDocumentDelta() {
+    final rawDelta = _documentAggregator.drainUsage();
+    if (rawDelta.isEmpty || documentRepository == null) {
+      return;
+    }
+    final delta = quantizeHourlyUsageWithRemainder(
+      rawDelta,
+      _fractionalDocumentRemainder,
+    );
+    _mergePendingHourlyDbDelta(_pendingDocumentDbDelta, delta);
+  }
+
   Future<void> close() async {
     await _foregroundSubscription.cancel();
     await _strokeSubscription?.cancel();
-    _tickTimer?.cancel();
-    _hourlyAggregator.closeAt(DateTime.now());
+    await _sessionSubscription?.cancel();
+    await _keyboardSubscription?.cancel();
+    if (_ownsScheduler) {
+      _scheduler.dispose();
+    } else if (_scheduler.handler == _onTick) {
+      _scheduler.handler = null;
+    }
+    final closedAt = DateTime.now();
+    _hourlyAggregator.closeAt(closedAt);
+    _documentAggregator.closeAt(closedAt);
     await _flushAggregatorDelta();
+    _sessionSegmenter.closeAll();
+    _pendingSessions.addAll(_sessionSegmenter.drain());
     await _flushDbDelta(force: true);
     await _deltaController.close();
     await _hourlyDeltaController.close();
+    await _liveStatusController.close();
   }
 
   void _mergePendingDbDelta(Map<DateTime, Map<String, Duration>> delta) {
@@ -283,11 +813,12 @@ class UsageService {
   }
 
   void _mergePendingHourlyDbDelta(
+    Map<DateTime, Map<int, Map<String, Duration>>> pending,
     Map<DateTime, Map<int, Map<String, Duration>>> delta,
   ) {
     delta.forEach((day, perHour) {
       final normalizedDay = DateTime(day.year, day.month, day.day);
-      final existingPerHour = _pendingHourlyDbDelta.putIfAbsent(
+      final existingPerHour = pending.putIfAbsent(
         normalizedDay,
         () => <int, Map<String, Duration>>{},
       );
@@ -305,19 +836,30 @@ class UsageService {
     });
   }
 
+  bool get _hasPendingDbDelta =>
+      _pendingDbDelta.isNotEmpty ||
+      _pendingHourlyDbDelta.isNotEmpty ||
+      _pendingDocumentDbDelta.isNotEmpty ||
+      _pendingSecondaryDbDelta.isNotEmpty ||
+      _pendingBusyDbDelta.isNotEmpty ||
+      _pendingSessions.isNotEmpty;
+
   Future<void> _flushDbDeltaIfNeeded() async {
     final now = DateTime.now();
-    if (now.difference(_lastDbFlushAt) < dbFlushInterval) {
+    final sinceLast = now.difference(_lastDbFlushAt);
+    if (sinceLast < dbFlushInterval) {
       return;
     }
+    AppMetrics.instance.dbFlushLag.recordDuration(sinceLast - dbFlushInterval);
     await _flushDbDelta();
   }
 
   Future<void> _flushDbDelta({bool force = false}) async {
     if (_isFlushingDb) {
+      AppMetrics.instance.increment('db_flush_skipped_busy');
       return;
     }
-    if (!force && _pendingDbDelta.isEmpty && _pendingHourlyDbDelta.isEmpty) {
+    if (!force && !_hasPendingDbDelta) {
       return;
     }
 
@@ -328,9 +870,26 @@ class UsageService {
     final toPersistHourly = Map<DateTime, Map<int, Map<String, Duration>>>.from(
       _pendingHourlyDbDelta,
     );
+    final toPersistDocuments =
+        Map<DateTime, Map<int, Map<String, Duration>>>.from(
+          _pendingDocumentDbDelta,
+        );
+    final toPersistSecondary =
+        Map<DateTime, Map<int, Map<String, Duration>>>.from(
+          _pendingSecondaryDbDelta,
+        );
+    final toPersistBusy = Map<DateTime, Map<int, Map<String, Duration>>>.from(
+      _pendingBusyDbDelta,
+    );
     _pendingDbDelta.clear();
     _pendingHourlyDbDelta.clear();
+    _pendingDocumentDbDelta.clear();
+    final toPersistSessions = List.of(_pendingSessions);
+    _pendingSecondaryDbDelta.clear();
+    _pendingBusyDbDelta.clear();
+    _pendingSessions.clear();
     _lastDbFlushAt = DateTime.now();
+    final watch = Stopwatch()..start();
     try {
       if (toPersistDaily.isNotEmpty) {
         // 记录日志方便排查
@@ -360,12 +919,35 @@ class UsageService {
         });
         await repository.mergeHourlyUsage(toPersistHourly);
       }
+
+      if (toPersistDocuments.isNotEmpty) {
+        await documentRepository?.mergeHourlyDocumentUsage(toPersistDocuments);
+      }
+
+      if (toPersistSecondary.isNotEmpty) {
+        await secondaryRepository?.mergeHourlySecondaryUsage(
+          toPersistSecondary,
+        );
+      }
+
+      if (toPersistBusy.isNotEmpty) {
+        await busyRepository?.mergeHourlyBusyUsage(toPersistBusy);
+      }
+
+      if (toPersistSessions.isNotEmpty) {
+        await sessionRepository?.insertSessions(toPersistSessions);
+      }
     } finally {
       _isFlushingDb = false;
+      AppMetrics.instance.dbFlush.recordDuration(watch.elapsed);
     }
   }
 }
 
+DateTime _normalizeDay(DateTime date) {
+  return DateTime(date.year, date.month, date.day);
+}
+
 /// 将 UsageAggregator 的毫秒级增量与现有的「余数」一起量化为整秒输出。
 ///
 /// - [rawDelta]: 本次聚合产生的增量（毫秒级）。
@@ -4,11 +4,21 @@ import 'package:flutter/material.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:ringotrack/app.dart';
 import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+import 'package:ringotrack/feature/dashboard/services/dashboard_snapshot_store.dart';
+import 'package:ringotrack/feature/dashboard/services/startup_timing.dart';
 import 'package:ringotrack/platform/glass_tint_controller.dart';
+import 'package:ringotrack/providers.dart';
 
 void main() async {
+  StartupTiming.markLaunch();
   WidgetsFlutterBinding.ensureInitialized();
 
+  // 上次运行留下的仪表盘快照：同步读取，首帧即可绘制，数据库随后校正。
+  final snapshotStore = DashboardSnapshotStore.defaultLocation();
+  final snapshot = DashboardSnapshotStore.disabledByEnvironment
+      ? null
+      : snapshotStore.loadSync();
+
   // Windows 平台：在启动时一次性决定是否启用玻璃效果。
   // 由于 Windows 上玻璃效果无法在运行时优雅地关闭，
   // 所以仅在启动时根据用户偏好来决定是否启用。
@@ -23,5 +33,13 @@ void main() async {
     // 窗口将保持默认的不透明背景。
   }
 
-  runApp(const ProviderScope(child: RingoTrackApp()));
+  runApp(
+    ProviderScope(
+      overrides: [
+        dashboardSnapshotStoreProvider.overrideWithValue(snapshotStore),
+        dashboardSnapshotSeedProvider.overrideWithValue(snapshot),
+      ],
+      child: const RingoTrackApp(),
+    ),
+  );
 }
@@ -1,11 +1,14 @@
 import 'dart:async';
-import 'dart:io' show Platform;
+import 'dart:io' show Platform, ProcessInfo;
 import 'dart:math' as math;
 
 import 'package:flutter/material.dart';
+import 'package:flutter/scheduler.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:flutter_screenutil/flutter_screenutil.dart';
 import 'package:go_router/go_router.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
 import 'package:ringotrack/providers.dart';
 import 'package:ringotrack/platform/window_pin_controller.dart';
 import 'package:ringotrack/platform/glass_tint_controller.dart';
@@ -25,6 +28,24 @@ class _ClockPageState extends ConsumerState<ClockPage> {
   bool _hudVisible = true;
   Timer? _hudHideTimer;
 
+  final _pinButtonKey = GlobalKey();
+  final _lockButtonKey = GlobalKey();
+  List<Rect>? _registeredRegions;
+  Color? _appliedTint;
+
+  late final PinnedClockMode _pinnedMode;
+
+  // 置顶期间的帧数与进入时的常驻内存，退出时写入日志与 AppMetrics。
+  DateTime? _pinnedSince;
+  int _pinnedFrames = 0;
+  int _pinnedRssAtEnter = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _pinnedMode = ref.read(pinnedClockModeProvider.notifier);
+  }
+
   @override
   void didChangeDependencies() {
     super.didChangeDependencies();
@@ -36,6 +57,12 @@ class _ClockPageState extends ConsumerState<ClockPage> {
     // 离开页面时恢复默认白色 tint（macOS/Windows 都支持更新 tint 颜色）
     GlassTintController.instance.resetTintColor();
     _hudHideTimer?.cancel();
+    if (_isMiniMode) {
+      _stopPinnedMeasurement();
+      // 卸载过程中不能修改 provider，推迟到下一个微任务。
+      final pinnedMode = _pinnedMode;
+      Future.microtask(() => pinnedMode.set(false));
+    }
     super.dispose();
   }
 
@@ -49,9 +76,51 @@ class _ClockPageState extends ConsumerState<ClockPage> {
       theme.colorScheme.primary,
     ).withSaturation(0.6).withLightness(0.6).toColor();
 
+    // 依赖变化（窗口缩放、置顶切换）时颜色通常没变，省掉一次平台调用。
+    if (clockBgColor == _appliedTint) return;
+    _appliedTint = clockBgColor;
     GlassTintController.instance.setTintColor(clockBgColor);
   }
 
+  void _resetGlassTint() {
+    _appliedTint = null;
+    GlassTintController.instance.resetTintColor();
+  }
+
+  void _setPinned(bool pinned) {
+    if (pinned) {
+      _pinnedSince = DateTime.now();
+      _pinnedFrames = 0;
+      _pinnedRssAtEnter = ProcessInfo.currentRss;
+      SchedulerBinding.instance.addTimingsCallback(_countPinnedFrames);
+    } else {
+      _stopPinnedMeasurement();
+    }
+    _pinnedMode.set(pinned);
+  }
+
+  void _countPinnedFrames(List<FrameTiming> timings) {
+    _pinnedFrames += timings.length;
+  }
+
+  void _stopPinnedMeasurement() {
+    final since = _pinnedSince;
+    if (since == null) return;
+    _pinnedSince = null;
+    SchedulerBinding.instance.removeTimingsCallback(_countPinnedFrames);
+
+    final seconds = DateTime.now().difference(since).inSeconds;
+    AppMetrics.instance
+      ..increment('pinned_clock_seconds', seconds)
+      ..increment('pinned_clock_frames', _pinnedFrames);
+    String mb(int bytes) => (bytes / (1 << 20)).toStringAsFixed(1);
+    AppLogService.instance.logInfo(
+      'clock',
+      'pinned ${seconds}s, frames=$_pinnedFrames, '
+          'rss ${mb(_pinnedRssAtEnter)}MB -> ${mb(ProcessInfo.currentRss)}MB',
+    );
+  }
+
   Future<void> _toggleMiniMode() async {
     if (_isTogglingMiniMode) {
       return;
@@ -90,6 +159,45 @@ class _ClockPageState extends ConsumerState<ClockPage> {
         _isMiniMode = !_isMiniMode;
       }
     });
+    if (success) {
+      _setPinned(_isMiniMode);
+    }
+    if (success && !_isMiniMode && _registeredRegions != null) {
+      _registeredRegions = null;
+      controller.setInteractiveRegions(null, MediaQuery.sizeOf(context));
+    }
+  }
+
+  /// 迷你模式下把 pin / lock 按钮的实际位置登记为可点击区域，窗口其余
+  /// 部分用于拖动。HUD 隐藏时按钮不在树上，沿用上一次登记的区域。
+  void _syncInteractiveRegions() {
+    if (!mounted || !_isMiniMode || !Platform.isWindows) {
+      return;
+    }
+    final pinRect = _globalRectOf(_pinButtonKey);
+    final lockRect = _globalRectOf(_lockButtonKey);
+    if (pinRect == null || lockRect == null) {
+      return;
+    }
+    final regions = [pinRect, lockRect];
+    if (listEquals(regions, _registeredRegions)) {
+      return;
+    }
+    final ok = WindowPinController.instance.setInteractiveRegions(
+      regions,
+      MediaQuery.sizeOf(context),
+    );
+    if (ok) {
+      _registeredRegions = regions;
+    }
+  }
+
+  Rect? _globalRectOf(GlobalKey key) {
+    final box = key.currentContext?.findRenderObject() as RenderBox?;
+    if (box == null || !box.hasSize) {
+      return null;
+    }
+    return box.localToGlobal(Offset.zero) & box.size;
   }
 
   Future<void> _toggleLock() async {
@@ -173,6 +281,12 @@ class _ClockPageState extends ConsumerState<ClockPage> {
     final pinSupported = WindowPinController.instance.isSupported;
     final useGlass = ref.watch(useGlassEffectProvider);
 
+    if (_isMiniMode) {
+      WidgetsBinding.instance.addPostFrameCallback(
+        (_) => _syncInteractiveRegions(),
+      );
+    }
+
     // 监听毛玻璃设置变化（仅 macOS，Windows 不支持实时开/关）
     if (Platform.isMacOS) {
       ref.listen(useGlassEffectProvider, (previous, next) {
@@ -183,7 +297,7 @@ class _ClockPageState extends ConsumerState<ClockPage> {
               _updateGlassTint();
             } else {
               // 关闭毛玻璃：恢复默认白色 tint
-              GlassTintController.instance.resetTintColor();
+              _resetGlassTint();
             }
           });
         }
@@ -243,6 +357,7 @@ class _ClockPageState extends ConsumerState<ClockPage> {
                       Visibility(
                         visible: _hudVisible,
                         child: IconButton(
+                          key: _pinButtonKey,
                           iconSize: _isMiniMode ? 16 : 24,
                           padding: EdgeInsets.all(8.w),
                           constraints: BoxConstraints(
@@ -276,6 +391,7 @@ class _ClockPageState extends ConsumerState<ClockPage> {
                       child: Visibility(
                         visible: _hudVisible,
                         child: IconButton(
+                          key: _lockButtonKey,
                           iconSize: 16,
                           padding: EdgeInsets.all(8.w),
                           constraints: BoxConstraints(
@@ -306,20 +422,13 @@ class _ClockPageState extends ConsumerState<ClockPage> {
     ThemeData theme,
     TextStyle? timeTextStyle,
   ) {
-    final metricsAsync = ref.watch(dashboardMetricsProvider);
-
-    return metricsAsync.when(
-      data: (metrics) {
-        return _buildTimeRow(theme, timeTextStyle, metrics.today);
-      },
-      loading: () {
-        return _buildTimeRow(theme, timeTextStyle, Duration.zero);
-      },
-      error: (err, _) {
-        debugPrint('ClockPage metrics error: $err');
-        return _buildTimeRow(theme, timeTextStyle, Duration.zero);
-      },
+    // 只订阅实时状态里的今日合计：它按整秒变化，前台应用切换等其它字段
+    // 的变化不会触发重建；也不依赖仪表盘的全年数据。
+    final today = ref.watch(
+      liveStatusProvider.select((status) => status.value?.todayTotal),
     );
+
+    return _buildTimeRow(theme, timeTextStyle, today ?? Duration.zero);
   }
 
   Widget _buildTimeRow(
@@ -336,19 +445,36 @@ class _ClockPageState extends ConsumerState<ClockPage> {
     final minutesText = minutes.toString().padLeft(2, '0');
     final secondsText = seconds.toString().padLeft(2, '0');
 
+    // 迷你模式不做翻页动画：每秒只画一帧，而不是 420ms 的连续动画帧。
+    final animate = !_isMiniMode;
+
     return Center(
-      child: FittedBox(
-        fit: BoxFit.contain,
-        child: Row(
-          mainAxisAlignment: MainAxisAlignment.center,
-          crossAxisAlignment: CrossAxisAlignment.center,
-          children: [
-            _FlipBlock(value: hoursText, textStyle: timeTextStyle),
-            SizedBox(width: 18.w),
-            _FlipBlock(value: minutesText, textStyle: timeTextStyle),
-            SizedBox(width: 18.w),
-            _FlipBlock(value: secondsText, textStyle: timeTextStyle),
-          ],
+      child: RepaintBoundary(
+        child: FittedBox(
+          fit: BoxFit.contain,
+          child: Row(
+            mainAxisAlignment: MainAxisAlignment.center,
+            crossAxisAlignment: CrossAxisAlignment.center,
+            children: [
+              _FlipBlock(
+                value: hoursText,
+                textStyle: timeTextStyle,
+                animate: animate,
+              ),
+              SizedBox(width: 18.w),
+              _FlipBlock(
+                value: minutesText,
+                textStyle: timeTextStyle,
+                animate: animate,
+              ),
+              SizedBox(width: 18.w),
+              _FlipBlock(
+                value: secondsText,
+                textStyle: timeTextStyle,
+                animate: animate,
+              ),
+            ],
+          ),
         ),
       ),
     );
@@ -356,10 +482,15 @@ class _ClockPageState extends ConsumerState<ClockPage> {
 }
 
 class _FlipBlock extends StatelessWidget {
-  const _FlipBlock({required this.value, required this.textStyle});
+  const _FlipBlock({
+    required this.value,
+    required this.textStyle,
+    this.animate = true,
+  });
 
   final String value;
   final TextStyle? textStyle;
+  final bool animate;
 
   @override
   Widget build(BuildContext context) {
@@ -371,6 +502,18 @@ class _FlipBlock extends StatelessWidget {
         .withLightness((baseHsl.lightness * 0.9).clamp(0.0, 1.0));
     final cardColor = cardHsl.toColor();
     final key = ValueKey<String>(value);
+    final card = Container(
+      key: key,
+      padding: EdgeInsets.symmetric(vertical: 28.h, horizontal: 40.w),
+      decoration: BoxDecoration(
+        color: cardColor,
+        borderRadius: BorderRadius.circular(28.r),
+      ),
+      child: Text(value, style: textStyle),
+    );
+    if (!animate) {
+      return card;
+    }
 
     return AnimatedSwitcher(
       duration: const Duration(milliseconds: 420),
@@ -395,15 +538,7 @@ class _FlipBlock extends StatelessWidget {
           },
         );
       },
-      child: Container(
-        key: key,
-        padding: EdgeInsets.symmetric(vertical: 28.h, horizontal: 40.w),
-        decoration: BoxDecoration(
-          color: cardColor,
-          borderRadius: BorderRadius.circular(28.r),
-        ),
-        child: Text(value, style: textStyle),
-      ),
+      child: card,
     );
   }
 }
@@ -4,6 +4,10 @@ import 'package:flutter_screenutil/flutter_screenutil.dart';
 import 'package:go_router/go_router.dart';
 import 'package:ringotrack/feature/settings/drawing_app/controllers/drawing_app_preferences_controller.dart';
 
+import 'package:ringotrack/feature/dashboard/services/startup_timing.dart';
+import 'package:ringotrack/feature/usage/models/usage_timeline.dart';
+import 'package:ringotrack/feature/usage/repositories/compact_usage_repository.dart';
+import 'package:ringotrack/feature/usage/repositories/demo_usage_repository.dart';
 import 'package:ringotrack/feature/usage/services/usage_analysis.dart';
 import 'package:ringotrack/providers.dart';
 import 'package:fl_chart/fl_chart.dart';
@@ -43,19 +47,37 @@ final hourlySelectedDayProvider = NotifierProvider<HourlySelectedDay, DateTime>(
 final hourlyUsageByDayProvider = StreamProvider.autoDispose
     .family<Map<int, Map<String, Duration>>, DateTime>((ref, day) async* {
       final repo = ref.watch(usageRepositoryProvider);
+      // 全量记录模式在查询时过滤，追踪列表变化后需要重新加载。
+      if (repo is CompactUsageRepository) {
+        ref.watch(drawingAppFilterProvider);
+      }
       final service = ref.watch(usageServiceProvider);
       final normalizedDay = _normalizeDayDashboard(day);
 
+      // 只为今天维护快照；演示数据不参与。
+      final useSnapshot =
+          repo is! DemoUsageRepository &&
+          normalizedDay == _normalizeDayDashboard(DateTime.now());
+      final writer = useSnapshot
+          ? ref.watch(dashboardSnapshotWriterProvider)
+          : null;
+      final fromSnapshot = useSnapshot
+          ? ref.read(dashboardSnapshotProvider)?.hourlyFor(normalizedDay)
+          : null;
+      if (fromSnapshot != null) {
+        yield fromSnapshot;
+      }
+
       // 初始：从数据库加载该日的小时级用时分布
       final initial = await repo.loadHourlyRange(normalizedDay, normalizedDay);
       final initialForDay =
           initial[normalizedDay] ?? const <int, Map<String, Duration>>{};
 
-      Map<int, Map<String, Duration>> current = initialForDay.map(
-        (hour, perApp) => MapEntry(hour, Map<String, Duration>.from(perApp)),
-      );
+      // 只读版本：后续合并只替换被修改的小时，其余小时与上一版本共享
+      var current = mergeHourlyDelta(const {}, initialForDay);
 
       yield current;
+      writer?.updateHourly(normalizedDay, current);
 
       // 后续：监听 UsageService 的小时级增量流，增量合并到当日数据
       await for (final delta in service.hourlyDeltaStream) {
@@ -64,17 +86,9 @@ final hourlyUsageByDayProvider = StreamProvider.autoDispose
           continue;
         }
 
-        dayDelta.forEach((hour, perAppDelta) {
-          final perApp = current.putIfAbsent(hour, () => <String, Duration>{});
-          perAppDelta.forEach((appId, duration) {
-            perApp[appId] = (perApp[appId] ?? Duration.zero) + duration;
-          });
-        });
-
-        // 输出一份深拷贝，避免外部修改内部状态
-        yield current.map(
-          (hour, perApp) => MapEntry(hour, Map<String, Duration>.from(perApp)),
-        );
+        current = mergeHourlyDelta(current, dayDelta);
+        yield current;
+        writer?.updateHourly(normalizedDay, current);
       }
     });
 
@@ -100,6 +114,12 @@ class _DashboardPageState extends ConsumerState<DashboardPage> {
 
   @override
   Widget build(BuildContext context) {
+    // 时钟置顶时仪表盘压在路由栈下方不可见：不构建内容，让年度数据、指标
+    // 与图表的 autoDispose provider 释放，迷你时钟只保留实时状态订阅。
+    if (ref.watch(pinnedClockModeProvider)) {
+      return const SizedBox.shrink();
+    }
+
     final theme = Theme.of(context);
     final range = ref.watch(heatmapRangeProvider);
     final start = range.start;
@@ -108,6 +128,9 @@ class _DashboardPageState extends ConsumerState<DashboardPage> {
     final asyncUsage = ref.watch(yearlyUsageByDateProvider);
     final metricsAsync = ref.watch(dashboardMetricsProvider);
     final useGlass = ref.watch(useGlassEffectProvider);
+    if (asyncUsage.hasValue && metricsAsync.hasValue) {
+      StartupTiming.reportFirstMeaningfulFrame();
+    }
 
     return Scaffold(
       backgroundColor: useGlass ? Colors.transparent : Colors.grey[100],
@@ -887,14 +910,16 @@ class _DashboardPageState extends ConsumerState<DashboardPage> {
                   weekRangeStart = analysisStart;
                 }
 
-                final analysis = UsageAnalysis(usageByDate);
-                final daily = analysis.dailyTotals(last30Start, windowEnd);
-                final weekly = analysis.weeklyTotals(weekRangeStart, windowEnd);
-                final perApp = analysis.appTotals(last30Start, windowEnd);
-                final weekdayAvg = analysis.weekdayAverages(
+                // 四个图表共用一次列式扫描。
+                final summary = UsageAnalysis(usageByDate).summarize(
                   last30Start,
                   windowEnd,
+                  weeklyStart: weekRangeStart,
                 );
+                final daily = summary.daily;
+                final weekly = summary.weekly;
+                final perApp = summary.appTotals;
+                final weekdayAvg = summary.weekdayAverages;
 
                 return ListView(
                   key: const PageStorageKey('dashboard-analysis-list'),
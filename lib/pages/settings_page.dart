@@ -5,6 +5,10 @@ import 'package:flutter_screenutil/flutter_screenutil.dart';
 import 'package:go_router/go_router.dart';
 import 'package:ringotrack/feature/settings/drawing_app/models/drawing_app_preferences.dart';
 import 'package:ringotrack/feature/settings/drawing_app/controllers/drawing_app_preferences_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/keyboard_activity_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/record_all_apps_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/process_activity_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/secondary_visible_controller.dart';
 import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
 
 import 'package:ringotrack/providers.dart';
@@ -228,6 +232,10 @@ class _SettingsPageState extends ConsumerState<SettingsPage> {
           ],
         ),
       ),
+      _recordAllAppsTile(theme),
+      if (Platform.isWindows) _keyboardActivityTile(theme),
+      if (Platform.isWindows) _secondaryVisibleTile(theme),
+      if (Platform.isWindows) _processActivityTile(theme),
     ];
 
     return _sectionCard(
@@ -241,6 +249,100 @@ class _SettingsPageState extends ConsumerState<SettingsPage> {
     );
   }
 
+  Widget _recordAllAppsTile(ThemeData theme) {
+    final enabled = ref.watch(recordAllAppsControllerProvider).value ?? false;
+    return _dataTile(
+      theme,
+      title: '记录所有前台应用',
+      helper: '开启后所有前台应用都会记录，之后再加入追踪列表的软件也能看到历史时长。',
+      child: Row(
+        children: [
+          Switch(
+            value: enabled,
+            onChanged: (value) {
+              ref
+                  .read(recordAllAppsControllerProvider.notifier)
+                  .setEnabled(value);
+            },
+          ),
+          SizedBox(width: 8.w),
+          Text(enabled ? '已启用' : '已关闭', style: theme.textTheme.bodyMedium),
+        ],
+      ),
+    );
+  }
+
+  Widget _keyboardActivityTile(ThemeData theme) {
+    final enabled =
+        ref.watch(keyboardActivityControllerProvider).value ?? false;
+    return _dataTile(
+      theme,
+      title: '按键也算作活动',
+      helper: '用快捷键平移、缩放或切换工具时不会被判定为离开。只记录按键发生的时间，不记录按了什么键。',
+      child: Row(
+        children: [
+          Switch(
+            value: enabled,
+            onChanged: (value) {
+              ref
+                  .read(keyboardActivityControllerProvider.notifier)
+                  .setEnabled(value);
+            },
+          ),
+          SizedBox(width: 8.w),
+          Text(enabled ? '已启用' : '已关闭', style: theme.textTheme.bodyMedium),
+        ],
+      ),
+    );
+  }
+
+  Widget _secondaryVisibleTile(ThemeData theme) {
+    final enabled =
+        ref.watch(secondaryVisibleControllerProvider).value ?? false;
+    return _dataTile(
+      theme,
+      title: '记录副屏可见时长',
+      helper: '在另一块屏幕上开着参考图或第二个画布时，单独记录它可见的时长，不计入前台使用时长。',
+      child: Row(
+        children: [
+          Switch(
+            value: enabled,
+            onChanged: (value) {
+              ref
+                  .read(secondaryVisibleControllerProvider.notifier)
+                  .setEnabled(value);
+            },
+          ),
+          SizedBox(width: 8.w),
+          Text(enabled ? '已启用' : '已关闭', style: theme.textTheme.bodyMedium),
+        ],
+      ),
+    );
+  }
+
+  Widget _processActivityTile(ThemeData theme) {
+    final enabled = ref.watch(processActivityControllerProvider).value ?? false;
+    return _dataTile(
+      theme,
+      title: '记录后台忙碌时长',
+      helper: '离开键鼠时若软件仍在运行滤镜、导出或渲染，单独记录这段忙碌时长，不计入使用时长。只读取前台软件的 CPU 占用。',
+      child: Row(
+        children: [
+          Switch(
+            value: enabled,
+            onChanged: (value) {
+              ref
+                  .read(processActivityControllerProvider.notifier)
+                  .setEnabled(value);
+            },
+          ),
+          SizedBox(width: 8.w),
+          Text(enabled ? '已启用' : '已关闭', style: theme.textTheme.bodyMedium),
+        ],
+      ),
+    );
+  }
+
   Widget _dataSection(
     ThemeData theme,
     AsyncValue<DrawingAppPreferences> prefsAsync,
@@ -873,6 +975,7 @@ class _SettingsPageState extends ConsumerState<SettingsPage> {
       await repo.deleteByAppId(id.value);
     }
     ref.invalidate(yearlyUsageByDateProvider);
+    ref.read(usageQueryServerProvider).value?.cache.invalidate();
     _showSnack('已删除 ${app.displayName} 的所有数据');
   }
 
@@ -885,6 +988,7 @@ class _SettingsPageState extends ConsumerState<SettingsPage> {
     final repo = ref.read(usageRepositoryProvider);
     await repo.deleteByDateRange(_rangeStart!, _rangeEnd!);
     ref.invalidate(yearlyUsageByDateProvider);
+    ref.read(usageQueryServerProvider).value?.cache.invalidate();
     _showSnack(
       '已删除 ${_formatDate(_rangeStart)} 至 ${_formatDate(_rangeEnd)} 的数据',
     );
@@ -916,6 +1020,7 @@ class _SettingsPageState extends ConsumerState<SettingsPage> {
     final repo = ref.read(usageRepositoryProvider);
     await repo.clearAll();
     ref.invalidate(yearlyUsageByDateProvider);
+    ref.read(usageQueryServerProvider).value?.cache.invalidate();
     _showSnack('所有数据已清空');
   }
 
@@ -5,6 +5,7 @@ import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
 import 'package:ringotrack/feature/logging/services/app_log_service.dart';
 import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
 
 /// 统一的前台应用切换事件跟踪接口
 abstract class ForegroundAppTracker {
@@ -110,6 +111,15 @@ final class _RtForegroundAppInfo extends ffi.Struct {
 
   @ffi.Array.multi([260])
   external ffi.Array<ffi.Uint16> windowTitle;
+
+  @ffi.Uint32()
+  external int documentId;
+
+  @ffi.Array.multi([260])
+  external ffi.Array<ffi.Uint16> document;
+
+  @ffi.Uint64()
+  external int changedMillis;
 }
 
 typedef _RtGetForegroundAppNative =
@@ -124,12 +134,15 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
   final _RtGetForegroundAppDart? _rtGetForegroundApp;
 
   final _controller = StreamController<ForegroundAppEvent>.broadcast();
-  Timer? _timer;
+  final TickScheduler _scheduler;
 
   String? _lastAppId;
   int? _lastPid;
+  int _lastDocumentId = 0;
+  int _lastPollMillis = 0;
 
-  _WindowsForegroundAppTracker() : _rtGetForegroundApp = _loadNativeFunction() {
+  _WindowsForegroundAppTracker(this._scheduler)
+    : _rtGetForegroundApp = _loadNativeFunction() {
     if (kDebugMode) {
       debugPrint('[ForegroundAppTracker] using Windows implementation');
     }
@@ -142,7 +155,7 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
       return;
     }
 
-    _startPolling();
+    _scheduler.addPoller(_pollOnce);
   }
 
   static _RtGetForegroundAppDart? _loadNativeFunction() {
@@ -169,14 +182,6 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
   @override
   Stream<ForegroundAppEvent> get events => _controller.stream;
 
-  void _startPolling() {
-    const interval = Duration(seconds: 1);
-    _timer?.cancel();
-    _timer = Timer.periodic(interval, (_) {
-      _pollOnce();
-    });
-  }
-
   void _pollOnce() {
     final rtGetForegroundApp = _rtGetForegroundApp;
     if (rtGetForegroundApp == null) {
@@ -195,8 +200,11 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
       }
 
       final info = ptr.ref;
+      final polledMillis = info.timestampMillis;
+      final previousPollMillis = _lastPollMillis;
+      _lastPollMillis = polledMillis;
       final timestamp = DateTime.fromMillisecondsSinceEpoch(
-        info.timestampMillis,
+        polledMillis,
         isUtc: false,
       );
 
@@ -218,20 +226,36 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
         return;
       }
 
-      if (_lastAppId == appId && _lastPid == pid) {
-        // 前台应用未变化，不产生新的事件，避免噪音。
+      // 文档 ID 由 native 侧在标题变化时驻留，比较整数即可判断是否切换了画布。
+      final documentId = info.documentId;
+      if (_lastAppId == appId &&
+          _lastPid == pid &&
+          _lastDocumentId == documentId) {
+        // 前台应用与文档均未变化，不产生新的事件，避免噪音。
         return;
       }
 
       _lastAppId = appId;
       _lastPid = pid;
-
-      final event = ForegroundAppEvent(appId: appId, timestamp: timestamp);
+      _lastDocumentId = documentId;
+
+      final document = documentId == 0
+          ? null
+          : _utf16ArrayToString(info.document);
+      final event = ForegroundAppEvent(
+        appId: appId,
+        timestamp: _switchTime(
+          info.changedMillis,
+          previousPollMillis,
+          polledMillis,
+        ),
+        document: document,
+      );
       _controller.add(event);
 
       AppLogService.instance.logInfo(
         _logTag,
-        'foreground changed -> appId=$appId pid=$pid',
+        'foreground changed -> appId=$appId pid=$pid document=$document',
       );
     } catch (e, st) {
       AppLogService.instance.logError(_logTag, 'poll error: $e\n$st');
@@ -241,9 +265,22 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
     }
   }
 
+  /// 轮询间隔随节拍档位变长后，用 native 记录的切换时刻作为事件时间；
+  /// 夹在上一次与本次轮询之间，保证不早于上一个事件（聚合器不重叠）。
+  DateTime _switchTime(
+    int changedMillis,
+    int previousMillis,
+    int polledMillis,
+  ) {
+    var millis = changedMillis == 0 ? polledMillis : changedMillis;
+    if (millis < previousMillis) millis = previousMillis;
+    if (millis > polledMillis) millis = polledMillis;
+    return DateTime.fromMillisecondsSinceEpoch(millis, isUtc: false);
+  }
+
   @override
   void dispose() {
-    _timer?.cancel();
+    _scheduler.removePoller(_pollOnce);
     _controller.close();
   }
 
@@ -270,7 +307,10 @@ class _WindowsForegroundAppTracker implements ForegroundAppTracker {
   }
 }
 
-ForegroundAppTracker createForegroundAppTracker() {
+/// Windows 实现挂在 [scheduler] 上轮询，与其它轮询源共用同一次唤醒。
+ForegroundAppTracker createForegroundAppTracker({
+  required TickScheduler scheduler,
+}) {
   if (kDebugMode) {
     debugPrint(
       '[ForegroundAppTracker] createForegroundAppTracker: '
@@ -287,7 +327,7 @@ ForegroundAppTracker createForegroundAppTracker() {
   }
 
   if (Platform.isWindows) {
-    return _WindowsForegroundAppTracker();
+    return _WindowsForegroundAppTracker(scheduler);
   }
 
   if (kDebugMode) {
@@ -0,0 +1,108 @@
+import 'dart:async';
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+
+typedef _RtInitKeyboardHookNative = ffi.Void Function();
+typedef _RtInitKeyboardHookDart = void Function();
+typedef _RtGetLastKeyActivityMillisNative = ffi.Uint64 Function();
+typedef _RtGetLastKeyActivityMillisDart = int Function();
+typedef _RtShutdownKeyboardHookNative = ffi.Void Function();
+typedef _RtShutdownKeyboardHookDart = void Function();
+
+/// 按键活动来源：只报告「有按键发生」的时间，不含任何按键内容。
+///
+/// 用作 AFK 判定的辅助来源，让主要靠快捷键平移 / 缩放 / 切换工具的
+/// 操作不被判定为离开。默认关闭，在设置中开启。
+abstract class KeyboardActivityTracker {
+  /// 每次观察到新的按键活动时发出其时间；同一轮询周期内的多次按键只发一次。
+  Stream<DateTime> get activity;
+
+  void dispose();
+}
+
+class _NoopKeyboardActivityTracker implements KeyboardActivityTracker {
+  @override
+  Stream<DateTime> get activity => const Stream<DateTime>.empty();
+
+  @override
+  void dispose() {}
+}
+
+/// Windows：WH_KEYBOARD_LL 回调只写入最近一次按键的时间，这里随共享节拍轮询。
+class _WindowsKeyboardActivityTracker implements KeyboardActivityTracker {
+  _WindowsKeyboardActivityTracker._(
+    this._scheduler,
+    this._getLastMillis,
+    this._shutdown,
+  ) {
+    _scheduler.addPoller(_pollOnce);
+  }
+
+  static const _logTag = 'keyboard_tracker_windows';
+
+  final TickScheduler _scheduler;
+  final _RtGetLastKeyActivityMillisDart _getLastMillis;
+  final _RtShutdownKeyboardHookDart _shutdown;
+  final _controller = StreamController<DateTime>.broadcast();
+  int _lastSeenMillis = 0;
+
+  static KeyboardActivityTracker create(TickScheduler scheduler) {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final initFn = lib
+          .lookupFunction<_RtInitKeyboardHookNative, _RtInitKeyboardHookDart>(
+            'rt_init_keyboard_hook',
+          );
+      final getFn = lib
+          .lookupFunction<
+            _RtGetLastKeyActivityMillisNative,
+            _RtGetLastKeyActivityMillisDart
+          >('rt_get_last_key_activity_millis');
+      final shutdownFn = lib
+          .lookupFunction<
+            _RtShutdownKeyboardHookNative,
+            _RtShutdownKeyboardHookDart
+          >('rt_shutdown_keyboard_hook');
+      initFn();
+      return _WindowsKeyboardActivityTracker._(scheduler, getFn, shutdownFn);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup keyboard hook functions failed: $e\n$st',
+      );
+      return _NoopKeyboardActivityTracker();
+    }
+  }
+
+  @override
+  Stream<DateTime> get activity => _controller.stream;
+
+  void _pollOnce() {
+    final millis = _getLastMillis();
+    if (millis == 0 || millis == _lastSeenMillis) return;
+    _lastSeenMillis = millis;
+    _controller.add(DateTime.fromMillisecondsSinceEpoch(millis));
+  }
+
+  @override
+  void dispose() {
+    _scheduler.removePoller(_pollOnce);
+    _shutdown();
+    _controller.close();
+  }
+}
+
+/// macOS 监听全局按键需要「输入监控」权限，暂不提供；其他平台同样为空实现。
+KeyboardActivityTracker createKeyboardActivityTracker({
+  required TickScheduler scheduler,
+}) {
+  if (kIsWeb) return _NoopKeyboardActivityTracker();
+  if (Platform.isWindows) {
+    return _WindowsKeyboardActivityTracker.create(scheduler);
+  }
+  return _NoopKeyboardActivityTracker();
+}
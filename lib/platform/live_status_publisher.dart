@@ -0,0 +1,119 @@
+import 'dart:convert';
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/usage/models/live_status.dart';
+
+export 'package:ringotrack/feature/usage/models/live_status.dart';
+
+/// 把实时状态发布给本机其它进程（直播叠加层、状态栏等）。
+///
+/// Windows 下写入 native 侧维护的 seqlock 共享内存段
+/// `Local\ringotrack.live_status`，读者无需任何 IPC 往返。
+abstract class LiveStatusPublisher {
+  void publish(LiveStatus status);
+
+  void dispose();
+}
+
+class _NoopLiveStatusPublisher implements LiveStatusPublisher {
+  @override
+  void publish(LiveStatus status) {}
+
+  @override
+  void dispose() {}
+}
+
+// 与 Windows C 侧 RtLiveStatusInput 对齐的 FFI 结构体
+final class _RtLiveStatusInput extends ffi.Struct {
+  @ffi.Int64()
+  external int sessionStartMillis;
+
+  @ffi.Int64()
+  external int todayTotalMillis;
+
+  @ffi.Int32()
+  external int isIdle;
+
+  @ffi.Int32()
+  external int isTracking;
+
+  @ffi.Array.multi([_appIdCapacity])
+  external ffi.Array<ffi.Uint8> appId;
+}
+
+const _appIdCapacity = 128;
+
+typedef _RtLiveStatusInputNative = ffi.Pointer<_RtLiveStatusInput> Function();
+typedef _RtLiveStatusInputDart = ffi.Pointer<_RtLiveStatusInput> Function();
+typedef _RtPublishLiveStatusNative = ffi.Int32 Function();
+typedef _RtPublishLiveStatusDart = int Function();
+
+class _WindowsLiveStatusPublisher implements LiveStatusPublisher {
+  _WindowsLiveStatusPublisher._(this._input, this._publish);
+
+  static const _logTag = 'live_status_windows';
+
+  final ffi.Pointer<_RtLiveStatusInput> _input;
+  final _RtPublishLiveStatusDart _publish;
+  bool _failureLogged = false;
+
+  static LiveStatusPublisher create() {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final inputFn = lib
+          .lookupFunction<_RtLiveStatusInputNative, _RtLiveStatusInputDart>(
+            'rt_live_status_input',
+          );
+      final publishFn = lib
+          .lookupFunction<_RtPublishLiveStatusNative, _RtPublishLiveStatusDart>(
+            'rt_publish_live_status',
+          );
+      return _WindowsLiveStatusPublisher._(inputFn(), publishFn);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup live status functions failed: $e\n$st',
+      );
+      return _NoopLiveStatusPublisher();
+    }
+  }
+
+  @override
+  void publish(LiveStatus status) {
+    final input = _input.ref;
+    input.sessionStartMillis = status.sessionStart?.millisecondsSinceEpoch ?? 0;
+    input.todayTotalMillis = status.todayTotal.inMilliseconds;
+    input.isIdle = status.isIdle ? 1 : 0;
+    input.isTracking = status.isTracking ? 1 : 0;
+
+    final bytes = utf8.encode(status.appId ?? '');
+    final length = bytes.length < _appIdCapacity
+        ? bytes.length
+        : _appIdCapacity - 1;
+    for (var i = 0; i < length; i++) {
+      input.appId[i] = bytes[i];
+    }
+    input.appId[length] = 0;
+
+    if (_publish() == 0 && !_failureLogged) {
+      _failureLogged = true;
+      AppLogService.instance.logWarn(
+        _logTag,
+        'shared memory segment unavailable; live status disabled',
+      );
+    }
+  }
+
+  @override
+  void dispose() {}
+}
+
+LiveStatusPublisher createLiveStatusPublisher() {
+  if (!kIsWeb && Platform.isWindows) {
+    return _WindowsLiveStatusPublisher.create();
+  }
+  return _NoopLiveStatusPublisher();
+}
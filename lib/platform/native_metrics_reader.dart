@@ -0,0 +1,167 @@
+import 'dart:ffi' as ffi;
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
+
+/// native `ringotrack::MetricsSnapshot` 的解码结果。
+class NativeMetricsSnapshot {
+  NativeMetricsSnapshot({required this.counters, required this.histograms});
+
+  /// 与 native `CounterId` 顺序一致；native 侧新增的项以 `counter_<下标>` 命名。
+  static const counterNames = [
+    'foreground_queries',
+    'no_foreground_window',
+    'open_process_failures',
+    'query_path_failures',
+    'mouse_hook_events',
+    'session_events_drained',
+    'session_events_dropped',
+  ];
+
+  /// 与 native `HistogramId` 顺序一致。
+  static const histogramNames = [
+    'foreground_query',
+    'mouse_hook',
+    'session_drain',
+    'process_sample',
+  ];
+
+  static const supportedVersion = 1;
+  static const _headerBytes = 16;
+
+  final Map<String, int> counters;
+  final Map<String, HistogramSnapshot> histograms;
+
+  /// 按头部记录的各段长度解码；版本或桶布局不匹配时返回 null。
+  static NativeMetricsSnapshot? decode(ByteData data) {
+    if (data.lengthInBytes < _headerBytes) return null;
+    final version = data.getUint32(0, Endian.host);
+    final counterCount = data.getUint32(4, Endian.host);
+    final histogramCount = data.getUint32(8, Endian.host);
+    final bucketCount = data.getUint32(12, Endian.host);
+    if (version != supportedVersion ||
+        bucketCount != LatencyHistogram.bucketCount ||
+        data.lengthInBytes < byteLength(counterCount, histogramCount)) {
+      return null;
+    }
+
+    var offset = _headerBytes;
+    int next() {
+      final value = data.getUint64(offset, Endian.host);
+      offset += 8;
+      return value;
+    }
+
+    final counters = <String, int>{};
+    for (var i = 0; i < counterCount; i++) {
+      counters[i < counterNames.length ? counterNames[i] : 'counter_$i'] =
+          next();
+    }
+    final histograms = <String, HistogramSnapshot>{};
+    for (var i = 0; i < histogramCount; i++) {
+      final count = next();
+      final sum = next();
+      final max = next();
+      final buckets = Uint64List(bucketCount);
+      for (var b = 0; b < bucketCount; b++) {
+        buckets[b] = next();
+      }
+      final name = i < histogramNames.length
+          ? histogramNames[i]
+          : 'histogram_$i';
+      histograms[name] = HistogramSnapshot(
+        count: count,
+        sum: sum,
+        max: max,
+        buckets: buckets,
+      );
+    }
+    return NativeMetricsSnapshot(counters: counters, histograms: histograms);
+  }
+
+  /// 给定计数器与直方图个数时整个结构体的字节数。
+  static int byteLength(int counterCount, int histogramCount) =>
+      _headerBytes +
+      8 * counterCount +
+      histogramCount * 8 * (3 + LatencyHistogram.bucketCount);
+
+  Map<String, Object> toJson() => {
+    'counters': counters,
+    'histograms': {
+      for (final entry in histograms.entries) entry.key: entry.value.toJson(),
+    },
+  };
+}
+
+/// 读取 native 热路径指标；不支持的平台返回 null。
+abstract class NativeMetricsReader {
+  NativeMetricsSnapshot? read();
+
+  void reset();
+}
+
+class _NoopNativeMetricsReader implements NativeMetricsReader {
+  @override
+  NativeMetricsSnapshot? read() => null;
+
+  @override
+  void reset() {}
+}
+
+typedef _RtReadMetricsNative = ffi.Pointer<ffi.Uint8> Function();
+typedef _RtReadMetricsDart = ffi.Pointer<ffi.Uint8> Function();
+typedef _RtResetMetricsNative = ffi.Void Function();
+typedef _RtResetMetricsDart = void Function();
+
+/// Windows：rt_read_metrics 返回 runner 内静态快照的指针，这里按头部
+/// 长度拷出字节后解码，调用期间不持有 native 内存。
+class _WindowsNativeMetricsReader implements NativeMetricsReader {
+  _WindowsNativeMetricsReader._(this._read, this._reset);
+
+  static const _logTag = 'native_metrics';
+
+  final _RtReadMetricsDart _read;
+  final _RtResetMetricsDart _reset;
+
+  static NativeMetricsReader create() {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final readFn = lib
+          .lookupFunction<_RtReadMetricsNative, _RtReadMetricsDart>(
+            'rt_read_metrics',
+          );
+      final resetFn = lib
+          .lookupFunction<_RtResetMetricsNative, _RtResetMetricsDart>(
+            'rt_reset_metrics',
+          );
+      return _WindowsNativeMetricsReader._(readFn, resetFn);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup metrics functions failed: $e\n$st',
+      );
+      return _NoopNativeMetricsReader();
+    }
+  }
+
+  @override
+  NativeMetricsSnapshot? read() {
+    final pointer = _read();
+    final header = pointer.cast<ffi.Uint32>();
+    final length = NativeMetricsSnapshot.byteLength(header[1], header[2]);
+    final bytes = Uint8List.fromList(pointer.asTypedList(length));
+    return NativeMetricsSnapshot.decode(ByteData.sublistView(bytes));
+  }
+
+  @override
+  void reset() => _reset();
+}
+
+NativeMetricsReader createNativeMetricsReader() {
+  if (kIsWeb) return _NoopNativeMetricsReader();
+  if (Platform.isWindows) return _WindowsNativeMetricsReader.create();
+  return _NoopNativeMetricsReader();
+}
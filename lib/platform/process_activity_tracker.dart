@@ -0,0 +1,127 @@
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+
+/// 前台进程某一时刻的 CPU 活动。
+class ProcessActivity {
+  const ProcessActivity({
+    required this.isBusy,
+    required this.cpuFraction,
+    this.busySince,
+  });
+
+  static const quiet = ProcessActivity(isBusy: false, cpuFraction: 0);
+
+  /// 处于持续占用 CPU 的「忙碌」区间（滤镜、导出、3D 渲染等）。
+  final bool isBusy;
+
+  /// 最近一个采样间隔的 CPU 占用，以单核为 1，多核并行时可以大于 1。
+  final double cpuFraction;
+
+  /// 进入忙碌的时刻；不忙时为 null。
+  final DateTime? busySince;
+}
+
+/// 前台进程活动来源：没有键鼠输入时，前台软件自身是否仍在工作。
+///
+/// 只是补充信号，不参与 AFK 判定；CPU 时间采样在 native 侧限频并缓存进程
+/// 句柄，[queryForeground] 可以每个 tick 调用。
+abstract class ProcessActivityTracker {
+  ProcessActivity queryForeground();
+
+  void dispose();
+}
+
+class _NoopProcessActivityTracker implements ProcessActivityTracker {
+  @override
+  ProcessActivity queryForeground() => ProcessActivity.quiet;
+
+  @override
+  void dispose() {}
+}
+
+// 与 Windows C 侧 RtProcessActivity 对齐的 FFI 结构体
+final class _RtProcessActivity extends ffi.Struct {
+  @ffi.Int64()
+  external int busySinceMillis;
+
+  @ffi.Uint32()
+  external int pid;
+
+  @ffi.Uint32()
+  external int cpuPermille;
+
+  @ffi.Int32()
+  external int isBusy;
+
+  @ffi.Uint32()
+  external int reserved;
+}
+
+typedef _RtQueryForegroundActivityNative =
+    ffi.Pointer<_RtProcessActivity> Function();
+typedef _RtQueryForegroundActivityDart =
+    ffi.Pointer<_RtProcessActivity> Function();
+typedef _RtResetForegroundActivityNative = ffi.Void Function();
+typedef _RtResetForegroundActivityDart = void Function();
+
+/// Windows：GetProcessTimes 读取前台进程的 CPU 时间，分类在 native 核心。
+class _WindowsProcessActivityTracker implements ProcessActivityTracker {
+  _WindowsProcessActivityTracker._(this._query, this._reset);
+
+  static const _logTag = 'process_activity_windows';
+
+  final _RtQueryForegroundActivityDart _query;
+  final _RtResetForegroundActivityDart _reset;
+
+  static ProcessActivityTracker create() {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final queryFn = lib
+          .lookupFunction<
+            _RtQueryForegroundActivityNative,
+            _RtQueryForegroundActivityDart
+          >('rt_query_foreground_activity');
+      final resetFn = lib
+          .lookupFunction<
+            _RtResetForegroundActivityNative,
+            _RtResetForegroundActivityDart
+          >('rt_reset_foreground_activity');
+      return _WindowsProcessActivityTracker._(queryFn, resetFn);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup process activity functions failed: $e\n$st',
+      );
+      return _NoopProcessActivityTracker();
+    }
+  }
+
+  @override
+  ProcessActivity queryForeground() {
+    final result = _query().ref;
+    final busy = result.isBusy != 0;
+    return ProcessActivity(
+      isBusy: busy,
+      cpuFraction: result.cpuPermille / 1000,
+      busySince: busy
+          ? DateTime.fromMillisecondsSinceEpoch(result.busySinceMillis)
+          : null,
+    );
+  }
+
+  @override
+  void dispose() {
+    _reset();
+  }
+}
+
+/// Linux 的 /proc 采样器在 native 核心中，但桌面端只有 Windows runner
+/// 导出了查询函数；其他平台为空实现。
+ProcessActivityTracker createProcessActivityTracker() {
+  if (kIsWeb) return _NoopProcessActivityTracker();
+  if (Platform.isWindows) return _WindowsProcessActivityTracker.create();
+  return _NoopProcessActivityTracker();
+}
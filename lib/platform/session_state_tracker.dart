@@ -0,0 +1,296 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+
+/// 会话锁定 / 系统休眠事件。
+enum SessionEventKind { locked, unlocked, suspend, resume }
+
+class SessionEvent {
+  SessionEvent({required this.kind, required this.timestamp});
+
+  final SessionEventKind kind;
+
+  /// 系统发出通知的时间，作为计时区间的精确边界。
+  final DateTime timestamp;
+}
+
+/// 锁屏 / 休眠 / 唤醒通知的统一接口。
+///
+/// Windows 的事件由 native 窗口过程记录到队列里，[poll] 同步取出并在
+/// [events] 上立即派发；UsageService 在每次 tick 前先 [poll]，
+/// 保证唤醒后的第一次 tick 看到的已经是休眠边界。
+abstract class SessionStateTracker {
+  Stream<SessionEvent> get events;
+
+  /// 同步派发已经到达的事件；没有轮询需求的平台为空实现。
+  void poll();
+
+  void dispose();
+}
+
+class _NoopSessionStateTracker implements SessionStateTracker {
+  @override
+  Stream<SessionEvent> get events => const Stream<SessionEvent>.empty();
+
+  @override
+  void poll() {}
+
+  @override
+  void dispose() {}
+}
+
+/// macOS：NSWorkspace 休眠 / 唤醒与屏幕锁定通知，经 EventChannel 推送。
+class _MacOsSessionStateTracker implements SessionStateTracker {
+  _MacOsSessionStateTracker() {
+    _subscription = _eventChannel.receiveBroadcastStream().listen(
+      _handleEvent,
+      onError: (error) {
+        if (kDebugMode) {
+          debugPrint('[SessionStateTracker][macOS] error: $error');
+        }
+      },
+    );
+  }
+
+  static const _eventChannel = EventChannel('ringotrack/session_events');
+
+  final _controller = StreamController<SessionEvent>.broadcast();
+  StreamSubscription<dynamic>? _subscription;
+
+  @override
+  Stream<SessionEvent> get events => _controller.stream;
+
+  void _handleEvent(dynamic event) {
+    if (event is! Map) return;
+    final tsMillis = event['timestamp'] as num?;
+    final kind = switch (event['kind']) {
+      'locked' => SessionEventKind.locked,
+      'unlocked' => SessionEventKind.unlocked,
+      'suspend' => SessionEventKind.suspend,
+      'resume' => SessionEventKind.resume,
+      _ => null,
+    };
+    if (tsMillis == null || kind == null) return;
+    _controller.add(
+      SessionEvent(
+        kind: kind,
+        timestamp: DateTime.fromMillisecondsSinceEpoch(tsMillis.toInt()),
+      ),
+    );
+  }
+
+  @override
+  void poll() {}
+
+  @override
+  void dispose() {
+    _subscription?.cancel();
+    _controller.close();
+  }
+}
+
+// 与 Windows C 侧 RtSessionEvent 对齐的 FFI 结构体
+final class _RtSessionEvent extends ffi.Struct {
+  @ffi.Int64()
+  external int timestampMillis;
+
+  @ffi.Uint32()
+  external int kind;
+
+  @ffi.Uint32()
+  external int reserved;
+}
+
+typedef _RtSessionEventBufferNative = ffi.Pointer<_RtSessionEvent> Function();
+typedef _RtSessionEventBufferDart = ffi.Pointer<_RtSessionEvent> Function();
+typedef _RtDrainSessionEventsNative = ffi.Int32 Function();
+typedef _RtDrainSessionEventsDart = int Function();
+
+/// Windows：WM_POWERBROADCAST / WM_WTSSESSION_CHANGE 由 runner 记录，
+/// 这里通过 FFI 取出静态缓冲区中的事件。
+class _WindowsSessionStateTracker implements SessionStateTracker {
+  _WindowsSessionStateTracker._(this._buffer, this._drain);
+
+  static const _logTag = 'session_tracker_windows';
+
+  // 与 native ringotrack::TrackerEventKind 取值一致。
+  static const _kindLocked = 4;
+  static const _kindUnlocked = 5;
+  static const _kindSuspend = 6;
+  static const _kindResume = 7;
+
+  final ffi.Pointer<_RtSessionEvent> _buffer;
+  final _RtDrainSessionEventsDart _drain;
+  final _controller = StreamController<SessionEvent>.broadcast(sync: true);
+
+  static SessionStateTracker create() {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final bufferFn = lib
+          .lookupFunction<
+            _RtSessionEventBufferNative,
+            _RtSessionEventBufferDart
+          >('rt_session_event_buffer');
+      final drainFn = lib
+          .lookupFunction<_RtDrainSessionEventsNative, _RtDrainSessionEventsDart>(
+            'rt_drain_session_events',
+          );
+      return _WindowsSessionStateTracker._(bufferFn(), drainFn);
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup session event functions failed: $e\n$st',
+      );
+      return _NoopSessionStateTracker();
+    }
+  }
+
+  @override
+  Stream<SessionEvent> get events => _controller.stream;
+
+  @override
+  void poll() {
+    final count = _drain();
+    for (var i = 0; i < count; i++) {
+      final raw = (_buffer + i).ref;
+      final kind = switch (raw.kind) {
+        _kindLocked => SessionEventKind.locked,
+        _kindUnlocked => SessionEventKind.unlocked,
+        _kindSuspend => SessionEventKind.suspend,
+        _kindResume => SessionEventKind.resume,
+        _ => null,
+      };
+      if (kind == null) continue;
+      _controller.add(
+        SessionEvent(
+          kind: kind,
+          timestamp: DateTime.fromMillisecondsSinceEpoch(raw.timestampMillis),
+        ),
+      );
+    }
+  }
+
+  @override
+  void dispose() {
+    _controller.close();
+  }
+}
+
+/// Linux：监听 logind 的 D-Bus 信号（PrepareForSleep、Session.Lock / Unlock）。
+///
+/// 借助系统自带的 `gdbus monitor`，避免引入 D-Bus 客户端依赖。
+class _LinuxSessionStateTracker implements SessionStateTracker {
+  _LinuxSessionStateTracker() {
+    final sessionId = Platform.environment['XDG_SESSION_ID'];
+    _sessionPath = (sessionId == null || sessionId.isEmpty)
+        ? null
+        : logindSessionObjectPath(sessionId);
+    unawaited(_start());
+  }
+
+  static const _logTag = 'session_tracker_linux';
+
+  final _controller = StreamController<SessionEvent>.broadcast();
+  String? _sessionPath;
+  Process? _process;
+  bool _disposed = false;
+
+  Future<void> _start() async {
+    try {
+      final process = await Process.start('gdbus', [
+        'monitor',
+        '--system',
+        '--dest',
+        'org.freedesktop.login1',
+      ]);
+      if (_disposed) {
+        process.kill();
+        return;
+      }
+      _process = process;
+      process.stdout
+          .transform(utf8.decoder)
+          .transform(const LineSplitter())
+          .listen((line) {
+            final kind = parseLogindMonitorLine(line, sessionPath: _sessionPath);
+            if (kind != null && !_controller.isClosed) {
+              _controller.add(
+                SessionEvent(kind: kind, timestamp: DateTime.now()),
+              );
+            }
+          });
+    } catch (e) {
+      AppLogService.instance.logWarn(
+        _logTag,
+        'gdbus monitor unavailable; session events disabled: $e',
+      );
+    }
+  }
+
+  @override
+  Stream<SessionEvent> get events => _controller.stream;
+
+  @override
+  void poll() {}
+
+  @override
+  void dispose() {
+    _disposed = true;
+    _process?.kill();
+    _controller.close();
+  }
+}
+
+/// logind 会话 ID -> D-Bus 对象路径（非字母数字及首位数字按 `_xx` 转义）。
+String logindSessionObjectPath(String sessionId) {
+  final buffer = StringBuffer('/org/freedesktop/login1/session/');
+  for (var i = 0; i < sessionId.length; i++) {
+    final c = sessionId.codeUnitAt(i);
+    final isAlpha = (c >= 0x41 && c <= 0x5A) || (c >= 0x61 && c <= 0x7A);
+    final isDigit = c >= 0x30 && c <= 0x39;
+    if (isAlpha || (isDigit && i > 0)) {
+      buffer.writeCharCode(c);
+    } else {
+      buffer.write('_${c.toRadixString(16).padLeft(2, '0')}');
+    }
+  }
+  return buffer.toString();
+}
+
+/// 解析 `gdbus monitor` 的一行输出；非会话事件返回 null。
+///
+/// [sessionPath] 不为空时只接受本会话的 Lock / Unlock。
+SessionEventKind? parseLogindMonitorLine(String line, {String? sessionPath}) {
+  final separator = line.indexOf(': ');
+  if (separator <= 0) return null;
+  final path = line.substring(0, separator);
+  final body = line.substring(separator + 2);
+
+  if (body.startsWith('org.freedesktop.login1.Manager.PrepareForSleep ')) {
+    if (body.contains('(true')) return SessionEventKind.suspend;
+    if (body.contains('(false')) return SessionEventKind.resume;
+    return null;
+  }
+
+  if (sessionPath != null && path != sessionPath) return null;
+  if (body.startsWith('org.freedesktop.login1.Session.Lock ')) {
+    return SessionEventKind.locked;
+  }
+  if (body.startsWith('org.freedesktop.login1.Session.Unlock ')) {
+    return SessionEventKind.unlocked;
+  }
+  return null;
+}
+
+SessionStateTracker createSessionStateTracker() {
+  if (kIsWeb) return _NoopSessionStateTracker();
+  if (Platform.isWindows) return _WindowsSessionStateTracker.create();
+  if (Platform.isMacOS) return _MacOsSessionStateTracker();
+  if (Platform.isLinux) return _LinuxSessionStateTracker();
+  return _NoopSessionStateTracker();
+}
@@ -5,6 +5,7 @@ import 'dart:io';
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
 import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
 
 typedef RtInitStrokeHookNative = ffi.Void Function();
 typedef RtInitStrokeHookDart = void Function();
@@ -90,8 +91,11 @@ class _MacOsStrokeActivityTracker implements StrokeActivityTracker {
 }
 
 /// Windows 侧通过 FFI 轮询 native 维护的 last_left_click_millis。
+///
+/// 轮询随共享节拍执行；落笔时间由 hook 记录，节拍变稀疏不影响 AFK 判定的
+/// 时间点。
 class _WindowsStrokeActivityTracker implements StrokeActivityTracker {
-  _WindowsStrokeActivityTracker()
+  _WindowsStrokeActivityTracker(this._scheduler)
     : _initStrokeHook = _loadInitFunction(),
       _getLastStrokeMillis = _loadGetLastStrokeFunction(),
       _getIsLeftButtonDown = _loadIsButtonDownFunction() {
@@ -106,7 +110,7 @@ class _WindowsStrokeActivityTracker implements StrokeActivityTracker {
     }
 
     _initStrokeHook();
-    _timer = Timer.periodic(const Duration(seconds: 1), (_) => _pollOnce());
+    _scheduler.addPoller(_pollOnce);
   }
 
   static const _logTag = 'stroke_tracker_windows';
@@ -115,8 +119,8 @@ class _WindowsStrokeActivityTracker implements StrokeActivityTracker {
   final RtGetLastStrokeMillisDart? _getLastStrokeMillis;
   final RtIsLeftButtonDownDart? _getIsLeftButtonDown;
 
+  final TickScheduler _scheduler;
   final _controller = StreamController<StrokeEvent>.broadcast();
-  Timer? _timer;
   int _lastSeenMillis = 0;
   bool _lastButtonDown = false;
 
@@ -213,12 +217,14 @@ class _WindowsStrokeActivityTracker implements StrokeActivityTracker {
 
   @override
   void dispose() {
-    _timer?.cancel();
+    _scheduler.removePoller(_pollOnce);
     _controller.close();
   }
 }
 
-StrokeActivityTracker createStrokeActivityTracker() {
+StrokeActivityTracker createStrokeActivityTracker({
+  required TickScheduler scheduler,
+}) {
   if (kDebugMode) {
     debugPrint(
       '[StrokeActivityTracker] createStrokeActivityTracker: '
@@ -231,7 +237,7 @@ StrokeActivityTracker createStrokeActivityTracker() {
   }
 
   if (Platform.isWindows) {
-    return _WindowsStrokeActivityTracker();
+    return _WindowsStrokeActivityTracker(scheduler);
   }
 
   return _NoopStrokeActivityTracker();
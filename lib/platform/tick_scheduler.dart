@@ -0,0 +1,169 @@
+import 'dart:async';
+
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
+
+/// 节拍档位，由 UsageService 按当前状态设置。
+enum TickCadence {
+  /// 统计中的应用在前台且未 AFK：今日时长与小时分布需要逐秒刷新。
+  active,
+
+  /// 前台不是统计中的应用：只需发现前台切换与 AFK。
+  background,
+
+  /// AFK / 锁屏 / 休眠：只需发现恢复活动；没有轮询源时完全由事件驱动。
+  idle,
+}
+
+typedef TickTimerFactory =
+    Timer Function(Duration delay, void Function() callback);
+
+/// 进程内唯一的节拍源，替代各个轮询器与 UsageService 各自的 1 秒定时器。
+///
+/// - 轮询器（Windows 前台 / 落笔 / 按键）在每次节拍开始时按注册顺序执行，
+///   之后执行 [handler]（UsageService 的结算），同一次唤醒完成全部工作；
+/// - 节拍对齐到间隔的整数倍（墙钟），间隔随 [cadence] 变化，切到更快的
+///   档位时立即按新间隔重排；
+/// - 上一次 [handler] 尚未完成（例如落库较慢）时跳过本次，不会并发结算。
+///
+/// 计时精度不依赖节拍密度：前台切换、落笔、按键都带有 native 记录的事件
+/// 时间，节拍只决定「多久之后发现」，不决定「记到哪个时刻」。
+class TickScheduler {
+  TickScheduler({
+    this.activeInterval = const Duration(seconds: 1),
+    this.backgroundInterval = const Duration(seconds: 5),
+    this.idleInterval = const Duration(seconds: 5),
+    DateTime Function()? now,
+    TickTimerFactory? createTimer,
+  }) : _now = now ?? DateTime.now,
+       _createTimer = createTimer ?? Timer.new;
+
+  final Duration activeInterval;
+  final Duration backgroundInterval;
+
+  /// 有轮询源时 idle 档位的间隔；没有轮询源时 idle 档位不定时唤醒。
+  final Duration idleInterval;
+
+  final DateTime Function() _now;
+  final TickTimerFactory _createTimer;
+
+  final _pollers = <void Function()>[];
+  Future<void> Function()? _handler;
+  TickCadence _cadence = TickCadence.active;
+  Timer? _timer;
+  DateTime? _scheduledAt;
+  bool _ticking = false;
+  bool _disposed = false;
+  int _wakeups = 0;
+
+  TickCadence get cadence => _cadence;
+
+  /// 自创建以来实际执行的节拍次数。
+  int get wakeups => _wakeups;
+
+  /// 下一次节拍的时间；为 null 表示当前不定时唤醒。
+  DateTime? get scheduledAt => _scheduledAt;
+
+  /// 当前档位的间隔；为 null 表示只由事件驱动。
+  Duration? get currentInterval => switch (_cadence) {
+    TickCadence.active => activeInterval,
+    TickCadence.background => backgroundInterval,
+    TickCadence.idle => _pollers.isEmpty ? null : idleInterval,
+  };
+
+  Future<void> Function()? get handler => _handler;
+
+  set handler(Future<void> Function()? handler) {
+    _handler = handler;
+    _reschedule();
+  }
+
+  void addPoller(void Function() poll) {
+    _pollers.add(poll);
+    _reschedule();
+  }
+
+  void removePoller(void Function() poll) {
+    _pollers.remove(poll);
+    _reschedule();
+  }
+
+  void setCadence(TickCadence cadence) {
+    if (cadence == _cadence) return;
+    _cadence = cadence;
+    _reschedule();
+  }
+
+  /// 推送型事件源收到事件后请求尽快执行一次节拍。
+  void requestTick() {
+    if (_disposed) return;
+    _schedule(_now());
+  }
+
+  void dispose() {
+    _disposed = true;
+    _cancel();
+    _pollers.clear();
+    _handler = null;
+  }
+
+  void _reschedule() {
+    if (_disposed) return;
+    final interval = currentInterval;
+    if (interval == null || (_pollers.isEmpty && _handler == null)) {
+      _cancel();
+      return;
+    }
+    final now = _now();
+    final next = _alignedAfter(now, interval);
+    // 已经排好的更早节拍保留：切到更慢的档位不推迟它。
+    final scheduled = _scheduledAt;
+    if (scheduled != null && !scheduled.isAfter(next)) return;
+    _schedule(next);
+  }
+
+  DateTime _alignedAfter(DateTime now, Duration interval) {
+    final step = interval.inMilliseconds;
+    if (step <= 0) return now;
+    final millis = now.millisecondsSinceEpoch;
+    return DateTime.fromMillisecondsSinceEpoch((millis ~/ step + 1) * step);
+  }
+
+  void _schedule(DateTime at) {
+    _timer?.cancel();
+    _scheduledAt = at;
+    final delay = at.difference(_now());
+    _timer = _createTimer(delay.isNegative ? Duration.zero : delay, _onTimer);
+  }
+
+  void _cancel() {
+    _timer?.cancel();
+    _timer = null;
+    _scheduledAt = null;
+  }
+
+  Future<void> _onTimer() async {
+    _timer = null;
+    _scheduledAt = null;
+    if (_disposed) return;
+    if (_ticking) {
+      _reschedule();
+      return;
+    }
+
+    _ticking = true;
+    _wakeups++;
+    AppMetrics.instance.increment('tick_wakeups_${_cadence.name}');
+    try {
+      for (final poll in List.of(_pollers)) {
+        poll();
+      }
+      // 轮询源经异步广播流发出的事件在微任务中派发，先让它们送达，
+      // 结算才能看到本次节拍发现的前台切换与落笔。
+      await Future<void>.value();
+      await _handler?.call();
+    } finally {
+      _ticking = false;
+      _reschedule();
+    }
+  }
+}
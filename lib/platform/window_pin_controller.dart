@@ -1,6 +1,7 @@
 import 'dart:async';
 import 'dart:ffi' as ffi;
 import 'dart:io';
+import 'dart:ui' show Rect, Size;
 
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
@@ -18,6 +19,41 @@ typedef _RtLockWindowDart = int Function();
 typedef _RtUnlockWindowNative = ffi.Int32 Function();
 typedef _RtUnlockWindowDart = int Function();
 
+/// 与 native/include/ringotrack/hit_test_regions.h 中 InteractiveRegion 对齐。
+final class _RtInteractiveRegion extends ffi.Struct {
+  @ffi.Uint32()
+  external int anchor;
+
+  @ffi.Int32()
+  external int x;
+
+  @ffi.Int32()
+  external int y;
+
+  @ffi.Int32()
+  external int width;
+
+  @ffi.Int32()
+  external int height;
+}
+
+typedef _RtInteractiveRegionsInputNative =
+    ffi.Pointer<_RtInteractiveRegion> Function();
+typedef _RtInteractiveRegionsInputDart =
+    ffi.Pointer<_RtInteractiveRegion> Function();
+
+typedef _RtApplyInteractiveRegionsNative = ffi.Int32 Function(ffi.Int32);
+typedef _RtApplyInteractiveRegionsDart = int Function(int);
+
+// 与 RegionAnchor 的取值一致。
+const _anchorTopLeft = 0;
+const _anchorTopRight = 1;
+const _anchorBottomLeft = 2;
+const _anchorBottomRight = 3;
+
+/// native 命中测试表的容量（HitTestRegions::kMaxRegions）。
+const maxInteractiveRegions = 16;
+
 /// 控制窗口在 Windows 上的置顶 / 取消置顶行为。
 ///
 /// 通过 FFI 调用 runner 进程中导出的 Win32 函数，实现：
@@ -29,8 +65,11 @@ final class WindowPinController {
     this._exitPinnedMode,
     this._lockWindow,
     this._unlockWindow,
-    this._methodChannel,
-  );
+    this._methodChannel, {
+    _RtInteractiveRegionsInputDart? regionsInput,
+    _RtApplyInteractiveRegionsDart? applyRegions,
+  }) : _regionsInput = regionsInput,
+       _applyRegions = applyRegions;
 
   static const _logTag = 'window_pin';
   static const _methodChannelName = 'ringotrack/window_pin';
@@ -42,6 +81,8 @@ final class WindowPinController {
   final _RtLockWindowDart? _lockWindow;
   final _RtUnlockWindowDart? _unlockWindow;
   final MethodChannel? _methodChannel;
+  final _RtInteractiveRegionsInputDart? _regionsInput;
+  final _RtApplyInteractiveRegionsDart? _applyRegions;
 
   static WindowPinController _create() {
     // Web 不支持桌面窗口 API，直接返回空实现。
@@ -82,7 +123,36 @@ final class WindowPinController {
           debugPrint('[WindowPinController] Windows FFI functions resolved');
         }
 
-        return WindowPinController._(enterFn, exitFn, lockFn, unlockFn, null);
+        // 交互区域接口缺失时（旧 runner）退回 native 默认的两个角落。
+        _RtInteractiveRegionsInputDart? regionsInputFn;
+        _RtApplyInteractiveRegionsDart? applyRegionsFn;
+        try {
+          regionsInputFn = lib
+              .lookupFunction<
+                _RtInteractiveRegionsInputNative,
+                _RtInteractiveRegionsInputDart
+              >('rt_interactive_regions_input');
+          applyRegionsFn = lib
+              .lookupFunction<
+                _RtApplyInteractiveRegionsNative,
+                _RtApplyInteractiveRegionsDart
+              >('rt_apply_interactive_regions');
+        } catch (e) {
+          AppLogService.instance.logError(
+            _logTag,
+            'lookup interactive region functions failed: $e',
+          );
+        }
+
+        return WindowPinController._(
+          enterFn,
+          exitFn,
+          lockFn,
+          unlockFn,
+          null,
+          regionsInput: regionsInputFn,
+          applyRegions: applyRegionsFn,
+        );
       } catch (e, st) {
         AppLogService.instance.logError(
           _logTag,
@@ -351,4 +421,48 @@ final class WindowPinController {
 
     return false;
   }
+
+  /// 注册 pinned 小窗中需要响应点击的区域（逻辑像素，相对窗口左上角），
+  /// 其余区域用于拖动窗口。每个矩形锚定到离它最近的窗口角落，窗口尺寸
+  /// 变化时仍贴住该角。传入 null 恢复默认的右上 / 右下两个角落。
+  ///
+  /// 仅 Windows 生效；返回 false 表示不支持或区域无效。
+  bool setInteractiveRegions(List<Rect>? regions, Size windowSize) {
+    final inputFn = _regionsInput;
+    final applyFn = _applyRegions;
+    if (!Platform.isWindows || inputFn == null || applyFn == null) {
+      return false;
+    }
+    if (regions == null) {
+      return applyFn(-1) != 0;
+    }
+    if (regions.length > maxInteractiveRegions) {
+      return false;
+    }
+
+    final input = inputFn();
+    for (var i = 0; i < regions.length; i++) {
+      final rect = regions[i];
+      final right = rect.right >= windowSize.width / 2;
+      final bottom = rect.bottom >= windowSize.height / 2;
+      final region = input[i]
+        ..anchor = right
+            ? (bottom ? _anchorBottomRight : _anchorTopRight)
+            : (bottom ? _anchorBottomLeft : _anchorTopLeft)
+        ..x = (right ? windowSize.width - rect.right : rect.left).round()
+        ..y = (bottom ? windowSize.height - rect.bottom : rect.top).round()
+        ..width = rect.width.ceil()
+        ..height = rect.height.ceil();
+      if (region.x < 0) region.x = 0;
+      if (region.y < 0) region.y = 0;
+    }
+    final ok = applyFn(regions.length) != 0;
+    if (!ok) {
+      AppLogService.instance.logError(
+        _logTag,
+        'setInteractiveRegions rejected: $regions',
+      );
+    }
+    return ok;
+  }
 }
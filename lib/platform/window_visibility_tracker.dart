@@ -0,0 +1,188 @@
+import 'dart:convert';
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+import 'package:flutter/foundation.dart';
+import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+
+/// 可见但不在前台的应用。
+class VisibleApp {
+  const VisibleApp({required this.appId, required this.visibleFraction});
+
+  final String appId;
+
+  /// 该应用可见比例最大的窗口未被遮挡的面积占比（0-1）。
+  final double visibleFraction;
+}
+
+/// 多窗口可见性来源：报告哪些被跟踪的应用窗口在屏幕上可见（未最小化、
+/// 未被其它窗口遮挡），但不是前台窗口，例如副屏上开着的参考图。
+///
+/// 窗口表由系统窗口事件增量维护，[queryVisibleApps] 在窗口没有变化时
+/// 只读取缓存结果，适合每个 tick 调用一次。
+abstract class WindowVisibilityTracker {
+  /// 设置需要计算的应用（小写 appId）；[trackAll] 为 true 时计算全部窗口，
+  /// 用于过滤规则含通配符的情况。
+  void setTrackedApps(Iterable<String> appIds, {bool trackAll = false});
+
+  /// 可见比例不低于 [minFraction] 的非前台应用。
+  List<VisibleApp> queryVisibleApps({double minFraction = 0.5});
+
+  void dispose();
+}
+
+class _NoopWindowVisibilityTracker implements WindowVisibilityTracker {
+  @override
+  void setTrackedApps(Iterable<String> appIds, {bool trackAll = false}) {}
+
+  @override
+  List<VisibleApp> queryVisibleApps({double minFraction = 0.5}) => const [];
+
+  @override
+  void dispose() {}
+}
+
+// 与 Windows C 侧 RtVisibleApp / RtVisibleApps 对齐的 FFI 结构体
+final class _RtVisibleApp extends ffi.Struct {
+  @ffi.Array.multi([128])
+  external ffi.Array<ffi.Uint8> appId;
+
+  @ffi.Uint32()
+  external int visiblePermille;
+
+  @ffi.Uint32()
+  external int reserved;
+}
+
+final class _RtVisibleApps extends ffi.Struct {
+  @ffi.Int32()
+  external int count;
+
+  @ffi.Uint32()
+  external int reserved;
+
+  @ffi.Array.multi([16])
+  external ffi.Array<_RtVisibleApp> apps;
+}
+
+const _trackedInputCapacity = 8192;
+
+typedef _RtSetVisibilityTrackingNative = ffi.Int32 Function(ffi.Int32);
+typedef _RtSetVisibilityTrackingDart = int Function(int);
+typedef _RtVisibilityTrackedInputNative = ffi.Pointer<ffi.Uint8> Function();
+typedef _RtVisibilityTrackedInputDart = ffi.Pointer<ffi.Uint8> Function();
+typedef _RtApplyVisibilityTrackedNative = ffi.Int32 Function();
+typedef _RtApplyVisibilityTrackedDart = int Function();
+typedef _RtQueryVisibleAppsNative =
+    ffi.Pointer<_RtVisibleApps> Function(ffi.Uint32);
+typedef _RtQueryVisibleAppsDart = ffi.Pointer<_RtVisibleApps> Function(int);
+
+/// Windows：WinEvent hook 维护顶层窗口的 z 序与矩形，遮挡计算在 native 核心。
+class _WindowsWindowVisibilityTracker implements WindowVisibilityTracker {
+  _WindowsWindowVisibilityTracker._(
+    this._setTracking,
+    this._trackedInput,
+    this._applyTracked,
+    this._query,
+  );
+
+  static const _logTag = 'visibility_tracker_windows';
+
+  final _RtSetVisibilityTrackingDart _setTracking;
+  final ffi.Pointer<ffi.Uint8> _trackedInput;
+  final _RtApplyVisibilityTrackedDart _applyTracked;
+  final _RtQueryVisibleAppsDart _query;
+
+  static WindowVisibilityTracker create() {
+    try {
+      final lib = ffi.DynamicLibrary.process();
+      final setTrackingFn = lib
+          .lookupFunction<
+            _RtSetVisibilityTrackingNative,
+            _RtSetVisibilityTrackingDart
+          >('rt_set_visibility_tracking');
+      final inputFn = lib
+          .lookupFunction<
+            _RtVisibilityTrackedInputNative,
+            _RtVisibilityTrackedInputDart
+          >('rt_visibility_tracked_input');
+      final applyFn = lib
+          .lookupFunction<
+            _RtApplyVisibilityTrackedNative,
+            _RtApplyVisibilityTrackedDart
+          >('rt_apply_visibility_tracked');
+      final queryFn = lib
+          .lookupFunction<_RtQueryVisibleAppsNative, _RtQueryVisibleAppsDart>(
+            'rt_query_visible_apps',
+          );
+      if (setTrackingFn(1) == 0) {
+        AppLogService.instance.logWarn(
+          _logTag,
+          'window event hooks unavailable; visibility tracking disabled',
+        );
+        return _NoopWindowVisibilityTracker();
+      }
+      return _WindowsWindowVisibilityTracker._(
+        setTrackingFn,
+        inputFn(),
+        applyFn,
+        queryFn,
+      );
+    } catch (e, st) {
+      AppLogService.instance.logError(
+        _logTag,
+        'lookup visibility functions failed: $e\n$st',
+      );
+      return _NoopWindowVisibilityTracker();
+    }
+  }
+
+  @override
+  void setTrackedApps(Iterable<String> appIds, {bool trackAll = false}) {
+    final lines = [if (trackAll) '*', ...appIds.map((id) => id.toLowerCase())];
+    final bytes = utf8.encode(lines.join('\n'));
+    final length = bytes.length < _trackedInputCapacity
+        ? bytes.length
+        : _trackedInputCapacity - 1;
+    final buffer = _trackedInput.asTypedList(_trackedInputCapacity);
+    buffer.setRange(0, length, bytes);
+    buffer[length] = 0;
+    _applyTracked();
+  }
+
+  @override
+  List<VisibleApp> queryVisibleApps({double minFraction = 0.5}) {
+    final permille = (minFraction.clamp(0.0, 1.0) * 1000).round();
+    final result = _query(permille).ref;
+    return [
+      for (var i = 0; i < result.count; i++)
+        VisibleApp(
+          appId: _readAppId(result.apps[i].appId),
+          visibleFraction: result.apps[i].visiblePermille / 1000,
+        ),
+    ];
+  }
+
+  String _readAppId(ffi.Array<ffi.Uint8> array) {
+    final bytes = <int>[];
+    for (var i = 0; i < 128; i++) {
+      final byte = array[i];
+      if (byte == 0) break;
+      bytes.add(byte);
+    }
+    return utf8.decode(bytes, allowMalformed: true);
+  }
+
+  @override
+  void dispose() {
+    _setTracking(0);
+  }
+}
+
+/// macOS 需要「屏幕录制」权限才能读取其它应用的窗口几何，暂不提供；
+/// 其他平台同样为空实现。
+WindowVisibilityTracker createWindowVisibilityTracker() {
+  if (kIsWeb) return _NoopWindowVisibilityTracker();
+  if (Platform.isWindows) return _WindowsWindowVisibilityTracker.create();
+  return _NoopWindowVisibilityTracker();
+}
@@ -8,15 +8,32 @@ import 'package:ringotrack/feature/settings/demo/controllers/demo_mode_controlle
 import 'package:ringotrack/feature/usage/repositories/demo_usage_repository.dart';
 import 'package:ringotrack/feature/settings/drawing_app/models/drawing_app_preferences.dart';
 import 'package:ringotrack/feature/settings/drawing_app/controllers/drawing_app_preferences_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/keyboard_activity_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/process_activity_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/record_all_apps_controller.dart';
+import 'package:ringotrack/feature/settings/drawing_app/controllers/secondary_visible_controller.dart';
 import 'package:ringotrack/feature/dashboard/providers/dashboard_providers.dart'
     as dashboard_providers;
 import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+import 'package:ringotrack/feature/dashboard/services/startup_timing.dart';
 import 'package:ringotrack/feature/settings/theme/controllers/theme_controller.dart';
 
+import 'package:ringotrack/feature/query/services/usage_query_cache.dart';
+import 'package:ringotrack/feature/query/services/usage_query_server.dart';
+import 'package:ringotrack/feature/usage/repositories/compact_usage_repository.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
+import 'package:ringotrack/feature/usage/models/usage_timeline.dart';
 import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
 import 'package:ringotrack/feature/usage/services/usage_service.dart';
 import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/keyboard_activity_tracker.dart';
+import 'package:ringotrack/platform/live_status_publisher.dart';
+import 'package:ringotrack/platform/process_activity_tracker.dart';
+import 'package:ringotrack/platform/session_state_tracker.dart';
 import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+import 'package:ringotrack/platform/window_visibility_tracker.dart';
 
 // ============================================================================
 // Core Infrastructure Providers
@@ -28,18 +45,54 @@ final appDatabaseProvider = Provider<AppDatabase>((ref) {
   return db;
 });
 
+/// 共享节拍：Windows 轮询源与 UsageService 的结算在同一次唤醒里完成。
+final tickSchedulerProvider = Provider<TickScheduler>((ref) {
+  final scheduler = TickScheduler();
+  ref.onDispose(scheduler.dispose);
+  return scheduler;
+});
+
 final foregroundAppTrackerProvider = Provider<ForegroundAppTracker>((ref) {
-  final tracker = createForegroundAppTracker();
+  final tracker = createForegroundAppTracker(
+    scheduler: ref.watch(tickSchedulerProvider),
+  );
   ref.onDispose(tracker.dispose);
   return tracker;
 });
 
 final strokeActivityTrackerProvider = Provider<StrokeActivityTracker>((ref) {
-  final tracker = createStrokeActivityTracker();
+  final tracker = createStrokeActivityTracker(
+    scheduler: ref.watch(tickSchedulerProvider),
+  );
+  ref.onDispose(tracker.dispose);
+  return tracker;
+});
+
+/// 按键活动来源（AFK 辅助判定）；设置中未开启时为 null，不安装键盘 hook。
+final keyboardActivityTrackerProvider = Provider<KeyboardActivityTracker?>((
+  ref,
+) {
+  final enabled = ref.watch(keyboardActivityControllerProvider).value ?? false;
+  if (!enabled) return null;
+  final tracker = createKeyboardActivityTracker(
+    scheduler: ref.watch(tickSchedulerProvider),
+  );
   ref.onDispose(tracker.dispose);
   return tracker;
 });
 
+final sessionStateTrackerProvider = Provider<SessionStateTracker>((ref) {
+  final tracker = createSessionStateTracker();
+  ref.onDispose(tracker.dispose);
+  return tracker;
+});
+
+final liveStatusPublisherProvider = Provider<LiveStatusPublisher>((ref) {
+  final publisher = createLiveStatusPublisher();
+  ref.onDispose(publisher.dispose);
+  return publisher;
+});
+
 /// 应用版本信息
 final packageInfoProvider = FutureProvider<PackageInfo>((ref) async {
   return await PackageInfo.fromPlatform();
@@ -71,6 +124,13 @@ final dashboardPreferencesControllerProvider =
     dashboard_providers.dashboardPreferencesControllerProvider;
 final windowsGlassEffectDisplayProvider =
     dashboard_providers.windowsGlassEffectDisplayProvider;
+final dashboardSnapshotSeedProvider =
+    dashboard_providers.dashboardSnapshotSeedProvider;
+final dashboardSnapshotProvider = dashboard_providers.dashboardSnapshotProvider;
+final dashboardSnapshotStoreProvider =
+    dashboard_providers.dashboardSnapshotStoreProvider;
+final dashboardSnapshotWriterProvider =
+    dashboard_providers.dashboardSnapshotWriterProvider;
 
 // ============================================================================
 // Usage Providers
@@ -88,10 +148,19 @@ final usageRepositoryProvider = Provider<UsageRepository>((ref) {
     return ref.watch(demoUsageRepositoryProvider);
   }
   final db = ref.watch(appDatabaseProvider);
+  final recordAllApps =
+      ref.watch(recordAllAppsControllerProvider).value ?? false;
+  if (recordAllApps) {
+    // 过滤器在查询时读取，追踪列表变化不需要重建仓库。
+    return CompactUsageRepository(
+      db,
+      trackedFilter: () => ref.read(drawingAppFilterProvider),
+    );
+  }
   return SqliteUsageRepository(db);
 });
 
-final drawingAppFilterProvider = Provider<bool Function(String)>((ref) {
+final drawingAppFilterProvider = Provider<AppMatcher>((ref) {
   final prefsAsync = ref.watch(drawingAppPrefsControllerProvider);
   final prefs =
       prefsAsync.value ??
@@ -99,19 +168,73 @@ final drawingAppFilterProvider = Provider<bool Function(String)>((ref) {
   return buildAppFilter(prefs);
 });
 
+/// 多窗口可见性来源；设置中未开启时为 null，不安装窗口事件 hook。
+final windowVisibilityTrackerProvider = Provider<WindowVisibilityTracker?>((
+  ref,
+) {
+  final enabled = ref.watch(secondaryVisibleControllerProvider).value ?? false;
+  if (!enabled) return null;
+  final tracker = createWindowVisibilityTracker();
+  void applyFilter(AppMatcher filter) {
+    tracker.setTrackedApps(filter.foldedIds, trackAll: filter.hasPatterns);
+  }
+
+  applyFilter(ref.read(drawingAppFilterProvider));
+  ref.listen(drawingAppFilterProvider, (previous, next) => applyFilter(next));
+  ref.onDispose(tracker.dispose);
+  return tracker;
+});
+
+/// 前台进程 CPU 活动来源；设置中未开启时为 null，不打开进程句柄。
+final processActivityTrackerProvider = Provider<ProcessActivityTracker?>((ref) {
+  final enabled = ref.watch(processActivityControllerProvider).value ?? false;
+  if (!enabled) return null;
+  final tracker = createProcessActivityTracker();
+  ref.onDispose(tracker.dispose);
+  return tracker;
+});
+
 final usageServiceProvider = Provider<UsageService>((ref) {
   final repo = ref.watch(usageRepositoryProvider);
   final tracker = ref.watch(foregroundAppTrackerProvider);
   final strokeTracker = ref.watch(strokeActivityTrackerProvider);
-  final filter = ref.watch(drawingAppFilterProvider);
+  // 过滤器变化时原地替换，不重建服务：重建会丢掉进行中的区间与余数。
+  final filter = ref.read(drawingAppFilterProvider);
+  final liveStatusPublisher = ref.watch(liveStatusPublisherProvider);
+  final sessionTracker = ref.watch(sessionStateTrackerProvider);
 
   final service = UsageService(
     isDrawingApp: filter,
     repository: repo,
     tracker: tracker,
     strokeTracker: strokeTracker,
+    liveStatusPublisher: liveStatusPublisher,
+    sessionTracker: sessionTracker,
+    keyboardTracker: ref.read(keyboardActivityTrackerProvider),
+    visibilityTracker: ref.read(windowVisibilityTrackerProvider),
+    activityTracker: ref.read(processActivityTrackerProvider),
+    scheduler: ref.watch(tickSchedulerProvider),
+    // 演示模式的内存仓库不记录文档维度、副屏可见 / 忙碌时长与绘画会话。
+    documentRepository: repo is DocumentUsageRepository ? repo : null,
+    secondaryRepository: repo is SecondaryUsageRepository ? repo : null,
+    busyRepository: repo is BusyUsageRepository ? repo : null,
+    sessionRepository: repo is SessionUsageRepository ? repo : null,
+    recordAllApps: repo is CompactUsageRepository,
   );
 
+  ref.listen(drawingAppFilterProvider, (previous, next) {
+    service.updateFilter(next);
+  });
+  ref.listen(keyboardActivityTrackerProvider, (previous, next) {
+    service.updateKeyboardTracker(next);
+  });
+  ref.listen(windowVisibilityTrackerProvider, (previous, next) {
+    service.updateVisibilityTracker(next);
+  });
+  ref.listen(processActivityTrackerProvider, (previous, next) {
+    service.updateActivityTracker(next);
+  });
+
   ref.onDispose(() {
     service.close();
   });
@@ -119,6 +242,40 @@ final usageServiceProvider = Provider<UsageService>((ref) {
   return service;
 });
 
+/// 本机查询端点（可选）。仅当设置了环境变量
+/// [UsageQueryServer.enableEnvironmentKey] 时启动；未启用或启动失败时为 null。
+final usageQueryServerProvider = FutureProvider<UsageQueryServer?>((ref) async {
+  if (kIsWeb) return null;
+  final endpointPath = UsageQueryServer.endpointPathFromEnvironment();
+  if (endpointPath == null) return null;
+
+  final service = ref.watch(usageServiceProvider);
+  final repo = ref.watch(usageRepositoryProvider);
+  final cache = UsageQueryCache(
+    repository: repo,
+    deltaStream: service.deltaStream,
+    hourlyDeltaStream: service.hourlyDeltaStream,
+  );
+  if (repo is CompactUsageRepository) {
+    // 全量记录模式下缓存内容依赖追踪列表，列表变化时整体失效即可。
+    ref.listen(drawingAppFilterProvider, (_, _) => cache.invalidate());
+  }
+
+  try {
+    final server = await UsageQueryServer.bind(
+      endpointPath: endpointPath,
+      cache: cache,
+      liveStatus: () => service.liveStatus,
+    );
+    ref.onDispose(server.close);
+    return server;
+  } catch (e) {
+    await cache.close();
+    debugPrint('[usageQueryServerProvider] bind failed: $e');
+    return null;
+  }
+});
+
 // ============================================================================
 // Dashboard Computed Providers
 // ============================================================================
@@ -185,41 +342,35 @@ final yearlyUsageByDateProvider =
       // 确保 UsageService 已启动
       final service = ref.watch(usageServiceProvider);
       final repo = ref.watch(usageRepositoryProvider);
+      // 全量记录模式在查询时过滤，追踪列表变化后需要重新加载。
+      if (repo is CompactUsageRepository) {
+        ref.watch(drawingAppFilterProvider);
+      }
       final range = ref.watch(heatmapRangeProvider);
       final start = range.start;
       final end = range.end;
 
+      // 冷启动：快照覆盖当前窗口时先用它绘制，随后由数据库结果替换。
+      final snapshot = repo is DemoUsageRepository
+          ? null
+          : ref.read(dashboardSnapshotProvider);
+      if (snapshot != null && snapshot.covers(start, end)) {
+        StartupTiming.noteDataSource('snapshot');
+        yield snapshot.dailyIn(start, end);
+      }
+
       // 初始全量
-      final usageByDate = await repo.loadRange(start, end);
+      var usageByDate = UsageTimeline.from(await repo.loadRange(start, end));
+      StartupTiming.noteDataSource('database');
       yield usageByDate;
 
-      // 后续增量：使用 UsageService.deltaStream 做增量合并
+      // 后续增量：合并出共享未变部分的新版本，只复制被修改的日期路径
       try {
         await for (final delta in service.deltaStream) {
-          if (delta.isEmpty) continue;
-
-          delta.forEach((day, perApp) {
-            final normalizedDay = _normalizeDay(day);
-            if (normalizedDay.isBefore(start) || normalizedDay.isAfter(end)) {
-              return;
-            }
-
-            final existingPerApp = usageByDate.putIfAbsent(
-              normalizedDay,
-              () => <String, Duration>{},
-            );
-
-            perApp.forEach((appId, duration) {
-              existingPerApp[appId] =
-                  (existingPerApp[appId] ?? Duration.zero) + duration;
-            });
-          });
-
-          yield Map<DateTime, Map<String, Duration>>.fromEntries(
-            usageByDate.entries.map(
-              (e) => MapEntry(e.key, Map<String, Duration>.from(e.value)),
-            ),
-          );
+          final next = usageByDate.withDelta(delta, start: start, end: end);
+          if (identical(next, usageByDate)) continue;
+          usageByDate = next;
+          yield usageByDate;
         }
       } catch (e) {
         if (kDebugMode) {
@@ -235,39 +386,38 @@ final currentYearUsageByDateProvider =
     ) async* {
       final service = ref.watch(usageServiceProvider);
       final repo = ref.watch(usageRepositoryProvider);
+      // 全量记录模式在查询时过滤，追踪列表变化后需要重新加载。
+      if (repo is CompactUsageRepository) {
+        ref.watch(drawingAppFilterProvider);
+      }
       final range = ref.watch(metricsRangeProvider);
       final start = range.start;
       final end = range.end;
 
-      final usageByDate = await repo.loadRange(start, end);
+      // 演示数据不写入快照，也不从快照读取。
+      final isDemo = repo is DemoUsageRepository;
+      final writer = isDemo ? null : ref.watch(dashboardSnapshotWriterProvider);
+      final snapshot = isDemo ? null : ref.read(dashboardSnapshotProvider);
+      if (snapshot != null && snapshot.covers(start, end)) {
+        StartupTiming.noteDataSource('snapshot');
+        yield snapshot.dailyIn(start, end);
+      }
+
+      var usageByDate = UsageTimeline.from(await repo.loadRange(start, end));
+      StartupTiming.noteDataSource('database');
       yield usageByDate;
+      if (!isDemo) {
+        ref.read(dashboardSnapshotProvider.notifier).release();
+      }
+      writer?.updateDaily(start, end, usageByDate);
 
       try {
         await for (final delta in service.deltaStream) {
-          if (delta.isEmpty) continue;
-
-          delta.forEach((day, perApp) {
-            final normalizedDay = _normalizeDay(day);
-            if (normalizedDay.isBefore(start) || normalizedDay.isAfter(end)) {
-              return;
-            }
-
-            final existingPerApp = usageByDate.putIfAbsent(
-              normalizedDay,
-              () => <String, Duration>{},
-            );
-
-            perApp.forEach((appId, duration) {
-              existingPerApp[appId] =
-                  (existingPerApp[appId] ?? Duration.zero) + duration;
-            });
-          });
-
-          yield Map<DateTime, Map<String, Duration>>.fromEntries(
-            usageByDate.entries.map(
-              (e) => MapEntry(e.key, Map<String, Duration>.from(e.value)),
-            ),
-          );
+          final next = usageByDate.withDelta(delta, start: start, end: end);
+          if (identical(next, usageByDate)) continue;
+          usageByDate = next;
+          yield usageByDate;
+          writer?.updateDaily(start, end, usageByDate);
         }
       } catch (e) {
         if (kDebugMode) {
@@ -276,50 +426,122 @@ final currentYearUsageByDateProvider =
       }
     });
 
-/// 仪表盘指标：今日 / 本周 / 本月 / 连续天数 + 数据更新时间
-final dashboardMetricsProvider = Provider<AsyncValue<DashboardMetrics>>((ref) {
-  final usageAsync = ref.watch(currentYearUsageByDateProvider);
-  final weekStartMode = ref.watch(dashboardWeekStartModeProvider);
-
-  return usageAsync.whenData((usageByDate) {
-    final today = _normalizeDay(DateTime.now());
-    final weekStart = startOfWeek(today, weekStartMode);
-    final monthStart = DateTime(today.year, today.month, 1);
-
-    var todayTotal = Duration.zero;
-    var weekTotal = Duration.zero;
-    var monthTotal = Duration.zero;
-
-    usageByDate.forEach((day, perApp) {
-      final normalizedDay = _normalizeDay(day);
-      final totalForDay = perApp.values.fold(Duration.zero, (a, b) => a + b);
+/// 指标区间内按天的绘画会话统计（会话表按开始时刻区间扫描）。
+final dailySessionStatsProvider =
+    FutureProvider.autoDispose<Map<DateTime, DailySessionStats>>((ref) async {
+      final repo = ref.watch(usageRepositoryProvider);
+      // 演示模式没有会话数据。
+      if (repo is! SessionUsageRepository) return const {};
+      final range = ref.watch(metricsRangeProvider);
+      final end = range.end;
+      final sessions = await repo.loadSessions(
+        range.start,
+        DateTime(end.year, end.month, end.day + 1),
+      );
+      return summarizeSessionsByDay(sessions);
+    });
 
-      if (normalizedDay == today) {
-        todayTotal += totalForDay;
-      }
-      if (!normalizedDay.isBefore(weekStart) && !normalizedDay.isAfter(today)) {
-        weekTotal += totalForDay;
+/// 指定年份各应用的周内小时分布：读增量维护的 168 格聚合，而不是折叠
+/// 全年的小时明细。
+final hourOfWeekUsageProvider = FutureProvider.autoDispose
+    .family<HourOfWeekUsage, int>((ref, year) async {
+      final repo = ref.watch(usageRepositoryProvider);
+      // 全量记录模式在查询时过滤，追踪列表变化后需要重新加载。
+      if (repo is CompactUsageRepository) {
+        ref.watch(drawingAppFilterProvider);
       }
-      if (normalizedDay.year == today.year &&
-          normalizedDay.month == today.month &&
-          !normalizedDay.isAfter(today) &&
-          !normalizedDay.isBefore(monthStart)) {
-        monthTotal += totalForDay;
+      if (repo is HourOfWeekUsageRepository) {
+        return repo.loadHourOfWeekUsage(year, year);
       }
+      // 演示数据没有聚合表，直接折叠。
+      final hourly = await repo.loadHourlyRange(
+        DateTime(year, 1, 1),
+        DateTime(year, 12, 31),
+      );
+      return HourOfWeekUsage.fold(hourly);
     });
 
-    final streakDays = _calculateCurrentStreak(usageByDate, today);
+/// 年度打卡图（7 × 24），行顺序跟随周起始日设置。
+final punchcardProvider = Provider.autoDispose
+    .family<AsyncValue<List<List<Duration>>>, int>((ref, year) {
+      final weekStart = ref.watch(dashboardWeekStartModeProvider);
+      return ref
+          .watch(hourOfWeekUsageProvider(year))
+          .whenData((usage) => usage.punchcard(weekStart));
+    });
 
-    return DashboardMetrics(
-      today: todayTotal,
-      thisWeek: weekTotal,
-      thisMonth: monthTotal,
-      streakDays: streakDays,
-      lastUpdatedAt: DateTime.now(),
-    );
-  });
+/// 迷你时钟用的实时状态：只订阅 [UsageService.liveStatusStream]，不加载
+/// 任何历史区间。
+final liveStatusProvider = StreamProvider.autoDispose<LiveStatus>((ref) async* {
+  final service = ref.watch(usageServiceProvider);
+  yield service.liveStatus;
+  yield* service.liveStatusStream;
 });
 
+/// 时钟是否处于置顶迷你模式。置顶期间仪表盘不构建内容，它依赖的年度
+/// 数据、指标与图表 provider 随之释放。
+class PinnedClockMode extends Notifier<bool> {
+  @override
+  bool build() => false;
+
+  void set(bool pinned) {
+    state = pinned;
+  }
+}
+
+final pinnedClockModeProvider = NotifierProvider<PinnedClockMode, bool>(
+  PinnedClockMode.new,
+);
+
+/// 仪表盘指标：今日 / 本周 / 本月 / 连续天数 + 数据更新时间
+final dashboardMetricsProvider =
+    Provider.autoDispose<AsyncValue<DashboardMetrics>>((ref) {
+      final usageAsync = ref.watch(currentYearUsageByDateProvider);
+      final weekStartMode = ref.watch(dashboardWeekStartModeProvider);
+
+      return usageAsync.whenData((usageByDate) {
+        final today = _normalizeDay(DateTime.now());
+        final weekStart = startOfWeek(today, weekStartMode);
+        final monthStart = DateTime(today.year, today.month, 1);
+
+        var todayTotal = Duration.zero;
+        var weekTotal = Duration.zero;
+        var monthTotal = Duration.zero;
+
+        usageByDate.forEach((day, perApp) {
+          final normalizedDay = _normalizeDay(day);
+          final totalForDay = perApp.values.fold(
+            Duration.zero,
+            (a, b) => a + b,
+          );
+
+          if (normalizedDay == today) {
+            todayTotal += totalForDay;
+          }
+          if (!normalizedDay.isBefore(weekStart) &&
+              !normalizedDay.isAfter(today)) {
+            weekTotal += totalForDay;
+          }
+          if (normalizedDay.year == today.year &&
+              normalizedDay.month == today.month &&
+              !normalizedDay.isAfter(today) &&
+              !normalizedDay.isBefore(monthStart)) {
+            monthTotal += totalForDay;
+          }
+        });
+
+        final streakDays = _calculateCurrentStreak(usageByDate, today);
+
+        return DashboardMetrics(
+          today: todayTotal,
+          thisWeek: weekTotal,
+          thisMonth: monthTotal,
+          streakDays: streakDays,
+          lastUpdatedAt: DateTime.now(),
+        );
+      });
+    });
+
 // ============================================================================
 // Update Providers
 // ============================================================================
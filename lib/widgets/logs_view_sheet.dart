@@ -1,7 +1,11 @@
+import 'dart:async';
+
 import 'package:flutter/material.dart';
 import 'package:flutter_screenutil/flutter_screenutil.dart';
 import 'package:ringotrack/feature/logging/services/app_log_service.dart';
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
 import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+import 'package:ringotrack/feature/logging/models/log_query.dart';
 
 class LogsViewSheet extends StatefulWidget {
   const LogsViewSheet({super.key});
@@ -11,37 +15,145 @@ class LogsViewSheet extends StatefulWidget {
 }
 
 class _LogsViewSheetState extends State<LogsViewSheet> {
+  static const _pageSize = 200;
+  // 滚动加载的上限；更早的记录请用时间之外的条件缩小范围。
+  static const _maxLoadedEntries = 5000;
+
   final AppLogService _logService = AppLogService.instance;
   final ScrollController _logScrollController = ScrollController();
-  late List<AppLogEntry> _entries;
+  final TextEditingController _tagController = TextEditingController();
+  final TextEditingController _searchController = TextEditingController();
+  final List<AppLogEntry> _entries = [];
+  LogQuery _query = LogQuery.all;
+  LogCursor? _cursor;
+  bool _hasMore = true;
+  bool _loading = false;
+  int _scannedBytes = 0;
+  // 条件变化后丢弃旧查询的结果。
+  int _generation = 0;
+  bool _showMetrics = false;
+  String _metricsSummary = '';
 
   @override
   void initState() {
     super.initState();
-    _entries = _logService.entries;
+    _logScrollController.addListener(_onScroll);
+    unawaited(_loadMore());
   }
 
   @override
   void dispose() {
     _logScrollController.dispose();
+    _tagController.dispose();
+    _searchController.dispose();
     super.dispose();
   }
 
+  void _onScroll() {
+    if (_showMetrics || !_logScrollController.hasClients) return;
+    if (_logScrollController.position.extentAfter < 400) {
+      unawaited(_loadMore());
+    }
+  }
+
+  /// 读取下一页（更早的记录）。查询有单次扫描上限，条件很少命中时一页
+  /// 可能不满，此时接着读，直到凑满一页或读完。
+  Future<void> _loadMore() async {
+    if (_loading || !_hasMore || _entries.length >= _maxLoadedEntries) {
+      return;
+    }
+    final generation = _generation;
+    setState(() => _loading = true);
+    final LogPage page;
+    try {
+      page = await _logService.query(_query, cursor: _cursor, limit: _pageSize);
+    } catch (_) {
+      if (mounted && generation == _generation) {
+        setState(() {
+          _loading = false;
+          _hasMore = false;
+        });
+      }
+      return;
+    }
+    if (!mounted || generation != _generation) return;
+    setState(() {
+      _loading = false;
+      _entries.addAll(page.entries);
+      _cursor = page.next;
+      _hasMore = page.next != null;
+      _scannedBytes += page.scannedBytes;
+    });
+    if (page.entries.length < _pageSize) {
+      unawaited(_loadMore());
+    }
+  }
+
+  void _reload() {
+    setState(() {
+      _generation++;
+      _entries.clear();
+      _cursor = null;
+      _hasMore = true;
+      _loading = false;
+      _scannedBytes = 0;
+    });
+    unawaited(_loadMore());
+  }
+
+  void _applyFilter() {
+    _query = LogQuery(
+      minLevel: _query.minLevel,
+      tag: _tagController.text.trim(),
+      text: _searchController.text.trim(),
+    );
+    _reload();
+  }
+
+  void _setMinLevel(String? minLevel) {
+    _query = LogQuery(minLevel: minLevel, tag: _query.tag, text: _query.text);
+    _reload();
+  }
+
   Future<void> _refresh() async {
+    if (_showMetrics) {
+      setState(() {
+        _metricsSummary = AppMetrics.instance.formatSummary();
+      });
+      return;
+    }
+    _reload();
+  }
+
+  void _toggleMetrics() {
     setState(() {
-      _entries = _logService.entries;
+      _showMetrics = !_showMetrics;
+      if (_showMetrics) {
+        _metricsSummary = AppMetrics.instance.formatSummary();
+      }
     });
   }
 
+  Future<void> _exportMetrics() async {
+    final messenger = ScaffoldMessenger.maybeOf(context);
+    try {
+      final file = await AppMetrics.instance.dumpToFile();
+      messenger?.showSnackBar(
+        SnackBar(content: Text('指标已导出到 ${file.path}')),
+      );
+    } catch (e) {
+      messenger?.showSnackBar(SnackBar(content: Text('导出指标失败：$e')));
+    }
+  }
+
   Future<void> _clear() async {
     await _logService.clear();
-    await _refresh();
+    if (mounted) _reload();
   }
 
   @override
   Widget build(BuildContext context) {
     final theme = Theme.of(context);
-    final entries = _entries.reversed.toList(growable: false);
 
     return SafeArea(
       top: false,
@@ -59,12 +171,26 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
             Row(
               children: [
                 Text(
-                  '采集日志预览',
+                  _showMetrics ? '热路径指标' : '采集日志预览',
                   style: theme.textTheme.titleMedium?.copyWith(
                     fontWeight: FontWeight.w700,
                   ),
                 ),
                 const Spacer(),
+                IconButton(
+                  onPressed: _toggleMetrics,
+                  icon: Icon(
+                    _showMetrics ? Icons.article_outlined : Icons.speed_rounded,
+                  ),
+                  tooltip: _showMetrics ? '查看日志' : '查看指标',
+                  splashRadius: 18.r,
+                ),
+                IconButton(
+                  onPressed: _exportMetrics,
+                  icon: const Icon(Icons.file_download_outlined),
+                  tooltip: '导出指标 JSON',
+                  splashRadius: 18.r,
+                ),
                 IconButton(
                   onPressed: _refresh,
                   icon: const Icon(Icons.refresh_rounded),
@@ -87,11 +213,17 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
             ),
             SizedBox(height: 6.h),
             Text(
-              '用于跨平台排查前台窗口采集与聚合写库的问题，最新记录在顶部。',
+              _showMetrics
+                  ? '钩子回调、前台查询、tick 与落库的耗时分布（p50 / p99 / max），点击刷新更新。'
+                  : '用于跨平台排查前台窗口采集与聚合写库的问题，最新记录在顶部，向下滚动加载更早的记录。',
               style: theme.textTheme.bodySmall?.copyWith(
                 color: const Color(0xFF4C5A52),
               ),
             ),
+            if (!_showMetrics) ...[
+              SizedBox(height: 10.h),
+              _buildFilterBar(theme),
+            ],
             SizedBox(height: 14.h),
             SizedBox(
               height: 480.h,
@@ -101,7 +233,9 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
                   borderRadius: BorderRadius.circular(12.r),
                   border: Border.all(color: const Color(0xFF1E293B)),
                 ),
-                child: _buildLogList(theme, entries),
+                child: _showMetrics
+                    ? _buildMetricsView()
+                    : _buildLogList(theme),
               ),
             ),
           ],
@@ -110,11 +244,84 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
     );
   }
 
-  Widget _buildLogList(ThemeData theme, List<AppLogEntry> entries) {
+  Widget _buildMetricsView() {
+    return Scrollbar(
+      controller: _logScrollController,
+      child: SingleChildScrollView(
+        controller: _logScrollController,
+        padding: EdgeInsets.symmetric(horizontal: 12.w, vertical: 10.h),
+        child: SelectableText(
+          _metricsSummary,
+          style: const TextStyle(
+            color: Color(0xFFE5E7EB),
+            fontSize: 12,
+            fontFamily: 'monospace',
+          ),
+        ),
+      ),
+    );
+  }
+
+  Widget _buildFilterBar(ThemeData theme) {
+    final scannedMb = (_scannedBytes / (1 << 20)).toStringAsFixed(1);
+    final loaded = _scannedBytes > 0
+        ? '已加载 ${_entries.length} 条，已扫描 $scannedMb MB'
+        : '已加载 ${_entries.length} 条';
+    return Row(
+      children: [
+        DropdownButton<String?>(
+          value: _query.minLevel,
+          isDense: true,
+          onChanged: _setMinLevel,
+          items: [
+            const DropdownMenuItem(child: Text('全部级别')),
+            for (final level in logLevels.skip(1))
+              DropdownMenuItem(value: level, child: Text('$level 及以上')),
+          ],
+        ),
+        SizedBox(width: 12.w),
+        SizedBox(
+          width: 160.w,
+          child: TextField(
+            controller: _tagController,
+            decoration: const InputDecoration(
+              isDense: true,
+              hintText: '模块（精确匹配）',
+            ),
+            onSubmitted: (_) => _applyFilter(),
+          ),
+        ),
+        SizedBox(width: 12.w),
+        Expanded(
+          child: TextField(
+            controller: _searchController,
+            decoration: const InputDecoration(
+              isDense: true,
+              hintText: '搜索内容，回车开始',
+              prefixIcon: Icon(Icons.search_rounded, size: 18),
+            ),
+            onSubmitted: (_) => _applyFilter(),
+          ),
+        ),
+        SizedBox(width: 12.w),
+        Text(loaded, style: theme.textTheme.bodySmall),
+      ],
+    );
+  }
+
+  Widget _buildLogList(ThemeData theme) {
+    final entries = _entries;
     if (entries.isEmpty) {
+      if (_loading || _hasMore) {
+        return const Center(child: CircularProgressIndicator(strokeWidth: 2));
+      }
       return Center(
         child: Text(
-          '当前还没有日志记录。请运行应用并切换前台软件后再查看。',
+          _query.minLevel == null &&
+                  (_query.tag ?? '').isEmpty &&
+                  (_query.text ?? '').isEmpty
+              ? '当前还没有日志记录。请运行应用并切换前台软件后再查看。'
+              : '没有符合条件的日志记录。',
           style: theme.textTheme.bodySmall?.copyWith(
             color: const Color(0xFFCBD5F5),
           ),
@@ -127,8 +334,9 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
       controller: _logScrollController,
       child: ListView.builder(
         controller: _logScrollController,
-        itemCount: entries.length,
+        itemCount: entries.length + 1,
         itemBuilder: (context, index) {
+          if (index == entries.length) return _buildListFooter(theme);
           final entry = entries[index];
           final tsStr = entry.timestamp.toIso8601String();
           final levelColor = _levelColor(entry.level);
@@ -190,6 +398,28 @@ class _LogsViewSheetState extends State<LogsViewSheet> {
     );
   }
 
+  Widget _buildListFooter(ThemeData theme) {
+    final String text;
+    if (_loading || (_hasMore && _entries.length < _maxLoadedEntries)) {
+      text = '加载中…';
+    } else if (_hasMore) {
+      text = '已加载 $_maxLoadedEntries 条，请用级别、模块或搜索条件缩小范围。';
+    } else {
+      text = '没有更早的记录了。';
+    }
+    return Padding(
+      padding: EdgeInsets.symmetric(vertical: 10.h),
+      child: Center(
+        child: Text(
+          text,
+          style: theme.textTheme.bodySmall?.copyWith(
+            color: const Color(0xFF94A3B8),
+          ),
+        ),
+      ),
+    );
+  }
+
   Color _levelColor(String level) {
     switch (level.toUpperCase()) {
       case 'DEBUG':
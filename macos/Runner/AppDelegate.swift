@@ -148,3 +148,56 @@ class StrokeEventStreamHandler: NSObject, FlutterStreamHandler {
     ])
   }
 }
+
+/// 锁屏 / 休眠 / 唤醒通知，作为 Dart 侧计时区间的精确边界。
+class SessionEventStreamHandler: NSObject, FlutterStreamHandler {
+  private var eventSink: FlutterEventSink?
+  private var workspaceObservers: [NSObjectProtocol] = []
+  private var distributedObservers: [NSObjectProtocol] = []
+
+  func onListen(withArguments arguments: Any?, eventSink events: @escaping FlutterEventSink) -> FlutterError? {
+    NSLog("[RingoTrack] SessionEventStreamHandler onListen")
+    self.eventSink = events
+
+    let workspaceCenter = NSWorkspace.shared.notificationCenter
+    workspaceObservers = [
+      workspaceCenter.addObserver(
+        forName: NSWorkspace.willSleepNotification, object: nil, queue: .main
+      ) { [weak self] _ in self?.emit("suspend") },
+      workspaceCenter.addObserver(
+        forName: NSWorkspace.didWakeNotification, object: nil, queue: .main
+      ) { [weak self] _ in self?.emit("resume") },
+    ]
+
+    let distributedCenter = DistributedNotificationCenter.default()
+    distributedObservers = [
+      distributedCenter.addObserver(
+        forName: NSNotification.Name("com.apple.screenIsLocked"), object: nil, queue: .main
+      ) { [weak self] _ in self?.emit("locked") },
+      distributedCenter.addObserver(
+        forName: NSNotification.Name("com.apple.screenIsUnlocked"), object: nil, queue: .main
+      ) { [weak self] _ in self?.emit("unlocked") },
+    ]
+    return nil
+  }
+
+  func onCancel(withArguments arguments: Any?) -> FlutterError? {
+    NSLog("[RingoTrack] SessionEventStreamHandler onCancel")
+    let workspaceCenter = NSWorkspace.shared.notificationCenter
+    workspaceObservers.forEach { workspaceCenter.removeObserver($0) }
+    workspaceObservers = []
+    let distributedCenter = DistributedNotificationCenter.default()
+    distributedObservers.forEach { distributedCenter.removeObserver($0) }
+    distributedObservers = []
+    eventSink = nil
+    return nil
+  }
+
+  private func emit(_ kind: String) {
+    guard let sink = eventSink else { return }
+    sink([
+      "kind": kind,
+      "timestamp": Int(Date().timeIntervalSince1970 * 1000),
+    ])
+  }
+}
@@ -4,6 +4,7 @@ import FlutterMacOS
 class MainFlutterWindow: NSWindow {
   private var foregroundAppStreamHandler: ForegroundAppStreamHandler?
   private var strokeEventStreamHandler: StrokeEventStreamHandler?
+  private var sessionEventStreamHandler: SessionEventStreamHandler?
   private var isPinnedWindow: Bool = false
   private var isLockedWindow: Bool = false
   private var previousFrame: NSRect?
@@ -145,7 +146,16 @@ class MainFlutterWindow: NSWindow {
     strokeChannel.setStreamHandler(strokeHandler)
     strokeEventStreamHandler = strokeHandler
 
-    NSLog("[RingoTrack] MainFlutterWindow set up foreground app + stroke event channels")
+    // 设置锁屏 / 休眠 / 唤醒事件的 EventChannel
+    let sessionChannel = FlutterEventChannel(
+      name: "ringotrack/session_events",
+      binaryMessenger: binaryMessenger
+    )
+    let sessionHandler = SessionEventStreamHandler()
+    sessionChannel.setStreamHandler(sessionHandler)
+    sessionEventStreamHandler = sessionHandler
+
+    NSLog("[RingoTrack] MainFlutterWindow set up foreground app + stroke + session event channels")
 
     super.awakeFromNib()
 
@@ -0,0 +1,444 @@
+// ringotrack_core 热路径的微基准。
+//
+// 运行：./ringotrack_core_bench --benchmark_format=json > bench.json
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <random>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ringotrack/app_interner.h"
+#include "ringotrack/clock.h"
+#include "ringotrack/event_queue.h"
+#include "ringotrack/hit_test_regions.h"
+#include "ringotrack/hourly_aggregator.h"
+#include "ringotrack/live_status.h"
+#include "ringotrack/metrics.h"
+#include "ringotrack/process_activity.h"
+#include "ringotrack/session_segmenter.h"
+#include "ringotrack/stroke_state.h"
+#include "ringotrack/title_rules.h"
+#include "ringotrack/tracker_engine.h"
+#include "ringotrack/window_visibility.h"
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kStart = 1735689600000LL;
+
+std::uint32_t CurrentProcessId() {
+#ifdef _WIN32
+  return ::GetCurrentProcessId();
+#else
+  return static_cast<std::uint32_t>(::getpid());
+#endif
+}
+
+void BM_SpscQueuePushPop(benchmark::State& state) {
+  TrackerEventQueue queue;
+  TrackerEvent event{kStart, TrackerEventKind::kPointerDown, 0};
+  TrackerEvent out{};
+  for (auto _ : state) {
+    queue.TryPush(event);
+    queue.TryPop(&out);
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_SpscQueuePushPop);
+
+void BM_InternerFindHit(benchmark::State& state) {
+  AppInterner interner;
+  const int count = static_cast<int>(state.range(0));
+  std::vector<std::string> names;
+  for (int i = 0; i < count; ++i) {
+    names.push_back("drawing_app_" + std::to_string(i) + ".exe");
+    interner.Intern(names.back());
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(interner.Intern(names[i]));
+    i = (i + 1) % names.size();
+  }
+}
+BENCHMARK(BM_InternerFindHit)->Arg(8)->Arg(256);
+
+void BM_SystemClockLocalHour(benchmark::State& state) {
+  const SystemClock clock;
+  std::int64_t t = clock.NowUnixMillis();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LocalHourAt(clock, t));
+    t += kMillisPerSecond;
+  }
+}
+BENCHMARK(BM_SystemClockLocalHour);
+
+// 模拟 1 秒一次的 tick：每次结算当前区间并 drain。
+void BM_AggregatorTickAndDrain(benchmark::State& state) {
+  const SystemClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+  std::vector<UsageBucket> out;
+  out.reserve(16);
+  std::int64_t t = kStart;
+  aggregator.OnForegroundChanged(1, t);
+  for (auto _ : state) {
+    t += kMillisPerSecond;
+    aggregator.OnForegroundChanged(1, t);
+    out.clear();
+    aggregator.Drain(&out);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_AggregatorTickAndDrain);
+
+// 一个长区间被切分到很多小时（例如 drain 间隔很长）。
+void BM_AggregatorLongInterval(benchmark::State& state) {
+  const SystemClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+  std::vector<UsageBucket> out;
+  const std::int64_t hours = state.range(0);
+  for (auto _ : state) {
+    aggregator.OnForegroundChanged(1, kStart);
+    aggregator.CloseAt(kStart + hours * kMillisPerHour);
+    out.clear();
+    aggregator.Drain(&out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * hours);
+}
+BENCHMARK(BM_AggregatorLongInterval)->Arg(24)->Arg(24 * 7);
+
+// 高频落笔事件经队列进入引擎。
+void BM_EngineProcessQueue(benchmark::State& state) {
+  const SystemClock clock;
+  TrackedAppSet tracked;
+  tracked.Add(1);
+  TrackerEngine engine(&clock, &tracked, 60 * kMillisPerSecond, kStart);
+  TrackerEventQueue queue;
+  engine.Process({kStart, TrackerEventKind::kForegroundChanged, 1});
+  std::int64_t t = kStart;
+  const int batch = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < batch; ++i) {
+      t += 5;
+      queue.TryPush({t, (i & 1) == 0 ? TrackerEventKind::kPointerDown
+                                     : TrackerEventKind::kPointerUp,
+                     0});
+    }
+    benchmark::DoNotOptimize(engine.ProcessQueue(&queue));
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_EngineProcessQueue)->Arg(16)->Arg(512);
+
+// 1 秒一个区间，在 N 个应用之间轮换；每 64 个区间过期检查并 drain 一次。
+void BM_SessionSegmenterInterval(benchmark::State& state) {
+  const AppId apps = static_cast<AppId>(state.range(0));
+  SessionSegmenter segmenter(5 * 60 * kMillisPerSecond);
+  std::vector<DrawingSession> out;
+  std::int64_t t = kStart;
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    // 偶尔留出超过阈值的空档，让会话真正结束。
+    const std::int64_t gap = (i % 1024) == 0 ? 10 * 60 * kMillisPerSecond : 0;
+    segmenter.OnInterval(static_cast<AppId>(1 + i % apps), t + gap,
+                         t + gap + kMillisPerSecond);
+    t += gap + kMillisPerSecond;
+    if ((++i & 63) == 0) {
+      segmenter.ExpireBefore(t);
+      out.clear();
+      segmenter.Drain(&out);
+      benchmark::DoNotOptimize(out.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SessionSegmenterInterval)->Arg(1)->Arg(8)->Arg(256);
+
+void BM_LiveStatusPublish(benchmark::State& state) {
+  LiveStatusLayout layout{};
+  LiveStatusWriter writer(&layout);
+  writer.Initialize();
+  LiveStatus status;
+  std::snprintf(status.app_name, sizeof(status.app_name), "photoshop.exe");
+  for (auto _ : state) {
+    status.today_total_millis += kMillisPerSecond;
+    writer.Publish(status);
+  }
+}
+BENCHMARK(BM_LiveStatusPublish);
+
+void BM_LiveStatusRead(benchmark::State& state) {
+  LiveStatusLayout layout{};
+  LiveStatusWriter writer(&layout);
+  writer.Initialize();
+  const LiveStatusReader reader(&layout);
+  LiveStatus out;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.Read(&out));
+  }
+}
+BENCHMARK(BM_LiveStatusRead);
+
+// 标题语料：四种绘画软件的常见标题格式 + 不匹配的其他应用，文档名大量重复。
+struct TitleSample {
+  std::string app;
+  std::string title;
+};
+
+std::vector<TitleSample> MakeTitleCorpus(int count) {
+  std::vector<TitleSample> corpus;
+  corpus.reserve(static_cast<std::size_t>(count));
+  for (int i = 0; i < count; ++i) {
+    const std::string doc = "canvas_" + std::to_string(i % 997);
+    switch (i % 5) {
+      case 0:
+        corpus.push_back({"photoshop.exe",
+                          doc + ".psd @ 66.7% (Layer " + std::to_string(i % 13) +
+                              ", RGB/8#) *"});
+        break;
+      case 1:
+        corpus.push_back({"krita.exe", doc + ".kra * - Krita"});
+        break;
+      case 2:
+        corpus.push_back(
+            {"clipstudiopaint.exe", "CLIP STUDIO PAINT EX - [" + doc + ".clip]"});
+        break;
+      case 3:
+        corpus.push_back({"sai2.exe", "PaintTool SAI Ver.2 - [" + doc + ".sai2]"});
+        break;
+      default:
+        corpus.push_back({"chrome.exe", doc + " - Google Chrome"});
+        break;
+    }
+  }
+  return corpus;
+}
+
+void BM_TitleRulesCompile(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TitleRuleSet::Compile(kDefaultTitleRules, nullptr));
+  }
+}
+BENCHMARK(BM_TitleRulesCompile);
+
+void BM_TitleExtract(benchmark::State& state) {
+  const auto rules = TitleRuleSet::Compile(kDefaultTitleRules, nullptr);
+  const auto corpus = MakeTitleCorpus(static_cast<int>(state.range(0)));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const TitleSample& sample = corpus[i];
+    benchmark::DoNotOptimize(rules->Extract(sample.app, sample.title));
+    i = (i + 1) % corpus.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TitleExtract)->Arg(100000);
+
+// 标题变化事件的完整处理：规则提取 + 文档名驻留。
+void BM_TitleExtractAndIntern(benchmark::State& state) {
+  const auto rules = TitleRuleSet::Compile(kDefaultTitleRules, nullptr);
+  const auto corpus = MakeTitleCorpus(static_cast<int>(state.range(0)));
+  AppInterner documents;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const TitleSample& sample = corpus[i];
+    const std::string_view doc = rules->Extract(sample.app, sample.title);
+    benchmark::DoNotOptimize(doc.empty() ? kNoDocument : documents.Intern(doc));
+    i = (i + 1) % corpus.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["documents"] = static_cast<double>(documents.size());
+}
+BENCHMARK(BM_TitleExtractAndIntern)->Arg(100000);
+
+// WM_NCHITTEST 热路径：鼠标在 pinned 小窗上移动时每个点查一次区域表。
+void BM_HitTestLookup(benchmark::State& state) {
+  HitTestRegions regions;
+  regions.SetScale(1.5);
+  regions.SetClientSize(540, 330);
+  std::int32_t x = 0;
+  std::int32_t y = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(regions.IsInteractive(x, y));
+    x = (x + 7) % 540;
+    y = (y + 3) % 330;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HitTestLookup);
+
+// 钩子回调里每个事件做一次计数 + 一次直方图记录，开销应远低于钩子预算。
+void BM_HistogramRecord(benchmark::State& state) {
+  auto registry = std::make_unique<MetricsRegistry>();
+  LatencyHistogram& histogram = registry->histogram(HistogramId::kMouseHook);
+  std::uint64_t value = 1;
+  for (auto _ : state) {
+    histogram.Record(value);
+    value = (value * 2862933555777941757ull + 3037000493ull) >> 44;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord);
+
+void BM_ScopedLatencyAndCount(benchmark::State& state) {
+  auto registry = std::make_unique<MetricsRegistry>();
+  for (auto _ : state) {
+    ScopedLatency scope(registry->histogram(HistogramId::kMouseHook));
+    registry->counter(CounterId::kMouseHookEvents).Increment();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScopedLatencyAndCount);
+
+// 键盘 hook 回调的全部工作：取时间 + 一次 relaxed store。
+void BM_KeyActivityHook(benchmark::State& state) {
+  SystemClock clock;
+  KeyActivityState keys;
+  for (auto _ : state) {
+    keys.OnKey(static_cast<std::uint64_t>(clock.NowUnixMillis()));
+  }
+  benchmark::DoNotOptimize(keys.last_key_millis());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeyActivityHook);
+
+void BM_MetricsSnapshot(benchmark::State& state) {
+  auto registry = std::make_unique<MetricsRegistry>();
+  auto snapshot = std::make_unique<MetricsSnapshot>();
+  for (auto _ : state) {
+    registry->Snapshot(snapshot.get());
+    benchmark::DoNotOptimize(snapshot->counters[0]);
+  }
+}
+BENCHMARK(BM_MetricsSnapshot);
+
+// 合成桌面：count 个随机大小 / 位置的窗口铺在 3840x2160 的双屏上，
+// 每 10 个窗口有一个属于被跟踪的绘画软件。
+void FillSyntheticDesktop(WindowVisibilityTracker* tracker, int count,
+                          AppId tracked_app, AppId other_app) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<std::int32_t> x(0, 3600);
+  std::uniform_int_distribution<std::int32_t> y(0, 2000);
+  std::uniform_int_distribution<std::int32_t> w(200, 1600);
+  std::uniform_int_distribution<std::int32_t> h(150, 1000);
+  for (int i = 0; i < count; ++i) {
+    const std::int32_t left = x(rng);
+    const std::int32_t top = y(rng);
+    tracker->Upsert(static_cast<std::uint64_t>(i + 1),
+                    i % 10 == 0 ? tracked_app : other_app,
+                    {left, top, left + w(rng), top + h(rng)}, true);
+  }
+}
+
+// 单个目标窗口被 range(0) 个窗口遮挡时的可见面积计算。
+void BM_VisibleArea(benchmark::State& state) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<std::int32_t> x(0, 3600);
+  std::uniform_int_distribution<std::int32_t> y(0, 2000);
+  std::uniform_int_distribution<std::int32_t> size(100, 600);
+  std::vector<WindowRect> occluders;
+  for (int i = 0; i < state.range(0); ++i) {
+    const std::int32_t left = x(rng);
+    const std::int32_t top = y(rng);
+    occluders.push_back({left, top, left + size(rng), top + size(rng)});
+  }
+  const WindowRect target{0, 0, 3840, 2160};
+  OcclusionCalculator calculator;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        calculator.VisibleArea(target, occluders.data(), occluders.size()));
+  }
+}
+BENCHMARK(BM_VisibleArea)->Arg(16)->Arg(100)->Arg(500);
+
+// 每次都有窗口移动（脏）时的完整重算：range(0) 个窗口，其中十分之一被跟踪。
+void BM_VisibilityCompute(benchmark::State& state) {
+  AppInterner interner;
+  const AppId krita = interner.Intern("krita.exe");
+  const AppId other = interner.Intern("chrome.exe");
+  const AppId foreground = interner.Intern("photoshop.exe");
+  TrackedAppSet tracked;
+  tracked.Add(krita);
+  WindowVisibilityTracker tracker;
+  tracker.SetTracked(tracked);
+  const int count = static_cast<int>(state.range(0));
+  FillSyntheticDesktop(&tracker, count, krita, other);
+  std::int32_t offset = 0;
+  for (auto _ : state) {
+    offset = (offset + 1) & 63;
+    tracker.Upsert(1, krita, {offset, 0, offset + 1200, 900}, true);
+    benchmark::DoNotOptimize(tracker.Compute(foreground, 50).size());
+  }
+}
+BENCHMARK(BM_VisibilityCompute)->Arg(100)->Arg(500);
+
+// 无窗口事件时读取缓存结果，对应 UsageService 每个 tick 的采样。
+void BM_VisibilityComputeCached(benchmark::State& state) {
+  AppInterner interner;
+  const AppId krita = interner.Intern("krita.exe");
+  const AppId other = interner.Intern("chrome.exe");
+  TrackedAppSet tracked;
+  tracked.Add(krita);
+  WindowVisibilityTracker tracker;
+  tracker.SetTracked(tracked);
+  FillSyntheticDesktop(&tracker, static_cast<int>(state.range(0)), krita,
+                       other);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tracker.Compute(kNoApp, 50).size());
+  }
+}
+BENCHMARK(BM_VisibilityComputeCached)->Arg(500);
+
+// 进程 CPU 时间采样：缓存句柄时每次只有一次读取；不缓存时每次额外
+// 打开 / 关闭一次（Linux 上是 /proc/<pid>/stat）。
+void BM_ProcessCpuSampleCached(benchmark::State& state) {
+  if (!ProcessCpuSampler::IsSupported()) {
+    state.SkipWithError("process sampling unsupported on this platform");
+    return;
+  }
+  const std::uint32_t pid = CurrentProcessId();
+  ProcessCpuSampler sampler;
+  std::int64_t cpu = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sampler.Sample(&pid, 1, &cpu));
+  }
+}
+BENCHMARK(BM_ProcessCpuSampleCached);
+
+void BM_ProcessCpuSampleUncached(benchmark::State& state) {
+  if (!ProcessCpuSampler::IsSupported()) {
+    state.SkipWithError("process sampling unsupported on this platform");
+    return;
+  }
+  const std::uint32_t pid = CurrentProcessId();
+  std::int64_t cpu = 0;
+  for (auto _ : state) {
+    ProcessCpuSampler sampler;
+    benchmark::DoNotOptimize(sampler.Sample(&pid, 1, &cpu));
+  }
+}
+BENCHMARK(BM_ProcessCpuSampleUncached);
+
+void BM_BusyClassifierSample(benchmark::State& state) {
+  BusyClassifier classifier;
+  std::int64_t now = kStart;
+  std::int64_t cpu = 0;
+  std::int64_t i = 0;
+  for (auto _ : state) {
+    now += 2000;
+    cpu += (++i & 7) < 4 ? 1800000 : 20000;
+    benchmark::DoNotOptimize(classifier.OnSample(now, cpu));
+  }
+}
+BENCHMARK(BM_BusyClassifierSample);
+
+}  // namespace
+}  // namespace ringotrack
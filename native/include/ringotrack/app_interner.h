@@ -0,0 +1,54 @@
+#ifndef RINGOTRACK_APP_INTERNER_H_
+#define RINGOTRACK_APP_INTERNER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ringotrack {
+
+// 驻留后的应用 ID；0 保留为「无应用」。
+using AppId = std::uint32_t;
+constexpr AppId kNoApp = 0;
+
+// 将 appId 字符串（exe 名 / bundleId）驻留为紧凑的整数 ID。
+//
+// 采用开放寻址哈希表 + 连续字符池，查找命中时无堆分配。
+// ID 从 1 开始按驻留顺序递增，生命周期内保持稳定。
+class AppInterner {
+ public:
+  AppInterner();
+
+  // 返回 name 对应的 ID，不存在时新建。
+  AppId Intern(std::string_view name);
+
+  // 仅查找，不存在时返回 kNoApp。
+  AppId Find(std::string_view name) const;
+
+  // 返回 ID 对应的名字；返回的 view 在下一次 Intern 之前有效。
+  std::string_view Name(AppId id) const;
+
+  // 已驻留的应用数量。
+  std::size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    std::uint32_t offset;
+    std::uint32_t length;
+    std::uint32_t hash;
+  };
+
+  static std::uint32_t Hash(std::string_view name);
+  std::size_t Probe(std::string_view name, std::uint32_t hash) const;
+  void Grow();
+
+  std::string pool_;
+  std::vector<Entry> entries_;
+  // 槽位存放 ID（0 表示空槽），容量始终为 2 的幂。
+  std::vector<AppId> slots_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_APP_INTERNER_H_
@@ -0,0 +1,104 @@
+#ifndef RINGOTRACK_CLIENT_LEASE_H_
+#define RINGOTRACK_CLIENT_LEASE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "ringotrack/shared_memory.h"
+
+namespace ringotrack {
+
+// 共享内存段的默认名字：UI 客户端与后台追踪守护进程按此名交接记账。
+constexpr char kClientLeaseSegmentName[] = "ringotrack.client_lease";
+
+constexpr std::uint32_t kClientLeaseMagic = 0x4C435452;  // "RTCL"
+constexpr std::uint32_t kClientLeaseVersion = 1;
+
+// UI 客户端的租约：客户端打开后自己记账，[attached_since, persisted_until]
+// 内的用时已由它写入数据库；守护进程只持久化租约之外的时段。
+//
+// 客户端每个节拍刷新 heartbeat，超过超时没有刷新（窗口关闭、引擎卡死）
+// 即视为失效，守护进程从 persisted_until 起接手。
+struct ClientLease {
+  // 0 表示当前没有客户端。
+  std::int64_t attached_since_millis = 0;
+  std::int64_t persisted_until_millis = 0;
+  std::int64_t heartbeat_millis = 0;
+
+  bool IsAlive(std::int64_t now_millis, std::int64_t timeout_millis) const {
+    return attached_since_millis != 0 && heartbeat_millis != 0 &&
+           now_millis - heartbeat_millis < timeout_millis;
+  }
+};
+
+// 共享内存中的二进制布局（版本 1），字段小端、自然对齐。
+// 客户端字段由 sequence 保护（seqlock，单写者为客户端）；
+// daemon_heartbeat_millis 只由守护进程写入。
+struct ClientLeaseLayout {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t size;
+  std::uint32_t reserved;
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::int64_t> attached_since_millis;
+  std::atomic<std::int64_t> persisted_until_millis;
+  std::atomic<std::int64_t> heartbeat_millis;
+  std::atomic<std::int64_t> daemon_heartbeat_millis;
+};
+
+static_assert(sizeof(ClientLeaseLayout) == 56, "layout v1 is frozen");
+
+// 客户端与守护进程都可能先创建段，头部不匹配时由打开的一方初始化。
+void InitializeClientLease(ClientLeaseLayout* layout);
+
+// 客户端侧：单写者。
+class ClientLeaseWriter {
+ public:
+  explicit ClientLeaseWriter(ClientLeaseLayout* layout) : layout_(layout) {}
+
+  // 从 since 起由客户端记账。
+  void Attach(std::int64_t since_millis, std::int64_t now_millis);
+
+  // 已写入数据库的截止时刻，同时刷新心跳。
+  void Report(std::int64_t persisted_until_millis, std::int64_t now_millis);
+
+  // 只刷新心跳（没有新的落库时）。
+  void Heartbeat(std::int64_t now_millis);
+
+  // 正常退出：最后一次落库之后调用，守护进程立即从 persisted_until 接手。
+  void Detach();
+
+ private:
+  void Write(const ClientLease& lease);
+
+  ClientLeaseLayout* layout_;
+  ClientLease lease_;
+};
+
+// 读取一致的租约快照；头部不匹配或与写者冲突超过 max_attempts 次时返回 false。
+bool ReadClientLease(const ClientLeaseLayout& layout, ClientLease* out,
+                     int max_attempts = 1000);
+
+// 持有共享内存段；客户端与守护进程各自打开一份。
+class ClientLeaseSegment {
+ public:
+  static std::unique_ptr<ClientLeaseSegment> Create(
+      const std::string& name = kClientLeaseSegmentName);
+
+  ClientLeaseLayout* layout() const {
+    return static_cast<ClientLeaseLayout*>(memory_->data());
+  }
+
+ private:
+  explicit ClientLeaseSegment(std::unique_ptr<SharedMemory> memory)
+      : memory_(std::move(memory)) {}
+
+  std::unique_ptr<SharedMemory> memory_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_CLIENT_LEASE_H_
@@ -0,0 +1,87 @@
+#ifndef RINGOTRACK_CLOCK_H_
+#define RINGOTRACK_CLOCK_H_
+
+#include <cstdint>
+
+namespace ringotrack {
+
+constexpr std::int64_t kMillisPerSecond = 1000;
+constexpr std::int64_t kMillisPerMinute = 60 * kMillisPerSecond;
+constexpr std::int64_t kMillisPerHour = 60 * kMillisPerMinute;
+constexpr std::int64_t kMillisPerDay = 24 * kMillisPerHour;
+
+// FILETIME: 1601-01-01 起每 100ns 一个 tick，与 Unix epoch 相差的 tick 数。
+constexpr std::uint64_t kFileTimeUnixEpochDifference = 116444736000000000ULL;
+
+// 将 FILETIME tick 转为 Unix epoch 毫秒；早于 Unix epoch 时返回 0。
+constexpr std::uint64_t FileTimeTicksToUnixMillis(std::uint64_t ticks) {
+  return ticks < kFileTimeUnixEpochDifference
+             ? 0
+             : (ticks - kFileTimeUnixEpochDifference) / 10000ULL;
+}
+
+// 时间源抽象：生产环境使用系统时钟，测试 / 回放使用 ManualClock。
+class Clock {
+ public:
+  virtual ~Clock() = default;
+
+  // 当前时间（Unix epoch 毫秒）。
+  virtual std::int64_t NowUnixMillis() const = 0;
+
+  // 指定时刻本地时间相对 UTC 的偏移（毫秒，东八区为 +8h）。
+  virtual std::int64_t LocalOffsetMillis(std::int64_t unix_millis) const = 0;
+};
+
+// 基于操作系统的时钟，本地时区偏移按 15 分钟窗口缓存，
+// 避免在聚合热路径上反复调用 localtime。非线程安全。
+class SystemClock : public Clock {
+ public:
+  std::int64_t NowUnixMillis() const override;
+  std::int64_t LocalOffsetMillis(std::int64_t unix_millis) const override;
+
+ private:
+  mutable std::int64_t cached_window_ = -1;
+  mutable std::int64_t cached_offset_ = 0;
+};
+
+// 手动推进的时钟，时区偏移固定。
+class ManualClock : public Clock {
+ public:
+  explicit ManualClock(std::int64_t now_unix_millis = 0,
+                       std::int64_t offset_millis = 0)
+      : now_(now_unix_millis), offset_(offset_millis) {}
+
+  std::int64_t NowUnixMillis() const override { return now_; }
+  std::int64_t LocalOffsetMillis(std::int64_t) const override {
+    return offset_;
+  }
+
+  void Set(std::int64_t now_unix_millis) { now_ = now_unix_millis; }
+  void Advance(std::int64_t delta_millis) { now_ += delta_millis; }
+
+ private:
+  std::int64_t now_;
+  std::int64_t offset_;
+};
+
+// 某一时刻所在的本地小时。
+struct LocalHour {
+  // 本地日期编号：自 1970-01-01（本地）起的天数。
+  std::int32_t day;
+  // 当天的第几个小时（0-23）。
+  std::int32_t hour;
+  // 该小时结束（下一小时开始）的 Unix 毫秒。
+  std::int64_t end_unix_millis;
+};
+
+LocalHour LocalHourAt(const Clock& clock, std::int64_t unix_millis);
+
+// 本地日期编号 <-> 年月日（公历），用于与 Dart 侧 DateTime 对齐。
+std::int32_t DayNumberFromCivil(std::int32_t year, std::uint32_t month,
+                                std::uint32_t day);
+void CivilFromDayNumber(std::int32_t day_number, std::int32_t* year,
+                        std::uint32_t* month, std::uint32_t* day);
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_CLOCK_H_
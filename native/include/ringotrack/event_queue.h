@@ -0,0 +1,116 @@
+#ifndef RINGOTRACK_EVENT_QUEUE_H_
+#define RINGOTRACK_EVENT_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ringotrack {
+
+// 追踪事件类型。
+enum class TrackerEventKind : std::uint32_t {
+  // 前台应用切换，app_id 为新的前台应用（0 表示无可用前台应用）。
+  kForegroundChanged = 1,
+  // 左键 / 落笔按下。
+  kPointerDown = 2,
+  // 左键 / 落笔抬起。
+  kPointerUp = 3,
+  // 会话锁定 / 解锁（WTS_SESSION_LOCK / UNLOCK，logind Lock / Unlock）。
+  kSessionLocked = 4,
+  kSessionUnlocked = 5,
+  // 系统即将休眠 / 已唤醒（PBT_APMSUSPEND / PBT_APMRESUME*，
+  // logind PrepareForSleep(true / false)）。
+  kSystemSuspend = 6,
+  kSystemResume = 7,
+  // 有按键发生（只有时间，不含按键内容），作为 Idle 判定的辅助活动来源。
+  kKeyActivity = 8,
+};
+
+// 由 hook / 轮询线程产生、由聚合线程消费的定长事件。
+struct TrackerEvent {
+  std::int64_t timestamp_millis;
+  TrackerEventKind kind;
+  std::uint32_t app_id;
+};
+
+// 单生产者 / 单消费者的无锁环形队列。
+//
+// kCapacity 必须是 2 的幂；队列满时 TryPush 返回 false，由调用方决定丢弃策略。
+template <typename T, std::size_t kCapacity>
+class SpscQueue {
+  static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+                "kCapacity must be a power of two");
+
+ public:
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // 生产者线程调用。
+  bool TryPush(const T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == kCapacity) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == kCapacity) {
+        return false;
+      }
+    }
+    slots_[tail & kMask] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 消费者线程调用。
+  bool TryPop(T* out) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    *out = slots_[head & kMask];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 消费者线程调用：批量取出最多 max_count 个元素，返回实际数量。
+  std::size_t PopBatch(T* out, std::size_t max_count) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    tail_cache_ = tail_.load(std::memory_order_acquire);
+    std::size_t available = tail_cache_ - head;
+    if (available > max_count) {
+      available = max_count;
+    }
+    for (std::size_t i = 0; i < available; ++i) {
+      out[i] = slots_[(head + i) & kMask];
+    }
+    head_.store(head + available, std::memory_order_release);
+    return available;
+  }
+
+  // 近似值，仅用于诊断。
+  std::size_t SizeApprox() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  static constexpr std::size_t capacity() { return kCapacity; }
+
+ private:
+  static constexpr std::size_t kMask = kCapacity - 1;
+  static constexpr std::size_t kCacheLine = 64;
+
+  alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;  // 仅消费者访问
+  alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;  // 仅生产者访问
+  alignas(kCacheLine) T slots_[kCapacity]{};
+};
+
+// 追踪事件队列的默认容量：1 秒一次 drain 时足以容纳任何现实的输入频率。
+using TrackerEventQueue = SpscQueue<TrackerEvent, 1024>;
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_EVENT_QUEUE_H_
@@ -0,0 +1,88 @@
+#ifndef RINGOTRACK_HIT_TEST_REGIONS_H_
+#define RINGOTRACK_HIT_TEST_REGIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ringotrack {
+
+// 交互区域相对于客户区哪个角定位；窗口尺寸变化时区域跟随该角移动。
+enum class RegionAnchor : std::uint32_t {
+  kTopLeft = 0,
+  kTopRight = 1,
+  kBottomLeft = 2,
+  kBottomRight = 3,
+};
+
+// 以逻辑像素（DIP）描述的交互区域。x / y 为区域外侧边到锚定角的距离，
+// 例如右上角锚定时 x 是区域右边到客户区右边的距离。
+// 布局与 Dart 侧 FFI 结构体一致，只使用定长字段。
+struct InteractiveRegion {
+  RegionAnchor anchor;
+  std::int32_t x;
+  std::int32_t y;
+  std::int32_t width;
+  std::int32_t height;
+};
+
+// pinned 小窗的命中测试表：区域内的点交给 Flutter 处理点击，其余视为
+// 可拖动的标题栏。
+//
+// 缩放比例与客户区尺寸只在 WM_DPICHANGED / WM_SIZE 时更新，并在那时把
+// 区域换算成物理像素矩形；WM_NCHITTEST 只做几次整数比较，不再查询
+// 显示器 DPI 或客户区。默认包含右上角（pin 按钮）与右下角（lock 按钮）
+// 两块 80 DIP 的区域。
+//
+// 本类不加锁，由调用方保证更新与查询不并发。
+class HitTestRegions {
+ public:
+  static constexpr std::size_t kMaxRegions = 16;
+  static constexpr std::int32_t kDefaultCornerDip = 80;
+
+  HitTestRegions();
+
+  // 替换全部区域；数量超过 kMaxRegions 或某个区域尺寸非正时返回 false，
+  // 原有区域保持不变。count 为 0 表示没有交互区域（整窗可拖动）。
+  bool SetRegions(const InteractiveRegion* regions, std::size_t count);
+
+  // 恢复为默认的两个角落区域。
+  void ResetToDefaults();
+
+  // 缩放比例（DPI / 96），非正值按 1.0 处理。
+  void SetScale(double scale);
+
+  // 客户区尺寸（物理像素）。
+  void SetClientSize(std::int32_t width, std::int32_t height);
+
+  // 客户区坐标（物理像素）是否落在某个交互区域内（含边界）。
+  bool IsInteractive(std::int32_t x, std::int32_t y) const;
+
+  // 点是否在客户区内（含边界）。
+  bool InClient(std::int32_t x, std::int32_t y) const {
+    return x >= 0 && y >= 0 && x <= width_ && y <= height_;
+  }
+
+  double scale() const { return scale_; }
+  std::size_t size() const { return count_; }
+
+ private:
+  struct Rect {
+    std::int32_t left;
+    std::int32_t top;
+    std::int32_t right;
+    std::int32_t bottom;
+  };
+
+  void Rebuild();
+
+  InteractiveRegion regions_[kMaxRegions];
+  Rect scaled_[kMaxRegions];
+  std::size_t count_ = 0;
+  double scale_ = 1.0;
+  std::int32_t width_ = 0;
+  std::int32_t height_ = 0;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_HIT_TEST_REGIONS_H_
@@ -0,0 +1,68 @@
+#ifndef RINGOTRACK_HOURLY_AGGREGATOR_H_
+#define RINGOTRACK_HOURLY_AGGREGATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+#include "ringotrack/clock.h"
+#include "ringotrack/session_segmenter.h"
+#include "ringotrack/tracked_app_set.h"
+
+namespace ringotrack {
+
+// 「本地日期 + 小时 + App」的一个用时桶（毫秒精度）。
+struct UsageBucket {
+  std::int32_t day;  // 本地日期编号，见 LocalHour::day
+  std::int32_t hour;
+  AppId app_id;
+  std::int64_t millis;
+};
+
+// 小时级聚合器：Dart 侧 HourlyUsageAggregator 的 native 版本。
+//
+// 前台区间在本地小时边界处切分；未 drain 的桶保存在一个很小的线性数组里——
+// 正常 1 秒一次 drain 时只会有 1~2 个活跃桶，线性查找比哈希表更快。
+class HourlyAggregator {
+ public:
+  // tracked 为 nullptr 时统计所有应用；否则只统计集合内的应用。
+  // clock 与 tracked 的生命周期需覆盖本对象。
+  HourlyAggregator(const Clock* clock, const TrackedAppSet* tracked)
+      : clock_(clock), tracked_(tracked) {}
+
+  void set_tracked(const TrackedAppSet* tracked) { tracked_ = tracked; }
+
+  // 可选：把通过过滤的每个区间（切分到小时之前）同时交给会话切分器。
+  void set_session_segmenter(SessionSegmenter* segmenter) {
+    segmenter_ = segmenter;
+  }
+
+  // 结束当前区间并开启新区间；app_id 为 kNoApp 表示进入「不计时」状态。
+  void OnForegroundChanged(AppId app_id, std::int64_t timestamp_millis);
+
+  // 结束当前区间，不再开启新区间。
+  void CloseAt(std::int64_t timestamp_millis);
+
+  // 把累计桶追加到 out 并清空内部缓存，返回追加的数量。
+  std::size_t Drain(std::vector<UsageBucket>* out);
+
+  AppId current_app() const { return current_app_; }
+  std::int64_t current_start_millis() const { return current_start_; }
+  bool has_pending() const { return !pending_.empty(); }
+
+ private:
+  void AddInterval(AppId app_id, std::int64_t start, std::int64_t end);
+  void Accumulate(std::int32_t day, std::int32_t hour, AppId app_id,
+                  std::int64_t millis);
+
+  const Clock* clock_;
+  const TrackedAppSet* tracked_;
+  SessionSegmenter* segmenter_ = nullptr;
+  AppId current_app_ = kNoApp;
+  std::int64_t current_start_ = 0;
+  std::vector<UsageBucket> pending_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_HOURLY_AGGREGATOR_H_
@@ -0,0 +1,68 @@
+#ifndef RINGOTRACK_IDLE_STATE_H_
+#define RINGOTRACK_IDLE_STATE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ringotrack {
+
+// 活动来源。键盘只记录「有按键发生」的时间，不含按键内容。
+enum class ActivitySource : std::uint32_t {
+  kPointer = 0,
+  kKeyboard,
+  kCount,
+};
+
+enum class IdleTransition {
+  kNone,
+  kEnterIdle,
+  kLeaveIdle,
+};
+
+// AFK 判定状态机，与 Dart 侧 UsageService 的 _onStrokeEvent / _onTick 语义一致：
+// - 左键按住期间视为持续活动；
+// - 距最近一次落笔 / 抬笔超过阈值进入 Idle；
+// - Idle 中只有「按下」才会立即恢复，tick 检测到活动也会恢复。
+//
+// 各来源按权重折算活动窗口：一次活动让状态在 threshold * weight 内保持活跃，
+// 取所有来源中最晚的截止时间。落笔默认权重 1（与只看左键时完全一致），
+// 键盘默认 0.5：快捷键多为零星操作，单独出现时只延长半个阈值。权重为 0
+// 表示忽略该来源。
+class IdleStateMachine {
+ public:
+  static constexpr double kDefaultKeyboardWeight = 0.5;
+
+  IdleStateMachine(std::int64_t threshold_millis, std::int64_t now_millis);
+
+  IdleTransition OnPointer(std::int64_t timestamp_millis, bool is_down);
+  // 非落笔来源的一次活动；Idle 中会立即恢复（权重为 0 时忽略）。
+  IdleTransition OnActivity(ActivitySource source,
+                            std::int64_t timestamp_millis);
+  IdleTransition OnTick(std::int64_t now_millis);
+
+  void SetWeight(ActivitySource source, double weight);
+
+  // 锁屏 / 休眠时按键状态已不可信（抬起事件可能永远不会到达），清掉「按住」标记。
+  void ReleasePointer() { pointer_down_ = false; }
+
+  bool is_idle() const { return is_idle_; }
+  bool pointer_down() const { return pointer_down_; }
+  std::int64_t last_activity_millis() const { return last_activity_millis_; }
+  // 按权重折算后的活跃截止时间，到达即进入 Idle。
+  std::int64_t active_until_millis() const { return active_until_millis_; }
+  std::int64_t threshold_millis() const { return threshold_millis_; }
+
+ private:
+  void Extend(ActivitySource source, std::int64_t timestamp_millis);
+
+  std::int64_t threshold_millis_;
+  std::int64_t last_activity_millis_;
+  std::int64_t active_until_millis_;
+  std::int64_t window_millis_[static_cast<std::size_t>(ActivitySource::kCount)];
+  bool is_idle_ = false;
+  bool pointer_down_ = false;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_IDLE_STATE_H_
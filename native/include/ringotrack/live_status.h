@@ -0,0 +1,114 @@
+#ifndef RINGOTRACK_LIVE_STATUS_H_
+#define RINGOTRACK_LIVE_STATUS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ringotrack/shared_memory.h"
+
+namespace ringotrack {
+
+// 共享内存段的默认名字，外部工具（直播叠加层、状态栏等）按此名只读打开。
+constexpr char kLiveStatusSegmentName[] = "ringotrack.live_status";
+
+constexpr std::uint32_t kLiveStatusMagic = 0x534C5452;  // "RTLS"
+constexpr std::uint32_t kLiveStatusVersion = 1;
+constexpr std::size_t kLiveStatusAppNameBytes = 128;
+
+// 「当前在画什么、今天画了多久」的快照。
+struct LiveStatus {
+  std::int64_t updated_at_millis = 0;
+  // 当前连续使用区间的开始时间；未在统计中的应用时为 0。
+  std::int64_t session_start_millis = 0;
+  // 今日（本地日期）累计使用时长。
+  std::int64_t today_total_millis = 0;
+  std::uint32_t app_id = 0;
+  bool is_idle = false;
+  // 当前前台应用是否在统计列表里。
+  bool is_tracking = false;
+  // UTF-8，NUL 结尾；超长时截断。
+  char app_name[kLiveStatusAppNameBytes] = {};
+};
+
+// 共享内存中的二进制布局（版本 1）。外部读取方可以直接按此布局解析：
+// 所有字段小端、自然对齐，sequence 为 seqlock 计数（奇数表示写入中）。
+struct LiveStatusLayout {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t size;
+  std::uint32_t reserved;
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::int64_t> updated_at_millis;
+  std::atomic<std::int64_t> session_start_millis;
+  std::atomic<std::int64_t> today_total_millis;
+  std::atomic<std::uint32_t> app_id;
+  // bit0: is_idle，bit1: is_tracking
+  std::atomic<std::uint32_t> flags;
+  std::atomic<std::uint64_t> app_name_words[kLiveStatusAppNameBytes / 8];
+};
+
+static_assert(sizeof(LiveStatusLayout) == 184, "layout v1 is frozen");
+
+// 单写者：原地更新布局，读者无需加锁。
+class LiveStatusWriter {
+ public:
+  explicit LiveStatusWriter(LiveStatusLayout* layout) : layout_(layout) {}
+
+  // 写入头部并清零内容；在发布第一条状态之前调用一次。
+  void Initialize();
+
+  void Publish(const LiveStatus& status);
+
+ private:
+  LiveStatusLayout* layout_;
+};
+
+// 读者：可在任意进程 / 线程中并发调用。
+class LiveStatusReader {
+ public:
+  explicit LiveStatusReader(const LiveStatusLayout* layout)
+      : layout_(layout) {}
+
+  // 读取一致的快照；头部不匹配或重试 max_attempts 次仍与写者冲突时返回 false。
+  bool Read(LiveStatus* out, int max_attempts = 1000) const;
+
+ private:
+  const LiveStatusLayout* layout_;
+};
+
+// 持有共享内存段并对外发布状态。
+class LiveStatusPublisher {
+ public:
+  static std::unique_ptr<LiveStatusPublisher> Create(
+      const std::string& name = kLiveStatusSegmentName);
+
+  void Publish(const LiveStatus& status) { writer_.Publish(status); }
+
+ private:
+  explicit LiveStatusPublisher(std::unique_ptr<SharedMemory> memory);
+
+  std::unique_ptr<SharedMemory> memory_;
+  LiveStatusWriter writer_;
+};
+
+// 只读订阅方使用的便捷封装。
+class LiveStatusSubscriber {
+ public:
+  static std::unique_ptr<LiveStatusSubscriber> Open(
+      const std::string& name = kLiveStatusSegmentName);
+
+  bool Read(LiveStatus* out) const { return reader_.Read(out); }
+
+ private:
+  explicit LiveStatusSubscriber(std::unique_ptr<SharedMemory> memory);
+
+  std::unique_ptr<SharedMemory> memory_;
+  LiveStatusReader reader_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_LIVE_STATUS_H_
@@ -0,0 +1,146 @@
+#ifndef RINGOTRACK_METRICS_H_
+#define RINGOTRACK_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ringotrack {
+
+// 单调时钟（纳秒），只用于测量耗时；与 Clock 的墙钟无关。
+std::int64_t MonotonicNanos();
+
+// 固定的计数器集合。新增项追加在 kCount 之前，Dart 侧按下标读取。
+enum class CounterId : std::uint32_t {
+  kForegroundQueries = 0,
+  kNoForegroundWindow,
+  kOpenProcessFailures,
+  kQueryPathFailures,
+  kMouseHookEvents,
+  kSessionEventsDrained,
+  kSessionEventsDropped,
+  kCount,
+};
+
+// 固定的延迟直方图集合（单位纳秒）。
+enum class HistogramId : std::uint32_t {
+  // rt_get_foreground_app 整体耗时。
+  kForegroundQuery = 0,
+  // LowLevelMouseProc 在调用 CallNextHookEx 之前占用钩子链的时间。
+  kMouseHook,
+  // rt_drain_session_events 耗时。
+  kSessionDrain,
+  // rt_query_foreground_activity 实际读取进程 CPU 时间的耗时（限频命中缓存
+  // 时不记录）。
+  kProcessSample,
+  kCount,
+};
+
+constexpr std::size_t kCounterCount =
+    static_cast<std::size_t>(CounterId::kCount);
+constexpr std::size_t kHistogramCount =
+    static_cast<std::size_t>(HistogramId::kCount);
+
+// 无锁计数器，可在任意线程递增。
+class Counter {
+ public:
+  void Increment(std::uint64_t n = 1) {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+  std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+  void Reset() { value_.store(0, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+// 直方图快照，布局固定供 FFI 读取。
+struct HistogramSnapshot;
+
+// 对数-线性直方图：小于 8 的值各占一个桶，之后每个 2 的幂区间再线性切成
+// 8 个子桶，相对误差不超过 12.5%，覆盖完整的 uint64 范围。
+// Record 只做几次 relaxed 原子加法，可在钩子回调等热路径上调用；
+// 快照不是严格一致的（各字段分别读取），用于诊断足够。
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) *
+                                              kSubBuckets;
+
+  static std::size_t BucketIndex(std::uint64_t value);
+  // 桶覆盖 [BucketLowerBound(i), BucketLowerBound(i + 1))。
+  static std::uint64_t BucketLowerBound(std::size_t index);
+
+  void Record(std::uint64_t value);
+  void Snapshot(HistogramSnapshot* out) const;
+  void Reset();
+
+ private:
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+  std::atomic<std::uint64_t> buckets_[kBucketCount] = {};
+};
+
+struct HistogramSnapshot {
+  std::uint64_t count;
+  std::uint64_t sum;
+  std::uint64_t max;
+  std::uint64_t buckets[LatencyHistogram::kBucketCount];
+};
+
+// 快照中分位数 q（0~1）所在桶的上界；没有样本时返回 0。
+std::uint64_t ValueAtQuantile(const HistogramSnapshot& snapshot, double q);
+
+constexpr std::uint32_t kMetricsSnapshotVersion = 1;
+
+// rt_read_metrics 返回的整体快照。头部记录各段长度，Dart 侧据此校验布局。
+struct MetricsSnapshot {
+  std::uint32_t version;
+  std::uint32_t counter_count;
+  std::uint32_t histogram_count;
+  std::uint32_t bucket_count;
+  std::uint64_t counters[kCounterCount];
+  HistogramSnapshot histograms[kHistogramCount];
+};
+
+// 进程内的计数器与直方图注册表；所有成员都可并发访问。
+class MetricsRegistry {
+ public:
+  Counter& counter(CounterId id) {
+    return counters_[static_cast<std::size_t>(id)];
+  }
+  LatencyHistogram& histogram(HistogramId id) {
+    return histograms_[static_cast<std::size_t>(id)];
+  }
+
+  void Snapshot(MetricsSnapshot* out) const;
+  void Reset();
+
+ private:
+  Counter counters_[kCounterCount];
+  LatencyHistogram histograms_[kHistogramCount];
+};
+
+// 作用域计时：析构时把经过的纳秒数记入直方图。
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram& histogram)
+      : histogram_(histogram), start_(MonotonicNanos()) {}
+  ~ScopedLatency() {
+    const std::int64_t elapsed = MonotonicNanos() - start_;
+    histogram_.Record(elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0);
+  }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram& histogram_;
+  std::int64_t start_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_METRICS_H_
@@ -0,0 +1,60 @@
+#ifndef RINGOTRACK_PIN_STATE_H_
+#define RINGOTRACK_PIN_STATE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace ringotrack {
+
+// pinned 小窗模式 / 锁定状态。
+//
+// 平台层负责真正的窗口操作，这里只维护状态转换规则：
+// - 只有在 pinned 模式下才允许锁定 / 解锁；
+// - 退出 pinned 模式时自动解锁。
+class PinState {
+ public:
+  bool is_pinned() const { return pinned_.load(std::memory_order_acquire); }
+  bool is_locked() const { return locked_.load(std::memory_order_acquire); }
+
+  void MarkPinned() { pinned_.store(true, std::memory_order_release); }
+
+  void MarkUnpinned() {
+    pinned_.store(false, std::memory_order_release);
+    locked_.store(false, std::memory_order_release);
+  }
+
+  // 返回 false 表示当前不在 pinned 模式，无法锁定。
+  bool Lock() {
+    if (!is_pinned()) {
+      return false;
+    }
+    locked_.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // 返回 false 表示当前不在 pinned 模式，无法解锁。
+  bool Unlock() {
+    if (!is_pinned()) {
+      return false;
+    }
+    locked_.store(false, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::atomic<bool> pinned_{false};
+  std::atomic<bool> locked_{false};
+};
+
+// AccentPolicy.GradientColor 的打包：按 AABBGGRR 排列。
+constexpr std::uint32_t PackAccentGradientColor(std::uint8_t r, std::uint8_t g,
+                                                std::uint8_t b,
+                                                std::uint8_t alpha) {
+  return (static_cast<std::uint32_t>(alpha) << 24) |
+         (static_cast<std::uint32_t>(b) << 16) |
+         (static_cast<std::uint32_t>(g) << 8) | static_cast<std::uint32_t>(r);
+}
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_PIN_STATE_H_
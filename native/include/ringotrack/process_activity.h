@@ -0,0 +1,97 @@
+#ifndef RINGOTRACK_PROCESS_ACTIVITY_H_
+#define RINGOTRACK_PROCESS_ACTIVITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ringotrack {
+
+// 按 pid 读取进程累计 CPU 时间（所有线程的用户态 + 内核态，微秒）。
+//
+// - Windows：OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION) + GetProcessTimes；
+// - Linux：/proc/<pid>/stat 的 utime + stime，文件保持打开，每次从头 pread。
+//
+// 句柄按 pid 缓存，一批 pid 一次调用；本批没有出现的 pid 的句柄随即关闭，
+// 不长期占用已经离开前台的进程。缓存句柄读取失败（进程已退出、pid 被复用）
+// 时重新打开一次。其它平台不支持，Sample 总是返回 0。非线程安全。
+class ProcessCpuSampler {
+ public:
+  ProcessCpuSampler() = default;
+  ~ProcessCpuSampler();
+
+  ProcessCpuSampler(const ProcessCpuSampler&) = delete;
+  ProcessCpuSampler& operator=(const ProcessCpuSampler&) = delete;
+
+  static bool IsSupported();
+
+  // 依次写入 cpu_micros[i]，读取失败的位置为 -1；返回成功的个数。
+  std::size_t Sample(const std::uint32_t* pids, std::size_t count,
+                     std::int64_t* cpu_micros);
+
+  // 关闭全部缓存的句柄。
+  void Clear();
+
+  std::size_t cached_handles() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    std::uint32_t pid;
+    std::intptr_t handle;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<Entry> next_;
+};
+
+enum class BusyTransition {
+  kNone,
+  kEnterBusy,
+  kLeaveBusy,
+};
+
+struct BusyClassifierConfig {
+  // 一个采样间隔内 CPU 时间与墙钟时间之比（千分比，1000 = 占满一个核，
+  // 多核并行时可以超过 1000）达到该值算「忙」采样。
+  std::uint32_t busy_permille = 250;
+  // 连续多少个「忙」采样进入忙碌、连续多少个「闲」采样退出，滤掉自动保存、
+  // 缩略图刷新之类的零星尖峰。
+  std::uint32_t enter_samples = 2;
+  std::uint32_t exit_samples = 2;
+  // 相邻采样超过该间隔（休眠、长时间未采样）时不计算差值，重新建立基线。
+  std::int64_t max_gap_millis = 60 * 1000;
+};
+
+// 把同一进程的 CPU 时间采样序列分类为「忙碌」区间：滤镜、导出、3D 渲染等
+// 没有输入的长操作。进入 / 退出的时刻是连续忙 / 闲采样中第一个间隔的
+// 起点，而不是确认时的采样时刻。
+class BusyClassifier {
+ public:
+  explicit BusyClassifier(const BusyClassifierConfig& config = {});
+
+  BusyTransition OnSample(std::int64_t wall_millis, std::int64_t cpu_micros);
+
+  // 换了一个进程（前台切换）：丢弃基线；忙碌中时在 at_millis 结束。
+  BusyTransition Reset(std::int64_t at_millis);
+
+  bool is_busy() const { return is_busy_; }
+  // 最近一次进入 / 退出忙碌的时刻。
+  std::int64_t changed_at_millis() const { return changed_at_millis_; }
+  // 最近一个有效采样间隔的 CPU 占用（千分比）。
+  std::uint32_t last_permille() const { return last_permille_; }
+
+ private:
+  BusyClassifierConfig config_;
+  bool has_baseline_ = false;
+  std::int64_t last_wall_millis_ = 0;
+  std::int64_t last_cpu_micros_ = 0;
+  std::uint32_t last_permille_ = 0;
+  std::uint32_t streak_ = 0;
+  std::int64_t streak_start_millis_ = 0;
+  bool is_busy_ = false;
+  std::int64_t changed_at_millis_ = 0;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_PROCESS_ACTIVITY_H_
@@ -0,0 +1,62 @@
+#ifndef RINGOTRACK_SESSION_SEGMENTER_H_
+#define RINGOTRACK_SESSION_SEGMENTER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+
+namespace ringotrack {
+
+// 一段绘画会话：同一应用的计时区间，间隔不超过合并阈值的视为同一段。
+struct DrawingSession {
+  AppId app_id;
+  std::int64_t start_millis;
+  std::int64_t end_millis;
+  // 实际计时的时长，不含被合并的间隔（Idle、切到其它应用等）。
+  std::int64_t active_millis;
+};
+
+// 在线会话切分器：输入 HourlyAggregator 结算出的计时区间，按应用维护
+// 「进行中」的会话，间隔超过 merge_gap 时结束旧会话、开始新会话。
+//
+// 每个区间 O(1)：按 AppId 直接索引到进行中的会话（AppId 由 AppInterner
+// 从 1 连续分配）。同一时刻进行中的会话只有最近用过的几个应用，
+// ExpireBefore 线性扫描它们。
+class SessionSegmenter {
+ public:
+  explicit SessionSegmenter(std::int64_t merge_gap_millis)
+      : merge_gap_(merge_gap_millis) {}
+
+  // 区间按结束时刻非递减的顺序到达；同一应用的区间不重叠。
+  void OnInterval(AppId app_id, std::int64_t start_millis,
+                  std::int64_t end_millis);
+
+  // 结束最后一个区间早于 now - merge_gap 的会话：此后再出现的区间
+  // 只会开始新会话。
+  void ExpireBefore(std::int64_t now_millis);
+
+  // 结束所有进行中的会话（例如退出时）。
+  void CloseAll();
+
+  // 把已结束的会话追加到 out 并清空，返回追加的数量。
+  std::size_t Drain(std::vector<DrawingSession>* out);
+
+  std::int64_t merge_gap_millis() const { return merge_gap_; }
+  std::size_t open_sessions() const { return open_.size(); }
+
+ private:
+  static constexpr std::int32_t kNoSlot = -1;
+
+  void Finish(std::size_t index);
+
+  std::int64_t merge_gap_;
+  // AppId -> open_ 下标；不在进行中时为 kNoSlot。
+  std::vector<std::int32_t> slot_of_app_;
+  std::vector<DrawingSession> open_;
+  std::vector<DrawingSession> finished_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_SESSION_SEGMENTER_H_
@@ -0,0 +1,46 @@
+#ifndef RINGOTRACK_SHARED_MEMORY_H_
+#define RINGOTRACK_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace ringotrack {
+
+// 具名共享内存段：Windows 上为 Local\ 命名空间下的 file mapping，
+// POSIX 上为 shm_open + mmap。
+//
+// name 只允许 ASCII，不带前缀（例如 "ringotrack.live_status"）。
+class SharedMemory {
+ public:
+  ~SharedMemory();
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+
+  // 创建（或打开已存在的）可写段，失败返回 nullptr。
+  static std::unique_ptr<SharedMemory> Create(const std::string& name,
+                                              std::size_t size);
+
+  // 只读打开已存在的段，不存在或尺寸不足时返回 nullptr。
+  static std::unique_ptr<SharedMemory> OpenReadOnly(const std::string& name,
+                                                    std::size_t size);
+
+  // 删除段名（POSIX），已有映射不受影响；Windows 上段随最后一个句柄释放。
+  static void Unlink(const std::string& name);
+
+  void* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  SharedMemory(void* data, std::size_t size, void* handle)
+      : data_(data), size_(size), handle_(handle) {}
+
+  void* data_;
+  std::size_t size_;
+  void* handle_;  // Windows 下为 mapping HANDLE，POSIX 下不使用
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_SHARED_MEMORY_H_
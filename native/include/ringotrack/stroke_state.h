@@ -0,0 +1,52 @@
+#ifndef RINGOTRACK_STROKE_STATE_H_
+#define RINGOTRACK_STROKE_STATE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace ringotrack {
+
+// 全局左键 / 落笔状态：由低级鼠标 hook 写入，由 FFI 轮询读取。
+// hook 回调中只做 relaxed store，尽量缩短占用 hook 链的时间。
+class StrokeState {
+ public:
+  void OnButton(bool is_down, std::uint64_t timestamp_millis) {
+    last_stroke_millis_.store(timestamp_millis, std::memory_order_relaxed);
+    button_down_.store(is_down, std::memory_order_relaxed);
+  }
+
+  // 初始化一次，避免读取方立即判定为 Idle。
+  void Reset(std::uint64_t now_millis) { OnButton(false, now_millis); }
+
+  std::uint64_t last_stroke_millis() const {
+    return last_stroke_millis_.load(std::memory_order_relaxed);
+  }
+
+  bool button_down() const {
+    return button_down_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> last_stroke_millis_{0};
+  std::atomic<bool> button_down_{false};
+};
+
+// 全局按键活动：由低级键盘 hook 写入，只记录最近一次按键的时间，
+// 不保存任何按键内容。hook 回调中只有一次 relaxed store。
+class KeyActivityState {
+ public:
+  void OnKey(std::uint64_t timestamp_millis) {
+    last_key_millis_.store(timestamp_millis, std::memory_order_relaxed);
+  }
+
+  std::uint64_t last_key_millis() const {
+    return last_key_millis_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> last_key_millis_{0};
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_STROKE_STATE_H_
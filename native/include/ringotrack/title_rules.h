@@ -0,0 +1,77 @@
+#ifndef RINGOTRACK_TITLE_RULES_H_
+#define RINGOTRACK_TITLE_RULES_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+
+namespace ringotrack {
+
+// 驻留后的文档 ID（画布 / 工程名）；0 保留为「无文档」。
+using DocumentId = std::uint32_t;
+constexpr DocumentId kNoDocument = 0;
+
+// 内置的提取规则，覆盖常见绘画软件的窗口标题格式。
+extern const char kDefaultTitleRules[];
+
+// 按应用从窗口标题中提取文档名的规则集，编译一次后只读使用。
+//
+// 配置为纯文本，每行一条规则：`<appId> <模式>`，appId 与模式之间用空白分隔，
+// `#` 开头的行与空行忽略。模式整体锚定标题首尾，支持：
+// - `{doc}`：文档名捕获，每条模式恰好一个；
+// - `*`：任意字符（含空）；
+// - 其余字符按字面匹配（区分大小写）。
+// 中间的字面量取最左匹配，最后一个字面量锚定到标题末尾；捕获结果会去掉
+// 首尾空白以及表示「未保存」的 `*`。同一应用的多条规则按配置顺序尝试。
+//
+// 匹配过程不分配内存，也不使用 std::regex，适合在标题变化事件里直接调用。
+class TitleRuleSet {
+ public:
+  // 编译配置；语法错误时返回 nullptr，并把出错行号（从 1 开始）写入
+  // error_line（可为空）。
+  static std::unique_ptr<TitleRuleSet> Compile(std::string_view config,
+                                               int* error_line);
+
+  // 返回 title 中的文档名（指向 title 内部的 view）；app 没有规则或都不匹配
+  // 时返回空 view。
+  std::string_view Extract(std::string_view app, std::string_view title) const;
+
+  // 已编译的规则条数。
+  std::size_t size() const { return patterns_.size(); }
+
+ private:
+  // 模式切分后的一个片段：前面的通配（首段为无），加上一段字面量。
+  struct Segment {
+    std::uint32_t offset;
+    std::uint32_t length;
+    // 本片段之前的通配是否为 `{doc}` 捕获。
+    bool capture_before;
+  };
+
+  struct Pattern {
+    std::uint32_t first_segment;
+    std::uint32_t segment_count;
+  };
+
+  TitleRuleSet() = default;
+
+  bool AddRule(std::string_view app, std::string_view pattern);
+  bool Match(const Pattern& pattern, std::string_view title,
+             std::string_view* doc) const;
+
+  // 应用名 -> 该应用的规则下标列表（按 AppId - 1 索引）。
+  AppInterner apps_;
+  std::vector<std::vector<std::uint32_t>> rules_by_app_;
+  std::vector<Pattern> patterns_;
+  std::vector<Segment> segments_;
+  // 所有字面量连续存放，Segment 通过偏移引用。
+  std::string literals_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_TITLE_RULES_H_
@@ -0,0 +1,46 @@
+#ifndef RINGOTRACK_TRACKED_APP_SET_H_
+#define RINGOTRACK_TRACKED_APP_SET_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+
+namespace ringotrack {
+
+// 以驻留 ID 为下标的位图，用于在热路径上 O(1) 判断是否为需要统计的绘画软件。
+class TrackedAppSet {
+ public:
+  void Add(AppId id) {
+    if (id == kNoApp) {
+      return;
+    }
+    const std::size_t word = id >> 6;
+    if (word >= bits_.size()) {
+      bits_.resize(word + 1, 0);
+    }
+    bits_[word] |= std::uint64_t{1} << (id & 63);
+  }
+
+  void Remove(AppId id) {
+    const std::size_t word = id >> 6;
+    if (word < bits_.size()) {
+      bits_[word] &= ~(std::uint64_t{1} << (id & 63));
+    }
+  }
+
+  bool Contains(AppId id) const {
+    const std::size_t word = id >> 6;
+    return id != kNoApp && word < bits_.size() &&
+           (bits_[word] >> (id & 63) & 1) != 0;
+  }
+
+  void Clear() { bits_.clear(); }
+
+ private:
+  std::vector<std::uint64_t> bits_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_TRACKED_APP_SET_H_
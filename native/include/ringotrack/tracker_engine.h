@@ -0,0 +1,78 @@
+#ifndef RINGOTRACK_TRACKER_ENGINE_H_
+#define RINGOTRACK_TRACKER_ENGINE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ringotrack/event_queue.h"
+#include "ringotrack/hourly_aggregator.h"
+#include "ringotrack/idle_state.h"
+
+namespace ringotrack {
+
+// 把「前台切换 + 落笔」事件流转换为小时级用时桶，
+// 语义与 Dart 侧 UsageService 保持一致：Idle 期间不计时，
+// 每次 Tick 都会把当前区间结算到 now，便于按秒向外输出增量。
+//
+// 锁屏 / 休眠事件是精确的区间边界：区间在事件时间点结束，暂停期间的 Tick
+// 不会结算任何时长；全部解除后按恢复时刻重新判定 Idle，再决定是否继续计时。
+class TrackerEngine {
+ public:
+  TrackerEngine(const Clock* clock, const TrackedAppSet* tracked,
+                std::int64_t idle_threshold_millis, std::int64_t now_millis)
+      : aggregator_(clock, tracked),
+        idle_(idle_threshold_millis, now_millis) {}
+
+  void Process(const TrackerEvent& event);
+
+  // 取空队列中的所有事件并依次处理，返回处理的事件数。
+  std::size_t ProcessQueue(TrackerEventQueue* queue);
+
+  void Tick(std::int64_t now_millis);
+
+  // 结束当前区间（例如退出时）。
+  void CloseAt(std::int64_t now_millis) { aggregator_.CloseAt(now_millis); }
+
+  std::size_t Drain(std::vector<UsageBucket>* out) {
+    return aggregator_.Drain(out);
+  }
+
+  // 调整某一活动来源在 Idle 判定中的权重，见 IdleStateMachine。
+  void SetActivityWeight(ActivitySource source, double weight) {
+    idle_.SetWeight(source, weight);
+  }
+
+  void set_tracked(const TrackedAppSet* tracked) {
+    aggregator_.set_tracked(tracked);
+  }
+
+  // 见 HourlyAggregator::set_session_segmenter。Idle 与暂停期间没有区间，
+  // 超过合并阈值后自然切成两段。
+  void set_session_segmenter(SessionSegmenter* segmenter) {
+    aggregator_.set_session_segmenter(segmenter);
+  }
+
+  AppId foreground_app() const { return foreground_app_; }
+  bool is_idle() const { return idle_.is_idle(); }
+  // 会话锁定或系统休眠中。
+  bool is_paused() const { return pause_reasons_ != 0; }
+  const IdleStateMachine& idle() const { return idle_; }
+  const HourlyAggregator& aggregator() const { return aggregator_; }
+
+ private:
+  static constexpr std::uint32_t kPausedByLock = 1u << 0;
+  static constexpr std::uint32_t kPausedBySuspend = 1u << 1;
+
+  void ApplyIdleTransition(IdleTransition transition, std::int64_t at_millis);
+  void Pause(std::uint32_t reason, std::int64_t at_millis);
+  void Resume(std::uint32_t reason, std::int64_t at_millis);
+
+  HourlyAggregator aggregator_;
+  IdleStateMachine idle_;
+  AppId foreground_app_ = kNoApp;
+  std::uint32_t pause_reasons_ = 0;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_TRACKER_ENGINE_H_
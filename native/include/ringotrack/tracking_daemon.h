@@ -0,0 +1,194 @@
+#ifndef RINGOTRACK_TRACKING_DAEMON_H_
+#define RINGOTRACK_TRACKING_DAEMON_H_
+
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+#include "ringotrack/client_lease.h"
+#include "ringotrack/clock.h"
+#include "ringotrack/event_queue.h"
+#include "ringotrack/hourly_aggregator.h"
+#include "ringotrack/tracked_app_set.h"
+#include "ringotrack/tracker_engine.h"
+
+namespace ringotrack {
+
+// 事件来源把应用名驻留为 AppId 时使用。
+class AppResolver {
+ public:
+  virtual ~AppResolver() = default;
+  virtual AppId Resolve(std::string_view name) = 0;
+};
+
+// 前台 / 落笔 / 会话事件的来源：平台 hook 与轮询，或测试 / 回放用的脚本。
+class EventSource {
+ public:
+  virtual ~EventSource() = default;
+
+  // 把 now 及之前发生、尚未交出的事件按时间顺序推入 queue。
+  virtual void Poll(std::int64_t now_millis, AppResolver* apps,
+                    TrackerEventQueue* queue) = 0;
+};
+
+// 待持久化的一条整秒用量。
+struct UsageRecord {
+  std::int32_t day;  // 本地日期编号，与 Dart 侧 dayNumberOf 一致
+  std::int32_t hour;
+  AppId app_id;
+  std::int64_t seconds;
+  // 是否为统计中的应用；「全量记录」时其余应用只写入全量表。
+  bool tracked;
+};
+
+// 持久化目标（数据库），一次调用对应一个事务。
+class UsageSink {
+ public:
+  virtual ~UsageSink() = default;
+
+  // 失败时不应写入任何记录，调用方保留数据稍后重试。
+  virtual bool Persist(const std::vector<UsageRecord>& records,
+                       const AppInterner& apps) = 0;
+};
+
+struct TrackingDaemonOptions {
+  std::int64_t idle_threshold_millis = kMillisPerMinute;
+  // 批量落库间隔；UI 客户端为 5 秒，守护进程没有界面需要刷新，攒得更久。
+  std::int64_t flush_interval_millis = 30 * kMillisPerSecond;
+  // 客户端心跳超过该时长未刷新即视为失效（窗口关闭或引擎卡死）。
+  std::int64_t client_timeout_millis = 15 * kMillisPerSecond;
+  // 计时中的节拍间隔，以及不计时（非统计应用、Idle、锁屏）时的间隔。
+  std::int64_t active_step_millis = kMillisPerSecond;
+  std::int64_t background_step_millis = 5 * kMillisPerSecond;
+  // 与 UsageService.recordAllApps 相同：记录所有前台应用。
+  bool record_all_apps = false;
+};
+
+// 脱离 Flutter 引擎运行的追踪核心：事件来源 -> TrackerEngine ->
+// 按节拍切片 -> 批量写入 UsageSink。
+//
+// UI 客户端打开时通过 ClientLease 接手记账：租约覆盖的切片直接丢弃，
+// 客户端存活且尚未落库的切片暂存；客户端失效后从 persisted_until 起
+// 重新由本进程持久化。交接精度为一个节拍。非线程安全，由单个线程驱动。
+class TrackingDaemon : public AppResolver {
+ public:
+  // lease 为 nullptr 时不与客户端交接，所有切片都由本进程持久化。
+  // clock / source / sink / lease 的生命周期需覆盖本对象。
+  TrackingDaemon(const Clock* clock, EventSource* source, UsageSink* sink,
+                 const ClientLeaseLayout* lease,
+                 const TrackingDaemonOptions& options);
+
+  // 统计中的应用（大小写不敏感，与 Dart 侧 AppMatcher.foldedIds 对应）。
+  void SetTrackedApps(const std::vector<std::string>& app_ids);
+
+  AppId Resolve(std::string_view name) override;
+
+  // 拉取事件、结算到当前时刻，到达落库间隔时批量写入。
+  void Step();
+
+  // 立即写入所有可由本进程持久化的用量，返回是否成功。
+  bool Flush();
+
+  // 结束当前区间并写入（退出前调用）。
+  bool Shutdown();
+
+  // 距下一次 Step 的建议间隔。
+  std::int64_t NextStepDelayMillis() const;
+
+  const TrackerEngine& engine() const { return engine_; }
+  const AppInterner& apps() const { return apps_; }
+  std::int64_t persisted_seconds() const { return persisted_seconds_; }
+  // 被客户端租约覆盖而丢弃的毫秒数。
+  std::int64_t handed_over_millis() const { return handed_over_millis_; }
+  std::size_t failed_flushes() const { return failed_flushes_; }
+  std::size_t pending_slices() const { return undecided_.size(); }
+
+ private:
+  // 两次 Step 之间结算出的桶。
+  struct Slice {
+    std::int64_t start_millis;
+    std::int64_t end_millis;
+    std::vector<UsageBucket> buckets;
+  };
+
+  struct Coverage {
+    std::int64_t since_millis;
+    std::int64_t until_millis;
+  };
+
+  bool IsTracked(std::string_view name) const;
+  void ObserveLease(std::int64_t now_millis);
+  void SettleSlices();
+  void Own(const std::vector<UsageBucket>& buckets);
+
+  const Clock* clock_;
+  EventSource* source_;
+  UsageSink* sink_;
+  const ClientLeaseLayout* lease_;
+  TrackingDaemonOptions options_;
+
+  AppInterner apps_;
+  TrackedAppSet tracked_;
+  std::unordered_set<std::string> tracked_names_;
+  TrackerEngine engine_;
+  TrackerEventQueue queue_;
+  std::vector<UsageBucket> scratch_;
+
+  std::int64_t last_step_millis_;
+  std::int64_t last_flush_millis_;
+  // 客户端存活、尚无法判定归属的切片，按时间排序。
+  std::deque<Slice> undecided_;
+  // 最近几次客户端租约覆盖的区间，最后一项为当前租约。
+  std::vector<Coverage> coverage_;
+  ClientLease client_;
+  bool client_alive_ = false;
+  // 归本进程持久化、尚未写入的毫秒数（同一小时同一应用合并）。
+  std::vector<UsageBucket> owned_;
+
+  std::int64_t persisted_seconds_ = 0;
+  std::int64_t handed_over_millis_ = 0;
+  std::size_t failed_flushes_ = 0;
+};
+
+// 脚本事件：相对脚本开始的毫秒偏移。
+struct ScriptedEvent {
+  std::int64_t offset_millis;
+  TrackerEventKind kind;
+  std::string app;
+};
+
+// 按时间回放固定事件序列的来源，用于测试与在没有平台 hook 的环境中运行。
+class ScriptedEventSource : public EventSource {
+ public:
+  ScriptedEventSource(std::vector<ScriptedEvent> events,
+                      std::int64_t start_millis)
+      : events_(std::move(events)), start_millis_(start_millis) {}
+
+  void Poll(std::int64_t now_millis, AppResolver* apps,
+            TrackerEventQueue* queue) override;
+
+  bool finished() const { return next_ == events_.size(); }
+  // 最后一个事件的时刻；没有事件时为开始时刻。
+  std::int64_t end_millis() const;
+
+ private:
+  std::vector<ScriptedEvent> events_;
+  std::int64_t start_millis_;
+  std::size_t next_ = 0;
+};
+
+// 解析事件脚本：每行「<偏移毫秒> <事件> [应用]」，# 开头为注释。
+// 事件为 fg / down / up / key / lock / unlock / suspend / resume，
+// fg 不带应用表示没有可用的前台应用。偏移需单调不减。
+bool ParseEventScript(std::istream& in, std::vector<ScriptedEvent>* out,
+                      std::string* error);
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_TRACKING_DAEMON_H_
@@ -0,0 +1,82 @@
+#ifndef RINGOTRACK_USAGE_STORE_H_
+#define RINGOTRACK_USAGE_STORE_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ringotrack/tracking_daemon.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace ringotrack {
+
+// 守护进程可以写入的最低 schema 版本（Dart 侧 AppDatabase.schemaVersion）：
+// v6 起日表 / 小时表为整数键，应用名经 app_dictionary 驻留。
+constexpr std::int32_t kMinUsageSchemaVersion = 6;
+
+// v8 起小时表的写入需同时记入 usage_change_log，供多设备同步发布。
+constexpr std::int32_t kChangeLogSchemaVersion = 8;
+
+// 小时表打包主键中应用 ID 占用的低位数，与 AppDatabase._appBits 一致。
+constexpr int kHourlyKeyAppBits = 20;
+
+constexpr std::int64_t HourlyUsageKey(std::int32_t day, std::int32_t hour,
+                                      std::int64_t app) {
+  return ((static_cast<std::int64_t>(day) * 24 + hour) << kHourlyKeyAppBits) |
+         app;
+}
+
+// 通过 SQLite C API 直接写入 UI 使用的同一个数据库文件。
+//
+// 库由 UI 创建并迁移；文件不存在或 schema 低于 kMinUsageSchemaVersion 时
+// Persist 返回 false，调用方保留数据，下次重试时重新打开。每次 Persist
+// 是一个 BEGIN IMMEDIATE 事务，应用 ID 在事务内查询 / 驻留（UI 可能随时
+// 清理不再引用的字典条目，跨事务缓存 ID 不安全）。
+class SqliteUsageStore : public UsageSink {
+ public:
+  // record_all_apps 与 TrackingDaemonOptions 相同：所有记录额外写入
+  // 「全量记录」的 hourly_app_usage，tracked 的记录才写日表 / 小时表。
+  explicit SqliteUsageStore(std::string path, bool record_all_apps = false)
+      : path_(std::move(path)), record_all_apps_(record_all_apps) {}
+  ~SqliteUsageStore() override;
+
+  SqliteUsageStore(const SqliteUsageStore&) = delete;
+  SqliteUsageStore& operator=(const SqliteUsageStore&) = delete;
+
+  bool Persist(const std::vector<UsageRecord>& records,
+               const AppInterner& apps) override;
+
+  // 最近一次失败的原因。
+  const std::string& last_error() const { return last_error_; }
+
+ private:
+  bool Open();
+  void Close();
+  bool Fail(const char* what);
+  bool Exec(const char* sql);
+  bool Prepare(const char* sql, sqlite3_stmt** stmt);
+  bool InternApp(std::string_view name, std::int64_t* id);
+  bool Run(sqlite3_stmt* stmt, std::initializer_list<std::int64_t> values);
+
+  std::string path_;
+  bool record_all_apps_;
+  std::string last_error_;
+  sqlite3* db_ = nullptr;
+  sqlite3_stmt* insert_app_ = nullptr;
+  sqlite3_stmt* select_app_ = nullptr;
+  sqlite3_stmt* add_daily_ = nullptr;
+  sqlite3_stmt* add_hourly_ = nullptr;
+  sqlite3_stmt* add_all_apps_ = nullptr;
+  sqlite3_stmt* log_change_ = nullptr;  // schema < v8 时为 nullptr
+  // 事务内 AppId -> app_dictionary.id 的缓存，-1 表示尚未查询。
+  std::vector<std::int64_t> dictionary_ids_;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_USAGE_STORE_H_
@@ -0,0 +1,111 @@
+#ifndef RINGOTRACK_WINDOW_VISIBILITY_H_
+#define RINGOTRACK_WINDOW_VISIBILITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+#include "ringotrack/tracked_app_set.h"
+
+namespace ringotrack {
+
+// 屏幕坐标下的窗口矩形，右 / 下边界不含。
+struct WindowRect {
+  std::int32_t left;
+  std::int32_t top;
+  std::int32_t right;
+  std::int32_t bottom;
+
+  bool empty() const { return right <= left || bottom <= top; }
+  std::int64_t area() const {
+    return empty() ? 0
+                   : static_cast<std::int64_t>(right - left) *
+                         static_cast<std::int64_t>(bottom - top);
+  }
+};
+
+// 计算矩形被一组遮挡矩形覆盖后剩余的可见面积。
+//
+// 先把遮挡矩形裁剪到目标内，再按所有竖边切成竖条，每条内合并 y 区间求覆盖
+// 长度；k 个有效遮挡时为 O(k^2 log k)。内部缓冲区复用，稳定后无堆分配。
+class OcclusionCalculator {
+ public:
+  std::int64_t VisibleArea(const WindowRect& target,
+                           const WindowRect* occluders, std::size_t count);
+
+ private:
+  struct Interval {
+    std::int32_t begin;
+    std::int32_t end;
+  };
+
+  std::vector<WindowRect> clipped_;
+  std::vector<std::int32_t> xs_;
+  std::vector<Interval> intervals_;
+};
+
+// 可见（但不一定在前台）的应用及其可见比例。
+struct VisibleApp {
+  AppId app_id;
+  // 该应用可见比例最大的窗口的可见面积占比，千分比。
+  std::uint32_t visible_permille;
+};
+
+// 顶层窗口的缓存表，按 z 序从上到下排列，由窗口事件（显示 / 隐藏 / 移动 /
+// 最小化 / 前台切换）增量维护，避免周期性枚举全部窗口。
+//
+// 事件只标记脏位，Compute 在下一次读取时才重新计算遮挡，拖动窗口时的
+// 大量位置变化事件不会触发重复计算。非线程安全，由调用方加锁。
+class WindowVisibilityTracker {
+ public:
+  // 新窗口放在最上层；已有窗口只更新几何与显示状态，z 序不变。
+  void Upsert(std::uint64_t handle, AppId app_id, const WindowRect& rect,
+              bool shown);
+  // 只更新已知窗口的几何与显示状态；窗口不在表中时返回 false，由调用方
+  // 查询所属应用后再 Upsert（查进程名较慢，不在每次位置变化时做）。
+  bool UpdateGeometry(std::uint64_t handle, const WindowRect& rect,
+                      bool shown);
+  void Remove(std::uint64_t handle);
+  // 窗口被激活时移到最上层。
+  void BringToTop(std::uint64_t handle);
+  void Clear();
+
+  // 只计算这些应用的窗口；为空时不产出任何结果。track_all 为 true 时
+  // 计算全部窗口（调用方的过滤规则含通配符、无法展开为集合时使用）。
+  void SetTracked(const TrackedAppSet& tracked, bool track_all = false);
+
+  // 统计除 exclude_app（通常是前台应用）外、可见比例不低于 min_permille
+  // 的被跟踪应用，每个应用只出现一次。结果在下一次修改前有效。
+  const std::vector<VisibleApp>& Compute(AppId exclude_app,
+                                         std::uint32_t min_permille);
+
+  // 窗口所属应用，不在表中时返回 kNoApp。
+  AppId AppOf(std::uint64_t handle) const;
+
+  std::size_t window_count() const { return windows_.size(); }
+
+ private:
+  struct Window {
+    std::uint64_t handle;
+    AppId app_id;
+    WindowRect rect;
+    bool shown;
+  };
+
+  std::size_t IndexOf(std::uint64_t handle) const;
+
+  std::vector<Window> windows_;
+  TrackedAppSet tracked_;
+  bool track_all_ = false;
+  OcclusionCalculator calculator_;
+  std::vector<WindowRect> above_;
+  std::vector<VisibleApp> result_;
+  bool dirty_ = true;
+  AppId last_exclude_ = kNoApp;
+  std::uint32_t last_min_permille_ = 0;
+};
+
+}  // namespace ringotrack
+
+#endif  // RINGOTRACK_WINDOW_VISIBILITY_H_
@@ -0,0 +1,91 @@
+#include "ringotrack/app_interner.h"
+
+namespace ringotrack {
+
+namespace {
+
+constexpr std::size_t kInitialSlots = 64;
+
+}  // namespace
+
+AppInterner::AppInterner() : slots_(kInitialSlots, kNoApp) {}
+
+std::uint32_t AppInterner::Hash(std::string_view name) {
+  // FNV-1a：appId 普遍很短，足够均匀且无需额外依赖。
+  std::uint32_t hash = 2166136261u;
+  for (const char c : name) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+std::size_t AppInterner::Probe(std::string_view name,
+                               std::uint32_t hash) const {
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t index = hash & mask;
+  while (true) {
+    const AppId id = slots_[index];
+    if (id == kNoApp) {
+      return index;
+    }
+    const Entry& entry = entries_[id - 1];
+    if (entry.hash == hash &&
+        std::string_view(pool_.data() + entry.offset, entry.length) == name) {
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
+AppId AppInterner::Find(std::string_view name) const {
+  return slots_[Probe(name, Hash(name))];
+}
+
+AppId AppInterner::Intern(std::string_view name) {
+  const std::uint32_t hash = Hash(name);
+  std::size_t index = Probe(name, hash);
+  if (slots_[index] != kNoApp) {
+    return slots_[index];
+  }
+
+  // 负载因子保持在 0.5 以下。
+  if ((entries_.size() + 1) * 2 > slots_.size()) {
+    Grow();
+    index = Probe(name, hash);
+  }
+
+  Entry entry;
+  entry.offset = static_cast<std::uint32_t>(pool_.size());
+  entry.length = static_cast<std::uint32_t>(name.size());
+  entry.hash = hash;
+  pool_.append(name.data(), name.size());
+  entries_.push_back(entry);
+
+  const AppId id = static_cast<AppId>(entries_.size());
+  slots_[index] = id;
+  return id;
+}
+
+std::string_view AppInterner::Name(AppId id) const {
+  if (id == kNoApp || id > entries_.size()) {
+    return std::string_view();
+  }
+  const Entry& entry = entries_[id - 1];
+  return std::string_view(pool_.data() + entry.offset, entry.length);
+}
+
+void AppInterner::Grow() {
+  std::vector<AppId> next(slots_.size() * 2, kNoApp);
+  const std::size_t mask = next.size() - 1;
+  for (std::size_t i = 0; i < entries_.size(); ++i) {
+    std::size_t index = entries_[i].hash & mask;
+    while (next[index] != kNoApp) {
+      index = (index + 1) & mask;
+    }
+    next[index] = static_cast<AppId>(i + 1);
+  }
+  slots_.swap(next);
+}
+
+}  // namespace ringotrack
@@ -0,0 +1,110 @@
+#include "ringotrack/client_lease.h"
+
+namespace ringotrack {
+
+static_assert(std::atomic<std::int64_t>::is_always_lock_free,
+              "lease fields must be lock-free to live in shared memory");
+
+void InitializeClientLease(ClientLeaseLayout* layout) {
+  if (layout->magic == kClientLeaseMagic &&
+      layout->version == kClientLeaseVersion) {
+    return;
+  }
+  layout->sequence.store(0, std::memory_order_relaxed);
+  layout->attached_since_millis.store(0, std::memory_order_relaxed);
+  layout->persisted_until_millis.store(0, std::memory_order_relaxed);
+  layout->heartbeat_millis.store(0, std::memory_order_relaxed);
+  layout->daemon_heartbeat_millis.store(0, std::memory_order_relaxed);
+  layout->size = static_cast<std::uint32_t>(sizeof(ClientLeaseLayout));
+  layout->reserved = 0;
+  layout->version = kClientLeaseVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  layout->magic = kClientLeaseMagic;
+}
+
+void ClientLeaseWriter::Attach(std::int64_t since_millis,
+                               std::int64_t now_millis) {
+  lease_.attached_since_millis = since_millis;
+  lease_.persisted_until_millis = since_millis;
+  lease_.heartbeat_millis = now_millis;
+  Write(lease_);
+}
+
+void ClientLeaseWriter::Report(std::int64_t persisted_until_millis,
+                               std::int64_t now_millis) {
+  if (persisted_until_millis > lease_.persisted_until_millis) {
+    lease_.persisted_until_millis = persisted_until_millis;
+  }
+  lease_.heartbeat_millis = now_millis;
+  Write(lease_);
+}
+
+void ClientLeaseWriter::Heartbeat(std::int64_t now_millis) {
+  lease_.heartbeat_millis = now_millis;
+  Write(lease_);
+}
+
+void ClientLeaseWriter::Detach() {
+  lease_.heartbeat_millis = 0;
+  Write(lease_);
+}
+
+void ClientLeaseWriter::Write(const ClientLease& lease) {
+  const std::uint64_t seq = layout_->sequence.load(std::memory_order_relaxed);
+  layout_->sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  layout_->attached_since_millis.store(lease.attached_since_millis,
+                                       std::memory_order_relaxed);
+  layout_->persisted_until_millis.store(lease.persisted_until_millis,
+                                        std::memory_order_relaxed);
+  layout_->heartbeat_millis.store(lease.heartbeat_millis,
+                                  std::memory_order_relaxed);
+
+  layout_->sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool ReadClientLease(const ClientLeaseLayout& layout, ClientLease* out,
+                     int max_attempts) {
+  if (layout.magic != kClientLeaseMagic ||
+      layout.version != kClientLeaseVersion) {
+    return false;
+  }
+  for (int attempt = 0; attempt < max_attempts; ++attempt) {
+    const std::uint64_t before =
+        layout.sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      continue;
+    }
+
+    ClientLease snapshot;
+    snapshot.attached_since_millis =
+        layout.attached_since_millis.load(std::memory_order_relaxed);
+    snapshot.persisted_until_millis =
+        layout.persisted_until_millis.load(std::memory_order_relaxed);
+    snapshot.heartbeat_millis =
+        layout.heartbeat_millis.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (layout.sequence.load(std::memory_order_relaxed) != before) {
+      continue;
+    }
+    *out = snapshot;
+    return true;
+  }
+  return false;
+}
+
+std::unique_ptr<ClientLeaseSegment> ClientLeaseSegment::Create(
+    const std::string& name) {
+  std::unique_ptr<SharedMemory> memory =
+      SharedMemory::Create(name, sizeof(ClientLeaseLayout));
+  if (!memory) {
+    return nullptr;
+  }
+  InitializeClientLease(static_cast<ClientLeaseLayout*>(memory->data()));
+  return std::unique_ptr<ClientLeaseSegment>(
+      new ClientLeaseSegment(std::move(memory)));
+}
+
+}  // namespace ringotrack
@@ -0,0 +1,112 @@
+#include "ringotrack/clock.h"
+
+#include <ctime>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace ringotrack {
+
+namespace {
+
+// 偏移缓存窗口：时区切换总是发生在整 15 分钟边界上。
+constexpr std::int64_t kOffsetCacheWindowMillis = 15 * kMillisPerMinute;
+
+std::int64_t FloorDiv(std::int64_t a, std::int64_t b) {
+  const std::int64_t q = a / b;
+  return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+std::int64_t QueryLocalOffsetMillis(std::int64_t unix_millis) {
+  const std::time_t seconds =
+      static_cast<std::time_t>(FloorDiv(unix_millis, kMillisPerSecond));
+  std::tm local_tm{};
+#ifdef _WIN32
+  if (::localtime_s(&local_tm, &seconds) != 0) {
+    return 0;
+  }
+  const std::time_t as_utc = ::_mkgmtime(&local_tm);
+  if (as_utc == static_cast<std::time_t>(-1)) {
+    return 0;
+  }
+  return static_cast<std::int64_t>(as_utc - seconds) * kMillisPerSecond;
+#else
+  if (::localtime_r(&seconds, &local_tm) == nullptr) {
+    return 0;
+  }
+  return static_cast<std::int64_t>(local_tm.tm_gmtoff) * kMillisPerSecond;
+#endif
+}
+
+}  // namespace
+
+std::int64_t SystemClock::NowUnixMillis() const {
+#ifdef _WIN32
+  FILETIME ft;
+  ::GetSystemTimeAsFileTime(&ft);
+
+  ULARGE_INTEGER uli;
+  uli.LowPart = ft.dwLowDateTime;
+  uli.HighPart = ft.dwHighDateTime;
+  return static_cast<std::int64_t>(FileTimeTicksToUnixMillis(uli.QuadPart));
+#else
+  timespec ts{};
+  ::clock_gettime(CLOCK_REALTIME, &ts);
+  return static_cast<std::int64_t>(ts.tv_sec) * kMillisPerSecond +
+         ts.tv_nsec / 1000000;
+#endif
+}
+
+std::int64_t SystemClock::LocalOffsetMillis(std::int64_t unix_millis) const {
+  const std::int64_t window = FloorDiv(unix_millis, kOffsetCacheWindowMillis);
+  if (window != cached_window_) {
+    cached_offset_ = QueryLocalOffsetMillis(unix_millis);
+    cached_window_ = window;
+  }
+  return cached_offset_;
+}
+
+LocalHour LocalHourAt(const Clock& clock, std::int64_t unix_millis) {
+  const std::int64_t local = unix_millis + clock.LocalOffsetMillis(unix_millis);
+  const std::int64_t day = FloorDiv(local, kMillisPerDay);
+  const std::int64_t millis_of_day = local - day * kMillisPerDay;
+  const std::int64_t hour = millis_of_day / kMillisPerHour;
+
+  LocalHour result;
+  result.day = static_cast<std::int32_t>(day);
+  result.hour = static_cast<std::int32_t>(hour);
+  result.end_unix_millis =
+      unix_millis + (kMillisPerHour - millis_of_day % kMillisPerHour);
+  return result;
+}
+
+// 以下两个换算采用 Howard Hinnant 的 days_from_civil / civil_from_days 算法。
+std::int32_t DayNumberFromCivil(std::int32_t year, std::uint32_t month,
+                                std::uint32_t day) {
+  year -= month <= 2 ? 1 : 0;
+  const std::int32_t era = (year >= 0 ? year : year - 399) / 400;
+  const std::uint32_t yoe = static_cast<std::uint32_t>(year - era * 400);
+  const std::uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 +
+                            day - 1;
+  const std::uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<std::int32_t>(doe) - 719468;
+}
+
+void CivilFromDayNumber(std::int32_t day_number, std::int32_t* year,
+                        std::uint32_t* month, std::uint32_t* day) {
+  const std::int32_t z = day_number + 719468;
+  const std::int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const std::uint32_t doe = static_cast<std::uint32_t>(z - era * 146097);
+  const std::uint32_t yoe =
+      (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const std::uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const std::uint32_t mp = (5 * doy + 2) / 153;
+  const std::uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+  const std::uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+  *year = static_cast<std::int32_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+  *month = m;
+  *day = d;
+}
+
+}  // namespace ringotrack
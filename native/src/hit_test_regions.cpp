@@ -0,0 +1,111 @@
+#include "ringotrack/hit_test_regions.h"
+
+namespace ringotrack {
+
+namespace {
+
+// 与 Win32 runner 原先的 ScaleToDpi 一致：截断取整，至少 1 像素。
+std::int32_t ScaleToDpi(std::int32_t source, double scale) {
+  const auto scaled = static_cast<std::int32_t>(source * scale);
+  return scaled > 0 ? scaled : 1;
+}
+
+// 偏移允许为 0（紧贴窗口边缘），不做至少 1 像素的修正。
+std::int32_t ScaleOffset(std::int32_t source, double scale) {
+  return static_cast<std::int32_t>(source * scale);
+}
+
+}  // namespace
+
+HitTestRegions::HitTestRegions() { ResetToDefaults(); }
+
+bool HitTestRegions::SetRegions(const InteractiveRegion* regions,
+                                std::size_t count) {
+  if (count > kMaxRegions || (count > 0 && regions == nullptr)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    const InteractiveRegion& region = regions[i];
+    if (region.width <= 0 || region.height <= 0 ||
+        static_cast<std::uint32_t>(region.anchor) >
+            static_cast<std::uint32_t>(RegionAnchor::kBottomRight)) {
+      return false;
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    regions_[i] = regions[i];
+  }
+  count_ = count;
+  Rebuild();
+  return true;
+}
+
+void HitTestRegions::ResetToDefaults() {
+  const InteractiveRegion defaults[] = {
+      // 右上角：pin 按钮。
+      {RegionAnchor::kTopRight, 0, 0, kDefaultCornerDip, kDefaultCornerDip},
+      // 右下角：lock 按钮。
+      {RegionAnchor::kBottomRight, 0, 0, kDefaultCornerDip, kDefaultCornerDip},
+  };
+  SetRegions(defaults, sizeof(defaults) / sizeof(defaults[0]));
+}
+
+void HitTestRegions::SetScale(double scale) {
+  scale_ = scale > 0 ? scale : 1.0;
+  Rebuild();
+}
+
+void HitTestRegions::SetClientSize(std::int32_t width, std::int32_t height) {
+  width_ = width > 0 ? width : 0;
+  height_ = height > 0 ? height : 0;
+  Rebuild();
+}
+
+void HitTestRegions::Rebuild() {
+  for (std::size_t i = 0; i < count_; ++i) {
+    const InteractiveRegion& region = regions_[i];
+    const std::int32_t x = ScaleOffset(region.x, scale_);
+    const std::int32_t y = ScaleOffset(region.y, scale_);
+    const std::int32_t width = ScaleToDpi(region.width, scale_);
+    const std::int32_t height = ScaleToDpi(region.height, scale_);
+
+    Rect& rect = scaled_[i];
+    switch (region.anchor) {
+      case RegionAnchor::kTopLeft:
+      case RegionAnchor::kBottomLeft:
+        rect.left = x;
+        rect.right = x + width;
+        break;
+      case RegionAnchor::kTopRight:
+      case RegionAnchor::kBottomRight:
+        rect.right = width_ - x;
+        rect.left = rect.right - width;
+        break;
+    }
+    switch (region.anchor) {
+      case RegionAnchor::kTopLeft:
+      case RegionAnchor::kTopRight:
+        rect.top = y;
+        rect.bottom = y + height;
+        break;
+      case RegionAnchor::kBottomLeft:
+      case RegionAnchor::kBottomRight:
+        rect.bottom = height_ - y;
+        rect.top = rect.bottom - height;
+        break;
+    }
+  }
+}
+
+bool HitTestRegions::IsInteractive(std::int32_t x, std::int32_t y) const {
+  for (std::size_t i = 0; i < count_; ++i) {
+    const Rect& rect = scaled_[i];
+    if (x >= rect.left && x <= rect.right && y >= rect.top &&
+        y <= rect.bottom) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ringotrack
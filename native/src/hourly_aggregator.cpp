@@ -0,0 +1,59 @@
+#include "ringotrack/hourly_aggregator.h"
+
+namespace ringotrack {
+
+void HourlyAggregator::OnForegroundChanged(AppId app_id,
+                                           std::int64_t timestamp_millis) {
+  if (current_app_ != kNoApp) {
+    AddInterval(current_app_, current_start_, timestamp_millis);
+  }
+  current_app_ = app_id;
+  current_start_ = timestamp_millis;
+}
+
+void HourlyAggregator::CloseAt(std::int64_t timestamp_millis) {
+  if (current_app_ != kNoApp) {
+    AddInterval(current_app_, current_start_, timestamp_millis);
+  }
+  current_app_ = kNoApp;
+  current_start_ = 0;
+}
+
+std::size_t HourlyAggregator::Drain(std::vector<UsageBucket>* out) {
+  const std::size_t count = pending_.size();
+  out->insert(out->end(), pending_.begin(), pending_.end());
+  pending_.clear();
+  return count;
+}
+
+void HourlyAggregator::AddInterval(AppId app_id, std::int64_t start,
+                                   std::int64_t end) {
+  if (tracked_ != nullptr && !tracked_->Contains(app_id)) {
+    return;
+  }
+  if (segmenter_ != nullptr) {
+    segmenter_->OnInterval(app_id, start, end);
+  }
+
+  std::int64_t cursor = start;
+  while (cursor < end) {
+    const LocalHour local = LocalHourAt(*clock_, cursor);
+    const std::int64_t segment_end =
+        end < local.end_unix_millis ? end : local.end_unix_millis;
+    Accumulate(local.day, local.hour, app_id, segment_end - cursor);
+    cursor = segment_end;
+  }
+}
+
+void HourlyAggregator::Accumulate(std::int32_t day, std::int32_t hour,
+                                  AppId app_id, std::int64_t millis) {
+  for (UsageBucket& bucket : pending_) {
+    if (bucket.app_id == app_id && bucket.hour == hour && bucket.day == day) {
+      bucket.millis += millis;
+      return;
+    }
+  }
+  pending_.push_back(UsageBucket{day, hour, app_id, millis});
+}
+
+}  // namespace ringotrack
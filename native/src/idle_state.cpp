@@ -0,0 +1,75 @@
+#include "ringotrack/idle_state.h"
+
+namespace ringotrack {
+
+IdleStateMachine::IdleStateMachine(std::int64_t threshold_millis,
+                                   std::int64_t now_millis)
+    : threshold_millis_(threshold_millis),
+      last_activity_millis_(now_millis),
+      active_until_millis_(now_millis + threshold_millis) {
+  SetWeight(ActivitySource::kPointer, 1.0);
+  SetWeight(ActivitySource::kKeyboard, kDefaultKeyboardWeight);
+}
+
+void IdleStateMachine::SetWeight(ActivitySource source, double weight) {
+  if (weight < 0) {
+    weight = 0;
+  }
+  window_millis_[static_cast<std::size_t>(source)] = static_cast<std::int64_t>(
+      static_cast<double>(threshold_millis_) * weight);
+}
+
+void IdleStateMachine::Extend(ActivitySource source,
+                              std::int64_t timestamp_millis) {
+  if (timestamp_millis > last_activity_millis_) {
+    last_activity_millis_ = timestamp_millis;
+  }
+  const std::int64_t until =
+      timestamp_millis + window_millis_[static_cast<std::size_t>(source)];
+  if (until > active_until_millis_) {
+    active_until_millis_ = until;
+  }
+}
+
+IdleTransition IdleStateMachine::OnPointer(std::int64_t timestamp_millis,
+                                           bool is_down) {
+  Extend(ActivitySource::kPointer, timestamp_millis);
+  pointer_down_ = is_down;
+  if (is_idle_ && pointer_down_) {
+    is_idle_ = false;
+    return IdleTransition::kLeaveIdle;
+  }
+  return IdleTransition::kNone;
+}
+
+IdleTransition IdleStateMachine::OnActivity(ActivitySource source,
+                                            std::int64_t timestamp_millis) {
+  if (window_millis_[static_cast<std::size_t>(source)] <= 0) {
+    return IdleTransition::kNone;
+  }
+  Extend(source, timestamp_millis);
+  if (is_idle_) {
+    is_idle_ = false;
+    return IdleTransition::kLeaveIdle;
+  }
+  return IdleTransition::kNone;
+}
+
+IdleTransition IdleStateMachine::OnTick(std::int64_t now_millis) {
+  if (pointer_down_) {
+    Extend(ActivitySource::kPointer, now_millis);
+  }
+
+  const bool now_idle = now_millis >= active_until_millis_;
+  if (!is_idle_ && now_idle) {
+    is_idle_ = true;
+    return IdleTransition::kEnterIdle;
+  }
+  if (is_idle_ && !now_idle) {
+    is_idle_ = false;
+    return IdleTransition::kLeaveIdle;
+  }
+  return IdleTransition::kNone;
+}
+
+}  // namespace ringotrack
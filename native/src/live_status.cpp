@@ -0,0 +1,135 @@
+#include "ringotrack/live_status.h"
+
+#include <cstring>
+#include <utility>
+
+namespace ringotrack {
+
+namespace {
+
+constexpr std::uint32_t kFlagIdle = 1u << 0;
+constexpr std::uint32_t kFlagTracking = 1u << 1;
+constexpr std::size_t kNameWords = kLiveStatusAppNameBytes / 8;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "seqlock fields must be lock-free to live in shared memory");
+
+}  // namespace
+
+void LiveStatusWriter::Initialize() {
+  layout_->magic = kLiveStatusMagic;
+  layout_->version = kLiveStatusVersion;
+  layout_->size = static_cast<std::uint32_t>(sizeof(LiveStatusLayout));
+  layout_->reserved = 0;
+  // 保留已有 sequence（段可能被之前的进程创建过），只保证为偶数。
+  const std::uint64_t seq =
+      layout_->sequence.load(std::memory_order_relaxed) & ~std::uint64_t{1};
+  layout_->sequence.store(seq, std::memory_order_relaxed);
+  Publish(LiveStatus());
+}
+
+void LiveStatusWriter::Publish(const LiveStatus& status) {
+  std::uint64_t name_words[kNameWords] = {};
+  std::size_t name_len = ::strnlen(status.app_name, kLiveStatusAppNameBytes);
+  if (name_len == kLiveStatusAppNameBytes) {
+    name_len -= 1;  // 保证读者总能看到 NUL 结尾
+  }
+  std::memcpy(name_words, status.app_name, name_len);
+
+  const std::uint64_t seq = layout_->sequence.load(std::memory_order_relaxed);
+  layout_->sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  layout_->updated_at_millis.store(status.updated_at_millis,
+                                   std::memory_order_relaxed);
+  layout_->session_start_millis.store(status.session_start_millis,
+                                      std::memory_order_relaxed);
+  layout_->today_total_millis.store(status.today_total_millis,
+                                    std::memory_order_relaxed);
+  layout_->app_id.store(status.app_id, std::memory_order_relaxed);
+  layout_->flags.store((status.is_idle ? kFlagIdle : 0u) |
+                           (status.is_tracking ? kFlagTracking : 0u),
+                       std::memory_order_relaxed);
+  for (std::size_t i = 0; i < kNameWords; ++i) {
+    layout_->app_name_words[i].store(name_words[i], std::memory_order_relaxed);
+  }
+
+  layout_->sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool LiveStatusReader::Read(LiveStatus* out, int max_attempts) const {
+  if (layout_->magic != kLiveStatusMagic ||
+      layout_->version != kLiveStatusVersion) {
+    return false;
+  }
+
+  std::uint64_t name_words[kNameWords];
+  for (int attempt = 0; attempt < max_attempts; ++attempt) {
+    const std::uint64_t before =
+        layout_->sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      continue;
+    }
+
+    LiveStatus snapshot;
+    snapshot.updated_at_millis =
+        layout_->updated_at_millis.load(std::memory_order_relaxed);
+    snapshot.session_start_millis =
+        layout_->session_start_millis.load(std::memory_order_relaxed);
+    snapshot.today_total_millis =
+        layout_->today_total_millis.load(std::memory_order_relaxed);
+    snapshot.app_id = layout_->app_id.load(std::memory_order_relaxed);
+    const std::uint32_t flags = layout_->flags.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kNameWords; ++i) {
+      name_words[i] =
+          layout_->app_name_words[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (layout_->sequence.load(std::memory_order_relaxed) != before) {
+      continue;
+    }
+
+    snapshot.is_idle = (flags & kFlagIdle) != 0;
+    snapshot.is_tracking = (flags & kFlagTracking) != 0;
+    std::memcpy(snapshot.app_name, name_words, kLiveStatusAppNameBytes);
+    snapshot.app_name[kLiveStatusAppNameBytes - 1] = '\0';
+    *out = snapshot;
+    return true;
+  }
+  return false;
+}
+
+LiveStatusPublisher::LiveStatusPublisher(std::unique_ptr<SharedMemory> memory)
+    : memory_(std::move(memory)),
+      writer_(static_cast<LiveStatusLayout*>(memory_->data())) {
+  writer_.Initialize();
+}
+
+std::unique_ptr<LiveStatusPublisher> LiveStatusPublisher::Create(
+    const std::string& name) {
+  std::unique_ptr<SharedMemory> memory =
+      SharedMemory::Create(name, sizeof(LiveStatusLayout));
+  if (!memory) {
+    return nullptr;
+  }
+  return std::unique_ptr<LiveStatusPublisher>(
+      new LiveStatusPublisher(std::move(memory)));
+}
+
+LiveStatusSubscriber::LiveStatusSubscriber(std::unique_ptr<SharedMemory> memory)
+    : memory_(std::move(memory)),
+      reader_(static_cast<const LiveStatusLayout*>(memory_->data())) {}
+
+std::unique_ptr<LiveStatusSubscriber> LiveStatusSubscriber::Open(
+    const std::string& name) {
+  std::unique_ptr<SharedMemory> memory =
+      SharedMemory::OpenReadOnly(name, sizeof(LiveStatusLayout));
+  if (!memory) {
+    return nullptr;
+  }
+  return std::unique_ptr<LiveStatusSubscriber>(
+      new LiveStatusSubscriber(std::move(memory)));
+}
+
+}  // namespace ringotrack
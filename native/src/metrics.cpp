@@ -0,0 +1,132 @@
+#include "ringotrack/metrics.h"
+
+#include <chrono>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ringotrack {
+
+namespace {
+
+// 最高有效位的下标；调用方保证 value != 0。
+int MostSignificantBit(std::uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long index = 0;
+  _BitScanReverse64(&index, value);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(value);
+#endif
+}
+
+}  // namespace
+
+std::int64_t MonotonicNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<std::size_t>(value);
+  }
+  const int msb = MostSignificantBit(value);
+  const std::size_t sub =
+      static_cast<std::size_t>(value >> (msb - kSubBucketBits)) &
+      (kSubBuckets - 1);
+  return static_cast<std::size_t>(msb - kSubBucketBits + 1) * kSubBuckets +
+         sub;
+}
+
+std::uint64_t LatencyHistogram::BucketLowerBound(std::size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const int msb = static_cast<int>(index / kSubBuckets) + kSubBucketBits - 1;
+  const std::uint64_t sub = index % kSubBuckets;
+  return (std::uint64_t{1} << msb) | (sub << (msb - kSubBucketBits));
+}
+
+void LatencyHistogram::Record(std::uint64_t value) {
+  buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  std::uint64_t current = max_.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max_.compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Snapshot(HistogramSnapshot* out) const {
+  out->count = count_.load(std::memory_order_relaxed);
+  out->sum = sum_.load(std::memory_order_relaxed);
+  out->max = max_.load(std::memory_order_relaxed);
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    out->buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t ValueAtQuantile(const HistogramSnapshot& snapshot, double q) {
+  std::uint64_t total = 0;
+  for (std::uint64_t n : snapshot.buckets) {
+    total += n;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  if (q < 0) q = 0;
+  if (q > 1) q = 1;
+  // 第 rank 个样本（从 1 开始）所在的桶。
+  std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total));
+  if (rank == 0) rank = 1;
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+    seen += snapshot.buckets[i];
+    if (seen >= rank) {
+      if (i + 1 == LatencyHistogram::kBucketCount) {
+        return snapshot.max;
+      }
+      // 上界不会超过实际最大值。
+      const std::uint64_t upper = LatencyHistogram::BucketLowerBound(i + 1) - 1;
+      return upper < snapshot.max ? upper : snapshot.max;
+    }
+  }
+  return snapshot.max;
+}
+
+void MetricsRegistry::Snapshot(MetricsSnapshot* out) const {
+  out->version = kMetricsSnapshotVersion;
+  out->counter_count = static_cast<std::uint32_t>(kCounterCount);
+  out->histogram_count = static_cast<std::uint32_t>(kHistogramCount);
+  out->bucket_count = static_cast<std::uint32_t>(LatencyHistogram::kBucketCount);
+  for (std::size_t i = 0; i < kCounterCount; ++i) {
+    out->counters[i] = counters_[i].value();
+  }
+  for (std::size_t i = 0; i < kHistogramCount; ++i) {
+    histograms_[i].Snapshot(&out->histograms[i]);
+  }
+}
+
+void MetricsRegistry::Reset() {
+  for (auto& counter : counters_) {
+    counter.Reset();
+  }
+  for (auto& histogram : histograms_) {
+    histogram.Reset();
+  }
+}
+
+}  // namespace ringotrack
@@ -0,0 +1,244 @@
+#include "ringotrack/process_activity.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace ringotrack {
+
+namespace {
+
+#ifdef _WIN32
+
+constexpr std::intptr_t kNoHandle = 0;
+
+std::intptr_t OpenProcessHandle(std::uint32_t pid) {
+  const HANDLE process =
+      ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  return reinterpret_cast<std::intptr_t>(process);
+}
+
+void CloseProcessHandle(std::intptr_t handle) {
+  ::CloseHandle(reinterpret_cast<HANDLE>(handle));
+}
+
+std::uint64_t FileTimeTicks(const FILETIME& ft) {
+  return (static_cast<std::uint64_t>(ft.dwHighDateTime) << 32) |
+         ft.dwLowDateTime;
+}
+
+// 句柄会让已退出进程的内核对象一直存在，需要先确认进程仍在运行，
+// 否则 pid 被复用后会一直读到旧进程的最终 CPU 时间。
+bool ReadCpuMicros(std::intptr_t handle, std::int64_t* cpu_micros) {
+  const HANDLE process = reinterpret_cast<HANDLE>(handle);
+  DWORD exit_code = 0;
+  if (!::GetExitCodeProcess(process, &exit_code) ||
+      exit_code != STILL_ACTIVE) {
+    return false;
+  }
+  FILETIME creation_time;
+  FILETIME exit_time;
+  FILETIME kernel;
+  FILETIME user;
+  if (!::GetProcessTimes(process, &creation_time, &exit_time, &kernel,
+                         &user)) {
+    return false;
+  }
+  // FILETIME 以 100ns 为单位。
+  *cpu_micros =
+      static_cast<std::int64_t>((FileTimeTicks(kernel) + FileTimeTicks(user)) /
+                                10);
+  return true;
+}
+
+#elif defined(__linux__)
+
+constexpr std::intptr_t kNoHandle = -1;
+
+std::intptr_t OpenProcessHandle(std::uint32_t pid) {
+  char path[32];
+  std::snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+  return ::open(path, O_RDONLY | O_CLOEXEC);
+}
+
+void CloseProcessHandle(std::intptr_t handle) {
+  ::close(static_cast<int>(handle));
+}
+
+std::int64_t ClockTicksPerSecond() {
+  static const long ticks = ::sysconf(_SC_CLK_TCK);
+  return ticks > 0 ? ticks : 100;
+}
+
+// 进程退出后已打开的 stat 文件读取返回 ESRCH，pid 被复用也不会读到新进程。
+bool ReadCpuMicros(std::intptr_t handle, std::int64_t* cpu_micros) {
+  char buffer[1024];
+  const ssize_t n =
+      ::pread(static_cast<int>(handle), buffer, sizeof(buffer) - 1, 0);
+  if (n <= 0) {
+    return false;
+  }
+  buffer[n] = '\0';
+  // 第 2 个字段是括号包住的进程名，可能含空格与括号，从最后一个 ')' 之后
+  // 开始数：其后第 1 个字段是第 3 列（state），utime / stime 是第 14 / 15 列。
+  const char* p = std::strrchr(buffer, ')');
+  if (p == nullptr) {
+    return false;
+  }
+  ++p;
+  for (int field = 3; field < 14; ++field) {
+    p = std::strchr(p + 1, ' ');
+    if (p == nullptr) {
+      return false;
+    }
+  }
+  char* end = nullptr;
+  const unsigned long long utime = std::strtoull(p, &end, 10);
+  if (end == p) {
+    return false;
+  }
+  const char* stime_begin = end;
+  const unsigned long long stime = std::strtoull(stime_begin, &end, 10);
+  if (end == stime_begin) {
+    return false;
+  }
+  const std::int64_t ticks = static_cast<std::int64_t>(utime + stime);
+  *cpu_micros = ticks * 1000000 / ClockTicksPerSecond();
+  return true;
+}
+
+#else
+
+constexpr std::intptr_t kNoHandle = -1;
+
+std::intptr_t OpenProcessHandle(std::uint32_t) { return kNoHandle; }
+
+void CloseProcessHandle(std::intptr_t) {}
+
+bool ReadCpuMicros(std::intptr_t, std::int64_t*) { return false; }
+
+#endif
+
+}  // namespace
+
+ProcessCpuSampler::~ProcessCpuSampler() { Clear(); }
+
+bool ProcessCpuSampler::IsSupported() {
+#if defined(_WIN32) || defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::size_t ProcessCpuSampler::Sample(const std::uint32_t* pids,
+                                      std::size_t count,
+                                      std::int64_t* cpu_micros) {
+  next_.clear();
+  std::size_t ok = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t pid = pids[i];
+    cpu_micros[i] = -1;
+
+    std::intptr_t handle = kNoHandle;
+    bool cached = false;
+    for (std::size_t j = 0; j < entries_.size(); ++j) {
+      if (entries_[j].pid == pid) {
+        handle = entries_[j].handle;
+        entries_[j] = entries_.back();
+        entries_.pop_back();
+        cached = true;
+        break;
+      }
+    }
+    if (handle == kNoHandle) {
+      handle = OpenProcessHandle(pid);
+    }
+    if (handle == kNoHandle) {
+      continue;
+    }
+    if (!ReadCpuMicros(handle, &cpu_micros[i])) {
+      CloseProcessHandle(handle);
+      handle = cached ? OpenProcessHandle(pid) : kNoHandle;
+      if (handle == kNoHandle) {
+        continue;
+      }
+      if (!ReadCpuMicros(handle, &cpu_micros[i])) {
+        CloseProcessHandle(handle);
+        continue;
+      }
+    }
+    next_.push_back(Entry{pid, handle});
+    ++ok;
+  }
+  Clear();
+  entries_.swap(next_);
+  return ok;
+}
+
+void ProcessCpuSampler::Clear() {
+  for (const Entry& entry : entries_) {
+    CloseProcessHandle(entry.handle);
+  }
+  entries_.clear();
+}
+
+BusyClassifier::BusyClassifier(const BusyClassifierConfig& config)
+    : config_(config) {}
+
+BusyTransition BusyClassifier::OnSample(std::int64_t wall_millis,
+                                        std::int64_t cpu_micros) {
+  const std::int64_t interval_start = last_wall_millis_;
+  const std::int64_t wall = wall_millis - last_wall_millis_;
+  const std::int64_t cpu = cpu_micros - last_cpu_micros_;
+  const bool valid = has_baseline_ && wall > 0 &&
+                     wall <= config_.max_gap_millis && cpu >= 0;
+  has_baseline_ = true;
+  last_wall_millis_ = wall_millis;
+  last_cpu_micros_ = cpu_micros;
+  if (!valid) {
+    streak_ = 0;
+    return BusyTransition::kNone;
+  }
+
+  // 微秒 / 毫秒恰好是千分比。
+  last_permille_ = static_cast<std::uint32_t>(cpu / wall);
+  const bool busy_sample = last_permille_ >= config_.busy_permille;
+  if (busy_sample == is_busy_) {
+    streak_ = 0;
+    return BusyTransition::kNone;
+  }
+  if (streak_ == 0) {
+    streak_start_millis_ = interval_start;
+  }
+  const std::uint32_t needed =
+      is_busy_ ? config_.exit_samples : config_.enter_samples;
+  if (++streak_ < needed) {
+    return BusyTransition::kNone;
+  }
+  streak_ = 0;
+  is_busy_ = !is_busy_;
+  changed_at_millis_ = streak_start_millis_;
+  return is_busy_ ? BusyTransition::kEnterBusy : BusyTransition::kLeaveBusy;
+}
+
+BusyTransition BusyClassifier::Reset(std::int64_t at_millis) {
+  has_baseline_ = false;
+  streak_ = 0;
+  last_permille_ = 0;
+  if (!is_busy_) {
+    return BusyTransition::kNone;
+  }
+  is_busy_ = false;
+  changed_at_millis_ = at_millis;
+  return BusyTransition::kLeaveBusy;
+}
+
+}  // namespace ringotrack
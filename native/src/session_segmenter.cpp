@@ -0,0 +1,70 @@
+#include "ringotrack/session_segmenter.h"
+
+namespace ringotrack {
+
+void SessionSegmenter::OnInterval(AppId app_id, std::int64_t start_millis,
+                                  std::int64_t end_millis) {
+  if (app_id == kNoApp || end_millis <= start_millis) {
+    return;
+  }
+  if (app_id >= slot_of_app_.size()) {
+    slot_of_app_.resize(app_id + 1, kNoSlot);
+  }
+
+  const std::int32_t slot = slot_of_app_[app_id];
+  if (slot != kNoSlot) {
+    DrawingSession& session = open_[slot];
+    if (start_millis - session.end_millis <= merge_gap_) {
+      if (end_millis > session.end_millis) {
+        session.end_millis = end_millis;
+      }
+      session.active_millis += end_millis - start_millis;
+      return;
+    }
+    // 间隔过长：旧会话结束，原地开始新会话。
+    finished_.push_back(session);
+    session = DrawingSession{app_id, start_millis, end_millis,
+                             end_millis - start_millis};
+    return;
+  }
+
+  slot_of_app_[app_id] = static_cast<std::int32_t>(open_.size());
+  open_.push_back(DrawingSession{app_id, start_millis, end_millis,
+                                 end_millis - start_millis});
+}
+
+void SessionSegmenter::ExpireBefore(std::int64_t now_millis) {
+  std::size_t i = 0;
+  while (i < open_.size()) {
+    if (now_millis - open_[i].end_millis > merge_gap_) {
+      Finish(i);  // 末尾元素换到 i，继续检查同一位置
+    } else {
+      ++i;
+    }
+  }
+}
+
+void SessionSegmenter::CloseAll() {
+  while (!open_.empty()) {
+    Finish(open_.size() - 1);
+  }
+}
+
+std::size_t SessionSegmenter::Drain(std::vector<DrawingSession>* out) {
+  const std::size_t count = finished_.size();
+  out->insert(out->end(), finished_.begin(), finished_.end());
+  finished_.clear();
+  return count;
+}
+
+void SessionSegmenter::Finish(std::size_t index) {
+  finished_.push_back(open_[index]);
+  slot_of_app_[open_[index].app_id] = kNoSlot;
+  if (index + 1 != open_.size()) {
+    open_[index] = open_.back();
+    slot_of_app_[open_[index].app_id] = static_cast<std::int32_t>(index);
+  }
+  open_.pop_back();
+}
+
+}  // namespace ringotrack
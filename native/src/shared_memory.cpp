@@ -0,0 +1,124 @@
+#include "ringotrack/shared_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ringotrack {
+
+#ifdef _WIN32
+
+namespace {
+
+std::string PlatformName(const std::string& name) { return "Local\\" + name; }
+
+}  // namespace
+
+SharedMemory::~SharedMemory() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (handle_ != nullptr) {
+    ::CloseHandle(static_cast<HANDLE>(handle_));
+  }
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name,
+                                                   std::size_t size) {
+  HANDLE mapping = ::CreateFileMappingA(
+      INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+      static_cast<DWORD>(size), PlatformName(name).c_str());
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  void* data = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (data == nullptr) {
+    ::CloseHandle(mapping);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(data, size, mapping));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::OpenReadOnly(
+    const std::string& name, std::size_t size) {
+  HANDLE mapping =
+      ::OpenFileMappingA(FILE_MAP_READ, FALSE, PlatformName(name).c_str());
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  if (data == nullptr) {
+    ::CloseHandle(mapping);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(data, size, mapping));
+}
+
+void SharedMemory::Unlink(const std::string&) {}
+
+#else
+
+namespace {
+
+std::string PlatformName(const std::string& name) { return "/" + name; }
+
+}  // namespace
+
+SharedMemory::~SharedMemory() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name,
+                                                   std::size_t size) {
+  const int fd = ::shm_open(PlatformName(name).c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      (static_cast<std::size_t>(st.st_size) < size &&
+       ::ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(data, size, nullptr));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::OpenReadOnly(
+    const std::string& name, std::size_t size) {
+  const int fd = ::shm_open(PlatformName(name).c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < size) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemory>(new SharedMemory(data, size, nullptr));
+}
+
+void SharedMemory::Unlink(const std::string& name) {
+  ::shm_unlink(PlatformName(name).c_str());
+}
+
+#endif
+
+}  // namespace ringotrack
@@ -0,0 +1,214 @@
+#include "ringotrack/title_rules.h"
+
+namespace ringotrack {
+
+const char kDefaultTitleRules[] =
+    "# Photoshop：`文档名 @ 缩放 (图层, 模式)`，新版本标题前带产品名。\n"
+    "photoshop.exe Adobe Photoshop * - {doc} @ *\n"
+    "photoshop.exe {doc} @ *\n"
+    "com.adobe.photoshop {doc} @ *\n"
+    "# Krita：`文档名 - Krita`，未保存时带 `*`。\n"
+    "krita.exe {doc} - Krita\n"
+    "org.kde.krita {doc} - Krita\n"
+    "# CLIP STUDIO PAINT：`CLIP STUDIO PAINT - [文档名]`。\n"
+    "clipstudiopaint.exe CLIP STUDIO PAINT* - [{doc}]*\n"
+    "clipstudiopaint.exe CLIP STUDIO PAINT* - {doc}\n"
+    "jp.co.celsys.clipstudiopaint CLIP STUDIO PAINT* - {doc}\n"
+    "# PaintTool SAI：`PaintTool SAI Ver.2 - [文档名]`。\n"
+    "sai.exe PaintTool SAI* - [{doc}]*\n"
+    "sai2.exe PaintTool SAI* - [{doc}]*\n";
+
+namespace {
+
+constexpr std::string_view kCaptureToken = "{doc}";
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+         c == '\f';
+}
+
+std::string_view TrimSpaces(std::string_view text) {
+  std::size_t begin = 0;
+  std::size_t end = text.size();
+  while (begin < end && IsSpace(text[begin])) {
+    ++begin;
+  }
+  while (end > begin && IsSpace(text[end - 1])) {
+    --end;
+  }
+  return text.substr(begin, end - begin);
+}
+
+// 文档名两端的空白与「未保存」标记。
+std::string_view TrimDocument(std::string_view doc) {
+  std::size_t begin = 0;
+  std::size_t end = doc.size();
+  while (begin < end && (IsSpace(doc[begin]) || doc[begin] == '*')) {
+    ++begin;
+  }
+  while (end > begin && (IsSpace(doc[end - 1]) || doc[end - 1] == '*')) {
+    --end;
+  }
+  return doc.substr(begin, end - begin);
+}
+
+}  // namespace
+
+std::unique_ptr<TitleRuleSet> TitleRuleSet::Compile(std::string_view config,
+                                                    int* error_line) {
+  std::unique_ptr<TitleRuleSet> rules(new TitleRuleSet());
+  int line_number = 0;
+  while (!config.empty()) {
+    ++line_number;
+    const std::size_t newline = config.find('\n');
+    std::string_view line = config.substr(0, newline);
+    config = newline == std::string_view::npos ? std::string_view()
+                                               : config.substr(newline + 1);
+
+    line = TrimSpaces(line);
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    std::size_t split = 0;
+    while (split < line.size() && !IsSpace(line[split])) {
+      ++split;
+    }
+    const std::string_view app = line.substr(0, split);
+    const std::string_view pattern = TrimSpaces(line.substr(split));
+    if (!rules->AddRule(app, pattern)) {
+      if (error_line != nullptr) {
+        *error_line = line_number;
+      }
+      return nullptr;
+    }
+  }
+  if (error_line != nullptr) {
+    *error_line = 0;
+  }
+  return rules;
+}
+
+bool TitleRuleSet::AddRule(std::string_view app, std::string_view pattern) {
+  if (app.empty() || pattern.empty()) {
+    return false;
+  }
+
+  const std::size_t segments_before = segments_.size();
+  const std::size_t literals_before = literals_.size();
+  auto rollback = [&]() {
+    segments_.resize(segments_before);
+    literals_.resize(literals_before);
+    return false;
+  };
+
+  Segment current{static_cast<std::uint32_t>(literals_.size()), 0, false};
+  // 当前字面量之前是否紧跟一个通配（`*` 或 `{doc}`）。
+  bool after_wildcard = false;
+  bool current_is_capture = false;
+  bool seen_capture = false;
+  std::size_t i = 0;
+  while (i < pattern.size()) {
+    const bool is_capture =
+        pattern.compare(i, kCaptureToken.size(), kCaptureToken) == 0;
+    if (is_capture || pattern[i] == '*') {
+      if (current.length == 0 && after_wildcard) {
+        // 连续的 `**` 等价于 `*`；但与捕获相邻时边界不确定，视为错误。
+        if (is_capture || current_is_capture) {
+          return rollback();
+        }
+        ++i;
+        continue;
+      }
+      if (is_capture) {
+        if (seen_capture) {
+          return rollback();
+        }
+        seen_capture = true;
+      }
+      segments_.push_back(current);
+      current = Segment{static_cast<std::uint32_t>(literals_.size()), 0,
+                        is_capture};
+      after_wildcard = true;
+      current_is_capture = is_capture;
+      i += is_capture ? kCaptureToken.size() : 1;
+      continue;
+    }
+    literals_.push_back(pattern[i]);
+    ++current.length;
+    ++i;
+  }
+  segments_.push_back(current);
+
+  if (!seen_capture) {
+    return rollback();
+  }
+
+  const AppId app_id = apps_.Intern(app);
+  if (rules_by_app_.size() < app_id) {
+    rules_by_app_.resize(app_id);
+  }
+  rules_by_app_[app_id - 1].push_back(
+      static_cast<std::uint32_t>(patterns_.size()));
+  patterns_.push_back(
+      Pattern{static_cast<std::uint32_t>(segments_before),
+              static_cast<std::uint32_t>(segments_.size() - segments_before)});
+  return true;
+}
+
+bool TitleRuleSet::Match(const Pattern& pattern, std::string_view title,
+                         std::string_view* doc) const {
+  const Segment* segments = segments_.data() + pattern.first_segment;
+  const std::string_view literals(literals_);
+
+  const Segment& head = segments[0];
+  const std::string_view prefix = literals.substr(head.offset, head.length);
+  if (title.substr(0, prefix.size()) != prefix) {
+    return false;
+  }
+
+  std::size_t pos = prefix.size();
+  for (std::uint32_t i = 1; i < pattern.segment_count; ++i) {
+    const Segment& segment = segments[i];
+    const std::string_view literal =
+        literals.substr(segment.offset, segment.length);
+    std::size_t found;
+    if (i + 1 == pattern.segment_count) {
+      // 最后一段锚定到末尾，且不能与前面已匹配的部分重叠。
+      if (title.size() < pos + literal.size() ||
+          title.substr(title.size() - literal.size()) != literal) {
+        return false;
+      }
+      found = title.size() - literal.size();
+    } else {
+      found = title.find(literal, pos);
+      if (found == std::string_view::npos) {
+        return false;
+      }
+    }
+    if (segment.capture_before) {
+      *doc = title.substr(pos, found - pos);
+    }
+    pos = found + literal.size();
+  }
+
+  *doc = TrimDocument(*doc);
+  return !doc->empty();
+}
+
+std::string_view TitleRuleSet::Extract(std::string_view app,
+                                       std::string_view title) const {
+  const AppId app_id = apps_.Find(app);
+  if (app_id == kNoApp) {
+    return std::string_view();
+  }
+  for (const std::uint32_t index : rules_by_app_[app_id - 1]) {
+    std::string_view doc;
+    if (Match(patterns_[index], title, &doc)) {
+      return doc;
+    }
+  }
+  return std::string_view();
+}
+
+}  // namespace ringotrack
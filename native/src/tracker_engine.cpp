@@ -0,0 +1,117 @@
+#include "ringotrack/tracker_engine.h"
+
+namespace ringotrack {
+
+void TrackerEngine::Process(const TrackerEvent& event) {
+  switch (event.kind) {
+    case TrackerEventKind::kForegroundChanged:
+      foreground_app_ = event.app_id;
+      // Idle / 暂停状态下不计时，只记住前台应用以便恢复后继续。
+      if (!idle_.is_idle() && !is_paused()) {
+        aggregator_.OnForegroundChanged(foreground_app_, event.timestamp_millis);
+      }
+      break;
+    case TrackerEventKind::kPointerDown:
+    case TrackerEventKind::kPointerUp:
+      ApplyIdleTransition(
+          idle_.OnPointer(event.timestamp_millis,
+                          event.kind == TrackerEventKind::kPointerDown),
+          event.timestamp_millis);
+      break;
+    case TrackerEventKind::kKeyActivity:
+      ApplyIdleTransition(
+          idle_.OnActivity(ActivitySource::kKeyboard, event.timestamp_millis),
+          event.timestamp_millis);
+      break;
+    case TrackerEventKind::kSessionLocked:
+      Pause(kPausedByLock, event.timestamp_millis);
+      break;
+    case TrackerEventKind::kSessionUnlocked:
+      Resume(kPausedByLock, event.timestamp_millis);
+      break;
+    case TrackerEventKind::kSystemSuspend:
+      Pause(kPausedBySuspend, event.timestamp_millis);
+      break;
+    case TrackerEventKind::kSystemResume:
+      Resume(kPausedBySuspend, event.timestamp_millis);
+      break;
+  }
+}
+
+std::size_t TrackerEngine::ProcessQueue(TrackerEventQueue* queue) {
+  constexpr std::size_t kBatch = 64;
+  TrackerEvent batch[kBatch];
+  std::size_t total = 0;
+  while (true) {
+    const std::size_t count = queue->PopBatch(batch, kBatch);
+    for (std::size_t i = 0; i < count; ++i) {
+      Process(batch[i]);
+    }
+    total += count;
+    if (count < kBatch) {
+      return total;
+    }
+  }
+}
+
+void TrackerEngine::Tick(std::int64_t now_millis) {
+  if (is_paused()) {
+    return;
+  }
+  const IdleTransition transition = idle_.OnTick(now_millis);
+  if (transition != IdleTransition::kNone) {
+    ApplyIdleTransition(transition, now_millis);
+    return;
+  }
+  if (!idle_.is_idle() && foreground_app_ != kNoApp) {
+    aggregator_.OnForegroundChanged(foreground_app_, now_millis);
+  }
+}
+
+void TrackerEngine::ApplyIdleTransition(IdleTransition transition,
+                                        std::int64_t at_millis) {
+  if (is_paused()) {
+    return;
+  }
+  switch (transition) {
+    case IdleTransition::kEnterIdle:
+      aggregator_.OnForegroundChanged(kNoApp, at_millis);
+      break;
+    case IdleTransition::kLeaveIdle:
+      if (foreground_app_ != kNoApp) {
+        aggregator_.OnForegroundChanged(foreground_app_, at_millis);
+      }
+      break;
+    case IdleTransition::kNone:
+      break;
+  }
+}
+
+void TrackerEngine::Pause(std::uint32_t reason, std::int64_t at_millis) {
+  if (!is_paused()) {
+    aggregator_.OnForegroundChanged(kNoApp, at_millis);
+  }
+  pause_reasons_ |= reason;
+  idle_.ReleasePointer();
+}
+
+void TrackerEngine::Resume(std::uint32_t reason, std::int64_t at_millis) {
+  if ((pause_reasons_ & reason) == 0) {
+    return;
+  }
+  pause_reasons_ &= ~reason;
+  if (is_paused()) {
+    return;
+  }
+  // 按恢复时刻重新判定 Idle：长时间锁屏 / 休眠后直接进入 Idle，
+  // 等下一次落笔才继续计时，唤醒那一刻不会把空档算给前台应用。
+  const IdleTransition transition = idle_.OnTick(at_millis);
+  if (transition == IdleTransition::kNone && !idle_.is_idle() &&
+      foreground_app_ != kNoApp) {
+    aggregator_.OnForegroundChanged(foreground_app_, at_millis);
+    return;
+  }
+  ApplyIdleTransition(transition, at_millis);
+}
+
+}  // namespace ringotrack
@@ -0,0 +1,326 @@
+#include "ringotrack/tracking_daemon.h"
+
+#include <cstdlib>
+#include <istream>
+
+namespace ringotrack {
+
+namespace {
+
+std::string FoldAscii(std::string_view name) {
+  std::string folded(name);
+  for (char& c : folded) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return folded;
+}
+
+std::int64_t TotalMillis(const std::vector<UsageBucket>& buckets) {
+  std::int64_t total = 0;
+  for (const UsageBucket& bucket : buckets) {
+    total += bucket.millis;
+  }
+  return total;
+}
+
+}  // namespace
+
+TrackingDaemon::TrackingDaemon(const Clock* clock, EventSource* source,
+                               UsageSink* sink, const ClientLeaseLayout* lease,
+                               const TrackingDaemonOptions& options)
+    : clock_(clock),
+      source_(source),
+      sink_(sink),
+      lease_(lease),
+      options_(options),
+      engine_(clock, options.record_all_apps ? nullptr : &tracked_,
+              options.idle_threshold_millis, clock->NowUnixMillis()),
+      last_step_millis_(clock->NowUnixMillis()),
+      last_flush_millis_(last_step_millis_) {}
+
+void TrackingDaemon::SetTrackedApps(const std::vector<std::string>& app_ids) {
+  tracked_names_.clear();
+  for (const std::string& id : app_ids) {
+    tracked_names_.insert(FoldAscii(id));
+  }
+  tracked_.Clear();
+  for (AppId id = 1; id <= apps_.size(); ++id) {
+    if (IsTracked(apps_.Name(id))) {
+      tracked_.Add(id);
+    }
+  }
+}
+
+bool TrackingDaemon::IsTracked(std::string_view name) const {
+  return tracked_names_.count(FoldAscii(name)) != 0;
+}
+
+AppId TrackingDaemon::Resolve(std::string_view name) {
+  const std::size_t known = apps_.size();
+  const AppId id = apps_.Intern(name);
+  if (apps_.size() > known && IsTracked(name)) {
+    tracked_.Add(id);
+  }
+  return id;
+}
+
+void TrackingDaemon::Step() {
+  const std::int64_t now = clock_->NowUnixMillis();
+  source_->Poll(now, this, &queue_);
+  engine_.ProcessQueue(&queue_);
+  engine_.Tick(now);
+
+  scratch_.clear();
+  if (engine_.Drain(&scratch_) > 0) {
+    undecided_.push_back(Slice{last_step_millis_, now, scratch_});
+  }
+  last_step_millis_ = now;
+
+  ObserveLease(now);
+  SettleSlices();
+
+  if (now - last_flush_millis_ >= options_.flush_interval_millis) {
+    Flush();
+  }
+}
+
+void TrackingDaemon::ObserveLease(std::int64_t now_millis) {
+  client_alive_ = false;
+  if (lease_ == nullptr || !ReadClientLease(*lease_, &client_)) {
+    return;
+  }
+  client_alive_ = client_.IsAlive(now_millis, options_.client_timeout_millis);
+
+  if (client_.attached_since_millis != 0) {
+    if (coverage_.empty() ||
+        coverage_.back().since_millis != client_.attached_since_millis) {
+      coverage_.push_back(Coverage{client_.attached_since_millis,
+                                   client_.persisted_until_millis});
+    } else if (client_.persisted_until_millis > coverage_.back().until_millis) {
+      coverage_.back().until_millis = client_.persisted_until_millis;
+    }
+  }
+
+  // 早于所有待判定切片的旧租约不再需要；当前租约保留到客户端失效。
+  const std::int64_t oldest =
+      undecided_.empty() ? last_step_millis_ : undecided_.front().start_millis;
+  std::size_t keep = 0;
+  for (std::size_t i = 0; i < coverage_.size(); ++i) {
+    const bool current = i + 1 == coverage_.size() && client_alive_;
+    if (current || coverage_[i].until_millis >= oldest) {
+      coverage_[keep++] = coverage_[i];
+    }
+  }
+  coverage_.resize(keep);
+}
+
+void TrackingDaemon::SettleSlices() {
+  while (!undecided_.empty()) {
+    const Slice& slice = undecided_.front();
+    // 切片按中点归属：跨越交接时刻的那一拍整体归给中点所在的一方。
+    const std::int64_t mid =
+        slice.start_millis + (slice.end_millis - slice.start_millis) / 2;
+
+    bool covered = false;
+    for (const Coverage& coverage : coverage_) {
+      if (coverage.since_millis <= mid && mid <= coverage.until_millis) {
+        covered = true;
+        break;
+      }
+    }
+    if (covered) {
+      handed_over_millis_ += TotalMillis(slice.buckets);
+      undecided_.pop_front();
+      continue;
+    }
+    if (client_alive_ && mid >= client_.attached_since_millis) {
+      // 客户端还在记账，可能稍后把这段落库。
+      return;
+    }
+    Own(slice.buckets);
+    undecided_.pop_front();
+  }
+}
+
+void TrackingDaemon::Own(const std::vector<UsageBucket>& buckets) {
+  for (const UsageBucket& bucket : buckets) {
+    bool merged = false;
+    for (UsageBucket& owned : owned_) {
+      if (owned.app_id == bucket.app_id && owned.hour == bucket.hour &&
+          owned.day == bucket.day) {
+        owned.millis += bucket.millis;
+        merged = true;
+        break;
+      }
+    }
+    if (!merged) {
+      owned_.push_back(bucket);
+    }
+  }
+}
+
+bool TrackingDaemon::Flush() {
+  const std::int64_t now = clock_->NowUnixMillis();
+  last_flush_millis_ = now;
+
+  std::vector<UsageRecord> records;
+  for (const UsageBucket& bucket : owned_) {
+    const std::int64_t seconds = bucket.millis / kMillisPerSecond;
+    if (seconds <= 0) {
+      continue;
+    }
+    records.push_back(UsageRecord{
+        bucket.day, bucket.hour, bucket.app_id, seconds,
+        !options_.record_all_apps || tracked_.Contains(bucket.app_id)});
+  }
+
+  if (!records.empty()) {
+    if (!sink_->Persist(records, apps_)) {
+      ++failed_flushes_;
+      return false;
+    }
+    for (const UsageRecord& record : records) {
+      persisted_seconds_ += record.seconds;
+    }
+  }
+
+  // 只保留不足 1 秒的余数，且只保留最近两天的，其余丢弃。
+  const std::int32_t today = LocalHourAt(*clock_, now).day;
+  std::size_t keep = 0;
+  for (UsageBucket& bucket : owned_) {
+    bucket.millis %= kMillisPerSecond;
+    if (bucket.millis > 0 && bucket.day >= today - 1) {
+      owned_[keep++] = bucket;
+    }
+  }
+  owned_.resize(keep);
+  return true;
+}
+
+bool TrackingDaemon::Shutdown() {
+  const std::int64_t now = clock_->NowUnixMillis();
+  source_->Poll(now, this, &queue_);
+  engine_.ProcessQueue(&queue_);
+  engine_.CloseAt(now);
+
+  scratch_.clear();
+  if (engine_.Drain(&scratch_) > 0) {
+    undecided_.push_back(Slice{last_step_millis_, now, scratch_});
+  }
+  last_step_millis_ = now;
+
+  ObserveLease(now);
+  SettleSlices();
+  // 客户端仍存活时剩下的切片由它负责。
+  undecided_.clear();
+  return Flush();
+}
+
+std::int64_t TrackingDaemon::NextStepDelayMillis() const {
+  const AppId app = engine_.foreground_app();
+  const bool counting =
+      !engine_.is_idle() && !engine_.is_paused() && app != kNoApp &&
+      (options_.record_all_apps || tracked_.Contains(app));
+  return counting ? options_.active_step_millis
+                  : options_.background_step_millis;
+}
+
+void ScriptedEventSource::Poll(std::int64_t now_millis, AppResolver* apps,
+                               TrackerEventQueue* queue) {
+  while (next_ < events_.size()) {
+    const ScriptedEvent& scripted = events_[next_];
+    const std::int64_t at = start_millis_ + scripted.offset_millis;
+    if (at > now_millis) {
+      return;
+    }
+    TrackerEvent event{at, scripted.kind, kNoApp};
+    if (scripted.kind == TrackerEventKind::kForegroundChanged &&
+        !scripted.app.empty()) {
+      event.app_id = apps->Resolve(scripted.app);
+    }
+    if (!queue->TryPush(event)) {
+      return;  // 队列满，下次 Poll 继续
+    }
+    ++next_;
+  }
+}
+
+std::int64_t ScriptedEventSource::end_millis() const {
+  return events_.empty() ? start_millis_
+                         : start_millis_ + events_.back().offset_millis;
+}
+
+bool ParseEventScript(std::istream& in, std::vector<ScriptedEvent>* out,
+                      std::string* error) {
+  struct KindName {
+    const char* name;
+    TrackerEventKind kind;
+  };
+  static constexpr KindName kKinds[] = {
+      {"fg", TrackerEventKind::kForegroundChanged},
+      {"down", TrackerEventKind::kPointerDown},
+      {"up", TrackerEventKind::kPointerUp},
+      {"key", TrackerEventKind::kKeyActivity},
+      {"lock", TrackerEventKind::kSessionLocked},
+      {"unlock", TrackerEventKind::kSessionUnlocked},
+      {"suspend", TrackerEventKind::kSystemSuspend},
+      {"resume", TrackerEventKind::kSystemResume},
+  };
+
+  std::string line;
+  std::size_t line_number = 0;
+  std::int64_t last_offset = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    const std::size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') {
+      continue;
+    }
+
+    const char* cursor = line.c_str() + begin;
+    char* end = nullptr;
+    const long long offset = std::strtoll(cursor, &end, 10);
+    if (end == cursor || offset < last_offset) {
+      *error = "line " + std::to_string(line_number) + ": bad offset";
+      return false;
+    }
+    last_offset = offset;
+
+    const std::string rest(end);
+    const std::size_t kind_begin = rest.find_first_not_of(" \t");
+    const std::size_t kind_end = rest.find_first_of(" \t\r", kind_begin);
+    const std::string kind_name =
+        kind_begin == std::string::npos
+            ? std::string()
+            : rest.substr(kind_begin, kind_end - kind_begin);
+
+    ScriptedEvent event{offset, TrackerEventKind::kForegroundChanged, {}};
+    bool known = false;
+    for (const KindName& kind : kKinds) {
+      if (kind_name == kind.name) {
+        event.kind = kind.kind;
+        known = true;
+        break;
+      }
+    }
+    if (!known) {
+      *error = "line " + std::to_string(line_number) + ": unknown event '" +
+               kind_name + "'";
+      return false;
+    }
+
+    if (kind_end != std::string::npos) {
+      const std::size_t app_begin = rest.find_first_not_of(" \t", kind_end);
+      const std::size_t app_end = rest.find_last_not_of(" \t\r");
+      if (app_begin != std::string::npos && app_end >= app_begin) {
+        event.app = rest.substr(app_begin, app_end - app_begin + 1);
+      }
+    }
+    out->push_back(std::move(event));
+  }
+  return true;
+}
+
+}  // namespace ringotrack
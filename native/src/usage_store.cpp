@@ -0,0 +1,182 @@
+#include "ringotrack/usage_store.h"
+
+#include <sqlite3.h>
+
+namespace ringotrack {
+
+namespace {
+
+constexpr int kBusyTimeoutMillis = 5000;
+
+}  // namespace
+
+SqliteUsageStore::~SqliteUsageStore() { Close(); }
+
+bool SqliteUsageStore::Persist(const std::vector<UsageRecord>& records,
+                               const AppInterner& apps) {
+  if (records.empty()) {
+    return true;
+  }
+  if (db_ == nullptr && !Open()) {
+    return false;
+  }
+  if (!Exec("BEGIN IMMEDIATE")) {
+    Close();
+    return false;
+  }
+
+  dictionary_ids_.assign(apps.size() + 1, -1);
+  bool ok = true;
+  for (const UsageRecord& record : records) {
+    std::int64_t& app = dictionary_ids_[record.app_id];
+    if (app < 0 && !InternApp(apps.Name(record.app_id), &app)) {
+      ok = false;
+      break;
+    }
+    const std::int64_t key = HourlyUsageKey(record.day, record.hour, app);
+    if (record.tracked &&
+        (!Run(add_daily_, {record.day, app, record.seconds}) ||
+         !Run(add_hourly_, {key, record.seconds}) ||
+         (log_change_ != nullptr && !Run(log_change_, {key})))) {
+      ok = false;
+      break;
+    }
+    if (record_all_apps_ &&
+        !Run(add_all_apps_, {record.day, record.hour, app, record.seconds})) {
+      ok = false;
+      break;
+    }
+  }
+
+  if (ok && Exec("COMMIT")) {
+    return true;
+  }
+  const std::string error = last_error_;
+  sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+  // 下次重试时重新打开，文件被替换或 schema 变化时也能恢复。
+  Close();
+  last_error_ = error;
+  return false;
+}
+
+bool SqliteUsageStore::Open() {
+  if (sqlite3_open_v2(path_.c_str(), &db_,
+                      SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX,
+                      nullptr) != SQLITE_OK) {
+    Fail("open");
+    Close();
+    return false;
+  }
+  sqlite3_busy_timeout(db_, kBusyTimeoutMillis);
+
+  sqlite3_stmt* version = nullptr;
+  if (!Prepare("PRAGMA user_version", &version)) {
+    Close();
+    return false;
+  }
+  const int schema =
+      sqlite3_step(version) == SQLITE_ROW ? sqlite3_column_int(version, 0) : 0;
+  sqlite3_finalize(version);
+  if (schema < kMinUsageSchemaVersion) {
+    last_error_ = "schema version " + std::to_string(schema) +
+                  " is older than " + std::to_string(kMinUsageSchemaVersion);
+    Close();
+    return false;
+  }
+
+  const bool prepared =
+      Prepare("INSERT INTO app_dictionary (app_id) VALUES (?1) "
+              "ON CONFLICT(app_id) DO NOTHING",
+              &insert_app_) &&
+      Prepare("SELECT id FROM app_dictionary WHERE app_id = ?1",
+              &select_app_) &&
+      Prepare("INSERT INTO daily_usage (day, app, seconds) "
+              "VALUES (?1, ?2, ?3) "
+              "ON CONFLICT(day, app) DO UPDATE SET "
+              "seconds = seconds + excluded.seconds",
+              &add_daily_) &&
+      Prepare("INSERT INTO hourly_usage (packed_key, seconds) "
+              "VALUES (?1, ?2) "
+              "ON CONFLICT(packed_key) DO UPDATE SET "
+              "seconds = seconds + excluded.seconds",
+              &add_hourly_) &&
+      (!record_all_apps_ ||
+       Prepare("INSERT INTO hourly_app_usage (day, hour, app, seconds) "
+               "VALUES (?1, ?2, ?3, ?4) "
+               "ON CONFLICT(day, hour, app) DO UPDATE SET "
+               "seconds = seconds + excluded.seconds",
+               &add_all_apps_)) &&
+      (schema < kChangeLogSchemaVersion ||
+       Prepare("INSERT OR REPLACE INTO usage_change_log (packed_key) "
+               "VALUES (?1)",
+               &log_change_));
+  if (!prepared) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void SqliteUsageStore::Close() {
+  for (sqlite3_stmt** stmt : {&insert_app_, &select_app_, &add_daily_,
+                              &add_hourly_, &add_all_apps_, &log_change_}) {
+    sqlite3_finalize(*stmt);
+    *stmt = nullptr;
+  }
+  if (db_ != nullptr) {
+    sqlite3_close(db_);
+    db_ = nullptr;
+  }
+}
+
+bool SqliteUsageStore::Fail(const char* what) {
+  last_error_ = std::string(what) + ": " +
+                (db_ != nullptr ? sqlite3_errmsg(db_) : "out of memory");
+  return false;
+}
+
+bool SqliteUsageStore::Exec(const char* sql) {
+  if (sqlite3_exec(db_, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+    return Fail(sql);
+  }
+  return true;
+}
+
+bool SqliteUsageStore::Prepare(const char* sql, sqlite3_stmt** stmt) {
+  if (sqlite3_prepare_v2(db_, sql, -1, stmt, nullptr) != SQLITE_OK) {
+    return Fail("prepare");
+  }
+  return true;
+}
+
+bool SqliteUsageStore::InternApp(std::string_view name, std::int64_t* id) {
+  for (sqlite3_stmt* stmt : {insert_app_, select_app_}) {
+    sqlite3_reset(stmt);
+    sqlite3_bind_text(stmt, 1, name.data(), static_cast<int>(name.size()),
+                      SQLITE_TRANSIENT);
+  }
+  if (sqlite3_step(insert_app_) != SQLITE_DONE) {
+    return Fail("intern app");
+  }
+  if (sqlite3_step(select_app_) != SQLITE_ROW) {
+    return Fail("look up app");
+  }
+  *id = sqlite3_column_int64(select_app_, 0);
+  sqlite3_reset(select_app_);
+  return true;
+}
+
+bool SqliteUsageStore::Run(sqlite3_stmt* stmt,
+                           std::initializer_list<std::int64_t> values) {
+  sqlite3_reset(stmt);
+  int index = 1;
+  for (const std::int64_t value : values) {
+    sqlite3_bind_int64(stmt, index++, value);
+  }
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    return Fail("write usage");
+  }
+  return true;
+}
+
+}  // namespace ringotrack
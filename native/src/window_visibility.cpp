@@ -0,0 +1,198 @@
+#include "ringotrack/window_visibility.h"
+
+#include <algorithm>
+
+namespace ringotrack {
+
+std::int64_t OcclusionCalculator::VisibleArea(const WindowRect& target,
+                                              const WindowRect* occluders,
+                                              std::size_t count) {
+  const std::int64_t total = target.area();
+  if (total == 0) {
+    return 0;
+  }
+
+  clipped_.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    const WindowRect clipped{std::max(occluders[i].left, target.left),
+                             std::max(occluders[i].top, target.top),
+                             std::min(occluders[i].right, target.right),
+                             std::min(occluders[i].bottom, target.bottom)};
+    if (clipped.empty()) {
+      continue;
+    }
+    if (clipped.area() == total) {
+      return 0;
+    }
+    clipped_.push_back(clipped);
+  }
+  if (clipped_.empty()) {
+    return total;
+  }
+
+  xs_.clear();
+  xs_.push_back(target.left);
+  xs_.push_back(target.right);
+  for (const WindowRect& rect : clipped_) {
+    xs_.push_back(rect.left);
+    xs_.push_back(rect.right);
+  }
+  std::sort(xs_.begin(), xs_.end());
+  xs_.erase(std::unique(xs_.begin(), xs_.end()), xs_.end());
+
+  std::int64_t covered = 0;
+  for (std::size_t i = 0; i + 1 < xs_.size(); ++i) {
+    const std::int32_t x0 = xs_[i];
+    const std::int32_t x1 = xs_[i + 1];
+    intervals_.clear();
+    for (const WindowRect& rect : clipped_) {
+      if (rect.left <= x0 && rect.right >= x1) {
+        intervals_.push_back({rect.top, rect.bottom});
+      }
+    }
+    if (intervals_.empty()) {
+      continue;
+    }
+    std::sort(intervals_.begin(), intervals_.end(),
+              [](const Interval& a, const Interval& b) {
+                return a.begin < b.begin;
+              });
+    std::int64_t length = 0;
+    std::int32_t begin = intervals_[0].begin;
+    std::int32_t end = intervals_[0].end;
+    for (std::size_t k = 1; k < intervals_.size(); ++k) {
+      if (intervals_[k].begin > end) {
+        length += end - begin;
+        begin = intervals_[k].begin;
+        end = intervals_[k].end;
+      } else if (intervals_[k].end > end) {
+        end = intervals_[k].end;
+      }
+    }
+    length += end - begin;
+    covered += length * (x1 - x0);
+  }
+  return total - covered;
+}
+
+std::size_t WindowVisibilityTracker::IndexOf(std::uint64_t handle) const {
+  for (std::size_t i = 0; i < windows_.size(); ++i) {
+    if (windows_[i].handle == handle) {
+      return i;
+    }
+  }
+  return windows_.size();
+}
+
+void WindowVisibilityTracker::Upsert(std::uint64_t handle, AppId app_id,
+                                     const WindowRect& rect, bool shown) {
+  const std::size_t index = IndexOf(handle);
+  if (index == windows_.size()) {
+    windows_.insert(windows_.begin(), Window{handle, app_id, rect, shown});
+    dirty_ = true;
+    return;
+  }
+  if (windows_[index].app_id != app_id) {
+    windows_[index].app_id = app_id;
+    dirty_ = true;
+  }
+  UpdateGeometry(handle, rect, shown);
+}
+
+bool WindowVisibilityTracker::UpdateGeometry(std::uint64_t handle,
+                                             const WindowRect& rect,
+                                             bool shown) {
+  const std::size_t index = IndexOf(handle);
+  if (index == windows_.size()) {
+    return false;
+  }
+  Window& window = windows_[index];
+  if (window.shown == shown && window.rect.left == rect.left &&
+      window.rect.top == rect.top && window.rect.right == rect.right &&
+      window.rect.bottom == rect.bottom) {
+    return true;
+  }
+  window.rect = rect;
+  window.shown = shown;
+  dirty_ = true;
+  return true;
+}
+
+AppId WindowVisibilityTracker::AppOf(std::uint64_t handle) const {
+  const std::size_t index = IndexOf(handle);
+  return index == windows_.size() ? kNoApp : windows_[index].app_id;
+}
+
+void WindowVisibilityTracker::Remove(std::uint64_t handle) {
+  const std::size_t index = IndexOf(handle);
+  if (index == windows_.size()) {
+    return;
+  }
+  windows_.erase(windows_.begin() + static_cast<std::ptrdiff_t>(index));
+  dirty_ = true;
+}
+
+void WindowVisibilityTracker::BringToTop(std::uint64_t handle) {
+  const std::size_t index = IndexOf(handle);
+  if (index == 0 || index == windows_.size()) {
+    return;
+  }
+  std::rotate(windows_.begin(),
+              windows_.begin() + static_cast<std::ptrdiff_t>(index),
+              windows_.begin() + static_cast<std::ptrdiff_t>(index) + 1);
+  dirty_ = true;
+}
+
+void WindowVisibilityTracker::Clear() {
+  windows_.clear();
+  dirty_ = true;
+}
+
+void WindowVisibilityTracker::SetTracked(const TrackedAppSet& tracked,
+                                         bool track_all) {
+  tracked_ = tracked;
+  track_all_ = track_all;
+  dirty_ = true;
+}
+
+const std::vector<VisibleApp>& WindowVisibilityTracker::Compute(
+    AppId exclude_app, std::uint32_t min_permille) {
+  if (!dirty_ && exclude_app == last_exclude_ &&
+      min_permille == last_min_permille_) {
+    return result_;
+  }
+  dirty_ = false;
+  last_exclude_ = exclude_app;
+  last_min_permille_ = min_permille;
+  result_.clear();
+
+  // above_ 依次累积当前窗口之上所有显示中的窗口。
+  above_.clear();
+  for (const Window& window : windows_) {
+    if (!window.shown || window.rect.empty()) {
+      continue;
+    }
+    if (window.app_id != exclude_app && window.app_id != kNoApp &&
+        (track_all_ || tracked_.Contains(window.app_id))) {
+      const std::int64_t visible =
+          calculator_.VisibleArea(window.rect, above_.data(), above_.size());
+      const std::uint32_t permille =
+          static_cast<std::uint32_t>(visible * 1000 / window.rect.area());
+      if (permille >= min_permille && permille > 0) {
+        auto it = std::find_if(result_.begin(), result_.end(),
+                               [&](const VisibleApp& app) {
+                                 return app.app_id == window.app_id;
+                               });
+        if (it == result_.end()) {
+          result_.push_back({window.app_id, permille});
+        } else if (permille > it->visible_permille) {
+          it->visible_permille = permille;
+        }
+      }
+    }
+    above_.push_back(window.rect);
+  }
+  return result_;
+}
+
+}  // namespace ringotrack
@@ -0,0 +1,47 @@
+#include "ringotrack/app_interner.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace ringotrack {
+namespace {
+
+TEST(AppInternerTest, InternIsStable) {
+  AppInterner interner;
+  const AppId ps = interner.Intern("photoshop.exe");
+  const AppId csp = interner.Intern("clipstudiopaint.exe");
+
+  EXPECT_NE(ps, kNoApp);
+  EXPECT_NE(csp, kNoApp);
+  EXPECT_NE(ps, csp);
+  EXPECT_EQ(interner.Intern("photoshop.exe"), ps);
+  EXPECT_EQ(interner.Find("clipstudiopaint.exe"), csp);
+  EXPECT_EQ(interner.Find("sai.exe"), kNoApp);
+  EXPECT_EQ(interner.Name(ps), "photoshop.exe");
+  EXPECT_EQ(interner.Name(kNoApp), "");
+  EXPECT_EQ(interner.size(), 2u);
+}
+
+TEST(AppInternerTest, GrowsPastInitialCapacity) {
+  AppInterner interner;
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_EQ(interner.Intern("app" + std::to_string(i) + ".exe"),
+              static_cast<AppId>(i + 1));
+  }
+  for (int i = 0; i < 5000; ++i) {
+    const std::string name = "app" + std::to_string(i) + ".exe";
+    EXPECT_EQ(interner.Find(name), static_cast<AppId>(i + 1));
+    EXPECT_EQ(interner.Name(static_cast<AppId>(i + 1)), name);
+  }
+}
+
+TEST(AppInternerTest, EmptyNameIsValidKey) {
+  AppInterner interner;
+  const AppId empty = interner.Intern("");
+  EXPECT_NE(empty, kNoApp);
+  EXPECT_EQ(interner.Find(""), empty);
+}
+
+}  // namespace
+}  // namespace ringotrack
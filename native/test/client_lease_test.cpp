@@ -0,0 +1,60 @@
+#include "ringotrack/client_lease.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+TEST(ClientLeaseTest, UninitializedLayoutIsNotReadable) {
+  ClientLeaseLayout layout{};
+  ClientLease lease;
+  EXPECT_FALSE(ReadClientLease(layout, &lease));
+
+  InitializeClientLease(&layout);
+  ASSERT_TRUE(ReadClientLease(layout, &lease));
+  EXPECT_EQ(lease.attached_since_millis, 0);
+  EXPECT_FALSE(lease.IsAlive(1000, 15000));
+}
+
+TEST(ClientLeaseTest, AttachReportDetachRoundTrip) {
+  ClientLeaseLayout layout{};
+  InitializeClientLease(&layout);
+  ClientLeaseWriter writer(&layout);
+
+  writer.Attach(1000, 1000);
+  ClientLease lease;
+  ASSERT_TRUE(ReadClientLease(layout, &lease));
+  EXPECT_EQ(lease.attached_since_millis, 1000);
+  EXPECT_EQ(lease.persisted_until_millis, 1000);
+  EXPECT_TRUE(lease.IsAlive(2000, 15000));
+
+  writer.Report(6000, 6500);
+  // 落库截止时刻不会回退。
+  writer.Report(4000, 7000);
+  ASSERT_TRUE(ReadClientLease(layout, &lease));
+  EXPECT_EQ(lease.persisted_until_millis, 6000);
+  EXPECT_EQ(lease.heartbeat_millis, 7000);
+  EXPECT_TRUE(lease.IsAlive(21999, 15000));
+  EXPECT_FALSE(lease.IsAlive(22000, 15000));
+
+  writer.Detach();
+  ASSERT_TRUE(ReadClientLease(layout, &lease));
+  EXPECT_EQ(lease.attached_since_millis, 1000);
+  EXPECT_EQ(lease.persisted_until_millis, 6000);
+  EXPECT_FALSE(lease.IsAlive(7000, 15000));
+}
+
+TEST(ClientLeaseTest, ReinitializingKeepsExistingLease) {
+  ClientLeaseLayout layout{};
+  InitializeClientLease(&layout);
+  ClientLeaseWriter(&layout).Attach(1000, 1000);
+
+  // 守护进程后打开同一个段时不能清掉客户端已写入的租约。
+  InitializeClientLease(&layout);
+  ClientLease lease;
+  ASSERT_TRUE(ReadClientLease(layout, &lease));
+  EXPECT_EQ(lease.attached_since_millis, 1000);
+}
+
+}  // namespace
+}  // namespace ringotrack
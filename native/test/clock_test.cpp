@@ -0,0 +1,68 @@
+#include "ringotrack/clock.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+TEST(ClockTest, FileTimeTicksToUnixMillis) {
+  EXPECT_EQ(FileTimeTicksToUnixMillis(0), 0u);
+  EXPECT_EQ(FileTimeTicksToUnixMillis(kFileTimeUnixEpochDifference), 0u);
+  EXPECT_EQ(FileTimeTicksToUnixMillis(kFileTimeUnixEpochDifference + 15000),
+            1u);
+  // 2025-01-01T00:00:00Z
+  EXPECT_EQ(FileTimeTicksToUnixMillis(133801632000000000ULL),
+            1735689600000ULL);
+}
+
+TEST(ClockTest, CivilRoundTrip) {
+  EXPECT_EQ(DayNumberFromCivil(1970, 1, 1), 0);
+  EXPECT_EQ(DayNumberFromCivil(2000, 3, 1), 11017);
+  EXPECT_EQ(DayNumberFromCivil(1969, 12, 31), -1);
+
+  for (std::int32_t day = -1000; day < 30000; day += 7) {
+    std::int32_t y;
+    std::uint32_t m;
+    std::uint32_t d;
+    CivilFromDayNumber(day, &y, &m, &d);
+    EXPECT_EQ(DayNumberFromCivil(y, m, d), day);
+  }
+}
+
+TEST(ClockTest, LocalHourAtHonorsOffset) {
+  // 东八区：UTC 2025-01-01 15:30 即本地 2025-01-01 23:30。
+  const ManualClock clock(0, 8 * kMillisPerHour);
+  const std::int64_t utc = 1735689600000LL + 15 * kMillisPerHour +
+                           30 * kMillisPerMinute;
+
+  const LocalHour local = LocalHourAt(clock, utc);
+  EXPECT_EQ(local.day, DayNumberFromCivil(2025, 1, 1));
+  EXPECT_EQ(local.hour, 23);
+  EXPECT_EQ(local.end_unix_millis, utc + 30 * kMillisPerMinute);
+
+  const LocalHour next = LocalHourAt(clock, local.end_unix_millis);
+  EXPECT_EQ(next.day, DayNumberFromCivil(2025, 1, 2));
+  EXPECT_EQ(next.hour, 0);
+}
+
+TEST(ClockTest, LocalHourAtBeforeEpoch) {
+  const ManualClock clock(0, -5 * kMillisPerHour);
+  const LocalHour local = LocalHourAt(clock, 0);
+  EXPECT_EQ(local.day, -1);
+  EXPECT_EQ(local.hour, 19);
+  EXPECT_EQ(local.end_unix_millis, kMillisPerHour);
+}
+
+TEST(ClockTest, SystemClockIsSane) {
+  const SystemClock clock;
+  const std::int64_t now = clock.NowUnixMillis();
+  EXPECT_GT(now, 1700000000000LL);
+
+  const std::int64_t offset = clock.LocalOffsetMillis(now);
+  EXPECT_GE(offset, -14 * kMillisPerHour);
+  EXPECT_LE(offset, 14 * kMillisPerHour);
+  EXPECT_EQ(clock.LocalOffsetMillis(now), offset);
+}
+
+}  // namespace
+}  // namespace ringotrack
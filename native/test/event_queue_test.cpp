@@ -0,0 +1,70 @@
+#include "ringotrack/event_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace ringotrack {
+namespace {
+
+TEST(SpscQueueTest, PushPopInOrder) {
+  SpscQueue<int, 4> queue;
+  int value = 0;
+  EXPECT_FALSE(queue.TryPop(&value));
+
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_TRUE(queue.TryPush(3));
+  EXPECT_TRUE(queue.TryPush(4));
+  EXPECT_FALSE(queue.TryPush(5));
+  EXPECT_EQ(queue.SizeApprox(), 4u);
+
+  for (int expected = 1; expected <= 4; ++expected) {
+    ASSERT_TRUE(queue.TryPop(&value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST(SpscQueueTest, PopBatchWrapsAround) {
+  SpscQueue<int, 8> queue;
+  int out[8];
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      ASSERT_TRUE(queue.TryPush(round * 10 + i));
+    }
+    ASSERT_EQ(queue.PopBatch(out, 3), 3u);
+    EXPECT_EQ(out[0], round * 10);
+    ASSERT_EQ(queue.PopBatch(out, 8), 2u);
+    EXPECT_EQ(out[1], round * 10 + 4);
+  }
+}
+
+TEST(SpscQueueTest, ConcurrentProducerConsumer) {
+  SpscQueue<TrackerEvent, 256> queue;
+  constexpr std::int64_t kCount = 200000;
+
+  std::thread producer([&queue] {
+    for (std::int64_t i = 0; i < kCount; ++i) {
+      const TrackerEvent event{i, TrackerEventKind::kPointerDown,
+                               static_cast<std::uint32_t>(i)};
+      while (!queue.TryPush(event)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::int64_t expected = 0;
+  TrackerEvent event{};
+  while (expected < kCount) {
+    if (queue.TryPop(&event)) {
+      ASSERT_EQ(event.timestamp_millis, expected);
+      ASSERT_EQ(event.app_id, static_cast<std::uint32_t>(expected));
+      ++expected;
+    }
+  }
+  producer.join();
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,103 @@
+#include "ringotrack/hit_test_regions.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+TEST(HitTestRegionsTest, DefaultCornersMatchLegacySafeRegions) {
+  HitTestRegions regions;
+  regions.SetClientSize(360, 220);
+  EXPECT_EQ(regions.size(), 2u);
+
+  // 右上角 80x80（含边界）。
+  EXPECT_TRUE(regions.IsInteractive(280, 0));
+  EXPECT_TRUE(regions.IsInteractive(360, 80));
+  EXPECT_FALSE(regions.IsInteractive(279, 0));
+  EXPECT_FALSE(regions.IsInteractive(300, 81));
+  // 右下角。
+  EXPECT_TRUE(regions.IsInteractive(300, 140));
+  EXPECT_TRUE(regions.IsInteractive(360, 220));
+  EXPECT_FALSE(regions.IsInteractive(300, 139));
+  // 中间与左侧可拖动。
+  EXPECT_FALSE(regions.IsInteractive(180, 110));
+  EXPECT_FALSE(regions.IsInteractive(0, 0));
+}
+
+TEST(HitTestRegionsTest, ScaleAndResizeRecomputeRects) {
+  HitTestRegions regions;
+  regions.SetScale(1.5);
+  regions.SetClientSize(540, 330);
+
+  // 80 DIP * 1.5 = 120 px。
+  EXPECT_TRUE(regions.IsInteractive(420, 120));
+  EXPECT_FALSE(regions.IsInteractive(419, 0));
+
+  // 尺寸变化后右侧锚定的区域跟着移动。
+  regions.SetClientSize(600, 330);
+  EXPECT_FALSE(regions.IsInteractive(420, 0));
+  EXPECT_TRUE(regions.IsInteractive(480, 0));
+
+  regions.SetScale(0);
+  EXPECT_DOUBLE_EQ(regions.scale(), 1.0);
+  EXPECT_TRUE(regions.IsInteractive(520, 0));
+  EXPECT_FALSE(regions.IsInteractive(519, 0));
+}
+
+TEST(HitTestRegionsTest, CustomRegionsUseAnchorsAndOffsets) {
+  HitTestRegions regions;
+  regions.SetScale(2.0);
+  regions.SetClientSize(400, 200);
+
+  const InteractiveRegion custom[] = {
+      {RegionAnchor::kTopLeft, 10, 5, 20, 10},
+      {RegionAnchor::kBottomRight, 4, 4, 8, 8},
+  };
+  ASSERT_TRUE(regions.SetRegions(custom, 2));
+
+  // 左上：x 20..60，y 10..30。
+  EXPECT_TRUE(regions.IsInteractive(20, 10));
+  EXPECT_TRUE(regions.IsInteractive(60, 30));
+  EXPECT_FALSE(regions.IsInteractive(19, 10));
+  EXPECT_FALSE(regions.IsInteractive(61, 30));
+  // 右下：右边 400-8=392，左边 376；底边 192，顶边 176。
+  EXPECT_TRUE(regions.IsInteractive(376, 176));
+  EXPECT_TRUE(regions.IsInteractive(392, 192));
+  EXPECT_FALSE(regions.IsInteractive(393, 192));
+  // 默认角落已被替换。
+  EXPECT_FALSE(regions.IsInteractive(400, 0));
+}
+
+TEST(HitTestRegionsTest, InvalidRegionsAreRejectedAtomically) {
+  HitTestRegions regions;
+  regions.SetClientSize(360, 220);
+
+  const InteractiveRegion bad[] = {
+      {RegionAnchor::kTopLeft, 0, 0, 10, 10},
+      {RegionAnchor::kTopLeft, 0, 0, 0, 10},
+  };
+  EXPECT_FALSE(regions.SetRegions(bad, 2));
+  EXPECT_FALSE(regions.SetRegions(bad, HitTestRegions::kMaxRegions + 1));
+  EXPECT_FALSE(regions.SetRegions(nullptr, 1));
+  EXPECT_EQ(regions.size(), 2u);
+  EXPECT_TRUE(regions.IsInteractive(360, 0));
+
+  // 空表：整个客户区都可拖动。
+  EXPECT_TRUE(regions.SetRegions(nullptr, 0));
+  EXPECT_FALSE(regions.IsInteractive(360, 0));
+
+  regions.ResetToDefaults();
+  EXPECT_TRUE(regions.IsInteractive(360, 0));
+}
+
+TEST(HitTestRegionsTest, InClientCoversBoundary) {
+  HitTestRegions regions;
+  regions.SetClientSize(100, 50);
+  EXPECT_TRUE(regions.InClient(0, 0));
+  EXPECT_TRUE(regions.InClient(100, 50));
+  EXPECT_FALSE(regions.InClient(-1, 10));
+  EXPECT_FALSE(regions.InClient(10, 51));
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,112 @@
+#include "ringotrack/hourly_aggregator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace ringotrack {
+namespace {
+
+// 2025-01-01T00:00:00Z，测试中统一使用 UTC 作为本地时区。
+constexpr std::int64_t kDayStart = 1735689600000LL;
+const std::int32_t kDay = DayNumberFromCivil(2025, 1, 1);
+
+std::int64_t At(std::int32_t hour, std::int32_t minute) {
+  return kDayStart + hour * kMillisPerHour + minute * kMillisPerMinute;
+}
+
+TEST(HourlyAggregatorTest, SplitsAcrossHourBoundaries) {
+  const ManualClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+
+  aggregator.OnForegroundChanged(1, At(9, 30));
+  aggregator.OnForegroundChanged(2, At(11, 15));
+
+  std::vector<UsageBucket> out;
+  ASSERT_EQ(aggregator.Drain(&out), 3u);
+  EXPECT_EQ(out[0].day, kDay);
+  EXPECT_EQ(out[0].hour, 9);
+  EXPECT_EQ(out[0].millis, 30 * kMillisPerMinute);
+  EXPECT_EQ(out[1].hour, 10);
+  EXPECT_EQ(out[1].millis, kMillisPerHour);
+  EXPECT_EQ(out[2].hour, 11);
+  EXPECT_EQ(out[2].millis, 15 * kMillisPerMinute);
+  EXPECT_FALSE(aggregator.has_pending());
+}
+
+TEST(HourlyAggregatorTest, SplitsAcrossMidnight) {
+  const ManualClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+
+  aggregator.OnForegroundChanged(1, At(23, 50));
+  aggregator.CloseAt(At(24, 10));
+
+  std::vector<UsageBucket> out;
+  ASSERT_EQ(aggregator.Drain(&out), 2u);
+  EXPECT_EQ(out[0].day, kDay);
+  EXPECT_EQ(out[0].hour, 23);
+  EXPECT_EQ(out[1].day, kDay + 1);
+  EXPECT_EQ(out[1].hour, 0);
+  EXPECT_EQ(out[1].millis, 10 * kMillisPerMinute);
+  EXPECT_EQ(aggregator.current_app(), kNoApp);
+}
+
+TEST(HourlyAggregatorTest, MergesRepeatedTicksIntoOneBucket) {
+  const ManualClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+
+  for (int second = 0; second <= 60; ++second) {
+    aggregator.OnForegroundChanged(7, At(10, 0) + second * kMillisPerSecond);
+  }
+
+  std::vector<UsageBucket> out;
+  ASSERT_EQ(aggregator.Drain(&out), 1u);
+  EXPECT_EQ(out[0].app_id, 7u);
+  EXPECT_EQ(out[0].millis, kMillisPerMinute);
+}
+
+TEST(HourlyAggregatorTest, SkipsUntrackedAndNoApp) {
+  const ManualClock clock;
+  TrackedAppSet tracked;
+  tracked.Add(1);
+  HourlyAggregator aggregator(&clock, &tracked);
+
+  aggregator.OnForegroundChanged(2, At(9, 0));
+  aggregator.OnForegroundChanged(kNoApp, At(9, 10));
+  aggregator.OnForegroundChanged(1, At(9, 20));
+  aggregator.OnForegroundChanged(2, At(9, 25));
+
+  std::vector<UsageBucket> out;
+  ASSERT_EQ(aggregator.Drain(&out), 1u);
+  EXPECT_EQ(out[0].app_id, 1u);
+  EXPECT_EQ(out[0].millis, 5 * kMillisPerMinute);
+}
+
+TEST(HourlyAggregatorTest, IgnoresNonPositiveIntervals) {
+  const ManualClock clock;
+  HourlyAggregator aggregator(&clock, nullptr);
+
+  aggregator.OnForegroundChanged(1, At(9, 30));
+  aggregator.OnForegroundChanged(1, At(9, 20));
+
+  std::vector<UsageBucket> out;
+  EXPECT_EQ(aggregator.Drain(&out), 0u);
+}
+
+TEST(HourlyAggregatorTest, UsesLocalOffset) {
+  // 东八区本地 00:30 对应 UTC 前一天 16:30。
+  const ManualClock clock(0, 8 * kMillisPerHour);
+  HourlyAggregator aggregator(&clock, nullptr);
+
+  aggregator.OnForegroundChanged(1, kDayStart - 8 * kMillisPerHour +
+                                        30 * kMillisPerMinute);
+  aggregator.CloseAt(kDayStart - 8 * kMillisPerHour + 45 * kMillisPerMinute);
+
+  std::vector<UsageBucket> out;
+  ASSERT_EQ(aggregator.Drain(&out), 1u);
+  EXPECT_EQ(out[0].day, kDay);
+  EXPECT_EQ(out[0].hour, 0);
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,110 @@
+#include "ringotrack/idle_state.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kThreshold = 60000;
+
+TEST(IdleStateMachineTest, EntersIdleAfterThreshold) {
+  IdleStateMachine idle(kThreshold, 0);
+  EXPECT_EQ(idle.OnTick(59999), IdleTransition::kNone);
+  EXPECT_EQ(idle.OnTick(60000), IdleTransition::kEnterIdle);
+  EXPECT_TRUE(idle.is_idle());
+  EXPECT_EQ(idle.OnTick(61000), IdleTransition::kNone);
+}
+
+TEST(IdleStateMachineTest, PointerDownLeavesIdleImmediately) {
+  IdleStateMachine idle(kThreshold, 0);
+  ASSERT_EQ(idle.OnTick(70000), IdleTransition::kEnterIdle);
+
+  // 抬笔不会让 Idle 恢复，只有按下才会。
+  EXPECT_EQ(idle.OnPointer(71000, false), IdleTransition::kNone);
+  EXPECT_TRUE(idle.is_idle());
+  EXPECT_EQ(idle.OnPointer(72000, true), IdleTransition::kLeaveIdle);
+  EXPECT_FALSE(idle.is_idle());
+}
+
+TEST(IdleStateMachineTest, HeldPointerKeepsActive) {
+  IdleStateMachine idle(kThreshold, 0);
+  idle.OnPointer(1000, true);
+  for (std::int64_t t = 2000; t < 10 * kThreshold; t += 1000) {
+    ASSERT_EQ(idle.OnTick(t), IdleTransition::kNone);
+  }
+  EXPECT_FALSE(idle.is_idle());
+}
+
+TEST(IdleStateMachineTest, TickLeavesIdleAfterRecentRelease) {
+  IdleStateMachine idle(kThreshold, 0);
+  ASSERT_EQ(idle.OnTick(60000), IdleTransition::kEnterIdle);
+  idle.OnPointer(60500, false);
+  EXPECT_EQ(idle.OnTick(61000), IdleTransition::kLeaveIdle);
+}
+
+// 合成轨迹：只有键盘活动，按给定间隔按键，返回期间进入 Idle 的次数。
+int CountIdleEntriesForKeyTrace(IdleStateMachine* idle, std::int64_t interval,
+                                std::int64_t duration) {
+  int entries = 0;
+  std::int64_t next_key = 0;
+  for (std::int64_t t = 0; t <= duration; t += 1000) {
+    if (t >= next_key) {
+      idle->OnActivity(ActivitySource::kKeyboard, t);
+      next_key += interval;
+    }
+    if (idle->OnTick(t) == IdleTransition::kEnterIdle) {
+      ++entries;
+    }
+  }
+  return entries;
+}
+
+TEST(IdleStateMachineTest, FrequentShortcutsKeepActive) {
+  IdleStateMachine idle(kThreshold, 0);
+  // 默认权重 0.5：键盘活动窗口 30 秒，每 20 秒一次快捷键足以保持活跃。
+  EXPECT_EQ(CountIdleEntriesForKeyTrace(&idle, 20000, 10 * kThreshold), 0);
+  EXPECT_FALSE(idle.is_idle());
+}
+
+TEST(IdleStateMachineTest, SparseShortcutsCountLessThanStrokes) {
+  IdleStateMachine keyboard(kThreshold, 0);
+  // 每 40 秒一次按键超出键盘窗口，每个间隔都会短暂进入 Idle。
+  EXPECT_GT(CountIdleEntriesForKeyTrace(&keyboard, 40000, 10 * kThreshold), 0);
+
+  IdleStateMachine full_weight(kThreshold, 0);
+  full_weight.SetWeight(ActivitySource::kKeyboard, 1.0);
+  EXPECT_EQ(
+      CountIdleEntriesForKeyTrace(&full_weight, 40000, 10 * kThreshold), 0);
+}
+
+TEST(IdleStateMachineTest, KeyboardLeavesIdleImmediately) {
+  IdleStateMachine idle(kThreshold, 0);
+  ASSERT_EQ(idle.OnTick(60000), IdleTransition::kEnterIdle);
+  EXPECT_EQ(idle.OnActivity(ActivitySource::kKeyboard, 90000),
+            IdleTransition::kLeaveIdle);
+  EXPECT_EQ(idle.active_until_millis(), 90000 + kThreshold / 2);
+  EXPECT_EQ(idle.OnTick(119999), IdleTransition::kNone);
+  EXPECT_EQ(idle.OnTick(120000), IdleTransition::kEnterIdle);
+}
+
+TEST(IdleStateMachineTest, ZeroWeightIgnoresSource) {
+  IdleStateMachine idle(kThreshold, 0);
+  idle.SetWeight(ActivitySource::kKeyboard, 0);
+  ASSERT_EQ(idle.OnTick(60000), IdleTransition::kEnterIdle);
+  EXPECT_EQ(idle.OnActivity(ActivitySource::kKeyboard, 61000),
+            IdleTransition::kNone);
+  EXPECT_TRUE(idle.is_idle());
+}
+
+TEST(IdleStateMachineTest, KeyboardNeverShortensStrokeWindow) {
+  IdleStateMachine idle(kThreshold, 0);
+  idle.OnPointer(10000, false);
+  // 之后的按键窗口（35000 + 30000）早于落笔窗口（10000 + 60000）时不缩短。
+  idle.OnActivity(ActivitySource::kKeyboard, 35000);
+  EXPECT_EQ(idle.active_until_millis(), 70000);
+  EXPECT_EQ(idle.OnTick(69999), IdleTransition::kNone);
+  EXPECT_EQ(idle.OnTick(70000), IdleTransition::kEnterIdle);
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,169 @@
+#include "ringotrack/live_status.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace ringotrack {
+namespace {
+
+std::string UniqueSegmentName(const char* tag) {
+#ifdef _WIN32
+  const long pid = 0;
+#else
+  const long pid = static_cast<long>(::getpid());
+#endif
+  return std::string("ringotrack.test.") + tag + "." + std::to_string(pid);
+}
+
+LiveStatus MakeStatus(std::int64_t i) {
+  LiveStatus status;
+  status.updated_at_millis = 1000 + i;
+  status.session_start_millis = -i;
+  status.today_total_millis = i * 7;
+  status.app_id = static_cast<std::uint32_t>(i % 50);
+  status.is_idle = (i & 1) != 0;
+  status.is_tracking = (i & 2) != 0;
+  std::snprintf(status.app_name, sizeof(status.app_name), "app%lld.exe",
+                static_cast<long long>(i));
+  return status;
+}
+
+// 读到的快照必须来自同一次 Publish。
+void ExpectConsistent(const LiveStatus& status) {
+  const std::int64_t i = status.updated_at_millis - 1000;
+  ASSERT_EQ(status.session_start_millis, -i);
+  ASSERT_EQ(status.today_total_millis, i * 7);
+  ASSERT_EQ(status.app_id, static_cast<std::uint32_t>(i % 50));
+  ASSERT_EQ(status.is_idle, (i & 1) != 0);
+  ASSERT_EQ(status.is_tracking, (i & 2) != 0);
+  ASSERT_EQ(std::string(status.app_name),
+            "app" + std::to_string(i) + ".exe");
+}
+
+TEST(LiveStatusTest, PublishAndReadRoundTrip) {
+  LiveStatusLayout layout{};
+  LiveStatusWriter writer(&layout);
+  LiveStatusReader reader(&layout);
+
+  LiveStatus out;
+  EXPECT_FALSE(reader.Read(&out));  // 未初始化的段
+
+  writer.Initialize();
+  ASSERT_TRUE(reader.Read(&out));
+  EXPECT_EQ(out.app_id, 0u);
+  EXPECT_STREQ(out.app_name, "");
+
+  writer.Publish(MakeStatus(42));
+  ASSERT_TRUE(reader.Read(&out));
+  ExpectConsistent(out);
+  EXPECT_EQ(layout.sequence.load() % 2, 0u);
+}
+
+TEST(LiveStatusTest, LongAppNameIsTruncated) {
+  LiveStatusLayout layout{};
+  LiveStatusWriter writer(&layout);
+  writer.Initialize();
+
+  LiveStatus status;
+  std::memset(status.app_name, 'x', sizeof(status.app_name));
+  writer.Publish(status);
+
+  LiveStatus out;
+  ASSERT_TRUE(LiveStatusReader(&layout).Read(&out));
+  EXPECT_EQ(std::strlen(out.app_name), kLiveStatusAppNameBytes - 1);
+}
+
+TEST(LiveStatusTest, ConcurrentReadersNeverSeeTornSnapshots) {
+  LiveStatusLayout layout{};
+  LiveStatusWriter writer(&layout);
+  writer.Initialize();
+  writer.Publish(MakeStatus(0));
+
+  constexpr std::int64_t kWrites = 200000;
+  constexpr int kReaders = 4;
+  std::atomic<bool> done{false};
+  std::atomic<std::int64_t> total_reads{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < kReaders; ++r) {
+    readers.emplace_back([&] {
+      const LiveStatusReader reader(&layout);
+      std::int64_t last_seen = 0;
+      std::int64_t reads = 0;
+      LiveStatus out;
+      while (!done.load(std::memory_order_acquire)) {
+        if (!reader.Read(&out)) {
+          continue;
+        }
+        ExpectConsistent(out);
+        // 单写者顺序发布，读者看到的版本只会前进。
+        ASSERT_GE(out.updated_at_millis, last_seen);
+        last_seen = out.updated_at_millis;
+        ++reads;
+      }
+      total_reads.fetch_add(reads);
+    });
+  }
+
+  for (std::int64_t i = 1; i <= kWrites; ++i) {
+    writer.Publish(MakeStatus(i));
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& t : readers) {
+    t.join();
+  }
+
+  EXPECT_GT(total_reads.load(), 0);
+  LiveStatus out;
+  ASSERT_TRUE(LiveStatusReader(&layout).Read(&out));
+  EXPECT_EQ(out.updated_at_millis, 1000 + kWrites);
+}
+
+TEST(LiveStatusTest, SharedMemorySegmentIsVisibleToSeparateMapping) {
+  const std::string name = UniqueSegmentName("live");
+  SharedMemory::Unlink(name);
+
+  EXPECT_EQ(LiveStatusSubscriber::Open(name), nullptr);
+
+  std::unique_ptr<LiveStatusPublisher> publisher =
+      LiveStatusPublisher::Create(name);
+  ASSERT_NE(publisher, nullptr);
+  std::unique_ptr<LiveStatusSubscriber> subscriber =
+      LiveStatusSubscriber::Open(name);
+  ASSERT_NE(subscriber, nullptr);
+
+  publisher->Publish(MakeStatus(7));
+  LiveStatus out;
+  ASSERT_TRUE(subscriber->Read(&out));
+  ExpectConsistent(out);
+
+  // 写者线程持续发布时，另一映射上的读者仍只看到完整快照。
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (std::int64_t i = 8; i < 50000; ++i) {
+      publisher->Publish(MakeStatus(i));
+    }
+    done.store(true);
+  });
+  while (!done.load()) {
+    if (subscriber->Read(&out)) {
+      ExpectConsistent(out);
+    }
+  }
+  writer.join();
+
+  SharedMemory::Unlink(name);
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,124 @@
+#include "ringotrack/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ringotrack {
+namespace {
+
+TEST(LatencyHistogramTest, BucketsAreMonotonicAndContainTheirBounds) {
+  std::size_t previous = 0;
+  for (std::uint64_t v = 0; v < 100000; ++v) {
+    const std::size_t index = LatencyHistogram::BucketIndex(v);
+    ASSERT_GE(index, previous);
+    ASSERT_LE(LatencyHistogram::BucketLowerBound(index), v);
+    ASSERT_GT(LatencyHistogram::BucketLowerBound(index + 1), v);
+    previous = index;
+  }
+  for (std::size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+    EXPECT_EQ(
+        LatencyHistogram::BucketIndex(LatencyHistogram::BucketLowerBound(i)),
+        i);
+  }
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX),
+            LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, RelativeErrorIsBounded) {
+  for (std::uint64_t v = 8; v < (std::uint64_t{1} << 40); v = v * 3 + 1) {
+    const std::size_t index = LatencyHistogram::BucketIndex(v);
+    const std::uint64_t lower = LatencyHistogram::BucketLowerBound(index);
+    const std::uint64_t upper = LatencyHistogram::BucketLowerBound(index + 1);
+    EXPECT_LE(static_cast<double>(upper - lower) / static_cast<double>(lower),
+              0.125)
+        << v;
+  }
+}
+
+TEST(LatencyHistogramTest, SnapshotAndQuantiles) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+  for (std::uint64_t v = 1; v <= 1000; ++v) {
+    histogram->Record(v * 1000);
+  }
+
+  auto snapshot = std::make_unique<HistogramSnapshot>();
+  histogram->Snapshot(snapshot.get());
+  EXPECT_EQ(snapshot->count, 1000u);
+  EXPECT_EQ(snapshot->sum, 500500u * 1000u);
+  EXPECT_EQ(snapshot->max, 1000000u);
+
+  const std::uint64_t p50 = ValueAtQuantile(*snapshot, 0.5);
+  EXPECT_GE(p50, 500000u);
+  EXPECT_LE(p50, 500000u * 9 / 8);
+  const std::uint64_t p99 = ValueAtQuantile(*snapshot, 0.99);
+  EXPECT_GE(p99, 990000u);
+  EXPECT_LE(p99, 1000000u);
+  EXPECT_EQ(ValueAtQuantile(*snapshot, 1.0), 1000000u);
+
+  histogram->Reset();
+  histogram->Snapshot(snapshot.get());
+  EXPECT_EQ(snapshot->count, 0u);
+  EXPECT_EQ(ValueAtQuantile(*snapshot, 0.5), 0u);
+}
+
+TEST(MetricsRegistryTest, ConcurrentRecordingIsLossless) {
+  auto registry = std::make_unique<MetricsRegistry>();
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 20000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&registry, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        registry->counter(CounterId::kMouseHookEvents).Increment();
+        registry->histogram(HistogramId::kMouseHook)
+            .Record(static_cast<std::uint64_t>(t * kPerThread + i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto snapshot = std::make_unique<MetricsSnapshot>();
+  registry->Snapshot(snapshot.get());
+  EXPECT_EQ(snapshot->version, kMetricsSnapshotVersion);
+  EXPECT_EQ(snapshot->counter_count, kCounterCount);
+  EXPECT_EQ(snapshot->histogram_count, kHistogramCount);
+  EXPECT_EQ(snapshot->bucket_count, LatencyHistogram::kBucketCount);
+
+  constexpr std::uint64_t kTotal = kThreads * kPerThread;
+  EXPECT_EQ(
+      snapshot->counters[static_cast<std::size_t>(CounterId::kMouseHookEvents)],
+      kTotal);
+  const HistogramSnapshot& hook =
+      snapshot->histograms[static_cast<std::size_t>(HistogramId::kMouseHook)];
+  EXPECT_EQ(hook.count, kTotal);
+  EXPECT_EQ(hook.max, kTotal - 1);
+  std::uint64_t bucketed = 0;
+  for (std::uint64_t n : hook.buckets) {
+    bucketed += n;
+  }
+  EXPECT_EQ(bucketed, kTotal);
+
+  registry->Reset();
+  registry->Snapshot(snapshot.get());
+  EXPECT_EQ(
+      snapshot->counters[static_cast<std::size_t>(CounterId::kMouseHookEvents)],
+      0u);
+}
+
+TEST(ScopedLatencyTest, RecordsOneSample) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+  { ScopedLatency scope(*histogram); }
+  auto snapshot = std::make_unique<HistogramSnapshot>();
+  histogram->Snapshot(snapshot.get());
+  EXPECT_EQ(snapshot->count, 1u);
+}
+
+}  // namespace
+}  // namespace ringotrack
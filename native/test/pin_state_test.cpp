@@ -0,0 +1,51 @@
+#include "ringotrack/pin_state.h"
+#include "ringotrack/stroke_state.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+TEST(PinStateTest, LockRequiresPinned) {
+  PinState state;
+  EXPECT_FALSE(state.Lock());
+  EXPECT_FALSE(state.Unlock());
+
+  state.MarkPinned();
+  EXPECT_TRUE(state.Lock());
+  EXPECT_TRUE(state.is_locked());
+  EXPECT_TRUE(state.Lock());
+  EXPECT_TRUE(state.Unlock());
+  EXPECT_FALSE(state.is_locked());
+}
+
+TEST(PinStateTest, UnpinClearsLock) {
+  PinState state;
+  state.MarkPinned();
+  ASSERT_TRUE(state.Lock());
+  state.MarkUnpinned();
+  EXPECT_FALSE(state.is_pinned());
+  EXPECT_FALSE(state.is_locked());
+}
+
+TEST(PinStateTest, AccentGradientColorIsAbgr) {
+  static_assert(PackAccentGradientColor(0x11, 0x22, 0x33, 0x99) == 0x99332211u,
+                "ABGR packing");
+  EXPECT_EQ(PackAccentGradientColor(255, 255, 255, 0xC0), 0xC0FFFFFFu);
+}
+
+TEST(StrokeStateTest, RecordsButtonEdges) {
+  StrokeState state;
+  state.Reset(100);
+  EXPECT_EQ(state.last_stroke_millis(), 100u);
+  EXPECT_FALSE(state.button_down());
+
+  state.OnButton(true, 200);
+  EXPECT_TRUE(state.button_down());
+  state.OnButton(false, 300);
+  EXPECT_FALSE(state.button_down());
+  EXPECT_EQ(state.last_stroke_millis(), 300u);
+}
+
+}  // namespace
+}  // namespace ringotrack
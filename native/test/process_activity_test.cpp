@@ -0,0 +1,192 @@
+#include "ringotrack/process_activity.h"
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include "ringotrack/metrics.h"
+#endif
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kInterval = 2000;
+
+// 以固定间隔喂入 CPU 占用（千分比），返回每次的状态转换。
+class SyntheticProcess {
+ public:
+  explicit SyntheticProcess(BusyClassifier* classifier)
+      : classifier_(classifier) {
+    classifier_->OnSample(now_, cpu_);
+  }
+
+  BusyTransition Run(std::int64_t permille) {
+    now_ += kInterval;
+    cpu_ += permille * kInterval;
+    return classifier_->OnSample(now_, cpu_);
+  }
+
+  void Jump(std::int64_t millis) { now_ += millis; }
+
+  std::int64_t now() const { return now_; }
+
+ private:
+  BusyClassifier* classifier_;
+  std::int64_t now_ = 1735689600000LL;
+  std::int64_t cpu_ = 5000000;
+};
+
+TEST(BusyClassifierTest, EntersBusyAtStartOfSustainedLoad) {
+  BusyClassifier classifier;
+  SyntheticProcess process(&classifier);
+  EXPECT_EQ(process.Run(20), BusyTransition::kNone);
+  const std::int64_t load_start = process.now();
+  EXPECT_EQ(process.Run(800), BusyTransition::kNone);
+  EXPECT_FALSE(classifier.is_busy());
+  EXPECT_EQ(process.Run(900), BusyTransition::kEnterBusy);
+  EXPECT_TRUE(classifier.is_busy());
+  EXPECT_EQ(classifier.changed_at_millis(), load_start);
+  EXPECT_EQ(classifier.last_permille(), 900u);
+}
+
+TEST(BusyClassifierTest, LeavesBusyAtStartOfSustainedQuiet) {
+  BusyClassifier classifier;
+  SyntheticProcess process(&classifier);
+  process.Run(1000);
+  ASSERT_EQ(process.Run(1000), BusyTransition::kEnterBusy);
+
+  // 多核渲染超过 1000‰ 同样是忙碌。
+  EXPECT_EQ(process.Run(3500), BusyTransition::kNone);
+  const std::int64_t quiet_start = process.now();
+  EXPECT_EQ(process.Run(10), BusyTransition::kNone);
+  EXPECT_TRUE(classifier.is_busy());
+  EXPECT_EQ(process.Run(0), BusyTransition::kLeaveBusy);
+  EXPECT_EQ(classifier.changed_at_millis(), quiet_start);
+}
+
+TEST(BusyClassifierTest, IsolatedSpikesAreIgnored) {
+  BusyClassifier classifier;
+  SyntheticProcess process(&classifier);
+  // 自动保存、缩略图刷新：单个采样的尖峰。
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_EQ(process.Run(i % 2 == 0 ? 950 : 30), BusyTransition::kNone);
+  }
+  EXPECT_FALSE(classifier.is_busy());
+}
+
+TEST(BusyClassifierTest, LongGapRebuildsBaseline) {
+  BusyClassifier classifier;
+  SyntheticProcess process(&classifier);
+  process.Run(900);
+  // 休眠两小时后的第一个采样只建立基线，之前的连续计数作废。
+  process.Jump(2 * 60 * 60 * 1000);
+  EXPECT_EQ(process.Run(900), BusyTransition::kNone);
+  EXPECT_FALSE(classifier.is_busy());
+  EXPECT_EQ(process.Run(900), BusyTransition::kNone);
+  EXPECT_EQ(process.Run(900), BusyTransition::kEnterBusy);
+}
+
+TEST(BusyClassifierTest, ResetEndsBusyForNewProcess) {
+  BusyClassifierConfig config;
+  config.busy_permille = 500;
+  config.enter_samples = 1;
+  BusyClassifier classifier(config);
+  SyntheticProcess process(&classifier);
+  EXPECT_EQ(process.Run(400), BusyTransition::kNone);
+  ASSERT_EQ(process.Run(600), BusyTransition::kEnterBusy);
+
+  EXPECT_EQ(classifier.Reset(process.now() + 500), BusyTransition::kLeaveBusy);
+  EXPECT_EQ(classifier.changed_at_millis(), process.now() + 500);
+  EXPECT_EQ(classifier.Reset(process.now() + 600), BusyTransition::kNone);
+  // 新进程的第一个采样只是基线。
+  EXPECT_EQ(classifier.OnSample(process.now() + 1000, 0),
+            BusyTransition::kNone);
+}
+
+#ifdef __linux__
+
+std::int64_t NowMillis() { return MonotonicNanos() / 1000000; }
+
+// 子进程持续占满一个核，模拟前台软件在没有输入时执行滤镜 / 渲染。
+// 进程名带括号与空格，覆盖 /proc/<pid>/stat 的名称字段解析。
+pid_t SpawnSpinner() {
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::prctl(PR_SET_NAME, "spin) (x y");
+    volatile std::uint64_t sink = 0;
+    for (;;) {
+      sink = sink + 1;
+    }
+  }
+  return pid;
+}
+
+TEST(ProcessCpuSamplerTest, ClassifiesSyntheticWorkloadsInOneBatch) {
+  ASSERT_TRUE(ProcessCpuSampler::IsSupported());
+  const pid_t child = SpawnSpinner();
+  ASSERT_GT(child, 0);
+  const std::uint32_t pids[2] = {static_cast<std::uint32_t>(child),
+                                 static_cast<std::uint32_t>(::getpid())};
+
+  BusyClassifierConfig config;
+  config.busy_permille = 300;
+  BusyClassifier spinner(config);
+  BusyClassifier idle_parent(config);
+  ProcessCpuSampler sampler;
+  std::int64_t cpu[2];
+
+  auto sample_for = [&](int samples) {
+    for (int i = 0; i < samples; ++i) {
+      ASSERT_EQ(sampler.Sample(pids, 2, cpu), 2u);
+      const std::int64_t now = NowMillis();
+      spinner.OnSample(now, cpu[0]);
+      idle_parent.OnSample(now, cpu[1]);
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  };
+
+  sample_for(8);
+  EXPECT_TRUE(spinner.is_busy());
+  EXPECT_GE(spinner.last_permille(), 300u);
+  EXPECT_FALSE(idle_parent.is_busy());
+  EXPECT_EQ(sampler.cached_handles(), 2u);
+
+  // 暂停的进程不再消耗 CPU：渲染结束。
+  ASSERT_EQ(::kill(child, SIGSTOP), 0);
+  sample_for(6);
+  EXPECT_FALSE(spinner.is_busy());
+  EXPECT_LT(spinner.last_permille(), 300u);
+
+  ::kill(child, SIGKILL);
+  ::waitpid(child, nullptr, 0);
+  EXPECT_EQ(sampler.Sample(pids, 2, cpu), 1u);
+  EXPECT_EQ(cpu[0], -1);
+  EXPECT_GE(cpu[1], 0);
+  EXPECT_EQ(sampler.cached_handles(), 1u);
+
+  // 不在本批中的 pid 的句柄被关闭。
+  EXPECT_EQ(sampler.Sample(pids + 1, 1, cpu), 1u);
+  EXPECT_EQ(sampler.Sample(pids, 0, cpu), 0u);
+  EXPECT_EQ(sampler.cached_handles(), 0u);
+}
+
+TEST(ProcessCpuSamplerTest, UnknownPidFails) {
+  ProcessCpuSampler sampler;
+  const std::uint32_t pid = 0x7ffffff0u;
+  std::int64_t cpu = 0;
+  EXPECT_EQ(sampler.Sample(&pid, 1, &cpu), 0u);
+  EXPECT_EQ(cpu, -1);
+  EXPECT_EQ(sampler.cached_handles(), 0u);
+}
+
+#endif  // __linux__
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,133 @@
+#include "ringotrack/session_segmenter.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ringotrack/tracker_engine.h"
+#include "ringotrack/tracking_daemon.h"
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kStart = 1735689600000LL;  // 2025-01-01T00:00:00Z
+constexpr std::int64_t kGap = 5 * 60 * kMillisPerSecond;
+constexpr AppId kKrita = 1;
+constexpr AppId kBlender = 2;
+
+std::int64_t Seconds(std::int64_t s) { return s * kMillisPerSecond; }
+
+TEST(SessionSegmenterTest, MergesShortGapsAndSplitsLongOnes) {
+  SessionSegmenter segmenter(kGap);
+  segmenter.OnInterval(kKrita, 0, Seconds(60));
+  segmenter.OnInterval(kKrita, Seconds(60), Seconds(120));
+  // 4 分钟的间隔被合并，活跃时长不含间隔。
+  segmenter.OnInterval(kKrita, Seconds(360), Seconds(400));
+  // 超过 5 分钟：上一段结束。
+  segmenter.OnInterval(kKrita, Seconds(800), Seconds(810));
+
+  std::vector<DrawingSession> out;
+  ASSERT_EQ(segmenter.Drain(&out), 1u);
+  EXPECT_EQ(out[0].start_millis, 0);
+  EXPECT_EQ(out[0].end_millis, Seconds(400));
+  EXPECT_EQ(out[0].active_millis, Seconds(160));
+  EXPECT_EQ(segmenter.open_sessions(), 1u);
+}
+
+TEST(SessionSegmenterTest, KeepsOneOpenSessionPerApp) {
+  SessionSegmenter segmenter(kGap);
+  segmenter.OnInterval(kKrita, 0, Seconds(10));
+  segmenter.OnInterval(kBlender, Seconds(10), Seconds(20));
+  segmenter.OnInterval(kKrita, Seconds(20), Seconds(30));
+  EXPECT_EQ(segmenter.open_sessions(), 2u);
+
+  segmenter.ExpireBefore(Seconds(20) + kGap);
+  EXPECT_EQ(segmenter.open_sessions(), 2u);
+  // Blender 最后一个区间结束于 20 秒，Krita 结束于 30 秒。
+  segmenter.ExpireBefore(Seconds(21) + kGap);
+  std::vector<DrawingSession> out;
+  ASSERT_EQ(segmenter.Drain(&out), 1u);
+  EXPECT_EQ(out[0].app_id, kBlender);
+
+  segmenter.CloseAll();
+  out.clear();
+  ASSERT_EQ(segmenter.Drain(&out), 1u);
+  EXPECT_EQ(out[0].app_id, kKrita);
+  EXPECT_EQ(out[0].end_millis, Seconds(30));
+  EXPECT_EQ(out[0].active_millis, Seconds(20));
+  EXPECT_EQ(segmenter.open_sessions(), 0u);
+
+  // 过期后同一应用重新开始新会话。
+  segmenter.OnInterval(kKrita, Seconds(1000), Seconds(1001));
+  EXPECT_EQ(segmenter.open_sessions(), 1u);
+}
+
+class InternerResolver : public AppResolver {
+ public:
+  AppId Resolve(std::string_view name) override { return apps.Intern(name); }
+
+  AppInterner apps;
+};
+
+// 按 1 秒节拍把事件脚本回放进 TrackerEngine，返回切分出的会话。
+std::vector<DrawingSession> ReplayTrace(const std::string& script,
+                                        std::int64_t run_millis,
+                                        InternerResolver* resolver) {
+  std::istringstream in(script);
+  std::vector<ScriptedEvent> events;
+  std::string error;
+  EXPECT_TRUE(ParseEventScript(in, &events, &error)) << error;
+
+  const ManualClock clock(kStart);
+  TrackedAppSet tracked;
+  tracked.Add(resolver->Resolve("Krita.exe"));
+  TrackerEngine engine(&clock, &tracked, 60 * kMillisPerSecond, kStart);
+  SessionSegmenter segmenter(kGap);
+  engine.set_session_segmenter(&segmenter);
+  ScriptedEventSource source(std::move(events), kStart);
+  TrackerEventQueue queue;
+
+  for (std::int64_t now = kStart; now <= kStart + run_millis;
+       now += kMillisPerSecond) {
+    source.Poll(now, resolver, &queue);
+    engine.ProcessQueue(&queue);
+    engine.Tick(now);
+    segmenter.ExpireBefore(now);
+  }
+  engine.CloseAt(kStart + run_millis);
+  segmenter.CloseAll();
+
+  std::vector<DrawingSession> sessions;
+  segmenter.Drain(&sessions);
+  return sessions;
+}
+
+TEST(SessionSegmenterTest, ReplaysEngineTraceIntoSessions) {
+  InternerResolver resolver;
+  const std::vector<DrawingSession> sessions = ReplayTrace(
+      "0 fg Krita.exe\n"
+      "0 down\n"
+      "600000 up\n"        // 11 分钟进入 Idle
+      "900000 down\n"      // 空档 4 分钟：合并
+      "960000 up\n"        // 17 分钟进入 Idle
+      "1800000 down\n"     // 空档 13 分钟：新会话
+      "1860000 fg Browser.exe\n"
+      "1920000 fg Krita.exe\n"  // 切走 1 分钟：合并
+      "1980000 up\n"       // 34 分钟进入 Idle
+      "2100000 lock\n",
+      Seconds(2400), &resolver);
+
+  ASSERT_EQ(sessions.size(), 2u);
+  EXPECT_EQ(resolver.apps.Name(sessions[0].app_id), "Krita.exe");
+  EXPECT_EQ(sessions[0].start_millis, kStart);
+  EXPECT_EQ(sessions[0].end_millis, kStart + Seconds(1020));
+  EXPECT_EQ(sessions[0].active_millis, Seconds(660 + 120));
+  EXPECT_EQ(sessions[1].start_millis, kStart + Seconds(1800));
+  EXPECT_EQ(sessions[1].end_millis, kStart + Seconds(2040));
+  EXPECT_EQ(sessions[1].active_millis, Seconds(60 + 120));
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,101 @@
+#include "ringotrack/title_rules.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace ringotrack {
+namespace {
+
+std::unique_ptr<TitleRuleSet> Defaults() {
+  int error_line = -1;
+  auto rules = TitleRuleSet::Compile(kDefaultTitleRules, &error_line);
+  EXPECT_NE(rules, nullptr);
+  EXPECT_EQ(error_line, 0);
+  return rules;
+}
+
+TEST(TitleRulesTest, DefaultRulesExtractCanvasNames) {
+  const auto rules = Defaults();
+  ASSERT_NE(rules, nullptr);
+
+  EXPECT_EQ(rules->Extract("photoshop.exe",
+                           "sketch.psd @ 66.7% (Layer 1, RGB/8#) *"),
+            "sketch.psd");
+  EXPECT_EQ(rules->Extract("photoshop.exe",
+                           "Adobe Photoshop 2024 - cover - v2.psd @ 50% (RGB/8)"),
+            "cover - v2.psd");
+  EXPECT_EQ(rules->Extract("krita.exe", "* lineart.kra - Krita"),
+            "lineart.kra");
+  EXPECT_EQ(rules->Extract("clipstudiopaint.exe",
+                           "CLIP STUDIO PAINT EX - [illust_01.clip]"),
+            "illust_01.clip");
+  EXPECT_EQ(rules->Extract("sai2.exe", "PaintTool SAI Ver.2 - [doodle.sai2 *]"),
+            "doodle.sai2");
+}
+
+TEST(TitleRulesTest, UnknownAppOrNonMatchingTitleYieldsNothing) {
+  const auto rules = Defaults();
+  ASSERT_NE(rules, nullptr);
+
+  EXPECT_TRUE(rules->Extract("notepad.exe", "a.txt - Notepad").empty());
+  EXPECT_TRUE(rules->Extract("krita.exe", "Krita").empty());
+  // 捕获为空（只有未保存标记）时不算匹配。
+  EXPECT_TRUE(rules->Extract("krita.exe", " * - Krita").empty());
+  // 末尾字面量不能与开头重叠。
+  EXPECT_TRUE(rules->Extract("krita.exe", " - Krit").empty());
+}
+
+TEST(TitleRulesTest, RulesAreTriedInOrder) {
+  const auto rules = TitleRuleSet::Compile(
+      "# 注释\n"
+      "\n"
+      "app.exe [{doc}] *\n"
+      "app.exe {doc}\n",
+      nullptr);
+  ASSERT_NE(rules, nullptr);
+  EXPECT_EQ(rules->size(), 2u);
+  EXPECT_EQ(rules->Extract("app.exe", "[one] - App"), "one");
+  EXPECT_EQ(rules->Extract("app.exe", "  two  "), "two");
+}
+
+TEST(TitleRulesTest, CaptureIsShortestBeforeMiddleLiteral) {
+  const auto rules = TitleRuleSet::Compile("app.exe {doc} @ *", nullptr);
+  ASSERT_NE(rules, nullptr);
+  EXPECT_EQ(rules->Extract("app.exe", "a @ b @ 50%"), "a");
+}
+
+TEST(TitleRulesTest, CompileReportsErrorLine) {
+  int error_line = 0;
+  EXPECT_EQ(TitleRuleSet::Compile("ok.exe {doc}\nbad.exe no capture\n",
+                                  &error_line),
+            nullptr);
+  EXPECT_EQ(error_line, 2);
+
+  EXPECT_EQ(TitleRuleSet::Compile("a.exe {doc}{doc}", &error_line), nullptr);
+  EXPECT_EQ(error_line, 1);
+  EXPECT_EQ(TitleRuleSet::Compile("a.exe *{doc}", &error_line), nullptr);
+  EXPECT_EQ(TitleRuleSet::Compile("a.exe", &error_line), nullptr);
+
+  // `**` 折叠为 `*`。
+  const auto rules = TitleRuleSet::Compile("a.exe {doc} -** end", &error_line);
+  ASSERT_NE(rules, nullptr);
+  EXPECT_EQ(rules->Extract("a.exe", "x - y end"), "x");
+}
+
+TEST(TitleRulesTest, ExtractedNamesInternToStableIds) {
+  const auto rules = Defaults();
+  ASSERT_NE(rules, nullptr);
+
+  AppInterner documents;
+  const DocumentId first = documents.Intern(
+      rules->Extract("krita.exe", "lineart.kra - Krita"));
+  const DocumentId modified = documents.Intern(
+      rules->Extract("krita.exe", "lineart.kra * - Krita"));
+  EXPECT_NE(first, kNoDocument);
+  EXPECT_EQ(first, modified);
+  EXPECT_EQ(documents.Name(first), "lineart.kra");
+}
+
+}  // namespace
+}  // namespace ringotrack
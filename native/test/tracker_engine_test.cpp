@@ -0,0 +1,250 @@
+#include "ringotrack/tracker_engine.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kStart = 1735689600000LL;  // 2025-01-01T00:00:00Z
+constexpr std::int64_t kThreshold = 60 * kMillisPerSecond;
+
+std::int64_t TotalMillis(const std::vector<UsageBucket>& buckets,
+                         AppId app_id) {
+  std::int64_t total = 0;
+  for (const UsageBucket& bucket : buckets) {
+    if (bucket.app_id == app_id) {
+      total += bucket.millis;
+    }
+  }
+  return total;
+}
+
+class TrackerEngineTest : public ::testing::Test {
+ protected:
+  TrackerEngineTest() : engine_(&clock_, &tracked_, kThreshold, kStart) {
+    tracked_.Add(kDrawingApp);
+  }
+
+  static constexpr AppId kDrawingApp = 1;
+  static constexpr AppId kBrowser = 2;
+
+  ManualClock clock_;
+  TrackedAppSet tracked_;
+  TrackerEngine engine_;
+};
+
+TEST_F(TrackerEngineTest, CountsTrackedForegroundTime) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  for (int s = 1; s <= 30; ++s) {
+    engine_.Tick(kStart + s * kMillisPerSecond);
+  }
+  engine_.Process({kStart + 30 * kMillisPerSecond,
+                   TrackerEventKind::kForegroundChanged, kBrowser});
+  engine_.Tick(kStart + 40 * kMillisPerSecond);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 30 * kMillisPerSecond);
+  EXPECT_EQ(TotalMillis(out, kBrowser), 0);
+}
+
+TEST_F(TrackerEngineTest, StopsCountingWhileIdle) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  for (int s = 1; s <= 120; ++s) {
+    engine_.Tick(kStart + s * kMillisPerSecond);
+  }
+  EXPECT_TRUE(engine_.is_idle());
+
+  // 落笔后恢复计时。
+  engine_.Process({kStart + 150 * kMillisPerSecond,
+                   TrackerEventKind::kPointerDown, 0});
+  EXPECT_FALSE(engine_.is_idle());
+  engine_.Tick(kStart + 160 * kMillisPerSecond);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 70 * kMillisPerSecond);
+}
+
+TEST_F(TrackerEngineTest, KeyboardActivityExtendsByWeightedWindow) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  // 落笔窗口在 60 秒结束；第 50 秒的按键（权重 0.5）把截止推到 80 秒。
+  engine_.Process({kStart + 50 * kMillisPerSecond,
+                   TrackerEventKind::kKeyActivity, 0});
+  for (int s = 1; s <= 120; ++s) {
+    engine_.Tick(kStart + s * kMillisPerSecond);
+  }
+  EXPECT_TRUE(engine_.is_idle());
+
+  // Idle 中的按键立即恢复计时。
+  engine_.Process({kStart + 150 * kMillisPerSecond,
+                   TrackerEventKind::kKeyActivity, 0});
+  EXPECT_FALSE(engine_.is_idle());
+  engine_.Tick(kStart + 160 * kMillisPerSecond);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 90 * kMillisPerSecond);
+}
+
+TEST_F(TrackerEngineTest, KeyboardIgnoredWithZeroWeight) {
+  engine_.SetActivityWeight(ActivitySource::kKeyboard, 0);
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Process({kStart + 50 * kMillisPerSecond,
+                   TrackerEventKind::kKeyActivity, 0});
+  for (int s = 1; s <= 120; ++s) {
+    engine_.Tick(kStart + s * kMillisPerSecond);
+  }
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 60 * kMillisPerSecond);
+}
+
+TEST_F(TrackerEngineTest, ForegroundChangeWhileIdleIsRemembered) {
+  engine_.Tick(kStart + kThreshold);
+  ASSERT_TRUE(engine_.is_idle());
+
+  engine_.Process({kStart + kThreshold + 1000,
+                   TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Process({kStart + kThreshold + 2000, TrackerEventKind::kPointerDown,
+                   0});
+  engine_.Tick(kStart + kThreshold + 5000);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 3000);
+}
+
+TEST_F(TrackerEngineTest, ProcessQueueDrainsAllEvents) {
+  TrackerEventQueue queue;
+  ASSERT_TRUE(queue.TryPush(
+      {kStart, TrackerEventKind::kForegroundChanged, kDrawingApp}));
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_TRUE(queue.TryPush({kStart + i * 10,
+                               i % 2 == 0 ? TrackerEventKind::kPointerDown
+                                          : TrackerEventKind::kPointerUp,
+                               0}));
+  }
+
+  EXPECT_EQ(engine_.ProcessQueue(&queue), 201u);
+  EXPECT_EQ(queue.SizeApprox(), 0u);
+  EXPECT_EQ(engine_.foreground_app(), kDrawingApp);
+}
+
+TEST_F(TrackerEngineTest, SuspendClosesIntervalAtEventTime) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Process({kStart, TrackerEventKind::kPointerDown, 0});
+  for (int s = 1; s <= 10; ++s) {
+    engine_.Tick(kStart + s * kMillisPerSecond);
+  }
+  // 10.5s 时休眠；进程被冻结，直到 3 小时后唤醒才有下一次 Tick。
+  engine_.Process({kStart + 10500, TrackerEventKind::kSystemSuspend, 0});
+  EXPECT_TRUE(engine_.is_paused());
+  const std::int64_t wake = kStart + 3 * kMillisPerHour;
+  engine_.Tick(wake);
+  engine_.Process({wake + 200, TrackerEventKind::kSystemResume, 0});
+  EXPECT_FALSE(engine_.is_paused());
+  // 按键在休眠前按下、抬起事件丢失：唤醒后不能视为持续活动。
+  EXPECT_TRUE(engine_.is_idle());
+  engine_.Tick(wake + kMillisPerSecond);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 10500);
+}
+
+TEST_F(TrackerEngineTest, ShortLockResumesAtUnlockTime) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Tick(kStart + 5 * kMillisPerSecond);
+  engine_.Process({kStart + 5 * kMillisPerSecond,
+                   TrackerEventKind::kSessionLocked, 0});
+  engine_.Tick(kStart + 10 * kMillisPerSecond);
+  // 锁屏期间切换前台：记住但不计时。
+  engine_.Process({kStart + 12 * kMillisPerSecond,
+                   TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Process({kStart + 20 * kMillisPerSecond,
+                   TrackerEventKind::kSessionUnlocked, 0});
+  EXPECT_FALSE(engine_.is_idle());
+  engine_.Tick(kStart + 30 * kMillisPerSecond);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 15 * kMillisPerSecond);
+}
+
+TEST_F(TrackerEngineTest, NestedLockAndSuspendResumeOnlyWhenBothCleared) {
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  engine_.Process({kStart + 1000, TrackerEventKind::kSessionLocked, 0});
+  engine_.Process({kStart + 2000, TrackerEventKind::kSystemSuspend, 0});
+  engine_.Process({kStart + 9000, TrackerEventKind::kSystemResume, 0});
+  EXPECT_TRUE(engine_.is_paused());
+  engine_.Tick(kStart + 10000);
+  engine_.Process({kStart + 11000, TrackerEventKind::kSessionUnlocked, 0});
+  // 重复的解锁通知不影响状态。
+  engine_.Process({kStart + 11500, TrackerEventKind::kSessionUnlocked, 0});
+  engine_.Tick(kStart + 12000);
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), 1000 + 1000);
+}
+
+// 回放一条包含多次锁屏 / 休眠的追踪：1Hz Tick 只在进程醒着时出现，
+// 计数结果必须与按事件边界手算的真值完全一致。
+TEST_F(TrackerEngineTest, ReplayedTraceHasNoOverCountAcrossSuspend) {
+  struct Step {
+    std::int64_t at;
+    TrackerEventKind kind;
+    bool frozen_until_next;  // 事件之后进程被冻结（休眠）
+  };
+  const std::int64_t m = kMillisPerMinute;
+  const Step trace[] = {
+      {0, TrackerEventKind::kPointerDown, false},
+      {30 * 1000, TrackerEventKind::kPointerUp, false},
+      {50 * 1000, TrackerEventKind::kSystemSuspend, true},
+      {8 * 60 * m, TrackerEventKind::kSystemResume, false},
+      {8 * 60 * m + 5000, TrackerEventKind::kPointerDown, false},
+      {8 * 60 * m + 20000, TrackerEventKind::kPointerUp, false},
+      {8 * 60 * m + 40000, TrackerEventKind::kSessionLocked, false},
+      {8 * 60 * m + 45 * m, TrackerEventKind::kSessionUnlocked, false},
+      {8 * 60 * m + 45 * m + 1000, TrackerEventKind::kPointerDown, false},
+      {8 * 60 * m + 46 * m, TrackerEventKind::kSystemSuspend, true},
+      {20 * 60 * m, TrackerEventKind::kSystemResume, false},
+  };
+  // 真值：0~50s；唤醒后 5s 落笔 ~ 40s 锁屏；解锁后 1s 落笔 ~ 1 分钟后休眠。
+  const std::int64_t expected = 50 * 1000 + 35 * 1000 + 59 * 1000;
+
+  engine_.Process({kStart, TrackerEventKind::kForegroundChanged, kDrawingApp});
+  std::int64_t now = kStart;
+  bool frozen = false;
+  for (const Step& step : trace) {
+    const std::int64_t at = kStart + step.at;
+    if (frozen) {
+      // 唤醒后的第一次 Tick 可能抢在恢复通知之前执行。
+      now = at;
+      engine_.Tick(now);
+    } else {
+      // 醒着时每秒一次 Tick，直到事件发生。
+      while (now + kMillisPerSecond <= at) {
+        now += kMillisPerSecond;
+        engine_.Tick(now);
+      }
+    }
+    engine_.Process({at, step.kind, 0});
+    frozen = step.frozen_until_next;
+  }
+  for (int s = 0; s < 600; ++s) {
+    now += kMillisPerSecond;
+    engine_.Tick(now);
+  }
+
+  std::vector<UsageBucket> out;
+  engine_.Drain(&out);
+  EXPECT_EQ(TotalMillis(out, kDrawingApp), expected);
+}
+
+}  // namespace
+}  // namespace ringotrack
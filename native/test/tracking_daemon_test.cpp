@@ -0,0 +1,238 @@
+#include "ringotrack/tracking_daemon.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ringotrack {
+namespace {
+
+constexpr std::int64_t kStart = 1735689600000LL;  // 2025-01-01T00:00:00Z
+
+class RecordingSink : public UsageSink {
+ public:
+  bool Persist(const std::vector<UsageRecord>& records,
+               const AppInterner& apps) override {
+    ++calls;
+    if (fail) {
+      return false;
+    }
+    for (const UsageRecord& record : records) {
+      const std::string name(apps.Name(record.app_id));
+      seconds[name] += record.seconds;
+      tracked[name] = record.tracked;
+    }
+    return true;
+  }
+
+  std::int64_t total() const {
+    std::int64_t sum = 0;
+    for (const auto& entry : seconds) {
+      sum += entry.second;
+    }
+    return sum;
+  }
+
+  int calls = 0;
+  bool fail = false;
+  std::map<std::string, std::int64_t> seconds;
+  std::map<std::string, bool> tracked;
+};
+
+class TrackingDaemonTest : public ::testing::Test {
+ protected:
+  TrackingDaemonTest() : clock_(kStart) {
+    // 大多数用例不关心 Idle，阈值放宽到一小时。
+    options_.idle_threshold_millis = kMillisPerHour;
+  }
+
+  void Start(std::vector<ScriptedEvent> events,
+             const ClientLeaseLayout* lease = nullptr) {
+    source_ = std::make_unique<ScriptedEventSource>(std::move(events), kStart);
+    daemon_ = std::make_unique<TrackingDaemon>(&clock_, source_.get(), &sink_,
+                                               lease, options_);
+    daemon_->SetTrackedApps({"krita.exe"});
+  }
+
+  // 按 1 秒节拍推进到 kStart + offset。
+  void RunUntil(std::int64_t offset_millis) {
+    while (clock_.NowUnixMillis() < kStart + offset_millis) {
+      clock_.Advance(kMillisPerSecond);
+      daemon_->Step();
+    }
+  }
+
+  static ScriptedEvent Foreground(std::int64_t offset, const char* app) {
+    return {offset, TrackerEventKind::kForegroundChanged, app};
+  }
+
+  ManualClock clock_;
+  TrackingDaemonOptions options_;
+  RecordingSink sink_;
+  std::unique_ptr<ScriptedEventSource> source_;
+  std::unique_ptr<TrackingDaemon> daemon_;
+};
+
+TEST_F(TrackingDaemonTest, PersistsTrackedTimeInBatches) {
+  Start({Foreground(0, "Krita.exe"), Foreground(40000, "browser.exe")});
+
+  RunUntil(29000);
+  EXPECT_EQ(sink_.calls, 0);
+  RunUntil(30000);
+  EXPECT_EQ(sink_.calls, 1);
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 30);
+
+  RunUntil(50000);
+  ASSERT_TRUE(daemon_->Shutdown());
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 40);
+  EXPECT_EQ(sink_.seconds.count("browser.exe"), 0u);
+  EXPECT_EQ(daemon_->persisted_seconds(), 40);
+}
+
+TEST_F(TrackingDaemonTest, IdleTimeIsNotPersisted) {
+  options_.idle_threshold_millis = 60 * kMillisPerSecond;
+  Start({Foreground(0, "Krita.exe"),
+         {0, TrackerEventKind::kPointerDown, {}},
+         {1000, TrackerEventKind::kPointerUp, {}},
+         {120000, TrackerEventKind::kPointerDown, {}},
+         {121000, TrackerEventKind::kPointerUp, {}}});
+
+  RunUntil(150000);
+  ASSERT_TRUE(daemon_->Shutdown());
+  // 抬笔后 60 秒进入 Idle，120 秒落笔恢复。
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 61 + 30);
+}
+
+TEST_F(TrackingDaemonTest, UsesAdaptiveStepInterval) {
+  Start({Foreground(0, "Krita.exe"), Foreground(5000, "browser.exe")});
+
+  RunUntil(1000);
+  EXPECT_EQ(daemon_->NextStepDelayMillis(), options_.active_step_millis);
+  RunUntil(6000);
+  EXPECT_EQ(daemon_->NextStepDelayMillis(), options_.background_step_millis);
+}
+
+TEST_F(TrackingDaemonTest, LeavesLiveClientLeaseToTheClient) {
+  ClientLeaseLayout layout{};
+  InitializeClientLease(&layout);
+  ClientLeaseWriter client(&layout);
+  Start({Foreground(0, "Krita.exe")}, &layout);
+
+  RunUntil(10000);
+  client.Attach(kStart + 10000, kStart + 10000);
+  RunUntil(20000);
+  client.Report(kStart + 20000, kStart + 20000);
+  RunUntil(25000);
+  // 最后一次心跳之后客户端卡死。
+  client.Heartbeat(kStart + 25000);
+
+  RunUntil(35000);
+  // 客户端仍在超时内：只落库接手之前的时段，之后的切片暂存。
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 10);
+  EXPECT_GT(daemon_->pending_slices(), 0u);
+
+  RunUntil(60000);
+  ASSERT_TRUE(daemon_->Shutdown());
+  // 租约覆盖的 10~20 秒由客户端负责，其余从 persisted_until 起接手。
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 50);
+  EXPECT_EQ(daemon_->handed_over_millis(), 10 * kMillisPerSecond);
+}
+
+TEST_F(TrackingDaemonTest, DetachedClientIsTakenOverImmediately) {
+  ClientLeaseLayout layout{};
+  InitializeClientLease(&layout);
+  ClientLeaseWriter client(&layout);
+  client.Attach(kStart, kStart);
+  Start({Foreground(0, "Krita.exe")}, &layout);
+
+  for (std::int64_t t = 5000; t <= 20000; t += 5000) {
+    RunUntil(t);
+    client.Heartbeat(kStart + t);
+  }
+  EXPECT_EQ(daemon_->persisted_seconds(), 0);
+  client.Report(kStart + 20000, kStart + 20000);
+  client.Detach();
+
+  RunUntil(30000);
+  EXPECT_EQ(daemon_->pending_slices(), 0u);
+  ASSERT_TRUE(daemon_->Shutdown());
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 10);
+}
+
+TEST_F(TrackingDaemonTest, FailedFlushKeepsUsageForRetry) {
+  Start({Foreground(0, "Krita.exe")});
+  sink_.fail = true;
+  RunUntil(30000);
+  EXPECT_EQ(daemon_->failed_flushes(), 1u);
+  EXPECT_EQ(daemon_->persisted_seconds(), 0);
+
+  sink_.fail = false;
+  RunUntil(60000);
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 60);
+}
+
+TEST_F(TrackingDaemonTest, RecordAllAppsMarksUntrackedRecords) {
+  options_.record_all_apps = true;
+  Start({Foreground(0, "Krita.exe"), Foreground(10000, "browser.exe")});
+
+  RunUntil(20000);
+  ASSERT_TRUE(daemon_->Shutdown());
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 10);
+  EXPECT_EQ(sink_.seconds["browser.exe"], 10);
+  EXPECT_TRUE(sink_.tracked["Krita.exe"]);
+  EXPECT_FALSE(sink_.tracked["browser.exe"]);
+}
+
+TEST_F(TrackingDaemonTest, TrackedAppsCanChangeWhileRunning) {
+  Start({Foreground(0, "Krita.exe"), Foreground(10000, "Blender.exe"),
+         Foreground(20000, "Krita.exe")});
+
+  RunUntil(10000);
+  daemon_->SetTrackedApps({"blender.exe"});
+  RunUntil(30000);
+  ASSERT_TRUE(daemon_->Shutdown());
+  // 已结束的区间按当时的列表计入，之后只统计新列表中的应用。
+  EXPECT_EQ(sink_.seconds["Krita.exe"], 10);
+  EXPECT_EQ(sink_.seconds["Blender.exe"], 10);
+}
+
+TEST(EventScriptTest, ParsesEventsAndComments) {
+  std::istringstream in(
+      "# 注释\n"
+      "0 fg Clip Studio Paint.exe\n"
+      "  500 down\n"
+      "1500 up\r\n"
+      "\n"
+      "2000 fg\n"
+      "3000 lock\n");
+  std::vector<ScriptedEvent> events;
+  std::string error;
+  ASSERT_TRUE(ParseEventScript(in, &events, &error)) << error;
+  ASSERT_EQ(events.size(), 5u);
+  EXPECT_EQ(events[0].app, "Clip Studio Paint.exe");
+  EXPECT_EQ(events[1].kind, TrackerEventKind::kPointerDown);
+  EXPECT_EQ(events[2].offset_millis, 1500);
+  EXPECT_EQ(events[3].kind, TrackerEventKind::kForegroundChanged);
+  EXPECT_TRUE(events[3].app.empty());
+  EXPECT_EQ(events[4].kind, TrackerEventKind::kSessionLocked);
+}
+
+TEST(EventScriptTest, RejectsUnknownEventsAndDecreasingOffsets) {
+  std::vector<ScriptedEvent> events;
+  std::string error;
+  std::istringstream unknown("0 wiggle\n");
+  EXPECT_FALSE(ParseEventScript(unknown, &events, &error));
+  EXPECT_NE(error.find("line 1"), std::string::npos);
+
+  std::istringstream backwards("10 down\n5 up\n");
+  EXPECT_FALSE(ParseEventScript(backwards, &events, &error));
+  EXPECT_NE(error.find("line 2"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace ringotrack
@@ -0,0 +1,167 @@
+#include "ringotrack/usage_store.h"
+
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace ringotrack {
+namespace {
+
+std::string TempDatabasePath(const char* tag) {
+#ifdef _WIN32
+  const long pid = 0;
+#else
+  const long pid = static_cast<long>(::getpid());
+#endif
+  return ::testing::TempDir() + "ringotrack_" + tag + "_" +
+         std::to_string(pid) + ".sqlite";
+}
+
+// 与 Dart 侧 AppDatabase v6 相同的表结构；v8 起另有变更日志。
+void CreateSchema(const std::string& path, int user_version) {
+  sqlite3* db = nullptr;
+  ASSERT_EQ(sqlite3_open(path.c_str(), &db), SQLITE_OK);
+  const std::string sql =
+      "CREATE TABLE app_dictionary (id INTEGER PRIMARY KEY, "
+      "app_id TEXT NOT NULL UNIQUE);"
+      "CREATE TABLE daily_usage (day INTEGER NOT NULL, app INTEGER NOT NULL, "
+      "seconds INTEGER NOT NULL, PRIMARY KEY (day, app)) WITHOUT ROWID;"
+      "CREATE TABLE hourly_usage (packed_key INTEGER NOT NULL PRIMARY KEY, "
+      "seconds INTEGER NOT NULL) WITHOUT ROWID;"
+      "CREATE TABLE hourly_app_usage (day INTEGER NOT NULL, "
+      "hour INTEGER NOT NULL, app INTEGER NOT NULL, "
+      "seconds INTEGER NOT NULL, PRIMARY KEY (day, hour, app)) WITHOUT ROWID;"
+      "INSERT INTO app_dictionary (id, app_id) VALUES (7, 'Krita.exe');" +
+      std::string(user_version >= 8
+                      ? "CREATE TABLE usage_change_log ("
+                        "seq INTEGER PRIMARY KEY AUTOINCREMENT, "
+                        "packed_key INTEGER NOT NULL UNIQUE);"
+                      : "") +
+      "PRAGMA user_version = " +
+      std::to_string(user_version) + ";";
+  ASSERT_EQ(sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr),
+            SQLITE_OK);
+  sqlite3_close(db);
+}
+
+std::int64_t QueryInt(const std::string& path, const std::string& sql) {
+  sqlite3* db = nullptr;
+  sqlite3_open(path.c_str(), &db);
+  sqlite3_stmt* stmt = nullptr;
+  std::int64_t value = -1;
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW) {
+    value = sqlite3_column_int64(stmt, 0);
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return value;
+}
+
+class SqliteUsageStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = TempDatabasePath(
+        ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::remove(path_.c_str());
+    krita_ = apps_.Intern("Krita.exe");
+    blender_ = apps_.Intern("Blender.exe");
+  }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::string path_;
+  AppInterner apps_;
+  AppId krita_ = kNoApp;
+  AppId blender_ = kNoApp;
+};
+
+TEST_F(SqliteUsageStoreTest, AddsToDailyAndPackedHourlyRows) {
+  CreateSchema(path_, 6);
+  SqliteUsageStore store(path_);
+
+  const std::int32_t day = DayNumberFromCivil(2025, 1, 1);
+  ASSERT_TRUE(store.Persist({{day, 23, krita_, 30, true},
+                             {day, 23, blender_, 5, true}},
+                            apps_))
+      << store.last_error();
+  ASSERT_TRUE(store.Persist({{day, 23, krita_, 12, true}}, apps_));
+
+  // 已有的字典条目沿用原 ID，新应用追加。
+  EXPECT_EQ(QueryInt(path_, "SELECT seconds FROM daily_usage WHERE app = 7"),
+            42);
+  EXPECT_EQ(QueryInt(path_, "SELECT seconds FROM hourly_usage "
+                            "WHERE packed_key = " +
+                                std::to_string(HourlyUsageKey(day, 23, 7))),
+            42);
+  const std::int64_t blender = QueryInt(
+      path_, "SELECT id FROM app_dictionary WHERE app_id = 'Blender.exe'");
+  EXPECT_GT(blender, 7);
+  EXPECT_EQ(QueryInt(path_, "SELECT seconds FROM daily_usage WHERE app = " +
+                                std::to_string(blender)),
+            5);
+  EXPECT_EQ(QueryInt(path_, "SELECT COUNT(*) FROM hourly_app_usage"), 0);
+}
+
+TEST_F(SqliteUsageStoreTest, RecordAllAppsWritesFullTable) {
+  CreateSchema(path_, 6);
+  SqliteUsageStore store(path_, /*record_all_apps=*/true);
+
+  const std::int32_t day = DayNumberFromCivil(2025, 3, 9);
+  ASSERT_TRUE(store.Persist({{day, 8, krita_, 20, true},
+                             {day, 8, blender_, 10, false}},
+                            apps_))
+      << store.last_error();
+
+  EXPECT_EQ(QueryInt(path_, "SELECT SUM(seconds) FROM hourly_app_usage"), 30);
+  EXPECT_EQ(QueryInt(path_, "SELECT SUM(seconds) FROM daily_usage"), 20);
+  EXPECT_EQ(QueryInt(path_, "SELECT COUNT(*) FROM hourly_usage"), 1);
+}
+
+TEST_F(SqliteUsageStoreTest, LogsHourlyKeysForSyncFromSchemaV8) {
+  CreateSchema(path_, 8);
+  SqliteUsageStore store(path_);
+
+  const std::int32_t day = DayNumberFromCivil(2025, 3, 9);
+  ASSERT_TRUE(store.Persist({{day, 8, krita_, 20, true},
+                             {day, 9, krita_, 5, true}},
+                            apps_))
+      << store.last_error();
+  ASSERT_TRUE(store.Persist({{day, 8, krita_, 1, true}}, apps_));
+
+  // 每个键只保留最近一次改动的序号。
+  EXPECT_EQ(QueryInt(path_, "SELECT COUNT(*) FROM usage_change_log"), 2);
+  EXPECT_EQ(QueryInt(path_, "SELECT packed_key FROM usage_change_log "
+                            "ORDER BY seq DESC LIMIT 1"),
+            HourlyUsageKey(day, 8, 7));
+}
+
+TEST_F(SqliteUsageStoreTest, WaitsForTheAppToCreateAndMigrateTheDatabase) {
+  SqliteUsageStore store(path_);
+  const std::vector<UsageRecord> records = {{20000, 1, krita_, 1, true}};
+
+  // 文件不存在时不自行创建。
+  EXPECT_FALSE(store.Persist(records, apps_));
+  EXPECT_EQ(std::fopen(path_.c_str(), "rb"), nullptr);
+
+  CreateSchema(path_, 5);
+  EXPECT_FALSE(store.Persist(records, apps_));
+  EXPECT_NE(store.last_error().find("schema version 5"), std::string::npos);
+
+  ASSERT_EQ(QueryInt(path_, "PRAGMA user_version"), 5);
+  sqlite3* db = nullptr;
+  sqlite3_open(path_.c_str(), &db);
+  sqlite3_exec(db, "PRAGMA user_version = 6", nullptr, nullptr, nullptr);
+  sqlite3_close(db);
+  EXPECT_TRUE(store.Persist(records, apps_)) << store.last_error();
+}
+
+}  // namespace
+}  // namespace ringotrack
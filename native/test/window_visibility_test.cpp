@@ -0,0 +1,160 @@
+#include "ringotrack/window_visibility.h"
+
+#include <gtest/gtest.h>
+
+namespace ringotrack {
+namespace {
+
+TEST(OcclusionCalculatorTest, NoOccludersLeavesWholeAreaVisible) {
+  OcclusionCalculator calculator;
+  const WindowRect target{0, 0, 100, 50};
+  EXPECT_EQ(calculator.VisibleArea(target, nullptr, 0), 5000);
+
+  const WindowRect outside[] = {{200, 0, 300, 50}, {0, 50, 100, 80}};
+  EXPECT_EQ(calculator.VisibleArea(target, outside, 2), 5000);
+}
+
+TEST(OcclusionCalculatorTest, OverlappingOccludersAreNotDoubleCounted) {
+  OcclusionCalculator calculator;
+  const WindowRect target{0, 0, 100, 100};
+  // 左半边 + 上半边，重叠的左上角只算一次：5000 + 5000 - 2500。
+  const WindowRect occluders[] = {{-20, -20, 50, 120}, {0, 0, 100, 50}};
+  EXPECT_EQ(calculator.VisibleArea(target, occluders, 2), 2500);
+}
+
+TEST(OcclusionCalculatorTest, FullCoverReturnsZero) {
+  OcclusionCalculator calculator;
+  const WindowRect target{10, 10, 20, 20};
+  const WindowRect occluders[] = {{0, 0, 5, 5}, {0, 0, 100, 100}};
+  EXPECT_EQ(calculator.VisibleArea(target, occluders, 2), 0);
+
+  // 两块拼起来刚好盖满。
+  const WindowRect halves[] = {{10, 10, 15, 20}, {15, 10, 20, 20}};
+  EXPECT_EQ(calculator.VisibleArea(target, halves, 2), 0);
+}
+
+TEST(OcclusionCalculatorTest, MatchesPixelCountOnGrid) {
+  OcclusionCalculator calculator;
+  const WindowRect target{0, 0, 40, 30};
+  const WindowRect occluders[] = {
+      {5, 5, 15, 25}, {10, 0, 30, 10}, {25, 20, 45, 35}, {12, 12, 18, 18}};
+
+  std::int64_t expected = 0;
+  for (int x = target.left; x < target.right; ++x) {
+    for (int y = target.top; y < target.bottom; ++y) {
+      bool covered = false;
+      for (const WindowRect& rect : occluders) {
+        covered = covered || (x >= rect.left && x < rect.right &&
+                              y >= rect.top && y < rect.bottom);
+      }
+      expected += covered ? 0 : 1;
+    }
+  }
+  EXPECT_EQ(calculator.VisibleArea(target, occluders, 4), expected);
+}
+
+class WindowVisibilityTrackerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    krita_ = interner_.Intern("krita.exe");
+    photoshop_ = interner_.Intern("photoshop.exe");
+    chrome_ = interner_.Intern("chrome.exe");
+    TrackedAppSet tracked;
+    tracked.Add(krita_);
+    tracked.Add(photoshop_);
+    tracker_.SetTracked(tracked);
+  }
+
+  AppInterner interner_;
+  AppId krita_ = kNoApp;
+  AppId photoshop_ = kNoApp;
+  AppId chrome_ = kNoApp;
+  WindowVisibilityTracker tracker_;
+};
+
+TEST_F(WindowVisibilityTrackerTest, ReferenceOnSecondMonitorIsVisible) {
+  // 主屏前台是 Photoshop，副屏上的 Krita 开着参考图。
+  tracker_.Upsert(1, krita_, {1920, 0, 3840, 1080}, true);
+  tracker_.Upsert(2, photoshop_, {0, 0, 1920, 1080}, true);
+
+  const auto& visible = tracker_.Compute(photoshop_, 100);
+  ASSERT_EQ(visible.size(), 1u);
+  EXPECT_EQ(visible[0].app_id, krita_);
+  EXPECT_EQ(visible[0].visible_permille, 1000u);
+}
+
+TEST_F(WindowVisibilityTrackerTest, OccludedAndHiddenWindowsAreExcluded) {
+  tracker_.Upsert(1, krita_, {0, 0, 1000, 1000}, true);
+  // 浏览器盖住 Krita 的 95%。
+  tracker_.Upsert(2, chrome_, {0, 0, 1000, 950}, true);
+
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 100).empty());
+
+  // 浏览器最小化后 Krita 重新可见；未跟踪的浏览器本身不出现。
+  tracker_.Upsert(2, chrome_, {0, 0, 1000, 950}, false);
+  const auto& visible = tracker_.Compute(kNoApp, 100);
+  ASSERT_EQ(visible.size(), 1u);
+  EXPECT_EQ(visible[0].app_id, krita_);
+
+  tracker_.Upsert(1, krita_, {0, 0, 1000, 1000}, false);
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 100).empty());
+}
+
+TEST_F(WindowVisibilityTrackerTest, BringToTopReordersZOrder) {
+  tracker_.Upsert(1, krita_, {0, 0, 100, 100}, true);
+  tracker_.Upsert(2, chrome_, {0, 0, 100, 100}, true);
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 1).empty());
+
+  tracker_.BringToTop(1);
+  const auto& visible = tracker_.Compute(kNoApp, 1);
+  ASSERT_EQ(visible.size(), 1u);
+  EXPECT_EQ(visible[0].visible_permille, 1000u);
+
+  tracker_.Remove(1);
+  EXPECT_EQ(tracker_.window_count(), 1u);
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 1).empty());
+}
+
+TEST_F(WindowVisibilityTrackerTest, AppWithSeveralWindowsReportsBestOnce) {
+  tracker_.Upsert(1, krita_, {0, 0, 100, 100}, true);
+  tracker_.Upsert(2, chrome_, {0, 0, 100, 70}, true);
+  tracker_.Upsert(3, krita_, {500, 0, 600, 100}, true);
+  tracker_.Upsert(4, chrome_, {500, 0, 600, 50}, true);
+
+  const auto& visible = tracker_.Compute(kNoApp, 100);
+  ASSERT_EQ(visible.size(), 1u);
+  EXPECT_EQ(visible[0].visible_permille, 500u);
+}
+
+TEST_F(WindowVisibilityTrackerTest, TrackAllIncludesUnlistedApps) {
+  tracker_.Upsert(1, chrome_, {0, 0, 100, 100}, true);
+  tracker_.Upsert(2, kNoApp, {200, 0, 300, 100}, true);
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 1).empty());
+
+  tracker_.SetTracked(TrackedAppSet(), true);
+  const auto& visible = tracker_.Compute(kNoApp, 1);
+  ASSERT_EQ(visible.size(), 1u);
+  EXPECT_EQ(visible[0].app_id, chrome_);
+}
+
+TEST_F(WindowVisibilityTrackerTest, UpdateGeometryOnlyTouchesKnownWindows) {
+  tracker_.Upsert(1, krita_, {0, 0, 100, 100}, true);
+  ASSERT_EQ(tracker_.Compute(kNoApp, 100).size(), 1u);
+
+  // 未知窗口需要先查询所属应用再 Upsert。
+  EXPECT_FALSE(tracker_.UpdateGeometry(9, {0, 0, 10, 10}, true));
+  EXPECT_EQ(tracker_.AppOf(9), kNoApp);
+  EXPECT_EQ(tracker_.window_count(), 1u);
+
+  EXPECT_TRUE(tracker_.UpdateGeometry(1, {0, 0, 100, 100}, false));
+  EXPECT_EQ(tracker_.AppOf(1), krita_);
+  EXPECT_TRUE(tracker_.Compute(kNoApp, 100).empty());
+
+  // 前台应用变化时需要重新排除。
+  EXPECT_TRUE(tracker_.UpdateGeometry(1, {0, 0, 100, 100}, true));
+  ASSERT_EQ(tracker_.Compute(kNoApp, 100).size(), 1u);
+  EXPECT_TRUE(tracker_.Compute(krita_, 100).empty());
+}
+
+}  // namespace
+}  // namespace ringotrack
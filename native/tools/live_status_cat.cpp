@@ -0,0 +1,49 @@
+// 打印 RingoTrack 实时状态段的内容，演示外部进程如何只读订阅。
+//
+// 用法：ringotrack_live_status [--watch] [segment-name]
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "ringotrack/live_status.h"
+
+int main(int argc, char** argv) {
+  bool watch = false;
+  std::string name = ringotrack::kLiveStatusSegmentName;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--watch") == 0) {
+      watch = true;
+    } else {
+      name = argv[i];
+    }
+  }
+
+  const std::unique_ptr<ringotrack::LiveStatusSubscriber> subscriber =
+      ringotrack::LiveStatusSubscriber::Open(name);
+  if (!subscriber) {
+    std::fprintf(stderr, "live status segment '%s' not found\n", name.c_str());
+    return 1;
+  }
+
+  std::int64_t last_update = -1;
+  do {
+    ringotrack::LiveStatus status;
+    if (subscriber->Read(&status) && status.updated_at_millis != last_update) {
+      last_update = status.updated_at_millis;
+      std::printf(
+          "updated=%lld app=%s id=%u tracking=%d idle=%d session_start=%lld "
+          "today_ms=%lld\n",
+          static_cast<long long>(status.updated_at_millis), status.app_name,
+          status.app_id, status.is_tracking ? 1 : 0, status.is_idle ? 1 : 0,
+          static_cast<long long>(status.session_start_millis),
+          static_cast<long long>(status.today_total_millis));
+      std::fflush(stdout);
+    }
+    if (watch) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+  } while (watch);
+  return 0;
+}
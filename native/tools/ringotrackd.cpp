@@ -0,0 +1,248 @@
+// 脱离 Flutter 引擎运行的追踪守护进程。
+//
+// 用法：ringotrackd --db <ringotrack.sqlite> --script <events.txt>
+//                   [--tracked a.exe,b.exe] [--tracked-file <path>]
+//                   [--record-all] [--flush-seconds N] [--idle-seconds N]
+//                   [--replay [--start <unix-ms>]] [--no-lease]
+//
+// 事件来源目前只有脚本（格式见 ParseEventScript）：实时模式按墙钟回放，
+// --replay 用手动时钟一次跑完。有持租者时本进程只写 ClientLease 之外的
+// 时段；UI 暂不持租，也不随 Windows 构建打包本进程。退出（SIGINT /
+// SIGTERM 或回放结束）时落库并输出一行 JSON 统计。
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "ringotrack/client_lease.h"
+#include "ringotrack/clock.h"
+#include "ringotrack/tracking_daemon.h"
+#include "ringotrack/usage_store.h"
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void OnSignal(int) { g_stop.store(true); }
+
+std::vector<std::string> SplitList(const std::string& text) {
+  std::vector<std::string> items;
+  std::string item;
+  std::istringstream in(text);
+  while (std::getline(in, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// 每行一个 appId，# 开头为注释。
+std::vector<std::string> ReadTrackedFile(const std::string& path) {
+  std::vector<std::string> items;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::size_t begin = line.find_first_not_of(" \t");
+    const std::size_t end = line.find_last_not_of(" \t\r");
+    if (begin != std::string::npos && line[begin] != '#') {
+      items.push_back(line.substr(begin, end - begin + 1));
+    }
+  }
+  return items;
+}
+
+long MaxResidentKilobytes() {
+#ifdef _WIN32
+  return 0;
+#else
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#endif
+}
+
+// 追踪列表文件变化时重新读取。
+class TrackedFileWatcher {
+ public:
+  explicit TrackedFileWatcher(std::string path) : path_(std::move(path)) {}
+
+  bool Changed() {
+    std::error_code error;
+    const auto stamp = std::filesystem::last_write_time(path_, error);
+    if (error || (loaded_ && stamp == stamp_)) {
+      return false;
+    }
+    stamp_ = stamp;
+    loaded_ = true;
+    return true;
+  }
+
+  std::vector<std::string> Read() const { return ReadTrackedFile(path_); }
+
+ private:
+  std::string path_;
+  std::filesystem::file_time_type stamp_;
+  bool loaded_ = false;
+};
+
+int Usage() {
+  std::fprintf(stderr,
+               "usage: ringotrackd --db <path> --script <events> "
+               "[--tracked a,b] [--tracked-file <path>] [--record-all] "
+               "[--flush-seconds N] [--idle-seconds N] "
+               "[--replay [--start <unix-ms>]] [--no-lease]\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string db_path;
+  std::string script_path;
+  std::string tracked_list;
+  std::string tracked_file;
+  bool replay = false;
+  bool use_lease = true;
+  long long start_millis = -1;
+  ringotrack::TrackingDaemonOptions options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--db" && has_value) {
+      db_path = argv[++i];
+    } else if (arg == "--script" && has_value) {
+      script_path = argv[++i];
+    } else if (arg == "--tracked" && has_value) {
+      tracked_list = argv[++i];
+    } else if (arg == "--tracked-file" && has_value) {
+      tracked_file = argv[++i];
+    } else if (arg == "--record-all") {
+      options.record_all_apps = true;
+    } else if (arg == "--flush-seconds" && has_value) {
+      options.flush_interval_millis =
+          std::atoll(argv[++i]) * ringotrack::kMillisPerSecond;
+    } else if (arg == "--idle-seconds" && has_value) {
+      options.idle_threshold_millis =
+          std::atoll(argv[++i]) * ringotrack::kMillisPerSecond;
+    } else if (arg == "--replay") {
+      replay = true;
+    } else if (arg == "--start" && has_value) {
+      start_millis = std::atoll(argv[++i]);
+    } else if (arg == "--no-lease") {
+      use_lease = false;
+    } else {
+      return Usage();
+    }
+  }
+  if (db_path.empty() || script_path.empty()) {
+    return Usage();
+  }
+
+  std::ifstream script_file(script_path);
+  std::vector<ringotrack::ScriptedEvent> events;
+  std::string error;
+  if (!script_file || !ringotrack::ParseEventScript(script_file, &events,
+                                                    &error)) {
+    std::fprintf(stderr, "cannot read script '%s': %s\n", script_path.c_str(),
+                 error.c_str());
+    return 1;
+  }
+
+  ringotrack::SystemClock system_clock;
+  ringotrack::ManualClock manual_clock(
+      start_millis >= 0 ? start_millis : system_clock.NowUnixMillis(),
+      system_clock.LocalOffsetMillis(system_clock.NowUnixMillis()));
+  const ringotrack::Clock* clock =
+      replay ? static_cast<const ringotrack::Clock*>(&manual_clock)
+             : &system_clock;
+
+  ringotrack::ScriptedEventSource source(std::move(events),
+                                         clock->NowUnixMillis());
+  ringotrack::SqliteUsageStore store(db_path, options.record_all_apps);
+  std::unique_ptr<ringotrack::ClientLeaseSegment> lease;
+  if (use_lease) {
+    lease = ringotrack::ClientLeaseSegment::Create();
+    if (!lease) {
+      std::fprintf(stderr, "client lease segment unavailable\n");
+    }
+  }
+  ringotrack::TrackingDaemon daemon(clock, &source, &store,
+                                    lease ? lease->layout() : nullptr,
+                                    options);
+
+  std::unique_ptr<TrackedFileWatcher> watcher;
+  if (!tracked_file.empty()) {
+    watcher = std::make_unique<TrackedFileWatcher>(tracked_file);
+  } else {
+    daemon.SetTrackedApps(SplitList(tracked_list));
+  }
+
+  std::signal(SIGINT, OnSignal);
+  std::signal(SIGTERM, OnSignal);
+
+  // 回放在最后一个事件之后再跑一个 Idle 阈值，让末尾的区间自然结束。
+  const std::int64_t replay_end =
+      source.end_millis() + options.idle_threshold_millis;
+  std::size_t steps = 0;
+  std::size_t reported_failures = 0;
+  while (!g_stop.load()) {
+    if (watcher && watcher->Changed()) {
+      daemon.SetTrackedApps(watcher->Read());
+    }
+    daemon.Step();
+    ++steps;
+    if (lease) {
+      lease->layout()->daemon_heartbeat_millis.store(
+          clock->NowUnixMillis(), std::memory_order_relaxed);
+    }
+    if (daemon.failed_flushes() > reported_failures) {
+      reported_failures = daemon.failed_flushes();
+      std::fprintf(stderr, "flush failed: %s\n", store.last_error().c_str());
+    }
+
+    const std::int64_t delay = daemon.NextStepDelayMillis();
+    if (replay) {
+      if (source.finished() && manual_clock.NowUnixMillis() >= replay_end) {
+        break;
+      }
+      manual_clock.Advance(delay);
+      continue;
+    }
+    // 分段睡眠以便及时响应退出信号。
+    for (std::int64_t slept = 0; slept < delay && !g_stop.load();
+         slept += ringotrack::kMillisPerSecond) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(
+          std::min<std::int64_t>(delay - slept, ringotrack::kMillisPerSecond)));
+    }
+  }
+
+  const bool flushed = daemon.Shutdown();
+  if (!flushed) {
+    std::fprintf(stderr, "final flush failed: %s\n",
+                 store.last_error().c_str());
+  }
+  std::printf(
+      "{\"steps\":%zu,\"persisted_seconds\":%lld,\"handed_over_ms\":%lld,"
+      "\"failed_flushes\":%zu,\"apps\":%zu,\"max_rss_kb\":%ld}\n",
+      steps, static_cast<long long>(daemon.persisted_seconds()),
+      static_cast<long long>(daemon.handed_over_millis()),
+      daemon.failed_flushes(), daemon.apps().size(), MaxResidentKilobytes());
+  return flushed ? 0 : 1;
+}
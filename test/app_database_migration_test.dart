@@ -1,6 +1,9 @@
 import 'package:drift/native.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/compact_usage_store.dart';
+import 'package:ringotrack/feature/usage/models/document_usage.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
 
 void main() {
   group('AppDatabase hourly migration backfill', () {
@@ -139,4 +142,255 @@ void main() {
       },
     );
   });
+
+  group('AppDatabase integer-keyed usage tables', () {
+    late AppDatabase db;
+
+    setUp(() {
+      db = AppDatabase.forTesting(NativeDatabase.memory());
+    });
+
+    tearDown(() async {
+      await db.close();
+    });
+
+    Future<void> insertLegacy(
+      DateTime day,
+      String appId,
+      int seconds, {
+      int? hour,
+    }) async {
+      if (hour == null) {
+        await db
+            .into(db.dailyUsageEntries)
+            .insert(
+              DailyUsageEntriesCompanion.insert(
+                date: day,
+                appId: appId,
+                durationSeconds: seconds,
+              ),
+            );
+      } else {
+        await db
+            .into(db.hourlyUsageEntries)
+            .insert(
+              HourlyUsageEntriesCompanion.insert(
+                date: day,
+                hourIndex: hour,
+                appId: appId,
+                durationSeconds: seconds,
+              ),
+            );
+      }
+    }
+
+    test('moves legacy rows in chunks and keeps query results', () async {
+      final d1 = DateTime(2024, 12, 31);
+      final d2 = DateTime(2025, 1, 1);
+      await insertLegacy(d1, 'krita.exe', 600);
+      await insertLegacy(d2, 'krita.exe', 120);
+      await insertLegacy(d2, 'com.adobe.photoshop', 300);
+      await insertLegacy(d1, 'krita.exe', 600, hour: 23);
+      await insertLegacy(d2, 'krita.exe', 120, hour: 0);
+      await insertLegacy(d2, 'com.adobe.photoshop', 300, hour: 0);
+
+      expect(await db.migrateLegacyUsage(chunkRows: 2), 6);
+      expect(await db.select(db.dailyUsageEntries).get(), isEmpty);
+      expect(await db.select(db.hourlyUsageEntries).get(), isEmpty);
+
+      final daily = await db.loadRange(d1, d2);
+      expect(daily[d1], {'krita.exe': const Duration(seconds: 600)});
+      expect(daily[d2], {
+        'krita.exe': const Duration(seconds: 120),
+        'com.adobe.photoshop': const Duration(seconds: 300),
+      });
+
+      final hourly = await db.loadHourlyRange(d2, d2);
+      expect(hourly.keys, [d2]);
+      expect(hourly[d2]![0], {
+        'krita.exe': const Duration(seconds: 120),
+        'com.adobe.photoshop': const Duration(seconds: 300),
+      });
+
+      // 已经搬完时再次调用不做任何事。
+      expect(await db.migrateLegacyUsage(), 0);
+    });
+
+    test('resumes a partial migration without double counting', () async {
+      final day = DateTime(2025, 3, 1);
+      // 已搬运的部分在新表里，剩余的行仍在旧表里。
+      await db.mergeUsage({
+        day: {'krita.exe': const Duration(seconds: 100)},
+      });
+      await db.mergeHourlyUsage({
+        day: {
+          9: {'krita.exe': const Duration(seconds: 100)},
+        },
+      });
+      await insertLegacy(day, 'krita.exe', 50);
+      await insertLegacy(day, 'krita.exe', 50, hour: 9);
+
+      expect(await db.migrateLegacyUsage(chunkRows: 1), 2);
+      expect(
+        (await db.loadRange(day, day))[day]!['krita.exe'],
+        const Duration(seconds: 150),
+      );
+      expect(
+        (await db.loadHourlyRange(day, day))[day]![9]!['krita.exe'],
+        const Duration(seconds: 150),
+      );
+    });
+
+    test('hour and day boundaries survive key packing', () async {
+      final before = DateTime(2025, 5, 31);
+      final day = DateTime(2025, 6, 1);
+      final after = DateTime(2025, 6, 2);
+      final apps = [for (var i = 0; i < 40; i++) 'app_$i.exe'];
+      for (final d in [before, day, after]) {
+        await db.mergeHourlyUsage({
+          d: {
+            0: {for (final app in apps) app: const Duration(seconds: 1)},
+            23: {apps.last: const Duration(seconds: 2)},
+          },
+        });
+      }
+
+      final loaded = await db.loadHourlyRange(day, day);
+      expect(loaded.keys, [day]);
+      expect(loaded[day]![0]!.length, apps.length);
+      expect(loaded[day]![23], {apps.last: const Duration(seconds: 2)});
+
+      await db.deleteByDateRange(day, day);
+      final remaining = await db.loadHourlyRange(before, after);
+      expect(remaining.keys, unorderedEquals([before, after]));
+    });
+
+    test('sessions load by start time and follow deletions', () async {
+      DrawingSession session(String appId, DateTime start, int minutes) {
+        return DrawingSession(
+          appId: appId,
+          start: start,
+          end: start.add(Duration(minutes: minutes)),
+          active: Duration(minutes: minutes),
+        );
+      }
+
+      final day = DateTime(2025, 3, 1);
+      final sessions = [
+        session('krita.exe', DateTime(2025, 2, 28, 23, 50), 30),
+        session('krita.exe', DateTime(2025, 3, 1, 9), 45),
+        session('blender.exe', DateTime(2025, 3, 1, 14), 10),
+        session('krita.exe', DateTime(2025, 3, 2, 0, 10), 5),
+      ];
+      await db.insertSessions(sessions);
+
+      // 只按开始时刻筛选：跨过零点的会话归属前一天。
+      final loaded = await db.loadSessions(day, DateTime(2025, 3, 2));
+      expect(loaded, sessions.sublist(1, 3));
+
+      await db.deleteByAppId('blender.exe');
+      expect(await db.loadSessions(day, DateTime(2025, 3, 2)), [sessions[1]]);
+
+      await db.deleteByDateRange(day, day);
+      expect(
+        await db.loadSessions(DateTime(2025, 2, 1), DateTime(2025, 4, 1)),
+        [sessions[0], sessions[3]],
+      );
+    });
+
+    test('dictionary entries are pruned once no table uses them', () async {
+      final day = DateTime(2025, 3, 1);
+      final store = CompactUsageStore(db);
+      await db.mergeUsage({
+        day: {'krita.exe': const Duration(seconds: 10)},
+      });
+      await store.mergeHourly({
+        day: {
+          9: {'krita.exe': const Duration(seconds: 10)},
+        },
+      });
+
+      Future<List<String>> names() async => [
+        for (final row in await db
+            .customSelect('SELECT app_id FROM app_dictionary')
+            .get())
+          row.read<String>('app_id'),
+      ];
+
+      // 紧凑存储仍引用该应用时保留。
+      await db.clearAll();
+      expect(await names(), ['krita.exe']);
+
+      await store.clearAll();
+      expect(await names(), isEmpty);
+
+      // 作废后的缓存重新驻留仍然可用。
+      await db.mergeUsage({
+        day: {'krita.exe': const Duration(seconds: 5)},
+      });
+      expect(
+        (await db.loadRange(day, day))[day],
+        {'krita.exe': const Duration(seconds: 5)},
+      );
+    });
+
+    test('moves v10 document and secondary rows to packed keys', () async {
+      final day = DateTime(2025, 3, 1);
+      // drift 把 DateTime 存为 Unix 秒。
+      final date = day.millisecondsSinceEpoch ~/ 1000;
+      await db.customStatement(
+        'INSERT INTO documents (id, app_id, name) VALUES (?, ?, ?)',
+        [7, 'krita.exe', 'lineart.kra'],
+      );
+      for (final hour in [9, 23]) {
+        await db.customStatement(
+          'INSERT INTO hourly_document_usage_entries '
+          '(date, hour_index, app_id, doc_id, duration_seconds) '
+          'VALUES (?, ?, ?, ?, ?)',
+          [date, hour, 'krita.exe', 7, 60],
+        );
+        await db.customStatement(
+          'INSERT INTO hourly_secondary_usage_entries '
+          '(date, hour_index, app_id, duration_seconds) VALUES (?, ?, ?, ?)',
+          [date, hour, 'krita.exe', 30],
+        );
+      }
+
+      expect(await db.migrateLegacyUsage(chunkRows: 1), 4);
+      for (final table in const [
+        'documents',
+        'hourly_document_usage_entries',
+        'hourly_secondary_usage_entries',
+      ]) {
+        final row = await db
+            .customSelect('SELECT COUNT(*) AS c FROM $table')
+            .getSingle();
+        expect(row.read<int>('c'), 0, reason: table);
+      }
+
+      final key = documentUsageKey('krita.exe', 'lineart.kra');
+      expect(await db.loadHourlyDocumentRange(day, day), {
+        day: {
+          9: {key: const Duration(minutes: 1)},
+          23: {key: const Duration(minutes: 1)},
+        },
+      });
+      expect(await db.loadHourlySecondaryRange(day, day), {
+        day: {
+          9: {'krita.exe': const Duration(seconds: 30)},
+          23: {'krita.exe': const Duration(seconds: 30)},
+        },
+      });
+
+      // 与其它整数键表共用删除与字典清理路径。
+      await db.deleteByDateRange(day, day);
+      expect(await db.loadHourlyDocumentRange(day, day), isEmpty);
+      expect(await db.loadHourlySecondaryRange(day, day), isEmpty);
+      await db.deleteByAppId('krita.exe');
+      final names = await db
+          .customSelect('SELECT COUNT(*) AS c FROM app_dictionary')
+          .getSingle();
+      expect(names.read<int>('c'), 0);
+    });
+  });
 }
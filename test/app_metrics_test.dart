@@ -0,0 +1,93 @@
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/logging/services/app_metrics.dart';
+import 'package:ringotrack/platform/native_metrics_reader.dart';
+
+void main() {
+  group('LatencyHistogram', () {
+    test('matches the native bucket layout', () {
+      expect(LatencyHistogram.bucketCount, 496);
+      expect(LatencyHistogram.bucketIndex(7), 7);
+      expect(LatencyHistogram.bucketIndex(8), 8);
+      expect(LatencyHistogram.bucketIndex(15), 15);
+      expect(LatencyHistogram.bucketIndex(16), 16);
+      expect(LatencyHistogram.bucketIndex(17), 16);
+      expect(LatencyHistogram.bucketIndex(18), 17);
+      for (var i = 1; i < 480; i++) {
+        final lower = LatencyHistogram.bucketLowerBound(i);
+        expect(LatencyHistogram.bucketIndex(lower), i);
+        expect(LatencyHistogram.bucketIndex(lower - 1), lessThan(i));
+      }
+    });
+
+    test('reports quantiles within one bucket', () {
+      final histogram = LatencyHistogram();
+      for (var ms = 1; ms <= 100; ms++) {
+        histogram.recordDuration(Duration(milliseconds: ms));
+      }
+      final snapshot = histogram.snapshot();
+      expect(snapshot.count, 100);
+      expect(snapshot.max, 100000000);
+      expect(snapshot.mean, 50500000);
+      expect(
+        snapshot.valueAtQuantile(0.5),
+        inInclusiveRange(50000000, 56250000),
+      );
+      expect(snapshot.valueAtQuantile(1), 100000000);
+
+      histogram.reset();
+      expect(histogram.snapshot().valueAtQuantile(0.5), 0);
+    });
+  });
+
+  group('NativeMetricsSnapshot', () {
+    ByteData encode({int version = 1, int bucketCount = 496}) {
+      const counters = 7;
+      const histograms = 3;
+      final data = ByteData(
+        NativeMetricsSnapshot.byteLength(counters, histograms),
+      );
+      data.setUint32(0, version, Endian.host);
+      data.setUint32(4, counters, Endian.host);
+      data.setUint32(8, histograms, Endian.host);
+      data.setUint32(12, bucketCount, Endian.host);
+      var offset = 16;
+      void put(int value) {
+        data.setUint64(offset, value, Endian.host);
+        offset += 8;
+      }
+
+      for (var i = 0; i < counters; i++) {
+        put(i + 1);
+      }
+      for (var h = 0; h < histograms; h++) {
+        put(2);
+        put(3000 + h);
+        put(2000 + h);
+        for (var b = 0; b < LatencyHistogram.bucketCount; b++) {
+          put(b == LatencyHistogram.bucketIndex(1000) ? 2 : 0);
+        }
+      }
+      return data;
+    }
+
+    test('decodes counters and histograms by position', () {
+      final snapshot = NativeMetricsSnapshot.decode(encode())!;
+
+      expect(snapshot.counters['foreground_queries'], 1);
+      expect(snapshot.counters['session_events_dropped'], 7);
+      final hook = snapshot.histograms['mouse_hook']!;
+      expect(hook.count, 2);
+      expect(hook.sum, 3001);
+      expect(hook.max, 2001);
+      expect(hook.valueAtQuantile(0.5), inInclusiveRange(1000, 1125));
+    });
+
+    test('rejects unknown versions and bucket layouts', () {
+      expect(NativeMetricsSnapshot.decode(encode(version: 2)), isNull);
+      expect(NativeMetricsSnapshot.decode(encode(bucketCount: 64)), isNull);
+      expect(NativeMetricsSnapshot.decode(ByteData(8)), isNull);
+    });
+  });
+}
@@ -0,0 +1,189 @@
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/repositories/compact_usage_repository.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+
+void main() {
+  group('CompactUsageRepository', () {
+    late AppDatabase db;
+    late Set<String> tracked;
+    late bool Function(String) filter;
+    late CompactUsageRepository repo;
+
+    void track(Set<String> apps) {
+      tracked = apps;
+      // 新的闭包实例，模拟追踪列表变化后 provider 产出的新过滤器。
+      filter = (appId) => tracked.contains(appId);
+    }
+
+    setUp(() {
+      db = AppDatabase.forTesting(NativeDatabase.memory());
+      track({'photoshop.exe'});
+      repo = CompactUsageRepository(db, trackedFilter: () => filter);
+    });
+
+    tearDown(() async {
+      await db.close();
+    });
+
+    test('records every app and filters at query time', () async {
+      final day = DateTime(2025, 3, 1);
+      await repo.mergeHourlyUsage({
+        day: {
+          10: {
+            'photoshop.exe': const Duration(minutes: 20),
+            'chrome.exe': const Duration(minutes: 30),
+          },
+          11: {'chrome.exe': const Duration(minutes: 5)},
+        },
+      });
+
+      var hourly = await repo.loadHourlyRange(day, day);
+      expect(hourly[day]!.keys, [10]);
+      expect(hourly[day]![10], {'photoshop.exe': const Duration(minutes: 20)});
+
+      var daily = await repo.loadRange(day, day);
+      expect(daily[day], {'photoshop.exe': const Duration(minutes: 20)});
+
+      // 之后才加入追踪的应用，历史时长同样可见。
+      track({'photoshop.exe', 'chrome.exe'});
+      hourly = await repo.loadHourlyRange(day, day);
+      expect(hourly[day]![11], {'chrome.exe': const Duration(minutes: 5)});
+      daily = await repo.loadRange(day, day);
+      expect(daily[day]!['chrome.exe'], const Duration(minutes: 35));
+    });
+
+    test('keeps legacy tables limited to tracked apps', () async {
+      final day = DateTime(2025, 3, 2);
+      await repo.mergeHourlyUsage({
+        day: {
+          9: {
+            'photoshop.exe': const Duration(minutes: 10),
+            'chrome.exe': const Duration(minutes: 10),
+          },
+        },
+      });
+
+      final legacy = await SqliteUsageRepository(
+        db,
+      ).loadHourlyRange(day, day);
+      expect(legacy[day]![9], {'photoshop.exe': const Duration(minutes: 10)});
+    });
+
+    test('imports legacy hourly history once', () async {
+      final day = DateTime(2024, 12, 31);
+      await SqliteUsageRepository(db).mergeHourlyUsage({
+        day: {
+          22: {'photoshop.exe': const Duration(minutes: 40)},
+        },
+      });
+
+      final first = await repo.loadRange(day, day);
+      expect(first[day], {'photoshop.exe': const Duration(minutes: 40)});
+
+      // 第二个实例（例如重新开启全量记录）不会重复导入。
+      final again = CompactUsageRepository(db, trackedFilter: () => filter);
+      final second = await again.loadRange(day, day);
+      expect(second[day], {'photoshop.exe': const Duration(minutes: 40)});
+    });
+
+    test('reconciles hours logged while all-apps recording was off', () async {
+      final day = DateTime(2025, 5, 1);
+      track({'photoshop.exe', 'krita.exe'});
+      await repo.mergeHourlyUsage({
+        day: {
+          14: {
+            'photoshop.exe': const Duration(minutes: 10),
+            'chrome.exe': const Duration(minutes: 3),
+          },
+        },
+      });
+
+      // 关闭全量记录期间只写旧表，包括已有记录的同一天、同一小时。
+      final legacy = SqliteUsageRepository(db);
+      await legacy.mergeHourlyUsage({
+        day: {
+          14: {'photoshop.exe': const Duration(minutes: 20)},
+          15: {'krita.exe': const Duration(minutes: 5)},
+        },
+      });
+      // 跨越多个导入分段的更早历史。
+      final older = DateTime(2023, 1, 1);
+      await legacy.mergeHourlyUsage({
+        older: {
+          8: {'krita.exe': const Duration(minutes: 7)},
+        },
+      });
+
+      for (var i = 0; i < 2; i++) {
+        // 重新开启（以及之后每次启动）都只补差值。
+        final reopened = CompactUsageRepository(
+          db,
+          trackedFilter: () => filter,
+        );
+        final hourly = await reopened.loadHourlyRange(day, day);
+        expect(hourly[day]![14], {
+          'photoshop.exe': const Duration(minutes: 30),
+        });
+        expect(hourly[day]![15], {'krita.exe': const Duration(minutes: 5)});
+        final earlier = await reopened.loadRange(older, older);
+        expect(earlier[older], {'krita.exe': const Duration(minutes: 7)});
+      }
+
+      track({'photoshop.exe', 'krita.exe', 'chrome.exe'});
+      final all = await repo.loadHourlyRange(day, day);
+      expect(all[day]![14]!['chrome.exe'], const Duration(minutes: 3));
+    });
+
+    test('imports pre-1970 legacy hours into the right day', () async {
+      final day = DateTime(1969, 12, 31);
+      await SqliteUsageRepository(db).mergeHourlyUsage({
+        day: {
+          23: {'photoshop.exe': const Duration(minutes: 8)},
+        },
+      });
+
+      final hourly = await repo.loadHourlyRange(day, day);
+      expect(hourly[day], {
+        23: {'photoshop.exe': const Duration(minutes: 8)},
+      });
+      final next = DateTime(1970, 1, 1);
+      expect((await repo.loadRange(next, next))[next], isNull);
+    });
+
+    test('deletes apply to both stores', () async {
+      final day1 = DateTime(2025, 4, 1);
+      final day2 = DateTime(2025, 4, 2);
+      track({'photoshop.exe', 'krita.exe'});
+      await repo.mergeHourlyUsage({
+        day1: {
+          8: {
+            'photoshop.exe': const Duration(minutes: 10),
+            'krita.exe': const Duration(minutes: 10),
+          },
+        },
+        day2: {
+          8: {'krita.exe': const Duration(minutes: 15)},
+        },
+      });
+
+      await repo.deleteByAppId('krita.exe');
+      var range = await repo.loadRange(day1, day2);
+      expect(range.keys, [day1]);
+      expect(range[day1], {'photoshop.exe': const Duration(minutes: 10)});
+
+      await repo.deleteByDateRange(day1, day1);
+      range = await repo.loadRange(day1, day2);
+      expect(range, isEmpty);
+
+      await repo.mergeHourlyUsage({
+        day2: {
+          9: {'photoshop.exe': const Duration(minutes: 1)},
+        },
+      });
+      await repo.clearAll();
+      expect(await repo.loadHourlyRange(day1, day2), isEmpty);
+    });
+  });
+}
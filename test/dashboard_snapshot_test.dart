@@ -0,0 +1,144 @@
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_snapshot.dart';
+import 'package:ringotrack/feature/dashboard/services/dashboard_snapshot_store.dart';
+
+DashboardSnapshot _sample() {
+  return DashboardSnapshot(
+    writtenAt: DateTime(2025, 6, 2, 21, 30),
+    rangeStart: DateTime(2025, 1, 1),
+    rangeEnd: DateTime(2025, 12, 31),
+    daily: {
+      DateTime(2025, 6, 1): {
+        'photoshop.exe': const Duration(hours: 2, seconds: 5),
+        'clip_studio_paint.exe': const Duration(minutes: 40),
+      },
+      DateTime(2025, 6, 2): {'画图.exe': const Duration(minutes: 15)},
+    },
+    hourlyDay: DateTime(2025, 6, 2),
+    hourly: {
+      0: {'画图.exe': const Duration(minutes: 5)},
+      23: {'画图.exe': const Duration(minutes: 10)},
+    },
+  );
+}
+
+void main() {
+  group('DashboardSnapshot', () {
+    test('round-trips daily and hourly data', () {
+      final decoded = DashboardSnapshot.decode(_sample().encode())!;
+
+      expect(decoded.writtenAt, DateTime(2025, 6, 2, 21, 30));
+      expect(decoded.rangeStart, DateTime(2025, 1, 1));
+      expect(decoded.rangeEnd, DateTime(2025, 12, 31));
+      expect(decoded.daily, _sample().daily);
+      expect(decoded.hourlyDay, DateTime(2025, 6, 2));
+      expect(decoded.hourly, _sample().hourly);
+    });
+
+    test('covers and slices only within its range', () {
+      final snapshot = _sample();
+
+      expect(
+        snapshot.covers(DateTime(2025, 1, 1), DateTime(2025, 12, 31)),
+        isTrue,
+      );
+      expect(
+        snapshot.covers(DateTime(2024, 12, 1), DateTime(2025, 11, 30)),
+        isFalse,
+      );
+      expect(
+        snapshot.dailyIn(DateTime(2025, 6, 2), DateTime(2025, 6, 30)).keys,
+        [DateTime(2025, 6, 2)],
+      );
+      expect(snapshot.hourlyFor(DateTime(2025, 6, 1)), isNull);
+      expect(snapshot.hourlyFor(DateTime(2025, 6, 2)), snapshot.hourly);
+    });
+
+    test('omits hourly section when no day is set', () {
+      final snapshot = DashboardSnapshot(
+        writtenAt: DateTime(2025, 6, 2),
+        rangeStart: DateTime(2025, 1, 1),
+        rangeEnd: DateTime(2025, 12, 31),
+        daily: const {},
+      );
+      final decoded = DashboardSnapshot.decode(snapshot.encode())!;
+
+      expect(decoded.hourlyDay, isNull);
+      expect(decoded.hourly, isEmpty);
+      expect(decoded.daily, isEmpty);
+    });
+
+    test('rejects corrupted, truncated and foreign bytes', () {
+      final bytes = _sample().encode();
+
+      final flipped = Uint8List.fromList(bytes);
+      flipped[40] ^= 0xFF;
+      expect(DashboardSnapshot.decode(flipped), isNull);
+
+      expect(
+        DashboardSnapshot.decode(Uint8List.sublistView(bytes, 0, 50)),
+        isNull,
+      );
+      expect(DashboardSnapshot.decode(Uint8List(8)), isNull);
+      expect(DashboardSnapshot.decode(Uint8List(0)), isNull);
+    });
+  });
+
+  group('DashboardSnapshotStore', () {
+    late Directory dir;
+    late DashboardSnapshotStore store;
+
+    setUp(() {
+      dir = Directory.systemTemp.createTempSync('ringotrack_snapshot_');
+      final separator = Platform.pathSeparator;
+      store = DashboardSnapshotStore(
+        File('${dir.path}${separator}cache${separator}dashboard.snapshot'),
+      );
+    });
+
+    tearDown(() {
+      dir.deleteSync(recursive: true);
+    });
+
+    test('writes atomically and loads synchronously', () async {
+      expect(store.loadSync(), isNull);
+
+      await store.write(_sample());
+
+      expect(File('${store.file.path}.tmp').existsSync(), isFalse);
+      expect(store.loadSync()!.daily, _sample().daily);
+    });
+
+    test('ignores a damaged file', () async {
+      await store.write(_sample());
+      store.file.writeAsBytesSync([1, 2, 3, 4], mode: FileMode.append);
+
+      expect(store.loadSync(), isNull);
+    });
+
+    test('writer skips clean state and flushes latest data', () async {
+      final writer = DashboardSnapshotWriter(
+        store,
+        writeInterval: const Duration(hours: 1),
+        clock: () => DateTime(2025, 6, 2, 22),
+      );
+
+      await writer.flush();
+      expect(store.file.existsSync(), isFalse);
+
+      final sample = _sample();
+      writer.updateDaily(sample.rangeStart, sample.rangeEnd, sample.daily);
+      writer.updateHourly(sample.hourlyDay!, sample.hourly);
+      await writer.flush();
+      writer.dispose();
+
+      final loaded = store.loadSync()!;
+      expect(loaded.writtenAt, DateTime(2025, 6, 2, 22));
+      expect(loaded.daily, sample.daily);
+      expect(loaded.hourly, sample.hourly);
+    });
+  });
+}
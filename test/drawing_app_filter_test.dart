@@ -60,5 +60,22 @@ void main() {
       expect(filter('com.celsys.clipstudio'), isTrue);
       expect(filter('org.kde.krita'), isFalse);
     });
+
+    test('matches case-folded ids and glob patterns', () {
+      final filter = AppMatcher.fromIds([
+        'CLIPStudioPaint.exe',
+        'krita*.exe',
+        'sai?.exe',
+        '',
+      ]);
+
+      expect(filter('CLIPStudioPaint.exe'), isTrue);
+      expect(filter('clipstudiopaint.exe'), isTrue);
+      expect(filter('Krita-5.2.exe'), isTrue);
+      expect(filter('sai2.exe'), isTrue);
+      expect(filter('sai.exe'), isFalse);
+      expect(filter('krita.exe.bak'), isFalse);
+      expect(filter(''), isFalse);
+    });
   });
 }
@@ -0,0 +1,65 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+
+void main() {
+  final t0 = DateTime(2025, 1, 1, 9);
+  DateTime at(int minutes) => t0.add(Duration(minutes: minutes));
+
+  test('merges short gaps and splits long ones per app', () {
+    final segmenter = DrawingSessionSegmenter(
+      mergeGap: const Duration(minutes: 5),
+    );
+    segmenter.onInterval('krita.exe', at(0), at(30));
+    // 切到 Blender 两分钟后回来：Krita 的会话继续。
+    segmenter.onInterval('blender.exe', at(30), at(32));
+    segmenter.onInterval('krita.exe', at(32), at(60));
+    // 空档 20 分钟：上一段结束。
+    segmenter.onInterval('krita.exe', at(80), at(90));
+
+    expect(segmenter.drain(), [
+      DrawingSession(
+        appId: 'krita.exe',
+        start: at(0),
+        end: at(60),
+        active: const Duration(minutes: 58),
+      ),
+    ]);
+    expect(segmenter.openSessions, 2);
+
+    segmenter.expireBefore(at(95));
+    expect(segmenter.drain().single.appId, 'blender.exe');
+    segmenter.closeAll();
+    expect(segmenter.drain().single.end, at(90));
+    expect(segmenter.openSessions, 0);
+  });
+
+  test('summarizes sessions by the local day they start on', () {
+    final stats = summarizeSessionsByDay([
+      DrawingSession(
+        appId: 'krita.exe',
+        start: DateTime(2025, 1, 1, 23, 30),
+        end: DateTime(2025, 1, 2, 0, 30),
+        active: const Duration(minutes: 60),
+      ),
+      DrawingSession(
+        appId: 'krita.exe',
+        start: DateTime(2025, 1, 1, 9),
+        end: DateTime(2025, 1, 1, 9, 20),
+        active: const Duration(minutes: 20),
+      ),
+      DrawingSession(
+        appId: 'blender.exe',
+        start: DateTime(2025, 1, 2, 10),
+        end: DateTime(2025, 1, 2, 10, 5),
+        active: const Duration(minutes: 5),
+      ),
+    ]);
+
+    final first = stats[DateTime(2025, 1, 1)]!;
+    expect(first.count, 2);
+    expect(first.total, const Duration(minutes: 80));
+    expect(first.longest, const Duration(minutes: 60));
+    expect(first.average, const Duration(minutes: 40));
+    expect(stats[DateTime(2025, 1, 2)]!.count, 1);
+  });
+}
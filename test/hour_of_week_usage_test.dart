@@ -0,0 +1,133 @@
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/dashboard/models/dashboard_preferences.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/hour_of_week_usage.dart';
+
+// 2025-01-01 是周三，2025-01-05 是周日，2024-12-30 是周一。
+final _history = <DateTime, Map<int, Map<String, Duration>>>{
+  DateTime(2024, 12, 30): {
+    22: {'Krita.exe': const Duration(minutes: 40)},
+  },
+  DateTime(2025, 1, 1): {
+    9: {
+      'Krita.exe': const Duration(minutes: 30),
+      'Blender.exe': const Duration(minutes: 5),
+    },
+  },
+  DateTime(2025, 1, 5): {
+    9: {'Krita.exe': const Duration(minutes: 20)},
+    21: {'Krita.exe': const Duration(minutes: 10)},
+  },
+  DateTime(2025, 1, 8): {
+    9: {'Krita.exe': const Duration(minutes: 15)},
+  },
+};
+
+void main() {
+  late AppDatabase db;
+
+  setUp(() {
+    db = AppDatabase.forTesting(NativeDatabase.memory());
+  });
+
+  tearDown(() async {
+    await db.close();
+  });
+
+  Future<HourOfWeekUsage> folded(int year) async => HourOfWeekUsage.fold(
+    await db.loadHourlyRange(DateTime(year, 1, 1), DateTime(year, 12, 31)),
+  );
+
+  test('aggregate follows merges and matches folding hourly rows', () async {
+    await db.mergeHourlyUsage(_history);
+    await db.mergeHourlyUsage({
+      DateTime(2025, 1, 1): {
+        9: {'Krita.exe': const Duration(minutes: 1)},
+      },
+    });
+
+    final usage = await db.loadHourOfWeekUsage(2025, 2025);
+    expect(usage.secondsByApp, (await folded(2025)).secondsByApp);
+
+    final krita = usage.secondsByApp['Krita.exe']!;
+    expect(krita[HourOfWeekUsage.cellOf(2, 9)], (31 + 15) * 60);
+    expect(krita[HourOfWeekUsage.cellOf(6, 21)], 10 * 60);
+    expect(usage.hourOfDay('Krita.exe')[9], const Duration(minutes: 66));
+
+    // 年份按本地日期划分：2024-12-30 只属于 2024。
+    final previous = await db.loadHourOfWeekUsage(2024, 2024);
+    expect(previous.secondsByApp.keys, ['Krita.exe']);
+    expect(
+      previous.secondsByApp['Krita.exe']![HourOfWeekUsage.cellOf(0, 22)],
+      40 * 60,
+    );
+  });
+
+  test('punchcard rotates rows by week start mode', () async {
+    await db.mergeHourlyUsage(_history);
+    final usage = await db.loadHourOfWeekUsage(2024, 2025);
+
+    final monday = usage.punchcard(WeekStartMode.monday);
+    final sunday = usage.punchcard(WeekStartMode.sunday);
+    expect(monday, hasLength(7));
+    expect(monday[0][22], const Duration(minutes: 40));
+    expect(monday[6][21], const Duration(minutes: 10));
+    expect(sunday[0][21], const Duration(minutes: 10));
+    expect(sunday[1][22], const Duration(minutes: 40));
+    expect(sunday[3][9], const Duration(minutes: 51));
+
+    final blenderOnly = usage.punchcard(
+      WeekStartMode.monday,
+      include: (appId) => appId == 'Blender.exe',
+    );
+    expect(blenderOnly[2][9], const Duration(minutes: 5));
+  });
+
+  test('deletes and rebuild keep the aggregate consistent', () async {
+    await db.mergeHourlyUsage(_history);
+
+    await db.deleteByDateRange(DateTime(2025, 1, 5), DateTime(2025, 1, 5));
+    expect(
+      (await db.loadHourOfWeekUsage(2025, 2025)).secondsByApp,
+      (await folded(2025)).secondsByApp,
+    );
+
+    await db.deleteByAppId('Blender.exe');
+    final afterDelete = await db.loadHourOfWeekUsage(2025, 2025);
+    expect(afterDelete.secondsByApp.keys, ['Krita.exe']);
+
+    await db.rebuildHourOfWeekUsage();
+    expect(
+      (await db.loadHourOfWeekUsage(2025, 2025)).secondsByApp,
+      afterDelete.secondsByApp,
+    );
+
+    await db.clearAll();
+    expect((await db.loadHourOfWeekUsage(2024, 2025)).secondsByApp, isEmpty);
+  });
+
+  test('pre-1970 hourly keys round-trip with floor division', () async {
+    for (final (day, hour) in [(-1, 23), (-1, 0), (-8, 5), (0, 0), (0, 23)]) {
+      final key = AppDatabase.packHourlyKey(day, hour, 42);
+      expect(AppDatabase.unpackHourlyKey(key), (day: day, hour: hour, app: 42));
+    }
+
+    // 1969-12-31 是周三，日序号 -1。
+    final day = DateTime(1969, 12, 31);
+    await db.mergeHourlyUsage({
+      day: {
+        23: {'Krita.exe': const Duration(minutes: 12)},
+      },
+    });
+    expect((await db.loadHourlyRange(day, day))[day], {
+      23: {'Krita.exe': const Duration(minutes: 12)},
+    });
+    final usage = await db.loadHourOfWeekUsage(1969, 1969);
+    expect(
+      usage.secondsByApp['Krita.exe']![HourOfWeekUsage.cellOf(2, 23)],
+      12 * 60,
+    );
+    expect((await db.loadHourOfWeekUsage(1970, 1970)).secondsByApp, isEmpty);
+  });
+}
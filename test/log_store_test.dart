@@ -0,0 +1,185 @@
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/logging/models/app_log_entry.dart';
+import 'package:ringotrack/feature/logging/models/log_query.dart';
+import 'package:ringotrack/feature/logging/services/log_store.dart';
+
+AppLogEntry _entry(int i, {String? level, String? tag, String? message}) {
+  return AppLogEntry(
+    timestamp: DateTime(2025, 3, 1).add(Duration(seconds: i)),
+    level: level ?? (i % 10 == 0 ? 'ERROR' : 'INFO'),
+    tag: tag ?? (i % 3 == 0 ? 'usage_afk' : 'foreground_tracker'),
+    message: message ?? 'entry $i',
+  );
+}
+
+Future<List<AppLogEntry>> _readAll(
+  LogStore store,
+  LogQuery query, {
+  int limit = 7,
+  int maxScanBytes = 16 << 20,
+}) async {
+  final all = <AppLogEntry>[];
+  LogCursor? cursor;
+  do {
+    final page = await store.query(
+      query,
+      cursor: cursor,
+      limit: limit,
+      maxScanBytes: maxScanBytes,
+    );
+    expect(page.entries.length, lessThanOrEqualTo(limit));
+    all.addAll(page.entries);
+    cursor = page.next;
+  } while (cursor != null);
+  return all;
+}
+
+List<int> _ids(List<AppLogEntry> entries) => [
+  for (final entry in entries) int.parse(entry.message.split(' ').last),
+];
+
+void main() {
+  late Directory dir;
+
+  setUp(() async {
+    dir = await Directory.systemTemp.createTemp('ringotrack_logs_');
+  });
+
+  tearDown(() async {
+    await dir.delete(recursive: true);
+  });
+
+  LogStore createStore({int maxTotalBytes = 64 << 20}) => LogStore(
+    dir,
+    maxSegmentBytes: 2048,
+    maxTotalBytes: maxTotalBytes,
+    blockEntries: 8,
+  );
+
+  test('pages newest first across segments and unindexed tails', () async {
+    final store = createStore();
+    for (var i = 0; i < 300; i++) {
+      await store.append(_entry(i));
+    }
+
+    final segments = dir.listSync().where((e) => e.path.endsWith('.log'));
+    expect(segments.length, greaterThan(3));
+
+    final all = await _readAll(store, LogQuery.all);
+    expect(_ids(all), [for (var i = 299; i >= 0; i--) i]);
+    await store.close();
+  });
+
+  test('filters by level, tag, text and time range', () async {
+    final store = createStore();
+    for (var i = 0; i < 300; i++) {
+      await store.append(_entry(i));
+    }
+
+    final errors = await _readAll(store, const LogQuery(minLevel: 'WARN'));
+    expect(_ids(errors), [for (var i = 290; i >= 0; i -= 10) i]);
+
+    final afk = await _readAll(
+      store,
+      const LogQuery(minLevel: 'ERROR', tag: 'usage_afk'),
+    );
+    expect(_ids(afk), [for (var i = 270; i >= 0; i -= 30) i]);
+
+    final search = await _readAll(store, const LogQuery(text: 'ENTRY 12'));
+    expect(_ids(search), [for (var i = 129; i >= 120; i--) i, 12]);
+
+    final range = await _readAll(
+      store,
+      LogQuery(
+        from: DateTime(2025, 3, 1).add(const Duration(seconds: 100)),
+        to: DateTime(2025, 3, 1).add(const Duration(seconds: 110)),
+      ),
+    );
+    expect(_ids(range), [for (var i = 109; i >= 100; i--) i]);
+    await store.close();
+  });
+
+  test('index skips blocks that cannot match', () async {
+    final store = createStore();
+    for (var i = 0; i < 200; i++) {
+      await store.append(_entry(i, level: 'INFO', tag: 'tick'));
+    }
+    await store.append(_entry(200, level: 'ERROR', tag: 'usage_db'));
+    for (var i = 201; i < 400; i++) {
+      await store.append(_entry(i, level: 'INFO', tag: 'tick'));
+    }
+    await store.close();
+
+    final page = await store.query(const LogQuery(tag: 'usage_db'));
+    expect(_ids(page.entries), [200]);
+    expect(page.next, isNull);
+    expect(page.skippedBlocks, greaterThan(30));
+  });
+
+  test('scan budget returns partial pages that resume', () async {
+    final store = createStore();
+    for (var i = 0; i < 300; i++) {
+      await store.append(_entry(i));
+    }
+
+    final first = await store.query(
+      const LogQuery(text: 'entry 5'),
+      maxScanBytes: 1,
+    );
+    expect(first.entries.length, lessThan(5));
+    expect(first.next, isNotNull);
+
+    final all = await _readAll(
+      store,
+      const LogQuery(text: 'entry 5'),
+      maxScanBytes: 1,
+    );
+    expect(_ids(all), [59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 5]);
+    await store.close();
+  });
+
+  test('messages with newlines and backslashes round-trip', () async {
+    final store = createStore();
+    const message = 'line 1\nC:\\Users\\r\\n done 0';
+    await store.append(_entry(0, message: message));
+
+    final page = await store.query(LogQuery.all);
+    expect(page.entries.single.message, message);
+    expect(page.entries.single.tag, 'usage_afk');
+    await store.close();
+  });
+
+  test('retention deletes the oldest segments', () async {
+    final store = createStore(maxTotalBytes: 8192);
+    for (var i = 0; i < 1000; i++) {
+      await store.append(_entry(i));
+    }
+    await store.close();
+
+    var total = 0;
+    for (final file in dir.listSync().whereType<File>()) {
+      total += file.lengthSync();
+    }
+    expect(total, lessThanOrEqualTo(8192 + 2048 + 1024));
+
+    final ids = _ids(await _readAll(store, LogQuery.all, limit: 500));
+    expect(ids.first, 999);
+    expect(ids.last, greaterThan(0));
+    expect(ids, [for (var i = 999; i >= ids.last; i--) i]);
+  });
+
+  test('clear removes all segments', () async {
+    final store = createStore();
+    for (var i = 0; i < 50; i++) {
+      await store.append(_entry(i));
+    }
+    await store.clear();
+    expect((await store.query(LogQuery.all)).entries, isEmpty);
+
+    await store.append(_entry(1));
+    expect(_ids((await store.query(LogQuery.all)).entries), [1]);
+    await store.close();
+  });
+}
@@ -0,0 +1,109 @@
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/services/synthetic_usage_generator.dart';
+
+void main() {
+  group('SyntheticUsageGenerator', () {
+    test('is reproducible for the same seed', () {
+      final a = SyntheticUsageGenerator(seed: 7, years: 1, appCount: 20);
+      final b = SyntheticUsageGenerator(seed: 7, years: 1, appCount: 20);
+      final c = SyntheticUsageGenerator(seed: 8, years: 1, appCount: 20);
+
+      final first = Map.fromEntries(a.days());
+      expect(Map.fromEntries(b.days()), first);
+      expect(Map.fromEntries(c.days()), isNot(first));
+    });
+
+    test('stays within the requested range and hour limits', () {
+      final generator = SyntheticUsageGenerator(years: 2, appCount: 30);
+      final apps = generator.appIds.toSet();
+      final days = generator.days().toList();
+
+      expect(generator.firstDay, DateTime(2024, 1, 1));
+      expect(days, isNotEmpty);
+      expect(days.length, lessThan(731));
+      for (final entry in days) {
+        expect(entry.key.isBefore(generator.firstDay), isFalse);
+        expect(entry.key.isAfter(generator.lastDay), isFalse);
+        entry.value.forEach((hour, perApp) {
+          expect(hour, inInclusiveRange(0, 23));
+          final total = perApp.values.fold(Duration.zero, (a, b) => a + b);
+          expect(total.inSeconds, lessThanOrEqualTo(3600));
+          expect(apps.containsAll(perApp.keys), isTrue);
+        });
+      }
+    });
+
+    test('weekends and evenings dominate', () {
+      final generator = SyntheticUsageGenerator(years: 2, appCount: 30);
+      var weekendSeconds = 0;
+      var weekendDays = 0;
+      var weekdaySeconds = 0;
+      var weekdayDays = 0;
+      var eveningSeconds = 0;
+      var morningSeconds = 0;
+
+      for (final entry in generator.days()) {
+        final daily = SyntheticUsageGenerator.dailyOf(entry.value);
+        final seconds = daily.values.fold(0, (sum, d) => sum + d.inSeconds);
+        if (entry.key.weekday >= DateTime.saturday) {
+          weekendSeconds += seconds;
+          weekendDays++;
+        } else {
+          weekdaySeconds += seconds;
+          weekdayDays++;
+        }
+        entry.value.forEach((hour, perApp) {
+          final s = perApp.values.fold(0, (sum, d) => sum + d.inSeconds);
+          if (hour >= 19) eveningSeconds += s;
+          if (hour >= 4 && hour < 9) morningSeconds += s;
+        });
+      }
+
+      expect(
+        weekendSeconds / weekendDays,
+        greaterThan(weekdaySeconds / weekdayDays),
+      );
+      expect(eveningSeconds, greaterThan(morningSeconds * 10));
+    });
+  });
+
+  group('AppDatabase.bulkLoadUsage', () {
+    late AppDatabase db;
+
+    setUp(() {
+      db = AppDatabase.forTesting(NativeDatabase.memory());
+    });
+
+    tearDown(() async {
+      await db.close();
+    });
+
+    test('writes hourly rows and matching daily totals', () async {
+      final generator = SyntheticUsageGenerator(years: 1, appCount: 15);
+      final expectedHourly = Map.fromEntries(generator.days());
+
+      final rows = await db.bulkLoadUsage(generator.days(), chunkDays: 10);
+
+      final hourly = await db.loadHourlyRange(
+        generator.firstDay,
+        generator.lastDay,
+      );
+      final daily = await db.loadRange(generator.firstDay, generator.lastDay);
+      expect(hourly, expectedHourly);
+      expect(daily, {
+        for (final entry in expectedHourly.entries)
+          entry.key: SyntheticUsageGenerator.dailyOf(entry.value),
+      });
+
+      final hourlyRows = expectedHourly.values.fold<int>(
+        0,
+        (sum, perHour) =>
+            sum + perHour.values.fold(0, (s, apps) => s + apps.length),
+      );
+      final dailyRows = daily.values.fold<int>(0, (s, apps) => s + apps.length);
+      expect(rows, hourlyRows + dailyRows);
+    });
+  });
+}
@@ -0,0 +1,161 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+
+class _VirtualTimer implements Timer {
+  _VirtualTimer(this.due, this.callback);
+
+  final DateTime due;
+  final void Function() callback;
+  bool _active = true;
+
+  @override
+  bool get isActive => _active;
+
+  @override
+  int get tick => 0;
+
+  @override
+  void cancel() {
+    _active = false;
+  }
+}
+
+/// 虚拟时钟：只在 [advance] 时按到期顺序触发定时器。
+class _VirtualClock {
+  _VirtualClock(this.now);
+
+  DateTime now;
+  final _timers = <_VirtualTimer>[];
+
+  Timer createTimer(Duration delay, void Function() callback) {
+    final timer = _VirtualTimer(now.add(delay), callback);
+    _timers.add(timer);
+    return timer;
+  }
+
+  Future<void> advance(Duration by) async {
+    final target = now.add(by);
+    while (true) {
+      _timers.removeWhere((t) => !t.isActive);
+      _timers.sort((a, b) => a.due.compareTo(b.due));
+      if (_timers.isEmpty || _timers.first.due.isAfter(target)) break;
+      final timer = _timers.removeAt(0);
+      timer._active = false;
+      now = timer.due;
+      timer.callback();
+      // 让异步节拍跑完。
+      await Future<void>.delayed(Duration.zero);
+    }
+    now = target;
+  }
+}
+
+void main() {
+  late _VirtualClock clock;
+  late TickScheduler scheduler;
+  late List<DateTime> ticks;
+
+  setUp(() {
+    clock = _VirtualClock(DateTime(2025, 3, 1, 10, 0, 0, 300));
+    scheduler = TickScheduler(
+      now: () => clock.now,
+      createTimer: clock.createTimer,
+    );
+    ticks = [];
+    scheduler.handler = () async => ticks.add(clock.now);
+  });
+
+  tearDown(() => scheduler.dispose());
+
+  test('ticks are aligned to whole intervals', () async {
+    await clock.advance(const Duration(seconds: 3));
+    expect(ticks, [
+      DateTime(2025, 3, 1, 10, 0, 1),
+      DateTime(2025, 3, 1, 10, 0, 2),
+      DateTime(2025, 3, 1, 10, 0, 3),
+    ]);
+    expect(scheduler.wakeups, 3);
+  });
+
+  test('cadence changes the interval; speeding up is immediate', () async {
+    // 已经排好的 10:00:01 不因切到更慢的档位而推迟。
+    scheduler.setCadence(TickCadence.background);
+    await clock.advance(const Duration(seconds: 12));
+    expect(ticks, [
+      DateTime(2025, 3, 1, 10, 0, 1),
+      DateTime(2025, 3, 1, 10, 0, 5),
+      DateTime(2025, 3, 1, 10, 0, 10),
+    ]);
+
+    // 10:00:12.300 切回 active，下一拍在 10:00:13，而不是 10:00:15。
+    scheduler.setCadence(TickCadence.active);
+    await clock.advance(const Duration(seconds: 1));
+    expect(ticks.last, DateTime(2025, 3, 1, 10, 0, 13));
+  });
+
+  test('pollers run in order before the handler', () async {
+    final calls = <String>[];
+    void first() => calls.add('first');
+    void second() => calls.add('second');
+    scheduler.addPoller(first);
+    scheduler.addPoller(second);
+    scheduler.handler = () async => calls.add('handler');
+
+    await clock.advance(const Duration(seconds: 1));
+    expect(calls, ['first', 'second', 'handler']);
+
+    scheduler.removePoller(first);
+    calls.clear();
+    await clock.advance(const Duration(seconds: 1));
+    expect(calls, ['second', 'handler']);
+  });
+
+  test('idle without pollers is event driven', () async {
+    scheduler.setCadence(TickCadence.idle);
+    expect(scheduler.currentInterval, isNull);
+    expect(scheduler.scheduledAt, isNull);
+
+    await clock.advance(const Duration(minutes: 10));
+    expect(ticks, isEmpty);
+
+    scheduler.requestTick();
+    await clock.advance(Duration.zero);
+    expect(ticks, hasLength(1));
+
+    // 有轮询源时仍按 idle 间隔唤醒。
+    scheduler.addPoller(() {});
+    await clock.advance(const Duration(seconds: 10));
+    expect(ticks, hasLength(3));
+  });
+
+  test('a slow handler is never re-entered', () async {
+    final release = Completer<void>();
+    var running = 0;
+    var maxRunning = 0;
+    scheduler.handler = () async {
+      running++;
+      maxRunning = running > maxRunning ? running : maxRunning;
+      await release.future;
+      running--;
+    };
+
+    await clock.advance(const Duration(seconds: 2));
+    // 结算未完成时请求的节拍被跳过，而不是并发执行。
+    scheduler.requestTick();
+    await clock.advance(const Duration(seconds: 3));
+    expect(scheduler.wakeups, 1);
+    release.complete();
+    await Future<void>.delayed(Duration.zero);
+    await clock.advance(const Duration(seconds: 2));
+    expect(maxRunning, 1);
+    expect(scheduler.wakeups, greaterThan(1));
+  });
+
+  test('dispose cancels pending ticks', () async {
+    scheduler.dispose();
+    await clock.advance(const Duration(seconds: 5));
+    expect(ticks, isEmpty);
+  });
+}
@@ -254,4 +254,25 @@ void main() {
       expect(aggregator.usageByDateHour.isEmpty, isTrue);
     });
   });
+
+  group('addIntervalByHour', () {
+    test('splits a late tick across hours and midnight', () {
+      final usage = <DateTime, Map<int, Map<String, Duration>>>{};
+      final start = DateTime(2025, 1, 1, 22, 59, 30);
+      final end = DateTime(2025, 1, 2, 0, 0, 20);
+
+      addIntervalByHour(usage, 'Krita.exe', start, end);
+      addIntervalByHour(usage, 'Photoshop.exe', start, start);
+
+      expect(usage, {
+        DateTime(2025, 1, 1): {
+          22: {'Krita.exe': const Duration(seconds: 30)},
+          23: {'Krita.exe': const Duration(hours: 1)},
+        },
+        DateTime(2025, 1, 2): {
+          0: {'Krita.exe': const Duration(seconds: 20)},
+        },
+      });
+    });
+  });
 }
@@ -1,3 +1,5 @@
+import 'dart:math';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:ringotrack/feature/usage/services/usage_analysis.dart';
 
@@ -88,5 +90,82 @@ void main() {
       expect(sunday.average.inHours, 1);
       expect(tuesday.average, Duration.zero);
     });
+
+    test('summarize matches individual queries over multi-year data', () {
+      final random = Random(7);
+      final usage = <DateTime, Map<String, Duration>>{};
+      for (var i = 0; i < 3 * 365; i += 1 + random.nextInt(3)) {
+        usage[DateTime(2022, 3, 1 + i)] = {
+          for (var a = 0; a < 1 + random.nextInt(4); a++)
+            'app${random.nextInt(6)}': Duration(
+              seconds: 1 + random.nextInt(7200),
+            ),
+        };
+      }
+
+      final analysis = UsageAnalysis(usage);
+      final start = DateTime(2023, 2, 15); // 周三
+      final end = DateTime(2024, 11, 3);
+      final weeklyStart = DateTime(2022, 12, 1);
+      final summary = analysis.summarize(
+        start,
+        end,
+        weeklyStart: weeklyStart,
+      );
+
+      final daily = analysis.dailyTotals(start, end);
+      expect(summary.daily.length, daily.length);
+      expect(daily.first.date, start);
+      expect(daily.last.date, end);
+      for (var i = 0; i < daily.length; i++) {
+        expect(summary.daily[i].date, daily[i].date);
+        expect(summary.daily[i].total, daily[i].total);
+        expect(summary.daily[i].perApp, daily[i].perApp);
+        final expected = usage[daily[i].date] ?? const {};
+        expect(
+          daily[i].total,
+          expected.values.fold(Duration.zero, (a, b) => a + b),
+        );
+      }
+
+      final weekly = analysis.weeklyTotals(weeklyStart, end);
+      expect(summary.weekly.map((w) => w.weekStart), [
+        for (final w in weekly) w.weekStart,
+      ]);
+      expect(summary.weekly.map((w) => w.total), [
+        for (final w in weekly) w.total,
+      ]);
+      for (final w in weekly) {
+        expect(w.weekStart.weekday, DateTime.monday);
+      }
+
+      expect(
+        summary.appTotals.map((e) => (e.appId, e.total)),
+        analysis.appTotals(start, end).map((e) => (e.appId, e.total)),
+      );
+      expect(
+        summary.weekdayAverages.map((e) => e.average),
+        analysis.weekdayAverages(start, end).map((e) => e.average),
+      );
+    });
+
+    test('empty usage and reversed ranges yield empty results', () {
+      final analysis = UsageAnalysis({});
+      expect(analysis.dailyTotals(DateTime(2025), DateTime(2025, 1, 3)), [
+        isA<DailyTotal>(),
+        isA<DailyTotal>(),
+        isA<DailyTotal>(),
+      ]);
+      expect(
+        analysis.dailyTotals(DateTime(2025, 1, 3), DateTime(2025, 1, 1)),
+        isEmpty,
+      );
+      expect(
+        analysis.weekdayAverages(DateTime(2025), DateTime(2025, 1, 7)).map(
+          (e) => e.average,
+        ),
+        everyElement(Duration.zero),
+      );
+    });
   });
 }
@@ -0,0 +1,143 @@
+import 'dart:typed_data';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/usage_archive.dart';
+import 'package:ringotrack/feature/usage/models/drawing_session.dart';
+
+final _first = DateTime(2024, 12, 31);
+final _last = DateTime(2025, 1, 2);
+
+final _sessions = [
+  DrawingSession(
+    appId: 'Krita.exe',
+    start: DateTime(2025, 1, 1, 9),
+    end: DateTime(2025, 1, 1, 10, 30),
+    active: const Duration(minutes: 80),
+  ),
+  DrawingSession(
+    appId: 'Clip, "Studio".exe',
+    start: DateTime(2025, 1, 1, 21),
+    end: DateTime(2025, 1, 1, 21, 20),
+    active: const Duration(minutes: 20),
+  ),
+];
+
+Future<void> _seed(AppDatabase db) async {
+  await db.mergeHourlyUsage({
+    DateTime(2024, 12, 31): {
+      23: {'Krita.exe': const Duration(minutes: 30)},
+    },
+    DateTime(2025, 1, 1): {
+      9: {
+        'Krita.exe': const Duration(minutes: 50),
+        'Clip, "Studio".exe': const Duration(seconds: 5),
+      },
+      21: {'Clip, "Studio".exe': const Duration(minutes: 20)},
+    },
+  });
+  await db.mergeUsage({
+    DateTime(2024, 12, 31): {'Krita.exe': const Duration(minutes: 30)},
+    DateTime(2025, 1, 1): {
+      'Krita.exe': const Duration(minutes: 50),
+      'Clip, "Studio".exe': const Duration(seconds: 1205),
+    },
+  });
+  await db.insertSessions(_sessions);
+}
+
+Future<Uint8List> _exportBytes(
+  AppDatabase db,
+  UsageArchiveFormat format,
+) async {
+  final builder = BytesBuilder();
+  await for (final chunk in UsageArchive(
+    db,
+    chunkRows: 2,
+  ).export(format: format)) {
+    builder.add(chunk);
+  }
+  return builder.takeBytes();
+}
+
+/// 按 [size] 字节切块，模拟从文件分段读取。
+Stream<List<int>> _chunked(Uint8List bytes, int size) async* {
+  for (var i = 0; i < bytes.length; i += size) {
+    yield bytes.sublist(i, i + size > bytes.length ? bytes.length : i + size);
+  }
+}
+
+void main() {
+  late AppDatabase source;
+  late AppDatabase target;
+
+  setUp(() async {
+    source = AppDatabase.forTesting(NativeDatabase.memory());
+    target = AppDatabase.forTesting(NativeDatabase.memory());
+    await _seed(source);
+  });
+
+  tearDown(() async {
+    await source.close();
+    await target.close();
+  });
+
+  for (final format in UsageArchiveFormat.values) {
+    test('round-trips history through ${format.name} archive', () async {
+      final bytes = await _exportBytes(source, format);
+      final progress = <int>[];
+
+      final result = await UsageArchive(target, chunkRows: 2).import(
+        _chunked(bytes, 3),
+        totalBytes: bytes.length,
+        onProgress: (p) => progress.add(p.rows),
+      );
+
+      expect(result.dailyRows, 3);
+      expect(result.hourlyRows, 4);
+      expect(result.sessions, 2);
+      expect(progress.last, result.rows);
+      expect(progress, orderedEquals([...progress]..sort()));
+      expect(
+        await target.loadHourlyRange(_first, _last),
+        await source.loadHourlyRange(_first, _last),
+      );
+      expect(
+        await target.loadRange(_first, _last),
+        await source.loadRange(_first, _last),
+      );
+      expect(await target.loadSessions(_first, _last), _sessions);
+    });
+  }
+
+  test('add mode sums durations while replace mode overwrites', () async {
+    final bytes = await _exportBytes(source, UsageArchiveFormat.binary);
+    final archive = UsageArchive(target);
+
+    await archive.import(_chunked(bytes, 64));
+    await archive.import(_chunked(bytes, 64));
+    var daily = await target.loadRange(_first, _last);
+    expect(
+      daily[DateTime(2025, 1, 1)]!['Krita.exe'],
+      const Duration(minutes: 100),
+    );
+    expect(await target.loadSessions(_first, _last), _sessions);
+
+    await archive.import(_chunked(bytes, 64), mode: UsageImportMode.replace);
+    daily = await target.loadRange(_first, _last);
+    expect(
+      daily[DateTime(2025, 1, 1)]!['Krita.exe'],
+      const Duration(minutes: 50),
+    );
+  });
+
+  test('rejects truncated binary archive', () async {
+    final bytes = await _exportBytes(source, UsageArchiveFormat.binary);
+
+    await expectLater(
+      UsageArchive(target).import(_chunked(bytes.sublist(0, 20), 64)),
+      throwsFormatException,
+    );
+  });
+}
@@ -0,0 +1,281 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/query/models/usage_query_protocol.dart';
+import 'package:ringotrack/feature/query/services/usage_query_cache.dart';
+import 'package:ringotrack/feature/query/services/usage_query_client.dart';
+import 'package:ringotrack/feature/query/services/usage_query_load.dart';
+import 'package:ringotrack/feature/query/services/usage_query_server.dart';
+import 'package:ringotrack/feature/usage/models/live_status.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+
+class _CountingUsageRepository implements UsageRepository {
+  _CountingUsageRepository(this.daily, this.hourly);
+
+  final Map<DateTime, Map<String, Duration>> daily;
+  final Map<DateTime, Map<int, Map<String, Duration>>> hourly;
+  int loadRangeCalls = 0;
+  int loadHourlyRangeCalls = 0;
+
+  @override
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    loadRangeCalls++;
+    return Map.fromEntries(
+      daily.entries.where(
+        (e) => !e.key.isBefore(start) && !e.key.isAfter(end),
+      ),
+    );
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    loadHourlyRangeCalls++;
+    return Map.fromEntries(
+      hourly.entries.where(
+        (e) => !e.key.isBefore(start) && !e.key.isAfter(end),
+      ),
+    );
+  }
+
+  @override
+  Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {}
+
+  @override
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {}
+
+  @override
+  Future<void> deleteByAppId(String appId) async {}
+
+  @override
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {}
+
+  @override
+  Future<void> clearAll() async {}
+}
+
+void main() {
+  // 跨年的两天，验证按年懒加载。
+  final day1 = DateTime(2024, 12, 31);
+  final day2 = DateTime(2025, 1, 1);
+  final d1 = dayNumberOf(day1);
+  final d2 = dayNumberOf(day2);
+
+  late Directory tempDir;
+  late _CountingUsageRepository repo;
+  late StreamController<Map<DateTime, Map<String, Duration>>> deltas;
+  late UsageQueryServer server;
+
+  setUp(() async {
+    tempDir = await Directory.systemTemp.createTemp('ringotrack_query_');
+    repo = _CountingUsageRepository(
+      {
+        day1: {
+          'Photoshop.exe': const Duration(minutes: 30),
+          'clip_studio_paint.exe': const Duration(minutes: 90),
+        },
+        day2: {'Photoshop.exe': const Duration(minutes: 15)},
+      },
+      {
+        day1: {
+          9: {'Photoshop.exe': const Duration(minutes: 30)},
+          22: {'clip_studio_paint.exe': const Duration(minutes: 90)},
+        },
+        day2: {
+          9: {'Photoshop.exe': const Duration(minutes: 15)},
+        },
+      },
+    );
+    deltas = StreamController.broadcast(sync: true);
+    server = await UsageQueryServer.bind(
+      endpointPath: '${tempDir.path}/query.sock',
+      cache: UsageQueryCache(repository: repo, deltaStream: deltas.stream),
+      liveStatus: () => LiveStatus(
+        appId: 'Photoshop.exe',
+        sessionStart: DateTime.fromMillisecondsSinceEpoch(1700000000000),
+        todayTotal: const Duration(minutes: 15),
+        isIdle: false,
+        isTracking: true,
+      ),
+    );
+  });
+
+  tearDown(() async {
+    await server.close();
+    await deltas.close();
+    await tempDir.delete(recursive: true);
+  });
+
+  test('day numbers round-trip and start at 1970-01-01', () {
+    expect(dayNumberOf(DateTime(1970, 1, 1)), 0);
+    expect(dateOfDayNumber(d2), day2);
+    expect(d2 - d1, 1);
+  });
+
+  test('pipelined batches are answered in order', () async {
+    final client = await UsageQueryClient.connect(server.endpointPath);
+
+    final first = client.send([
+      UsageQueryRequest.rangeTotal(1, d1, d2),
+      UsageQueryRequest.appTotals(2, d1, d2),
+    ]);
+    final second = client.send([
+      UsageQueryRequest.hourlyDistribution(3, d1, d2),
+      const UsageQueryRequest.liveStatus(4),
+      UsageQueryRequest.rangeTotal(5, d2, d1),
+    ]);
+
+    final a = await first;
+    expect(a.map((r) => r.id), [1, 2]);
+    expect(a[0].total, const Duration(minutes: 135));
+    expect(a[1].appTotals!.map((e) => e.key), [
+      'clip_studio_paint.exe',
+      'Photoshop.exe',
+    ]);
+    expect(a[1].appTotals!.last.value, const Duration(minutes: 45));
+
+    final b = await second;
+    expect(b.map((r) => r.id), [3, 4, 5]);
+    expect(b[0].hourly![9], const Duration(minutes: 45));
+    expect(b[0].hourly![22], const Duration(minutes: 90));
+    expect(b[1].liveStatus!.appId, 'Photoshop.exe');
+    expect(b[1].liveStatus!.isTracking, isTrue);
+    expect(b[1].liveStatus!.todayTotal, const Duration(minutes: 15));
+    expect(b[2].status, UsageQueryStatus.badRequest);
+
+    await client.close();
+  });
+
+  test('out-of-range days get badRequest responses', () async {
+    final client = await UsageQueryClient.connect(server.endpointPath);
+
+    final rejected = await client.send([
+      const UsageQueryRequest.rangeTotal(1, 2000000000, 2000000000),
+      const UsageQueryRequest.hourlyDistribution(2, -2000000000, -1999999999),
+    ]);
+    expect(rejected.map((r) => r.status), [
+      UsageQueryStatus.badRequest,
+      UsageQueryStatus.badRequest,
+    ]);
+
+    final after = await client.send([UsageQueryRequest.rangeTotal(3, d2, d2)]);
+    expect(after.single.total, const Duration(minutes: 15));
+    await client.close();
+  });
+
+  test('oversized replies become errors instead of stalling', () async {
+    // 20 个约 60 KB 的应用名，编码后超过帧长度上限。
+    final day = DateTime(2023, 6, 1);
+    repo.daily[day] = {
+      for (var i = 0; i < 20; i++)
+        '$i${'x' * 60000}': Duration(minutes: i + 1),
+    };
+    final client = await UsageQueryClient.connect(server.endpointPath);
+
+    final reply = await client.send([
+      UsageQueryRequest.appTotals(1, dayNumberOf(day), dayNumberOf(day)),
+      UsageQueryRequest.rangeTotal(2, dayNumberOf(day), dayNumberOf(day)),
+    ]);
+    expect(reply.map((r) => r.id), [1, 2]);
+    expect(reply.map((r) => r.status), [
+      UsageQueryStatus.internalError,
+      UsageQueryStatus.internalError,
+    ]);
+
+    final after = await client.send([UsageQueryRequest.rangeTotal(3, d2, d2)]);
+    expect(after.single.total, const Duration(minutes: 15));
+    await client.close();
+  });
+
+  test('hot queries hit the repository once per year and follow deltas', () async {
+    final client = await UsageQueryClient.connect(server.endpointPath);
+
+    for (var i = 0; i < 10; i++) {
+      await client.send([UsageQueryRequest.rangeTotal(i, d1, d2)]);
+    }
+    // 跨两个自然年：各加载一次。
+    expect(repo.loadRangeCalls, 2);
+
+    deltas.add({
+      day2: {'Photoshop.exe': const Duration(minutes: 5)},
+    });
+    final after = await client.send([UsageQueryRequest.rangeTotal(0, d2, d2)]);
+    expect(after.single.total, const Duration(minutes: 20));
+    expect(repo.loadRangeCalls, 2);
+
+    server.cache.invalidate();
+    await client.send([UsageQueryRequest.rangeTotal(0, d2, d2)]);
+    expect(repo.loadRangeCalls, 3);
+
+    await client.close();
+  });
+
+  test('load client reports latency percentiles without errors', () async {
+    final report = await runUsageQueryLoad(
+      endpointPath: server.endpointPath,
+      connections: 2,
+      batchesPerConnection: 200,
+      batchSize: 8,
+      pipelineDepth: 8,
+      today: day2,
+    );
+
+    expect(report.errors, 0);
+    expect(report.batches, 400);
+    expect(report.requests, 3200);
+    expect(report.p50, lessThanOrEqualTo(report.p99));
+    expect(report.p99, lessThanOrEqualTo(report.max));
+    // ignore: avoid_print
+    print('usage query load: $report');
+  });
+
+  test('tcp endpoint drops connections without the file token', () async {
+    final tcp = await UsageQueryServer.bind(
+      endpointPath: '${tempDir.path}/query.endpoint',
+      cache: UsageQueryCache(repository: repo, deltaStream: deltas.stream),
+      liveStatus: () => const LiveStatus(
+        appId: null,
+        sessionStart: null,
+        todayTotal: Duration.zero,
+        isIdle: false,
+        isTracking: false,
+      ),
+      loopbackTcp: true,
+    );
+    final parts = File(tcp.endpointPath).readAsStringSync().split(':');
+    expect(parts, hasLength(4));
+    expect(parts[3], matches(RegExp(r'^[0-9a-f]{64}$')));
+
+    final client = await UsageQueryClient.connect(tcp.endpointPath);
+    final reply = await client.send([UsageQueryRequest.rangeTotal(1, d2, d2)]);
+    expect(reply.single.total, const Duration(minutes: 15));
+    await client.close();
+
+    final request = encodeUsageQueryRequests([
+      UsageQueryRequest.rangeTotal(1, d1, d2),
+    ]);
+    for (final auth in [<int>[], encodeUsageQueryAuth('0' * 64)]) {
+      final raw = await Socket.connect(parts[1], int.parse(parts[2]));
+      raw.add([...auth, ...request]);
+      // 不回复任何数据，直接断开（可能表现为连接被重置）。
+      var received = 0;
+      try {
+        await for (final chunk in raw) {
+          received += chunk.length;
+        }
+      } on SocketException catch (_) {}
+      expect(received, 0);
+      raw.destroy();
+    }
+
+    await tcp.close();
+  });
+}
@@ -0,0 +1,204 @@
+import 'dart:async';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/process_activity_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+import 'package:ringotrack/platform/tick_scheduler.dart';
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+class _FakeProcessActivityTracker implements ProcessActivityTracker {
+  bool busy = true;
+  int queries = 0;
+
+  @override
+  ProcessActivity queryForeground() {
+    queries++;
+    return busy
+        ? const ProcessActivity(isBusy: true, cpuFraction: 0.9)
+        : ProcessActivity.quiet;
+  }
+
+  @override
+  void dispose() {}
+}
+
+Map<String, Duration> _sumByApp(
+  Map<DateTime, Map<int, Map<String, Duration>>> usage,
+) {
+  final totals = <String, Duration>{};
+  for (final perHour in usage.values) {
+    for (final perApp in perHour.values) {
+      perApp.forEach((appId, duration) {
+        totals[appId] = (totals[appId] ?? Duration.zero) + duration;
+      });
+    }
+  }
+  return totals;
+}
+
+void main() {
+  late AppDatabase db;
+  late SqliteUsageRepository repo;
+  late _TestForegroundAppTracker tracker;
+  late _FakeProcessActivityTracker activity;
+
+  UsageService createService({required Duration idleThreshold}) {
+    return UsageService(
+      isDrawingApp: (id) => id == 'photoshop.exe' || id == 'krita.exe',
+      repository: repo,
+      busyRepository: repo,
+      activityTracker: activity,
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      scheduler: TickScheduler(
+        activeInterval: const Duration(milliseconds: 100),
+        backgroundInterval: const Duration(milliseconds: 100),
+        idleInterval: const Duration(milliseconds: 100),
+      ),
+      idleThreshold: idleThreshold,
+      dbFlushInterval: Duration.zero,
+    );
+  }
+
+  Future<Map<String, Duration>> loadBusy() async {
+    final today = DateTime.now();
+    return _sumByApp(
+      await repo.loadHourlyBusyRange(
+        today.subtract(const Duration(days: 1)),
+        today.add(const Duration(days: 1)),
+      ),
+    );
+  }
+
+  setUp(() {
+    db = AppDatabase.forTesting(NativeDatabase.memory());
+    repo = SqliteUsageRepository(db);
+    tracker = _TestForegroundAppTracker();
+    activity = _FakeProcessActivityTracker();
+  });
+
+  tearDown(() async {
+    tracker.dispose();
+    await db.close();
+  });
+
+  test('records busy time of the foreground app while idle', () async {
+    final service = createService(
+      idleThreshold: const Duration(milliseconds: 300),
+    );
+    tracker.emit(
+      ForegroundAppEvent(appId: 'photoshop.exe', timestamp: DateTime.now()),
+    );
+
+    // 0.3s 后进入 Idle，之后的时长都记给仍在忙碌的前台应用。
+    await Future<void>.delayed(const Duration(milliseconds: 2800));
+    await service.close();
+
+    final busy = await loadBusy();
+    expect(busy.keys, ['photoshop.exe']);
+    expect(busy['photoshop.exe']!.inSeconds, inInclusiveRange(1, 3));
+
+    // 忙碌时长不计入前台使用时长。
+    final today = DateTime.now();
+    final foreground = _sumByApp(
+      await repo.loadHourlyRange(
+        today.subtract(const Duration(days: 1)),
+        today.add(const Duration(days: 1)),
+      ),
+    );
+    expect(
+      foreground['photoshop.exe'] ?? Duration.zero,
+      lessThanOrEqualTo(const Duration(seconds: 1)),
+    );
+  });
+
+  test('quiet or untracked foreground apps record nothing', () async {
+    activity.busy = false;
+    final service = createService(
+      idleThreshold: const Duration(milliseconds: 300),
+    );
+    tracker.emit(
+      ForegroundAppEvent(appId: 'photoshop.exe', timestamp: DateTime.now()),
+    );
+    await Future<void>.delayed(const Duration(milliseconds: 1200));
+    expect(activity.queries, greaterThan(0));
+
+    activity.busy = true;
+    tracker.emit(
+      ForegroundAppEvent(appId: 'chrome.exe', timestamp: DateTime.now()),
+    );
+    await Future<void>.delayed(const Duration(milliseconds: 1200));
+    await service.close();
+
+    expect(await loadBusy(), isEmpty);
+  });
+
+  test('no sampling while the user is active', () async {
+    final service = createService(idleThreshold: const Duration(minutes: 60));
+    tracker.emit(
+      ForegroundAppEvent(appId: 'photoshop.exe', timestamp: DateTime.now()),
+    );
+    await Future<void>.delayed(const Duration(milliseconds: 1200));
+    await service.close();
+
+    expect(activity.queries, 0);
+    expect(await loadBusy(), isEmpty);
+  });
+
+  test('busy usage merges, loads and is deleted with the app', () async {
+    final day = DateTime(2025, 3, 1);
+    for (var i = 0; i < 2; i++) {
+      await repo.mergeHourlyBusyUsage({
+        day: {
+          22: {'blender.exe': const Duration(minutes: 25)},
+        },
+      });
+    }
+    expect(
+      (await repo.loadHourlyBusyRange(day, day))[day]![22]!['blender.exe'],
+      const Duration(minutes: 50),
+    );
+
+    await repo.deleteByDateRange(day, day);
+    expect(await repo.loadHourlyBusyRange(day, day), isEmpty);
+
+    await repo.mergeHourlyBusyUsage({
+      day: {
+        22: {'blender.exe': const Duration(minutes: 1)},
+      },
+    });
+    await repo.deleteByAppId('blender.exe');
+    expect(await repo.loadHourlyBusyRange(day, day), isEmpty);
+  });
+}
@@ -0,0 +1,171 @@
+import 'dart:async';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/document_usage.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+Map<String, Duration> _sumByKey(
+  Map<DateTime, Map<int, Map<String, Duration>>> usage,
+) {
+  final totals = <String, Duration>{};
+  for (final perHour in usage.values) {
+    for (final perKey in perHour.values) {
+      perKey.forEach((key, duration) {
+        totals[key] = (totals[key] ?? Duration.zero) + duration;
+      });
+    }
+  }
+  return totals;
+}
+
+void main() {
+  late AppDatabase db;
+  late SqliteUsageRepository repo;
+  late _TestForegroundAppTracker tracker;
+  late UsageService service;
+
+  setUp(() {
+    db = AppDatabase.forTesting(NativeDatabase.memory());
+    repo = SqliteUsageRepository(db);
+    tracker = _TestForegroundAppTracker();
+    service = UsageService(
+      isDrawingApp: (id) => id == 'photoshop.exe',
+      repository: repo,
+      documentRepository: repo,
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      idleThreshold: const Duration(minutes: 60),
+      dbFlushInterval: Duration.zero,
+    );
+  });
+
+  tearDown(() async {
+    tracker.dispose();
+    await db.close();
+  });
+
+  test('splits drawing time by document and skips untracked apps', () async {
+    // 取整到秒：区间跨整点切分时不会留下不足 1 秒的余数。
+    final now = DateTime.now();
+    final start = DateTime(
+      now.year,
+      now.month,
+      now.day,
+      now.hour,
+      now.minute,
+      now.second,
+    ).subtract(const Duration(minutes: 30));
+    tracker
+      ..emit(
+        ForegroundAppEvent(
+          appId: 'photoshop.exe',
+          timestamp: start,
+          document: 'cover.psd',
+        ),
+      )
+      // 同一应用内切换画布。
+      ..emit(
+        ForegroundAppEvent(
+          appId: 'photoshop.exe',
+          timestamp: start.add(const Duration(minutes: 10)),
+          document: 'sketch.psd',
+        ),
+      )
+      // 没有匹配到文档名：只计入应用维度。
+      ..emit(
+        ForegroundAppEvent(
+          appId: 'photoshop.exe',
+          timestamp: start.add(const Duration(minutes: 15)),
+        ),
+      )
+      ..emit(
+        ForegroundAppEvent(
+          appId: 'chrome.exe',
+          timestamp: start.add(const Duration(minutes: 20)),
+          document: 'reference',
+        ),
+      );
+
+    await Future<void>.delayed(Duration.zero);
+    await service.close();
+
+    final day = DateTime(start.year, start.month, start.day);
+    final documents = _sumByKey(
+      await repo.loadHourlyDocumentRange(
+        day.subtract(const Duration(days: 1)),
+        day.add(const Duration(days: 1)),
+      ),
+    );
+    expect(documents, {
+      documentUsageKey('photoshop.exe', 'cover.psd'): const Duration(
+        minutes: 10,
+      ),
+      documentUsageKey('photoshop.exe', 'sketch.psd'): const Duration(
+        minutes: 5,
+      ),
+    });
+
+    final apps = _sumByKey(
+      await repo.loadHourlyRange(
+        day.subtract(const Duration(days: 1)),
+        day.add(const Duration(days: 1)),
+      ),
+    );
+    expect(apps['photoshop.exe'], const Duration(minutes: 20));
+  });
+
+  test('document ids are interned once and survive repeated merges', () async {
+    final day = DateTime(2025, 3, 1);
+    final key = documentUsageKey('krita.exe', 'lineart.kra');
+    for (var i = 0; i < 3; i++) {
+      await repo.mergeHourlyDocumentUsage({
+        day: {
+          9: {key: const Duration(minutes: 5)},
+        },
+      });
+    }
+
+    final rows = await db
+        .customSelect('SELECT COUNT(*) AS c FROM document_dictionary')
+        .getSingle();
+    expect(rows.read<int>('c'), 1);
+
+    final loaded = await repo.loadHourlyDocumentRange(day, day);
+    expect(loaded[day]![9]![key], const Duration(minutes: 15));
+
+    await repo.deleteByAppId('krita.exe');
+    expect(await repo.loadHourlyDocumentRange(day, day), isEmpty);
+  });
+}
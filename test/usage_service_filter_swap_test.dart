@@ -0,0 +1,149 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/settings/drawing_app/models/drawing_app_preferences.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+
+class _RecordingUsageRepository implements UsageRepository {
+  final totals = <String, Duration>{};
+  int mergeCalls = 0;
+
+  @override
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {};
+  }
+
+  @override
+  Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {
+    mergeCalls++;
+    for (final perApp in delta.values) {
+      perApp.forEach((appId, duration) {
+        totals[appId] = (totals[appId] ?? Duration.zero) + duration;
+      });
+    }
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {};
+  }
+
+  @override
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {}
+
+  @override
+  Future<void> deleteByAppId(String appId) async {}
+
+  @override
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {}
+
+  @override
+  Future<void> clearAll() async {}
+}
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+void main() {
+  late _RecordingUsageRepository repo;
+  late _TestForegroundAppTracker tracker;
+  late UsageService service;
+
+  setUp(() {
+    repo = _RecordingUsageRepository();
+    tracker = _TestForegroundAppTracker();
+    service = UsageService(
+      isDrawingApp: AppMatcher.fromIds(['photoshop.exe']),
+      repository: repo,
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      idleThreshold: const Duration(minutes: 60),
+      // 足够长：close 之前不会因为时间到了而落库。
+      dbFlushInterval: const Duration(hours: 1),
+    );
+  });
+
+  tearDown(() {
+    tracker.dispose();
+  });
+
+  test('repeated filter edits keep accounting continuous', () async {
+    final start = DateTime.now().subtract(const Duration(minutes: 30));
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: start));
+    expect(service.liveStatus.sessionStart, start);
+
+    // 模拟设置页里反复增删应用：每次都保留 Photoshop。
+    for (var i = 0; i < 20; i++) {
+      service.updateFilter(
+        i.isEven
+            ? AppMatcher.fromIds(['photoshop.exe', 'krita.exe'])
+            : AppMatcher.fromIds(['photo*.exe']),
+      );
+      expect(service.liveStatus.isTracking, isTrue);
+      expect(service.liveStatus.sessionStart, start);
+    }
+
+    // 替换过滤器本身不落库。
+    await Future<void>.delayed(Duration.zero);
+    expect(repo.mergeCalls, 0);
+
+    await service.close();
+    expect(repo.mergeCalls, 1);
+    expect(
+      repo.totals['Photoshop.exe']!.inSeconds,
+      closeTo(const Duration(minutes: 30).inSeconds, 2),
+    );
+  });
+
+  test('removing the foreground app stops counting from the edit', () async {
+    final start = DateTime.now().subtract(const Duration(minutes: 10));
+    tracker.emit(ForegroundAppEvent(appId: 'photoshop.exe', timestamp: start));
+
+    service.updateFilter(AppMatcher.fromIds(['krita.exe']));
+    expect(service.liveStatus.isTracking, isFalse);
+    expect(service.liveStatus.sessionStart, isNull);
+
+    // 1 秒后的 tick 不应再把时间记给 Photoshop。
+    await Future<void>.delayed(const Duration(milliseconds: 1200));
+    await service.close();
+    expect(
+      repo.totals['photoshop.exe']!.inSeconds,
+      closeTo(const Duration(minutes: 10).inSeconds, 2),
+    );
+  });
+}
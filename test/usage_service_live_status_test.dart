@@ -0,0 +1,162 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/live_status_publisher.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+
+class _BaselineUsageRepository implements UsageRepository {
+  _BaselineUsageRepository(this.todayBaseline);
+
+  final Duration todayBaseline;
+
+  @override
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {
+      start: {'Photoshop.exe': todayBaseline},
+    };
+  }
+
+  @override
+  Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {}
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {};
+  }
+
+  @override
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {}
+
+  @override
+  Future<void> deleteByAppId(String appId) async {}
+
+  @override
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {}
+
+  @override
+  Future<void> clearAll() async {}
+}
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+class _RecordingLiveStatusPublisher implements LiveStatusPublisher {
+  final published = <LiveStatus>[];
+
+  @override
+  void publish(LiveStatus status) {
+    published.add(status);
+  }
+
+  @override
+  void dispose() {}
+}
+
+void main() {
+  test('UsageService publishes live status on state changes', () async {
+    final tracker = _TestForegroundAppTracker();
+    final publisher = _RecordingLiveStatusPublisher();
+
+    final service = UsageService(
+      isDrawingApp: (id) => id == 'Photoshop.exe',
+      repository: _BaselineUsageRepository(const Duration(minutes: 30)),
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      liveStatusPublisher: publisher,
+      idleThreshold: const Duration(minutes: 60),
+      dbFlushInterval: Duration.zero,
+    );
+
+    // 等待今日基线加载完成。
+    await Future<void>.delayed(Duration.zero);
+    expect(publisher.published.last.todayTotal, const Duration(minutes: 30));
+
+    final end = DateTime.now();
+    final start = end.subtract(const Duration(minutes: 10));
+
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: start));
+    final drawing = publisher.published.last;
+    expect(drawing.appId, 'Photoshop.exe');
+    expect(drawing.isTracking, isTrue);
+    expect(drawing.isIdle, isFalse);
+    expect(drawing.sessionStart, start);
+
+    tracker.emit(ForegroundAppEvent(appId: 'Browser', timestamp: end));
+    await Future<void>.delayed(Duration.zero);
+
+    final browsing = publisher.published.last;
+    expect(browsing.isTracking, isFalse);
+    expect(browsing.sessionStart, isNull);
+
+    final status = service.liveStatus;
+    expect(status.appId, 'Browser');
+    expect(status.todayTotal.inMinutes, closeTo(40, 1));
+
+    await service.close();
+    tracker.dispose();
+  });
+
+  test('liveStatusStream skips statuses that did not change', () async {
+    final tracker = _TestForegroundAppTracker();
+    final service = UsageService(
+      isDrawingApp: (id) => id == 'Photoshop.exe',
+      repository: _BaselineUsageRepository(const Duration(minutes: 30)),
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      idleThreshold: const Duration(minutes: 60),
+      dbFlushInterval: Duration.zero,
+    );
+    await Future<void>.delayed(Duration.zero);
+
+    final statuses = <LiveStatus>[];
+    final subscription = service.liveStatusStream.listen(statuses.add);
+
+    final at = DateTime.now();
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: at));
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: at));
+    await Future<void>.delayed(Duration.zero);
+
+    expect(statuses, hasLength(1));
+    expect(statuses.single.appId, 'Photoshop.exe');
+    expect(statuses.single.todayTotal, const Duration(minutes: 30));
+
+    await subscription.cancel();
+    await service.close();
+    tracker.dispose();
+  });
+}
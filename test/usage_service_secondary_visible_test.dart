@@ -0,0 +1,165 @@
+import 'dart:async';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+import 'package:ringotrack/platform/window_visibility_tracker.dart';
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+class _FakeWindowVisibilityTracker implements WindowVisibilityTracker {
+  List<VisibleApp> visible = const [];
+
+  @override
+  void setTrackedApps(Iterable<String> appIds, {bool trackAll = false}) {}
+
+  @override
+  List<VisibleApp> queryVisibleApps({double minFraction = 0.5}) => [
+    for (final app in visible)
+      if (app.visibleFraction >= minFraction) app,
+  ];
+
+  @override
+  void dispose() {}
+}
+
+Map<String, Duration> _sumByApp(
+  Map<DateTime, Map<int, Map<String, Duration>>> usage,
+) {
+  final totals = <String, Duration>{};
+  for (final perHour in usage.values) {
+    for (final perApp in perHour.values) {
+      perApp.forEach((appId, duration) {
+        totals[appId] = (totals[appId] ?? Duration.zero) + duration;
+      });
+    }
+  }
+  return totals;
+}
+
+void main() {
+  late AppDatabase db;
+  late SqliteUsageRepository repo;
+  late _TestForegroundAppTracker tracker;
+  late _FakeWindowVisibilityTracker visibility;
+  late UsageService service;
+
+  setUp(() {
+    db = AppDatabase.forTesting(NativeDatabase.memory());
+    repo = SqliteUsageRepository(db);
+    tracker = _TestForegroundAppTracker();
+    visibility = _FakeWindowVisibilityTracker();
+    service = UsageService(
+      isDrawingApp: (id) => id == 'photoshop.exe' || id == 'krita.exe',
+      repository: repo,
+      secondaryRepository: repo,
+      visibilityTracker: visibility,
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      idleThreshold: const Duration(minutes: 60),
+      dbFlushInterval: Duration.zero,
+    );
+  });
+
+  tearDown(() async {
+    tracker.dispose();
+    await db.close();
+  });
+
+  test('records visible tracked apps separately from foreground', () async {
+    visibility.visible = const [
+      VisibleApp(appId: 'krita.exe', visibleFraction: 1),
+      // 未统计的应用与遮挡过多的窗口都不计入。
+      VisibleApp(appId: 'chrome.exe', visibleFraction: 1),
+      VisibleApp(appId: 'photoshop.exe', visibleFraction: 0.2),
+    ];
+    tracker.emit(
+      ForegroundAppEvent(appId: 'photoshop.exe', timestamp: DateTime.now()),
+    );
+
+    // 第一个 tick 只建立采样起点，之后每个 tick 累计一个间隔。
+    await Future<void>.delayed(const Duration(milliseconds: 3200));
+    await service.close();
+
+    final today = DateTime.now();
+    final start = today.subtract(const Duration(days: 1));
+    final end = today.add(const Duration(days: 1));
+    final secondary = _sumByApp(
+      await repo.loadHourlySecondaryRange(start, end),
+    );
+    expect(secondary.keys, ['krita.exe']);
+    expect(secondary['krita.exe']!.inSeconds, inInclusiveRange(1, 3));
+
+    // 副屏时长不进入前台统计。
+    final foreground = _sumByApp(await repo.loadHourlyRange(start, end));
+    expect(foreground.containsKey('krita.exe'), isFalse);
+  });
+
+  test('detaching the tracker stops sampling', () async {
+    visibility.visible = const [
+      VisibleApp(appId: 'krita.exe', visibleFraction: 1),
+    ];
+    service.updateVisibilityTracker(null);
+
+    await Future<void>.delayed(const Duration(milliseconds: 2200));
+    await service.close();
+
+    final today = DateTime.now();
+    expect(await repo.loadHourlySecondaryRange(today, today), isEmpty);
+  });
+
+  test('secondary usage merges, loads and is deleted with the app', () async {
+    final day = DateTime(2025, 3, 1);
+    for (var i = 0; i < 2; i++) {
+      await repo.mergeHourlySecondaryUsage({
+        day: {
+          14: {'krita.exe': const Duration(minutes: 7)},
+        },
+      });
+    }
+    expect(
+      (await repo.loadHourlySecondaryRange(day, day))[day]![14]!['krita.exe'],
+      const Duration(minutes: 14),
+    );
+
+    await repo.deleteByDateRange(day, day);
+    expect(await repo.loadHourlySecondaryRange(day, day), isEmpty);
+
+    await repo.mergeHourlySecondaryUsage({
+      day: {
+        14: {'krita.exe': const Duration(minutes: 1)},
+      },
+    });
+    await repo.deleteByAppId('krita.exe');
+    expect(await repo.loadHourlySecondaryRange(day, day), isEmpty);
+  });
+}
@@ -0,0 +1,234 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/models/usage_models.dart';
+import 'package:ringotrack/feature/usage/repositories/usage_repository.dart';
+import 'package:ringotrack/feature/usage/services/usage_service.dart';
+import 'package:ringotrack/platform/foreground_app_tracker.dart';
+import 'package:ringotrack/platform/session_state_tracker.dart';
+import 'package:ringotrack/platform/stroke_activity_tracker.dart';
+
+class _RecordingUsageRepository implements UsageRepository {
+  Duration total = Duration.zero;
+
+  @override
+  Future<Map<DateTime, Map<String, Duration>>> loadRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {};
+  }
+
+  @override
+  Future<void> mergeUsage(Map<DateTime, Map<String, Duration>> delta) async {
+    for (final perApp in delta.values) {
+      total += perApp['Photoshop.exe'] ?? Duration.zero;
+    }
+  }
+
+  @override
+  Future<Map<DateTime, Map<int, Map<String, Duration>>>> loadHourlyRange(
+    DateTime start,
+    DateTime end,
+  ) async {
+    return {};
+  }
+
+  @override
+  Future<void> mergeHourlyUsage(
+    Map<DateTime, Map<int, Map<String, Duration>>> delta,
+  ) async {}
+
+  @override
+  Future<void> deleteByAppId(String appId) async {}
+
+  @override
+  Future<void> deleteByDateRange(DateTime start, DateTime end) async {}
+
+  @override
+  Future<void> clearAll() async {}
+}
+
+class _TestForegroundAppTracker implements ForegroundAppTracker {
+  final _controller = StreamController<ForegroundAppEvent>.broadcast(
+    sync: true,
+  );
+
+  @override
+  Stream<ForegroundAppEvent> get events => _controller.stream;
+
+  void emit(ForegroundAppEvent event) {
+    _controller.add(event);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+class _TestStrokeActivityTracker implements StrokeActivityTracker {
+  @override
+  Stream<StrokeEvent> get strokes => const Stream<StrokeEvent>.empty();
+
+  @override
+  void dispose() {}
+}
+
+/// 模拟 Windows：事件先进入队列，只有 poll() 时才派发。
+class _QueuedSessionStateTracker implements SessionStateTracker {
+  final _controller = StreamController<SessionEvent>.broadcast(sync: true);
+  final _queue = <SessionEvent>[];
+  int pollCount = 0;
+
+  void enqueue(SessionEventKind kind, DateTime timestamp) {
+    _queue.add(SessionEvent(kind: kind, timestamp: timestamp));
+  }
+
+  @override
+  Stream<SessionEvent> get events => _controller.stream;
+
+  @override
+  void poll() {
+    pollCount++;
+    final pending = List.of(_queue);
+    _queue.clear();
+    pending.forEach(_controller.add);
+  }
+
+  @override
+  void dispose() {
+    unawaited(_controller.close());
+  }
+}
+
+void main() {
+  late _RecordingUsageRepository repo;
+  late _TestForegroundAppTracker tracker;
+  late _QueuedSessionStateTracker sessionTracker;
+  late UsageService service;
+
+  setUp(() {
+    repo = _RecordingUsageRepository();
+    tracker = _TestForegroundAppTracker();
+    sessionTracker = _QueuedSessionStateTracker();
+    service = UsageService(
+      isDrawingApp: (id) => id == 'Photoshop.exe',
+      repository: repo,
+      tracker: tracker,
+      strokeTracker: _TestStrokeActivityTracker(),
+      sessionTracker: sessionTracker,
+      idleThreshold: const Duration(minutes: 60),
+      dbFlushInterval: Duration.zero,
+    );
+  });
+
+  tearDown(() {
+    tracker.dispose();
+    sessionTracker.dispose();
+  });
+
+  test('suspend gap is not attributed to the foreground app', () async {
+    final now = DateTime.now();
+    final start = now.subtract(const Duration(hours: 3));
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: start));
+
+    sessionTracker
+      ..enqueue(SessionEventKind.suspend, start.add(const Duration(minutes: 10)))
+      ..enqueue(SessionEventKind.resume, now.subtract(const Duration(seconds: 5)))
+      // Windows 用户唤醒会再收到一次恢复通知。
+      ..enqueue(SessionEventKind.resume, now.subtract(const Duration(seconds: 4)));
+
+    // 等待下一次 tick：它必须先 poll 出休眠边界，再结算。
+    await Future<void>.delayed(const Duration(milliseconds: 1200));
+    expect(sessionTracker.pollCount, greaterThan(0));
+
+    await service.close();
+    expect(
+      repo.total.inSeconds,
+      closeTo(const Duration(minutes: 10, seconds: 6).inSeconds, 2),
+    );
+  });
+
+  test('lock and suspend stack; counting resumes after both clear', () async {
+    final now = DateTime.now();
+    final start = now.subtract(const Duration(hours: 2));
+    tracker.emit(ForegroundAppEvent(appId: 'Photoshop.exe', timestamp: start));
+
+    sessionTracker
+      ..enqueue(SessionEventKind.locked, start.add(const Duration(minutes: 1)))
+      ..enqueue(SessionEventKind.suspend, start.add(const Duration(minutes: 2)))
+      ..enqueue(SessionEventKind.resume, start.add(const Duration(minutes: 30)));
+    sessionTracker.poll();
+    expect(service.liveStatus.sessionStart, isNull);
+
+    // 锁屏期间切换前台：记住但不计时。
+    tracker.emit(
+      ForegroundAppEvent(
+        appId: 'Photoshop.exe',
+        timestamp: start.add(const Duration(minutes: 40)),
+      ),
+    );
+    sessionTracker
+      ..enqueue(SessionEventKind.unlocked, now.subtract(const Duration(minutes: 1)))
+      ..poll();
+    expect(service.liveStatus.isTracking, isTrue);
+    expect(
+      service.liveStatus.sessionStart,
+      now.subtract(const Duration(minutes: 1)),
+    );
+
+    await Future<void>.delayed(Duration.zero);
+    await service.close();
+    expect(repo.total.inSeconds, closeTo(60 + 60, 2));
+  });
+
+  test('parses logind signals from gdbus monitor output', () {
+    final self = logindSessionObjectPath('2');
+    expect(self, '/org/freedesktop/login1/session/_32');
+
+    expect(
+      parseLogindMonitorLine(
+        '/org/freedesktop/login1: '
+        'org.freedesktop.login1.Manager.PrepareForSleep (true,)',
+      ),
+      SessionEventKind.suspend,
+    );
+    expect(
+      parseLogindMonitorLine(
+        '/org/freedesktop/login1: '
+        'org.freedesktop.login1.Manager.PrepareForSleep (false,)',
+      ),
+      SessionEventKind.resume,
+    );
+    expect(
+      parseLogindMonitorLine(
+        '$self: org.freedesktop.login1.Session.Lock ()',
+        sessionPath: self,
+      ),
+      SessionEventKind.locked,
+    );
+    expect(
+      parseLogindMonitorLine(
+        '/org/freedesktop/login1/session/_35: '
+        'org.freedesktop.login1.Session.Unlock ()',
+        sessionPath: self,
+      ),
+      isNull,
+    );
+    expect(
+      parseLogindMonitorLine(
+        '$self: org.freedesktop.login1.Session.Unlock ()',
+        sessionPath: self,
+      ),
+      SessionEventKind.unlocked,
+    );
+    expect(
+      parseLogindMonitorLine(
+        "/org/freedesktop/login1: org.freedesktop.DBus.Properties."
+        "PropertiesChanged ('org.freedesktop.login1.Manager', {}, [])",
+      ),
+      isNull,
+    );
+  });
+}
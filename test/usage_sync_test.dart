@@ -0,0 +1,223 @@
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:drift/native.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/database/services/app_database.dart';
+import 'package:ringotrack/feature/database/services/usage_archive.dart';
+import 'package:ringotrack/feature/database/services/usage_sync.dart';
+import 'package:ringotrack/feature/usage/repositories/compact_usage_repository.dart';
+
+final _day = DateTime(2025, 3, 1);
+
+Map<DateTime, Map<int, Map<String, Duration>>> _hour(
+  int hour,
+  String appId,
+  int minutes,
+) => {
+  _day: {
+    hour: {appId: Duration(minutes: minutes)},
+  },
+};
+
+void main() {
+  late Directory folder;
+  late List<AppDatabase> dbs;
+  late List<UsageSync> syncs;
+
+  setUp(() async {
+    folder = await Directory.systemTemp.createTemp('ringotrack_sync_');
+    dbs = [
+      for (var i = 0; i < 3; i++)
+        AppDatabase.forTesting(NativeDatabase.memory()),
+    ];
+    syncs = [for (final db in dbs) UsageSync(db, folder, segmentEntries: 2)];
+  });
+
+  tearDown(() async {
+    for (final db in dbs) {
+      await db.close();
+    }
+    await folder.delete(recursive: true);
+  });
+
+  Future<void> syncAll() async {
+    for (final sync in syncs) {
+      await sync.sync();
+    }
+    // 第一轮先发布的设备还没看到之后发布的分段，再拉一次。
+    for (final sync in syncs) {
+      await sync.pull();
+    }
+  }
+
+  Future<Map<int, Map<String, Duration>>?> hoursOf(AppDatabase db) async =>
+      (await db.loadHourlyRange(_day, _day))[_day];
+
+  Future<Map<String, Duration>?> dailyOf(AppDatabase db) async =>
+      (await db.loadRange(_day, _day))[_day];
+
+  test('three devices converge to the sum of their contributions', () async {
+    await dbs[0].mergeHourlyUsage(_hour(9, 'Krita.exe', 30));
+    await dbs[0].mergeUsage({
+      _day: {'Krita.exe': const Duration(minutes: 30)},
+    });
+    await dbs[1].mergeHourlyUsage(_hour(9, 'Krita.exe', 20));
+    await dbs[1].mergeUsage({
+      _day: {'Krita.exe': const Duration(minutes: 20)},
+    });
+    await dbs[2].mergeHourlyUsage(_hour(21, 'Blender.exe', 10));
+    await dbs[2].mergeUsage({
+      _day: {'Blender.exe': const Duration(minutes: 10)},
+    });
+
+    await syncAll();
+
+    for (final db in dbs) {
+      expect(await hoursOf(db), {
+        9: {'Krita.exe': const Duration(minutes: 50)},
+        21: {'Blender.exe': const Duration(minutes: 10)},
+      });
+      expect(await dailyOf(db), {
+        'Krita.exe': const Duration(minutes: 50),
+        'Blender.exe': const Duration(minutes: 10),
+      });
+    }
+  });
+
+  test('repeated syncs are idempotent and only ship new changes', () async {
+    await dbs[0].mergeHourlyUsage({
+      _day: {
+        for (var hour = 0; hour < 5; hour++)
+          hour: {'Krita.exe': const Duration(minutes: 10)},
+      },
+    });
+    await syncAll();
+    final before = [for (final db in dbs) await hoursOf(db)];
+
+    for (var round = 0; round < 3; round++) {
+      final results = [for (final sync in syncs) await sync.sync()];
+      expect(results.map((r) => r.published), everyElement(0));
+      expect(results.map((r) => r.applied), everyElement(0));
+      expect([for (final db in dbs) await hoursOf(db)], before);
+    }
+
+    // 增量只包含改动过的键，值为本机分量的最新值。
+    await dbs[0].mergeHourlyUsage(_hour(4, 'Krita.exe', 5));
+    final result = await syncs[0].sync();
+    expect(result.published, 1);
+    expect((await syncs[1].sync()).applied, 1);
+    expect((await hoursOf(dbs[1]))![4], {
+      'Krita.exe': const Duration(minutes: 15),
+    });
+    expect((await hoursOf(dbs[1]))![3], {
+      'Krita.exe': const Duration(minutes: 10),
+    });
+  });
+
+  test('publishes only the local share of keys also synced in', () async {
+    await dbs[0].mergeHourlyUsage(_hour(9, 'Krita.exe', 30));
+    await syncAll();
+    await dbs[1].mergeHourlyUsage(_hour(9, 'Krita.exe', 5));
+    await syncAll();
+    await syncAll();
+
+    for (final db in dbs) {
+      expect((await hoursOf(db))![9], {
+        'Krita.exe': const Duration(minutes: 35),
+      });
+    }
+  });
+
+  test('waits for missing segments before advancing the watermark', () async {
+    await dbs[0].mergeHourlyUsage({
+      _day: {
+        for (var hour = 0; hour < 4; hour++)
+          hour: {'Krita.exe': const Duration(minutes: 10)},
+      },
+    });
+    await syncs[0].publish();
+    final uuid = await syncs[0].localDeviceUuid();
+    final segments =
+        Directory('${folder.path}${Platform.pathSeparator}$uuid')
+            .listSync()
+            .whereType<File>()
+            .toList()
+          ..sort((a, b) => a.path.compareTo(b.path));
+    expect(segments, hasLength(2));
+    final first = await segments.first.readAsBytes();
+    await segments.first.delete();
+
+    expect((await syncs[1].pull()).applied, 0);
+    await segments.first.writeAsBytes(first);
+    expect((await syncs[1].pull()).applied, 4);
+  });
+
+  test('replace import below synced time never publishes negatives', () async {
+    await dbs[0].mergeHourlyUsage(_hour(9, 'Krita.exe', 30));
+    await dbs[1].mergeHourlyUsage(_hour(9, 'Krita.exe', 20));
+    await syncAll();
+
+    // 同步之前的备份：本机这一小时只有 10 分钟。
+    final backup = AppDatabase.forTesting(NativeDatabase.memory());
+    await backup.mergeHourlyUsage(_hour(9, 'Krita.exe', 10));
+    final bytes = <int>[];
+    await UsageArchive(backup).export().forEach(bytes.addAll);
+    await backup.close();
+    await UsageArchive(
+      dbs[1],
+    ).import(Stream.value(bytes), mode: UsageImportMode.replace);
+
+    // 合计不低于远端分量之和，本机分量为 0。
+    expect((await hoursOf(dbs[1]))![9], {
+      'Krita.exe': const Duration(minutes: 30),
+    });
+
+    await syncAll();
+    final segments = folder
+        .listSync(recursive: true)
+        .whereType<File>()
+        .where((file) => file.path.endsWith('.json'));
+    expect(segments, isNotEmpty);
+    for (final file in segments) {
+      final json = jsonDecode(file.readAsStringSync()) as Map<String, Object?>;
+      for (final entry in json['entries']! as List<Object?>) {
+        expect((entry! as List<Object?>).last! as int, greaterThan(0));
+      }
+    }
+    expect((await hoursOf(dbs[0]))![9], {
+      'Krita.exe': const Duration(minutes: 50),
+    });
+  });
+
+  test('synced time shows up with all-apps recording on', () async {
+    final repo = CompactUsageRepository(
+      dbs[1],
+      trackedFilter: () => (appId) => true,
+    );
+    await repo.mergeHourlyUsage(_hour(9, 'Krita.exe', 20));
+    // 旧小时表已导入过，之后的同步增量必须直接写入紧凑存储。
+    expect((await repo.loadHourlyRange(_day, _day))[_day]![9], {
+      'Krita.exe': const Duration(minutes: 20),
+    });
+
+    await dbs[0].mergeHourlyUsage(_hour(9, 'Krita.exe', 30));
+    await syncAll();
+    await syncAll();
+
+    expect((await repo.loadHourlyRange(_day, _day))[_day]![9], {
+      'Krita.exe': const Duration(minutes: 50),
+    });
+    expect((await repo.loadRange(_day, _day))[_day], {
+      'Krita.exe': const Duration(minutes: 50),
+    });
+    // 重新开启后按较大值对齐，不会重复计入。
+    final reopened = CompactUsageRepository(
+      dbs[1],
+      trackedFilter: () => (appId) => true,
+    );
+    expect((await reopened.loadHourlyRange(_day, _day))[_day]![9], {
+      'Krita.exe': const Duration(minutes: 50),
+    });
+  });
+}
@@ -0,0 +1,101 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ringotrack/feature/usage/models/usage_timeline.dart';
+
+void main() {
+  group('UsageTimeline', () {
+    final base = UsageTimeline.from({
+      DateTime(2024, 12, 31): {'photoshop.exe': const Duration(minutes: 30)},
+      DateTime(2025, 3, 1): {'photoshop.exe': const Duration(minutes: 10)},
+      DateTime(2025, 3, 2): {'sai.exe': const Duration(minutes: 5)},
+    });
+
+    test('behaves like a read-only map keyed by normalized days', () {
+      expect(base.length, 3);
+      expect(base.keys, [
+        DateTime(2024, 12, 31),
+        DateTime(2025, 3, 1),
+        DateTime(2025, 3, 2),
+      ]);
+      expect(base[DateTime(2025, 3, 1)], {
+        'photoshop.exe': const Duration(minutes: 10),
+      });
+      expect(base[DateTime(2025, 3, 1, 8)], isNull);
+      expect(base[DateTime(2025, 3, 3)], isNull);
+      expect(base.containsKey(DateTime(2025, 3, 2)), isTrue);
+
+      expect(() => base[DateTime(2025, 3, 3)] = {}, throwsUnsupportedError);
+      expect(
+        () => base[DateTime(2025, 3, 1)]!['sai.exe'] = Duration.zero,
+        throwsUnsupportedError,
+      );
+    });
+
+    test('shares untouched days and leaves the old version intact', () {
+      final next = base.withDelta({
+        DateTime(2025, 3, 1, 14, 5): {
+          'photoshop.exe': const Duration(seconds: 1),
+          'sai.exe': const Duration(seconds: 2),
+        },
+        DateTime(2025, 4, 1): {'sai.exe': const Duration(seconds: 3)},
+      });
+
+      expect(next.version, base.version + 1);
+      expect(next.length, 4);
+      expect(next[DateTime(2025, 3, 1)], {
+        'photoshop.exe': const Duration(minutes: 10, seconds: 1),
+        'sai.exe': const Duration(seconds: 2),
+      });
+      expect(next[DateTime(2025, 4, 1)], {
+        'sai.exe': const Duration(seconds: 3),
+      });
+      expect(
+        identical(next[DateTime(2025, 3, 2)], base[DateTime(2025, 3, 2)]),
+        isTrue,
+      );
+      expect(
+        identical(next[DateTime(2024, 12, 31)], base[DateTime(2024, 12, 31)]),
+        isTrue,
+      );
+
+      expect(base.length, 3);
+      expect(base[DateTime(2025, 3, 1)], {
+        'photoshop.exe': const Duration(minutes: 10),
+      });
+      expect(base[DateTime(2025, 4, 1)], isNull);
+    });
+
+    test('ignores out-of-range and empty deltas', () {
+      final next = base.withDelta(
+        {
+          DateTime(2024, 12, 31): {'sai.exe': const Duration(minutes: 1)},
+          DateTime(2025, 3, 2): const {},
+        },
+        start: DateTime(2025, 1, 1),
+        end: DateTime(2025, 12, 31),
+      );
+
+      expect(identical(next, base), isTrue);
+      expect(identical(base.withDelta(const {}), base), isTrue);
+    });
+  });
+
+  group('mergeHourlyDelta', () {
+    test('replaces touched hours and shares the rest', () {
+      final base = mergeHourlyDelta(const {}, {
+        9: {'photoshop.exe': const Duration(minutes: 20)},
+        10: {'photoshop.exe': const Duration(minutes: 5)},
+      });
+      final next = mergeHourlyDelta(base, {
+        10: {'sai.exe': const Duration(seconds: 1)},
+      });
+
+      expect(next[10], {
+        'photoshop.exe': const Duration(minutes: 5),
+        'sai.exe': const Duration(seconds: 1),
+      });
+      expect(identical(next[9], base[9]), isTrue);
+      expect(base[10], {'photoshop.exe': const Duration(minutes: 5)});
+      expect(() => next[11] = {}, throwsUnsupportedError);
+    });
+  });
+}
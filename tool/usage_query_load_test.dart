@@ -0,0 +1,35 @@
+// 查询端点压测客户端。
+//
+// 先以 RINGOTRACK_QUERY_SERVER=1（或某个路径）启动应用，然后：
+//   dart run tool/usage_query_load_test.dart [--endpoint PATH]
+//       [--connections 4] [--batches 1000] [--batch-size 8] [--depth 16]
+// 输出一行 JSON，包含吞吐与 p50 / p99 批延迟。
+import 'dart:io';
+
+import 'package:ringotrack/feature/query/services/usage_query_client.dart';
+import 'package:ringotrack/feature/query/services/usage_query_load.dart';
+
+Future<void> main(List<String> args) async {
+  final options = <String, String>{};
+  for (var i = 0; i + 1 < args.length; i += 2) {
+    if (!args[i].startsWith('--')) {
+      stderr.writeln('unexpected argument: ${args[i]}');
+      exit(64);
+    }
+    options[args[i].substring(2)] = args[i + 1];
+  }
+
+  final endpoint = options['endpoint'] ?? defaultUsageQueryEndpointPath();
+  int intOption(String name, int fallback) =>
+      int.tryParse(options[name] ?? '') ?? fallback;
+
+  final report = await runUsageQueryLoad(
+    endpointPath: endpoint,
+    connections: intOption('connections', 4),
+    batchesPerConnection: intOption('batches', 1000),
+    batchSize: intOption('batch-size', 8),
+    pipelineDepth: intOption('depth', 16),
+  );
+  stdout.writeln(report);
+  if (report.errors > 0) exitCode = 1;
+}
@@ -3,35 +3,22 @@
 #include <flutter_windows.h>
 #include <optional>
 #include <windowsx.h>
+#include <wtsapi32.h>
 
 #include "flutter/generated_plugin_registrant.h"
+#include "ringotrack/event_queue.h"
 
-// 来自 foreground_tracker_win.cpp：查询当前是否处于 pinned 模式。
-extern "C" int rt_is_pinned();
-// 查询当前是否处于锁定状态（lock 模式）。
-extern "C" int rt_is_locked();
+// 来自 foreground_tracker_win.cpp：与主窗口共用的 pinned 命中测试表。
+extern "C" std::int32_t rt_hit_test_is_draggable(std::int32_t x,
+                                                 std::int32_t y);
+// 记录会话锁定 / 休眠事件，kind 为 ringotrack::TrackerEventKind。
+extern "C" void rt_record_session_event(std::uint32_t kind);
+// 订阅 / 取消前台窗口标题变化事件。
+extern "C" void rt_install_title_hook();
+extern "C" void rt_uninstall_title_hook();
 
 namespace {
 
-double GetFlutterWindowScaleFactor(HWND hwnd) {
-  HMONITOR monitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-  if (monitor == nullptr) {
-    return 1.0;
-  }
-
-  const UINT dpi = FlutterDesktopGetDpiForMonitor(monitor);
-  if (dpi == 0) {
-    return 1.0;
-  }
-
-  return static_cast<double>(dpi) / 96.0;
-}
-
-int ScaleToDpiValue(int source, double scale_factor) {
-  const int scaled = static_cast<int>(source * scale_factor);
-  return scaled > 0 ? scaled : 1;
-}
-
 // 原始 Flutter View 窗口过程，用于在自定义处理后转发消息。
 WNDPROC g_flutter_view_wndproc = nullptr;
 
@@ -44,47 +31,13 @@ LRESULT CALLBACK FlutterViewWindowProc(HWND hwnd,
                                        LPARAM const lparam) {
   switch (message) {
     case WM_NCHITTEST: {
-      if (rt_is_pinned() && !rt_is_locked()) {
-        // 获取鼠标屏幕坐标
-        POINT screen_pos{GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)};
-
-        // 转换为客户区坐标
-        POINT client_pos = screen_pos;
-        ScreenToClient(hwnd, &client_pos);
-
-        RECT client_rect{};
-        GetClientRect(hwnd, &client_rect);
-
-        // 在右上角预留一块区域给 Flutter 内部的 pin 按钮点击
-        constexpr int kPinSafeWidthDip = 80;
-        constexpr int kPinSafeHeightDip = 80;
-        constexpr int kLockSafeWidthDip = 80;
-        constexpr int kLockSafeHeightDip = 80;
-        const double scale_factor = GetFlutterWindowScaleFactor(hwnd);
-        const int kPinSafeWidthScaled =
-            ScaleToDpiValue(kPinSafeWidthDip, scale_factor);
-        const int kPinSafeHeightScaled =
-            ScaleToDpiValue(kPinSafeHeightDip, scale_factor);
-        const int kLockSafeWidthScaled =
-            ScaleToDpiValue(kLockSafeWidthDip, scale_factor);
-        const int kLockSafeHeightScaled =
-            ScaleToDpiValue(kLockSafeHeightDip, scale_factor);
-        const bool in_pin_safe_region =
-            client_pos.x >= client_rect.right - kPinSafeWidthScaled &&
-            client_pos.x <= client_rect.right &&
-            client_pos.y >= client_rect.top &&
-            client_pos.y <= client_rect.top + kPinSafeHeightScaled;
-        const bool in_lock_safe_region =
-            client_pos.x >= client_rect.right - kLockSafeWidthScaled &&
-            client_pos.x <= client_rect.right &&
-            client_pos.y >= client_rect.bottom - kLockSafeHeightScaled &&
-            client_pos.y <= client_rect.bottom;
-
-        if (!in_pin_safe_region && !in_lock_safe_region) {
-          // 返回 HTTRANSPARENT，让系统将命中测试传递给父窗口，
-          // 父窗口会返回 HTCAPTION，从而触发系统原生拖动。
-          return HTTRANSPARENT;
-        }
+      // Flutter View 铺满主窗口客户区，两者的客户区坐标一致。
+      POINT client_pos{GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)};
+      ScreenToClient(hwnd, &client_pos);
+      if (rt_hit_test_is_draggable(client_pos.x, client_pos.y)) {
+        // 返回 HTTRANSPARENT，让系统将命中测试传递给父窗口，
+        // 父窗口会返回 HTCAPTION，从而触发系统原生拖动。
+        return HTTRANSPARENT;
       }
       break;
     }
@@ -97,6 +50,10 @@ LRESULT CALLBACK FlutterViewWindowProc(HWND hwnd,
   return DefWindowProc(hwnd, message, wparam, lparam);
 }
 
+void RecordSessionEvent(ringotrack::TrackerEventKind kind) {
+  rt_record_session_event(static_cast<std::uint32_t>(kind));
+}
+
 }  // namespace
 
 FlutterWindow::FlutterWindow(const flutter::DartProject& project)
@@ -138,10 +95,19 @@ bool FlutterWindow::OnCreate() {
       SetWindowLongPtr(flutter_view_hwnd, GWLP_WNDPROC,
                        reinterpret_cast<LONG_PTR>(FlutterViewWindowProc)));
 
+  // 订阅当前会话的锁屏 / 解锁通知（WM_WTSSESSION_CHANGE）。
+  ::WTSRegisterSessionNotification(GetHandle(), NOTIFY_FOR_THIS_SESSION);
+
+  // 前台窗口标题只在变化时获取，用于按文档统计。
+  rt_install_title_hook();
+
   return true;
 }
 
 void FlutterWindow::OnDestroy() {
+  rt_uninstall_title_hook();
+  ::WTSUnRegisterSessionNotification(GetHandle());
+
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
   }
@@ -167,6 +133,23 @@ FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
     case WM_FONTCHANGE:
       flutter_controller_->engine()->ReloadSystemFonts();
       break;
+    case WM_POWERBROADCAST:
+      // 唤醒时 PBT_APMRESUMEAUTOMATIC 总会到达，用户唤醒还会再收到
+      // PBT_APMRESUMESUSPEND；重复的恢复事件由消费方忽略。
+      if (wparam == PBT_APMSUSPEND) {
+        RecordSessionEvent(ringotrack::TrackerEventKind::kSystemSuspend);
+      } else if (wparam == PBT_APMRESUMEAUTOMATIC ||
+                 wparam == PBT_APMRESUMESUSPEND) {
+        RecordSessionEvent(ringotrack::TrackerEventKind::kSystemResume);
+      }
+      break;
+    case WM_WTSSESSION_CHANGE:
+      if (wparam == WTS_SESSION_LOCK) {
+        RecordSessionEvent(ringotrack::TrackerEventKind::kSessionLocked);
+      } else if (wparam == WTS_SESSION_UNLOCK) {
+        RecordSessionEvent(ringotrack::TrackerEventKind::kSessionUnlocked);
+      }
+      break;
   }
 
   return Win32Window::MessageHandler(hwnd, message, wparam, lparam);
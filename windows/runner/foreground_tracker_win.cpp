@@ -1,8 +1,28 @@
 #include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <windows.h>
 #include <dwmapi.h>
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ringotrack/app_interner.h"
+#include "ringotrack/clock.h"
+#include "ringotrack/event_queue.h"
+#include "ringotrack/hit_test_regions.h"
+#include "ringotrack/live_status.h"
+#include "ringotrack/metrics.h"
+#include "ringotrack/pin_state.h"
+#include "ringotrack/process_activity.h"
+#include "ringotrack/stroke_state.h"
+#include "ringotrack/title_rules.h"
+#include "ringotrack/tracked_app_set.h"
+#include "ringotrack/window_visibility.h"
+
 // 简单的前台窗口信息结构，用于 Dart FFI 映射。
 struct RtForegroundAppInfo {
   std::uint64_t timestamp_millis;  // 自 Unix epoch 起的毫秒数（本机时间）
@@ -10,7 +30,56 @@ struct RtForegroundAppInfo {
   std::int32_t is_error;           // 1 表示存在错误信息
   std::int32_t error_code;         // 具体错误码，含义见下方常量
   wchar_t exe_path[260];           // 可执行文件完整路径
-  wchar_t window_title[260];       // 窗口标题
+  wchar_t window_title[260];       // 窗口标题（来自标题变化事件的缓存）
+  std::uint32_t document_id;       // 进程内驻留的文档 ID，0 表示无
+  wchar_t document[260];           // 按提取规则从标题中得到的文档名
+  std::uint64_t changed_millis;    // 前台窗口或文档最近一次变化的时间，0 表示未知
+};
+
+// 实时状态输入缓冲区：Dart 侧直接写字段后调用 rt_publish_live_status 发布，
+// 避免跨 FFI 传递字符串时的内存分配。
+struct RtLiveStatusInput {
+  std::int64_t session_start_millis;  // 当前连续使用区间开始时间，0 表示无
+  std::int64_t today_total_millis;    // 今日累计使用时长
+  std::int32_t is_idle;               // 1 表示 AFK
+  std::int32_t is_tracking;           // 1 表示前台应用在统计列表里
+  char app_id[128];                   // UTF-8 appId，NUL 结尾
+};
+
+// 会话锁定 / 休眠事件，kind 取值与 ringotrack::TrackerEventKind 一致。
+struct RtSessionEvent {
+  std::int64_t timestamp_millis;  // 自 Unix epoch 起的毫秒数
+  std::uint32_t kind;
+  std::uint32_t reserved;
+};
+
+constexpr std::int32_t kRtSessionEventBufferSize = 64;
+
+constexpr std::size_t kRtTitleRulesInputSize = 8192;
+
+// 可见（非前台）的被跟踪应用，rt_query_visible_apps 的返回结构。
+constexpr std::int32_t kRtMaxVisibleApps = 16;
+constexpr std::size_t kRtVisibilityTrackedInputSize = 8192;
+
+struct RtVisibleApp {
+  char app_id[128];                 // UTF-8 appId，NUL 结尾
+  std::uint32_t visible_permille;   // 可见面积占比（千分比）
+  std::uint32_t reserved;
+};
+
+struct RtVisibleApps {
+  std::int32_t count;
+  std::uint32_t reserved;
+  RtVisibleApp apps[kRtMaxVisibleApps];
+};
+
+// 前台进程的 CPU 活动，rt_query_foreground_activity 的返回结构。
+struct RtProcessActivity {
+  std::int64_t busy_since_millis;  // 进入忙碌的时刻（Unix 毫秒），不忙时为 0
+  std::uint32_t pid;               // 前台进程 ID，没有前台窗口时为 0
+  std::uint32_t cpu_permille;      // 最近一个采样间隔的 CPU 占用（千分比）
+  std::int32_t is_busy;            // 1 表示处于忙碌区间
+  std::uint32_t reserved;
 };
 
 // 错误码约定，仅用于诊断日志，不影响基础功能
@@ -30,16 +99,18 @@ std::uint64_t GetCurrentUnixMillis() {
   ULARGE_INTEGER uli;
   uli.LowPart = ft.dwLowDateTime;
   uli.HighPart = ft.dwHighDateTime;
+  return ringotrack::FileTimeTicksToUnixMillis(uli.QuadPart);
+}
 
-  // FILETIME: 1601-01-01 起每 100ns 一个 tick
-  constexpr std::uint64_t EPOCH_DIFFERENCE = 116444736000000000ULL;
-  if (uli.QuadPart < EPOCH_DIFFERENCE) {
-    return 0;
-  }
+// 热路径计数器与延迟直方图，由 rt_read_metrics 整体快照给 Dart 侧。
+ringotrack::MetricsRegistry g_metrics;
+
+ringotrack::Counter& MetricCounter(ringotrack::CounterId id) {
+  return g_metrics.counter(id);
+}
 
-  const std::uint64_t ticks_since_unix_epoch = uli.QuadPart - EPOCH_DIFFERENCE;
-  const std::uint64_t millis = ticks_since_unix_epoch / 10000ULL;
-  return millis;
+ringotrack::LatencyHistogram& MetricHistogram(ringotrack::HistogramId id) {
+  return g_metrics.histogram(id);
 }
 
 }  // namespace
@@ -48,18 +119,19 @@ std::uint64_t GetCurrentUnixMillis() {
 
 namespace {
 
-std::atomic<std::uint64_t> g_last_left_click_millis{0};
+ringotrack::StrokeState g_stroke_state;
 HHOOK g_mouse_hook = nullptr;
-std::atomic<bool> g_left_button_down{false};
 
 LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
   if (nCode == HC_ACTION) {
+    // 只统计本回调自身的耗时，不含后续钩子（CallNextHookEx）。
+    ringotrack::ScopedLatency latency(
+        MetricHistogram(ringotrack::HistogramId::kMouseHook));
+    MetricCounter(ringotrack::CounterId::kMouseHookEvents).Increment();
     if (wParam == WM_LBUTTONDOWN) {
-      g_last_left_click_millis.store(GetCurrentUnixMillis(), std::memory_order_relaxed);
-      g_left_button_down.store(true, std::memory_order_relaxed);
+      g_stroke_state.OnButton(true, GetCurrentUnixMillis());
     } else if (wParam == WM_LBUTTONUP) {
-      g_last_left_click_millis.store(GetCurrentUnixMillis(), std::memory_order_relaxed);
-      g_left_button_down.store(false, std::memory_order_relaxed);
+      g_stroke_state.OnButton(false, GetCurrentUnixMillis());
     }
   }
   return ::CallNextHookEx(g_mouse_hook, nCode, wParam, lParam);
@@ -74,8 +146,7 @@ void InstallMouseHookIfNeeded() {
   g_mouse_hook = ::SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, module_handle, 0);
 
   // 初始化一次，避免 Dart 侧立即判定为 Idle
-  g_last_left_click_millis.store(GetCurrentUnixMillis(), std::memory_order_relaxed);
-  g_left_button_down.store(false, std::memory_order_relaxed);
+  g_stroke_state.Reset(GetCurrentUnixMillis());
 }
 
 void UninstallMouseHook() {
@@ -85,6 +156,153 @@ void UninstallMouseHook() {
   }
 }
 
+// ------------------- 全局按键活动（可选的 AFK 辅助来源） -------------------
+
+ringotrack::KeyActivityState g_key_activity;
+HHOOK g_keyboard_hook = nullptr;
+
+// 只记录「有按键按下」的时间：不读取 vkCode / scanCode，忽略抬起与注入事件。
+// 回调里只有一次 relaxed store，不做计时与计数，尽量不拖慢全局键盘输入。
+LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+  if (nCode == HC_ACTION && (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) &&
+      (reinterpret_cast<const KBDLLHOOKSTRUCT*>(lParam)->flags &
+       LLKHF_INJECTED) == 0) {
+    g_key_activity.OnKey(GetCurrentUnixMillis());
+  }
+  return ::CallNextHookEx(g_keyboard_hook, nCode, wParam, lParam);
+}
+
+}  // namespace
+
+// ------------------- 前台窗口标题 / 文档跟踪 -------------------
+
+namespace {
+
+constexpr int kTitleCapacity = 260;
+
+// 由标题事件回调（主线程）写入，rt_get_foreground_app（Dart 线程）读取。
+struct TitleCache {
+  HWND hwnd = nullptr;
+  wchar_t title[kTitleCapacity] = {};
+  ringotrack::DocumentId document_id = ringotrack::kNoDocument;
+  wchar_t document[kTitleCapacity] = {};
+  // 前台窗口切换或文档变化的时间：轮询间隔变长后仍能按真实切换时刻计时。
+  std::uint64_t changed_millis = 0;
+};
+
+// 保护 g_title_cache / g_title_rules / g_documents；只在标题变化与每秒轮询时
+// 各取一次，几乎没有竞争。
+std::mutex g_title_mutex;
+TitleCache g_title_cache;
+std::unique_ptr<ringotrack::TitleRuleSet> g_title_rules;
+ringotrack::AppInterner g_documents;
+char g_title_rules_input[kRtTitleRulesInputSize];
+
+// 以下仅在回调线程访问。
+HWINEVENTHOOK g_foreground_event_hook = nullptr;
+HWINEVENTHOOK g_name_change_hook = nullptr;
+HWND g_title_hwnd = nullptr;
+std::string g_title_app;
+
+std::string ToUtf8(const wchar_t* text, int length) {
+  if (length <= 0) {
+    return std::string();
+  }
+  const int size = ::WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0,
+                                         nullptr, nullptr);
+  std::string utf8(static_cast<std::size_t>(size > 0 ? size : 0), '\0');
+  if (size > 0) {
+    ::WideCharToMultiByte(CP_UTF8, 0, text, length, utf8.data(), size, nullptr,
+                          nullptr);
+  }
+  return utf8;
+}
+
+// 与 Dart 侧一致：exe 文件名转小写作为 appId，规则按它查找。
+std::string QueryAppIdForWindow(HWND hwnd) {
+  DWORD pid = 0;
+  ::GetWindowThreadProcessId(hwnd, &pid);
+  HANDLE process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (process == nullptr) {
+    MetricCounter(ringotrack::CounterId::kOpenProcessFailures).Increment();
+    return std::string();
+  }
+  wchar_t path[MAX_PATH] = {};
+  DWORD length = MAX_PATH;
+  const BOOL ok = ::QueryFullProcessImageNameW(process, 0, path, &length);
+  ::CloseHandle(process);
+  if (!ok) {
+    return std::string();
+  }
+
+  const wchar_t* name = path;
+  for (const wchar_t* p = path; *p != L'\0'; ++p) {
+    if (*p == L'\\' || *p == L'/') {
+      name = p + 1;
+    }
+  }
+  std::string app = ToUtf8(name, static_cast<int>(::wcslen(name)));
+  for (char& c : app) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return app;
+}
+
+// 取一次标题并按规则解析文档；只在前台切换与标题变化时调用。
+void RefreshTitle(HWND hwnd) {
+  wchar_t title[kTitleCapacity];
+  int length = ::GetWindowTextW(hwnd, title, kTitleCapacity);
+  if (length < 0) {
+    length = 0;
+  }
+  title[length] = L'\0';
+  const std::string utf8_title = ToUtf8(title, length);
+  const std::uint64_t now = GetCurrentUnixMillis();
+
+  std::lock_guard<std::mutex> lock(g_title_mutex);
+  if (g_title_cache.hwnd != hwnd) {
+    g_title_cache.hwnd = hwnd;
+    g_title_cache.changed_millis = now;
+  }
+  ::wmemcpy(g_title_cache.title, title, static_cast<std::size_t>(length) + 1);
+
+  const std::string_view doc =
+      g_title_rules ? g_title_rules->Extract(g_title_app, utf8_title)
+                    : std::string_view();
+  const ringotrack::DocumentId document_id =
+      doc.empty() ? ringotrack::kNoDocument : g_documents.Intern(doc);
+  if (document_id == g_title_cache.document_id) {
+    return;
+  }
+  g_title_cache.document_id = document_id;
+  g_title_cache.changed_millis = now;
+  const int converted =
+      doc.empty() ? 0
+                  : ::MultiByteToWideChar(CP_UTF8, 0, doc.data(),
+                                          static_cast<int>(doc.size()),
+                                          g_title_cache.document,
+                                          kTitleCapacity - 1);
+  g_title_cache.document[converted > 0 ? converted : 0] = L'\0';
+}
+
+void CALLBACK OnTitleEvent(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                           LONG id_object, LONG id_child, DWORD, DWORD) {
+  if (hwnd == nullptr || id_object != OBJID_WINDOW ||
+      id_child != CHILDID_SELF) {
+    return;
+  }
+  if (event == EVENT_SYSTEM_FOREGROUND) {
+    g_title_hwnd = hwnd;
+    g_title_app = QueryAppIdForWindow(hwnd);
+  } else if (hwnd != g_title_hwnd) {
+    // 后台窗口的标题变化（浏览器标签、进度条等）非常频繁，直接忽略。
+    return;
+  }
+  RefreshTitle(hwnd);
+}
+
 }  // namespace
 
 extern "C" {
@@ -93,6 +311,9 @@ extern "C" {
 // 每次调用都会覆盖内部缓存的内容。
 __declspec(dllexport) RtForegroundAppInfo* rt_get_foreground_app() {
   static RtForegroundAppInfo info;
+  ringotrack::ScopedLatency latency(
+      MetricHistogram(ringotrack::HistogramId::kForegroundQuery));
+  MetricCounter(ringotrack::CounterId::kForegroundQueries).Increment();
 
   ::ZeroMemory(&info, sizeof(info));
   info.timestamp_millis = GetCurrentUnixMillis();
@@ -103,6 +324,7 @@ __declspec(dllexport) RtForegroundAppInfo* rt_get_foreground_app() {
   if (hwnd == nullptr) {
     info.is_error = 1;
     info.error_code = RT_ERR_NO_FOREGROUND_WINDOW;
+    MetricCounter(ringotrack::CounterId::kNoForegroundWindow).Increment();
     return &info;
   }
 
@@ -114,6 +336,7 @@ __declspec(dllexport) RtForegroundAppInfo* rt_get_foreground_app() {
   if (process == nullptr) {
     info.is_error = 1;
     info.error_code = RT_ERR_OPEN_PROCESS_FAILED;
+    MetricCounter(ringotrack::CounterId::kOpenProcessFailures).Increment();
   } else {
     DWORD buffer_len = static_cast<DWORD>(sizeof(info.exe_path) / sizeof(wchar_t));
     DWORD copied_len = buffer_len;
@@ -121,49 +344,131 @@ __declspec(dllexport) RtForegroundAppInfo* rt_get_foreground_app() {
       info.exe_path[0] = L'\0';
       info.is_error = 1;
       info.error_code = RT_ERR_QUERY_PATH_FAILED;
+      MetricCounter(ringotrack::CounterId::kQueryPathFailures).Increment();
     }
 
     ::CloseHandle(process);
     process = nullptr;
   }
 
-  // 获取窗口标题（不论是否获取到路径，都尝试）
-  info.window_title[0] = L'\0';
-  const int title_capacity = static_cast<int>(sizeof(info.window_title) / sizeof(wchar_t));
-  const int title_len = ::GetWindowTextW(hwnd, info.window_title, title_capacity);
-  if (title_len <= 0) {
-    info.window_title[0] = L'\0';
-    if (info.error_code == RT_ERR_NONE) {
-      info.is_error = 1;
-      info.error_code = RT_ERR_GET_WINDOW_TITLE_FAILED;
+  // 标题与文档由标题变化事件维护，这里只拷贝缓存，不再每次轮询都取标题。
+  {
+    std::lock_guard<std::mutex> lock(g_title_mutex);
+    if (g_title_cache.hwnd == hwnd) {
+      ::wmemcpy(info.window_title, g_title_cache.title, kTitleCapacity);
+      info.document_id = g_title_cache.document_id;
+      ::wmemcpy(info.document, g_title_cache.document, kTitleCapacity);
+      info.changed_millis = g_title_cache.changed_millis;
     }
   }
 
   return &info;
 }
 
+// 由 flutter_window.cpp 在主窗口创建时调用：订阅前台切换与标题变化事件。
+// 必须在有消息循环的线程上调用（WINEVENT_OUTOFCONTEXT 回调投递到该线程）。
+void rt_install_title_hook() {
+  if (g_name_change_hook != nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_title_mutex);
+    if (!g_title_rules) {
+      g_title_rules = ringotrack::TitleRuleSet::Compile(
+          ringotrack::kDefaultTitleRules, nullptr);
+    }
+  }
+
+  constexpr DWORD kFlags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+  g_foreground_event_hook =
+      ::SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                        nullptr, OnTitleEvent, 0, 0, kFlags);
+  g_name_change_hook =
+      ::SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+                        nullptr, OnTitleEvent, 0, 0, kFlags);
+
+  // 安装前已在前台的窗口不会再收到 EVENT_SYSTEM_FOREGROUND，主动取一次。
+  const HWND hwnd = ::GetForegroundWindow();
+  if (hwnd != nullptr) {
+    OnTitleEvent(nullptr, EVENT_SYSTEM_FOREGROUND, hwnd, OBJID_WINDOW,
+                 CHILDID_SELF, 0, 0);
+  }
+}
+
+void rt_uninstall_title_hook() {
+  if (g_foreground_event_hook != nullptr) {
+    ::UnhookWinEvent(g_foreground_event_hook);
+    g_foreground_event_hook = nullptr;
+  }
+  if (g_name_change_hook != nullptr) {
+    ::UnhookWinEvent(g_name_change_hook);
+    g_name_change_hook = nullptr;
+  }
+}
+
+// 返回 Dart 侧写入文档提取规则（UTF-8 文本，格式见 title_rules.h）的静态缓冲区。
+__declspec(dllexport) char* rt_title_rules_input() {
+  return g_title_rules_input;
+}
+
+// 编译输入缓冲区中的规则并替换当前规则；下一次标题变化起生效。
+// 返回值：0 表示成功，否则为出错的行号（原规则保持不变）。
+__declspec(dllexport) std::int32_t rt_apply_title_rules() {
+  const std::size_t length =
+      ::strnlen(g_title_rules_input, sizeof(g_title_rules_input));
+  int error_line = 0;
+  auto rules = ringotrack::TitleRuleSet::Compile(
+      std::string_view(g_title_rules_input, length), &error_line);
+  if (!rules) {
+    return error_line > 0 ? error_line : 1;
+  }
+  std::lock_guard<std::mutex> lock(g_title_mutex);
+  g_title_rules = std::move(rules);
+  return 0;
+}
+
 // 初始化全局鼠标钩子，用于 AFK 检测。
 __declspec(dllexport) void rt_init_stroke_hook() { InstallMouseHookIfNeeded(); }
 
 // 获取最近一次左键按下的时间（Unix 毫秒，若未初始化则返回 0）。
 __declspec(dllexport) std::uint64_t rt_get_last_left_click_millis() {
-  return g_last_left_click_millis.load(std::memory_order_relaxed);
+  return g_stroke_state.last_stroke_millis();
 }
 
 // 左键是否按下
 __declspec(dllexport) std::uint32_t rt_is_left_button_down() {
-  return g_left_button_down.load(std::memory_order_relaxed) ? 1u : 0u;
+  return g_stroke_state.button_down() ? 1u : 0u;
 }
 
 // 可选的清理函数，当前未在 Dart 侧调用。
 __declspec(dllexport) void rt_shutdown_stroke_hook() { UninstallMouseHook(); }
 
+// 安装低级键盘 hook（重复调用无副作用）；需在有消息循环的线程上调用。
+__declspec(dllexport) void rt_init_keyboard_hook() {
+  if (g_keyboard_hook != nullptr) {
+    return;
+  }
+  g_keyboard_hook = ::SetWindowsHookExW(
+      WH_KEYBOARD_LL, LowLevelKeyboardProc, ::GetModuleHandleW(nullptr), 0);
+}
+
+// 最近一次按键的 Unix 毫秒时间，0 表示尚无按键。
+__declspec(dllexport) std::uint64_t rt_get_last_key_activity_millis() {
+  return g_key_activity.last_key_millis();
+}
+
+__declspec(dllexport) void rt_shutdown_keyboard_hook() {
+  if (g_keyboard_hook != nullptr) {
+    ::UnhookWindowsHookEx(g_keyboard_hook);
+    g_keyboard_hook = nullptr;
+  }
+}
+
 // ------------------- 窗口置顶 / 固定大小控制 -------------------
 
 namespace {
 
-std::atomic<bool> g_is_pinned{false};
-std::atomic<bool> g_is_locked{false};
+ringotrack::PinState g_pin_state;
 HWND g_pinned_hwnd = nullptr;
 WINDOWPLACEMENT g_prev_placement{};
 LONG g_prev_style = 0;
@@ -334,16 +639,9 @@ bool EnableGlassWithColor(COLORREF rgb, BYTE alpha) {
     return false;
   }
 
-  const BYTE r = GetRValue(rgb);
-  const BYTE g = GetGValue(rgb);
-  const BYTE b = GetBValue(rgb);
-
   // GradientColor: AARRGGBB，但 AccentPolicy 通常以 ABGR 形式解析。
-  const unsigned int gradient_color =
-      (static_cast<unsigned int>(alpha) << 24) |
-      (static_cast<unsigned int>(b) << 16) |
-      (static_cast<unsigned int>(g) << 8) |
-      static_cast<unsigned int>(r);
+  const unsigned int gradient_color = ringotrack::PackAccentGradientColor(
+      GetRValue(rgb), GetGValue(rgb), GetBValue(rgb), alpha);
 
   // 优先尝试 Acrylic，失败则回退到普通 BlurBehind，兼容 Win10 早期版本。
   if (ApplyAccentPolicy(hwnd, ACCENT_ENABLE_ACRYLICBLURBEHIND,
@@ -367,7 +665,7 @@ bool DisableGlass() {
 // 将当前窗口缩放到较小尺寸并置顶，便于作为「时钟挂件」悬浮。
 // 返回值：非 0 表示成功，0 表示失败（例如无法获取窗口句柄）。
 __declspec(dllexport) std::int32_t rt_enter_pinned_mode() {
-  if (g_is_pinned.load(std::memory_order_acquire)) {
+  if (g_pin_state.is_pinned()) {
     return 1;
   }
 
@@ -429,31 +727,31 @@ __declspec(dllexport) std::int32_t rt_enter_pinned_mode() {
   DwmSetWindowAttribute(hwnd, DWMWA_WINDOW_CORNER_PREFERENCE, &corner_pref,
                         sizeof(corner_pref));
 
-  g_is_pinned.store(true, std::memory_order_release);
+  g_pin_state.MarkPinned();
   return 1;
 }
 
 // 查询当前是否处于 pinned 模式。
 // 返回值：1 表示处于 pinned 模式，0 表示非 pinned 模式。
 __declspec(dllexport) std::int32_t rt_is_pinned() {
-  return g_is_pinned.load(std::memory_order_acquire) ? 1 : 0;
+  return g_pin_state.is_pinned() ? 1 : 0;
 }
 
 // 查询当前是否处于锁定状态。
 // 返回值：1 表示窗口已锁定，0 表示未锁定。
 __declspec(dllexport) std::int32_t rt_is_locked() {
-  return g_is_locked.load(std::memory_order_acquire) ? 1 : 0;
+  return g_pin_state.is_locked() ? 1 : 0;
 }
 
 // 退出置顶小窗模式，恢复窗口原有位置和大小。
 // 返回值：非 0 表示成功，0 表示失败。
 __declspec(dllexport) std::int32_t rt_exit_pinned_mode() {
-  if (!g_is_pinned.load(std::memory_order_acquire)) {
+  if (!g_pin_state.is_pinned()) {
     return 1;
   }
 
   if (g_pinned_hwnd == nullptr) {
-    g_is_pinned.store(false, std::memory_order_release);
+    g_pin_state.MarkUnpinned();
     return 0;
   }
 
@@ -492,12 +790,11 @@ __declspec(dllexport) std::int32_t rt_exit_pinned_mode() {
   DwmSetWindowAttribute(hwnd, DWMWA_WINDOW_CORNER_PREFERENCE,
                         &corner_pref_reset, sizeof(corner_pref_reset));
 
-  g_is_pinned.store(false, std::memory_order_release);
+  g_pin_state.MarkUnpinned();
   g_pinned_hwnd = nullptr;
   ::ZeroMemory(&g_prev_placement, sizeof(g_prev_placement));
   g_prev_style = 0;
   g_prev_ex_style = 0;
-  g_is_locked.store(false, std::memory_order_release);
 
   return 1;
 }
@@ -505,44 +802,82 @@ __declspec(dllexport) std::int32_t rt_exit_pinned_mode() {
 // 锁定窗口（禁止移动）
 // 返回值：非 0 表示成功，0 表示失败
 __declspec(dllexport) std::int32_t rt_lock_window() {
-  if (!g_is_pinned.load(std::memory_order_acquire)) {
-    return 0;  // 仅在pinned模式下允许锁定
-  }
-
-  if (g_is_locked.load(std::memory_order_acquire)) {
-    return 1;  // 已经锁定
-  }
-
   if (g_pinned_hwnd == nullptr) {
     return 0;
   }
 
   // 目前只需标记窗口处于锁定状态，拖拽行为由 hit-test 层检测。
-  g_is_locked.store(true, std::memory_order_release);
-  return 1;
+  // 仅在 pinned 模式下允许锁定。
+  return g_pin_state.Lock() ? 1 : 0;
 }
 
 // 解锁窗口（允许移动）
 // 返回值：非 0 表示成功，0 表示失败
 __declspec(dllexport) std::int32_t rt_unlock_window() {
-  if (!g_is_pinned.load(std::memory_order_acquire)) {
-    return 0;  // 仅在pinned模式下允许解锁
-  }
-
-  if (!g_is_locked.load(std::memory_order_acquire)) {
-    return 1;  // 已经解锁
-  }
-
   if (g_pinned_hwnd == nullptr) {
     return 0;
   }
 
-  if (g_pinned_hwnd == nullptr) {
+  // 仅在 pinned 模式下允许解锁。
+  return g_pin_state.Unlock() ? 1 : 0;
+}
+
+// ------------------- pinned 小窗命中测试 -------------------
+
+namespace {
+
+// 区域由 Dart（UI 线程）更新，在窗口过程（平台线程）中查询。
+std::mutex g_hit_test_mutex;
+ringotrack::HitTestRegions g_hit_test_regions;
+ringotrack::InteractiveRegion
+    g_interactive_regions_input[ringotrack::HitTestRegions::kMaxRegions];
+
+}  // namespace
+
+// 由 win32_window.cpp 在创建窗口与 WM_DPICHANGED 时调用，缓存缩放比例。
+void rt_hit_test_set_dpi(std::uint32_t dpi) {
+  std::lock_guard<std::mutex> lock(g_hit_test_mutex);
+  g_hit_test_regions.SetScale(dpi == 0 ? 1.0 : dpi / 96.0);
+}
+
+// 由 win32_window.cpp 在 WM_SIZE 时调用，缓存客户区尺寸（物理像素）。
+void rt_hit_test_set_client_size(std::int32_t width, std::int32_t height) {
+  std::lock_guard<std::mutex> lock(g_hit_test_mutex);
+  g_hit_test_regions.SetClientSize(width, height);
+}
+
+// 主窗口与 Flutter View 共用的命中测试：客户区坐标（物理像素）在 pinned、
+// 未锁定且不在任何交互区域时返回 1，表示该点用于拖动窗口。
+std::int32_t rt_hit_test_is_draggable(std::int32_t x, std::int32_t y) {
+  if (!g_pin_state.is_pinned() || g_pin_state.is_locked()) {
     return 0;
   }
+  std::lock_guard<std::mutex> lock(g_hit_test_mutex);
+  return g_hit_test_regions.InClient(x, y) &&
+                 !g_hit_test_regions.IsInteractive(x, y)
+             ? 1
+             : 0;
+}
 
-  g_is_locked.store(false, std::memory_order_release);
-  return 1;
+// 返回 Dart 侧写入交互区域的静态缓冲区，容量为 HitTestRegions::kMaxRegions。
+__declspec(dllexport) ringotrack::InteractiveRegion*
+rt_interactive_regions_input() {
+  return g_interactive_regions_input;
+}
+
+// 用输入缓冲区前 count 个区域替换命中测试表；count 为负时恢复默认的
+// 两个角落区域。返回值：非 0 表示成功，0 表示参数无效（原区域保持不变）。
+__declspec(dllexport) std::int32_t rt_apply_interactive_regions(
+    std::int32_t count) {
+  std::lock_guard<std::mutex> lock(g_hit_test_mutex);
+  if (count < 0) {
+    g_hit_test_regions.ResetToDefaults();
+    return 1;
+  }
+  return g_hit_test_regions.SetRegions(g_interactive_regions_input,
+                                       static_cast<std::size_t>(count))
+             ? 1
+             : 0;
 }
 
 // ------------------- 毛玻璃 tint 控制导出（Windows FFI） -------------------
@@ -571,4 +906,378 @@ __declspec(dllexport) std::int32_t rt_disable_glass() {
   return DisableGlass() ? 1 : 0;
 }
 
+// ------------------- 实时状态共享内存（供外部工具只读订阅） -------------------
+
+namespace {
+
+RtLiveStatusInput g_live_status_input{};
+std::unique_ptr<ringotrack::LiveStatusPublisher> g_live_status_publisher;
+bool g_live_status_create_failed = false;
+ringotrack::AppInterner g_live_status_apps;
+
+}  // namespace
+
+// 返回 Dart 侧写入实时状态的静态缓冲区。
+__declspec(dllexport) RtLiveStatusInput* rt_live_status_input() {
+  return &g_live_status_input;
+}
+
+// 将输入缓冲区中的内容发布到共享内存段（首次调用时创建）。
+// 返回值：非 0 表示成功，0 表示共享内存不可用。
+__declspec(dllexport) std::int32_t rt_publish_live_status() {
+  if (!g_live_status_publisher) {
+    if (g_live_status_create_failed) {
+      return 0;
+    }
+    g_live_status_publisher = ringotrack::LiveStatusPublisher::Create();
+    if (!g_live_status_publisher) {
+      g_live_status_create_failed = true;
+      return 0;
+    }
+  }
+
+  const RtLiveStatusInput& input = g_live_status_input;
+  ringotrack::LiveStatus status;
+  status.updated_at_millis = static_cast<std::int64_t>(GetCurrentUnixMillis());
+  status.session_start_millis = input.session_start_millis;
+  status.today_total_millis = input.today_total_millis;
+  status.is_idle = input.is_idle != 0;
+  status.is_tracking = input.is_tracking != 0;
+
+  const std::size_t len = ::strnlen(input.app_id, sizeof(input.app_id));
+  status.app_id =
+      len == 0 ? ringotrack::kNoApp
+               : g_live_status_apps.Intern(std::string_view(input.app_id, len));
+  std::memcpy(status.app_name, input.app_id,
+              len < sizeof(status.app_name) ? len : sizeof(status.app_name) - 1);
+
+  g_live_status_publisher->Publish(status);
+  return 1;
+}
+
+// ------------------- 会话锁定 / 休眠事件 -------------------
+
+namespace {
+
+// 生产者：主窗口过程（WM_POWERBROADCAST / WM_WTSSESSION_CHANGE）；
+// 消费者：Dart 侧每次 tick 前的 rt_drain_session_events。
+ringotrack::SpscQueue<ringotrack::TrackerEvent, 64> g_session_events;
+RtSessionEvent g_session_event_buffer[kRtSessionEventBufferSize];
+
+}  // namespace
+
+// 由 flutter_window.cpp 在收到系统通知时调用，记录精确的事件时间。
+void rt_record_session_event(std::uint32_t kind) {
+  // 队列满说明 Dart 侧长时间未消费，丢弃最新事件即可。
+  if (!g_session_events.TryPush(ringotrack::TrackerEvent{
+          static_cast<std::int64_t>(GetCurrentUnixMillis()),
+          static_cast<ringotrack::TrackerEventKind>(kind),
+          ringotrack::kNoApp})) {
+    MetricCounter(ringotrack::CounterId::kSessionEventsDropped).Increment();
+  }
+}
+
+// 返回 Dart 侧读取会话事件的静态缓冲区（kRtSessionEventBufferSize 项）。
+__declspec(dllexport) RtSessionEvent* rt_session_event_buffer() {
+  return g_session_event_buffer;
+}
+
+// 把待处理的会话事件拷入静态缓冲区，返回条数。
+__declspec(dllexport) std::int32_t rt_drain_session_events() {
+  ringotrack::ScopedLatency latency(
+      MetricHistogram(ringotrack::HistogramId::kSessionDrain));
+  ringotrack::TrackerEvent events[kRtSessionEventBufferSize];
+  const std::size_t count =
+      g_session_events.PopBatch(events, kRtSessionEventBufferSize);
+  for (std::size_t i = 0; i < count; ++i) {
+    g_session_event_buffer[i].timestamp_millis = events[i].timestamp_millis;
+    g_session_event_buffer[i].kind = static_cast<std::uint32_t>(events[i].kind);
+    g_session_event_buffer[i].reserved = 0;
+  }
+  MetricCounter(ringotrack::CounterId::kSessionEventsDrained).Increment(count);
+  return static_cast<std::int32_t>(count);
+}
+
+// ------------------- 多窗口可见性（副屏参考窗口） -------------------
+
+namespace {
+
+// 保护下列全部状态：窗口事件回调在主线程写入，rt_query_visible_apps 在
+// Dart 线程读取。
+std::mutex g_visibility_mutex;
+ringotrack::WindowVisibilityTracker g_visibility;
+ringotrack::AppInterner g_visibility_apps;
+char g_visibility_tracked_input[kRtVisibilityTrackedInputSize];
+std::vector<HWINEVENTHOOK> g_visibility_hooks;
+
+// 只跟踪可以被用户看到的普通顶层窗口。
+bool IsTrackableTopLevel(HWND hwnd) {
+  if (::GetAncestor(hwnd, GA_ROOT) != hwnd) {
+    return false;
+  }
+  const LONG_PTR ex_style = ::GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
+  // 点击穿透的透明层（录屏边框、通知动画等）不会遮挡下面的窗口。
+  return (ex_style & WS_EX_TRANSPARENT) == 0;
+}
+
+// 取 DWM 实际绘制的边框（不含 Win10+ 的透明缩放边），并判断是否真正显示：
+// 最小化、隐藏与被 cloak（其他虚拟桌面、UWP 挂起）的窗口都视为不可见。
+bool QueryWindowGeometry(HWND hwnd, ringotrack::WindowRect* rect) {
+  RECT bounds{};
+  if (FAILED(::DwmGetWindowAttribute(hwnd, DWMWA_EXTENDED_FRAME_BOUNDS,
+                                     &bounds, sizeof(bounds))) &&
+      !::GetWindowRect(hwnd, &bounds)) {
+    *rect = ringotrack::WindowRect{0, 0, 0, 0};
+    return false;
+  }
+  *rect = ringotrack::WindowRect{bounds.left, bounds.top, bounds.right,
+                                 bounds.bottom};
+  if (!::IsWindowVisible(hwnd) || ::IsIconic(hwnd)) {
+    return false;
+  }
+  DWORD cloaked = 0;
+  if (SUCCEEDED(::DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked,
+                                        sizeof(cloaked))) &&
+      cloaked != 0) {
+    return false;
+  }
+  return !rect->empty();
+}
+
+// 更新一个窗口；调用方持有 g_visibility_mutex。
+void RefreshVisibilityWindow(HWND hwnd) {
+  const auto handle = reinterpret_cast<std::uint64_t>(hwnd);
+  ringotrack::WindowRect rect;
+  const bool shown = QueryWindowGeometry(hwnd, &rect);
+  if (g_visibility.UpdateGeometry(handle, rect, shown) || !shown) {
+    return;
+  }
+  // 首次出现的窗口：查一次进程名后缓存，之后的位置变化不再打开进程。
+  const std::string app = QueryAppIdForWindow(hwnd);
+  g_visibility.Upsert(handle,
+                      app.empty() ? ringotrack::kNoApp
+                                  : g_visibility_apps.Intern(app),
+                      rect, shown);
+}
+
+void CALLBACK OnVisibilityEvent(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                                LONG id_object, LONG id_child, DWORD, DWORD) {
+  if (hwnd == nullptr || id_object != OBJID_WINDOW ||
+      id_child != CHILDID_SELF) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(g_visibility_mutex);
+  if (event == EVENT_OBJECT_DESTROY) {
+    g_visibility.Remove(reinterpret_cast<std::uint64_t>(hwnd));
+    return;
+  }
+  if (!IsTrackableTopLevel(hwnd)) {
+    return;
+  }
+  RefreshVisibilityWindow(hwnd);
+  if (event == EVENT_SYSTEM_FOREGROUND) {
+    g_visibility.BringToTop(reinterpret_cast<std::uint64_t>(hwnd));
+  }
+}
+
+BOOL CALLBACK CollectTopLevelWindow(HWND hwnd, LPARAM param) {
+  reinterpret_cast<std::vector<HWND>*>(param)->push_back(hwnd);
+  return TRUE;
+}
+
+// 开启时枚举一次建立初始 z 序，之后只靠事件增量维护。
+void SeedVisibilityWindows() {
+  std::vector<HWND> windows;
+  ::EnumWindows(CollectTopLevelWindow, reinterpret_cast<LPARAM>(&windows));
+  std::lock_guard<std::mutex> lock(g_visibility_mutex);
+  g_visibility.Clear();
+  // EnumWindows 按 z 序从上到下返回，而 Upsert 把新窗口放在最上层。
+  for (auto it = windows.rbegin(); it != windows.rend(); ++it) {
+    if (IsTrackableTopLevel(*it)) {
+      RefreshVisibilityWindow(*it);
+    }
+  }
+}
+
+}  // namespace
+
+// 开启 / 关闭可见性跟踪；需在有消息循环的线程上调用。返回 1 表示已开启。
+__declspec(dllexport) std::int32_t rt_set_visibility_tracking(
+    std::int32_t enabled) {
+  if (enabled == 0) {
+    for (HWINEVENTHOOK hook : g_visibility_hooks) {
+      ::UnhookWinEvent(hook);
+    }
+    g_visibility_hooks.clear();
+    std::lock_guard<std::mutex> lock(g_visibility_mutex);
+    g_visibility.Clear();
+    return 0;
+  }
+  if (!g_visibility_hooks.empty()) {
+    return 1;
+  }
+
+  constexpr DWORD kFlags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+  const DWORD ranges[][2] = {
+      {EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND},
+      {EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND},
+      {EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE},
+      {EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE},
+      {EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED},
+  };
+  for (const auto& range : ranges) {
+    const HWINEVENTHOOK hook = ::SetWinEventHook(
+        range[0], range[1], nullptr, OnVisibilityEvent, 0, 0, kFlags);
+    if (hook != nullptr) {
+      g_visibility_hooks.push_back(hook);
+    }
+  }
+  if (g_visibility_hooks.empty()) {
+    return 0;
+  }
+  SeedVisibilityWindows();
+  return 1;
+}
+
+// 返回 Dart 侧写入被跟踪应用列表（每行一个小写 appId）的静态缓冲区。
+// 单独一行 "*" 表示计算全部应用的窗口，由 Dart 侧再按过滤器筛选。
+__declspec(dllexport) char* rt_visibility_tracked_input() {
+  return g_visibility_tracked_input;
+}
+
+// 用输入缓冲区中的列表替换被跟踪应用集合，返回应用数量（"*" 不计）。
+__declspec(dllexport) std::int32_t rt_apply_visibility_tracked() {
+  const std::string_view input(
+      g_visibility_tracked_input,
+      ::strnlen(g_visibility_tracked_input, sizeof(g_visibility_tracked_input)));
+  std::lock_guard<std::mutex> lock(g_visibility_mutex);
+  ringotrack::TrackedAppSet tracked;
+  bool track_all = false;
+  std::int32_t count = 0;
+  std::size_t begin = 0;
+  while (begin < input.size()) {
+    std::size_t end = input.find('\n', begin);
+    if (end == std::string_view::npos) {
+      end = input.size();
+    }
+    const std::string_view app = input.substr(begin, end - begin);
+    if (app == "*") {
+      track_all = true;
+    } else if (!app.empty()) {
+      tracked.Add(g_visibility_apps.Intern(app));
+      ++count;
+    }
+    begin = end + 1;
+  }
+  g_visibility.SetTracked(tracked, track_all);
+  return count;
+}
+
+// 可见比例不低于 min_permille、且不是当前前台应用的被跟踪应用。
+// 返回指向静态结构体的指针，每次调用覆盖上一次的内容。窗口没有变化时
+// 直接返回缓存的遮挡计算结果。
+__declspec(dllexport) RtVisibleApps* rt_query_visible_apps(
+    std::uint32_t min_permille) {
+  static RtVisibleApps result;
+  result.count = 0;
+  const auto foreground =
+      reinterpret_cast<std::uint64_t>(::GetForegroundWindow());
+  std::lock_guard<std::mutex> lock(g_visibility_mutex);
+  const auto& visible =
+      g_visibility.Compute(g_visibility.AppOf(foreground), min_permille);
+  for (const ringotrack::VisibleApp& app : visible) {
+    if (result.count == kRtMaxVisibleApps) {
+      break;
+    }
+    RtVisibleApp& out = result.apps[result.count++];
+    const std::string_view name = g_visibility_apps.Name(app.app_id);
+    const std::size_t len =
+        name.size() < sizeof(out.app_id) ? name.size() : sizeof(out.app_id) - 1;
+    std::memcpy(out.app_id, name.data(), len);
+    out.app_id[len] = '\0';
+    out.visible_permille = app.visible_permille;
+    out.reserved = 0;
+  }
+  return &result;
+}
+
+// ------------------- 前台进程 CPU 活动（忙碌判定） -------------------
+
+namespace {
+
+// 读取 CPU 时间的最小间隔：忙碌判定只关心持续数秒以上的长操作。
+constexpr std::int64_t kActivitySampleIntervalMillis = 2000;
+
+// rt_query_foreground_activity 在 Dart 线程调用，加锁只为与
+// rt_reset_foreground_activity 互斥。
+std::mutex g_activity_mutex;
+ringotrack::ProcessCpuSampler g_activity_sampler;
+ringotrack::BusyClassifier g_activity_classifier;
+std::uint32_t g_activity_pid = 0;
+std::int64_t g_activity_sampled_at = 0;
+
+}  // namespace
+
+// 前台进程的忙碌状态。实际采样限频为每 2 秒一次，间隔内的调用直接返回
+// 上一次的分类结果；句柄只为当前前台进程缓存，前台切换后随下一次采样
+// 关闭。返回指向静态结构体的指针，每次调用覆盖上一次的内容。
+__declspec(dllexport) RtProcessActivity* rt_query_foreground_activity() {
+  static RtProcessActivity result;
+  std::lock_guard<std::mutex> lock(g_activity_mutex);
+  const auto now = static_cast<std::int64_t>(GetCurrentUnixMillis());
+
+  DWORD pid = 0;
+  const HWND hwnd = ::GetForegroundWindow();
+  if (hwnd != nullptr) {
+    ::GetWindowThreadProcessId(hwnd, &pid);
+  }
+  if (pid != g_activity_pid) {
+    g_activity_classifier.Reset(now);
+    g_activity_pid = pid;
+    g_activity_sampled_at = 0;
+  }
+  if (pid == 0) {
+    g_activity_sampler.Clear();
+  } else if (now - g_activity_sampled_at >= kActivitySampleIntervalMillis) {
+    ringotrack::ScopedLatency latency(
+        MetricHistogram(ringotrack::HistogramId::kProcessSample));
+    std::int64_t cpu_micros = 0;
+    if (g_activity_sampler.Sample(&g_activity_pid, 1, &cpu_micros) == 1) {
+      g_activity_classifier.OnSample(now, cpu_micros);
+    }
+    g_activity_sampled_at = now;
+  }
+
+  const bool busy = g_activity_classifier.is_busy();
+  result.busy_since_millis =
+      busy ? g_activity_classifier.changed_at_millis() : 0;
+  result.pid = g_activity_pid;
+  result.cpu_permille = g_activity_classifier.last_permille();
+  result.is_busy = busy ? 1 : 0;
+  result.reserved = 0;
+  return &result;
+}
+
+// 关闭缓存的进程句柄并清空分类状态（Dart 侧关闭采样时调用）。
+__declspec(dllexport) void rt_reset_foreground_activity() {
+  std::lock_guard<std::mutex> lock(g_activity_mutex);
+  g_activity_sampler.Clear();
+  g_activity_classifier.Reset(0);
+  g_activity_pid = 0;
+  g_activity_sampled_at = 0;
+}
+
+// ------------------- 热路径指标 -------------------
+
+// 一次性快照全部计数器与直方图，返回指向静态结构体的指针；
+// 布局见 ringotrack::MetricsSnapshot，每次调用覆盖上一次的内容。
+__declspec(dllexport) ringotrack::MetricsSnapshot* rt_read_metrics() {
+  static ringotrack::MetricsSnapshot snapshot;
+  g_metrics.Snapshot(&snapshot);
+  return &snapshot;
+}
+
+// 清零全部指标，便于按时间段对比。
+__declspec(dllexport) void rt_reset_metrics() { g_metrics.Reset(); }
+
 }  // extern "C"
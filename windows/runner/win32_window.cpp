@@ -4,16 +4,20 @@
 #include <flutter_windows.h>
 #include <windowsx.h>
 
+#include <cstdint>
+
 #include "resource.h"
 
 // 来自 foreground_tracker_win.cpp 的导出函数，用于退出 pinned 小窗模式。
 // 这里声明为 C 接口，方便在窗口关闭前做一次 cleanup，恢复正常窗口尺寸。
 extern "C" int rt_exit_pinned_mode();
 
-// 来自 foreground_tracker_win.cpp：查询当前是否处于 pinned 模式。
-extern "C" int rt_is_pinned();
-// 查询当前是否锁定窗口。
-extern "C" int rt_is_locked();
+// pinned 小窗的命中测试表：缓存 DPI / 客户区尺寸，并判断某点是否用于拖动。
+extern "C" void rt_hit_test_set_dpi(std::uint32_t dpi);
+extern "C" void rt_hit_test_set_client_size(std::int32_t width,
+                                            std::int32_t height);
+extern "C" std::int32_t rt_hit_test_is_draggable(std::int32_t x,
+                                                 std::int32_t y);
 
 namespace {
 
@@ -47,25 +51,6 @@ int Scale(int source, double scale_factor) {
   return static_cast<int>(source * scale_factor);
 }
 
-double GetWindowScaleFactor(HWND hwnd) {
-  HMONITOR monitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-  if (monitor == nullptr) {
-    return 1.0;
-  }
-
-  const UINT dpi = FlutterDesktopGetDpiForMonitor(monitor);
-  if (dpi == 0) {
-    return 1.0;
-  }
-
-  return static_cast<double>(dpi) / 96.0;
-}
-
-int ScaleToDpi(int source, double scale_factor) {
-  const int scaled = Scale(source, scale_factor);
-  return scaled > 0 ? scaled : 1;
-}
-
 // Dynamically loads the |EnableNonClientDpiScaling| from the User32 module.
 // This API is only needed for PerMonitor V1 awareness mode.
 void EnableFullDpiSupportIfAvailable(HWND hwnd) {
@@ -173,6 +158,7 @@ bool Win32Window::Create(const std::wstring& title,
     return false;
   }
 
+  rt_hit_test_set_dpi(dpi);
   UpdateTheme(window);
 
   return OnCreate();
@@ -209,60 +195,13 @@ Win32Window::MessageHandler(HWND hwnd,
                             LPARAM const lparam) noexcept {
   switch (message) {
     case WM_NCHITTEST: {
-      // 在 pinned 小窗模式下（无标题栏），让整个窗口（除右上角安全区域）
-      // 都被系统识别为「标题栏」，这样系统会自动处理窗口拖动，非常流畅跟手。
-      if (rt_is_pinned() && !rt_is_locked()) {
-        // 先调用默认处理获取标准结果
-        LRESULT default_result = DefWindowProc(hwnd, message, wparam, lparam);
-
-        // 如果在客户区，则判断是否需要视为标题栏
-        if (default_result == HTCLIENT) {
-          // 获取鼠标在屏幕上的坐标
-          POINT screen_pos{GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)};
-
-          // 转换为窗口客户区坐标
-          POINT client_pos = screen_pos;
-          ScreenToClient(hwnd, &client_pos);
-
-          RECT client_rect{};
-          GetClientRect(hwnd, &client_rect);
-
-          // 在右上角预留一块区域给 Flutter 内部的 pin 按钮点击，
-          // 避免把 pin 按钮点击也拦截成拖动。
-          constexpr int kPinSafeWidthDip = 80;
-          constexpr int kPinSafeHeightDip = 80;
-          constexpr int kLockSafeWidthDip = 80;
-          constexpr int kLockSafeHeightDip = 80;
-          const double scale_factor = GetWindowScaleFactor(hwnd);
-          const int kPinSafeWidthScaled =
-              ScaleToDpi(kPinSafeWidthDip, scale_factor);
-          const int kPinSafeHeightScaled =
-              ScaleToDpi(kPinSafeHeightDip, scale_factor);
-          const int kLockSafeWidthScaled =
-              ScaleToDpi(kLockSafeWidthDip, scale_factor);
-          const int kLockSafeHeightScaled =
-              ScaleToDpi(kLockSafeHeightDip, scale_factor);
-          const bool in_pin_safe_region =
-              client_pos.x >= client_rect.right - kPinSafeWidthScaled &&
-              client_pos.x <= client_rect.right &&
-              client_pos.y >= client_rect.top &&
-              client_pos.y <= client_rect.top + kPinSafeHeightScaled;
-
-          // 在右下角预留一块区域给 Flutter 内部的 lock 按钮点击，
-          // 避免把 lock 按钮点击也拦截成拖动。
-          const bool in_lock_safe_region =
-              client_pos.x >= client_rect.right - kLockSafeWidthScaled &&
-              client_pos.x <= client_rect.right &&
-              client_pos.y >= client_rect.bottom - kLockSafeHeightScaled &&
-              client_pos.y <= client_rect.bottom;
-
-          if (!in_pin_safe_region && !in_lock_safe_region) {
-            // 告诉系统这是标题栏，系统会自动处理拖动
-            return HTCAPTION;
-          }
-        }
-
-        return default_result;
+      // 在 pinned 小窗模式下（无标题栏），让整个窗口（除交互区域）都被系统
+      // 识别为「标题栏」，这样系统会自动处理窗口拖动，非常流畅跟手。
+      // 小窗没有边框，客户区即整个窗口，因此无需先调用 DefWindowProc。
+      POINT client_pos{GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)};
+      ScreenToClient(hwnd, &client_pos);
+      if (rt_hit_test_is_draggable(client_pos.x, client_pos.y)) {
+        return HTCAPTION;
       }
       break;
     }
@@ -282,6 +221,7 @@ Win32Window::MessageHandler(HWND hwnd,
       return 0;
 
     case WM_DPICHANGED: {
+      rt_hit_test_set_dpi(HIWORD(wparam));
       auto newRectSize = reinterpret_cast<RECT*>(lparam);
       LONG newWidth = newRectSize->right - newRectSize->left;
       LONG newHeight = newRectSize->bottom - newRectSize->top;
@@ -293,6 +233,8 @@ Win32Window::MessageHandler(HWND hwnd,
     }
     case WM_SIZE: {
       RECT rect = GetClientArea();
+      rt_hit_test_set_client_size(rect.right - rect.left,
+                                  rect.bottom - rect.top);
       if (child_content_ != nullptr) {
         // Size and position the child window.
         MoveWindow(child_content_, rect.left, rect.top, rect.right - rect.left,